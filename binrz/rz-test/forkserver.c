@@ -0,0 +1,355 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "rz_test.h"
+
+/*
+ * A fork server is a process with an RzCore initialized once, which forks a
+ * child running rizin on it for each command line received from its worker:
+ *
+ * request:  ut32 argc, argc * (ut32 len, bytes), ut32 envc, envc * 2 * (ut32 len, bytes), ut64 timeout_ms
+ * response: st32 ret, ut8 timeout, ut32 out_len, out bytes, ut32 err_len, err bytes
+ */
+
+#if __UNIX__
+#include <rz_core.h>
+#include <rz_main.h>
+#include <sys/wait.h>
+
+static bool read_full(int fd, void *buf, size_t len) {
+	ut8 *p = buf;
+	while (len) {
+		ssize_t r = read(fd, p, len);
+		if (r < 0 && errno == EINTR) {
+			continue;
+		}
+		if (r <= 0) {
+			return false;
+		}
+		p += r;
+		len -= r;
+	}
+	return true;
+}
+
+static bool write_full(int fd, const void *buf, size_t len) {
+	const ut8 *p = buf;
+	while (len) {
+		ssize_t r = write(fd, p, len);
+		if (r < 0 && errno == EINTR) {
+			continue;
+		}
+		if (r <= 0) {
+			return false;
+		}
+		p += r;
+		len -= r;
+	}
+	return true;
+}
+
+static bool write_u32(int fd, ut32 v) {
+	ut8 b[4];
+	rz_write_le32(b, v);
+	return write_full(fd, b, sizeof(b));
+}
+
+static bool read_u32(int fd, ut32 *v) {
+	ut8 b[4];
+	if (!read_full(fd, b, sizeof(b))) {
+		return false;
+	}
+	*v = rz_read_le32(b);
+	return true;
+}
+
+static bool write_blob(int fd, const void *buf, ut32 len) {
+	return write_u32(fd, len) && write_full(fd, buf, len);
+}
+
+/**
+ * Reads a blob sent by write_blob() into a buffer terminated by a 0, so
+ * strings can be used as they are.
+ */
+static ut8 *read_blob(int fd, ut32 *len) {
+	if (!read_u32(fd, len) || *len == UT32_MAX) {
+		return NULL;
+	}
+	ut8 *buf = malloc((size_t)*len + 1);
+	if (!buf) {
+		return NULL;
+	}
+	if (!read_full(fd, buf, *len)) {
+		free(buf);
+		return NULL;
+	}
+	buf[*len] = 0;
+	return buf;
+}
+
+static ut8 *file_drain(FILE *f, ut32 *len) {
+	*len = 0;
+	long size = ftell(f);
+	if (size < 0 || size >= UT32_MAX || fseek(f, 0, SEEK_SET)) {
+		return NULL;
+	}
+	ut8 *buf = malloc(size + 1);
+	if (!buf) {
+		return NULL;
+	}
+	*len = fread(buf, 1, size, f);
+	buf[*len] = 0;
+	return buf;
+}
+
+/**
+ * Waits for the child \p pid for \p timeout_ms at most, then kills it.
+ */
+static int server_wait(pid_t pid, ut64 timeout_ms, bool *timeout) {
+	ut64 start = rz_time_now_mono();
+	ut64 timeout_us = timeout_ms < UT64_MAX / 1000 ? timeout_ms * 1000 : UT64_MAX;
+	int wstat = 0;
+	*timeout = false;
+	while (true) {
+		pid_t r = waitpid(pid, &wstat, WNOHANG);
+		if (r == pid || (r < 0 && errno != EINTR)) {
+			break;
+		}
+		if (rz_time_now_mono() - start > timeout_us) {
+			kill(pid, SIGKILL);
+			waitpid(pid, &wstat, 0);
+			*timeout = true;
+			break;
+		}
+		rz_sys_usleep(100);
+	}
+	return WIFEXITED(wstat) ? WEXITSTATUS(wstat) : -1;
+}
+
+static void server_child(RzCore *core, RzPVector *args, RzPVector *env, FILE *out, FILE *err) {
+	if (dup2(fileno(out), STDOUT_FILENO) < 0 || dup2(fileno(err), STDERR_FILENO) < 0) {
+		_exit(1);
+	}
+	for (size_t i = 0; i + 1 < rz_pvector_len(env); i += 2) {
+		rz_sys_setenv(rz_pvector_at(env, i), rz_pvector_at(env, i + 1));
+	}
+	int ret = rz_main_rizin_with_core(core, rz_pvector_len(args) - 1, (const char **)args->v.a);
+	// flushes stdio like a rizin process exiting
+	exit(ret);
+}
+
+static bool server_read_strings(int fd, RzPVector *vec, ut32 count) {
+	for (ut32 i = 0; i < count; i++) {
+		ut32 len;
+		char *s = (char *)read_blob(fd, &len);
+		if (!s) {
+			return false;
+		}
+		rz_pvector_push(vec, s);
+	}
+	return true;
+}
+
+/**
+ * Serves the requests of the worker until it closes the pipe.
+ */
+static void server_loop(RzCore *core, int req_fd, int resp_fd) {
+	RzPVector args, env;
+	rz_pvector_init(&args, free);
+	rz_pvector_init(&env, free);
+	while (true) {
+		rz_pvector_clear(&args);
+		rz_pvector_clear(&env);
+		ut32 argc, envc;
+		ut8 tb[8];
+		if (!read_u32(req_fd, &argc) || !server_read_strings(req_fd, &args, argc) ||
+			!read_u32(req_fd, &envc) || !server_read_strings(req_fd, &env, envc * 2) ||
+			!read_full(req_fd, tb, sizeof(tb))) {
+			break;
+		}
+		ut64 timeout_ms = rz_read_le64(tb);
+		// argv must be terminated by NULL
+		rz_pvector_push(&args, NULL);
+
+		FILE *out = tmpfile();
+		FILE *err = tmpfile();
+		pid_t pid = out && err ? fork() : -1;
+		if (!pid) {
+			close(req_fd);
+			close(resp_fd);
+			server_child(core, &args, &env, out, err);
+		}
+		int ret = -1;
+		bool timeout = false;
+		ut8 *out_buf = NULL, *err_buf = NULL;
+		ut32 out_len = 0, err_len = 0;
+		if (pid > 0) {
+			ret = server_wait(pid, timeout_ms, &timeout);
+			out_buf = file_drain(out, &out_len);
+			err_buf = file_drain(err, &err_len);
+		}
+		if (out) {
+			fclose(out);
+		}
+		if (err) {
+			fclose(err);
+		}
+		ut8 hdr[5];
+		rz_write_le32(hdr, (ut32)ret);
+		hdr[4] = timeout;
+		bool sent = pid > 0 && write_full(resp_fd, hdr, sizeof(hdr)) &&
+			write_blob(resp_fd, out_buf ? out_buf : (ut8 *)"", out_len) &&
+			write_blob(resp_fd, err_buf ? err_buf : (ut8 *)"", err_len);
+		free(out_buf);
+		free(err_buf);
+		if (!sent) {
+			// the worker gets an EOF and spawns the test instead
+			break;
+		}
+	}
+	rz_pvector_fini(&args);
+	rz_pvector_fini(&env);
+}
+
+/**
+ * \brief Starts a fork server, which must be done before creating any thread
+ *
+ * The server initializes an RzCore, with its plugins and config, once and
+ * forks it for each test, so the tests don't pay for it. Its stdin, stdout
+ * and stderr are /dev/null, as the children's ones are redirected anyway.
+ *
+ * \return the server, or NULL if forking is not supported or failed
+ */
+RZ_API RZ_OWN RzTestForkServer *rz_test_fork_server_new(void) {
+	RzTestForkServer *server = RZ_NEW0(RzTestForkServer);
+	if (!server) {
+		return NULL;
+	}
+	int req[2], resp[2];
+	if (rz_sys_pipe(req, true) == -1) {
+		free(server);
+		return NULL;
+	}
+	if (rz_sys_pipe(resp, true) == -1) {
+		rz_sys_pipe_close(req[0]);
+		rz_sys_pipe_close(req[1]);
+		free(server);
+		return NULL;
+	}
+	// a dead server must not kill rz-test when writing to it
+	rz_sys_signal(SIGPIPE, SIG_IGN);
+	fflush(stdout);
+	fflush(stderr);
+	pid_t pid = rz_sys_fork();
+	if (!pid) {
+		close(req[1]);
+		close(resp[0]);
+		rz_sys_signal(SIGCHLD, SIG_DFL);
+		int null = open("/dev/null", O_RDWR);
+		if (null >= 0) {
+			dup2(null, STDIN_FILENO);
+			dup2(null, STDOUT_FILENO);
+			dup2(null, STDERR_FILENO);
+		}
+		RzCore *core = rz_core_new();
+		if (core) {
+			server_loop(core, req[0], resp[1]);
+		}
+		_exit(core ? 0 : 1);
+	}
+	rz_sys_pipe_close(req[0]);
+	rz_sys_pipe_close(resp[1]);
+	if (pid < 0) {
+		rz_sys_pipe_close(req[1]);
+		rz_sys_pipe_close(resp[0]);
+		free(server);
+		return NULL;
+	}
+	server->pid = pid;
+	server->req_fd = req[1];
+	server->resp_fd = resp[0];
+	return server;
+}
+
+/**
+ * \brief Stops the server, which exits when its request pipe is closed
+ */
+RZ_API void rz_test_fork_server_free(RZ_NULLABLE RzTestForkServer *server) {
+	if (!server) {
+		return;
+	}
+	rz_sys_pipe_close(server->req_fd);
+	rz_sys_pipe_close(server->resp_fd);
+	free(server);
+}
+
+/**
+ * \brief RzTestCmdRunner running rizin in the fork server given as \p user
+ *
+ * \p file is ignored, as the server runs the rizin it is linked to.
+ *
+ * \return the output or NULL if the server is not working, so the test must
+ *         be spawned instead
+ */
+RZ_API RzSubprocessOutput *rz_test_fork_server_runner(const char *file, const char *args[], size_t args_size,
+	const char *envvars[], const char *envvals[], size_t env_size, ut64 timeout_ms, void *user) {
+	RzTestForkServer *server = user;
+	if (!server || server->dead) {
+		return NULL;
+	}
+	int fd = server->req_fd;
+	bool sent = write_u32(fd, args_size + 1) && write_blob(fd, "rizin", 5);
+	for (size_t i = 0; sent && i < args_size; i++) {
+		sent = write_blob(fd, args[i], strlen(args[i]));
+	}
+	sent = sent && write_u32(fd, env_size);
+	for (size_t i = 0; sent && i < env_size; i++) {
+		sent = write_blob(fd, envvars[i], strlen(envvars[i])) &&
+			write_blob(fd, envvals[i], strlen(envvals[i]));
+	}
+	ut8 tb[8];
+	rz_write_le64(tb, timeout_ms);
+	sent = sent && write_full(fd, tb, sizeof(tb));
+
+	ut8 hdr[5];
+	RzSubprocessOutput *out = NULL;
+	if (!sent || !read_full(server->resp_fd, hdr, sizeof(hdr)) || !(out = RZ_NEW0(RzSubprocessOutput))) {
+		goto fail;
+	}
+	out->ret = (st32)rz_read_le32(hdr);
+	out->timeout = hdr[4];
+	ut32 len;
+	out->out = read_blob(server->resp_fd, &len);
+	out->out_len = len;
+	if (!out->out) {
+		goto fail;
+	}
+	out->err = read_blob(server->resp_fd, &len);
+	out->err_len = len;
+	if (!out->err) {
+		goto fail;
+	}
+	return out;
+fail:
+	RZ_LOG_ERROR("rz-test: fork server %d stopped working, spawning the tests instead\n", (int)server->pid);
+	server->dead = true;
+	rz_subprocess_output_free(out);
+	return NULL;
+}
+
+#else
+
+RZ_API RZ_OWN RzTestForkServer *rz_test_fork_server_new(void) {
+	return NULL;
+}
+
+RZ_API void rz_test_fork_server_free(RZ_NULLABLE RzTestForkServer *server) {
+	free(server);
+}
+
+RZ_API RzSubprocessOutput *rz_test_fork_server_runner(const char *file, const char *args[], size_t args_size,
+	const char *envvars[], const char *envvals[], size_t env_size, ut64 timeout_ms, void *user) {
+	return NULL;
+}
+
+#endif
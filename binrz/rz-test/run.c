@@ -440,7 +440,74 @@ RZ_API bool rz_test_broken(RzTest *test) {
 	return false;
 }
 
-RZ_API RzTestResultInfo *rz_test_run_test(RzTestRunConfig *config, RzTest *test) {
+static RzSubprocessOutput *run_cmd_or_json_test(RzTestRunConfig *config, RzTest *test, RzTestCmdRunner runner, void *user) {
+	return test->type == RZ_TEST_TYPE_CMD
+		? rz_test_run_cmd_test(config, test->cmd_test, runner, user)
+		: rz_test_run_json_test(config, test->json_test, runner, user);
+}
+
+static bool check_cmd_or_json_test(RzSubprocessOutput *out, RzTest *test) {
+	return test->type == RZ_TEST_TYPE_CMD
+		? rz_test_check_cmd_test(out, test->cmd_test)
+		: rz_test_check_json_test(out, test->json_test);
+}
+
+static bool same_output(RzSubprocessOutput *a, RzSubprocessOutput *b) {
+	return a->ret == b->ret && a->timeout == b->timeout &&
+		a->out_len == b->out_len && !memcmp(a->out, b->out, a->out_len) &&
+		a->err_len == b->err_len && !memcmp(a->err, b->err, a->err_len);
+}
+
+/**
+ * Runs a cmd or json \p test in \p server. The failed tests and a sample of
+ * the others are spawned too and, if the outputs differ, the pre-initialized
+ * core leaked some state into the test, so the spawned output is used.
+ */
+static RzSubprocessOutput *run_in_fork_server(RzTestRunConfig *config, RzTest *test, RzTestForkServer *server, bool *success) {
+	RzTestForkServerStats *stats = &server->stats;
+	ut64 start = rz_time_now_mono();
+	RzSubprocessOutput *out = run_cmd_or_json_test(config, test, rz_test_fork_server_runner, server);
+	ut64 fork_time = rz_time_now_mono() - start;
+	if (!out) {
+		stats->fallbacks++;
+		out = run_cmd_or_json_test(config, test, subprocess_runner, NULL);
+		*success = check_cmd_or_json_test(out, test);
+		return out;
+	}
+	stats->forked++;
+	stats->fork_time += fork_time;
+	*success = check_cmd_or_json_test(out, test);
+	bool sample = stats->forked % RZ_TEST_FORK_SERVER_SAMPLE == 0;
+	if (!sample && (*success || out->timeout || rz_test_broken(test))) {
+		return out;
+	}
+	start = rz_time_now_mono();
+	RzSubprocessOutput *spawned = run_cmd_or_json_test(config, test, subprocess_runner, NULL);
+	if (!spawned) {
+		return out;
+	}
+	if (sample) {
+		stats->sampled++;
+		stats->sampled_fork_time += fork_time;
+		stats->sampled_spawn_time += rz_time_now_mono() - start;
+	}
+	if (same_output(out, spawned)) {
+		rz_subprocess_output_free(spawned);
+		return out;
+	}
+	stats->mismatches++;
+	char *name = rz_test_test_name(test);
+	RZ_LOG_WARN("rz-test: %s %s has a different output in the fork server, using the spawned one\n", test->path, name ? name : "");
+	free(name);
+	rz_subprocess_output_free(out);
+	*success = check_cmd_or_json_test(spawned, test);
+	return spawned;
+}
+
+/**
+ * \brief Runs \p test, in \p server if not NULL and the test is a cmd or json one
+ */
+RZ_API RzTestResultInfo *rz_test_run_test(RzTestRunConfig *config, RzTest *test, RZ_NULLABLE RzTestForkServer *server) {
 	RzTestResultInfo *ret = RZ_NEW0(RzTestResultInfo);
 	if (!ret) {
 		return NULL;
@@ -451,8 +518,13 @@ RZ_API RzTestResultInfo *rz_test_run_test(RzTestRunConfig *config, RzTest *test)
 	switch (test->type) {
 	case RZ_TEST_TYPE_CMD: {
 		RzCmdTest *cmd_test = test->cmd_test;
-		RzSubprocessOutput *out = rz_test_run_cmd_test(config, cmd_test, subprocess_runner, NULL);
-		success = rz_test_check_cmd_test(out, cmd_test);
+		RzSubprocessOutput *out;
+		if (server) {
+			out = run_in_fork_server(config, test, server, &success);
+		} else {
+			out = rz_test_run_cmd_test(config, cmd_test, subprocess_runner, NULL);
+			success = rz_test_check_cmd_test(out, cmd_test);
+		}
 		ret->proc_out = out;
 		ret->timeout = out && out->timeout;
 		ret->run_failed = !out;
@@ -471,8 +543,13 @@ RZ_API RzTestResultInfo *rz_test_run_test(RzTestRunConfig *config, RzTest *test)
 	}
 	case RZ_TEST_TYPE_JSON: {
 		RzJsonTest *json_test = test->json_test;
-		RzSubprocessOutput *out = rz_test_run_json_test(config, json_test, subprocess_runner, NULL);
-		success = rz_test_check_json_test(out, json_test);
+		RzSubprocessOutput *out;
+		if (server) {
+			out = run_in_fork_server(config, test, server, &success);
+		} else {
+			out = rz_test_run_json_test(config, json_test, subprocess_runner, NULL);
+			success = rz_test_check_json_test(out, json_test);
+		}
 		ret->proc_out = out;
 		if (out) {
 			ret->timeout = out->timeout;
@@ -50,7 +50,13 @@ typedef struct rz_test_state_t {
 	RzPVector results;
 } RzTestState;
 
+typedef struct rz_test_worker_t {
+	RzTestState *state;
+	RzTestForkServer *server; // NULL to spawn all the tests
+} RzTestWorker;
+
 static RzThreadFunctionRet worker_th(RzThread *th);
+static void print_fork_server_stats(RzPVector *servers);
 static void print_state(RzTestState *state, ut64 prev_completed);
 static void print_log(RzTestState *state, ut64 prev_completed, ut64 prev_paths_completed);
 static void interact(RzTestState *state);
@@ -59,7 +65,7 @@ static void interact_break(RzTestResultInfo *result, RzPVector *fixup_results);
 static void interact_commands(RzTestResultInfo *result, RzPVector *fixup_results);
 
 static int help(bool verbose) {
-	printf("Usage: rz-test [-qvVnL] [-j threads] [test file/dir | @test-type]\n");
+	printf("Usage: rz-test [-qvVnLS] [-j threads] [test file/dir | @test-type]\n");
 	if (verbose) {
 		printf(
 			" -h           print this help\n"
@@ -69,6 +75,7 @@ static int help(bool verbose) {
 			" -i           interactive mode\n"
 			" -n           do nothing (don't run any test, just load/parse them)\n"
 			" -L           log mode (better printing for CI, logfiles, etc.)\n"
+			" -S           run cmd and json tests in fork servers, with a rizin initialized once per thread (-r is ignored for them)\n"
 			" -F [dir]     run fuzz tests (open and default analysis) on all files in the given dir\n"
 			" -j [threads] how many threads to use for running tests concurrently (default is " WORKERS_DEFAULT_STR ")\n"
 			" -r [rizin] path to rizin executable (default is " RIZIN_CMD_DEFAULT ")\n"
@@ -186,6 +193,7 @@ int rz_test_main(int argc, const char **argv) {
 	bool nothing = false;
 	bool quiet = false;
 	bool interactive = false;
+	bool fork_servers = false;
 	char *rizin_cmd = NULL;
 	char *rz_asm_cmd = NULL;
 	char *json_test_file = NULL;
@@ -194,6 +202,8 @@ int rz_test_main(int argc, const char **argv) {
 	const char *rz_test_dir = NULL;
 	ut64 timeout_sec = TIMEOUT_DEFAULT;
 	int ret = 0;
+	RzPVector servers;
+	rz_pvector_init(&servers, (RzPVectorFree)rz_test_fork_server_free);
 
 #if __WINDOWS__
 	UINT old_cp = GetConsoleOutputCP();
@@ -210,7 +220,7 @@ int rz_test_main(int argc, const char **argv) {
 #endif
 
 	RzGetopt opt;
-	rz_getopt_init(&opt, argc, (const char **)argv, "hqvj:r:m:f:C:LnVt:F:io:");
+	rz_getopt_init(&opt, argc, (const char **)argv, "hqvj:r:m:f:C:LnVt:F:io:S");
 
 	int c;
 	while ((c = rz_getopt_next(&opt)) != -1) {
@@ -240,6 +250,9 @@ int rz_test_main(int argc, const char **argv) {
 		case 'L':
 			log_mode = true;
 			break;
+		case 'S':
+			fork_servers = true;
+			break;
 		case 'F':
 			free(fuzz_dir);
 			fuzz_dir = strdup(opt.arg);
@@ -310,6 +323,20 @@ int rz_test_main(int argc, const char **argv) {
 		free(tmp);
 	}
 
+	rz_sys_setenv("TZ", "UTC");
+	if (fork_servers && !nothing) {
+		// the servers are forked before any thread and before the SIGCHLD
+		// handling of rz_subprocess is set up
+		for (int i = 0; i < workers_count; i++) {
+			RzTestForkServer *server = rz_test_fork_server_new();
+			if (!server) {
+				eprintf("Cannot start the fork servers, spawning all the tests.\n");
+				break;
+			}
+			rz_pvector_push(&servers, server);
+		}
+	}
+
 	if (!rz_subprocess_init()) {
 		eprintf("Subprocess init failed\n");
 		ret = -1;
@@ -317,7 +344,6 @@ int rz_test_main(int argc, const char **argv) {
 	}
 	atexit(rz_subprocess_fini);
 
-	rz_sys_setenv("TZ", "UTC");
 	ut64 time_start = rz_time_now_mono();
 	RzTestState state = { 0 };
 	state.run_config.rz_cmd = rizin_cmd ? rizin_cmd : RIZIN_CMD_DEFAULT;
@@ -454,9 +480,17 @@ int rz_test_main(int argc, const char **argv) {
 
 	RzPVector workers;
 	rz_pvector_init(&workers, NULL);
+	RzTestWorker *worker_ctx = RZ_NEWS0(RzTestWorker, workers_count);
+	if (!worker_ctx) {
+		rz_th_lock_leave(state.lock);
+		ret = -1;
+		goto coast;
+	}
 	int i;
 	for (i = 0; i < workers_count; i++) {
-		RzThread *th = rz_th_new(worker_th, &state, 0);
+		worker_ctx[i].state = &state;
+		worker_ctx[i].server = i < rz_pvector_len(&servers) ? rz_pvector_at(&servers, i) : NULL;
+		RzThread *th = rz_th_new(worker_th, &worker_ctx[i], 0);
 		if (!th) {
 			eprintf("Failed to start thread.\n");
 			rz_th_lock_leave(state.lock);
@@ -493,6 +527,7 @@ int rz_test_main(int argc, const char **argv) {
 		rz_th_free(th);
 	}
 	rz_pvector_clear(&workers);
+	free(worker_ctx);
 
 	ut64 seconds = (rz_time_now_mono() - time_start) / 1000000;
 	printf("Finished in");
@@ -502,6 +537,9 @@ int rz_test_main(int argc, const char **argv) {
 		seconds -= (minutes * 60);
 	}
 	printf(" %" PFMT64d " seconds.\n", seconds % 60);
+	if (!rz_pvector_empty(&servers)) {
+		print_fork_server_stats(&servers);
+	}
 
 	if (output_file) {
 		pj_end(state.test_results);
@@ -527,6 +565,7 @@ coast:
 	rz_th_cond_free(state.cond);
 	ht_pp_free(state.path_left);
 beach:
+	rz_pvector_fini(&servers);
 	free(output_file);
 	free(rizin_cmd);
 	free(rz_asm_cmd);
@@ -588,8 +627,35 @@ static void test_result_to_json(PJ *pj, RzTestResultInfo *result) {
 	pj_end(pj);
 }
 
+static void print_fork_server_stats(RzPVector *servers) {
+	RzTestForkServerStats total = { 0 };
+	void **it;
+	rz_pvector_foreach (servers, it) {
+		RzTestForkServer *server = *it;
+		total.forked += server->stats.forked;
+		total.fork_time += server->stats.fork_time;
+		total.sampled += server->stats.sampled;
+		total.sampled_fork_time += server->stats.sampled_fork_time;
+		total.sampled_spawn_time += server->stats.sampled_spawn_time;
+		total.mismatches += server->stats.mismatches;
+		total.fallbacks += server->stats.fallbacks;
+	}
+	printf("Fork servers: %" PFMT64u " tests, %.1f ms per test", total.forked,
+		total.forked ? total.fork_time / 1000.0 / total.forked : 0.0);
+	if (total.sampled) {
+		printf(", sampled %" PFMT64u ": %.1f ms forked vs %.1f ms spawned", total.sampled,
+			total.sampled_fork_time / 1000.0 / total.sampled, total.sampled_spawn_time / 1000.0 / total.sampled);
+	}
+	printf(".\n");
+	if (total.mismatches || total.fallbacks) {
+		printf("Fork servers: %" PFMT64u " tests with a different output when spawned, %" PFMT64u " spawned after a server failure.\n",
+			total.mismatches, total.fallbacks);
+	}
+}
+
 static RzThreadFunctionRet worker_th(RzThread *th) {
-	RzTestState *state = th->user;
+	RzTestWorker *worker = th->user;
+	RzTestState *state = worker->state;
 	rz_th_lock_enter(state->lock);
 	while (true) {
 		if (rz_pvector_empty(&state->queue)) {
@@ -598,7 +664,7 @@ static RzThreadFunctionRet worker_th(RzThread *th) {
 		RzTest *test = rz_pvector_pop(&state->queue);
 		rz_th_lock_leave(state->lock);
 
-		RzTestResultInfo *result = rz_test_run_test(&state->run_config, test);
+		RzTestResultInfo *result = rz_test_run_test(&state->run_config, test, worker->server);
 
 		rz_th_lock_enter(state->lock);
 		rz_pvector_push(&state->results, result);
@@ -204,10 +204,36 @@ RZ_API void rz_test_asm_test_output_free(RzAsmTestOutput *out);
 RZ_API RzSubprocessOutput *rz_test_run_fuzz_test(RzTestRunConfig *config, RzFuzzTest *test, RzTestCmdRunner runner, void *user);
 RZ_API bool rz_test_check_fuzz_test(RzSubprocessOutput *out);
 
+// every n-th test run in a fork server is spawned too, to compare the results
+#define RZ_TEST_FORK_SERVER_SAMPLE 32
+
+typedef struct rz_test_fork_server_stats_t {
+	ut64 forked; ///< tests run in the fork server
+	ut64 fork_time; ///< total time of the forked tests in us
+	ut64 sampled; ///< tests spawned too for comparison
+	ut64 sampled_fork_time; ///< time of the sampled tests in the fork server in us
+	ut64 sampled_spawn_time; ///< time of the sampled tests spawned in us
+	ut64 mismatches; ///< tests whose spawned output differed, which was used instead
+	ut64 fallbacks; ///< tests spawned because the server did not answer
+} RzTestForkServerStats;
+
+typedef struct rz_test_fork_server_t {
+	int pid;
+	int req_fd; ///< requests to the server
+	int resp_fd; ///< responses from the server
+	bool dead;
+	RzTestForkServerStats stats;
+} RzTestForkServer;
+
+RZ_API RZ_OWN RzTestForkServer *rz_test_fork_server_new(void);
+RZ_API void rz_test_fork_server_free(RZ_NULLABLE RzTestForkServer *server);
+RZ_API RzSubprocessOutput *rz_test_fork_server_runner(const char *file, const char *args[], size_t args_size,
+	const char *envvars[], const char *envvals[], size_t env_size, ut64 timeout_ms, void *user);
+
 RZ_API void rz_test_test_free(RzTest *test);
 RZ_API char *rz_test_test_name(RzTest *test);
 RZ_API bool rz_test_test_broken(RzTest *test);
-RZ_API RzTestResultInfo *rz_test_run_test(RzTestRunConfig *config, RzTest *test);
+RZ_API RzTestResultInfo *rz_test_run_test(RzTestRunConfig *config, RzTest *test, RZ_NULLABLE RzTestForkServer *server);
 RZ_API void rz_test_test_result_info_free(RzTestResultInfo *result);
 
 #endif // RIZIN_RZTEST_H
@@ -74,6 +74,12 @@ RZ_API RzAnalysis *rz_analysis_new(void) {
 		return NULL;
 	}
 	analysis->bb_tree = NULL;
+	analysis->block_slab = rz_slab_new(sizeof(RzAnalysisBlock), 0, "analysis.block");
+	if (!analysis->block_slab) {
+		rz_str_constpool_fini(&analysis->constpool);
+		free(analysis);
+		return NULL;
+	}
 	analysis->ht_addr_fun = ht_up_new0();
 	analysis->ht_name_fun = ht_pp_new0();
 	analysis->os = strdup(RZ_SYS_OS);
@@ -158,6 +164,7 @@ RZ_API RzAnalysis *rz_analysis_free(RzAnalysis *a) {
 	free(a->zign_path);
 	rz_list_free(a->plugins);
 	rz_rbtree_free(a->bb_tree, __block_free_rb, NULL);
+	rz_slab_free(a->block_slab);
 	rz_spaces_fini(&a->meta_spaces);
 	rz_spaces_fini(&a->zign_spaces);
 	rz_syscall_free(a->syscall);
@@ -235,6 +242,10 @@ RZ_API bool rz_analysis_set_reg_profile(RzAnalysis *analysis) {
 	char *p = rz_analysis_get_reg_profile(analysis);
 	if (p) {
 		rz_reg_set_profile_string(analysis->reg, p);
+		if (analysis->rzil && analysis->rzil->vm) {
+			// the register indexes may have changed
+			rz_analysis_rzil_bind_regs(analysis->rzil, analysis->reg);
+		}
 		ret = true;
 	}
 	free(p);
@@ -45,7 +45,7 @@ RZ_API void rz_analysis_block_ref(RzAnalysisBlock *bb) {
 #define DFLT_NINSTR 3
 
 static RzAnalysisBlock *block_new(RzAnalysis *a, ut64 addr, ut64 size) {
-	RzAnalysisBlock *block = RZ_NEW0(RzAnalysisBlock);
+	RzAnalysisBlock *block = rz_slab_alloc0(a->block_slab);
 	if (!block) {
 		return NULL;
 	}
@@ -79,7 +79,7 @@ static void block_free(RzAnalysisBlock *block) {
 	rz_list_free(block->fcns);
 	free(block->op_pos);
 	free(block->parent_reg_arena);
-	free(block);
+	rz_slab_release(block->analysis->block_slab, block);
 }
 
 void __block_free_rb(RBNode *node, void *user) {
@@ -1078,6 +1078,8 @@ RZ_API ut64 rz_analysis_block_get_op_size(RzAnalysisBlock *bb, size_t i) {
 	return idx_next != UT16_MAX ? idx_next - idx_cur : bb->size - idx_cur;
 }
 
+#define BLOCK_ANALYZE_OPS_BATCH 16
+
 /**
  * Successively disassemble the ops in this block and update the contained op addrs.
  * This will not move or resize the block itself or touch anything else around it,
@@ -1100,26 +1102,36 @@ RZ_API void rz_analysis_block_analyze_ops(RzAnalysisBlock *block) {
 		free(buf);
 		return;
 	}
+	ut64 end = block->addr + block->size;
 	ut64 addr = block->addr;
 	size_t i = 0;
-	while (addr < block->addr + block->size) {
-		RzAnalysisOp op;
-		if (rz_analysis_op(block->analysis, &op, addr,
-			    buf + (addr - block->addr), block->addr + block->size - addr, 0) <= 0) {
-			rz_analysis_op_fini(&op);
-			break;
-		}
-		if (i > 0) {
-			ut64 off = addr - block->addr;
-			if (off >= UT16_MAX) {
-				rz_analysis_op_fini(&op);
-				break;
+	bool done = false;
+	RzAnalysisOp ops[BLOCK_ANALYZE_OPS_BATCH];
+	while (!done && addr < end) {
+		bool failed;
+		int n = rz_analysis_op_batch(a, ops, BLOCK_ANALYZE_OPS_BATCH, addr, buf + (addr - block->addr), (int)(end - addr), 0, &failed);
+		done = n < 1;
+		for (int k = 0; k < n; k++) {
+			RzAnalysisOp *op = &ops[k];
+			if (done || (failed && k == n - 1)) {
+				// the batch ends with the op it could not decode, if any
+				rz_analysis_op_fini(op);
+				done = true;
+				continue;
 			}
-			rz_analysis_block_set_op_offset(block, i, (ut16)off);
+			if (i > 0) {
+				ut64 off = addr - block->addr;
+				if (off >= UT16_MAX) {
+					rz_analysis_op_fini(op);
+					done = true;
+					continue;
+				}
+				rz_analysis_block_set_op_offset(block, i, (ut16)off);
+			}
+			i++;
+			addr += op->size > 0 ? op->size : 1;
+			rz_analysis_op_fini(op);
 		}
-		i++;
-		addr += op.size > 0 ? op.size : 1;
-		rz_analysis_op_fini(&op);
 	}
 	block->ninstr = i;
 	free(buf);
@@ -4,12 +4,6 @@
 
 #include <rz_analysis.h>
 
-#define CMP_REG_CHANGE(x, y) ((x) - ((RzAnalysisEsilRegChange *)(y))->idx)
-#define CMP_MEM_CHANGE(x, y) ((x) - ((RzAnalysisEsilMemChange *)(y))->idx)
-
-static int ocbs_set = false;
-static RzAnalysisEsilCallbacks ocbs = { 0 };
-
 // IL trace wrapper of esil
 static inline bool esil_add_mem_trace(RzAnalysisEsilTrace *etrace, RzILTraceMemOp *mem) {
 	RzILTraceInstruction *instr_trace = rz_analysis_esil_get_instruction_trace(etrace, etrace->idx);
@@ -21,50 +15,21 @@ static inline bool esil_add_reg_trace(RzAnalysisEsilTrace *etrace, RzILTraceRegO
 	return rz_analysis_il_trace_add_reg(instr_trace, reg);
 }
 
-static void htup_vector_free(HtUPKv *kv) {
-	rz_vector_free(kv->value);
-}
-
 RZ_API RzAnalysisEsilTrace *rz_analysis_esil_trace_new(RzAnalysisEsil *esil) {
-	rz_return_val_if_fail(esil && esil->stack_addr && esil->stack_size, NULL);
-	size_t i;
+	rz_return_val_if_fail(esil, NULL);
 	RzAnalysisEsilTrace *trace = RZ_NEW0(RzAnalysisEsilTrace);
 	if (!trace) {
 		return NULL;
 	}
-	trace->registers = ht_up_new(NULL, htup_vector_free, NULL);
-	if (!trace->registers) {
-		goto error;
-	}
-	trace->memory = ht_up_new(NULL, htup_vector_free, NULL);
-	if (!trace->memory) {
+	// The initial registers and memory are saved by the log with the first step
+	trace->log = rz_analysis_esil_trace_log_new();
+	if (!trace->log) {
 		goto error;
 	}
 	trace->instructions = rz_pvector_new((RzPVectorFree)rz_analysis_il_trace_instruction_free);
 	if (!trace->instructions) {
 		goto error;
 	}
-	// Save initial ESIL stack memory
-	trace->stack_addr = esil->stack_addr;
-	trace->stack_size = esil->stack_size;
-	trace->stack_data = malloc(esil->stack_size);
-	if (!trace->stack_data) {
-		goto error;
-	}
-	esil->analysis->iob.read_at(esil->analysis->iob.io, trace->stack_addr,
-		trace->stack_data, trace->stack_size);
-	// Save initial registers arenas
-	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
-		RzRegArena *a = esil->analysis->reg->regset[i].arena;
-		RzRegArena *b = rz_reg_arena_new(a->size);
-		if (!b) {
-			goto error;
-		}
-		if (b->bytes && a->bytes && b->size > 0) {
-			memcpy(b->bytes, a->bytes, b->size);
-		}
-		trace->arena[i] = b;
-	}
 	return trace;
 error:
 	eprintf("error\n");
@@ -76,57 +41,22 @@ RZ_API void rz_analysis_esil_trace_free(RzAnalysisEsilTrace *trace) {
 	if (!trace) {
 		return;
 	}
-	size_t i;
-	ht_up_free(trace->registers);
-	ht_up_free(trace->memory);
-	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
-		rz_reg_arena_free(trace->arena[i]);
-	}
-	free(trace->stack_data);
+	rz_analysis_esil_trace_log_free(trace->log);
 	rz_pvector_free(trace->instructions);
 	trace->instructions = NULL;
 	RZ_FREE(trace);
 }
 
-static void add_reg_change(RzAnalysisEsilTrace *trace, int idx, RzRegItem *ri, ut64 data) {
-	ut64 addr = ri->offset | (ri->arena << 16);
-	RzVector *vreg = ht_up_find(trace->registers, addr, NULL);
-	if (!vreg) {
-		vreg = rz_vector_new(sizeof(RzAnalysisEsilRegChange), NULL, NULL);
-		if (!vreg) {
-			eprintf("Error: creating a register vector.\n");
-			return;
-		}
-		ht_up_insert(trace->registers, addr, vreg);
-	}
-	RzAnalysisEsilRegChange reg = { idx, data };
-	rz_vector_push(vreg, &reg);
-}
-
-static void add_mem_change(RzAnalysisEsilTrace *trace, int idx, ut64 addr, ut8 data) {
-	RzVector *vmem = ht_up_find(trace->memory, addr, NULL);
-	if (!vmem) {
-		vmem = rz_vector_new(sizeof(RzAnalysisEsilMemChange), NULL, NULL);
-		if (!vmem) {
-			eprintf("Error: creating a memory vector.\n");
-			return;
-		}
-		ht_up_insert(trace->memory, addr, vmem);
-	}
-	RzAnalysisEsilMemChange mem = { idx, data };
-	rz_vector_push(vmem, &mem);
-}
-
 static int trace_hook_reg_read(RzAnalysisEsil *esil, const char *name, ut64 *res, int *size) {
 	int ret = 0;
 	if (*name == '0') {
 		// eprintf ("Register not found in profile\n");
 		return 0;
 	}
-	if (ocbs.hook_reg_read) {
+	if (esil->trace->ocbs.hook_reg_read) {
 		RzAnalysisEsilCallbacks cbs = esil->cb;
-		esil->cb = ocbs;
-		ret = ocbs.hook_reg_read(esil, name, res, size);
+		esil->cb = esil->trace->ocbs;
+		ret = esil->trace->ocbs.hook_reg_read(esil, name, res, size);
 		esil->cb = cbs;
 	}
 	if (!ret && esil->cb.reg_read) {
@@ -166,11 +96,13 @@ static int trace_hook_reg_write(RzAnalysisEsil *esil, const char *name, ut64 *va
 	}
 
 	RzRegItem *ri = rz_reg_get(esil->analysis->reg, name, -1);
-	add_reg_change(esil->trace, esil->trace->idx + 1, ri, *val);
-	if (ocbs.hook_reg_write) {
+	if (ri) {
+		rz_analysis_esil_trace_log_reg_write(esil->trace->log, ri->name, *val);
+	}
+	if (esil->trace->ocbs.hook_reg_write) {
 		RzAnalysisEsilCallbacks cbs = esil->cb;
-		esil->cb = ocbs;
-		ret = ocbs.hook_reg_write(esil, name, val);
+		esil->cb = esil->trace->ocbs;
+		ret = esil->trace->ocbs.hook_reg_write(esil, name, val);
 		esil->cb = cbs;
 	}
 	return ret;
@@ -203,17 +135,16 @@ static int trace_hook_mem_read(RzAnalysisEsil *esil, ut64 addr, ut8 *buf, int le
 		RZ_FREE(mem_read);
 	}
 
-	if (ocbs.hook_mem_read) {
+	if (esil->trace->ocbs.hook_mem_read) {
 		RzAnalysisEsilCallbacks cbs = esil->cb;
-		esil->cb = ocbs;
-		ret = ocbs.hook_mem_read(esil, addr, buf, len);
+		esil->cb = esil->trace->ocbs;
+		ret = esil->trace->ocbs.hook_mem_read(esil, addr, buf, len);
 		esil->cb = cbs;
 	}
 	return ret;
 }
 
 static int trace_hook_mem_write(RzAnalysisEsil *esil, ut64 addr, const ut8 *buf, int len) {
-	size_t i;
 	int ret = 0;
 
 	// Trace memory read behavior
@@ -237,14 +168,14 @@ static int trace_hook_mem_write(RzAnalysisEsil *esil, ut64 addr, const ut8 *buf,
 		RZ_FREE(mem_write);
 	}
 
-	for (i = 0; i < len; i++) {
-		add_mem_change(esil->trace, esil->trace->idx + 1, addr + i, buf[i]);
-	}
+	ut8 old[sizeof(mem_write->data_buf)];
+	esil->analysis->iob.read_at(esil->analysis->iob.io, addr, old, len);
+	rz_analysis_esil_trace_log_mem_write(esil->trace->log, addr, old, buf, len);
 
-	if (ocbs.hook_mem_write) {
+	if (esil->trace->ocbs.hook_mem_write) {
 		RzAnalysisEsilCallbacks cbs = esil->cb;
-		esil->cb = ocbs;
-		ret = ocbs.hook_mem_write(esil, addr, buf, len);
+		esil->cb = esil->trace->ocbs;
+		ret = esil->trace->ocbs.hook_mem_write(esil, addr, buf, len);
 		esil->cb = cbs;
 	}
 	return ret;
@@ -277,24 +208,25 @@ RZ_API void rz_analysis_esil_trace_op(RzAnalysisEsil *esil, RZ_NONNULL RzAnalysi
 			return;
 		}
 	}
-	/* restore from trace when `idx` is not at the end */
-	if (esil->trace->idx != esil->trace->end_idx) {
-		rz_analysis_esil_trace_restore(esil, esil->trace->idx + 1);
-		return;
+	/* drop the steps after `idx` when stepping from a rewound position */
+	while (rz_pvector_len(esil->trace->instructions) > esil->trace->idx) {
+		rz_analysis_il_trace_instruction_free(rz_pvector_pop(esil->trace->instructions));
 	}
+	esil->trace->end_idx = esil->trace->idx;
 	/* save old callbacks */
 	int esil_verbose = esil->verbose;
-	if (ocbs_set) {
+	if (esil->trace->ocbs_set) {
 		eprintf("cannot call recursively\n");
 	}
-	ocbs = esil->cb;
-	ocbs_set = true;
+	esil->trace->ocbs = esil->cb;
+	esil->trace->ocbs_set = true;
 
 	RzILTraceInstruction *instruction = rz_analysis_il_trace_instruction_new(op->addr);
 	rz_pvector_push(esil->trace->instructions, instruction);
 
-	RzRegItem *pc_ri = rz_reg_get(esil->analysis->reg, "PC", -1);
-	add_reg_change(esil->trace, esil->trace->idx, pc_ri, op->addr);
+	if (!rz_analysis_esil_trace_log_step_begin(esil->trace->log, esil->analysis->reg, op->addr)) {
+		RZ_LOG_ERROR("failed to record the ESIL trace step\n");
+	}
 	/* set hooks */
 	esil->verbose = 0;
 	esil->cb.hook_reg_read = trace_hook_reg_read;
@@ -305,67 +237,62 @@ RZ_API void rz_analysis_esil_trace_op(RzAnalysisEsil *esil, RZ_NONNULL RzAnalysi
 	/* evaluate esil expression */
 	rz_analysis_esil_parse(esil, expr);
 	rz_analysis_esil_stack_free(esil);
+	rz_analysis_esil_trace_log_step_end(esil->trace->log);
 	/* restore hooks */
-	esil->cb = ocbs;
-	ocbs_set = false;
+	esil->cb = esil->trace->ocbs;
+	esil->trace->ocbs_set = false;
 	esil->verbose = esil_verbose;
 	/* increment idx */
 	esil->trace->idx++;
 	esil->trace->end_idx++;
 }
 
-static bool restore_memory_cb(void *user, const ut64 key, const void *value) {
-	size_t index;
-	RzAnalysisEsil *esil = user;
-	RzVector *vmem = (RzVector *)value;
-
-	rz_vector_upper_bound(vmem, esil->trace->idx, index, CMP_MEM_CHANGE);
-	if (index > 0 && index <= vmem->len) {
-		RzAnalysisEsilMemChange *c = rz_vector_index_ptr(vmem, index - 1);
-		esil->analysis->iob.write_at(esil->analysis->iob.io, key, &c->data, 1);
+/**
+ * \brief Moves registers and memory to the state before the step \p idx
+ *
+ * \param esil ESIL instance with a trace
+ * \param idx Step to reach, up to the number of recorded steps
+ */
+RZ_API void rz_analysis_esil_trace_restore(RzAnalysisEsil *esil, int idx) {
+	rz_return_if_fail(esil && esil->trace && idx >= 0);
+	RzAnalysisEsilTrace *trace = esil->trace;
+	if (rz_analysis_esil_trace_log_seek(trace->log, esil->analysis->reg, &esil->analysis->iob, idx)) {
+		trace->idx = idx;
 	}
-	return true;
 }
 
-static bool restore_register(RzAnalysisEsil *esil, RzRegItem *ri, int idx) {
-	size_t index;
-	RzVector *vreg = ht_up_find(esil->trace->registers, ri->offset | (ri->arena << 16), NULL);
-	if (vreg) {
-		rz_vector_upper_bound(vreg, idx, index, CMP_REG_CHANGE);
-		if (index > 0 && index <= vreg->len) {
-			RzAnalysisEsilRegChange *c = rz_vector_index_ptr(vreg, index - 1);
-			rz_reg_set_value(esil->analysis->reg, ri, c->data);
-		}
-	}
-	return true;
+/**
+ * \brief Saves the registers and memory changes of the trace to \p path
+ */
+RZ_API bool rz_analysis_esil_trace_save(RZ_NONNULL RzAnalysisEsilTrace *trace, RZ_NONNULL const char *path) {
+	rz_return_val_if_fail(trace && path, false);
+	return rz_analysis_esil_trace_log_save(trace->log, path);
 }
 
-RZ_API void rz_analysis_esil_trace_restore(RzAnalysisEsil *esil, int idx) {
-	rz_return_if_fail(esil);
-	size_t i;
-	RzAnalysisEsilTrace *trace = esil->trace;
-	// Restore initial state when going backward
-	if (idx < esil->trace->idx) {
-		// Restore initial registers value
-		for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
-			RzRegArena *a = esil->analysis->reg->regset[i].arena;
-			RzRegArena *b = trace->arena[i];
-			if (a && b) {
-				memcpy(a->bytes, b->bytes, a->size);
-			}
-		}
-		// Restore initial stack memory
-		esil->analysis->iob.write_at(esil->analysis->iob.io, trace->stack_addr,
-			trace->stack_data, trace->stack_size);
-	}
-	// Apply latest changes to registers and memory
-	esil->trace->idx = idx;
-	RzListIter *iter;
-	RzRegItem *ri;
-	rz_list_foreach (esil->analysis->reg->allregs, iter, ri) {
-		restore_register(esil, ri, idx);
-	}
-	ht_up_foreach(trace->memory, restore_memory_cb, esil);
+/**
+ * \brief Replaces the trace of \p esil with the one saved at \p path
+ *
+ * Registers and memory are moved to the state of the first step of the
+ * loaded trace, which can then be replayed by stepping. The instructions
+ * of the trace are not saved, so they are not listed.
+ */
+RZ_API bool rz_analysis_esil_trace_load(RZ_NONNULL RzAnalysisEsil *esil, RZ_NONNULL const char *path) {
+	rz_return_val_if_fail(esil && path, false);
+	RzAnalysisEsilTrace *trace = RZ_NEW0(RzAnalysisEsilTrace);
+	if (!trace) {
+		return false;
+	}
+	trace->instructions = rz_pvector_new((RzPVectorFree)rz_analysis_il_trace_instruction_free);
+	trace->log = rz_analysis_esil_trace_log_load(path);
+	if (!trace->instructions || !trace->log ||
+		!rz_analysis_esil_trace_log_seek(trace->log, esil->analysis->reg, &esil->analysis->iob, 0)) {
+		rz_analysis_esil_trace_free(trace);
+		return false;
+	}
+	trace->end_idx = rz_analysis_esil_trace_log_count(trace->log);
+	rz_analysis_esil_trace_free(esil->trace);
+	esil->trace = trace;
+	return true;
 }
 
 static void print_instruction_ops(RzILTraceInstruction *instruction, int idx, RzILTraceInsOp focus) {
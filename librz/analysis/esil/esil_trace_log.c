@@ -0,0 +1,1038 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+
+/*
+ * Compact log of the registers and memory changes of an ESIL trace, used to
+ * move back and forth in the emulation history.
+ *
+ * Steps are appended to chunks of at most TRACE_LOG_CHUNK_STEPS steps, each
+ * one being a stream of varints decodable on its own:
+ *
+ *   zigzag(pc - previous pc)
+ *   n, n * { register name index, value }
+ *   n, n * { zigzag(addr - previous run end), len, len * new byte }
+ *
+ * Every chunk also keeps a copy of the register arenas when it started and,
+ * for each byte written within it, the value before the first write and the
+ * one after the last write. Aligned groups of 2^k closed chunks, for k from
+ * TRACE_LOG_CHECKPOINT_LEVEL, get a checkpoint merging their summaries the
+ * same way. Moving to a step means writing the old or new values of the
+ * largest checkpoints and chunks covering the ones in between, O(log n) of
+ * them, and replaying the steps of a single chunk, which is found with a
+ * binary search on the first steps of the chunks.
+ *
+ * The state at step N is the one before executing the step, with the PC
+ * set to its address.
+ */
+
+#define TRACE_LOG_CHUNK_STEPS      256
+#define TRACE_LOG_CHECKPOINT_LEVEL 3 ///< the smallest checkpoints cover 1 << TRACE_LOG_CHECKPOINT_LEVEL chunks
+#define TRACE_LOG_LEVELS           32
+#define TRACE_LOG_MAGIC            "RZETRACE"
+#define TRACE_LOG_VERSION          1
+#define TRACE_BYTE_WRITTEN         (1 << 16) ///< flags the bytes of a rebuilt dirty table written by the kept steps
+
+typedef struct {
+	ut32 first; ///< index of the first step
+	ut32 count; ///< number of steps
+	RzVector /*<ut8>*/ steps; ///< encoded steps
+	RzVector /*<ut8>*/ summary; ///< encoded memory summary, filled when the chunk is closed
+	ut8 *regs; ///< register arenas when the chunk started
+} TraceChunk;
+
+typedef struct {
+	ut32 name; ///< index in RzAnalysisEsilTraceLog.names
+	ut64 value;
+} TraceRegWrite;
+
+typedef struct {
+	ut64 addr;
+	ut32 len; ///< number of bytes taken from RzAnalysisEsilTraceLog.step_bytes
+} TraceMemRun;
+
+struct rz_analysis_esil_trace_log_t {
+	RzVector /*<TraceChunk>*/ chunks;
+	RzVector /*<RzVector<ut8>>*/ checkpoints[TRACE_LOG_LEVELS]; ///< merged summaries of the chunks [i << level, (i + 1) << level)
+	RzPVector /*<char *>*/ names; ///< names of the written registers
+	HtPP /*<char *, ut32>*/ *names_idx; ///< register name -> index in names + 1
+	ut32 arena_size[RZ_REG_TYPE_LAST]; ///< size of the register arenas in the snapshots
+	ut32 regs_size; ///< size of a snapshot
+	ut32 count; ///< number of steps
+	ut32 pos; ///< step matching the state of registers and memory
+	HtUP /*<ut64, ut16>*/ *dirty; ///< bytes written in the open chunk, old | new << 8
+	ut64 last_pc; ///< address of the last step in the open chunk
+	ut64 last_mem; ///< end of the last memory run in the open chunk
+	bool in_step; ///< a step is being recorded
+	ut64 step_pc;
+	RzVector /*<TraceRegWrite>*/ step_regs;
+	RzVector /*<TraceMemRun>*/ step_runs;
+	RzVector /*<ut8>*/ step_bytes;
+};
+
+typedef struct {
+	const ut8 *p;
+	const ut8 *end;
+	bool error;
+} LogReader;
+
+static inline ut64 zigzag_encode(st64 v) {
+	return ((ut64)v << 1) ^ (ut64)(v >> 63);
+}
+
+static inline st64 zigzag_decode(ut64 v) {
+	return (st64)(v >> 1) ^ -(st64)(v & 1);
+}
+
+static bool write_bytes(RzVector *buf, const ut8 *data, size_t len) {
+	return !len || rz_vector_insert_range(buf, buf->len, (void *)data, len);
+}
+
+static bool write_uleb(RzVector *buf, ut64 v) {
+	ut8 tmp[10];
+	size_t len = 0;
+	do {
+		ut8 b = v & 0x7f;
+		v >>= 7;
+		tmp[len++] = v ? b | 0x80 : b;
+	} while (v);
+	return write_bytes(buf, tmp, len);
+}
+
+static inline bool write_sleb(RzVector *buf, st64 v) {
+	return write_uleb(buf, zigzag_encode(v));
+}
+
+static inline void reader_init(LogReader *r, const ut8 *data, size_t len) {
+	r->p = data;
+	r->end = data + len;
+	r->error = false;
+}
+
+static ut64 read_uleb(LogReader *r) {
+	ut64 v = 0;
+	size_t len = r->error ? 0 : read_u64_leb128(r->p, r->end, &v);
+	if (!len) {
+		r->error = true;
+		return 0;
+	}
+	r->p += len;
+	return v;
+}
+
+static inline st64 read_sleb(LogReader *r) {
+	return zigzag_decode(read_uleb(r));
+}
+
+static const ut8 *read_bytes(LogReader *r, ut64 len) {
+	if (r->error || len > (size_t)(r->end - r->p)) {
+		r->error = true;
+		return NULL;
+	}
+	const ut8 *p = r->p;
+	r->p += len;
+	return p;
+}
+
+static void chunk_fini(void *e, void *user) {
+	TraceChunk *chunk = e;
+	rz_vector_fini(&chunk->steps);
+	rz_vector_fini(&chunk->summary);
+	free(chunk->regs);
+}
+
+static void summary_fini(void *e, void *user) {
+	rz_vector_fini(e);
+}
+
+static void chunk_init(TraceChunk *chunk, ut32 first) {
+	memset(chunk, 0, sizeof(*chunk));
+	chunk->first = first;
+	rz_vector_init(&chunk->steps, 1, NULL, NULL);
+	rz_vector_init(&chunk->summary, 1, NULL, NULL);
+}
+
+/**
+ * \brief Creates an empty trace log
+ */
+RZ_API RZ_OWN RzAnalysisEsilTraceLog *rz_analysis_esil_trace_log_new(void) {
+	RzAnalysisEsilTraceLog *log = RZ_NEW0(RzAnalysisEsilTraceLog);
+	if (!log) {
+		return NULL;
+	}
+	rz_vector_init(&log->chunks, sizeof(TraceChunk), chunk_fini, NULL);
+	for (int i = 0; i < TRACE_LOG_LEVELS; i++) {
+		rz_vector_init(&log->checkpoints[i], sizeof(RzVector), summary_fini, NULL);
+	}
+	rz_pvector_init(&log->names, free);
+	rz_vector_init(&log->step_regs, sizeof(TraceRegWrite), NULL, NULL);
+	rz_vector_init(&log->step_runs, sizeof(TraceMemRun), NULL, NULL);
+	rz_vector_init(&log->step_bytes, 1, NULL, NULL);
+	log->names_idx = ht_pp_new0();
+	if (!log->names_idx) {
+		rz_analysis_esil_trace_log_free(log);
+		return NULL;
+	}
+	return log;
+}
+
+RZ_API void rz_analysis_esil_trace_log_free(RZ_NULLABLE RzAnalysisEsilTraceLog *log) {
+	if (!log) {
+		return;
+	}
+	rz_vector_fini(&log->chunks);
+	for (int i = 0; i < TRACE_LOG_LEVELS; i++) {
+		rz_vector_fini(&log->checkpoints[i]);
+	}
+	rz_pvector_fini(&log->names);
+	ht_pp_free(log->names_idx);
+	ht_up_free(log->dirty);
+	rz_vector_fini(&log->step_regs);
+	rz_vector_fini(&log->step_runs);
+	rz_vector_fini(&log->step_bytes);
+	free(log);
+}
+
+/**
+ * \brief Returns the number of steps in the log
+ */
+RZ_API ut32 rz_analysis_esil_trace_log_count(RZ_NONNULL RzAnalysisEsilTraceLog *log) {
+	rz_return_val_if_fail(log, 0);
+	return log->count;
+}
+
+static bool layout_matches(RzAnalysisEsilTraceLog *log, RzReg *reg) {
+	for (int i = 0; i < RZ_REG_TYPE_LAST; i++) {
+		RzRegArena *a = reg->regset[i].arena;
+		if ((a && a->size > 0 ? (ut32)a->size : 0) != log->arena_size[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void regs_save(RzAnalysisEsilTraceLog *log, RzReg *reg, ut8 *dst) {
+	for (int i = 0; i < RZ_REG_TYPE_LAST; i++) {
+		RzRegArena *a = reg->regset[i].arena;
+		if (log->arena_size[i] && a->bytes) {
+			memcpy(dst, a->bytes, log->arena_size[i]);
+		}
+		dst += log->arena_size[i];
+	}
+}
+
+static void regs_restore(RzAnalysisEsilTraceLog *log, RzReg *reg, const ut8 *src) {
+	for (int i = 0; i < RZ_REG_TYPE_LAST; i++) {
+		RzRegArena *a = reg->regset[i].arena;
+		if (log->arena_size[i] && a->bytes) {
+			memcpy(a->bytes, src, log->arena_size[i]);
+		}
+		src += log->arena_size[i];
+	}
+}
+
+static bool dirty_collect_cb(void *user, const ut64 key, const void *value) {
+	rz_vector_push(user, (void *)&key);
+	return true;
+}
+
+static int addr_cmp(const void *a, const void *b) {
+	ut64 x = *(const ut64 *)a, y = *(const ut64 *)b;
+	return x < y ? -1 : x > y;
+}
+
+/**
+ * Encodes the bytes written in the open chunk into \p out, as sorted runs of
+ * { addr - previous run end, len, len * old byte, len * new byte }
+ */
+static bool summary_encode(HtUP *dirty, RzVector *out) {
+	RzVector addrs;
+	rz_vector_init(&addrs, sizeof(ut64), NULL, NULL);
+	if (dirty->count && !rz_vector_reserve(&addrs, dirty->count)) {
+		return false;
+	}
+	ht_up_foreach(dirty, dirty_collect_cb, &addrs);
+	if (addrs.len) {
+		qsort(addrs.a, addrs.len, sizeof(ut64), addr_cmp);
+	}
+	bool ret = true;
+	ut64 *sorted = addrs.a;
+	ut64 prev_end = 0;
+	size_t i = 0;
+	while (ret && i < addrs.len) {
+		size_t len = 1;
+		while (i + len < addrs.len && sorted[i + len] == sorted[i] + len) {
+			len++;
+		}
+		ret = write_uleb(out, sorted[i] - prev_end) && write_uleb(out, len);
+		for (int shift = 0; ret && shift <= 8; shift += 8) {
+			for (size_t j = 0; ret && j < len; j++) {
+				ut8 b = (size_t)ht_up_find(dirty, sorted[i + j], NULL) >> shift;
+				ret = write_bytes(out, &b, 1);
+			}
+		}
+		prev_end = sorted[i] + len;
+		i += len;
+	}
+	rz_vector_fini(&addrs);
+	return ret;
+}
+
+/**
+ * Returns the encoded memory summary of \p chunk, encoding the one of the
+ * open chunk into \p tmp.
+ */
+static const RzVector *summary_get(RzAnalysisEsilTraceLog *log, TraceChunk *chunk, RzVector *tmp) {
+	if (log->dirty && chunk == rz_vector_tail(&log->chunks)) {
+		rz_vector_clear(tmp);
+		return summary_encode(log->dirty, tmp) ? tmp : NULL;
+	}
+	return &chunk->summary;
+}
+
+/**
+ * Writes to memory the values of the bytes of a summary at the start
+ * (\p new false) or at the end (\p new true) of its chunk
+ */
+static bool summary_apply(const RzVector *summary, RzIOBind *iob, bool new) {
+	if (!summary) {
+		return false;
+	}
+	LogReader r;
+	reader_init(&r, summary->a, summary->len);
+	ut64 addr = 0;
+	while (!r.error && r.p < r.end) {
+		addr += read_uleb(&r);
+		ut64 len = read_uleb(&r);
+		const ut8 *old = read_bytes(&r, len);
+		const ut8 *cur = read_bytes(&r, len);
+		if (r.error || len > INT_MAX) {
+			return false;
+		}
+		iob->write_at(iob->io, addr, new ? cur : old, (int)len);
+		addr += len;
+	}
+	return !r.error;
+}
+
+/**
+ * Merges the bytes of \p summary, which follows the ones already in \p dirty,
+ * into \p dirty as old | new << 8
+ */
+static bool summary_merge(const RzVector *summary, HtUP *dirty) {
+	LogReader r;
+	reader_init(&r, summary->a, summary->len);
+	ut64 addr = 0;
+	while (!r.error && r.p < r.end) {
+		addr += read_uleb(&r);
+		ut64 len = read_uleb(&r);
+		const ut8 *old = read_bytes(&r, len);
+		const ut8 *cur = read_bytes(&r, len);
+		if (r.error) {
+			return false;
+		}
+		for (ut64 i = 0; i < len; i++) {
+			bool found = false;
+			size_t prev = (size_t)ht_up_find(dirty, addr + i, &found);
+			ut8 first = found ? prev & 0xff : old[i];
+			if (!ht_up_update(dirty, addr + i, (void *)(size_t)(first | (cur[i] << 8)))) {
+				return false;
+			}
+		}
+		addr += len;
+	}
+	return !r.error;
+}
+
+/**
+ * Returns the checkpoint of the chunks [start, start + (1 << level)), or NULL
+ * if \p start is not aligned or the checkpoint was not built.
+ */
+static const RzVector *checkpoint_get(RzAnalysisEsilTraceLog *log, int level, size_t start) {
+	if (start & (((size_t)1 << level) - 1)) {
+		return NULL;
+	}
+	RzVector *checkpoints = &log->checkpoints[level];
+	size_t idx = start >> level;
+	return idx < checkpoints->len ? rz_vector_index_ptr(checkpoints, idx) : NULL;
+}
+
+/**
+ * Builds the checkpoints ending with the last closed chunk, from the ones of
+ * the level below. A failure only leaves seeking with smaller steps.
+ */
+static void checkpoints_add(RzAnalysisEsilTraceLog *log) {
+	size_t closed = log->chunks.len - (log->dirty ? 1 : 0);
+	for (int level = TRACE_LOG_CHECKPOINT_LEVEL; closed && level < TRACE_LOG_LEVELS; level++) {
+		size_t size = (size_t)1 << level;
+		if (closed & (size - 1)) {
+			break;
+		}
+		size_t start = closed - size;
+		RzVector *checkpoints = &log->checkpoints[level];
+		if (checkpoints->len != start >> level) {
+			break;
+		}
+		int sub = level == TRACE_LOG_CHECKPOINT_LEVEL ? 0 : level - 1;
+		size_t sub_size = (size_t)1 << sub;
+		HtUP *dirty = ht_up_new0();
+		bool ok = dirty;
+		for (size_t c = start; ok && c < closed; c += sub_size) {
+			const RzVector *summary = sub ? checkpoint_get(log, sub, c) : &((TraceChunk *)rz_vector_index_ptr(&log->chunks, c))->summary;
+			ok = summary && summary_merge(summary, dirty);
+		}
+		RzVector merged;
+		rz_vector_init(&merged, 1, NULL, NULL);
+		ok = ok && summary_encode(dirty, &merged);
+		ht_up_free(dirty);
+		rz_vector_shrink(&merged);
+		if (!ok || !rz_vector_push(checkpoints, &merged)) {
+			rz_vector_fini(&merged);
+			break;
+		}
+	}
+}
+
+/**
+ * Drops the checkpoints covering chunks from \p closed
+ */
+static void checkpoints_truncate(RzAnalysisEsilTraceLog *log, size_t closed) {
+	for (int level = TRACE_LOG_CHECKPOINT_LEVEL; level < TRACE_LOG_LEVELS; level++) {
+		RzVector *checkpoints = &log->checkpoints[level];
+		while (checkpoints->len && (checkpoints->len << level) > closed) {
+			RzVector dropped;
+			rz_vector_pop(checkpoints, &dropped);
+			rz_vector_fini(&dropped);
+		}
+	}
+}
+
+/**
+ * Writes to memory the values of the bytes written by the chunks [from, to)
+ * at their start (\p new false) or at their end (\p new true), applying the
+ * largest checkpoints covering the range.
+ */
+static bool summaries_apply(RzAnalysisEsilTraceLog *log, size_t from, size_t to, RzIOBind *iob, bool new) {
+	RzVector tmp;
+	rz_vector_init(&tmp, 1, NULL, NULL);
+	bool ok = true;
+	while (ok && from < to) {
+		// forward from the start, or backward from the end
+		size_t size = 1;
+		const RzVector *summary = NULL;
+		for (int level = TRACE_LOG_LEVELS - 1; !summary && level >= TRACE_LOG_CHECKPOINT_LEVEL; level--) {
+			size = (size_t)1 << level;
+			if (to - from >= size) {
+				summary = checkpoint_get(log, level, new ? from : to - size);
+			}
+		}
+		if (!summary) {
+			size = 1;
+			summary = summary_get(log, rz_vector_index_ptr(&log->chunks, new ? from : to - 1), &tmp);
+		}
+		ok = summary_apply(summary, iob, new);
+		if (new) {
+			from += size;
+		} else {
+			to -= size;
+		}
+	}
+	rz_vector_fini(&tmp);
+	return ok;
+}
+
+static bool chunk_open(RzAnalysisEsilTraceLog *log, RzReg *reg) {
+	if (!log->count) {
+		log->regs_size = 0;
+		for (int i = 0; i < RZ_REG_TYPE_LAST; i++) {
+			RzRegArena *a = reg->regset[i].arena;
+			log->arena_size[i] = a && a->size > 0 ? a->size : 0;
+			log->regs_size += log->arena_size[i];
+		}
+	} else if (!layout_matches(log, reg)) {
+		RZ_LOG_ERROR("The register profile changed, cannot extend the ESIL trace\n");
+		return false;
+	}
+	TraceChunk chunk;
+	chunk_init(&chunk, log->count);
+	chunk.regs = malloc(RZ_MAX(log->regs_size, 1));
+	HtUP *dirty = ht_up_new0();
+	if (!chunk.regs || !dirty) {
+		goto error;
+	}
+	regs_save(log, reg, chunk.regs);
+	if (log->dirty) {
+		// Close the previous chunk
+		TraceChunk *prev = rz_vector_tail(&log->chunks);
+		if (!summary_encode(log->dirty, &prev->summary)) {
+			rz_vector_clear(&prev->summary);
+			goto error;
+		}
+		rz_vector_shrink(&prev->steps);
+		ht_up_free(log->dirty);
+		log->dirty = NULL;
+		checkpoints_add(log);
+	}
+	if (!rz_vector_push(&log->chunks, &chunk)) {
+		goto error;
+	}
+	log->dirty = dirty;
+	log->last_pc = 0;
+	log->last_mem = 0;
+	return true;
+error:
+	ht_up_free(dirty);
+	chunk_fini(&chunk, NULL);
+	return false;
+}
+
+static bool log_truncate(RzAnalysisEsilTraceLog *log);
+
+/**
+ * \brief Starts recording the step at the end of the log
+ *
+ * The state of the registers is saved when a new chunk is started. If the
+ * log was moved back, the steps from its current one are dropped first.
+ *
+ * \param log Trace log
+ * \param reg Registers, in the state before executing the step
+ * \param pc Address of the step
+ */
+RZ_API bool rz_analysis_esil_trace_log_step_begin(RZ_NONNULL RzAnalysisEsilTraceLog *log, RZ_NONNULL RzReg *reg, ut64 pc) {
+	rz_return_val_if_fail(log && reg, false);
+	if (log->in_step || (log->pos != log->count && !log_truncate(log))) {
+		return false;
+	}
+	TraceChunk *chunk = rz_vector_empty(&log->chunks) ? NULL : rz_vector_tail(&log->chunks);
+	if (!log->dirty || !chunk || chunk->count >= TRACE_LOG_CHUNK_STEPS) {
+		if (!chunk_open(log, reg)) {
+			return false;
+		}
+	}
+	log->in_step = true;
+	log->step_pc = pc;
+	rz_vector_clear(&log->step_regs);
+	rz_vector_clear(&log->step_runs);
+	rz_vector_clear(&log->step_bytes);
+	return true;
+}
+
+static ut32 name_index(RzAnalysisEsilTraceLog *log, const char *name, bool *ok) {
+	bool found = false;
+	size_t idx = (size_t)ht_pp_find(log->names_idx, name, &found);
+	if (found) {
+		*ok = true;
+		return idx - 1;
+	}
+	char *dup = strdup(name);
+	if (!dup || !rz_pvector_push(&log->names, dup)) {
+		free(dup);
+		*ok = false;
+		return 0;
+	}
+	idx = rz_pvector_len(&log->names);
+	*ok = ht_pp_insert(log->names_idx, name, (void *)idx);
+	return idx - 1;
+}
+
+/**
+ * \brief Records a register write of the current step
+ *
+ * \param log Trace log
+ * \param name Name of the register in the profile
+ * \param value Written value
+ */
+RZ_API bool rz_analysis_esil_trace_log_reg_write(RZ_NONNULL RzAnalysisEsilTraceLog *log, RZ_NONNULL const char *name, ut64 value) {
+	rz_return_val_if_fail(log && name, false);
+	if (!log->in_step) {
+		return false;
+	}
+	bool ok;
+	ut32 idx = name_index(log, name, &ok);
+	if (!ok) {
+		return false;
+	}
+	TraceRegWrite *w;
+	rz_vector_foreach(&log->step_regs, w) {
+		if (w->name == idx) {
+			w->value = value;
+			return true;
+		}
+	}
+	TraceRegWrite nw = { idx, value };
+	return rz_vector_push(&log->step_regs, &nw);
+}
+
+/**
+ * \brief Records a memory write of the current step
+ *
+ * \param log Trace log
+ * \param addr Written address
+ * \param old Content of the memory before the write
+ * \param buf Written data
+ * \param len Length of \p old and \p buf
+ */
+RZ_API bool rz_analysis_esil_trace_log_mem_write(RZ_NONNULL RzAnalysisEsilTraceLog *log, ut64 addr, RZ_NONNULL const ut8 *old, RZ_NONNULL const ut8 *buf, int len) {
+	rz_return_val_if_fail(log && old && buf, false);
+	if (!log->in_step || len <= 0) {
+		return false;
+	}
+	for (int i = 0; i < len; i++) {
+		bool found = false;
+		size_t v = (size_t)ht_up_find(log->dirty, addr + i, &found);
+		v = (found ? v & 0xff : old[i]) | (buf[i] << 8);
+		ht_up_update(log->dirty, addr + i, (void *)v);
+	}
+	if (!write_bytes(&log->step_bytes, buf, len)) {
+		return false;
+	}
+	TraceMemRun *last = rz_vector_empty(&log->step_runs) ? NULL : rz_vector_tail(&log->step_runs);
+	if (last && last->addr + last->len == addr) {
+		last->len += len;
+		return true;
+	}
+	TraceMemRun run = { addr, len };
+	return rz_vector_push(&log->step_runs, &run);
+}
+
+/**
+ * \brief Appends the step being recorded to the log
+ */
+RZ_API bool rz_analysis_esil_trace_log_step_end(RZ_NONNULL RzAnalysisEsilTraceLog *log) {
+	rz_return_val_if_fail(log, false);
+	if (!log->in_step) {
+		return false;
+	}
+	log->in_step = false;
+	TraceChunk *chunk = rz_vector_tail(&log->chunks);
+	RzVector *out = &chunk->steps;
+	size_t mark = out->len;
+	bool ok = write_sleb(out, log->step_pc - log->last_pc) &&
+		write_uleb(out, log->step_regs.len);
+	TraceRegWrite *w;
+	rz_vector_foreach(&log->step_regs, w) {
+		ok = ok && write_uleb(out, w->name) && write_uleb(out, w->value);
+	}
+	ok = ok && write_uleb(out, log->step_runs.len);
+	ut64 mem = log->last_mem;
+	const ut8 *bytes = log->step_bytes.a;
+	TraceMemRun *run;
+	rz_vector_foreach(&log->step_runs, run) {
+		ok = ok && write_sleb(out, run->addr - mem) && write_uleb(out, run->len) &&
+			write_bytes(out, bytes, run->len);
+		bytes += run->len;
+		mem = run->addr + run->len;
+	}
+	if (!ok) {
+		// drop the partially encoded step
+		out->len = mark;
+		return false;
+	}
+	log->last_pc = log->step_pc;
+	log->last_mem = mem;
+	chunk->count++;
+	log->count++;
+	log->pos = log->count;
+	return true;
+}
+
+typedef struct {
+	LogReader r;
+	ut64 pc;
+	ut64 mem;
+} ChunkIter;
+
+static void chunk_iter_init(ChunkIter *it, TraceChunk *chunk) {
+	reader_init(&it->r, chunk->steps.a, chunk->steps.len);
+	it->pc = 0;
+	it->mem = 0;
+}
+
+static bool chunk_iter_pc(ChunkIter *it) {
+	it->pc += read_sleb(&it->r);
+	return !it->r.error;
+}
+
+/**
+ * Reads the register writes of a step, applying them to \p reg if not NULL
+ */
+static bool chunk_iter_regs(ChunkIter *it, RzAnalysisEsilTraceLog *log, RZ_NULLABLE RzReg *reg) {
+	ut64 n = read_uleb(&it->r);
+	for (ut64 i = 0; i < n && !it->r.error; i++) {
+		ut64 idx = read_uleb(&it->r);
+		ut64 value = read_uleb(&it->r);
+		if (idx >= rz_pvector_len(&log->names)) {
+			return false;
+		}
+		RzRegItem *ri = reg ? rz_reg_get(reg, rz_pvector_at(&log->names, idx), -1) : NULL;
+		if (ri) {
+			rz_reg_set_value(reg, ri, value);
+		}
+	}
+	return !it->r.error;
+}
+
+/**
+ * Reads the memory writes of a step, applying them through \p iob if not NULL
+ * and to the new values of the bytes of \p dirty if not NULL
+ */
+static bool chunk_iter_mem(ChunkIter *it, RZ_NULLABLE RzIOBind *iob, RZ_NULLABLE HtUP *dirty) {
+	ut64 n = read_uleb(&it->r);
+	for (ut64 i = 0; i < n && !it->r.error; i++) {
+		ut64 addr = it->mem + read_sleb(&it->r);
+		ut64 len = read_uleb(&it->r);
+		const ut8 *data = read_bytes(&it->r, len);
+		if (!data || len > INT_MAX) {
+			return false;
+		}
+		if (iob) {
+			iob->write_at(iob->io, addr, data, (int)len);
+		}
+		for (ut64 j = 0; dirty && j < len; j++) {
+			size_t v = (size_t)ht_up_find(dirty, addr + j, NULL);
+			v = (v & 0xff) | (data[j] << 8) | TRACE_BYTE_WRITTEN;
+			ht_up_update(dirty, addr + j, (void *)v);
+		}
+		it->mem = addr + len;
+	}
+	return !it->r.error;
+}
+
+#define CHUNK_FIRST_CMP(x, y) ((x) < ((TraceChunk *)(y))->first ? -1 : 1)
+
+/**
+ * Returns the index of the chunk to replay to reach step \p idx
+ */
+static size_t chunk_find(RzAnalysisEsilTraceLog *log, ut32 idx) {
+	size_t i;
+	rz_vector_upper_bound(&log->chunks, idx, i, CHUNK_FIRST_CMP);
+	return i > 0 ? i - 1 : 0;
+}
+
+/**
+ * Loads the values of the bytes of \p summary at the start of its chunk into
+ * \p dirty, as old | old << 8
+ */
+static bool summary_load(const RzVector *summary, HtUP *dirty) {
+	if (!summary) {
+		return false;
+	}
+	LogReader r;
+	reader_init(&r, summary->a, summary->len);
+	ut64 addr = 0;
+	while (!r.error && r.p < r.end) {
+		addr += read_uleb(&r);
+		ut64 len = read_uleb(&r);
+		const ut8 *old = read_bytes(&r, len);
+		if (!read_bytes(&r, len)) {
+			return false;
+		}
+		for (ut64 i = 0; i < len; i++) {
+			ht_up_update(dirty, addr + i, (void *)(size_t)(old[i] | (old[i] << 8)));
+		}
+		addr += len;
+	}
+	return !r.error;
+}
+
+static bool dirty_unwritten_cb(void *user, const ut64 key, const void *value) {
+	if (!((size_t)value & TRACE_BYTE_WRITTEN)) {
+		rz_vector_push(user, (void *)&key);
+	}
+	return true;
+}
+
+/**
+ * Drops the steps of \p chunk from log->pos and rebuilds into \p dirty the
+ * bytes written by the ones before, to reopen it.
+ */
+static bool chunk_truncate(RzAnalysisEsilTraceLog *log, TraceChunk *chunk, HtUP *dirty) {
+	RzVector tmp;
+	rz_vector_init(&tmp, 1, NULL, NULL);
+	bool ok = summary_load(summary_get(log, chunk, &tmp), dirty);
+	rz_vector_fini(&tmp);
+	ChunkIter it;
+	chunk_iter_init(&it, chunk);
+	for (ut32 s = chunk->first; ok && s < log->pos; s++) {
+		ok = chunk_iter_pc(&it) && chunk_iter_regs(&it, log, NULL) && chunk_iter_mem(&it, NULL, dirty);
+	}
+	if (!ok) {
+		return false;
+	}
+	// only keep the bytes written before log->pos
+	RzVector unwritten;
+	rz_vector_init(&unwritten, sizeof(ut64), NULL, NULL);
+	ht_up_foreach(dirty, dirty_unwritten_cb, &unwritten);
+	ut64 *addr;
+	rz_vector_foreach(&unwritten, addr) {
+		ht_up_delete(dirty, *addr);
+	}
+	rz_vector_fini(&unwritten);
+	chunk->steps.len = it.r.p - (const ut8 *)chunk->steps.a;
+	chunk->count = log->pos - chunk->first;
+	rz_vector_clear(&chunk->summary);
+	log->last_pc = it.pc;
+	log->last_mem = it.mem;
+	return true;
+}
+
+/**
+ * Drops the steps from log->pos to the end of the log, so that the next one
+ * is recorded there.
+ */
+static bool log_truncate(RzAnalysisEsilTraceLog *log) {
+	size_t c = chunk_find(log, log->pos);
+	TraceChunk *chunk = rz_vector_index_ptr(&log->chunks, c);
+	HtUP *dirty = NULL;
+	checkpoints_truncate(log, c);
+	if (log->pos > chunk->first) {
+		dirty = ht_up_new0();
+		if (!dirty || !chunk_truncate(log, chunk, dirty)) {
+			RZ_LOG_ERROR("Cannot truncate the ESIL trace\n");
+			ht_up_free(dirty);
+			return false;
+		}
+		c++;
+	}
+	while (rz_vector_len(&log->chunks) > c) {
+		TraceChunk dropped;
+		rz_vector_pop(&log->chunks, &dropped);
+		chunk_fini(&dropped, NULL);
+	}
+	ht_up_free(log->dirty);
+	log->dirty = dirty;
+	log->count = log->pos;
+	return true;
+}
+
+/**
+ * \brief Gets the addresses of a range of steps
+ *
+ * \param log Trace log
+ * \param from First step
+ * \param n Number of steps
+ * \param out Array of at least \p n addresses
+ * \return Number of addresses written to \p out
+ */
+RZ_API ut32 rz_analysis_esil_trace_log_pcs(RZ_NONNULL RzAnalysisEsilTraceLog *log, ut32 from, ut32 n, RZ_OUT ut64 *out) {
+	rz_return_val_if_fail(log && out, 0);
+	ut32 done = 0;
+	if (from >= log->count) {
+		return 0;
+	}
+	n = RZ_MIN(n, log->count - from);
+	for (size_t c = chunk_find(log, from); done < n && c < log->chunks.len; c++) {
+		TraceChunk *chunk = rz_vector_index_ptr(&log->chunks, c);
+		ChunkIter it;
+		chunk_iter_init(&it, chunk);
+		for (ut32 s = chunk->first; done < n && s < chunk->first + chunk->count; s++) {
+			if (!chunk_iter_pc(&it)) {
+				return done;
+			}
+			if (s >= from) {
+				out[done++] = it.pc;
+			}
+			if (!chunk_iter_regs(&it, log, NULL) || !chunk_iter_mem(&it, NULL, NULL)) {
+				return done;
+			}
+		}
+	}
+	return done;
+}
+
+/**
+ * \brief Moves registers and memory to the state of step \p idx
+ *
+ * Registers and memory must be in the state of the current step of the log,
+ * which is the last one while recording or after loading a log. The memory
+ * of the chunks in between is moved with O(log n) checkpoints and summaries.
+ *
+ * \param log Trace log
+ * \param reg Registers to update
+ * \param iob Binding used to write the memory
+ * \param idx Step to reach, up to rz_analysis_esil_trace_log_count()
+ */
+RZ_API bool rz_analysis_esil_trace_log_seek(RZ_NONNULL RzAnalysisEsilTraceLog *log, RZ_NONNULL RzReg *reg, RZ_NONNULL RzIOBind *iob, ut32 idx) {
+	rz_return_val_if_fail(log && reg && iob, false);
+	if (log->in_step || idx > log->count) {
+		return false;
+	}
+	if (!log->count) {
+		return true;
+	}
+	if (!layout_matches(log, reg)) {
+		RZ_LOG_ERROR("The register profile does not match the ESIL trace\n");
+		return false;
+	}
+	size_t target = chunk_find(log, idx);
+	size_t cur = chunk_find(log, log->pos);
+	TraceChunk *chunk = rz_vector_index_ptr(&log->chunks, target);
+	ut32 mem_from = chunk->first;
+	bool ok = true;
+	if (target == cur && idx >= log->pos) {
+		mem_from = log->pos;
+	} else if (target > cur) {
+		ok = summaries_apply(log, cur, target, iob, true);
+	} else {
+		ok = summaries_apply(log, target, cur + 1, iob, false);
+	}
+	if (!ok) {
+		RZ_LOG_ERROR("Corrupted memory summary in the ESIL trace\n");
+		return false;
+	}
+
+	regs_restore(log, reg, chunk->regs);
+	RzRegItem *pc_ri = rz_reg_get_by_role(reg, RZ_REG_NAME_PC);
+	ChunkIter it;
+	chunk_iter_init(&it, chunk);
+	for (ut32 s = chunk->first; ok && s <= idx && s < chunk->first + chunk->count; s++) {
+		ok = chunk_iter_pc(&it);
+		if (ok && pc_ri) {
+			rz_reg_set_value(reg, pc_ri, it.pc);
+		}
+		if (s == idx) {
+			break;
+		}
+		ok = ok && chunk_iter_regs(&it, log, reg) && chunk_iter_mem(&it, s >= mem_from ? iob : NULL, NULL);
+	}
+	if (!ok) {
+		RZ_LOG_ERROR("Corrupted step in the ESIL trace\n");
+		return false;
+	}
+	log->pos = idx;
+	return true;
+}
+
+/**
+ * \brief Saves the log to \p path
+ */
+RZ_API bool rz_analysis_esil_trace_log_save(RZ_NONNULL RzAnalysisEsilTraceLog *log, RZ_NONNULL const char *path) {
+	rz_return_val_if_fail(log && path, false);
+	RzVector buf, tmp;
+	rz_vector_init(&buf, 1, NULL, NULL);
+	rz_vector_init(&tmp, 1, NULL, NULL);
+	bool ok = write_bytes(&buf, (const ut8 *)TRACE_LOG_MAGIC, strlen(TRACE_LOG_MAGIC)) &&
+		write_uleb(&buf, TRACE_LOG_VERSION) &&
+		write_uleb(&buf, rz_pvector_len(&log->names));
+	void **it;
+	rz_pvector_foreach (&log->names, it) {
+		const char *name = *it;
+		size_t len = strlen(name);
+		ok = ok && write_uleb(&buf, len) && write_bytes(&buf, (const ut8 *)name, len);
+	}
+	ok = ok && write_uleb(&buf, RZ_REG_TYPE_LAST);
+	for (int i = 0; i < RZ_REG_TYPE_LAST; i++) {
+		ok = ok && write_uleb(&buf, log->arena_size[i]);
+	}
+	ok = ok && write_uleb(&buf, log->chunks.len);
+	TraceChunk *chunk;
+	rz_vector_foreach(&log->chunks, chunk) {
+		const RzVector *summary = ok ? summary_get(log, chunk, &tmp) : NULL;
+		ok = summary && write_uleb(&buf, chunk->count) &&
+			write_uleb(&buf, chunk->steps.len) && write_bytes(&buf, chunk->steps.a, chunk->steps.len) &&
+			write_uleb(&buf, summary->len) && write_bytes(&buf, summary->a, summary->len) &&
+			write_bytes(&buf, chunk->regs, log->regs_size);
+	}
+	ok = ok && buf.len <= INT_MAX && rz_file_dump(path, buf.a, (int)buf.len, false);
+	rz_vector_fini(&tmp);
+	rz_vector_fini(&buf);
+	return ok;
+}
+
+static bool load_chunks(RzAnalysisEsilTraceLog *log, LogReader *r) {
+	ut64 nchunks = read_uleb(r);
+	for (ut64 i = 0; i < nchunks && !r->error; i++) {
+		ut64 count = read_uleb(r);
+		ut64 steps_len = read_uleb(r);
+		const ut8 *steps = read_bytes(r, steps_len);
+		ut64 summary_len = read_uleb(r);
+		const ut8 *summary = read_bytes(r, summary_len);
+		const ut8 *regs = read_bytes(r, log->regs_size);
+		if (r->error || count > UT32_MAX - log->count) {
+			return false;
+		}
+		TraceChunk chunk;
+		chunk_init(&chunk, log->count);
+		chunk.count = count;
+		chunk.regs = malloc(RZ_MAX(log->regs_size, 1));
+		if (!chunk.regs || !write_bytes(&chunk.steps, steps, steps_len) ||
+			!write_bytes(&chunk.summary, summary, summary_len)) {
+			chunk_fini(&chunk, NULL);
+			return false;
+		}
+		memcpy(chunk.regs, regs, log->regs_size);
+		if (!rz_vector_push(&log->chunks, &chunk)) {
+			chunk_fini(&chunk, NULL);
+			return false;
+		}
+		log->count += count;
+		checkpoints_add(log);
+	}
+	return !r->error;
+}
+
+/**
+ * \brief Loads a log saved with rz_analysis_esil_trace_log_save()
+ *
+ * The loaded log is at its last step, new steps are appended to a new chunk.
+ */
+RZ_API RZ_OWN RzAnalysisEsilTraceLog *rz_analysis_esil_trace_log_load(RZ_NONNULL const char *path) {
+	rz_return_val_if_fail(path, NULL);
+	size_t size = 0;
+	ut8 *data = (ut8 *)rz_file_slurp(path, &size);
+	if (!data) {
+		return NULL;
+	}
+	RzAnalysisEsilTraceLog *log = NULL;
+	size_t magic_len = strlen(TRACE_LOG_MAGIC);
+	if (size < magic_len || memcmp(data, TRACE_LOG_MAGIC, magic_len)) {
+		RZ_LOG_ERROR("%s is not an ESIL trace\n", path);
+		goto error;
+	}
+	LogReader r;
+	reader_init(&r, data + magic_len, size - magic_len);
+	if (read_uleb(&r) != TRACE_LOG_VERSION) {
+		RZ_LOG_ERROR("Unsupported ESIL trace version\n");
+		goto error;
+	}
+	log = rz_analysis_esil_trace_log_new();
+	if (!log) {
+		goto error;
+	}
+	ut64 nnames = read_uleb(&r);
+	for (ut64 i = 0; i < nnames && !r.error; i++) {
+		ut64 len = read_uleb(&r);
+		const char *name = (const char *)read_bytes(&r, len);
+		char *dup = name ? rz_str_ndup(name, len) : NULL;
+		bool ok;
+		if (!dup || name_index(log, dup, &ok) != i || !ok) {
+			free(dup);
+			goto corrupted;
+		}
+		free(dup);
+	}
+	if (read_uleb(&r) != RZ_REG_TYPE_LAST) {
+		goto corrupted;
+	}
+	for (int i = 0; i < RZ_REG_TYPE_LAST; i++) {
+		ut64 arena_size = read_uleb(&r);
+		if (arena_size > INT_MAX || arena_size > size) {
+			goto corrupted;
+		}
+		log->arena_size[i] = arena_size;
+		log->regs_size += arena_size;
+	}
+	if (r.error || !load_chunks(log, &r)) {
+		goto corrupted;
+	}
+	log->pos = log->count;
+	free(data);
+	return log;
+corrupted:
+	RZ_LOG_ERROR("Corrupted ESIL trace %s\n", path);
+error:
+	rz_analysis_esil_trace_log_free(log);
+	free(data);
+	return NULL;
+}
@@ -409,6 +409,20 @@ RZ_API int rz_analysis_hint_bits_at(RzAnalysis *analysis, ut64 addr, RZ_NULLABLE
 	return record->bits;
 }
 
+static ut64 ranged_hint_next(RBTree tree, ut64 addr) {
+	if (addr == UT64_MAX) {
+		return UT64_MAX;
+	}
+	addr++;
+	RBNode *node = rz_rbtree_lower_bound(tree, &addr, ranged_hint_record_cmp, NULL);
+	return node ? container_of(node, RzAnalysisRangedHintRecordBase, rb)->addr : UT64_MAX;
+}
+
+RZ_API ut64 rz_analysis_hint_arch_bits_next(RzAnalysis *analysis, ut64 addr) {
+	rz_return_val_if_fail(analysis, UT64_MAX);
+	return RZ_MIN(ranged_hint_next(analysis->arch_hints, addr), ranged_hint_next(analysis->bits_hints, addr));
+}
+
 RZ_API RZ_NULLABLE const RzVector /*<const RzAnalysisAddrHintRecord>*/ *rz_analysis_addr_hints_at(RzAnalysis *analysis, ut64 addr) {
 	return ht_up_find(analysis->addr_hints, addr, NULL);
 }
@@ -146,6 +146,100 @@ RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, con
 	return ret;
 }
 
+/**
+ * \brief Decodes up to \p count consecutive instructions from \p data
+ *
+ * Each instruction starts where the previous one ends, as when calling
+ * rz_analysis_op() in a loop, which is what happens with the plugins not
+ * implementing the op_batch callback. The other plugins decode runs of
+ * instructions with a single setup of their decoder, using the arch and
+ * bits in use at the start of each run, so a run ends where an arch or
+ * bits hint is placed.
+ *
+ * The decoding stops after \p count instructions, at the end of \p data
+ * or after an instruction that could not be decoded, which is returned too
+ * and reported through \p failed.
+ *
+ * \param analysis RzAnalysis instance
+ * \param ops Array of at least \p count ops, the filled ones must be
+ *            released with rz_analysis_op_fini()
+ * \param count Maximum number of instructions to decode
+ * \param addr Address of the first instruction
+ * \param data Bytes to decode
+ * \param len Size of \p data
+ * \param mask Information to fill in each op
+ * \param failed Set to whether the last op filled is one rz_analysis_op() failed to decode
+ * \return The number of ops filled
+ */
+RZ_API int rz_analysis_op_batch(RzAnalysis *analysis, RZ_OUT RzAnalysisOp *ops, int count, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask, RZ_OUT RZ_NULLABLE bool *failed) {
+	if (failed) {
+		*failed = false;
+	}
+	rz_return_val_if_fail(analysis && ops && data && count >= 0, 0);
+	RzAnalysisOpBatchCallback batch = analysis->cur ? analysis->cur->op_batch : NULL;
+	int n = 0, off = 0;
+	while (n < count && off < len) {
+		ut64 at = addr + off;
+		int decoded = 0;
+		if (batch && !(analysis->pcalign && at % analysis->pcalign)) {
+			if (analysis->coreb.archbits) {
+				analysis->coreb.archbits(analysis->coreb.core, at);
+			}
+			decoded = batch(analysis, ops + n, count - n, at, data + off, len - off, mask);
+		}
+		if (decoded < 1) {
+			// not handled by the plugin, usually an invalid instruction
+			RzAnalysisOp *op = ops + n++;
+			int ret = rz_analysis_op(analysis, op, at, data + off, len - off, mask);
+			if (ret < 1) {
+				if (failed) {
+					*failed = true;
+				}
+				break;
+			}
+			if (op->size < 1) {
+				break;
+			}
+			off += op->size;
+			continue;
+		}
+		ut64 run_end = rz_analysis_hint_arch_bits_next(analysis, at);
+		int end = n + decoded;
+		while (n < end) {
+			RzAnalysisOp *op = ops + n;
+			if (op->addr >= run_end) {
+				// decoded with the arch and bits before the hint
+				break;
+			}
+			if (analysis->pcalign && op->addr % analysis->pcalign) {
+				// left to rz_analysis_op(), which marks it as invalid
+				break;
+			}
+			if (op->nopcode < 1) {
+				op->nopcode = 1;
+			}
+			int size = op->size;
+			if (mask & RZ_ANALYSIS_OP_MASK_HINT) {
+				RzAnalysisHint *hint = rz_analysis_hint_get(analysis, op->addr);
+				if (hint) {
+					rz_analysis_op_hint(op, hint);
+					rz_analysis_hint_free(hint);
+				}
+			}
+			off += op->size;
+			n++;
+			if (op->size != size) {
+				// the next instructions start elsewhere
+				break;
+			}
+		}
+		for (int i = n; i < end; i++) {
+			rz_analysis_op_fini(ops + i);
+		}
+	}
+	return n;
+}
+
 RZ_API RzAnalysisOp *rz_analysis_op_copy(RzAnalysisOp *op) {
 	RzAnalysisOp *nop = RZ_NEW0(RzAnalysisOp);
 	if (!nop) {
@@ -3874,12 +3874,8 @@ static void op_fillval(RzAnalysis *analysis, RzAnalysisOp *op, csh handle, cs_in
 	}
 }
 
-static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
-	ArmCSContext *ctx = (ArmCSContext *)a->plugin_data;
-
-	cs_insn *insn = NULL;
+static bool arm_cs_open(RzAnalysis *a, ArmCSContext *ctx) {
 	int mode = (a->bits == 16) ? CS_MODE_THUMB : CS_MODE_ARM;
-	int n, ret;
 	mode |= (a->big_endian) ? CS_MODE_BIG_ENDIAN : CS_MODE_LITTLE_ENDIAN;
 	if (a->cpu && strstr(a->cpu, "cortex")) {
 		mode |= CS_MODE_MCLASS;
@@ -3891,16 +3887,64 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 		ctx->omode = mode;
 		ctx->obits = a->bits;
 	}
-	op->size = (a->bits == 16) ? 2 : 4;
-	op->addr = addr;
 	if (ctx->handle == 0) {
-		ret = (a->bits == 64) ? cs_open(CS_ARCH_ARM64, mode, &ctx->handle) : cs_open(CS_ARCH_ARM, mode, &ctx->handle);
+		int ret = (a->bits == 64) ? cs_open(CS_ARCH_ARM64, mode, &ctx->handle) : cs_open(CS_ARCH_ARM, mode, &ctx->handle);
 		cs_option(ctx->handle, CS_OPT_DETAIL, CS_OPT_ON);
 		if (ret != CS_ERR_OK) {
 			ctx->handle = 0;
-			return -1;
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Fills \p op from the instruction \p insn decoded from \p buf
+ */
+static void arm_cs_fill_op(RzAnalysis *a, ArmCSContext *ctx, RzAnalysisOp *op, cs_insn *insn, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
+	if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
+		op->mnemonic = rz_str_newf("%s%s%s",
+			insn->mnemonic,
+			insn->op_str[0] ? " " : "",
+			insn->op_str);
+	}
+	// bool thumb = cs_insn_group (handle, insn, ARM_GRP_THUMB);
+	bool thumb = a->bits == 16;
+	op->size = insn->size;
+	op->id = insn->id;
+	if (a->bits == 64) {
+		anop64(ctx, op, insn);
+		if (mask & RZ_ANALYSIS_OP_MASK_OPEX) {
+			opex64(&op->opex, ctx->handle, insn);
+		}
+		if (mask & RZ_ANALYSIS_OP_MASK_ESIL) {
+			analop64_esil(a, op, addr, buf, len, &ctx->handle, insn);
+		}
+	} else {
+		anop32(a, ctx->handle, op, insn, thumb, (ut8 *)buf, len);
+		if (mask & RZ_ANALYSIS_OP_MASK_OPEX) {
+			opex(&op->opex, ctx->handle, insn);
+		}
+		if (mask & RZ_ANALYSIS_OP_MASK_ESIL) {
+			analop_esil(a, op, addr, buf, len, &ctx->handle, insn, thumb);
 		}
 	}
+	set_opdir(op);
+	if (mask & RZ_ANALYSIS_OP_MASK_VAL) {
+		op_fillval(a, op, ctx->handle, insn, a->bits);
+	}
+}
+
+static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
+	ArmCSContext *ctx = (ArmCSContext *)a->plugin_data;
+
+	cs_insn *insn = NULL;
+	int n;
+	op->size = (a->bits == 16) ? 2 : 4;
+	op->addr = addr;
+	if (!arm_cs_open(a, ctx)) {
+		return -1;
+	}
 	int haa = hackyArmAnal(a, op, buf, len);
 	if (haa > 0) {
 		return haa;
@@ -3913,43 +3957,41 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 			op->mnemonic = strdup("invalid");
 		}
 	} else {
-		if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
-			op->mnemonic = rz_str_newf("%s%s%s",
-				insn->mnemonic,
-				insn->op_str[0] ? " " : "",
-				insn->op_str);
-		}
-		// bool thumb = cs_insn_group (handle, insn, ARM_GRP_THUMB);
-		bool thumb = a->bits == 16;
-		op->size = insn->size;
-		op->id = insn->id;
-		if (a->bits == 64) {
-			anop64(ctx, op, insn);
-			if (mask & RZ_ANALYSIS_OP_MASK_OPEX) {
-				opex64(&op->opex, ctx->handle, insn);
-			}
-			if (mask & RZ_ANALYSIS_OP_MASK_ESIL) {
-				analop64_esil(a, op, addr, buf, len, &ctx->handle, insn);
-			}
-		} else {
-			anop32(a, ctx->handle, op, insn, thumb, (ut8 *)buf, len);
-			if (mask & RZ_ANALYSIS_OP_MASK_OPEX) {
-				opex(&op->opex, ctx->handle, insn);
-			}
-			if (mask & RZ_ANALYSIS_OP_MASK_ESIL) {
-				analop_esil(a, op, addr, buf, len, &ctx->handle, insn, thumb);
-			}
-		}
-		set_opdir(op);
-		if (mask & RZ_ANALYSIS_OP_MASK_VAL) {
-			op_fillval(a, op, ctx->handle, insn, a->bits);
-		}
+		arm_cs_fill_op(a, ctx, op, insn, addr, buf, len, mask);
 		cs_free(insn, n);
 	}
 	//		cs_close (&handle);
 	return op->size;
 }
 
+/**
+ * Decodes up to \p count instructions with a single call to capstone,
+ * stopping before the first one it can't decode.
+ */
+static int analop_batch(RzAnalysis *a, RzAnalysisOp *ops, int count, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
+	ArmCSContext *ctx = (ArmCSContext *)a->plugin_data;
+	cs_insn *insn = NULL;
+	if (count < 1 || len < 1 || !arm_cs_open(a, ctx)) {
+		return 0;
+	}
+	int n = cs_disasm(ctx->handle, buf, len, addr, count, &insn);
+	for (int i = 0; i < n; i++) {
+		RzAnalysisOp *op = &ops[i];
+		int off = insn[i].address - addr;
+		rz_analysis_op_init(op);
+		op->size = (a->bits == 16) ? 2 : 4;
+		op->addr = insn[i].address;
+		if (hackyArmAnal(a, op, buf + off, len - off) > 0) {
+			continue;
+		}
+		arm_cs_fill_op(a, ctx, op, &insn[i], insn[i].address, buf + off, len - off, mask);
+	}
+	if (insn) {
+		cs_free(insn, n);
+	}
+	return n;
+}
+
 static char *get_reg_profile(RzAnalysis *analysis) {
 	const char *p;
 	if (analysis->bits == 64) {
@@ -4549,6 +4591,7 @@ RzAnalysisPlugin rz_analysis_plugin_arm_cs = {
 	.bits = 16 | 32 | 64,
 	.address_bits = address_bits,
 	.op = &analop,
+	.op_batch = &analop_batch,
 	.init = &init,
 	.fini = &fini,
 };
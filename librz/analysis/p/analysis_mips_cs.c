@@ -715,12 +715,10 @@ static void set_opdir(RzAnalysisOp *op) {
 	}
 }
 
-static int analop(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
-	int n, ret, opsize = -1;
+static csh mips_cs_open(RzAnalysis *analysis) {
 	static csh hndl = 0;
 	static int omode = -1;
 	static int obits = 32;
-	cs_insn *insn;
 	int mode = analysis->big_endian ? CS_MODE_BIG_ENDIAN : CS_MODE_LITTLE_ENDIAN;
 
 	if (analysis->cpu && *analysis->cpu) {
@@ -744,20 +742,23 @@ static int analop(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *
 		obits = analysis->bits;
 	}
 	// XXX no arch->cpu ?!?! CS_MODE_MICRO, N64
-	op->addr = addr;
-	if (len < 4) {
-		return -1;
-	}
-	op->size = 4;
 	if (hndl == 0) {
-		ret = cs_open(CS_ARCH_MIPS, mode, &hndl);
-		if (ret != CS_ERR_OK) {
-			goto fin;
+		if (cs_open(CS_ARCH_MIPS, mode, &hndl) != CS_ERR_OK) {
+			hndl = 0;
+			return 0;
 		}
 		cs_option(hndl, CS_OPT_DETAIL, CS_OPT_ON);
 	}
-	n = cs_disasm(hndl, (ut8 *)buf, len, addr, 1, &insn);
-	if (n < 1 || insn->size < 1) {
+	return hndl;
+}
+
+/**
+ * Fills \p op from the instruction \p insn decoded from \p buf, or as an
+ * invalid instruction if \p insn is NULL
+ */
+static int mips_cs_fill_op(RzAnalysis *analysis, csh hndl, RzAnalysisOp *op, cs_insn *insn, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
+	int opsize = -1;
+	if (!insn || insn->size < 1) {
 		if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
 			op->mnemonic = strdup("invalid");
 		}
@@ -1086,12 +1087,62 @@ beach:
 	if (mask & RZ_ANALYSIS_OP_MASK_VAL) {
 		op_fillval(analysis, op, &hndl, insn);
 	}
-	cs_free(insn, n);
+	return opsize;
+}
+
+static int analop(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
+	cs_insn *insn = NULL;
+	op->addr = addr;
+	if (len < 4) {
+		return -1;
+	}
+	op->size = 4;
+	csh hndl = mips_cs_open(analysis);
+	if (!hndl) {
+		return -1;
+	}
+	int n = cs_disasm(hndl, (ut8 *)buf, len, addr, 1, &insn);
+	int opsize = mips_cs_fill_op(analysis, hndl, op, n > 0 ? insn : NULL, addr, buf, len, mask);
+	if (insn) {
+		cs_free(insn, n);
+	}
 	// cs_close (&handle);
-fin:
 	return opsize;
 }
 
+/**
+ * Decodes up to \p count instructions with a single call to capstone,
+ * stopping before the first one it can't decode.
+ */
+static int analop_batch(RzAnalysis *analysis, RzAnalysisOp *ops, int count, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
+	cs_insn *insn = NULL;
+	if (count < 1 || len < 4) {
+		return 0;
+	}
+	csh hndl = mips_cs_open(analysis);
+	if (!hndl) {
+		return 0;
+	}
+	int n = cs_disasm(hndl, buf, len, addr, count, &insn);
+	int i;
+	for (i = 0; i < n; i++) {
+		int off = insn[i].address - addr;
+		if (len - off < 4) {
+			// refused by analop()
+			break;
+		}
+		RzAnalysisOp *op = &ops[i];
+		rz_analysis_op_init(op);
+		op->addr = insn[i].address;
+		op->size = 4;
+		mips_cs_fill_op(analysis, hndl, op, &insn[i], insn[i].address, buf + off, len - off, mask);
+	}
+	if (insn) {
+		cs_free(insn, n);
+	}
+	return i;
+}
+
 static char *get_reg_profile(RzAnalysis *analysis) {
 	const char *p = NULL;
 	switch (analysis->bits) {
@@ -1220,6 +1271,7 @@ RzAnalysisPlugin rz_analysis_plugin_mips_cs = {
 	.preludes = analysis_preludes,
 	.bits = 16 | 32 | 64,
 	.op = &analop,
+	.op_batch = &analop_batch,
 };
 
 #ifndef RZ_PLUGIN_INCORE
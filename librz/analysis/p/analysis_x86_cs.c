@@ -108,8 +108,7 @@ static void hidden_op(cs_insn *insn, cs_x86 *x, int mode) {
 	}
 }
 
-static void opex(RzStrBuf *buf, X86CSContext *ctx, int mode) {
-	cs_insn *insn = ctx->insn;
+static void opex(RzStrBuf *buf, X86CSContext *ctx, cs_insn *insn, int mode) {
 	int i;
 	PJ *pj = pj_new();
 	if (!pj) {
@@ -3150,28 +3149,79 @@ static inline int select_mode(RzAnalysis *a) {
 	}
 }
 
-static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
-	X86CSContext *ctx = (X86CSContext *)a->plugin_data;
-
-	int mode = select_mode(a);
-	int n, ret;
-
-	if (ctx->handle && mode != ctx->omode) {
-		if (ctx->handle != 0) {
-			cs_close(&ctx->handle);
-			ctx->handle = 0;
-		}
+static bool x86_cs_open(RzAnalysis *a, X86CSContext *ctx, int *mode) {
+	*mode = select_mode(a);
+	if (ctx->handle && *mode != ctx->omode) {
+		cs_close(&ctx->handle);
+		ctx->handle = 0;
 	}
-	ctx->omode = mode;
+	ctx->omode = *mode;
 	if (ctx->handle == 0) {
-		ret = cs_open(CS_ARCH_X86, mode, &ctx->handle);
+		int ret = cs_open(CS_ARCH_X86, *mode, &ctx->handle);
 		if (ret != CS_ERR_OK) {
 			ctx->handle = 0;
-			return 0;
+			return false;
 		}
 	}
-	op->cycles = 1; // aprox
 	cs_option(ctx->handle, CS_OPT_DETAIL, CS_OPT_ON);
+	return true;
+}
+
+/**
+ * Fills \p op from the instruction \p insn decoded from \p buf
+ */
+static void x86_cs_fill_op(RzAnalysis *a, X86CSContext *ctx, RzAnalysisOp *op, cs_insn *insn, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask, int mode) {
+	if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
+		op->mnemonic = rz_str_newf("%s%s%s",
+			insn->mnemonic,
+			insn->op_str[0] ? " " : "",
+			insn->op_str);
+	}
+
+	op->nopcode = cs_len_prefix_opcode(insn->detail->x86.prefix) + cs_len_prefix_opcode(insn->detail->x86.opcode);
+	op->size = insn->size;
+	op->id = insn->id;
+	op->family = RZ_ANALYSIS_OP_FAMILY_CPU; // almost everything is CPU
+	op->prefix = 0;
+	op->cond = cond_x862r2(insn->id);
+	switch (insn->detail->x86.prefix[0]) {
+	case X86_PREFIX_REPNE:
+		op->prefix |= RZ_ANALYSIS_OP_PREFIX_REPNE;
+		break;
+	case X86_PREFIX_REP:
+		op->prefix |= RZ_ANALYSIS_OP_PREFIX_REP;
+		break;
+	case X86_PREFIX_LOCK:
+		op->prefix |= RZ_ANALYSIS_OP_PREFIX_LOCK;
+		op->family = RZ_ANALYSIS_OP_FAMILY_THREAD; // XXX ?
+		break;
+	}
+	anop(a, op, addr, buf, len, &ctx->handle, insn);
+	set_opdir(op, insn);
+	if (mask & RZ_ANALYSIS_OP_MASK_ESIL) {
+		anop_esil(a, op, addr, buf, len, &ctx->handle, insn);
+	}
+	if (mask & RZ_ANALYSIS_OP_MASK_OPEX) {
+		opex(&op->opex, ctx, insn, mode);
+	}
+	if (mask & RZ_ANALYSIS_OP_MASK_VAL) {
+		op_fillval(a, op, &ctx->handle, insn, mode);
+	}
+	//#if X86_GRP_PRIVILEGE>0
+#if HAVE_CSGRP_PRIVILEGE
+	if (cs_insn_group(ctx->handle, insn, X86_GRP_PRIVILEGE)) {
+		op->family = RZ_ANALYSIS_OP_FAMILY_PRIV;
+	}
+#endif
+}
+
+static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
+	X86CSContext *ctx = (X86CSContext *)a->plugin_data;
+	int mode, n;
+	if (!x86_cs_open(a, ctx, &mode)) {
+		return 0;
+	}
+	op->cycles = 1; // aprox
 	// capstone-next
 	n = cs_disasm(ctx->handle, (const ut8 *)buf, len, addr, 1, &ctx->insn);
 	if (n < 1) {
@@ -3180,56 +3230,41 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 			op->mnemonic = strdup("invalid");
 		}
 	} else {
-		if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
-			op->mnemonic = rz_str_newf("%s%s%s",
-				ctx->insn->mnemonic,
-				ctx->insn->op_str[0] ? " " : "",
-				ctx->insn->op_str);
-		}
-
-		op->nopcode = cs_len_prefix_opcode(ctx->insn->detail->x86.prefix) + cs_len_prefix_opcode(ctx->insn->detail->x86.opcode);
-		op->size = ctx->insn->size;
-		op->id = ctx->insn->id;
-		op->family = RZ_ANALYSIS_OP_FAMILY_CPU; // almost everything is CPU
-		op->prefix = 0;
-		op->cond = cond_x862r2(ctx->insn->id);
-		switch (ctx->insn->detail->x86.prefix[0]) {
-		case X86_PREFIX_REPNE:
-			op->prefix |= RZ_ANALYSIS_OP_PREFIX_REPNE;
-			break;
-		case X86_PREFIX_REP:
-			op->prefix |= RZ_ANALYSIS_OP_PREFIX_REP;
-			break;
-		case X86_PREFIX_LOCK:
-			op->prefix |= RZ_ANALYSIS_OP_PREFIX_LOCK;
-			op->family = RZ_ANALYSIS_OP_FAMILY_THREAD; // XXX ?
-			break;
-		}
-		anop(a, op, addr, buf, len, &ctx->handle, ctx->insn);
-		set_opdir(op, ctx->insn);
-		if (mask & RZ_ANALYSIS_OP_MASK_ESIL) {
-			anop_esil(a, op, addr, buf, len, &ctx->handle, ctx->insn);
-		}
-		if (mask & RZ_ANALYSIS_OP_MASK_OPEX) {
-			opex(&op->opex, ctx, mode);
-		}
-		if (mask & RZ_ANALYSIS_OP_MASK_VAL) {
-			op_fillval(a, op, &ctx->handle, ctx->insn, mode);
-		}
+		x86_cs_fill_op(a, ctx, op, ctx->insn, addr, buf, len, mask, mode);
 	}
-	//#if X86_GRP_PRIVILEGE>0
 	if (ctx->insn) {
-#if HAVE_CSGRP_PRIVILEGE
-		if (cs_insn_group(ctx->handle, ctx->insn, X86_GRP_PRIVILEGE)) {
-			op->family = RZ_ANALYSIS_OP_FAMILY_PRIV;
-		}
-#endif
 		cs_free(ctx->insn, n);
 	}
 	// cs_close (&ctx->handle);
 	return op->size;
 }
 
+/**
+ * Decodes up to \p count instructions with a single call to capstone,
+ * stopping before the first one it can't decode.
+ */
+static int analop_batch(RzAnalysis *a, RzAnalysisOp *ops, int count, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
+	X86CSContext *ctx = (X86CSContext *)a->plugin_data;
+	cs_insn *insn = NULL;
+	int mode;
+	if (count < 1 || len < 1 || !x86_cs_open(a, ctx, &mode)) {
+		return 0;
+	}
+	int n = cs_disasm(ctx->handle, buf, len, addr, count, &insn);
+	for (int i = 0; i < n; i++) {
+		RzAnalysisOp *op = &ops[i];
+		int off = insn[i].address - addr;
+		rz_analysis_op_init(op);
+		op->addr = insn[i].address;
+		op->cycles = 1; // aprox
+		x86_cs_fill_op(a, ctx, op, &insn[i], insn[i].address, buf + off, len - off, mask, mode);
+	}
+	if (insn) {
+		cs_free(insn, n);
+	}
+	return n;
+}
+
 static int esil_x86_cs_init(RzAnalysisEsil *esil) {
 	if (!esil) {
 		return false;
@@ -3734,6 +3769,7 @@ RzAnalysisPlugin rz_analysis_plugin_x86_cs = {
 	.arch = "x86",
 	.bits = 16 | 32 | 64,
 	.op = &analop,
+	.op_batch = &analop_batch,
 	.preludes = analysis_preludes,
 	.archinfo = archinfo,
 	.get_reg_profile = &get_reg_profile,
@@ -18,6 +18,7 @@ RZ_API RZ_OWN RzAnalysisRzil *rz_analysis_rzil_new() {
 		free(rzil);
 		return NULL;
 	}
+	rz_vector_init(&rzil->reg_bindings, sizeof(RzAnalysisRzilRegBinding), NULL, NULL);
 	return rzil;
 }
 
@@ -29,6 +30,7 @@ RZ_API void rz_analysis_rzil_free(RZ_NULLABLE RzAnalysisRzil *rzil) {
 		return;
 	}
 	rz_il_vm_free(rzil->vm);
+	rz_vector_fini(&rzil->reg_bindings);
 	free(rzil);
 }
 
@@ -62,6 +64,115 @@ RZ_API bool rz_analysis_rzil_set_pc(RzAnalysisRzil *rzil, ut64 addr) {
 	return true;
 }
 
+/**
+ * Resolves, once, which global variables of the VM represent a register of
+ * \p reg. The bindings are then used by rz_analysis_rzil_sync_from_reg()
+ * and rz_analysis_rzil_sync_to_reg(), which access the registers by index
+ * instead of looking them up by name. They are recomputed by
+ * rz_analysis_rzil_setup() and when the register profile changes.
+ *
+ * \param rzil RzAnalysisRzil with an initialized VM
+ * \param reg  RzReg containing the registers
+ * \return the number of bound registers
+ */
+RZ_API ut32 rz_analysis_rzil_bind_regs(RZ_NONNULL RzAnalysisRzil *rzil, RZ_NONNULL RzReg *reg) {
+	rz_return_val_if_fail(rzil && rzil->vm && reg, 0);
+	rz_vector_clear(&rzil->reg_bindings);
+
+	void **it;
+	rz_pvector_foreach (&rzil->vm->vm_global_variable_list, it) {
+		RzILVar *var = *it;
+		RzRegItem *item = rz_reg_get(reg, var->var_name, RZ_REG_TYPE_ANY);
+		if (!item || strcmp(item->name, var->var_name)) {
+			// aliases (PC, SP, ...) are not bound, only real register names
+			continue;
+		}
+		int index = rz_reg_index_of(reg, item->name);
+		if (index < 0) {
+			continue;
+		}
+		RzAnalysisRzilRegBinding binding = { .reg_index = index, .var = var };
+		rz_vector_push(&rzil->reg_bindings, &binding);
+	}
+	return rz_vector_len(&rzil->reg_bindings);
+}
+
+static void rzil_bv_from_reg(RzReg *reg, RzRegItem *item, RzBitVector *bv) {
+	if (item->size <= 64) {
+		rz_bv_set_from_ut64(bv, rz_reg_get_value(reg, item));
+		return;
+	}
+	RzRegArena *arena = reg->regset[item->arena].arena;
+	if (!arena || !arena->bytes || BITS2BYTES(item->offset + item->size) > arena->size) {
+		return;
+	}
+	rz_bv_set_from_bytes_le(bv, arena->bytes, item->offset, item->size);
+}
+
+static void rzil_bv_to_reg(RzReg *reg, RzRegItem *item, RzBitVector *bv) {
+	if (item->size <= 64) {
+		rz_reg_set_value(reg, item, rz_bv_to_ut64(bv));
+		return;
+	}
+	RzRegArena *arena = reg->regset[item->arena].arena;
+	if (!arena || !arena->bytes || BITS2BYTES(item->offset + item->size) > arena->size) {
+		return;
+	}
+	ut32 len = RZ_MIN((ut32)item->size, rz_bv_len(bv));
+	for (ut32 i = 0; i < len; i++) {
+		ut32 bit = item->offset + i;
+		if (rz_bv_get(bv, i)) {
+			arena->bytes[bit / 8] |= (1 << (bit % 8));
+		} else {
+			arena->bytes[bit / 8] &= ~(1 << (bit % 8));
+		}
+	}
+}
+
+/**
+ * Copies the register values of \p reg into the VM variables bound by
+ * rz_analysis_rzil_bind_regs(); values are updated in place, so no memory
+ * is allocated. The values are still found through the bind table of the
+ * VM, because each `set` replaces the value bound to a variable.
+ */
+RZ_API void rz_analysis_rzil_sync_from_reg(RZ_NONNULL RzAnalysisRzil *rzil, RZ_NONNULL RzReg *reg) {
+	rz_return_if_fail(rzil && rzil->vm && reg);
+	RzAnalysisRzilRegBinding *binding;
+	rz_vector_foreach (&rzil->reg_bindings, binding) {
+		RzRegItem *item = rz_reg_index_get(reg, binding->reg_index);
+		RzILVal *val = rz_il_hash_find_val_by_var(rzil->vm, binding->var);
+		if (!item || !val) {
+			continue;
+		}
+		if (val->type == RZIL_VAR_TYPE_BOOL && val->data.b) {
+			val->data.b->b = !!rz_reg_get_value(reg, item);
+		} else if (val->type == RZIL_VAR_TYPE_BV && val->data.bv) {
+			rzil_bv_from_reg(reg, item, val->data.bv);
+		}
+	}
+}
+
+/**
+ * Copies the values of the VM variables bound by rz_analysis_rzil_bind_regs()
+ * into the registers of \p reg.
+ */
+RZ_API void rz_analysis_rzil_sync_to_reg(RZ_NONNULL RzAnalysisRzil *rzil, RZ_NONNULL RzReg *reg) {
+	rz_return_if_fail(rzil && rzil->vm && reg);
+	RzAnalysisRzilRegBinding *binding;
+	rz_vector_foreach (&rzil->reg_bindings, binding) {
+		RzRegItem *item = rz_reg_index_get(reg, binding->reg_index);
+		RzILVal *val = rz_il_hash_find_val_by_var(rzil->vm, binding->var);
+		if (!item || !val) {
+			continue;
+		}
+		if (val->type == RZIL_VAR_TYPE_BOOL && val->data.b) {
+			rz_reg_set_value(reg, item, val->data.b->b ? 1 : 0);
+		} else if (val->type == RZIL_VAR_TYPE_BV && val->data.bv) {
+			rzil_bv_to_reg(reg, item, val->data.bv);
+		}
+	}
+}
+
 /**
  * Init an empty RZIL
  * \param analysis RzAnalysis* pointer to RzAnalysis
@@ -79,6 +190,9 @@ RZ_API bool rz_analysis_rzil_setup(RzAnalysis *analysis) {
 	}
 	analysis->rzil = rzil;
 	analysis->cur->rzil_init(analysis);
+	if (analysis->reg) {
+		rz_analysis_rzil_bind_regs(rzil, analysis->reg);
+	}
 	return true;
 }
 
@@ -128,7 +242,11 @@ RZ_API void rz_analysis_rzil_collect_info(RzAnalysis *analysis, RzAnalysisRzil *
 	rzil->trace->idx++;
 	rzil->trace->end_idx++;
 
-	// TODO : Add register change for sync with analysis->register
+	// Sync the registers bound by rz_analysis_rzil_bind_regs with analysis->reg;
+	// the debugger executes the instruction itself, so nothing is synced back
+	if (analysis->reg && !rz_vector_empty(&rzil->reg_bindings)) {
+		rz_analysis_rzil_sync_from_reg(rzil, analysis->reg);
+	}
 
 	// Parse and emulate RZIL opcode, and collect `trace` and `stats` info
 	// Use new op struct for parsing
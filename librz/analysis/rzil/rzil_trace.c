@@ -11,10 +11,6 @@
  * 4. reg.write name & data
  **/
 
-static void htup_vector_free(HtUPKv *kv) {
-	rz_vector_free(kv->value);
-}
-
 /**
  * Create a new trace to collect infos
  * \param analysis pointer to RzAnalysis
@@ -23,40 +19,17 @@ static void htup_vector_free(HtUPKv *kv) {
  */
 RZ_API RzAnalysisRzilTrace *rz_analysis_rzil_trace_new(RzAnalysis *analysis, RZ_NONNULL RzAnalysisRzil *rzil) {
 	rz_return_val_if_fail(rzil, NULL);
-	size_t i;
 	RzAnalysisEsilTrace *trace = RZ_NEW0(RzAnalysisEsilTrace);
 	if (!trace) {
 		return NULL;
 	}
 
-	// TODO : maybe we could remove memory && register in rzil trace ?
-	trace->registers = ht_up_new(NULL, htup_vector_free, NULL);
-	if (!trace->registers) {
-		goto error;
-	}
-	trace->memory = ht_up_new(NULL, htup_vector_free, NULL);
-	if (!trace->memory) {
-		goto error;
-	}
 	trace->instructions = rz_pvector_new((RzPVectorFree)rz_analysis_il_trace_instruction_free);
 	if (!trace->instructions) {
 		goto error;
 	}
 
 	// TODO : Integrate with stack panel in the future
-
-	// Save initial registers arenas
-	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
-		RzRegArena *a = analysis->reg->regset[i].arena;
-		RzRegArena *b = rz_reg_arena_new(a->size);
-		if (!b) {
-			goto error;
-		}
-		if (b->bytes && a->bytes && b->size > 0) {
-			memcpy(b->bytes, a->bytes, b->size);
-		}
-		trace->arena[i] = b;
-	}
 	return trace;
 error:
 	eprintf("Fail to init RZIL trace\n");
@@ -69,16 +42,10 @@ error:
  * \param trace trace to be free
  */
 RZ_API void rz_analysis_rzil_trace_free(RzAnalysisEsilTrace *trace) {
-	size_t i;
 	if (!trace) {
 		return;
 	}
 
-	ht_up_free(trace->registers);
-	ht_up_free(trace->memory);
-	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
-		rz_reg_arena_free(trace->arena[i]);
-	}
 	rz_pvector_free(trace->instructions);
 	trace->instructions = NULL;
 	RZ_FREE(trace);
@@ -759,9 +759,8 @@ RZ_API void rz_parse_pdb_types(const RzTypeDB *typedb, const RzPdb *pdb) {
 		return;
 	}
 
-	RBIter it;
-	RzPdbTpiType *type;
-	rz_rbtree_foreach (stream->types, it, type, RzPdbTpiType, rb) {
+	for (ut32 i = stream->header.TypeIndexBegin; i < stream->header.TypeIndexEnd; i++) {
+		RzPdbTpiType *type = rz_bin_pdb_get_type_by_index(stream, i);
 		if (type && is_parsable_type(type->leaf_type)) {
 			parse_types(typedb, stream, type);
 		}
@@ -31,7 +31,13 @@ static RzAnalysisXRef *rz_analysis_xref_new(ut64 from, ut64 to, ut64 type) {
 	return xref;
 }
 
+#define XREF_SITE "analysis.xref"
+
+// frees the xrefs stored in RzAnalysis, the clones listed are freed with free()
 static void rz_analysis_xref_free(RzAnalysisXRef *xref) {
+	if (rz_alloc_prof_enabled()) {
+		rz_alloc_prof_record(XREF_SITE, sizeof(RzAnalysisXRef), false);
+	}
 	free(xref);
 }
 
@@ -130,6 +136,9 @@ RZ_API bool rz_analysis_xrefs_set(RzAnalysis *analysis, ut64 from, ut64 to, RzAn
 	if (!xref) {
 		return false;
 	}
+	if (rz_alloc_prof_enabled()) {
+		rz_alloc_prof_record(XREF_SITE, sizeof(RzAnalysisXRef), true);
+	}
 	if (!set_xref(analysis->ht_xrefs_from, xref, true)) {
 		// Pointer isn't added to <ht_xrefs_from> so we have to release it
 		rz_analysis_xref_free(xref);
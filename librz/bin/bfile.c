@@ -574,13 +574,8 @@ RZ_IPI bool rz_bin_file_set_obj(RzBin *bin, RzBinFile *bf, RzBinObject *obj) {
 	if (bin->minstrlen < 1) {
 		bin->minstrlen = plugin ? plugin->minstrlen : bin->minstrlen;
 	}
-	if (obj) {
-		if (!obj->info) {
-			return false;
-		}
-		if (!obj->info->lang) {
-			obj->info->lang = rz_bin_language_to_string(obj->lang);
-		}
+	if (obj && !obj->info) {
+		return false;
 	}
 	return true;
 }
@@ -908,6 +903,8 @@ RZ_IPI void rz_bin_class_free(RzBinClass *k) {
 
 RZ_API RzBinClass *rz_bin_file_add_class(RzBinFile *bf, const char *name, const char *super, int view) {
 	rz_return_val_if_fail(name && bf && bf->o, NULL);
+	// the classes of the plugin are loaded first, as they replace the list
+	rz_bin_object_get_classes(bf->o);
 	RzBinClass *c = __getClass(bf, name);
 	if (c) {
 		if (super) {
@@ -966,7 +966,7 @@ RZ_API RzBuffer *rz_bin_package(RzBin *bin, const char *type, const char *file,
 RZ_API RzList * /*<RzBinClass>*/ rz_bin_get_classes(RzBin *bin) {
 	rz_return_val_if_fail(bin, NULL);
 	RzBinObject *o = rz_bin_cur_object(bin);
-	return o ? o->classes : NULL;
+	return o ? (RzList *)rz_bin_object_get_classes(o) : NULL;
 }
 
 RZ_API ut64 rz_bin_get_size(RzBin *bin) {
@@ -1326,20 +1326,26 @@ RZ_API const RzBinLdrPlugin *rz_bin_ldrplugin_get(RzBin *bin, const char *name)
 	return NULL;
 }
 
-#if WITH_GPL
-static char *bin_demangle_cxx(RzBinFile *bf, const char *symbol, ut64 vaddr) {
-	char *out = rz_demangler_cxx(symbol);
-	if (!out || !bf) {
-		return out;
-	}
-	char *sign = (char *)strchr(out, '(');
+/**
+ * \brief Adds to \p bf the method named by a demangled C++ symbol
+ *
+ * This is the side effect of rz_bin_demangle() for C++ and rust symbols,
+ * for the methods demangled with rz_bin_demangle_no_method().
+ *
+ * \param bf RzBinFile to add the method to
+ * \param demangled C++ demangled symbol, as returned by rz_bin_demangle_no_method()
+ * \param vaddr vaddr of the demangled symbol
+ */
+RZ_API void rz_bin_demangle_add_method(RZ_NONNULL RzBinFile *bf, RZ_NONNULL const char *demangled, ut64 vaddr) {
+	rz_return_if_fail(bf && demangled);
+	const char *sign = strchr(demangled, '(');
 	if (!sign) {
-		return out;
+		return;
 	}
 
-	char *str = out;
-	char *ptr = NULL;
-	char *method_name = NULL;
+	const char *str = demangled;
+	const char *ptr = NULL;
+	const char *method_name = NULL;
 	for (;;) {
 		ptr = strstr(str, "::");
 		if (!ptr || ptr > sign) {
@@ -1350,11 +1356,14 @@ static char *bin_demangle_cxx(RzBinFile *bf, const char *symbol, ut64 vaddr) {
 	}
 
 	if (RZ_STR_ISEMPTY(method_name)) {
-		return out;
+		return;
 	}
 
-	*method_name = 0;
-	RzBinSymbol *sym = rz_bin_file_add_method(bf, out, method_name + 2, 0);
+	char *klass = rz_str_ndup(demangled, method_name - demangled);
+	if (!klass) {
+		return;
+	}
+	RzBinSymbol *sym = rz_bin_file_add_method(bf, klass, method_name + 2, 0);
 	if (sym) {
 		if (sym->vaddr != 0 && sym->vaddr != vaddr) {
 			RZ_LOG_INFO("Duplicated method found: %s\n", sym->name);
@@ -1363,13 +1372,21 @@ static char *bin_demangle_cxx(RzBinFile *bf, const char *symbol, ut64 vaddr) {
 			sym->vaddr = vaddr;
 		}
 	}
-	*method_name = ':';
+	free(klass);
+}
+
+#if WITH_GPL
+static char *bin_demangle_cxx(const char *symbol, char **method) {
+	char *out = rz_demangler_cxx(symbol);
+	if (out && method && strchr(out, '(')) {
+		*method = strdup(out);
+	}
 	return out;
 }
 
-static char *bin_demangle_rust(RzBinFile *binfile, const char *symbol, ut64 vaddr) {
+static char *bin_demangle_rust(const char *symbol, char **method) {
 	char *str = NULL;
-	if (!(str = bin_demangle_cxx(binfile, symbol, vaddr))) {
+	if (!(str = bin_demangle_cxx(symbol, method))) {
 		return str;
 	}
 	free(str);
@@ -1377,23 +1394,7 @@ static char *bin_demangle_rust(RzBinFile *binfile, const char *symbol, ut64 vadd
 }
 #endif
 
-/**
- * \brief Demangles a symbol based on the language or the RzBinFile data
- *
- * This function demangles a symbol based on the language or the RzBinFile data
- * When C++ or rust is selected as the language, it will add methods into the
- * RzBinFile structure based on the demangled symbol.
- * When libs is set to true, the demangled symbol will be appended to the
- * library name <libname>_<demangled symbol>.
- *
- * \param bf RzBinFile data to be used for demangling
- * \param language Language to be used for demanglind
- * \param symbol Symbol to be demangled
- * \param vaddr vaddr of the \p symbol to be demangled
- * \param libs Append the library name to the demangled symbol, if set to true
- * \return char* Demangled name of the \p symbol
- */
-RZ_API RZ_OWN char *rz_bin_demangle(RZ_NULLABLE RzBinFile *bf, RZ_NULLABLE const char *language, RZ_NULLABLE const char *symbol, ut64 vaddr, bool libs) {
+static char *bin_demangle(RzBinFile *bf, const char *language, const char *symbol, bool libs, char **method) {
 	if (RZ_STR_ISEMPTY(symbol)) {
 		return NULL;
 	}
@@ -1402,7 +1403,9 @@ RZ_API RZ_OWN char *rz_bin_demangle(RZ_NULLABLE RzBinFile *bf, RZ_NULLABLE const
 	RzBin *bin = bf ? bf->rbin : NULL;
 	RzBinObject *o = bf ? bf->o : NULL;
 
-	if (!language && o && o->info && o->info->lang) {
+	if (!language && o && o->info) {
+		// fills the language of the info
+		rz_bin_object_get_language(o);
 		language = o->info->lang;
 	}
 
@@ -1480,8 +1483,8 @@ RZ_API RZ_OWN char *rz_bin_demangle(RZ_NULLABLE RzBinFile *bf, RZ_NULLABLE const
 	case RZ_BIN_LANGUAGE_OBJC: demangled = rz_demangler_objc(symbol); break;
 	case RZ_BIN_LANGUAGE_MSVC: demangled = rz_demangler_msvc(symbol); break;
 #if WITH_GPL
-	case RZ_BIN_LANGUAGE_RUST: demangled = bin_demangle_rust(bf, symbol, vaddr); break;
-	case RZ_BIN_LANGUAGE_CXX: demangled = bin_demangle_cxx(bf, symbol, vaddr); break;
+	case RZ_BIN_LANGUAGE_RUST: demangled = bin_demangle_rust(symbol, method); break;
+	case RZ_BIN_LANGUAGE_CXX: demangled = bin_demangle_cxx(symbol, method); break;
 #else
 	case RZ_BIN_LANGUAGE_RUST: demangled = NULL; break;
 	case RZ_BIN_LANGUAGE_CXX: demangled = NULL; break;
@@ -1495,3 +1498,51 @@ RZ_API RZ_OWN char *rz_bin_demangle(RZ_NULLABLE RzBinFile *bf, RZ_NULLABLE const
 	}
 	return demangled;
 }
+
+/**
+ * \brief Demangles a symbol based on the language or the RzBinFile data
+ *
+ * This function demangles a symbol based on the language or the RzBinFile data
+ * When C++ or rust is selected as the language, it will add methods into the
+ * RzBinFile structure based on the demangled symbol.
+ * When libs is set to true, the demangled symbol will be appended to the
+ * library name <libname>_<demangled symbol>.
+ *
+ * \param bf RzBinFile data to be used for demangling
+ * \param language Language to be used for demanglind
+ * \param symbol Symbol to be demangled
+ * \param vaddr vaddr of the \p symbol to be demangled
+ * \param libs Append the library name to the demangled symbol, if set to true
+ * \return char* Demangled name of the \p symbol
+ */
+RZ_API RZ_OWN char *rz_bin_demangle(RZ_NULLABLE RzBinFile *bf, RZ_NULLABLE const char *language, RZ_NULLABLE const char *symbol, ut64 vaddr, bool libs) {
+	char *method = NULL;
+	char *demangled = bin_demangle(bf, language, symbol, libs, bf ? &method : NULL);
+	if (method) {
+		rz_bin_demangle_add_method(bf, method, vaddr);
+		free(method);
+	}
+	return demangled;
+}
+
+/**
+ * \brief Demangles a symbol like rz_bin_demangle(), without changing \p bf
+ *
+ * Since \p bf is only read, this can be called concurrently on many symbols
+ * of the same RzBinFile. The methods that rz_bin_demangle() would add into
+ * \p bf are returned through \p method instead, to be added later with
+ * rz_bin_demangle_add_method().
+ *
+ * \param bf RzBinFile data to be used for demangling
+ * \param language Language to be used for demangling
+ * \param symbol Symbol to be demangled
+ * \param libs Append the library name to the demangled symbol, if set to true
+ * \param method If not NULL, set to the C++ demangled symbol naming a method, if any
+ * \return char* Demangled name of the \p symbol
+ */
+RZ_API RZ_OWN char *rz_bin_demangle_no_method(RZ_NULLABLE const RzBinFile *bf, RZ_NULLABLE const char *language, RZ_NULLABLE const char *symbol, bool libs, RZ_NULLABLE RZ_OUT char **method) {
+	if (method) {
+		*method = NULL;
+	}
+	return bin_demangle((RzBinFile *)bf, language, symbol, libs, method);
+}
@@ -7,6 +7,19 @@
 #include <rz_util.h>
 #include "i/private.h"
 
+#if defined(__GNUC__) || defined(__clang__)
+#define OBJECT_HAVE_ATOMICS 1
+#define atomic_load(p)     __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define atomic_store(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#elif defined(_MSC_VER)
+#define OBJECT_HAVE_ATOMICS 1
+#define atomic_load(p)     ((ut32)InterlockedCompareExchange((volatile LONG *)(p), 0, 0))
+#define atomic_store(p, v) InterlockedExchange((volatile LONG *)(p), (LONG)(v))
+#else
+#define OBJECT_HAVE_ATOMICS 0
+#define atomic_store(p, v) (*(p) = (v))
+#endif
+
 RZ_API void rz_bin_mem_free(void *data) {
 	RzBinMem *mem = (RzBinMem *)data;
 	if (mem && mem->mirrors) {
@@ -171,6 +184,7 @@ static void object_delete_items(RzBinObject *o) {
 	for (i = 0; i < RZ_BIN_SPECIAL_SYMBOL_LAST; i++) {
 		free(o->binsym[i]);
 	}
+	rz_th_lock_free(o->items_lock);
 }
 
 RZ_IPI void rz_bin_object_free(void /*RzBinObject*/ *o_) {
@@ -212,7 +226,7 @@ static char *swiftField(const char *dn, const char *cn) {
 static RzList *classes_from_symbols(RzBinFile *bf) {
 	RzBinSymbol *sym;
 	RzListIter *iter;
-	rz_list_foreach (bf->o->symbols, iter, sym) {
+	rz_list_foreach (rz_bin_object_get_symbols(bf->o), iter, sym) {
 		if (sym->name[0] != '_') {
 			continue;
 		}
@@ -268,18 +282,26 @@ RZ_IPI RzBinObject *rz_bin_object_new(RzBinFile *bf, RzBinPlugin *plugin, RzBinO
 	o->methods_ht = ht_pp_new0();
 	o->baddr_shift = 0;
 	o->plugin = plugin;
+	o->items_lock = rz_th_lock_new(true);
+	if (!o->items_lock) {
+		sdb_free(o->kv);
+		free(o);
+		return NULL;
+	}
 
 	if (plugin && plugin->load_buffer) {
 		if (!plugin->load_buffer(bf, o, bf->buf, sdb)) {
 			if (bf->rbin->verbose) {
 				eprintf("Error in rz_bin_object_new: load_buffer failed for %s plugin\n", plugin->name);
 			}
+			rz_th_lock_free(o->items_lock);
 			sdb_free(o->kv);
 			free(o);
 			return NULL;
 		}
 	} else {
 		RZ_LOG_WARN("Plugin %s should implement load_buffer method.\n", plugin->name);
+		rz_th_lock_free(o->items_lock);
 		sdb_free(o->kv);
 		free(o);
 		return NULL;
@@ -373,14 +395,232 @@ static void rz_bin_object_rebuild_classes_ht(RzBinObject *o) {
 	}
 }
 
+typedef enum {
+	OBJECT_ITEM_SYMBOLS = 1 << 0,
+	OBJECT_ITEM_IMPORTS = 1 << 1,
+	OBJECT_ITEM_RELOCS = 1 << 2,
+	OBJECT_ITEM_STRINGS = 1 << 3,
+	OBJECT_ITEM_CLASSES = 1 << 4,
+	OBJECT_ITEM_LANGUAGE = 1 << 5,
+} ObjectItem;
+
+typedef void (*ObjectItemLoad)(RzBinObject *o);
+
+/**
+ * Loads the items of the family \p item with \p load, unless they are
+ * already loaded. The family is marked as loading while calling \p load, so
+ * the loaders can use the accessors of the family they are loading (e.g. the
+ * classes of a plugin looked up while adding them).
+ *
+ * The family is marked as loaded once \p load returned, with a release store
+ * matching the acquire load of the accessors, which then skip the lock.
+ */
+static void object_load_item(RzBinObject *o, ObjectItem item, ObjectItemLoad load) {
+#if OBJECT_HAVE_ATOMICS
+	if (atomic_load(&o->loaded_items) & item) {
+		return;
+	}
+#endif
+	rz_th_lock_enter(o->items_lock);
+	if (!((o->loaded_items | o->loading_items) & item) && o->bf && o->plugin) {
+		o->loading_items |= item;
+		load(o);
+		o->loading_items &= ~item;
+		atomic_store(&o->loaded_items, o->loaded_items | item);
+	}
+	rz_th_lock_leave(o->items_lock);
+}
+
+/**
+ * Frees the items already loaded on demand, so they are loaded again on
+ * their next access. Must be called with the items lock held.
+ */
+static void object_unload_items(RzBinObject *o) {
+	if (o->loaded_items & OBJECT_ITEM_CLASSES) {
+		ht_up_free(o->addrzklassmethod);
+		o->addrzklassmethod = NULL;
+		ht_pp_free(o->methods_ht);
+		o->methods_ht = ht_pp_new0();
+		ht_pp_free(o->classes_ht);
+		o->classes_ht = ht_pp_new0();
+		rz_list_free(o->classes);
+		o->classes = rz_list_newf((RzListFree)rz_bin_class_free);
+	}
+	if (o->loaded_items & OBJECT_ITEM_STRINGS) {
+		rz_list_free(o->strings);
+		o->strings = NULL;
+		ht_up_free(o->strings_db);
+		o->strings_db = ht_up_new0();
+	}
+	if (o->loaded_items & OBJECT_ITEM_RELOCS) {
+		rz_bin_reloc_storage_free(o->relocs);
+		o->relocs = NULL;
+	}
+	if (o->loaded_items & OBJECT_ITEM_IMPORTS) {
+		rz_list_free(o->imports);
+		o->imports = NULL;
+	}
+	if (o->loaded_items & OBJECT_ITEM_SYMBOLS) {
+		ht_pp_free(o->import_name_symbols);
+		o->import_name_symbols = NULL;
+		rz_list_free(o->symbols);
+		o->symbols = NULL;
+	}
+	if (o->loaded_items & OBJECT_ITEM_LANGUAGE) {
+		o->lang = RZ_BIN_LANGUAGE_UNKNOWN;
+	}
+	atomic_store(&o->loaded_items, 0);
+}
+
+static void object_load_symbols(RzBinObject *o) {
+	RzBinFile *bf = o->bf;
+	RzBinPlugin *p = o->plugin;
+	if (!p->symbols) {
+		return;
+	}
+	o->symbols = p->symbols(bf);
+	if (!o->symbols) {
+		return;
+	}
+	rz_warn_if_fail(o->symbols->free);
+	REBASE_PADDR(o, o->symbols, RzBinSymbol);
+	if (o->filter) {
+		rz_bin_filter_symbols(bf, o->symbols);
+	}
+	o->import_name_symbols = ht_pp_new0();
+	if (o->import_name_symbols) {
+		RzBinSymbol *sym;
+		RzListIter *it;
+		rz_list_foreach (o->symbols, it, sym) {
+			if (!sym->is_imported || !sym->name || !*sym->name) {
+				continue;
+			}
+			ht_pp_insert(o->import_name_symbols, sym->name, sym);
+		}
+	}
+}
+
+static void object_load_imports(RzBinObject *o) {
+	RzBinPlugin *p = o->plugin;
+	if (!p->imports) {
+		return;
+	}
+	rz_list_free(o->imports);
+	o->imports = p->imports(o->bf);
+	if (o->imports) {
+		rz_warn_if_fail(o->imports->free);
+	}
+}
+
+static void object_load_relocs(RzBinObject *o) {
+	RzBinPlugin *p = o->plugin;
+	if (!(o->filter_rules & (RZ_BIN_REQ_RELOCS | RZ_BIN_REQ_IMPORTS)) || !p->relocs) {
+		return;
+	}
+	RzList *l = p->relocs(o->bf);
+	if (l) {
+		REBASE_PADDR(o, l, RzBinReloc);
+		o->relocs = rz_bin_reloc_storage_new(l);
+	}
+}
+
+static void object_load_strings(RzBinObject *o) {
+	RzBinFile *bf = o->bf;
+	RzBinPlugin *p = o->plugin;
+	if (!(o->filter_rules & RZ_BIN_REQ_STRINGS)) {
+		return;
+	}
+	int minlen = (o->minstrlen > 0) ? o->minstrlen : p->minstrlen;
+	o->strings = p->strings
+		? p->strings(bf)
+		: rz_bin_file_get_strings(bf, minlen, 0, bf->rawstr);
+	if (o->debase64) {
+		rz_bin_object_filter_strings(o);
+	}
+	REBASE_PADDR(o, o->strings, RzBinString);
+}
+
+static void object_load_language(RzBinObject *o) {
+	// the symbols are filtered without knowing the language, as when all the items were loaded at once
+	rz_bin_object_get_symbols(o);
+	o->lang = rz_bin_language_detect(o->bf);
+	if (o->info && !o->info->lang) {
+		o->info->lang = rz_bin_language_to_string(o->lang);
+	}
+}
+
+static void object_load_classes(RzBinObject *o) {
+	RzBinFile *bf = o->bf;
+	RzBinPlugin *p = o->plugin;
+	if (!(o->filter_rules & (RZ_BIN_REQ_CLASSES | RZ_BIN_REQ_CLASSES_SOURCES))) {
+		return;
+	}
+	if (p->classes) {
+		RzList *classes = p->classes(bf);
+		if (classes) {
+			// XXX we should probably merge them instead
+			rz_list_free(o->classes);
+			o->classes = classes;
+			rz_bin_object_rebuild_classes_ht(o);
+		}
+
+		if (rz_bin_object_get_language(o) == RZ_BIN_LANGUAGE_SWIFT) {
+			o->classes = classes_from_symbols(bf);
+		}
+	} else {
+		RzList *classes = classes_from_symbols(bf);
+		if (classes) {
+			o->classes = classes;
+		}
+	}
+
+	if (o->filter) {
+		filter_classes(bf, o->classes);
+	}
+
+	// cache addr=class+method
+	if (o->classes) {
+		RzList *klasses = o->classes;
+		RzListIter *iter, *iter2;
+		RzBinClass *klass;
+		RzBinSymbol *method;
+		if (!o->addrzklassmethod) {
+			// this is slow. must be optimized, but at least its cached
+			o->addrzklassmethod = ht_up_new0();
+			rz_list_foreach (klasses, iter, klass) {
+				rz_list_foreach (klass->methods, iter2, method) {
+					ht_up_insert(o->addrzklassmethod, method->vaddr, method);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * \brief Loads the items of \p o needed to map it, the others are loaded on
+ * their first access
+ *
+ * Symbols, imports, relocs, strings, classes and the language are loaded by
+ * their rz_bin_object_get_*() accessors, with the filter rules, name filter,
+ * minimum string length and base64 decoding of the RzBin at the time of this
+ * call. Calling it again (e.g. on rebase) frees the items already loaded.
+ */
 RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 	rz_return_val_if_fail(bf && o && o->plugin, false);
 
 	int i;
-	RzBin *bin = bf->rbin;
 	RzBinPlugin *p = o->plugin;
-	int minlen = (bf->rbin->minstrlen > 0) ? bf->rbin->minstrlen : p->minstrlen;
+	RzBin *bin = bf->rbin;
 	bf->o = o;
+	o->bf = bf;
+	rz_th_lock_enter(o->items_lock);
+	// a rebase loads the items again, at the new addresses
+	object_unload_items(o);
+	o->filter_rules = bin->filter_rules;
+	o->filter = bin->filter;
+	o->minstrlen = bin->minstrlen;
+	o->debase64 = bin->debase64;
+	rz_th_lock_leave(o->items_lock);
 
 	if (p->file_type) {
 		int type = p->file_type(bf);
@@ -429,34 +669,6 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 			REBASE_PADDR(o, o->fields, RzBinField);
 		}
 	}
-	if (p->imports) {
-		rz_list_free(o->imports);
-		o->imports = p->imports(bf);
-		if (o->imports) {
-			rz_warn_if_fail(o->imports->free);
-		}
-	}
-	if (p->symbols) {
-		o->symbols = p->symbols(bf);
-		if (o->symbols) {
-			rz_warn_if_fail(o->symbols->free);
-			REBASE_PADDR(o, o->symbols, RzBinSymbol);
-			if (bin->filter) {
-				rz_bin_filter_symbols(bf, o->symbols);
-			}
-			o->import_name_symbols = ht_pp_new0();
-			if (o->import_name_symbols) {
-				RzBinSymbol *sym;
-				RzListIter *it;
-				rz_list_foreach (o->symbols, it, sym) {
-					if (!sym->is_imported || !sym->name || !*sym->name) {
-						continue;
-					}
-					ht_pp_insert(o->import_name_symbols, sym->name, sym);
-				}
-			}
-		}
-	}
 	o->info = p->info ? p->info(bf) : NULL;
 	if (p->libs) {
 		o->libs = p->libs(bf);
@@ -467,72 +679,10 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 			o->sections = p->sections(bf);
 		}
 		REBASE_PADDR(o, o->sections, RzBinSection);
-		if (bin->filter) {
+		if (o->filter) {
 			rz_bin_filter_sections(bf, o->sections);
 		}
 	}
-	if (bin->filter_rules & (RZ_BIN_REQ_RELOCS | RZ_BIN_REQ_IMPORTS)) {
-		if (p->relocs) {
-			RzList *l = p->relocs(bf);
-			if (l) {
-				REBASE_PADDR(o, l, RzBinReloc);
-				o->relocs = rz_bin_reloc_storage_new(l);
-			}
-		}
-	}
-	if (bin->filter_rules & RZ_BIN_REQ_STRINGS) {
-		o->strings = p->strings
-			? p->strings(bf)
-			: rz_bin_file_get_strings(bf, minlen, 0, bf->rawstr);
-		if (bin->debase64) {
-			rz_bin_object_filter_strings(o);
-		}
-		REBASE_PADDR(o, o->strings, RzBinString);
-	}
-
-	o->lang = rz_bin_language_detect(bf);
-
-	if (bin->filter_rules & (RZ_BIN_REQ_CLASSES | RZ_BIN_REQ_CLASSES_SOURCES)) {
-		if (p->classes) {
-			RzList *classes = p->classes(bf);
-			if (classes) {
-				// XXX we should probably merge them instead
-				rz_list_free(o->classes);
-				o->classes = classes;
-				rz_bin_object_rebuild_classes_ht(o);
-			}
-
-			if (o->lang == RZ_BIN_LANGUAGE_SWIFT) {
-				o->classes = classes_from_symbols(bf);
-			}
-		} else {
-			RzList *classes = classes_from_symbols(bf);
-			if (classes) {
-				o->classes = classes;
-			}
-		}
-
-		if (bin->filter) {
-			filter_classes(bf, o->classes);
-		}
-
-		// cache addr=class+method
-		if (o->classes) {
-			RzList *klasses = o->classes;
-			RzListIter *iter, *iter2;
-			RzBinClass *klass;
-			RzBinSymbol *method;
-			if (!o->addrzklassmethod) {
-				// this is slow. must be optimized, but at least its cached
-				o->addrzklassmethod = ht_up_new0();
-				rz_list_foreach (klasses, iter, klass) {
-					rz_list_foreach (klass->methods, iter2, method) {
-						ht_up_insert(o->addrzklassmethod, method->vaddr, method);
-					}
-				}
-			}
-		}
-	}
 	if (p->lines) {
 		o->lines = p->lines(bf);
 	}
@@ -556,9 +706,9 @@ RZ_API RzBinRelocStorage *rz_bin_object_patch_relocs(RzBinFile *bf, RzBinObject
 	rz_return_val_if_fail(bf && o, NULL);
 
 	static bool first = true;
-	// rz_bin_object_set_items set o->relocs but there we don't have access
-	// to io so we need to be run from bin_relocs, free the previous reloc and get
-	// the patched ones
+	// the relocs are loaded without access to io so we need to be run from
+	// bin_relocs, free the previous reloc and get the patched ones
+	rz_bin_object_get_relocs(o);
 	if (first && o->plugin && o->plugin->patch_relocs) {
 		RzList *tmp = o->plugin->patch_relocs(bf);
 		first = false;
@@ -580,6 +730,7 @@ RZ_API RzBinRelocStorage *rz_bin_object_patch_relocs(RzBinFile *bf, RzBinObject
  */
 RZ_API RzBinSymbol *rz_bin_object_get_symbol_of_import(RzBinObject *o, RzBinImport *imp) {
 	rz_return_val_if_fail(o && imp && imp->name, NULL);
+	rz_bin_object_get_symbols(o);
 	if (!o->import_name_symbols) {
 		return NULL;
 	}
@@ -723,6 +874,7 @@ RZ_API const RzList *rz_bin_object_get_fields(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_get_imports(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	object_load_item(obj, OBJECT_ITEM_IMPORTS, object_load_imports);
 	return obj->imports;
 }
 
@@ -742,6 +894,33 @@ RZ_API const RzList *rz_bin_object_get_libs(RzBinObject *obj) {
 	return obj->libs;
 }
 
+/**
+ * \brief Get the relocations of the binary object, sorted by their address.
+ */
+RZ_API RzBinRelocStorage *rz_bin_object_get_relocs(RzBinObject *obj) {
+	rz_return_val_if_fail(obj, NULL);
+	object_load_item(obj, OBJECT_ITEM_RELOCS, object_load_relocs);
+	return obj->relocs;
+}
+
+/**
+ * \brief Get the language the binary object was compiled from, detected from its symbols.
+ */
+RZ_API RzBinLanguage rz_bin_object_get_language(RzBinObject *obj) {
+	rz_return_val_if_fail(obj, RZ_BIN_LANGUAGE_UNKNOWN);
+	object_load_item(obj, OBJECT_ITEM_LANGUAGE, object_load_language);
+	return obj->lang;
+}
+
+/**
+ * \brief Get the class method at the virtual address \p vaddr, if any.
+ */
+RZ_API RzBinSymbol *rz_bin_object_get_method_at(RzBinObject *obj, ut64 vaddr) {
+	rz_return_val_if_fail(obj, NULL);
+	object_load_item(obj, OBJECT_ITEM_CLASSES, object_load_classes);
+	return obj->addrzklassmethod ? ht_up_find(obj->addrzklassmethod, vaddr, NULL) : NULL;
+}
+
 /**
  * \brief Get list of \p RzBinSection representing both the sections and the segments of the binary object.
  */
@@ -787,6 +966,7 @@ RZ_API RzList *rz_bin_object_get_segments(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_get_classes(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	object_load_item(obj, OBJECT_ITEM_CLASSES, object_load_classes);
 	return obj->classes;
 }
 
@@ -795,6 +975,7 @@ RZ_API const RzList *rz_bin_object_get_classes(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_get_strings(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	object_load_item(obj, OBJECT_ITEM_STRINGS, object_load_strings);
 	return obj->strings;
 }
 
@@ -811,6 +992,7 @@ RZ_API const RzList *rz_bin_object_get_mem(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_get_symbols(RzBinObject *obj) {
 	rz_return_val_if_fail(obj, NULL);
+	object_load_item(obj, OBJECT_ITEM_SYMBOLS, object_load_symbols);
 	return obj->symbols;
 }
 
@@ -827,6 +1009,8 @@ RZ_API const RzList *rz_bin_object_get_resources(RzBinObject *obj) {
  */
 RZ_API const RzList *rz_bin_object_reset_strings(RzBin *bin, RzBinFile *bf, RzBinObject *obj) {
 	rz_return_val_if_fail(bin && bf && obj, NULL);
+	rz_th_lock_enter(obj->items_lock);
+	obj->loading_items |= OBJECT_ITEM_STRINGS;
 	if (obj->strings) {
 		rz_list_free(obj->strings);
 		obj->strings = NULL;
@@ -835,6 +1019,8 @@ RZ_API const RzList *rz_bin_object_reset_strings(RzBin *bin, RzBinFile *bf, RzBi
 	obj->strings_db = ht_up_new0();
 
 	bf->rawstr = bin->rawstr;
+	obj->minstrlen = bin->minstrlen;
+	obj->debase64 = bin->debase64;
 	RzBinPlugin *plugin = obj->plugin;
 	if (plugin && plugin->strings) {
 		obj->strings = plugin->strings(bf);
@@ -844,6 +1030,9 @@ RZ_API const RzList *rz_bin_object_reset_strings(RzBin *bin, RzBinFile *bf, RzBi
 	if (bin->debase64) {
 		rz_bin_object_filter_strings(obj);
 	}
+	obj->loading_items &= ~OBJECT_ITEM_STRINGS;
+	atomic_store(&obj->loaded_items, obj->loaded_items | OBJECT_ITEM_STRINGS);
+	rz_th_lock_leave(obj->items_lock);
 	return obj->strings;
 }
 
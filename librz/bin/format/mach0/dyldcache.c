@@ -249,7 +249,7 @@ objc_cache_opt_info *rz_dyldcache_get_objc_opt_info(RzBinFile *bf, RzDyldCache *
 	RzListIter *iter;
 	RzDyldBinImage *bin;
 	rz_list_foreach (cache->bins, iter, bin) {
-		if (strcmp(bin->file, "lib/libobjc.A.dylib")) {
+		if (!bin->file || strcmp(bin->file, "lib/libobjc.A.dylib")) {
 			continue;
 		}
 
@@ -764,7 +764,6 @@ beach:
 static RzDyldRebaseInfo *get_rebase_info(RzDyldCache *cache, ut64 slideInfoOffset, ut64 slideInfoSize, ut64 start_of_data, ut64 slide) {
 	ut8 *tmp_buf_1 = NULL;
 	ut8 *tmp_buf_2 = NULL;
-	ut8 *one_page_buf = NULL;
 	RzBuffer *cache_buf = cache->buf;
 
 	ut64 offset = slideInfoOffset;
@@ -797,13 +796,6 @@ static RzDyldRebaseInfo *get_rebase_info(RzDyldCache *cache, ut64 slideInfoOffse
 			}
 		}
 
-		if (slide_info.page_size > 0) {
-			one_page_buf = malloc(slide_info.page_size);
-			if (!one_page_buf) {
-				goto beach;
-			}
-		}
-
 		RzDyldRebaseInfo3 *rebase_info = RZ_NEW0(RzDyldRebaseInfo3);
 		if (!rebase_info) {
 			goto beach;
@@ -817,7 +809,6 @@ static RzDyldRebaseInfo *get_rebase_info(RzDyldCache *cache, ut64 slideInfoOffse
 		rebase_info->page_starts_count = slide_info.page_starts_count;
 		rebase_info->auth_value_add = slide_info.auth_value_add;
 		rebase_info->page_size = slide_info.page_size;
-		rebase_info->one_page_buf = one_page_buf;
 		if (slide == UT64_MAX) {
 			rebase_info->slide = estimate_slide(cache, 0x7ffffffffffffULL, 0);
 			if (rebase_info->slide) {
@@ -871,13 +862,6 @@ static RzDyldRebaseInfo *get_rebase_info(RzDyldCache *cache, ut64 slideInfoOffse
 			}
 		}
 
-		if (slide_info.page_size > 0) {
-			one_page_buf = malloc(slide_info.page_size);
-			if (!one_page_buf) {
-				goto beach;
-			}
-		}
-
 		RzDyldRebaseInfo2 *rebase_info = RZ_NEW0(RzDyldRebaseInfo2);
 		if (!rebase_info) {
 			goto beach;
@@ -894,7 +878,6 @@ static RzDyldRebaseInfo *get_rebase_info(RzDyldCache *cache, ut64 slideInfoOffse
 		rebase_info->value_mask = ~rebase_info->delta_mask;
 		rebase_info->delta_shift = dumb_ctzll(rebase_info->delta_mask) - 2;
 		rebase_info->page_size = slide_info.page_size;
-		rebase_info->one_page_buf = one_page_buf;
 		if (slide == UT64_MAX) {
 			rebase_info->slide = estimate_slide(cache, rebase_info->value_mask, rebase_info->value_add);
 			if (rebase_info->slide) {
@@ -948,11 +931,6 @@ static RzDyldRebaseInfo *get_rebase_info(RzDyldCache *cache, ut64 slideInfoOffse
 			}
 		}
 
-		one_page_buf = malloc(4096);
-		if (!one_page_buf) {
-			goto beach;
-		}
-
 		RzDyldRebaseInfo1 *rebase_info = RZ_NEW0(RzDyldRebaseInfo1);
 		if (!rebase_info) {
 			goto beach;
@@ -960,7 +938,6 @@ static RzDyldRebaseInfo *get_rebase_info(RzDyldCache *cache, ut64 slideInfoOffse
 
 		rebase_info->version = 1;
 		rebase_info->start_of_data = start_of_data;
-		rebase_info->one_page_buf = one_page_buf;
 		rebase_info->page_size = 4096;
 		rebase_info->toc = (ut16 *)tmp_buf_1;
 		rebase_info->toc_count = slide_info.toc_count;
@@ -984,7 +961,6 @@ static RzDyldRebaseInfo *get_rebase_info(RzDyldCache *cache, ut64 slideInfoOffse
 beach:
 	free(tmp_buf_1);
 	free(tmp_buf_2);
-	free(one_page_buf);
 	return NULL;
 }
 
@@ -1226,8 +1202,6 @@ static void rebase_info_free(RzDyldRebaseInfo *rebase_info) {
 		return;
 	}
 
-	RZ_FREE(rebase_info->one_page_buf);
-
 	ut8 version = rebase_info->version;
 
 	if (version == 1) {
@@ -15,7 +15,6 @@
 typedef struct rz_dyld_rebase_info_t {
 	ut8 version;
 	ut64 slide;
-	ut8 *one_page_buf;
 	ut32 page_size;
 	ut64 start_of_data;
 } RzDyldRebaseInfo;
@@ -34,7 +33,6 @@ typedef struct rz_dyld_rebase_infos_t {
 typedef struct rz_dyld_rebase_info_3_t {
 	ut8 version;
 	ut64 slide;
-	ut8 *one_page_buf;
 	ut32 page_size;
 	ut64 start_of_data;
 	ut16 *page_starts;
@@ -47,7 +45,6 @@ typedef struct rz_dyld_rebase_info_3_t {
 typedef struct rz_dyld_rebase_info_2_t {
 	ut8 version;
 	ut64 slide;
-	ut8 *one_page_buf;
 	ut32 page_size;
 	ut64 start_of_data;
 	ut16 *page_starts;
@@ -63,7 +60,6 @@ typedef struct rz_dyld_rebase_info_2_t {
 typedef struct rz_dyld_rebase_info_1_t {
 	ut8 version;
 	ut64 slide;
-	ut8 *one_page_buf;
 	ut32 page_size;
 	ut64 start_of_data;
 	ut16 *toc;
@@ -173,80 +173,179 @@ static void rebase_bytes(RzDyldRebaseInfo *rebase_info, ut8 *buf, ut64 offset, i
 	}
 }
 
+/*
+ * The rebasing buffer keeps the pages it rebased in a LRU cache, keyed by
+ * the offset of the page in the cache file: rebasing a page walks its
+ * pointer chains from the start of the page, which was done again for
+ * each read, and the same pages are read over and over by the analysis.
+ * Since reads update the cache, it is guarded by a lock.
+ */
+#define REBASED_PAGES_MAX 64
+
+typedef struct {
+	ut64 start; ///< offset of the page in the cache file
+	st64 size; ///< bytes of the page, less than the page size at the end of the file
+	ut8 *data;
+} RebasedPage;
+
 typedef struct {
 	RzDyldCache *cache;
 	ut64 off;
+	HtUP /*<ut64, RzListIter<RebasedPage *> *>*/ *pages; ///< page start -> iterator in lru
+	RzList /*<RebasedPage *>*/ *lru; ///< most recently used first
+	RzThreadLock *lock; ///< guards pages, lru and the data of their pages
 } BufCtx;
 
+static void rebased_page_free(RebasedPage *page) {
+	if (!page) {
+		return;
+	}
+	free(page->data);
+	free(page);
+}
+
+static void rebased_pages_clear(BufCtx *ctx) {
+	rz_th_lock_enter(ctx->lock);
+	ht_up_free(ctx->pages);
+	ctx->pages = ht_up_new0();
+	rz_list_purge(ctx->lru);
+	rz_th_lock_leave(ctx->lock);
+}
+
+static RebasedPage *rebased_page_get(BufCtx *ctx, RzDyldRebaseInfo *rebase_info, ut64 start) {
+	if (!ctx->pages) {
+		return NULL;
+	}
+	RzListIter *it = ht_up_find(ctx->pages, start, NULL);
+	if (it) {
+		RebasedPage *page = rz_list_iter_get_data(it);
+		if (it != rz_list_head(ctx->lru)) {
+			rz_list_split_iter(ctx->lru, it);
+			free(it);
+			it = rz_list_prepend(ctx->lru, page);
+			if (!it) {
+				ht_up_delete(ctx->pages, start);
+				rebased_page_free(page);
+				return NULL;
+			}
+			ht_up_update(ctx->pages, start, it);
+		}
+		return page;
+	}
+
+	RebasedPage *page = RZ_NEW0(RebasedPage);
+	if (!page) {
+		return NULL;
+	}
+	page->start = start;
+	page->data = malloc(rebase_info->page_size);
+	if (!page->data) {
+		rebased_page_free(page);
+		return NULL;
+	}
+	page->size = rz_buf_read_at(ctx->cache->buf, start, page->data, rebase_info->page_size);
+	if (page->size <= 0) {
+		rebased_page_free(page);
+		return NULL;
+	}
+	rebase_bytes(rebase_info, page->data, start, page->size, 0);
+	it = rz_list_prepend(ctx->lru, page);
+	if (!it) {
+		rebased_page_free(page);
+		return NULL;
+	}
+	ht_up_insert(ctx->pages, start, it);
+	while (rz_list_length(ctx->lru) > REBASED_PAGES_MAX) {
+		RebasedPage *old = rz_list_pop(ctx->lru);
+		ht_up_delete(ctx->pages, old->start);
+		rebased_page_free(old);
+	}
+	return page;
+}
+
 static bool buf_init(RzBuffer *b, const void *user) {
 	BufCtx *ctx = RZ_NEW0(BufCtx);
 	if (!ctx) {
 		return false;
 	}
 	ctx->cache = (void *)user;
+	ctx->pages = ht_up_new0();
+	ctx->lru = rz_list_newf((RzListFree)rebased_page_free);
+	ctx->lock = rz_th_lock_new(false);
+	if (!ctx->pages || !ctx->lru || !ctx->lock) {
+		ht_up_free(ctx->pages);
+		rz_list_free(ctx->lru);
+		rz_th_lock_free(ctx->lock);
+		free(ctx);
+		return false;
+	}
 	b->priv = ctx;
 	return true;
 }
 
 static bool buf_fini(RzBuffer *b) {
 	BufCtx *ctx = b->priv;
+	ht_up_free(ctx->pages);
+	rz_list_free(ctx->lru);
+	rz_th_lock_free(ctx->lock);
 	free(ctx);
 	return true;
 }
 
 static bool buf_resize(RzBuffer *b, ut64 newsize) {
 	BufCtx *ctx = b->priv;
+	rebased_pages_clear(ctx);
 	return rz_buf_resize(ctx->cache->buf, newsize);
 }
 
 static st64 buf_read(RzBuffer *b, ut8 *buf, ut64 len) {
 	BufCtx *ctx = b->priv;
-	st64 r = rz_buf_read_at(ctx->cache->buf, ctx->off, buf, len);
-	if (r <= 0 || !len) {
-		return r;
-	}
-
 	RzDyldCache *cache = ctx->cache;
-	RzDyldRebaseInfo *rebase_info = rebase_info_by_range(cache->rebase_infos, ctx->off, len);
-
-	if (!rebase_info) {
-		return rz_buf_read_at(cache->buf, ctx->off, buf, len);
-	}
-	st64 result = 0;
-	ut64 offset_in_data = ctx->off - rebase_info->start_of_data;
-	ut64 page_offset = offset_in_data % rebase_info->page_size;
-
-	ut64 internal_offset = ctx->off & ~(rebase_info->page_size - 1);
-	ut64 internal_end = ctx->off + len;
-	int rounded_count = internal_end - internal_offset;
-
-	ut8 *internal_buf = rebase_info->one_page_buf;
-	if (rounded_count > rebase_info->page_size) {
-		internal_buf = malloc(rounded_count);
-		if (!internal_buf) {
-			eprintf("Cannot allocate memory for 'internal_buf'\n");
-			return -1;
+	ut64 done = 0;
+	while (done < len) {
+		ut64 off = ctx->off + done;
+		ut64 left = len - done;
+		RzDyldRebaseInfo *rebase_info = rebase_info_by_range(cache->rebase_infos, off, left);
+		if (!rebase_info || !rebase_info->page_size) {
+			st64 r = rz_buf_read_at(cache->buf, off, buf + done, left);
+			return r > 0 ? done + r : (done ? done : r);
+		}
+		ut64 start = off & ~((ut64)rebase_info->page_size - 1);
+		ut64 page_offset = off - start;
+		ut64 chunk = RZ_MIN(left, rebase_info->page_size - page_offset);
+		rebase_info = rebase_info_by_range(cache->rebase_infos, off, chunk);
+		if (!rebase_info) {
+			// the range starts before the rebased data
+			st64 r = rz_buf_read_at(cache->buf, off, buf + done, chunk);
+			if (r <= 0) {
+				return done ? done : r;
+			}
+			done += r;
+			if (r < chunk) {
+				break;
+			}
+			continue;
+		}
+		rz_th_lock_enter(ctx->lock);
+		RebasedPage *page = rebased_page_get(ctx, rebase_info, start);
+		if (!page || page->size <= page_offset) {
+			rz_th_lock_leave(ctx->lock);
+			return done ? done : (page ? 0 : -1);
+		}
+		ut64 r = RZ_MIN(chunk, page->size - page_offset);
+		memcpy(buf + done, page->data + page_offset, r);
+		rz_th_lock_leave(ctx->lock);
+		done += r;
+		if (r < chunk) {
+			break;
 		}
 	}
-
-	st64 internal_result = rz_buf_read_at(cache->buf, internal_offset, internal_buf, rounded_count);
-	if (internal_result >= page_offset + len) {
-		rebase_bytes(rebase_info, internal_buf, internal_offset, internal_result, page_offset);
-		result = RZ_MIN(len, internal_result);
-		memcpy(buf, internal_buf + page_offset, result);
-	} else {
-		eprintf("ERROR rebasing\n");
-		result = rz_buf_read_at(cache->buf, ctx->off, buf, len);
-	}
-
-	if (internal_buf != rebase_info->one_page_buf) {
-		RZ_FREE(internal_buf);
-	}
-	return result;
+	return done;
 }
 
 static st64 buf_write(RzBuffer *b, const ut8 *buf, ut64 len) {
 	BufCtx *ctx = b->priv;
+	rebased_pages_clear(ctx);
 	return rz_buf_write_at(ctx->cache->buf, ctx->off, buf, len);
 }
 
@@ -1234,7 +1234,7 @@ static RzList *parse_swift_classes(RzBinFile *bf) {
 
 	int idx = 0;
 	ret = rz_list_newf (rz_bin_string_free);
-	rz_list_foreach (bf->o->strings, iter, str) {
+	rz_list_foreach (rz_bin_object_get_strings(bf->o), iter, str) {
 		if (!strncmp (str->string, "_TtC", 4)) {
 			char *msg = strdup (str->string + 4);
 			cls = RZ_NEW0 (RzBinClass);
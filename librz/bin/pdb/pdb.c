@@ -112,6 +112,94 @@ static ut64 count_blocks(ut64 length, ut64 block_size) {
 	return num_blocks;
 }
 
+/*
+ * MSF stream buffer: a read-only RzBuffer which maps the (sparse) blocks of
+ * a stream over the buffer of the whole PDB file, so that streams are never
+ * copied in memory and only the accessed blocks are read (or paged in, when
+ * the file is mmapped).
+ */
+typedef struct msf_stream_buf_user_t {
+	RzBuffer *file;
+	ut32 block_size;
+	ut32 *block_map; ///< index in the file of each block of the stream, ownership is transferred
+	ut64 size;
+} MsfStreamBufUser;
+
+typedef struct msf_stream_buf_priv_t {
+	RzBuffer *file;
+	ut32 block_size;
+	ut32 *block_map;
+	ut64 size;
+	ut64 cur;
+} MsfStreamBufPriv;
+
+static bool msf_stream_buf_init(RzBuffer *b, const void *user) {
+	const MsfStreamBufUser *u = user;
+	MsfStreamBufPriv *priv = RZ_NEW0(MsfStreamBufPriv);
+	if (!priv) {
+		return false;
+	}
+	b->readonly = true;
+	priv->file = rz_buf_ref(u->file);
+	priv->block_size = u->block_size;
+	priv->block_map = u->block_map;
+	priv->size = u->size;
+	b->priv = priv;
+	return true;
+}
+
+static bool msf_stream_buf_fini(RzBuffer *b) {
+	MsfStreamBufPriv *priv = b->priv;
+	rz_buf_free(priv->file);
+	free(priv->block_map);
+	RZ_FREE(b->priv);
+	return true;
+}
+
+static st64 msf_stream_buf_read(RzBuffer *b, ut8 *buf, ut64 len) {
+	MsfStreamBufPriv *priv = b->priv;
+	if (priv->cur >= priv->size) {
+		return 0;
+	}
+	len = RZ_MIN(len, priv->size - priv->cur);
+	ut64 done = 0;
+	while (done < len) {
+		ut64 block = priv->cur / priv->block_size;
+		ut64 delta = priv->cur % priv->block_size;
+		ut64 chunk = RZ_MIN(len - done, priv->block_size - delta);
+		ut64 addr = (ut64)priv->block_map[block] * priv->block_size + delta;
+		st64 r = rz_buf_read_at(priv->file, addr, buf + done, chunk);
+		if (r <= 0) {
+			break;
+		}
+		done += r;
+		priv->cur += r;
+		if (r < chunk) {
+			break;
+		}
+	}
+	return done;
+}
+
+static ut64 msf_stream_buf_get_size(RzBuffer *b) {
+	MsfStreamBufPriv *priv = b->priv;
+	return priv->size;
+}
+
+static st64 msf_stream_buf_seek(RzBuffer *b, st64 addr, int whence) {
+	MsfStreamBufPriv *priv = b->priv;
+	priv->cur = rz_seek_offset(priv->cur, priv->size, addr, whence);
+	return priv->cur;
+}
+
+static const RzBufferMethods msf_stream_buf_methods = {
+	.init = msf_stream_buf_init,
+	.fini = msf_stream_buf_fini,
+	.read = msf_stream_buf_read,
+	.get_size = msf_stream_buf_get_size,
+	.seek = msf_stream_buf_seek,
+};
+
 static RzList *pdb7_extract_streams(RzPdb *pdb, RzPdbMsfStreamDirectory *msd) {
 	RzList *streams = rz_list_newf(msf_stream_free);
 	if (!streams) {
@@ -131,8 +219,8 @@ static RzList *pdb7_extract_streams(RzPdb *pdb, RzPdbMsfStreamDirectory *msd) {
 			rz_list_append(streams, stream);
 			continue;
 		}
-		ut8 *stream_data = (ut8 *)malloc((size_t)stream->blocks_num * pdb->super_block->block_size);
-		if (!stream_data) {
+		ut32 *block_map = RZ_NEWS(ut32, stream->blocks_num);
+		if (!block_map) {
 			RZ_FREE(stream);
 			rz_list_free(streams);
 			RZ_LOG_ERROR("Error allocating memory.\n");
@@ -140,19 +228,25 @@ static RzList *pdb7_extract_streams(RzPdb *pdb, RzPdbMsfStreamDirectory *msd) {
 		}
 		for (size_t j = 0; j < stream->blocks_num; j++) {
 			ut32 block_idx;
-			if (!rz_buf_read_le32(msd->sd, &block_idx)) {
+			if (!rz_buf_read_le32(msd->sd, &block_idx) || block_idx >= pdb->super_block->num_blocks) {
+				RZ_LOG_ERROR("Error block index.\n");
 				RZ_FREE(stream);
-				RZ_FREE(stream_data);
+				RZ_FREE(block_map);
 				rz_list_free(streams);
 				return NULL;
 			}
-			rz_buf_seek(pdb->buf, (long long)block_idx * pdb->super_block->block_size, RZ_BUF_SET);
-			rz_buf_read(pdb->buf, stream_data + j * pdb->super_block->block_size, pdb->super_block->block_size);
+			block_map[j] = block_idx;
 		}
-		stream->stream_data = rz_buf_new_with_bytes(stream_data, stream->stream_size);
+		MsfStreamBufUser u = {
+			.file = pdb->buf,
+			.block_size = pdb->super_block->block_size,
+			.block_map = block_map,
+			.size = stream->stream_size,
+		};
+		stream->stream_data = rz_buf_new_with_methods(&msf_stream_buf_methods, &u);
 		if (!stream->stream_data) {
 			RZ_FREE(stream);
-			RZ_FREE(stream_data);
+			RZ_FREE(block_map);
 			rz_list_free(streams);
 			goto error_memory;
 		}
@@ -184,7 +278,7 @@ static RzPdbMsfStreamDirectory *pdb7_extract_msf_stream_directory(RzPdb *pdb) {
 			RZ_FREE(block_map);
 			goto error;
 		}
-		if (block_idx > pdb->super_block->num_blocks) {
+		if (block_idx >= pdb->super_block->num_blocks) {
 			RZ_LOG_ERROR("Error block index.\n");
 			RZ_FREE(block_map);
 			goto error;
@@ -275,7 +369,11 @@ error:
  */
 RZ_API RZ_OWN RzPdb *rz_bin_pdb_parse_from_file(RZ_NONNULL const char *filename) {
 	rz_return_val_if_fail(filename, NULL);
-	RzBuffer *buf = rz_buf_new_slurp(filename);
+	// streams are read on demand from the file, so it is mapped instead of slurped
+	RzBuffer *buf = rz_buf_new_mmap(filename, RZ_PERM_R, 0);
+	if (!buf) {
+		buf = rz_buf_new_slurp(filename);
+	}
 	if (!buf) {
 		eprintf("%s: Error reading file \"%s\"\n", __FUNCTION__, filename);
 		return false;
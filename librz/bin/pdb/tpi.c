@@ -701,8 +701,13 @@ static void free_tpi_rbtree(RBNode *node, void *user) {
 }
 
 RZ_IPI void free_tpi_stream(RzPdbTpiStream *stream) {
+	if (!stream) {
+		return;
+	}
 	rz_rbtree_free(stream->types, free_tpi_rbtree, NULL);
 	rz_list_free(stream->print_type);
+	rz_buf_free(stream->type_buf);
+	free(stream->type_offsets);
 }
 
 static void skip_padding(RzBuffer *buf, ut16 len, ut16 *read_len, bool has_length) {
@@ -1769,25 +1774,74 @@ RZ_IPI bool parse_tpi_stream(RzPdb *pdb, RzPdbMsfStream *stream) {
 		RZ_LOG_ERROR("Corrupted TPI stream.\n");
 		return false;
 	}
-	RzPdbTpiType *type;
-	for (ut32 i = s->header.TypeIndexBegin; i < s->header.TypeIndexEnd; i++) {
-		type = RZ_NEW0(RzPdbTpiType);
-		if (!type) {
-			continue;
-		}
-		type->type_index = i;
-		if (!parse_tpi_types(buf, type) || !type->type_data) {
-			RZ_LOG_ERROR("Parse TPI type error. idx in stream: 0x%" PFMT32x "\n", i);
-			RZ_FREE(type);
-			exit(0);
+	if (s->header.TypeIndexEnd < s->header.TypeIndexBegin) {
+		RZ_LOG_ERROR("Corrupted TPI stream.\n");
+		return false;
+	}
+	// Only the offsets of the records are collected here, each type is
+	// decoded by rz_bin_pdb_get_type_by_index() the first time it is used.
+	ut32 count = s->header.TypeIndexEnd - s->header.TypeIndexBegin;
+	ut64 size = rz_buf_size(buf);
+	if ((ut64)count * sizeof(ut32) > size) {
+		RZ_LOG_ERROR("Corrupted TPI stream.\n");
+		return false;
+	}
+	s->type_offsets = RZ_NEWS(ut32, count);
+	if (count && !s->type_offsets) {
+		RZ_LOG_ERROR("Error allocating memory.\n");
+		return false;
+	}
+	ut64 offset = rz_buf_tell(buf);
+	for (ut32 i = 0; i < count; i++) {
+		ut16 length;
+		if (offset + sizeof(ut16) > size || !rz_buf_read_le16_at(buf, offset, &length) || offset + sizeof(ut16) + length > size) {
+			RZ_LOG_ERROR("Parse TPI type error. idx in stream: 0x%" PFMT32x "\n", s->header.TypeIndexBegin + i);
+			return false;
 		}
-		rz_rbtree_insert(&s->types, &type->type_index, &type->rb, tpi_type_node_cmp, NULL);
+		s->type_offsets[i] = (ut32)offset;
+		offset += sizeof(ut16) + length;
 	}
+	s->type_buf = rz_buf_ref(buf);
 	return true;
 }
 
+#define TPI_TYPE_BROKEN UT32_MAX
+
+/**
+ * Decodes the record of the given type index and caches it in the tree of
+ * the decoded types. A record which cannot be decoded is marked as broken,
+ * so it is not decoded again by the following lookups.
+ */
+static RzPdbTpiType *tpi_type_load(RzPdbTpiStream *stream, ut32 index) {
+	if (!stream->type_offsets || index < stream->header.TypeIndexBegin || index >= stream->header.TypeIndexEnd) {
+		return NULL;
+	}
+	ut32 *offset = &stream->type_offsets[index - stream->header.TypeIndexBegin];
+	if (*offset == TPI_TYPE_BROKEN) {
+		return NULL;
+	}
+	RzPdbTpiType *type = RZ_NEW0(RzPdbTpiType);
+	if (!type) {
+		return NULL;
+	}
+	type->type_index = index;
+	rz_buf_seek(stream->type_buf, *offset, RZ_BUF_SET);
+	if (!parse_tpi_types(stream->type_buf, type) || !type->type_data) {
+		RZ_LOG_ERROR("Parse TPI type error. idx in stream: 0x%" PFMT32x "\n", index);
+		RZ_FREE(type);
+		*offset = TPI_TYPE_BROKEN;
+		return NULL;
+	}
+	rz_rbtree_insert(&stream->types, &type->type_index, &type->rb, tpi_type_node_cmp, NULL);
+	return type;
+}
+
 /**
  * \brief Get RzPdbTpiType that matches tpi stream index
+ *
+ * The type record is decoded the first time it is requested, then it is
+ * owned by the stream and returned by the following lookups.
+ *
  * \param stream TPI Stream
  * \param index TPI Stream Index
  */
@@ -1800,7 +1854,7 @@ RZ_API RZ_BORROW RzPdbTpiType *rz_bin_pdb_get_type_by_index(RZ_NONNULL RzPdbTpiS
 	RBNode *node = rz_rbtree_find(stream->types, &index, tpi_type_node_cmp, NULL);
 	if (!node) {
 		if (!is_simple_type(stream, index)) {
-			return NULL;
+			return tpi_type_load(stream, index);
 		} else {
 			return parse_simple_type(stream, index);
 		}
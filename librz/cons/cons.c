@@ -648,6 +648,8 @@ RZ_API RzCons *rz_cons_free(void) {
 	RZ_FREE(I.context->lastOutput);
 	I.context->lastLength = 0;
 	RZ_FREE(I.pager);
+	rz_cons_screen_free(I.screen);
+	I.screen = NULL;
 	return NULL;
 }
 
@@ -724,6 +726,9 @@ RZ_API void rz_cons_fill_line(void) {
 }
 
 RZ_API void rz_cons_clear_line(int std_err) {
+	if (I.screen) {
+		rz_cons_screen_invalidate(I.screen);
+	}
 #if __WINDOWS__
 	if (I.vtmode != RZ_VIRT_TERM_MODE_DISABLE) {
 		fprintf(std_err ? stderr : stdout, "%s", RZ_CONS_CLEAR_LINE);
@@ -933,6 +938,9 @@ RZ_API void rz_cons_flush(void) {
 		rz_cons_reset();
 		return;
 	}
+	if (I.screen && CTX(buffer_len)) {
+		rz_cons_screen_invalidate(I.screen);
+	}
 	if (lastMatters() && !CTX(lastMode)) {
 		// snapshot of the output
 		if (CTX(buffer_len) > CTX(lastLength)) {
@@ -1032,6 +1040,42 @@ RZ_API void rz_cons_flush(void) {
 	}
 }
 
+/**
+ * Writes only the cells of the frame which changed since the last one,
+ * returns false if the whole frame must be written instead.
+ */
+static bool visual_write_damage(void) {
+	if (!I.screen) {
+		I.screen = rz_cons_screen_new();
+		if (!I.screen) {
+			return false;
+		}
+	}
+	if (!rz_cons_screen_resize(I.screen, I.columns, I.rows)) {
+		return false;
+	}
+	I.screen->wrap = I.break_lines;
+	rz_cons_screen_clear(I.screen);
+	rz_cons_screen_write(I.screen, I.context->buffer, I.context->buffer_len);
+	RzStrBuf out;
+	rz_strbuf_init(&out);
+	if (rz_cons_screen_render(I.screen, &out)) {
+		__cons_write(rz_strbuf_get(&out), rz_strbuf_length(&out));
+	}
+	rz_strbuf_fini(&out);
+	return true;
+}
+
+static void visual_write(void) {
+	if (I.damage && visual_write_damage()) {
+		return;
+	}
+	rz_cons_visual_write(I.context->buffer);
+	if (I.screen) {
+		rz_cons_screen_invalidate(I.screen);
+	}
+}
+
 RZ_API void rz_cons_visual_flush(void) {
 	if (CTX(noflush)) {
 		return;
@@ -1041,12 +1085,12 @@ RZ_API void rz_cons_visual_flush(void) {
 /* TODO: this ifdef must go in the function body */
 #if __WINDOWS__
 		if (I.vtmode != RZ_VIRT_TERM_MODE_DISABLE) {
-			rz_cons_visual_write(I.context->buffer);
+			visual_write();
 		} else {
 			rz_cons_w32_print(I.context->buffer, I.context->buffer_len, true);
 		}
 #else
-		rz_cons_visual_write(I.context->buffer);
+		visual_write();
 #endif
 	}
 	rz_cons_reset();
@@ -1074,6 +1118,9 @@ RZ_API void rz_cons_print_fps(int col) {
 	if (col < 1) {
 		col = 12;
 	}
+	if (I.screen) {
+		rz_cons_screen_damage(I.screen, 0);
+	}
 #ifdef __WINDOWS__
 	if (I.vtmode != RZ_VIRT_TERM_MODE_DISABLE) {
 		eprintf("\x1b[0;%dH[%d FPS] \n", w - col, fps);
@@ -1972,6 +2019,9 @@ RZ_API void rz_cons_cmd_help(const char *help[], bool use_color) {
 }
 
 RZ_API void rz_cons_clear_buffer(void) {
+	if (I.screen) {
+		rz_cons_screen_invalidate(I.screen);
+	}
 	if (I.vtmode != RZ_VIRT_TERM_MODE_DISABLE) {
 		rz_xwrite(1, "\x1b"
 			     "c\x1b[3J",
@@ -0,0 +1,547 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_cons.h>
+
+/*
+ * Damage tracking for the visual modes.
+ *
+ * The ANSI output of a frame is parsed into a grid of cells (the back
+ * buffer) and compared with the cells of the previous frame (the front
+ * buffer), so that only the runs of changed cells are written to the
+ * terminal, each one preceded by a cursor motion.
+ *
+ * Every UTF-8 character takes a cell, except for the fullwidth ones which
+ * take two. The SGR sequences in effect on a cell are interned, and cells
+ * refer to them by index.
+ */
+
+#define SCREEN_MAX_ATTRS    4096
+#define SCREEN_MAX_ATTR_LEN 256
+#define SCREEN_MAX_PARAMS   16
+// Unchanged cells between two changed ones which are written again rather
+// than skipped with a cursor motion, which takes about as many bytes
+#define SCREEN_RUN_GAP 4
+
+#define CELL(s, buf, x, y) (&(buf)[(size_t)(y) * (s)->cols + (x)])
+
+static bool attrs_init(RzConsScreen *screen) {
+	rz_pvector_init(&screen->attrs, free);
+	screen->attrs_idx = ht_pu_new0();
+	char *none = strdup("");
+	if (!screen->attrs_idx || !none || !rz_pvector_push(&screen->attrs, none)) {
+		free(none);
+		return false;
+	}
+	return ht_pu_insert(screen->attrs_idx, none, 0);
+}
+
+static void attrs_fini(RzConsScreen *screen) {
+	rz_pvector_fini(&screen->attrs);
+	ht_pu_free(screen->attrs_idx);
+	screen->attrs_idx = NULL;
+}
+
+static ut32 attrs_intern(RzConsScreen *screen, const char *attr) {
+	bool found = false;
+	ut64 idx = ht_pu_find(screen->attrs_idx, attr, &found);
+	if (found) {
+		return (ut32)idx;
+	}
+	char *dup = strdup(attr);
+	if (!dup || !rz_pvector_push(&screen->attrs, dup)) {
+		free(dup);
+		return 0;
+	}
+	idx = rz_pvector_len(&screen->attrs) - 1;
+	ht_pu_insert(screen->attrs_idx, dup, idx);
+	return (ut32)idx;
+}
+
+/**
+ * \brief Creates an empty screen, to be sized with rz_cons_screen_resize()
+ */
+RZ_API RZ_OWN RzConsScreen *rz_cons_screen_new(void) {
+	RzConsScreen *screen = RZ_NEW0(RzConsScreen);
+	if (!screen) {
+		return NULL;
+	}
+	rz_strbuf_init(&screen->passthrough);
+	if (!attrs_init(screen)) {
+		rz_cons_screen_free(screen);
+		return NULL;
+	}
+	return screen;
+}
+
+RZ_API void rz_cons_screen_free(RZ_NULLABLE RzConsScreen *screen) {
+	if (!screen) {
+		return;
+	}
+	free(screen->back);
+	free(screen->front);
+	free(screen->damaged);
+	attrs_fini(screen);
+	rz_strbuf_fini(&screen->passthrough);
+	free(screen);
+}
+
+/**
+ * \brief Sets the size of the screen in cells
+ *
+ * Resizing discards the cells and redraws everything on the next render.
+ */
+RZ_API bool rz_cons_screen_resize(RZ_NONNULL RzConsScreen *screen, int cols, int rows) {
+	rz_return_val_if_fail(screen, false);
+	if (cols < 1 || rows < 1) {
+		return false;
+	}
+	if (screen->back && screen->cols == cols && screen->rows == rows) {
+		return true;
+	}
+	size_t count = (size_t)cols * rows;
+	RzConsCell *back = calloc(count, sizeof(RzConsCell));
+	RzConsCell *front = calloc(count, sizeof(RzConsCell));
+	bool *damaged = calloc(rows, sizeof(bool));
+	if (!back || !front || !damaged) {
+		free(back);
+		free(front);
+		free(damaged);
+		return false;
+	}
+	free(screen->back);
+	free(screen->front);
+	free(screen->damaged);
+	screen->back = back;
+	screen->front = front;
+	screen->damaged = damaged;
+	screen->cols = cols;
+	screen->rows = rows;
+	rz_cons_screen_invalidate(screen);
+	return true;
+}
+
+/**
+ * \brief Redraws every cell on the next render
+ *
+ * To be called when the terminal was written without going through the screen.
+ */
+RZ_API void rz_cons_screen_invalidate(RZ_NONNULL RzConsScreen *screen) {
+	rz_return_if_fail(screen);
+	if (screen->damaged) {
+		memset(screen->damaged, true, screen->rows * sizeof(bool));
+	}
+}
+
+/**
+ * \brief Redraws the row \p y on the next render
+ */
+RZ_API void rz_cons_screen_damage(RZ_NONNULL RzConsScreen *screen, int y) {
+	rz_return_if_fail(screen);
+	if (y >= 0 && y < screen->rows) {
+		screen->damaged[y] = true;
+	}
+}
+
+/**
+ * \brief Starts a new frame, with all the cells blank and the cursor at the top left
+ */
+RZ_API void rz_cons_screen_clear(RZ_NONNULL RzConsScreen *screen) {
+	rz_return_if_fail(screen);
+	if (rz_pvector_len(&screen->attrs) > SCREEN_MAX_ATTRS) {
+		// The front cells refer to the dropped attributes
+		attrs_fini(screen);
+		attrs_init(screen);
+		rz_cons_screen_invalidate(screen);
+	}
+	if (screen->back) {
+		memset(screen->back, 0, (size_t)screen->cols * screen->rows * sizeof(RzConsCell));
+	}
+	screen->x = screen->y = 0;
+	screen->saved_x = screen->saved_y = 0;
+	screen->attr = 0;
+	rz_strbuf_fini(&screen->passthrough);
+	rz_strbuf_init(&screen->passthrough);
+}
+
+/**
+ * Blanks the other half of the fullwidth character at \p x, \p y if any,
+ * before the cell is overwritten.
+ */
+static void split_wide(RzConsScreen *screen, int x, int y) {
+	RzConsCell *cell = CELL(screen, screen->back, x, y);
+	if (cell->flags & RZ_CONS_CELL_CONT && x > 0) {
+		memset(cell - 1, 0, sizeof(RzConsCell));
+	} else if (cell->flags & RZ_CONS_CELL_WIDE && x + 1 < screen->cols) {
+		memset(cell + 1, 0, sizeof(RzConsCell));
+	}
+}
+
+static void erase(RzConsScreen *screen, int y, int from, int to) {
+	if (y < 0 || y >= screen->rows) {
+		return;
+	}
+	from = RZ_MAX(from, 0);
+	to = RZ_MIN(to, screen->cols);
+	if (from >= to) {
+		return;
+	}
+	split_wide(screen, from, y);
+	split_wide(screen, to - 1, y);
+	for (int x = from; x < to; x++) {
+		RzConsCell *cell = CELL(screen, screen->back, x, y);
+		memset(cell, 0, sizeof(RzConsCell));
+		// Erased cells take the background of the current attributes
+		cell->attr = screen->attr;
+	}
+}
+
+static void put_char(RzConsScreen *screen, const char *ch, int len) {
+	int width = len > 1 && rz_str_char_fullwidth(ch, len) ? 2 : 1;
+	if (screen->x + width > screen->cols) {
+		if (!screen->wrap) {
+			screen->x += width;
+			return;
+		}
+		screen->x = 0;
+		screen->y++;
+	}
+	if (screen->y >= screen->rows || screen->x + width > screen->cols) {
+		screen->x += width;
+		return;
+	}
+	split_wide(screen, screen->x, screen->y);
+	if (width > 1) {
+		split_wide(screen, screen->x + 1, screen->y);
+	}
+	RzConsCell *cell = CELL(screen, screen->back, screen->x, screen->y);
+	memset(cell, 0, sizeof(RzConsCell) * width);
+	if (*ch != ' ') {
+		// spaces are stored as blank cells, to compare equal to erased ones
+		memcpy(cell->ch, ch, len);
+		cell->len = len;
+	}
+	cell->attr = screen->attr;
+	if (width > 1) {
+		cell->flags = RZ_CONS_CELL_WIDE;
+		cell[1].flags = RZ_CONS_CELL_CONT;
+		cell[1].attr = screen->attr;
+	}
+	screen->x += width;
+}
+
+static void sgr(RzConsScreen *screen, const char *seq, size_t len, const int *params, int n_params) {
+	bool reset = !n_params || params[0] <= 0;
+	if (reset && n_params <= 1) {
+		screen->attr = 0;
+		return;
+	}
+	// A sequence starting with a reset doesn't depend on the previous ones
+	const char *prev = reset ? "" : rz_pvector_at(&screen->attrs, screen->attr);
+	size_t prev_len = strlen(prev);
+	if (prev_len + len > SCREEN_MAX_ATTR_LEN) {
+		prev_len = 0;
+	}
+	char *attr = malloc(prev_len + len + 1);
+	if (!attr) {
+		return;
+	}
+	memcpy(attr, prev, prev_len);
+	memcpy(attr + prev_len, seq, len);
+	attr[prev_len + len] = 0;
+	screen->attr = attrs_intern(screen, attr);
+	free(attr);
+}
+
+static int param(const int *params, int n_params, int i, int def) {
+	return i < n_params && params[i] > 0 ? params[i] : def;
+}
+
+static void csi(RzConsScreen *screen, const char *seq, size_t len, const int *params, int n_params, char final) {
+	int n = param(params, n_params, 0, 1);
+	switch (final) {
+	case 'm':
+		sgr(screen, seq, len, params, n_params);
+		break;
+	case 'H':
+	case 'f':
+		screen->y = n - 1;
+		screen->x = param(params, n_params, 1, 1) - 1;
+		break;
+	case 'A':
+		screen->y = RZ_MAX(screen->y - n, 0);
+		break;
+	case 'B':
+		screen->y += n;
+		break;
+	case 'C':
+		screen->x += n;
+		break;
+	case 'D':
+		screen->x = RZ_MAX(RZ_MIN(screen->x, screen->cols) - n, 0);
+		break;
+	case 'G':
+		screen->x = n - 1;
+		break;
+	case 'd':
+		screen->y = n - 1;
+		break;
+	case 'K':
+		switch (param(params, n_params, 0, 0)) {
+		case 0:
+			erase(screen, screen->y, screen->x, screen->cols);
+			break;
+		case 1:
+			erase(screen, screen->y, 0, screen->x + 1);
+			break;
+		default:
+			erase(screen, screen->y, 0, screen->cols);
+			break;
+		}
+		break;
+	case 'J': {
+		int mode = param(params, n_params, 0, 0);
+		int from = mode == 0 ? screen->y + 1 : 0;
+		int to = mode == 1 ? screen->y : screen->rows;
+		if (mode == 0) {
+			erase(screen, screen->y, screen->x, screen->cols);
+		} else if (mode == 1) {
+			erase(screen, screen->y, 0, screen->x + 1);
+		}
+		for (int y = from; y < to; y++) {
+			erase(screen, y, 0, screen->cols);
+		}
+		break;
+	}
+	case 's':
+		screen->saved_x = screen->x;
+		screen->saved_y = screen->y;
+		break;
+	case 'u':
+		screen->x = screen->saved_x;
+		screen->y = screen->saved_y;
+		break;
+	default:
+		rz_strbuf_append_n(&screen->passthrough, seq, len);
+		break;
+	}
+}
+
+/**
+ * Parses the escape sequence at \p p and returns the position after it.
+ */
+static const char *escape(RzConsScreen *screen, const char *p, const char *end) {
+	const char *q = p + 1;
+	if (q >= end) {
+		return end;
+	}
+	if (*q == ']') {
+		// OSC, terminated by BEL or ST
+		for (q++; q < end; q++) {
+			if (*q == '\a') {
+				q++;
+				break;
+			}
+			if (*q == 0x1b && q + 1 < end && q[1] == '\\') {
+				q += 2;
+				break;
+			}
+		}
+		rz_strbuf_append_n(&screen->passthrough, p, q - p);
+		return q;
+	}
+	if (*q != '[') {
+		if (*q == '7') {
+			screen->saved_x = screen->x;
+			screen->saved_y = screen->y;
+		} else if (*q == '8') {
+			screen->x = screen->saved_x;
+			screen->y = screen->saved_y;
+		} else {
+			rz_strbuf_append_n(&screen->passthrough, p, 2);
+		}
+		return q + 1;
+	}
+	q++;
+	bool private = q < end && *q && strchr("<=>?", *q);
+	int params[SCREEN_MAX_PARAMS];
+	int n_params = 0, cur = -1;
+	for (; q < end && *q >= 0x30 && *q <= 0x3f; q++) {
+		if (IS_DIGIT(*q)) {
+			cur = (cur < 0 ? 0 : cur) * 10 + (*q - '0');
+			cur = RZ_MIN(cur, 0xffff);
+		} else if (*q == ';') {
+			if (n_params < SCREEN_MAX_PARAMS) {
+				params[n_params++] = cur;
+			}
+			cur = -1;
+		}
+	}
+	if (n_params < SCREEN_MAX_PARAMS && (cur >= 0 || n_params)) {
+		params[n_params++] = cur;
+	}
+	while (q < end && *q >= 0x20 && *q <= 0x2f) {
+		q++;
+	}
+	if (q >= end) {
+		return end;
+	}
+	q++;
+	if (private) {
+		rz_strbuf_append_n(&screen->passthrough, p, q - p);
+	} else {
+		csi(screen, p, q - p, params, n_params, q[-1]);
+	}
+	return q;
+}
+
+/**
+ * \brief Draws the ANSI output \p str in the current frame
+ *
+ * The cursor motions, erase and SGR sequences are applied to the cells, the
+ * other escape sequences are written before the cells on the next render.
+ * Lines longer than the screen are truncated, or wrapped if screen->wrap is set.
+ */
+RZ_API void rz_cons_screen_write(RZ_NONNULL RzConsScreen *screen, RZ_NONNULL const char *str, size_t len) {
+	rz_return_if_fail(screen && str);
+	if (!screen->back) {
+		return;
+	}
+	const char *p = str, *end = str + len;
+	while (p < end) {
+		ut8 c = *p;
+		switch (c) {
+		case 0x1b:
+			p = escape(screen, p, end);
+			continue;
+		case '\n':
+			screen->x = 0;
+			screen->y++;
+			break;
+		case '\r':
+			screen->x = 0;
+			break;
+		case '\t':
+			screen->x = (screen->x / 8 + 1) * 8;
+			break;
+		case '\b':
+			screen->x = RZ_MAX(RZ_MIN(screen->x, screen->cols) - 1, 0);
+			break;
+		default:
+			if (c >= 0x20 && c != 0x7f) {
+				int n = rz_utf8_decode((const ut8 *)p, end - p, NULL);
+				n = RZ_MAX(n, 1);
+				put_char(screen, p, n);
+				p += n;
+				continue;
+			}
+			break;
+		}
+		p++;
+	}
+}
+
+static inline bool cell_eq(const RzConsCell *a, const RzConsCell *b) {
+	return a->attr == b->attr && a->len == b->len && a->flags == b->flags && !memcmp(a->ch, b->ch, a->len);
+}
+
+static void move_to(RzStrBuf *out, int x, int y) {
+	rz_strbuf_appendf(out, "\x1b[%d;%dH", y + 1, x + 1);
+}
+
+/**
+ * \brief Writes to \p out the sequences turning the previous frame into the current one
+ *
+ * Only the runs of cells that changed since the previous render are written,
+ * and the cursor is left where the current frame left it.
+ *
+ * \return the number of bytes appended to \p out
+ */
+RZ_API size_t rz_cons_screen_render(RZ_NONNULL RzConsScreen *screen, RZ_NONNULL RzStrBuf *out) {
+	rz_return_val_if_fail(screen && out, 0);
+	size_t start = rz_strbuf_length(out);
+	if (!screen->back) {
+		return 0;
+	}
+	rz_strbuf_append_n(out, rz_strbuf_get(&screen->passthrough), rz_strbuf_length(&screen->passthrough));
+	int cx = -1, cy = -1;
+	ut32 cattr = UT32_MAX;
+	for (int y = 0; y < screen->rows; y++) {
+		RzConsCell *back = CELL(screen, screen->back, 0, y);
+		RzConsCell *front = CELL(screen, screen->front, 0, y);
+		bool all = screen->damaged[y];
+		int x = 0;
+		while (x < screen->cols) {
+			if (!all && cell_eq(&back[x], &front[x])) {
+				x++;
+				continue;
+			}
+			if (back[x].flags & RZ_CONS_CELL_CONT && x > 0) {
+				x--;
+			}
+			int last = x;
+			for (int i = x + 1; i < screen->cols && i - last <= SCREEN_RUN_GAP; i++) {
+				if (all || !cell_eq(&back[i], &front[i])) {
+					last = i;
+				}
+			}
+			int end = last + 1;
+			if (back[last].flags & RZ_CONS_CELL_WIDE) {
+				end = RZ_MIN(end + 1, screen->cols);
+			}
+			if (cx != x || cy != y) {
+				move_to(out, x, y);
+			}
+			for (int i = x; i < end; i++) {
+				RzConsCell *cell = &back[i];
+				if (cell->flags & RZ_CONS_CELL_CONT) {
+					continue;
+				}
+				if (cell->attr != cattr) {
+					rz_strbuf_append(out, Color_RESET);
+					rz_strbuf_append(out, rz_pvector_at(&screen->attrs, cell->attr));
+					cattr = cell->attr;
+				}
+				if (cell->len) {
+					rz_strbuf_append_n(out, cell->ch, cell->len);
+				} else {
+					rz_strbuf_append_n(out, " ", 1);
+				}
+			}
+			// The cursor position is unknown after writing the last column
+			cx = end < screen->cols ? end : -1;
+			cy = y;
+			x = end;
+		}
+		screen->damaged[y] = false;
+	}
+	if (cattr && cattr != UT32_MAX) {
+		rz_strbuf_append(out, Color_RESET);
+	}
+	int x = RZ_MAX(RZ_MIN(screen->x, screen->cols - 1), 0);
+	int y = RZ_MAX(RZ_MIN(screen->y, screen->rows - 1), 0);
+	if (cx != x || cy != y) {
+		move_to(out, x, y);
+	}
+	memcpy(screen->front, screen->back, (size_t)screen->cols * screen->rows * sizeof(RzConsCell));
+	return rz_strbuf_length(out) - start;
+}
+
+/**
+ * \brief Returns the cell at column \p x and row \p y of the current frame
+ */
+RZ_API RZ_BORROW const RzConsCell *rz_cons_screen_cell(RZ_NONNULL RzConsScreen *screen, int x, int y) {
+	rz_return_val_if_fail(screen, NULL);
+	if (!screen->back || x < 0 || y < 0 || x >= screen->cols || y >= screen->rows) {
+		return NULL;
+	}
+	return CELL(screen, screen->back, x, y);
+}
+
+/**
+ * \brief Returns the SGR sequences of the cells with attributes \p attr
+ */
+RZ_API RZ_BORROW const char *rz_cons_screen_attr(RZ_NONNULL RzConsScreen *screen, ut32 attr) {
+	rz_return_val_if_fail(screen, NULL);
+	return attr < rz_pvector_len(&screen->attrs) ? rz_pvector_at(&screen->attrs, attr) : NULL;
+}
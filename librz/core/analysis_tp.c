@@ -7,59 +7,64 @@
 #include <rz_util.h>
 #include <ht_uu.h>
 #include <rz_core.h>
+#include "core_private.h"
+
 #define LOOP_MAX 10
 
-static bool analysis_emul_init(RzCore *core, RzConfigHold *hc, RzDebugTrace **dt, RzAnalysisEsilTrace **et, RzAnalysisRzilTrace **rt) {
-	if (!core->analysis->esil || !core->analysis->rzil) {
-		return false;
-	}
-	*dt = core->dbg->trace;
-	*et = core->analysis->esil->trace;
-
-	core->dbg->trace = rz_debug_trace_new();
-	core->analysis->esil->trace = rz_analysis_esil_trace_new(core->analysis->esil);
-	core->analysis->rzil->trace = rz_analysis_rzil_trace_new(core->analysis, core->analysis->rzil);
-
-	rz_config_hold_i(hc, "esil.romem", "dbg.trace",
-		"esil.nonull", "dbg.follow", NULL);
-	rz_config_set(core->config, "esil.romem", "true");
-	rz_config_set(core->config, "dbg.trace", "true");
-	rz_config_set(core->config, "esil.nonull", "true");
-	rz_config_set_i(core->config, "dbg.follow", false);
-	const char *bp = rz_reg_get_name(core->analysis->reg, RZ_REG_NAME_BP);
-	const char *sp = rz_reg_get_name(core->analysis->reg, RZ_REG_NAME_SP);
-	if ((bp && !rz_reg_getv(core->analysis->reg, bp)) && (sp && !rz_reg_getv(core->analysis->reg, sp))) {
-		eprintf("Stack isn't initialized.\n");
-		eprintf("Try running aei and aeim commands before aft for default stack initialization\n");
-		return false;
-	}
-	return (core->dbg->trace && core->analysis->esil->trace);
-}
+#define TYPE_EMUL_PAGE_SIZE       0x1000
+#define TYPE_EMUL_FCNS_PER_THREAD 16
 
-static void analysis_emul_restore(RzCore *core, RzConfigHold *hc, RzDebugTrace *dt, RzAnalysisEsilTrace *et, RzAnalysisRzilTrace *rt) {
-	rz_config_hold_restore(hc);
-	rz_config_hold_free(hc);
-	rz_debug_trace_free(core->dbg->trace);
-	rz_analysis_esil_trace_free(core->analysis->esil->trace);
-	if (!core->analysis->rzil) {
-		// not enable rzil or be freed ?
-		if (core->analysis->cur->rzil_init) {
-			// enable but be freed ??
-			rz_warn_if_reached();
-		}
-	} else {
-		rz_analysis_rzil_trace_free(core->analysis->rzil->trace);
-		core->analysis->rzil->trace = rt;
-	}
-	core->analysis->esil->trace = et;
-	core->dbg->trace = dt;
-}
+typedef struct type_emul_batch_t TypeEmulBatch;
 
-static bool type_pos_hit(RzAnalysis *analysis, RzILTraceInstruction *instr_trace, bool in_stack, int size, const char *place) {
-	if (in_stack) {
-		const char *sp_name = rz_reg_get_name(analysis->reg, RZ_REG_NAME_SP);
-		ut64 sp = rz_reg_getv(analysis->reg, sp_name);
+/**
+ * Emulation of the functions with registers and memory private to it: the
+ * memory written by the ESIL is kept in the pages of the context instead of
+ * being written to the IO of the core, so many contexts can emulate at once.
+ */
+typedef struct {
+	RzCore *core;
+	TypeEmulBatch *batch; ///< batch emulated by many threads, NULL when emulating on the calling thread only
+	RzAnalysis *analysis; ///< private analysis of the ESIL, with its registers and IO
+	RzAnalysis *decoder; ///< private analysis decoding the instructions, NULL to use the one of core
+	RzAnalysisEsil *esil;
+	RzIO *io; ///< private IO of the ESIL, whose only desc is the context
+	ut64 io_seek; ///< seek of the desc of the private IO
+	HtUP /*<ut64, ut8 *>*/ *pages; ///< page address => TYPE_EMUL_PAGE_SIZE bytes written by the emulation
+	const ut8 *arena; ///< registers at the start of each function
+	int minopcode;
+	bool breakoninvalid;
+} TypeEmul;
+
+typedef struct {
+	RzAnalysisOp *op; ///< instruction, owned by the op cache of the function
+	RzAnalysisBlock *bb;
+	int cur_idx; ///< index of the last instruction in the ESIL trace
+	ut64 sp; ///< stack pointer after emulating the instruction
+} TypeEmulStep;
 
+/**
+ * Emulation of a single function, whose types are then matched by replaying
+ * its steps.
+ */
+typedef struct {
+	RzAnalysisFunction *fcn;
+	RzAnalysisEsilTrace *trace;
+	HtUP /*<ut64, RzAnalysisOp *>*/ *op_cache;
+	RzVector /*<TypeEmulStep>*/ steps;
+	bool done; ///< whether the emulation has not been interrupted
+} TypeEmulFunction;
+
+struct type_emul_batch_t {
+	RzThreadLock *lock; ///< guards core->io and the fields below
+	TypeEmulFunction *fcns;
+	size_t n_fcns;
+	size_t next_fcn;
+	size_t finished; ///< threads done emulating
+	bool stop;
+};
+
+static bool type_pos_hit(RzILTraceInstruction *instr_trace, bool in_stack, ut64 sp, int size, const char *place) {
+	if (in_stack) {
 		ut64 write_addr = 0LL;
 		if (instr_trace && (instr_trace->stats & RZ_IL_TRACE_INS_HAS_MEM_W)) {
 			// TODO : This assumes an op will only write to memory once
@@ -197,12 +202,11 @@ static void get_src_regname(RzCore *core, ut64 addr, char *regname, int size) {
 	rz_analysis_op_free(op);
 }
 
-static ut64 get_addr(RzAnalysis *analysis, const char *regname, int idx) {
+static ut64 get_addr(RzAnalysisEsilTrace *etrace, const char *regname, int idx) {
 	if (!regname || !*regname) {
 		return UT64_MAX;
 	}
 
-	RzAnalysisEsilTrace *etrace = analysis->esil->trace;
 	RzILTraceInstruction *instruction_trace = rz_analysis_esil_get_instruction_trace(etrace, idx);
 	RzILTraceRegOp *reg_op = rz_analysis_il_get_reg_op_trace(instruction_trace, regname, false);
 
@@ -327,6 +331,18 @@ bool function_argument_type_derive(RZ_NULLABLE const RzCallable *callable, int a
 	return true;
 }
 
+struct ReturnTypeAnalysisCtx;
+
+struct TypeAnalysisCtx {
+	struct ReturnTypeAnalysisCtx *retctx;
+	RzAnalysisEsilTrace *etrace; ///< trace of the emulation of the function
+	HtUP *op_cache;
+	int cur_idx; ///< index of the current instruction in the trace
+	ut64 sp; ///< stack pointer after emulating the current instruction
+	const char *prev_dest;
+	bool str_flag;
+};
+
 #define DEFAULT_MAX  3
 #define REGNAME_SIZE 10
 #define MAX_INSTR    5
@@ -341,15 +357,17 @@ bool function_argument_type_derive(RZ_NULLABLE const RzCallable *callable, int a
  * \param prev_idx index in the esil trace
  * \param userfnc whether the callee is a user function (affects propagation direction)
  * \param caddr addr of the callee
+ * \param ctx emulation of the caller, at the call instruction
  */
 static void type_match(RzCore *core, char *fcn_name, ut64 addr, ut64 baddr, const char *cc,
-	int prev_idx, bool userfnc, ut64 caddr, HtUP *op_cache) {
-	RzAnalysisEsilTrace *etrace = core->analysis->esil->trace;
+	int prev_idx, bool userfnc, ut64 caddr, struct TypeAnalysisCtx *ctx) {
+	RzAnalysisEsilTrace *etrace = ctx->etrace;
+	HtUP *op_cache = ctx->op_cache;
 	RzTypeDB *typedb = core->analysis->typedb;
 	RzAnalysis *analysis = core->analysis;
 	RzList *types = NULL;
 
-	int idx = rz_pvector_len(etrace->instructions) - 1;
+	int idx = ctx->cur_idx;
 
 	bool verbose = rz_config_get_i(core->config, "analysis.types.verbose");
 	bool stack_rev = false, in_stack = false, format = false;
@@ -440,7 +458,7 @@ static void type_match(RzCore *core, char *fcn_name, ut64 addr, ut64 baddr, cons
 				memref = !(!memref && var && (var->kind != RZ_ANALYSIS_VAR_KIND_REG));
 			}
 			// Match type from function param to instr
-			if (type_pos_hit(analysis, instr_trace, in_stack, size, place)) {
+			if (type_pos_hit(instr_trace, in_stack, ctx->sp, size, place)) {
 				if (!cmt_set && type && name) {
 					char *typestr = rz_type_as_string(analysis->typedb, type);
 					const char *maybe_space = type->kind == RZ_TYPE_KIND_POINTER ? "" : " ";
@@ -475,7 +493,7 @@ static void type_match(RzCore *core, char *fcn_name, ut64 addr, ut64 baddr, cons
 					res = true;
 				} else {
 					get_src_regname(core, instr_addr, regname, sizeof(regname));
-					xaddr = get_addr(analysis, regname, j);
+					xaddr = get_addr(etrace, regname, j);
 				}
 			}
 			// Type propagate by following source reg
@@ -506,7 +524,7 @@ static void type_match(RzCore *core, char *fcn_name, ut64 addr, ut64 baddr, cons
 			} else if (var && res && xaddr && (xaddr != UT64_MAX)) { // Type progation using value
 				char tmp[REGNAME_SIZE] = { 0 };
 				get_src_regname(core, instr_addr, tmp, sizeof(tmp));
-				ut64 ptr = get_addr(analysis, tmp, j);
+				ut64 ptr = get_addr(etrace, tmp, j);
 				if (ptr == xaddr) {
 					if (type) {
 						var_type_set(analysis, var, type, memref);
@@ -527,19 +545,12 @@ static void type_match(RzCore *core, char *fcn_name, ut64 addr, ut64 baddr, cons
 	rz_cons_break_pop();
 }
 
-static int bb_cmpaddr(const void *_a, const void *_b) {
-	const RzAnalysisBlock *a = _a, *b = _b;
-	return a->addr > b->addr ? 1 : (a->addr < b->addr ? -1 : 0);
-}
-
 void free_op_cache_kv(HtUPKv *kv) {
 	rz_analysis_op_free(kv->value);
 }
 
-void handle_stack_canary(RzCore *core, RzAnalysisOp *aop, int cur_idx) {
-	RzILTraceInstruction *prev_trace = rz_analysis_esil_get_instruction_trace(
-		core->analysis->esil->trace,
-		cur_idx - 1);
+void handle_stack_canary(RzCore *core, RzAnalysisOp *aop, struct TypeAnalysisCtx *ctx) {
+	RzILTraceInstruction *prev_trace = rz_analysis_esil_get_instruction_trace(ctx->etrace, ctx->cur_idx - 1);
 
 	ut64 mov_addr;
 	if (prev_trace) {
@@ -624,17 +635,10 @@ static void propagate_return_type(RzCore *core, RzAnalysisOp *aop, RzAnalysisOp
 	}
 }
 
-struct TypeAnalysisCtx {
-	struct ReturnTypeAnalysisCtx *retctx;
-	int cur_idx;
-	const char *prev_dest;
-	bool str_flag;
-};
-
-void propagate_types_among_used_variables(RzCore *core, HtUP *op_cache, RzAnalysisFunction *fcn, RzAnalysisBlock *bb, RzAnalysisOp *aop, struct TypeAnalysisCtx *ctx) {
+void propagate_types_among_used_variables(RzCore *core, RzAnalysisFunction *fcn, RzAnalysisBlock *bb, RzAnalysisOp *aop, struct TypeAnalysisCtx *ctx) {
 	RzPVector *used_vars = rz_analysis_function_get_vars_used_at(fcn, aop->addr);
 	bool chk_constraint = rz_config_get_b(core->config, "analysis.types.constraint");
-	RzAnalysisOp *next_op = op_cache_get(op_cache, core, aop->addr + aop->size);
+	RzAnalysisOp *next_op = op_cache_get(ctx->op_cache, core, aop->addr + aop->size);
 	void **uvit;
 	RzType *prev_type = NULL;
 	int prev_idx = 0;
@@ -645,8 +649,7 @@ void propagate_types_among_used_variables(RzCore *core, HtUP *op_cache, RzAnalys
 	ut32 type = aop->type & RZ_ANALYSIS_OP_TYPE_MASK;
 	RzAnalysis *analysis = core->analysis;
 
-	RzAnalysisEsilTrace *etrace = core->analysis->esil->trace;
-	RzILTraceInstruction *cur_instr_trace = rz_analysis_esil_get_instruction_trace(etrace, ctx->cur_idx);
+	RzILTraceInstruction *cur_instr_trace = rz_analysis_esil_get_instruction_trace(ctx->etrace, ctx->cur_idx);
 
 	if (aop->type == RZ_ANALYSIS_OP_TYPE_CALL || aop->type & RZ_ANALYSIS_OP_TYPE_UCALL) {
 		char *full_name = NULL;
@@ -679,7 +682,7 @@ void propagate_types_among_used_variables(RzCore *core, HtUP *op_cache, RzAnalys
 			const char *Cc = rz_analysis_cc_func(core->analysis, fcn_name);
 			if (Cc && rz_analysis_cc_exist(core->analysis, Cc)) {
 				char *cc = strdup(Cc);
-				type_match(core, fcn_name, aop->addr, bb->addr, cc, prev_idx, userfnc, callee_addr, op_cache);
+				type_match(core, fcn_name, aop->addr, bb->addr, cc, prev_idx, userfnc, callee_addr, ctx);
 				prev_idx = ctx->cur_idx;
 				ctx->retctx->ret_type = rz_type_func_ret(core->analysis->typedb, fcn_name);
 				RZ_FREE(ctx->retctx->ret_reg);
@@ -691,7 +694,7 @@ void propagate_types_among_used_variables(RzCore *core, HtUP *op_cache, RzAnalys
 				free(cc);
 			}
 			if (!strcmp(fcn_name, "__stack_chk_fail")) {
-				handle_stack_canary(core, aop, ctx->cur_idx);
+				handle_stack_canary(core, aop, ctx);
 			}
 			free(fcn_name);
 		}
@@ -810,87 +813,407 @@ void propagate_types_among_used_variables(RzCore *core, HtUP *op_cache, RzAnalys
 	}
 }
 
-RZ_API void rz_core_analysis_type_match(RzCore *core, RzAnalysisFunction *fcn, HtUU *loop_table) {
-	RzListIter *it;
+static void type_emul_lock(TypeEmul *emul) {
+	if (emul->batch) {
+		rz_th_lock_enter(emul->batch->lock);
+	}
+}
 
-	rz_return_if_fail(core && core->analysis && fcn);
+static void type_emul_unlock(TypeEmul *emul) {
+	if (emul->batch) {
+		rz_th_lock_leave(emul->batch->lock);
+	}
+}
 
-	if (!core->analysis->esil) {
-		eprintf("Please run aeim\n");
-		return;
+static bool type_emul_breaked(TypeEmul *emul) {
+	if (!emul->batch) {
+		return rz_cons_is_breaked();
+	}
+	rz_th_lock_enter(emul->batch->lock);
+	bool stop = emul->batch->stop;
+	rz_th_lock_leave(emul->batch->lock);
+	return stop;
+}
+
+/*
+ * Desc of the private IO of the ESIL, whose data is the context: the reads
+ * see the memory written by the emulation over the one of the core.
+ */
+static int type_emul_io_read(RzIO *io, RzIODesc *desc, ut8 *buf, int count) {
+	TypeEmul *emul = desc->data;
+	ut64 addr = emul->io_seek;
+	type_emul_lock(emul);
+	(void)rz_io_read_at(emul->core->io, addr, buf, count);
+	type_emul_unlock(emul);
+	for (int i = 0; i < count;) {
+		ut64 at = addr + i;
+		ut64 off = at % TYPE_EMUL_PAGE_SIZE;
+		int n = RZ_MIN(count - i, TYPE_EMUL_PAGE_SIZE - off);
+		ut8 *page = ht_up_find(emul->pages, at - off, NULL);
+		if (page) {
+			memcpy(buf + i, page + off, n);
+		}
+		i += n;
 	}
+	emul->io_seek += count;
+	return count;
+}
 
-	RzAnalysis *analysis = core->analysis;
-	const int mininstrsz = rz_analysis_archinfo(analysis, RZ_ANALYSIS_ARCHINFO_MIN_OP_SIZE);
-	const int minopcode = RZ_MAX(1, mininstrsz);
-	RzConfigHold *hc = rz_config_hold_new(core->config);
-	if (!hc) {
+static int type_emul_io_write(RzIO *io, RzIODesc *desc, const ut8 *buf, int count) {
+	TypeEmul *emul = desc->data;
+	ut64 addr = emul->io_seek;
+	type_emul_lock(emul);
+	bool writable = rz_io_is_valid_offset(emul->core->io, addr, RZ_PERM_W);
+	type_emul_unlock(emul);
+	if (!writable) {
+		return -1;
+	}
+	for (int i = 0; i < count;) {
+		ut64 at = addr + i;
+		ut64 off = at % TYPE_EMUL_PAGE_SIZE;
+		int n = RZ_MIN(count - i, TYPE_EMUL_PAGE_SIZE - off);
+		ut8 *page = ht_up_find(emul->pages, at - off, NULL);
+		if (!page) {
+			page = malloc(TYPE_EMUL_PAGE_SIZE);
+			if (!page) {
+				return -1;
+			}
+			// the bytes not written keep the content of the IO
+			type_emul_lock(emul);
+			(void)rz_io_read_at(emul->core->io, at - off, page, TYPE_EMUL_PAGE_SIZE);
+			type_emul_unlock(emul);
+			if (!ht_up_insert(emul->pages, at - off, page)) {
+				free(page);
+				return -1;
+			}
+		}
+		memcpy(page + off, buf + i, n);
+		i += n;
+	}
+	emul->io_seek += count;
+	return count;
+}
+
+static ut64 type_emul_io_lseek(RzIO *io, RzIODesc *desc, ut64 offset, int whence) {
+	TypeEmul *emul = desc->data;
+	switch (whence) {
+	case RZ_IO_SEEK_SET:
+		emul->io_seek = offset;
+		break;
+	case RZ_IO_SEEK_CUR:
+		emul->io_seek += offset;
+		break;
+	case RZ_IO_SEEK_END:
+		emul->io_seek = UT64_MAX;
+		break;
+	}
+	return emul->io_seek;
+}
+
+static RzIOPlugin type_emul_io_plugin = {
+	.name = "typeemul",
+	.desc = "Memory of the type matching emulation",
+	.license = "LGPL3",
+	.uris = "typeemul://",
+	.read = type_emul_io_read,
+	.write = type_emul_io_write,
+	.lseek = type_emul_io_lseek,
+};
+
+/*
+ * The whole address space is the desc of the private IO, so the mapped
+ * offsets are the ones of the core.
+ */
+static bool type_emul_io_is_valid_offset(RzIO *io, ut64 addr, int hasperm) {
+	TypeEmul *emul = io->desc->data;
+	type_emul_lock(emul);
+	bool ret = rz_io_is_valid_offset(emul->core->io, addr, hasperm);
+	type_emul_unlock(emul);
+	return ret;
+}
+
+static RzIO *type_emul_io_new(TypeEmul *emul) {
+	RzIO *io = rz_io_new();
+	if (!io) {
+		return NULL;
+	}
+	RzIODesc *desc = rz_io_desc_new(io, &type_emul_io_plugin, "typeemul://", RZ_PERM_RW, 0, emul);
+	if (!desc) {
+		rz_io_free(io);
+		return NULL;
+	}
+	if (!rz_io_desc_add(io, desc)) {
+		rz_io_desc_free(desc);
+		rz_io_free(io);
+		return NULL;
+	}
+	// physical mode, reading the desc at the addresses of the core
+	io->va = false;
+	io->desc = desc;
+	return io;
+}
+
+static void type_emul_page_free_kv(HtUPKv *kv) {
+	free(kv->value);
+}
+
+static RzAnalysis *type_emul_analysis_new(TypeEmul *emul) {
+	RzCore *core = emul->core;
+	const char *profile = core->analysis->reg->reg_profile_str;
+	if (!profile) {
+		return NULL;
+	}
+	RzAnalysis *analysis = rz_core_analysis_decoder_new(core);
+	if (!analysis) {
+		return NULL;
+	}
+	// same registers of the core, so its arena can be used
+	if (!rz_reg_set_profile_string(analysis->reg, profile)) {
+		rz_analysis_free(analysis);
+		return NULL;
+	}
+	rz_io_bind(emul->io, &analysis->iob);
+	analysis->iob.is_valid_offset = type_emul_io_is_valid_offset;
+	return analysis;
+}
+
+static void type_emul_fini(TypeEmul *emul) {
+	// the ESIL calls the fini of the plugin of its analysis
+	rz_analysis_esil_free(emul->esil);
+	rz_analysis_free(emul->analysis);
+	rz_analysis_free(emul->decoder);
+	rz_io_free(emul->io);
+	ht_up_free(emul->pages);
+	memset(emul, 0, sizeof(*emul));
+}
+
+/**
+ * Initializes \p emul with the ESIL settings of the core. Without \p batch
+ * the instructions are decoded by the analysis of the core, otherwise by a
+ * private one which can be used by another thread.
+ */
+static bool type_emul_init(TypeEmul *emul, RzCore *core, TypeEmulBatch *batch, const ut8 *arena) {
+	RzAnalysisEsil *src = core->analysis->esil;
+	memset(emul, 0, sizeof(*emul));
+	emul->core = core;
+	emul->batch = batch;
+	emul->arena = arena;
+	emul->io = type_emul_io_new(emul);
+	emul->analysis = emul->io ? type_emul_analysis_new(emul) : NULL;
+	emul->decoder = batch ? rz_core_analysis_decoder_new(core) : NULL;
+	emul->esil = rz_analysis_esil_new(src->stacksize, src->iotrap, 64);
+	emul->pages = ht_up_new(NULL, type_emul_page_free_kv, NULL);
+	if (!emul->analysis || (batch && !emul->decoder) || !emul->esil || !emul->pages ||
+		!rz_analysis_esil_setup(emul->esil, emul->analysis, rz_config_get_b(core->config, "esil.romem"),
+			false, rz_config_get_b(core->config, "esil.nonull"))) {
+		type_emul_fini(emul);
+		return false;
+	}
+	emul->esil->addrmask = src->addrmask;
+	emul->esil->exectrap = src->exectrap;
+	const int mininstrsz = rz_analysis_archinfo(core->analysis, RZ_ANALYSIS_ARCHINFO_MIN_OP_SIZE);
+	emul->minopcode = RZ_MAX(1, mininstrsz);
+	emul->breakoninvalid = rz_config_get_b(core->config, "esil.breakoninvalid");
+	return true;
+}
+
+static bool type_emul_stack_initialized(TypeEmul *emul) {
+	RzReg *reg = emul->analysis->reg;
+	rz_reg_arena_poke(reg, emul->arena);
+	const char *bp = rz_reg_get_name(reg, RZ_REG_NAME_BP);
+	const char *sp = rz_reg_get_name(reg, RZ_REG_NAME_SP);
+	if ((bp && !rz_reg_getv(reg, bp)) && (sp && !rz_reg_getv(reg, sp))) {
+		eprintf("Stack isn't initialized.\n");
+		eprintf("Try running aei and aeim commands before aft for default stack initialization\n");
+		return false;
+	}
+	return true;
+}
+
+static int type_emul_decode(TypeEmul *emul, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
+	RzAnalysis *hints = emul->core->analysis;
+	if (!emul->decoder) {
+		return rz_analysis_op(hints, op, addr, buf, len, mask);
+	}
+	// same as the coreb.archbits callback, without touching the configuration
+	int bits = 0;
+	rz_core_arch_bits_at(emul->core, addr, &bits, NULL);
+	if (bits && bits != emul->decoder->bits) {
+		rz_analysis_set_bits(emul->decoder, bits);
+	}
+	// the hints are only stored in the analysis of the core
+	int ret = rz_analysis_op(emul->decoder, op, addr, buf, len, mask & ~RZ_ANALYSIS_OP_MASK_HINT);
+	if (mask & RZ_ANALYSIS_OP_MASK_HINT) {
+		RzAnalysisHint *hint = rz_analysis_hint_get(hints, addr);
+		if (hint) {
+			rz_analysis_op_hint(op, hint);
+			rz_analysis_hint_free(hint);
+		}
+	}
+	return ret;
+}
+
+/**
+ * Same as op_cache_get(), decoding with the decoder of \p emul.
+ */
+static RzAnalysisOp *type_emul_op_cache_get(TypeEmul *emul, HtUP *cache, ut64 addr) {
+	if (!emul->decoder) {
+		return op_cache_get(cache, emul->core, addr);
+	}
+	RzAnalysisOp *op = ht_up_find(cache, addr, NULL);
+	if (op) {
+		return op;
+	}
+	ut8 buf[32];
+	type_emul_lock(emul);
+	bool read = rz_io_read_at(emul->core->io, addr, buf, sizeof(buf));
+	type_emul_unlock(emul);
+	op = read ? RZ_NEW0(RzAnalysisOp) : NULL;
+	if (op && type_emul_decode(emul, op, addr, buf, sizeof(buf), RZ_ANALYSIS_OP_MASK_BASIC | RZ_ANALYSIS_OP_MASK_VAL) < 1) {
+		rz_analysis_op_free(op);
+		op = NULL;
+	}
+	if (!ht_up_insert(cache, addr, op)) {
+		rz_analysis_op_free(op);
+		return NULL;
+	}
+	return op;
+}
+
+/**
+ * Emulates the instruction at the program counter, as rz_core_esil_step()
+ * does with dbg.trace enabled.
+ */
+static void type_emul_step(TypeEmul *emul) {
+	RzAnalysisEsil *esil = emul->esil;
+	RzReg *reg = emul->analysis->reg;
+	const char *name = rz_reg_get_name(reg, RZ_REG_NAME_PC);
+	RzAnalysisOp op = { 0 };
+	ut8 code[32];
+
+	esil->trap = 0;
+	ut64 addr = rz_reg_getv(reg, name);
+	if (esil->exectrap && !type_emul_io_is_valid_offset(emul->io, addr, RZ_PERM_X)) {
+		esil->trap = RZ_ANALYSIS_TRAP_EXEC_ERR;
+		esil->trap_code = addr;
 		return;
 	}
-	RzDebugTrace *dt = NULL;
-	RzAnalysisEsilTrace *et = NULL;
-	RzAnalysisRzilTrace *rt = NULL;
-	if (!analysis_emul_init(core, hc, &dt, &et, &rt) || !fcn) {
-		analysis_emul_restore(core, hc, dt, et, rt);
+	int dataAlign = rz_analysis_archinfo(emul->analysis, RZ_ANALYSIS_ARCHINFO_DATA_ALIGN);
+	if (dataAlign > 1 && addr % dataAlign && emul->breakoninvalid) {
 		return;
 	}
+	type_emul_lock(emul);
+	(void)rz_io_read_at_mapped(emul->core->io, addr, code, sizeof(code));
+	type_emul_unlock(emul);
+	int ret = type_emul_decode(emul, &op, addr, code, sizeof(code), RZ_ANALYSIS_OP_MASK_ESIL | RZ_ANALYSIS_OP_MASK_HINT);
+	if (op.size < 1 || ret < 1) {
+		if (emul->breakoninvalid) {
+			goto out;
+		}
+		op.size = 1; // avoid inverted stepping
+	}
+	rz_reg_setv(reg, name, addr + op.size);
+	if (ret) {
+		rz_analysis_esil_set_pc(esil, addr);
+		rz_analysis_esil_trace_op(esil, &op);
+		bool isNextFall = op.type == RZ_ANALYSIS_OP_TYPE_CJMP && rz_reg_getv(reg, name) == addr + op.size;
+		// only support 1 slot for now
+		if (op.delay && !isNextFall) {
+			ut8 code2[32];
+			ut64 naddr = addr + op.size;
+			RzAnalysisOp op2 = { 0 };
+			rz_analysis_esil_set_pc(esil, naddr);
+			type_emul_lock(emul);
+			(void)rz_io_read_at(emul->core->io, naddr, code2, sizeof(code2));
+			type_emul_unlock(emul);
+			if (type_emul_decode(emul, &op2, naddr, code2, sizeof(code2), RZ_ANALYSIS_OP_MASK_ESIL | RZ_ANALYSIS_OP_MASK_HINT) > 0) {
+				switch (op2.type) {
+				case RZ_ANALYSIS_OP_TYPE_CJMP:
+				case RZ_ANALYSIS_OP_TYPE_JMP:
+				case RZ_ANALYSIS_OP_TYPE_CRET:
+				case RZ_ANALYSIS_OP_TYPE_RET:
+					// branches are illegal in a delay slot
+					esil->trap = RZ_ANALYSIS_TRAP_EXEC_ERR;
+					esil->trap_code = addr;
+					rz_analysis_op_fini(&op2);
+					goto out;
+				}
+				const char *e = RZ_STRBUF_SAFEGET(&op2.esil);
+				if (RZ_STR_ISNOTEMPTY(e)) {
+					rz_analysis_esil_parse(esil, e);
+				}
+			}
+			rz_analysis_op_fini(&op2);
+		}
+	}
+	int pcalign = emul->core->analysis->pcalign;
+	if (pcalign > 0) {
+		ut64 pc = rz_reg_getv(reg, name);
+		rz_reg_setv(reg, name, pc - (pc % pcalign));
+	}
+out:
+	rz_analysis_op_fini(&op);
+}
 
-	// Reserve bigger ht to avoid rehashing
-	HtPPOptions opt;
-	RzDebugTrace *dtrace = core->dbg->trace;
-	opt = dtrace->ht->opt;
-	ht_pp_free(dtrace->ht);
-	dtrace->ht = ht_pp_new_size(fcn->ninstr, opt.dupvalue, opt.freefn, opt.calcsizeV);
-	dtrace->ht->opt = opt;
-
-	// Create a new context to store the return type propagation state
-	struct ReturnTypeAnalysisCtx retctx = {
-		.resolved = false,
-		.ret_type = NULL,
-		.ret_reg = NULL,
-	};
-	struct TypeAnalysisCtx ctx = {
-		.retctx = &retctx,
-		.cur_idx = 0,
-		.prev_dest = NULL,
-		.str_flag = false
-	};
+static void type_emul_function_fini(TypeEmulFunction *tf) {
+	rz_analysis_esil_trace_free(tf->trace);
+	tf->trace = NULL;
+	ht_up_free(tf->op_cache);
+	tf->op_cache = NULL;
+	rz_vector_fini(&tf->steps);
+}
 
-	HtUP *op_cache = NULL;
-	const char *pc = rz_reg_get_name(core->dbg->reg, RZ_REG_NAME_PC);
-	if (!pc) {
-		goto out_function;
+/**
+ * Emulates the blocks of the function of \p tf in address order, recording
+ * the steps whose types are matched by type_match_replay(). The blocks must
+ * be sorted already.
+ *
+ * \param loop_table addr => times an instruction has been emulated, NULL to not limit them
+ */
+static void type_emul_function(TypeEmul *emul, TypeEmulFunction *tf, HtUU *loop_table) {
+	RzReg *reg = emul->analysis->reg;
+	tf->done = false;
+	tf->op_cache = ht_up_new(NULL, free_op_cache_kv, NULL);
+	tf->trace = rz_analysis_esil_trace_new(emul->esil);
+	if (!tf->op_cache || !tf->trace) {
+		return;
 	}
-	RzRegItem *r = rz_reg_get(core->dbg->reg, pc, -1);
+	// every function starts from the same registers and memory
+	rz_reg_arena_poke(reg, emul->arena);
+	ht_up_free(emul->pages);
+	emul->pages = ht_up_new(NULL, type_emul_page_free_kv, NULL);
+	if (!emul->pages) {
+		return;
+	}
+	emul->esil->trace = tf->trace;
+	rz_analysis_esil_set_pc(emul->esil, tf->fcn->addr);
+
+	const char *pc = rz_reg_get_name(reg, RZ_REG_NAME_PC);
+	const char *sp = rz_reg_get_name(reg, RZ_REG_NAME_SP);
+	RzRegItem *r = pc ? rz_reg_get(reg, pc, -1) : NULL;
 	if (!r) {
-		goto out_function;
+		goto out;
 	}
-	rz_cons_break_push(NULL, NULL);
-	rz_list_sort(fcn->bbs, bb_cmpaddr);
 	// TODO: The algorithm can be more accurate if blocks are followed by their jmp/fail, not just by address
+	RzListIter *it;
 	RzAnalysisBlock *bb;
-	rz_list_foreach (fcn->bbs, it, bb) {
+	rz_list_foreach (tf->fcn->bbs, it, bb) {
 		ut64 addr = bb->addr;
-		rz_reg_set_value(core->dbg->reg, r, addr);
-		ht_up_free(op_cache);
-		op_cache = ht_up_new(NULL, free_op_cache_kv, NULL);
-		if (!op_cache) {
-			break;
-		}
+		rz_reg_set_value(reg, r, addr);
 		while (1) {
-			if (rz_cons_is_breaked()) {
-				goto out_function;
+			if (type_emul_breaked(emul)) {
+				goto out;
 			}
-			ut64 pcval = rz_reg_getv(analysis->reg, pc);
+			ut64 pcval = rz_reg_getv(reg, pc);
 			if ((addr >= bb->addr + bb->size) || (addr < bb->addr) || pcval != addr) {
 				break;
 			}
-			RzAnalysisOp *aop = op_cache_get(op_cache, core, addr);
+			RzAnalysisOp *aop = type_emul_op_cache_get(emul, tf->op_cache, addr);
 			if (!aop) {
 				break;
 			}
 			if (aop->type == RZ_ANALYSIS_OP_TYPE_ILL) {
-				addr += minopcode;
+				addr += emul->minopcode;
 				continue;
 			}
 
@@ -907,29 +1230,73 @@ RZ_API void rz_core_analysis_type_match(RzCore *core, RzAnalysisFunction *fcn, H
 			}
 
 			if (rz_analysis_op_nonlinear(aop->type)) { // skip the instr
-				rz_reg_set_value(core->dbg->reg, r, addr + aop->size);
+				rz_reg_set_value(reg, r, addr + aop->size);
 			} else {
-				rz_core_esil_step(core, UT64_MAX, NULL, NULL, false);
-			}
-
-			RzPVector *ins_traces = analysis->esil->trace->instructions;
-			ctx.cur_idx = rz_pvector_len(ins_traces) - 1;
-			RzList *fcns = rz_analysis_get_functions_in(analysis, aop->addr);
-			if (!fcns) {
-				break;
-			}
-			RzListIter *it;
-			RzAnalysisFunction *fcn;
-			rz_list_foreach (fcns, it, fcn) {
-				propagate_types_among_used_variables(core, op_cache, fcn, bb, aop, &ctx);
+				type_emul_step(emul);
 			}
+			TypeEmulStep step = {
+				.op = aop,
+				.bb = bb,
+				.cur_idx = rz_pvector_len(tf->trace->instructions) - 1,
+				.sp = sp ? rz_reg_getv(reg, sp) : 0,
+			};
+			rz_vector_push(&tf->steps, &step);
 			addr += aop->size;
-			rz_list_free(fcns);
 		}
 	}
+	tf->done = true;
+out:
+	emul->esil->trace = NULL;
+}
+
+/**
+ * Matches the types of the variables used by the instructions emulated by
+ * type_emul_function(), on the calling thread.
+ */
+static void type_match_replay(RzCore *core, TypeEmulFunction *tf) {
+	RzAnalysis *analysis = core->analysis;
+	// Create a new context to store the return type propagation state
+	struct ReturnTypeAnalysisCtx retctx = {
+		.resolved = false,
+		.ret_type = NULL,
+		.ret_reg = NULL,
+	};
+	struct TypeAnalysisCtx ctx = {
+		.retctx = &retctx,
+		.etrace = tf->trace,
+		.op_cache = tf->op_cache,
+		.cur_idx = 0,
+		.sp = 0,
+		.prev_dest = NULL,
+		.str_flag = false
+	};
+	if (!tf->trace || !tf->op_cache) {
+		return;
+	}
+	TypeEmulStep *step;
+	rz_vector_foreach(&tf->steps, step) {
+		if (rz_cons_is_breaked()) {
+			goto out_function;
+		}
+		ctx.cur_idx = step->cur_idx;
+		ctx.sp = step->sp;
+		RzList *fcns = rz_analysis_get_functions_in(analysis, step->op->addr);
+		if (!fcns) {
+			continue;
+		}
+		RzListIter *it;
+		RzAnalysisFunction *fcn;
+		rz_list_foreach (fcns, it, fcn) {
+			propagate_types_among_used_variables(core, fcn, step->bb, step->op, &ctx);
+		}
+		rz_list_free(fcns);
+	}
+	if (!tf->done) {
+		goto out_function;
+	}
 	// Type propagation for register based args
 	void **vit;
-	rz_pvector_foreach (&fcn->vars, vit) {
+	rz_pvector_foreach (&tf->fcn->vars, vit) {
 		RzAnalysisVar *rvar = *vit;
 		if (rvar->kind == RZ_ANALYSIS_VAR_KIND_REG) {
 			RzAnalysisVar *lvar = rz_analysis_var_get_dst_var(rvar);
@@ -949,7 +1316,197 @@ RZ_API void rz_core_analysis_type_match(RzCore *core, RzAnalysisFunction *fcn, H
 	}
 out_function:
 	free(retctx.ret_reg);
-	ht_up_free(op_cache);
-	rz_cons_break_pop();
-	analysis_emul_restore(core, hc, dt, et, rt);
+}
+
+RZ_API void rz_core_analysis_type_match(RzCore *core, RzAnalysisFunction *fcn, HtUU *loop_table) {
+	rz_return_if_fail(core && core->analysis && fcn);
+
+	if (!core->analysis->esil) {
+		eprintf("Please run aeim\n");
+		return;
+	}
+	TypeEmul emul;
+	TypeEmulFunction tf = { .fcn = fcn };
+	rz_vector_init(&tf.steps, sizeof(TypeEmulStep), NULL, NULL);
+	ut8 *arena = rz_reg_arena_peek(core->analysis->reg);
+	if (!arena || !type_emul_init(&emul, core, NULL, arena)) {
+		goto out;
+	}
+	if (type_emul_stack_initialized(&emul)) {
+		rz_cons_break_push(NULL, NULL);
+		rz_list_sort(fcn->bbs, bb_cmpaddr);
+		type_emul_function(&emul, &tf, loop_table);
+		type_match_replay(core, &tf);
+		rz_cons_break_pop();
+	}
+	type_emul_fini(&emul);
+out:
+	type_emul_function_fini(&tf);
+	free(arena);
+}
+
+static void type_emul_batch_run(TypeEmulBatch *batch, TypeEmul *emul) {
+	while (true) {
+		rz_th_lock_enter(batch->lock);
+		size_t i = batch->next_fcn;
+		bool stop = batch->stop || i >= batch->n_fcns;
+		if (!stop) {
+			batch->next_fcn++;
+		}
+		rz_th_lock_leave(batch->lock);
+		if (stop) {
+			break;
+		}
+		HtUU *loop_table = ht_uu_new0();
+		type_emul_function(emul, &batch->fcns[i], loop_table);
+		ht_uu_free(loop_table);
+	}
+}
+
+static RzThreadFunctionRet type_emul_thread(RzThread *th) {
+	TypeEmul *emul = th->user;
+	TypeEmulBatch *batch = emul->batch;
+	type_emul_batch_run(batch, emul);
+	rz_th_lock_enter(batch->lock);
+	batch->finished++;
+	rz_th_lock_leave(batch->lock);
+	return RZ_TH_STOP;
+}
+
+static void type_emul_batch_parallel(TypeEmulBatch *batch, TypeEmul *emuls, size_t n_emuls) {
+	batch->next_fcn = 0;
+	batch->finished = 0;
+	RzThreadPool *pool = rz_th_pool_new(n_emuls);
+	if (pool) {
+		size_t started = 0;
+		for (size_t i = 0; i < n_emuls && i < pool->size; i++) {
+			RzThread *th = rz_th_new(type_emul_thread, &emuls[i], 0);
+			if (!th) {
+				RZ_LOG_ERROR("aaft: cannot start thread %u.\n", (ut32)i);
+				break;
+			}
+			rz_th_pool_add_thread(pool, th);
+			started++;
+		}
+		while (true) {
+			rz_th_lock_enter(batch->lock);
+			bool done = batch->finished == started;
+			rz_th_lock_leave(batch->lock);
+			if (done) {
+				break;
+			}
+			if (rz_cons_is_breaked()) {
+				rz_th_lock_enter(batch->lock);
+				batch->stop = true;
+				rz_th_lock_leave(batch->lock);
+			}
+			rz_sys_usleep(1000);
+		}
+		rz_th_pool_wait(pool);
+		rz_th_pool_free(pool);
+	}
+	// threads which failed to start leave their work to this one
+	type_emul_batch_run(batch, &emuls[0]);
+}
+
+/**
+ * \brief Matches the types of the variables of all the functions, as
+ * rz_core_analysis_type_match() does for each of them
+ *
+ * The functions are matched in reverse order, so in top-bottom call order,
+ * each one emulated from the registers in \p arena and with its own memory
+ * and loop counts. When the instructions can be decoded by other threads,
+ * the functions are emulated in batches by a pool of threads and their
+ * types are then matched on the calling thread in the same order, so the
+ * result is the same of the serial run.
+ *
+ * \param arena GPR arena of the registers at the start of each function
+ * \param max_threads max threads of the emulation, RZ_THREAD_POOL_ALL_CORES for all the cores
+ */
+RZ_IPI void rz_core_analysis_type_match_all(RzCore *core, RZ_NONNULL const ut8 *arena, size_t max_threads) {
+	rz_return_if_fail(core && arena);
+	if (!core->analysis->esil) {
+		eprintf("Please run aeim\n");
+		return;
+	}
+	RzPVector fcns;
+	rz_pvector_init(&fcns, NULL);
+	RzListIter *it;
+	RzAnalysisFunction *fcn;
+	rz_list_foreach_prev(core->analysis->fcns, it, fcn) {
+		rz_pvector_push(&fcns, fcn);
+	}
+	TypeEmulBatch batch = { 0 };
+	size_t n_emuls = 1;
+	if (max_threads != 1 && rz_pvector_len(&fcns) > 1 && rz_core_analysis_decoder_is_reentrant(core)) {
+		RzThreadPool *pool = rz_th_pool_new(max_threads);
+		n_emuls = pool ? pool->size : 1;
+		rz_th_pool_free(pool);
+		batch.lock = n_emuls > 1 ? rz_th_lock_new(false) : NULL;
+		if (!batch.lock) {
+			n_emuls = 1;
+		}
+	}
+	TypeEmul *emuls = RZ_NEWS0(TypeEmul, n_emuls);
+	if (!emuls) {
+		goto end;
+	}
+	for (size_t i = 0; i < n_emuls; i++) {
+		if (!type_emul_init(&emuls[i], core, batch.lock ? &batch : NULL, arena)) {
+			RZ_LOG_ERROR("aaft: cannot initialize the emulation %u.\n", (ut32)i);
+			n_emuls = i;
+			break;
+		}
+	}
+	if (!n_emuls || !type_emul_stack_initialized(&emuls[0])) {
+		goto end;
+	}
+	bool threaded = n_emuls > 1;
+	size_t batch_size = threaded ? n_emuls * TYPE_EMUL_FCNS_PER_THREAD : 1;
+	batch.fcns = RZ_NEWS0(TypeEmulFunction, batch_size);
+	if (!batch.fcns) {
+		goto end;
+	}
+	if (threaded) {
+		RZ_LOG_VERBOSE("aaft: using %u threads\n", (ut32)n_emuls);
+	}
+	bool breaked = false;
+	for (size_t from = 0; from < rz_pvector_len(&fcns) && !breaked; from += batch_size) {
+		batch.n_fcns = RZ_MIN(batch_size, rz_pvector_len(&fcns) - from);
+		for (size_t i = 0; i < batch.n_fcns; i++) {
+			TypeEmulFunction *tf = &batch.fcns[i];
+			tf->fcn = rz_pvector_at(&fcns, from + i);
+			rz_vector_init(&tf->steps, sizeof(TypeEmulStep), NULL, NULL);
+			// the blocks are only read while emulating
+			rz_list_sort(tf->fcn->bbs, bb_cmpaddr);
+		}
+		if (threaded) {
+			type_emul_batch_parallel(&batch, emuls, n_emuls);
+		} else {
+			HtUU *loop_table = ht_uu_new0();
+			type_emul_function(&emuls[0], &batch.fcns[0], loop_table);
+			ht_uu_free(loop_table);
+		}
+		for (size_t i = 0; i < batch.n_fcns; i++) {
+			TypeEmulFunction *tf = &batch.fcns[i];
+			if (!breaked && rz_core_seek(core, tf->fcn->addr, true)) {
+				type_match_replay(core, tf);
+				breaked = rz_cons_is_breaked();
+				if (!breaked) {
+					rz_analysis_fcn_vars_add_types(core->analysis, tf->fcn);
+				}
+			}
+			type_emul_function_fini(tf);
+		}
+	}
+end:
+	if (emuls) {
+		for (size_t i = 0; i < n_emuls; i++) {
+			type_emul_fini(&emuls[i]);
+		}
+		free(emuls);
+	}
+	free(batch.fcns);
+	rz_th_lock_free(batch.lock);
+	rz_pvector_fini(&fcns);
 }
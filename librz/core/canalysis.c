@@ -12,6 +12,7 @@
 #include <ht_uu.h>
 #include <rz_util/rz_graph_drawable.h>
 #include <rz_util/rz_path.h>
+#include <rz_th.h>
 
 #include "core_private.h"
 
@@ -45,7 +46,7 @@ RZ_IPI int fcn_cmpaddr(const void *_a, const void *_b) {
 static char *getFunctionName(RzCore *core, ut64 addr) {
 	RzBinFile *bf = rz_bin_cur(core->bin);
 	if (bf && bf->o) {
-		RzBinSymbol *sym = ht_up_find(bf->o->addrzklassmethod, addr, NULL);
+		RzBinSymbol *sym = rz_bin_object_get_method_at(bf->o, addr);
 		if (sym && sym->classname && sym->name) {
 			return rz_str_newf("method.%s.%s", sym->classname, sym->name);
 		}
@@ -2482,7 +2483,7 @@ RZ_API RzGraph *rz_core_analysis_importxrefs(RzCore *core) {
 	if (!graph) {
 		return NULL;
 	}
-	rz_list_foreach (obj->imports, iter, imp) {
+	rz_list_foreach (rz_bin_object_get_imports(obj), iter, imp) {
 		RzBinSymbol *sym = rz_bin_object_get_symbol_of_import(obj, imp);
 		ut64 addr = sym ? (va ? rz_bin_object_get_vaddr(obj, sym->paddr, sym->vaddr) : sym->paddr) : UT64_MAX;
 		if (addr && addr != UT64_MAX) {
@@ -3377,13 +3378,443 @@ static bool found_xref(RzCore *core, ut64 at, ut64 xref_to, RzAnalysisXRefType t
 	return true;
 }
 
+#define XREFS_BLOCK_SIZE       8096
+#define XREFS_BLOCKS_PER_SHARD 64
+
+/**
+ * A reference candidate found by the linear sweep, which is then validated
+ * and added by found_xref() on the main thread.
+ */
+typedef struct {
+	ut64 at;
+	ut64 to;
+	RzAnalysisXRefType type;
+	bool count_always; ///< counts as found even when the reference is rejected
+} XRefsCandidate;
+
+typedef struct {
+	st64 asm_sub_varmin;
+	bool jmp_cref;
+} XRefsSweepOptions;
+
+static void xrefs_candidate_push(RzVector *out, ut64 at, ut64 to, RzAnalysisXRefType type, bool count_always) {
+	XRefsCandidate c = { .at = at, .to = to, .type = type, .count_always = count_always };
+	rz_vector_push(out, &c);
+}
+
+/**
+ * Decodes all the instructions of a block with \p analysis, pushing the
+ * reference candidates into \p out in the same order as they are found.
+ * The hints are read from \p hints, which is the analysis of the core.
+ */
+static void xrefs_sweep_block(RzAnalysis *analysis, RzAnalysis *hints, const XRefsSweepOptions *opt, ut64 at, const ut8 *buf, int bsz, RzVector *out, bool check_break) {
+	RzAnalysisOp op = { 0 };
+	int i = 0, ret;
+	while (i < bsz && (!check_break || !rz_cons_is_breaked())) {
+		if (analysis == hints) {
+			ret = rz_analysis_op(analysis, &op, at + i, buf + i, bsz - i, RZ_ANALYSIS_OP_MASK_BASIC | RZ_ANALYSIS_OP_MASK_HINT);
+		} else {
+			// same as the coreb.archbits callback, without touching the configuration
+			int bits = 0;
+			rz_core_arch_bits_at(hints->coreb.core, at + i, &bits, NULL);
+			if (bits && bits != analysis->bits) {
+				rz_analysis_set_bits(analysis, bits);
+			}
+			// the hints are only stored in the analysis of the core
+			ret = rz_analysis_op(analysis, &op, at + i, buf + i, bsz - i, RZ_ANALYSIS_OP_MASK_BASIC);
+			RzAnalysisHint *hint = rz_analysis_hint_get(hints, at + i);
+			if (hint) {
+				rz_analysis_op_hint(&op, hint);
+				rz_analysis_hint_free(hint);
+			}
+		}
+		ret = ret > 0 ? ret : 1;
+		i += ret;
+		if (ret <= 0 || i > bsz) {
+			rz_analysis_op_fini(&op);
+			break;
+		}
+		// find references
+		if ((st64)op.val > opt->asm_sub_varmin && op.val != UT64_MAX && op.val != UT32_MAX) {
+			xrefs_candidate_push(out, op.addr, op.val, RZ_ANALYSIS_REF_TYPE_DATA, false);
+		}
+		// find references
+		if (op.ptr && op.ptr != UT64_MAX && op.ptr != UT32_MAX) {
+			xrefs_candidate_push(out, op.addr, op.ptr, RZ_ANALYSIS_REF_TYPE_DATA, false);
+		}
+		// find references
+		if (op.addr > 512 && op.disp > 512 && op.disp && op.disp != UT64_MAX) {
+			xrefs_candidate_push(out, op.addr, op.disp, RZ_ANALYSIS_REF_TYPE_DATA, false);
+		}
+		switch (op.type) {
+		case RZ_ANALYSIS_OP_TYPE_JMP:
+			xrefs_candidate_push(out, op.addr, op.jump, RZ_ANALYSIS_REF_TYPE_CODE, false);
+			break;
+		case RZ_ANALYSIS_OP_TYPE_CJMP:
+			if (opt->jmp_cref) {
+				xrefs_candidate_push(out, op.addr, op.jump, RZ_ANALYSIS_REF_TYPE_CODE, false);
+			}
+			break;
+		case RZ_ANALYSIS_OP_TYPE_CALL:
+		case RZ_ANALYSIS_OP_TYPE_CCALL:
+			xrefs_candidate_push(out, op.addr, op.jump, RZ_ANALYSIS_REF_TYPE_CALL, false);
+			break;
+		case RZ_ANALYSIS_OP_TYPE_UJMP:
+		case RZ_ANALYSIS_OP_TYPE_IJMP:
+		case RZ_ANALYSIS_OP_TYPE_RJMP:
+		case RZ_ANALYSIS_OP_TYPE_IRJMP:
+		case RZ_ANALYSIS_OP_TYPE_MJMP:
+		case RZ_ANALYSIS_OP_TYPE_UCJMP:
+			xrefs_candidate_push(out, op.addr, op.ptr, RZ_ANALYSIS_REF_TYPE_CODE, true);
+			break;
+		case RZ_ANALYSIS_OP_TYPE_UCALL:
+		case RZ_ANALYSIS_OP_TYPE_ICALL:
+		case RZ_ANALYSIS_OP_TYPE_RCALL:
+		case RZ_ANALYSIS_OP_TYPE_IRCALL:
+		case RZ_ANALYSIS_OP_TYPE_UCCALL:
+			xrefs_candidate_push(out, op.addr, op.ptr, RZ_ANALYSIS_REF_TYPE_CALL, false);
+			break;
+		default:
+			break;
+		}
+		rz_analysis_op_fini(&op);
+	}
+}
+
+static bool xrefs_block_is_empty(const ut8 *buf, int bsz) {
+	ut8 c = buf[0];
+	if (c != 0x00 && c != 0xff) {
+		return false;
+	}
+	for (int i = 1; i < bsz; i++) {
+		if (buf[i] != c) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static int xrefs_flush_candidates(RzCore *core, RzVector *candidates, PJ *pj, int rad, int cfg_debug, bool cfg_analysis_strings) {
+	int count = 0;
+	XRefsCandidate *c;
+	rz_vector_foreach(candidates, c) {
+		if (c->count_always) {
+			count++;
+		}
+		if (found_xref(core, c->at, c->to, c->type, pj, rad, cfg_debug, cfg_analysis_strings)) {
+			count++;
+		}
+	}
+	rz_vector_clear(candidates);
+	return count;
+}
+
+/**
+ * Returns the end of the sweep, which stops at the first block that is
+ * not mapped as executable, exactly like the block by block loop does.
+ */
+static ut64 xrefs_sweep_end(RzCore *core, ut64 from, ut64 to) {
+	ut64 at = from;
+	while (at < to && rz_io_is_valid_offset(core->io, at, RZ_PERM_X)) {
+		if (UT64_ADD_OVFCHK(at, XREFS_BLOCK_SIZE)) {
+			return to;
+		}
+		at += XREFS_BLOCK_SIZE;
+	}
+	return RZ_MIN(at, to);
+}
+
+/**
+ * \brief Whether the instructions can be decoded by other threads with the
+ * private analyses returned by rz_core_analysis_decoder_new()
+ *
+ * This is true only with plugins which keep all the decoder state (i.e. the
+ * capstone handle) in their plugin_data and when the whole binary is decoded
+ * with the same architecture.
+ */
+RZ_IPI bool rz_core_analysis_decoder_is_reentrant(RzCore *core) {
+	static const char *reentrant_plugins[] = { "x86", "arm", NULL };
+	RzAnalysis *analysis = core->analysis;
+	if (!analysis->cur || !analysis->cur->name) {
+		return false;
+	}
+	bool found = false;
+	for (size_t i = 0; reentrant_plugins[i]; i++) {
+		if (!strcmp(analysis->cur->name, reentrant_plugins[i])) {
+			found = true;
+			break;
+		}
+	}
+	if (!found || (analysis->arch_hints && !core->fixedarch)) {
+		return false;
+	}
+	RzBinObject *o = rz_bin_cur_object(core->bin);
+	if (!o || core->fixedarch) {
+		return true;
+	}
+	RzListIter *iter;
+	RzBinSection *s;
+	rz_list_foreach (o->sections, iter, s) {
+		if (s->arch && strcmp(s->arch, analysis->cur->arch)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief Creates an analysis with the same plugin and settings of the one
+ * of \p core, to decode instructions on another thread
+ *
+ * It has neither io nor core bindings, so the callers read the bytes to
+ * decode themselves.
+ */
+RZ_IPI RzAnalysis *rz_core_analysis_decoder_new(RzCore *core) {
+	RzAnalysis *src = core->analysis;
+	RzAnalysis *analysis = rz_analysis_new();
+	if (!analysis) {
+		return NULL;
+	}
+	if (!rz_analysis_use(analysis, src->cur->name)) {
+		rz_analysis_free(analysis);
+		return NULL;
+	}
+	rz_analysis_set_cpu(analysis, src->cpu);
+	rz_analysis_set_bits(analysis, src->bits);
+	rz_analysis_set_big_endian(analysis, src->big_endian);
+	analysis->pcalign = src->pcalign;
+	analysis->gp = src->gp;
+	analysis->opt = src->opt;
+	return analysis;
+}
+
+typedef struct {
+	RzCore *core;
+	RzThreadLock *lock; ///< guards the fields below
+	RzThreadLock *io_lock; ///< guards core->io, when it is not read through the snapshot of its maps
+	bool concurrent_io; ///< whether the threads read the blocks through rz_io_read_at_concurrent()
+	XRefsSweepOptions opt;
+	ut64 from;
+	ut64 to;
+	size_t n_shards;
+	size_t next_shard; ///< next shard to be decoded
+	size_t next_flush; ///< next shard to be validated by the calling thread
+	size_t window; ///< max shards decoded ahead of next_flush
+	bool stop;
+	RzVector /*<XRefsCandidate>*/ *shards;
+	bool *decoded;
+} XRefsSweep;
+
+/**
+ * Context of a decoding thread, which reads the blocks from the core
+ * through the sweep and decodes them with its own analysis.
+ */
+typedef struct {
+	XRefsSweep *sweep;
+	RzAnalysis *analysis; ///< private decoder of the thread, without io
+} XRefsWorker;
+
+static void xrefs_sweep_read(XRefsSweep *sweep, ut64 addr, ut8 *buf, int len) {
+	if (sweep->concurrent_io && rz_io_read_at_concurrent(sweep->core->io, addr, buf, len)) {
+		return;
+	}
+	// unmapped bytes or descs which cannot be read concurrently
+	rz_th_lock_enter(sweep->io_lock);
+	(void)rz_io_read_at(sweep->core->io, addr, buf, len);
+	rz_th_lock_leave(sweep->io_lock);
+}
+
+static RzThreadFunctionRet xrefs_sweep_thread(RzThread *th) {
+	XRefsWorker *worker = th->user;
+	XRefsSweep *sweep = worker->sweep;
+	ut8 *buf = malloc(XREFS_BLOCK_SIZE);
+	if (!buf) {
+		RZ_LOG_ERROR("aar: cannot allocate block buffer.\n");
+		return RZ_TH_STOP;
+	}
+	while (true) {
+		rz_th_lock_enter(sweep->lock);
+		bool stop = sweep->stop || sweep->next_shard >= sweep->n_shards;
+		bool wait = !stop && sweep->next_shard >= sweep->next_flush + sweep->window;
+		size_t shard = sweep->next_shard;
+		if (!stop && !wait) {
+			sweep->next_shard++;
+		}
+		rz_th_lock_leave(sweep->lock);
+		if (stop) {
+			break;
+		}
+		if (wait) {
+			// bounds the candidates waiting to be validated
+			rz_sys_usleep(1000);
+			continue;
+		}
+		RzVector *out = &sweep->shards[shard];
+		ut64 at = sweep->from + shard * XREFS_BLOCKS_PER_SHARD * XREFS_BLOCK_SIZE;
+		for (int b = 0; b < XREFS_BLOCKS_PER_SHARD && at < sweep->to; b++, at += XREFS_BLOCK_SIZE) {
+			xrefs_sweep_read(sweep, at, buf, XREFS_BLOCK_SIZE);
+			if (xrefs_block_is_empty(buf, XREFS_BLOCK_SIZE)) {
+				continue;
+			}
+			xrefs_sweep_block(worker->analysis, sweep->core->analysis, &sweep->opt, at, buf, XREFS_BLOCK_SIZE, out, false);
+		}
+		rz_th_lock_enter(sweep->lock);
+		sweep->decoded[shard] = true;
+		rz_th_lock_leave(sweep->lock);
+	}
+	free(buf);
+	return RZ_TH_STOP;
+}
+
+/**
+ * Validates the candidates of the decoded shards which follow the ones
+ * already validated, in address order, and frees them.
+ */
+static int xrefs_sweep_drain(XRefsSweep *sweep, PJ *pj, int rad, int cfg_debug, bool cfg_analysis_strings) {
+	int count = 0;
+	rz_th_lock_enter(sweep->lock);
+	size_t end = sweep->next_flush;
+	while (end < sweep->n_shards && sweep->decoded[end]) {
+		end++;
+	}
+	rz_th_lock_leave(sweep->lock);
+	if (end == sweep->next_flush) {
+		return 0;
+	}
+	// the decoded shards are not touched by the threads anymore, but
+	// found_xref() reads from core->io
+	rz_th_lock_enter(sweep->io_lock);
+	for (size_t i = sweep->next_flush; i < end; i++) {
+		RzVector *shard = &sweep->shards[i];
+		if (!rz_cons_is_breaked()) {
+			count += xrefs_flush_candidates(sweep->core, shard, pj, rad, cfg_debug, cfg_analysis_strings);
+		}
+		rz_vector_fini(shard);
+	}
+	rz_th_lock_leave(sweep->io_lock);
+	rz_th_lock_enter(sweep->lock);
+	sweep->next_flush = end;
+	rz_th_lock_leave(sweep->lock);
+	return count;
+}
+
+/**
+ * Splits [from, to) in shards of XREFS_BLOCKS_PER_SHARD blocks which are
+ * decoded by a pool of threads; the candidates are validated and added on
+ * the calling thread as soon as the shards are decoded, in address order, so
+ * the result is the same of the serial sweep.
+ *
+ * \return the number of references found or -1 when the parallel sweep
+ *         cannot be started and the serial one must be used
+ */
+static int xrefs_sweep_parallel(RzCore *core, ut64 from, ut64 to, size_t max_threads, const XRefsSweepOptions *opt, PJ *pj, int rad, int cfg_debug, bool cfg_analysis_strings) {
+	XRefsSweep sweep = { 0 };
+	RzThreadPool *pool = NULL;
+	XRefsWorker *workers = NULL;
+	int count = -1;
+
+	ut64 shard_size = (ut64)XREFS_BLOCKS_PER_SHARD * XREFS_BLOCK_SIZE;
+	sweep.core = core;
+	sweep.opt = *opt;
+	sweep.from = from;
+	sweep.to = to;
+	sweep.n_shards = (to - from + shard_size - 1) / shard_size;
+	if (sweep.n_shards < 2) {
+		return -1;
+	}
+	sweep.shards = RZ_NEWS0(RzVector, sweep.n_shards);
+	sweep.decoded = RZ_NEWS0(bool, sweep.n_shards);
+	sweep.lock = rz_th_lock_new(false);
+	sweep.io_lock = rz_th_lock_new(false);
+	pool = rz_th_pool_new(max_threads);
+	if (!sweep.shards || !sweep.decoded || !sweep.lock || !sweep.io_lock || !pool) {
+		RZ_LOG_ERROR("aar: cannot allocate the thread pool.\n");
+		goto end;
+	}
+	for (size_t i = 0; i < sweep.n_shards; i++) {
+		rz_vector_init(&sweep.shards[i], sizeof(XRefsCandidate), NULL, NULL);
+	}
+	sweep.window = 2 * pool->size;
+	workers = RZ_NEWS0(XRefsWorker, pool->size);
+	if (!workers) {
+		goto end;
+	}
+	for (size_t i = 0; i < pool->size; i++) {
+		workers[i].sweep = &sweep;
+		workers[i].analysis = rz_core_analysis_decoder_new(core);
+		if (!workers[i].analysis) {
+			RZ_LOG_ERROR("aar: cannot initialize the analysis of thread %u.\n", (ut32)i);
+			goto end;
+		}
+	}
+	RzIO *io = core->io;
+	// the snapshot of the maps sees neither the io caches nor the physical mode
+	if (io->va && !io->cached && !io->p_cache && !io->cachemode) {
+		sweep.concurrent_io = rz_io_concurrent_begin(io);
+		if (!sweep.concurrent_io) {
+			rz_io_concurrent_end(io);
+		}
+	}
+	RZ_LOG_VERBOSE("aar: using %u threads for %u shards\n", (ut32)pool->size, (ut32)sweep.n_shards);
+	count = 0;
+	for (size_t i = 0; i < pool->size; i++) {
+		RzThread *th = rz_th_new(xrefs_sweep_thread, &workers[i], 0);
+		if (!th) {
+			RZ_LOG_ERROR("aar: cannot start thread %u.\n", (ut32)i);
+			rz_th_lock_enter(sweep.lock);
+			sweep.stop = true;
+			rz_th_lock_leave(sweep.lock);
+			rz_th_pool_wait(pool);
+			count = -1;
+			goto end;
+		}
+		rz_th_pool_add_thread(pool, th);
+	}
+	while (!rz_th_pool_wait_async(pool)) {
+		if (rz_cons_is_breaked()) {
+			rz_th_lock_enter(sweep.lock);
+			sweep.stop = true;
+			rz_th_lock_leave(sweep.lock);
+			break;
+		}
+		count += xrefs_sweep_drain(&sweep, pj, rad, cfg_debug, cfg_analysis_strings);
+		rz_sys_usleep(1000);
+	}
+	// rz_th_pool_wait_async() may be true before the threads started or
+	// while they are still returning, so they must be joined
+	rz_th_pool_wait(pool);
+	count += xrefs_sweep_drain(&sweep, pj, rad, cfg_debug, cfg_analysis_strings);
+
+end:
+	if (sweep.concurrent_io) {
+		rz_io_concurrent_end(core->io);
+	}
+	if (workers) {
+		for (size_t i = 0; pool && i < pool->size; i++) {
+			rz_analysis_free(workers[i].analysis);
+		}
+		free(workers);
+	}
+	rz_th_pool_free(pool);
+	rz_th_lock_free(sweep.io_lock);
+	rz_th_lock_free(sweep.lock);
+	if (sweep.shards) {
+		for (size_t i = sweep.next_flush; i < sweep.n_shards; i++) {
+			rz_vector_fini(&sweep.shards[i]);
+		}
+		free(sweep.shards);
+	}
+	free(sweep.decoded);
+	return count;
+}
+
 RZ_API int rz_core_analysis_search_xrefs(RzCore *core, ut64 from, ut64 to, PJ *pj, int rad) {
 	bool cfg_debug = rz_config_get_b(core->config, "cfg.debug");
 	bool cfg_analysis_strings = rz_config_get_i(core->config, "analysis.strings");
+	size_t max_threads = rz_config_get_i(core->config, "analysis.xrefs.threads");
 	ut64 at;
 	int count = 0;
-	const int bsz = 8096;
-	RzAnalysisOp op = { 0 };
+	const int bsz = XREFS_BLOCK_SIZE;
 
 	if (from == to) {
 		return -1;
@@ -3399,112 +3830,44 @@ RZ_API int rz_core_analysis_search_xrefs(RzCore *core, ut64 from, ut64 to, PJ *p
 		eprintf("Error: block size too small\n");
 		return -1;
 	}
+	XRefsSweepOptions opt = {
+		.asm_sub_varmin = rz_config_get_i(core->config, "asm.sub.varmin"),
+		.jmp_cref = rz_config_get_b(core->config, "analysis.jmp.cref"),
+	};
+	rz_cons_break_push(NULL, NULL);
+	if (max_threads != 1 && !cfg_debug && rz_core_analysis_decoder_is_reentrant(core)) {
+		count = xrefs_sweep_parallel(core, from, xrefs_sweep_end(core, from, to), max_threads, &opt, pj, rad, cfg_debug, cfg_analysis_strings);
+		if (count >= 0) {
+			rz_cons_break_pop();
+			return count;
+		}
+		count = 0;
+	}
 	ut8 *buf = malloc(bsz);
 	if (!buf) {
 		eprintf("Error: cannot allocate a block\n");
+		rz_cons_break_pop();
 		return -1;
 	}
-	ut8 *block = malloc(bsz);
-	if (!block) {
-		eprintf("Error: cannot allocate a temp block\n");
-		free(buf);
-		return -1;
-	}
-	rz_cons_break_push(NULL, NULL);
+	RzVector candidates;
+	rz_vector_init(&candidates, sizeof(XRefsCandidate), NULL, NULL);
 	at = from;
-	st64 asm_sub_varmin = rz_config_get_i(core->config, "asm.sub.varmin");
 	while (at < to && !rz_cons_is_breaked()) {
-		int i = 0, ret = bsz;
 		if (!rz_io_is_valid_offset(core->io, at, RZ_PERM_X)) {
 			break;
 		}
 		(void)rz_io_read_at(core->io, at, buf, bsz);
-		memset(block, -1, bsz);
-		if (!memcmp(buf, block, bsz)) {
-			//	eprintf ("Error: skipping uninitialized block \n");
-			at += ret;
+		if (xrefs_block_is_empty(buf, bsz)) {
+			at += bsz;
 			continue;
 		}
-		memset(block, 0, bsz);
-		if (!memcmp(buf, block, bsz)) {
-			//	eprintf ("Error: skipping uninitialized block \n");
-			at += ret;
-			continue;
-		}
-		while (i < bsz && !rz_cons_is_breaked()) {
-			ret = rz_analysis_op(core->analysis, &op, at + i, buf + i, bsz - i, RZ_ANALYSIS_OP_MASK_BASIC | RZ_ANALYSIS_OP_MASK_HINT);
-			ret = ret > 0 ? ret : 1;
-			i += ret;
-			if (ret <= 0 || i > bsz) {
-				break;
-			}
-			// find references
-			if ((st64)op.val > asm_sub_varmin && op.val != UT64_MAX && op.val != UT32_MAX) {
-				if (found_xref(core, op.addr, op.val, RZ_ANALYSIS_REF_TYPE_DATA, pj, rad, cfg_debug, cfg_analysis_strings)) {
-					count++;
-				}
-			}
-			// find references
-			if (op.ptr && op.ptr != UT64_MAX && op.ptr != UT32_MAX) {
-				if (found_xref(core, op.addr, op.ptr, RZ_ANALYSIS_REF_TYPE_DATA, pj, rad, cfg_debug, cfg_analysis_strings)) {
-					count++;
-				}
-			}
-			// find references
-			if (op.addr > 512 && op.disp > 512 && op.disp && op.disp != UT64_MAX) {
-				if (found_xref(core, op.addr, op.disp, RZ_ANALYSIS_REF_TYPE_DATA, pj, rad, cfg_debug, cfg_analysis_strings)) {
-					count++;
-				}
-			}
-			switch (op.type) {
-			case RZ_ANALYSIS_OP_TYPE_JMP:
-				if (found_xref(core, op.addr, op.jump, RZ_ANALYSIS_REF_TYPE_CODE, pj, rad, cfg_debug, cfg_analysis_strings)) {
-					count++;
-				}
-				break;
-			case RZ_ANALYSIS_OP_TYPE_CJMP:
-				if (rz_config_get_b(core->config, "analysis.jmp.cref") &&
-					found_xref(core, op.addr, op.jump, RZ_ANALYSIS_REF_TYPE_CODE, pj, rad, cfg_debug, cfg_analysis_strings)) {
-					count++;
-				}
-				break;
-			case RZ_ANALYSIS_OP_TYPE_CALL:
-			case RZ_ANALYSIS_OP_TYPE_CCALL:
-				if (found_xref(core, op.addr, op.jump, RZ_ANALYSIS_REF_TYPE_CALL, pj, rad, cfg_debug, cfg_analysis_strings)) {
-					count++;
-				}
-				break;
-			case RZ_ANALYSIS_OP_TYPE_UJMP:
-			case RZ_ANALYSIS_OP_TYPE_IJMP:
-			case RZ_ANALYSIS_OP_TYPE_RJMP:
-			case RZ_ANALYSIS_OP_TYPE_IRJMP:
-			case RZ_ANALYSIS_OP_TYPE_MJMP:
-			case RZ_ANALYSIS_OP_TYPE_UCJMP:
-				count++;
-				if (found_xref(core, op.addr, op.ptr, RZ_ANALYSIS_REF_TYPE_CODE, pj, rad, cfg_debug, cfg_analysis_strings)) {
-					count++;
-				}
-				break;
-			case RZ_ANALYSIS_OP_TYPE_UCALL:
-			case RZ_ANALYSIS_OP_TYPE_ICALL:
-			case RZ_ANALYSIS_OP_TYPE_RCALL:
-			case RZ_ANALYSIS_OP_TYPE_IRCALL:
-			case RZ_ANALYSIS_OP_TYPE_UCCALL:
-				if (found_xref(core, op.addr, op.ptr, RZ_ANALYSIS_REF_TYPE_CALL, pj, rad, cfg_debug, cfg_analysis_strings)) {
-					count++;
-				}
-				break;
-			default:
-				break;
-			}
-			rz_analysis_op_fini(&op);
-		}
+		xrefs_sweep_block(core->analysis, core->analysis, &opt, at, buf, bsz, &candidates, true);
+		count += xrefs_flush_candidates(core, &candidates, pj, rad, cfg_debug, cfg_analysis_strings);
 		at += bsz;
-		rz_analysis_op_fini(&op);
 	}
+	rz_vector_fini(&candidates);
 	rz_cons_break_pop();
 	free(buf);
-	free(block);
 	return count;
 }
 
@@ -3561,7 +3924,7 @@ RZ_API int rz_core_analysis_all(RzCore *core) {
 	RzBinFile *bf = core->bin->cur;
 	RzBinObject *o = bf ? bf->o : NULL;
 	/* Symbols (Imports are already analyzed by rz_bin on init) */
-	if (o && (list = o->symbols) != NULL) {
+	if (o && (list = (RzList *)rz_bin_object_get_symbols(o)) != NULL) {
 		rz_list_foreach (list, iter, symbol) {
 			if (rz_cons_is_breaked()) {
 				break;
@@ -6043,8 +6406,8 @@ RZ_API bool rz_core_analysis_sigdb_apply(RzCore *core, int *n_applied, const cha
 			if (strcmp(bin, sig->bin_name) || strcmp(arch, sig->arch_name) || bits != sig->arch_bits) {
 				continue;
 			} else if (strstr(sig->base_name, "c++") &&
-				obj->lang != RZ_BIN_LANGUAGE_CXX &&
-				obj->lang != RZ_BIN_LANGUAGE_RUST) {
+				rz_bin_object_get_language(obj) != RZ_BIN_LANGUAGE_CXX &&
+				rz_bin_object_get_language(obj) != RZ_BIN_LANGUAGE_RUST) {
 				// C++ libs can create many false positives, especially on C binaries.
 				// So their usage is limited to C++ and RUST lang
 				continue;
@@ -6262,8 +6625,6 @@ RZ_API bool rz_analysis_add_device_peripheral_map(RzBinObject *o, RzAnalysis *an
 }
 
 RZ_IPI bool rz_core_analysis_types_propagation(RzCore *core) {
-	RzListIter *it;
-	RzAnalysisFunction *fcn;
 	ut64 seek;
 	if (rz_config_get_b(core->config, "cfg.debug")) {
 		eprintf("TOFIX: aaft can't run in debugger mode.\n");
@@ -6283,25 +6644,9 @@ RZ_IPI bool rz_core_analysis_types_propagation(RzCore *core) {
 	rz_core_analysis_esil_init(core);
 	rz_core_analysis_esil_init_mem(core, NULL, UT64_MAX, UT32_MAX);
 	ut8 *saved_arena = rz_reg_arena_peek(core->analysis->reg);
-
-	// loop count of rz_core_analysis_type_match
-	// TODO : figure out the reason to hold a `LOOP COUNT` in type_match
-	// HtUU <addr->loop_count>
-	HtUU *loop_table = ht_uu_new0();
-
-	// Iterating Reverse so that we get function in top-bottom call order
-	rz_list_foreach_prev(core->analysis->fcns, it, fcn) {
-		int ret = rz_core_seek(core, fcn->addr, true);
-		if (!ret) {
-			continue;
-		}
-		rz_reg_arena_poke(core->analysis->reg, saved_arena);
-		rz_analysis_esil_set_pc(core->analysis->esil, fcn->addr);
-		rz_core_analysis_type_match(core, fcn, loop_table);
-		if (rz_cons_is_breaked()) {
-			break;
-		}
-		rz_analysis_fcn_vars_add_types(core->analysis, fcn);
+	if (saved_arena) {
+		size_t max_threads = rz_config_get_i(core->config, "analysis.types.threads");
+		rz_core_analysis_type_match_all(core, saved_arena, max_threads);
 	}
 	if (delete_regs) {
 		rz_core_debug_clear_register_flags(core);
@@ -6311,7 +6656,6 @@ RZ_IPI bool rz_core_analysis_types_propagation(RzCore *core) {
 	rz_config_hold_restore(hold);
 	rz_config_hold_free(hold);
 	free(saved_arena);
-	ht_uu_free(loop_table);
 	return true;
 }
 
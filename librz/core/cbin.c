@@ -343,6 +343,37 @@ RZ_API bool rz_core_bin_apply_info(RzCore *r, RzBinFile *binfile, ut32 mask) {
 	return true;
 }
 
+// items left to rz_core_bin_apply_pending() with bin.lazyflags, which need all the symbols, imports and relocs parsed
+#define BIN_LAZY_ACC (RZ_CORE_BIN_ACC_RELOCS | RZ_CORE_BIN_ACC_IMPORTS | RZ_CORE_BIN_ACC_SYMBOLS | RZ_CORE_BIN_ACC_CLASSES)
+
+/**
+ * \brief Applies the items of a file left by rz_core_bin_apply_all_info() when bin.lazyflags is set
+ *
+ * The commands not only reading the bin information call it before running.
+ */
+RZ_API bool rz_core_bin_apply_pending(RzCore *core) {
+	rz_return_val_if_fail(core, false);
+	ut32 mask = core->bin_pending;
+	if (!mask) {
+		return true;
+	}
+	core->bin_pending = 0;
+	RzBinFile *binfile = rz_bin_file_find_by_id(core->bin, core->bin_pending_id);
+	if (!binfile) {
+		// closed before anything needed them
+		return false;
+	}
+	RzBinFile *cur = rz_bin_cur(core->bin);
+	if (cur != binfile) {
+		rz_bin_file_set_cur_binfile(core->bin, binfile);
+	}
+	bool ret = rz_core_bin_apply_info(core, binfile, mask);
+	if (cur && cur != binfile) {
+		rz_bin_file_set_cur_binfile(core->bin, cur);
+	}
+	return ret;
+}
+
 RZ_API bool rz_core_bin_apply_all_info(RzCore *r, RzBinFile *binfile) {
 	rz_return_val_if_fail(r && binfile, false);
 	RzBinObject *binobj = binfile->o;
@@ -350,6 +381,10 @@ RZ_API bool rz_core_bin_apply_all_info(RzCore *r, RzBinFile *binfile) {
 	if (!info) {
 		return false;
 	}
+	if (r->bin_pending && r->bin_pending_id != binfile->id) {
+		rz_core_bin_apply_pending(r);
+	}
+	r->bin_pending = 0;
 	const char *arch = info->arch;
 	ut16 bits = info->bits;
 	ut64 baseaddr = rz_bin_get_baddr(r->bin);
@@ -366,7 +401,13 @@ RZ_API bool rz_core_bin_apply_all_info(RzCore *r, RzBinFile *binfile) {
 	}
 	rz_asm_use(r->rasm, arch);
 
-	rz_core_bin_apply_info(r, binfile, RZ_CORE_BIN_ACC_ALL);
+	ut32 mask = RZ_CORE_BIN_ACC_ALL;
+	if (rz_config_get_b(r->config, "bin.lazyflags")) {
+		r->bin_pending = mask & BIN_LAZY_ACC;
+		r->bin_pending_id = binfile->id;
+		mask &= ~BIN_LAZY_ACC;
+	}
+	rz_core_bin_apply_info(r, binfile, mask);
 
 	rz_core_bin_set_cur(r, binfile);
 	return true;
@@ -628,6 +669,9 @@ RZ_API bool rz_core_bin_apply_config(RzCore *r, RzBinFile *binfile) {
 		info->big_endian ? "true" : "false");
 	if (info->lang) {
 		rz_config_set(r->config, "bin.lang", info->lang);
+	} else {
+		// detecting the language loads all the symbols, so it is done on the first read of bin.lang
+		r->bin_lang_pending = true;
 	}
 	rz_config_set(r->config, "asm.os", info->os);
 	if (info->rclass && !strcmp(info->rclass, "pe")) {
@@ -1235,7 +1279,7 @@ RZ_API bool rz_core_bin_apply_relocs(RzCore *core, RzBinFile *binfile, bool va_b
 	int va = VA_TRUE; // XXX relocs always vaddr?
 	RzBinRelocStorage *relocs = rz_bin_object_patch_relocs(binfile, o);
 	if (!relocs) {
-		relocs = o->relocs;
+		relocs = rz_bin_object_get_relocs(o);
 		if (!relocs) {
 			return false;
 		}
@@ -1284,7 +1328,7 @@ RZ_API bool rz_core_bin_apply_imports(RzCore *core, RzBinFile *binfile, bool va)
 	}
 	RzListIter *iter;
 	RzBinImport *import;
-	RzList *imports = o->imports;
+	const RzList *imports = rz_bin_object_get_imports(o);
 	rz_list_foreach (imports, iter, import) {
 		if (!import->libname || !strstr(import->libname, ".dll")) {
 			continue;
@@ -1339,21 +1383,44 @@ typedef struct {
 	char *classflag; // flag for classname
 	char *methname; // methods [class]::[method]
 	char *methflag; // methods flag sym.[class].[method]
+	char *method; // C++ demangled symbol of a method not added yet to the RzBinFile
+	char *flagname; // filtered name of the flag to set, with the bin prefix
 } SymName;
 
-static void sym_name_init(RzCore *r, SymName *sn, RzBinSymbol *sym, const char *lang) {
-	if (!r || !sym || !sym->name) {
+typedef struct {
+	RzBinFile *bf;
+	const char *lang;
+	const char *prefix; // prefix of the flag names, if any
+	bool demangle;
+	bool keep_lib;
+} SymNameOptions;
+
+static void sym_name_options_init(RzCore *r, SymNameOptions *opt, const char *lang) {
+	opt->bf = r->bin->cur;
+	opt->lang = lang;
+	opt->prefix = r->bin->prefix;
+	opt->demangle = rz_config_get_b(r->config, "bin.demangle");
+	opt->keep_lib = rz_config_get_b(r->config, "bin.demangle.libs");
+}
+
+/*
+ * Only reads the RzBinFile and the symbol when defer_methods is true, so it can
+ * run concurrently on the symbols of the same file: the methods found while
+ * demangling are stored into sn->method and must be added by the caller.
+ */
+static void sym_name_init_opt(const SymNameOptions *opt, SymName *sn, RzBinSymbol *sym, bool defer_methods) {
+	if (!sym || !sym->name) {
 		return;
 	}
 
-	bool demangle = rz_config_get_b(r->config, "bin.demangle");
-	bool keep_lib = rz_config_get_b(r->config, "bin.demangle.libs");
-
-	const char *name = sym->dname && demangle ? sym->dname : sym->name;
+	const char *name = sym->dname && opt->demangle ? sym->dname : sym->name;
 	sn->name = rz_str_newf("%s%s", sym->is_imported ? "imp." : "", name);
 	sn->libname = sym->libname ? strdup(sym->libname) : NULL;
 	const char *pfx = get_prefix_for_sym(sym);
-	sn->nameflag = construct_symbol_flagname(pfx, sym->libname, rz_bin_symbol_name(sym), MAXFLAG_LEN_DEFAULT);
+	// not rz_bin_symbol_name(), which formats duplicates into a shared buffer
+	char *symname = sym->dup_count ? rz_str_newf("%s_%d", sym->name, sym->dup_count) : NULL;
+	sn->nameflag = construct_symbol_flagname(pfx, sym->libname, symname ? symname : sym->name, MAXFLAG_LEN_DEFAULT);
+	free(symname);
 	if (sym->classname && sym->classname[0]) {
 		sn->classname = strdup(sym->classname);
 		sn->classflag = rz_str_newf("sym.%s.%s", sn->classname, sn->name);
@@ -1369,14 +1436,27 @@ static void sym_name_init(RzCore *r, SymName *sn, RzBinSymbol *sym, const char *
 	}
 	sn->demname = NULL;
 	sn->demflag = NULL;
-	if (demangle && sym->paddr && lang) {
-		sn->demname = rz_bin_demangle(r->bin->cur, lang, sn->name, sym->vaddr, keep_lib);
+	sn->method = NULL;
+	sn->flagname = NULL;
+	if (opt->demangle && sym->paddr && opt->lang) {
+		sn->demname = defer_methods
+			? rz_bin_demangle_no_method(opt->bf, opt->lang, sn->name, opt->keep_lib, &sn->method)
+			: rz_bin_demangle(opt->bf, opt->lang, sn->name, sym->vaddr, opt->keep_lib);
 		if (sn->demname) {
 			sn->demflag = construct_symbol_flagname(pfx, sym->libname, sn->demname, -1);
 		}
 	}
 }
 
+static void sym_name_init(RzCore *r, SymName *sn, RzBinSymbol *sym, const char *lang) {
+	if (!r || !sym || !sym->name) {
+		return;
+	}
+	SymNameOptions opt;
+	sym_name_options_init(r, &opt, lang);
+	sym_name_init_opt(&opt, sn, sym, false);
+}
+
 static void sym_name_fini(SymName *sn) {
 	RZ_FREE(sn->name);
 	RZ_FREE(sn->libname);
@@ -1387,6 +1467,8 @@ static void sym_name_fini(SymName *sn) {
 	RZ_FREE(sn->classflag);
 	RZ_FREE(sn->methname);
 	RZ_FREE(sn->methflag);
+	RZ_FREE(sn->method);
+	RZ_FREE(sn->flagname);
 }
 
 static void handle_arm_special_symbol(RzCore *core, RzBinObject *o, RzBinSymbol *symbol, int va) {
@@ -1449,6 +1531,102 @@ static void select_flag_space(RzCore *core, RzBinSymbol *symbol) {
 	}
 }
 
+static bool is_flagged_symbol(RzBinSymbol *s) {
+	return !is_section_symbol(s) && !is_file_symbol(s) && !is_special_symbol(s);
+}
+
+#define SYM_NAMES_CHUNK 256
+
+typedef struct {
+	const SymNameOptions *opt;
+	RzBinSymbol **symbols;
+	SymName *names;
+	size_t count;
+	size_t next; ///< first symbol not taken by any thread
+	RzThreadLock *lock;
+} SymNamesJob;
+
+static void sym_names_work(SymNamesJob *job) {
+	while (true) {
+		if (job->lock) {
+			rz_th_lock_enter(job->lock);
+		}
+		size_t from = job->next;
+		size_t to = RZ_MIN(from + SYM_NAMES_CHUNK, job->count);
+		job->next = to;
+		if (job->lock) {
+			rz_th_lock_leave(job->lock);
+		}
+		if (from >= to) {
+			break;
+		}
+		for (size_t i = from; i < to; i++) {
+			RzBinSymbol *symbol = job->symbols[i];
+			SymName *sn = &job->names[i];
+			sym_name_init_opt(job->opt, sn, symbol, true);
+			if (sn->classname || !is_flagged_symbol(symbol)) {
+				continue;
+			}
+			const char *fn = sn->demflag ? sn->demflag : sn->nameflag;
+			char *fnp = job->opt->prefix ? rz_str_newf("%s.%s", job->opt->prefix, fn) : strdup(fn ? fn : "");
+			sn->flagname = fnp ? rz_flag_name_filter(fnp) : NULL;
+			free(fnp);
+		}
+	}
+}
+
+static RzThreadFunctionRet sym_names_thread(RzThread *th) {
+	sym_names_work(th->user);
+	return RZ_TH_STOP;
+}
+
+/**
+ * Computes the names and the flag names of \p count symbols, which is
+ * mostly demangling, with a pool of threads taking chunks of symbols.
+ * Anything that cannot be done by the pool is done on the calling thread.
+ */
+static void sym_names_compute(SymNamesJob *job, size_t max_threads) {
+	RzThreadPool *pool = NULL;
+	if (max_threads == 1 || job->count < 2 * SYM_NAMES_CHUNK) {
+		goto serial;
+	}
+	job->lock = rz_th_lock_new(false);
+	pool = job->lock ? rz_th_pool_new(max_threads) : NULL;
+	if (!pool) {
+		goto serial;
+	}
+	RZ_LOG_VERBOSE("Demangling %u symbols with %u threads\n", (ut32)job->count, (ut32)pool->size);
+	for (size_t i = 0; i < pool->size; i++) {
+		RzThread *th = rz_th_new(sym_names_thread, job, 0);
+		if (!th) {
+			break;
+		}
+		rz_th_pool_add_thread(pool, th);
+	}
+	rz_th_pool_wait(pool);
+serial:
+	sym_names_work(job);
+	rz_th_pool_free(pool);
+	rz_th_lock_free(job->lock);
+	job->lock = NULL;
+}
+
+static void flush_symbol_flags(RzCore *core, RzVector /*<RzFlagBulkItem>*/ *pending, RzPVector /*<const char *>*/ *pending_fn) {
+	if (rz_vector_empty(pending)) {
+		return;
+	}
+	rz_flag_set_bulk(core->flags, rz_vector_index_ptr(pending, 0), rz_vector_len(pending));
+	for (size_t i = 0; i < rz_vector_len(pending); i++) {
+		RzFlagBulkItem *bi = rz_vector_index_ptr(pending, i);
+		const char *fn = rz_pvector_at(pending_fn, i);
+		if (!bi->item && fn) {
+			eprintf("[Warning] Can't find flag (%s)\n", fn);
+		}
+	}
+	rz_vector_clear(pending);
+	rz_pvector_clear(pending_fn);
+}
+
 RZ_API bool rz_core_bin_apply_symbols(RzCore *core, RzBinFile *binfile, bool va) {
 	rz_return_val_if_fail(core && binfile, false);
 	RzBinObject *o = binfile->o;
@@ -1460,26 +1638,44 @@ RZ_API bool rz_core_bin_apply_symbols(RzCore *core, RzBinFile *binfile, bool va)
 	bool is_arm = info && info->arch && !strncmp(info->arch, "arm", 3);
 	bool bin_demangle = rz_config_get_b(core->config, "bin.demangle");
 	const char *lang = bin_demangle ? rz_config_get(core->config, "bin.lang") : NULL;
-
-	rz_spaces_push(&core->analysis->meta_spaces, "bin");
-	rz_flag_space_push(core->flags, RZ_FLAGS_FS_SYMBOLS);
+	size_t max_threads = rz_config_get_i(core->config, "bin.demangle.threads");
 
 	RzList *symbols = rz_bin_get_symbols(core->bin);
-	size_t count = 0;
+	SymNameOptions opt;
+	sym_name_options_init(core, &opt, lang);
+	SymNamesJob job = { .opt = &opt };
+	RzVector pending;
+	RzPVector pending_fn;
+	rz_vector_init(&pending, sizeof(RzFlagBulkItem), NULL, NULL);
+	rz_pvector_init(&pending_fn, NULL);
+
+	job.symbols = RZ_NEWS0(RzBinSymbol *, rz_list_length(symbols));
+	job.names = RZ_NEWS0(SymName, rz_list_length(symbols));
+	if ((!job.symbols || !job.names) && !rz_list_empty(symbols)) {
+		free(job.symbols);
+		free(job.names);
+		return false;
+	}
 	RzListIter *iter;
 	RzBinSymbol *symbol;
 	rz_list_foreach (symbols, iter, symbol) {
-		if (!symbol->name) {
-			continue;
+		if (symbol->name) {
+			job.symbols[job.count++] = symbol;
 		}
+	}
+	// demangling is the slowest part and doesn't depend on the previous symbols
+	sym_names_compute(&job, max_threads);
+
+	rz_spaces_push(&core->analysis->meta_spaces, "bin");
+	rz_flag_space_push(core->flags, RZ_FLAGS_FS_SYMBOLS);
+
+	for (size_t i = 0; i < job.count; i++) {
+		symbol = job.symbols[i];
+		SymName *sn = &job.names[i];
 		ut64 addr = rva(o, symbol->paddr, symbol->vaddr, va);
-		SymName sn = { 0 };
-		count++;
-		sym_name_init(core, &sn, symbol, lang);
-		RzStrEscOptions opt = { 0 };
-		opt.show_asciidot = false;
-		opt.esc_bslash = true;
-		char *rz_symbol_name = rz_str_escape_utf8(sn.name, &opt);
+		if (sn->method) {
+			rz_bin_demangle_add_method(binfile, sn->method, symbol->vaddr);
+		}
 
 		if (is_section_symbol(symbol) || is_file_symbol(symbol)) {
 			/*
@@ -1497,21 +1693,23 @@ RZ_API bool rz_core_bin_apply_symbols(RzCore *core, RzBinFile *binfile, bool va)
 			}
 			select_flag_space(core, symbol);
 			/* If that's a Classed symbol (method or so) */
-			if (sn.classname) {
-				RzFlagItem *fi = rz_flag_get(core->flags, sn.methflag);
+			if (sn->classname) {
+				// the flags set so far must be visible to the lookup
+				flush_symbol_flags(core, &pending, &pending_fn);
+				RzFlagItem *fi = rz_flag_get(core->flags, sn->methflag);
 				if (core->bin->prefix) {
-					char *prname = rz_str_newf("%s.%s", core->bin->prefix, sn.methflag);
-					rz_name_filter(sn.methflag, -1, true);
-					free(sn.methflag);
-					sn.methflag = prname;
+					char *prname = rz_str_newf("%s.%s", core->bin->prefix, sn->methflag);
+					rz_name_filter(sn->methflag, -1, true);
+					free(sn->methflag);
+					sn->methflag = prname;
 				}
 				if (fi) {
-					rz_flag_item_set_realname(fi, sn.methname);
+					rz_flag_item_set_realname(fi, sn->methname);
 					if ((fi->offset - core->flags->base) == addr) {
 						rz_flag_unset(core->flags, fi);
 					}
 				} else {
-					fi = rz_flag_set(core->flags, sn.methflag, addr, symbol->size);
+					fi = rz_flag_set(core->flags, sn->methflag, addr, symbol->size);
 					char *comment = (fi && fi->comment) ? strdup(fi->comment) : NULL;
 					if (comment) {
 						rz_flag_item_set_comment(fi, comment);
@@ -1519,29 +1717,34 @@ RZ_API bool rz_core_bin_apply_symbols(RzCore *core, RzBinFile *binfile, bool va)
 					}
 				}
 			} else {
-				const char *n = sn.demname ? sn.demname : symbol->name;
-				const char *fn = sn.demflag ? sn.demflag : sn.nameflag;
-				char *fnp = (core->bin->prefix) ? rz_str_newf("%s.%s", core->bin->prefix, fn) : strdup(fn ? fn : "");
-				RzFlagItem *fi = rz_flag_set(core->flags, fnp, addr, symbol->size);
-				if (fi) {
-					rz_flag_item_set_realname(fi, n);
-					fi->demangled = (bool)(size_t)sn.demname;
-				} else {
-					if (fn) {
-						eprintf("[Warning] Can't find flag (%s)\n", fn);
-					}
+				RzFlagBulkItem *bi = rz_vector_push(&pending, NULL);
+				if (bi) {
+					bi->name = sn->flagname;
+					sn->flagname = NULL;
+					bi->realname = sn->demname ? sn->demname : symbol->name;
+					bi->offset = addr;
+					bi->size = symbol->size;
+					bi->space = rz_flag_space_cur(core->flags);
+					bi->demangled = (bool)(size_t)sn->demname;
+					bi->item = NULL;
+					rz_pvector_push(&pending_fn, sn->demflag ? sn->demflag : sn->nameflag);
 				}
-				free(fnp);
 			}
-			if (sn.demname) {
+			if (sn->demname) {
 				ut64 size = symbol->size ? symbol->size : 1;
-				rz_meta_set(core->analysis, RZ_META_TYPE_COMMENT, addr, size, sn.demname);
+				rz_meta_set(core->analysis, RZ_META_TYPE_COMMENT, addr, size, sn->demname);
 			}
 			rz_flag_space_pop(core->flags);
 		}
-		sym_name_fini(&sn);
-		free(rz_symbol_name);
 	}
+	flush_symbol_flags(core, &pending, &pending_fn);
+	rz_vector_fini(&pending);
+	rz_pvector_fini(&pending_fn);
+	for (size_t i = 0; i < job.count; i++) {
+		sym_name_fini(&job.names[i]);
+	}
+	free(job.names);
+	free(job.symbols);
 
 	// handle thumb and arm for entry point since they are not present in symbols
 	if (is_arm) {
@@ -1559,11 +1762,11 @@ RZ_API bool rz_core_bin_apply_symbols(RzCore *core, RzBinFile *binfile, bool va)
 RZ_API bool rz_core_bin_apply_classes(RzCore *core, RzBinFile *binfile) {
 	rz_return_val_if_fail(core && binfile, false);
 	RzBinObject *o = binfile->o;
-	RzList *cs = o ? o->classes : NULL;
-	if (!cs) {
+	if (!o || !rz_config_get_b(core->config, "bin.classes")) {
 		return false;
 	}
-	if (!rz_config_get_b(core->config, "bin.classes")) {
+	const RzList *cs = rz_bin_object_get_classes(o);
+	if (!cs) {
 		return false;
 	}
 
@@ -2977,6 +3180,9 @@ RZ_API bool rz_core_bin_info_print(RzCore *core, RzBinFile *bf, RzCmdStateOutput
 	bool havecode;
 	int bits;
 
+	// fills info->lang
+	rz_bin_object_get_language(obj);
+
 	havecode = is_executable(obj) | (obj->entries != NULL);
 	compiled = get_compile_time(bf->sdb);
 	bits = (plugin && !strcmp(plugin->name, "any")) ? rz_config_get_i(core->config, "asm.bits") : info->bits;
@@ -3680,7 +3886,8 @@ static void bin_class_print_rizin(RzCore *r, RzBinClass *c, ut64 at_min) {
 	}
 
 	// C struct
-	if (bf->o->lang == RZ_BIN_LANGUAGE_C || bf->o->lang == RZ_BIN_LANGUAGE_CXX || bf->o->lang == RZ_BIN_LANGUAGE_OBJC) {
+	RzBinLanguage lang = rz_bin_object_get_language(bf->o);
+	if (lang == RZ_BIN_LANGUAGE_C || lang == RZ_BIN_LANGUAGE_CXX || lang == RZ_BIN_LANGUAGE_OBJC) {
 		rz_cons_printf("td \"struct %s {", c->name);
 		rz_list_foreach (c->fields, iter2, f) {
 			char *n = objc_name_toc(f->name);
@@ -3710,7 +3917,7 @@ RZ_API bool rz_core_bin_class_as_source_print(RzCore *core, RzBinFile *bf, const
 			continue;
 		}
 		found = true;
-		switch (bf->o->lang & (~RZ_BIN_LANGUAGE_BLOCKS)) {
+		switch (rz_bin_object_get_language(bf->o) & (~RZ_BIN_LANGUAGE_BLOCKS)) {
 		case RZ_BIN_LANGUAGE_KOTLIN:
 		case RZ_BIN_LANGUAGE_GROOVY:
 		case RZ_BIN_LANGUAGE_DART:
@@ -991,6 +991,31 @@ static bool cb_binstrenc(void *user, void *data) {
 	return false;
 }
 
+static bool cb_binlang(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	// a language set by the user is not replaced by the detected one
+	core->bin_lang_pending = false;
+	return true;
+}
+
+static bool cb_binlang_getter(RzCore *core, RzConfigNode *node) {
+	if (!core->bin_lang_pending) {
+		return true;
+	}
+	core->bin_lang_pending = false;
+	RzBinObject *o = rz_bin_cur_object(core->bin);
+	if (!o) {
+		return true;
+	}
+	// fills info->lang
+	rz_bin_object_get_language(o);
+	if (o->info && o->info->lang) {
+		free(node->value);
+		node->value = strdup(o->info->lang);
+	}
+	return true;
+}
+
 static bool cb_binfilter(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -1358,6 +1383,30 @@ static bool cb_dbg_forks(void *user, void *data) {
 	return true;
 }
 
+static bool cb_dbg_heap_snapshot(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	rz_core_heap_snapshot_enable(core, node->i_value);
+	return true;
+}
+
+static bool cb_dbg_allocprof(void *user, void *data) {
+	RzConfigNode *node = (RzConfigNode *)data;
+	if (node->i_value) {
+		rz_alloc_prof_reset();
+		rz_alloc_prof_enable(true);
+	} else if (rz_alloc_prof_enabled()) {
+		rz_alloc_prof_enable(false);
+		char *report = rz_alloc_prof_report();
+		if (report) {
+			rz_cons_print(report);
+			free(report);
+		}
+		rz_alloc_prof_reset();
+	}
+	return true;
+}
+
 static bool cb_dbg_gdb_page_size(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -1944,6 +1993,13 @@ static bool cb_cmddepth(void *user, void *data) {
 	return true;
 }
 
+static bool cb_cmd_parse_cache(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	rz_core_cmd_parse_cache_set_size(core, RZ_MAX(node->i_value, 0));
+	return true;
+}
+
 static bool cb_hexcols(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	int c = RZ_MIN(1024, RZ_MAX(((RzConfigNode *)data)->i_value, 0));
@@ -2116,6 +2172,12 @@ static bool cb_breaklines(void *user, void *data) {
 	return true;
 }
 
+static bool cb_scrdamage(void *user, void *data) {
+	RzConfigNode *node = (RzConfigNode *)data;
+	rz_cons_singleton()->damage = node->i_value;
+	return true;
+}
+
 static bool cb_scr_gadgets(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -3000,9 +3062,11 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETICB("analysis.nonull", 0, &cb_analysis_nonull, "Do not analyze regions of N null bytes");
 	SETBPREF("analysis.esil", "false", "Use the new ESIL code analysis");
 	SETCB("analysis.strings", "false", &cb_analysis_strings, "Identify and register strings during analysis (aar only)");
+	SETI("analysis.xrefs.threads", RZ_THREAD_POOL_ALL_CORES, "Max threads used to decode instructions in aar (when 0 uses all available cores, 1 disables threading)");
 	SETPREF("analysis.types.spec", "gcc", "Set profile for specifying format chars used in type analysis");
 	SETBPREF("analysis.types.verbose", "false", "Verbose output from type analysis");
 	SETBPREF("analysis.types.constraint", "false", "Enable constraint types analysis for variables");
+	SETI("analysis.types.threads", RZ_THREAD_POOL_ALL_CORES, "Max threads used to emulate the functions in aaft (when 0 uses all available cores, 1 disables threading)");
 	SETCB("analysis.vars", "true", &cb_analysis_vars, "Analyze local variables and arguments");
 	SETCB("analysis.vars.stackname", "false", &cb_analysis_vars_stackname, "Name variables based on their offset on the stack");
 	SETBPREF("analysis.vinfun", "true", "Search values in functions (aav) (false by default to only find on non-code)");
@@ -3052,6 +3116,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 #else
 	SETBPREF("dbg.glibc.tcache", "false", "Set glib tcache parsing");
 #endif
+	SETCB("dbg.heap.snapshot", "true", &cb_dbg_heap_snapshot, "Read the heap in bulk into a local snapshot, kept until the debuggee runs again or the memory is written");
 #if __x86_64__
 	SETI("dbg.glibc.ma_offset", 0x000000, "Main_arena offset from his symbol");
 	SETI("dbg.glibc.fc_offset", 0x00280, "First chunk offset from brk_start");
@@ -3261,13 +3326,16 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETOPTIONS(n, "a", "8", "p", "e", "u", "i", "U", "f", NULL);
 	SETCB("bin.filter", "true", &cb_binfilter, "Filter symbol names to fix dupped names");
 	SETCB("bin.force", "", &cb_binforce, "Force that rbin plugin");
-	SETPREF("bin.lang", "", "Language for bin.demangle");
+	SETCB("bin.lang", "", &cb_binlang, "Language for bin.demangle");
+	rz_config_set_getter(cfg, "bin.lang", (RzConfigCallback)cb_binlang_getter);
 	SETBPREF("bin.demangle", "true", "Import demangled symbols from RzBin");
 	SETBPREF("bin.demangle.libs", "false", "Show library name on demangled symbols names");
+	SETI("bin.demangle.threads", RZ_THREAD_POOL_ALL_CORES, "Max threads used to demangle the symbols (when 0 uses all available cores, 1 disables threading)");
 	SETI("bin.baddr", -1, "Base address of the binary");
 	SETI("bin.laddr", 0, "Base address for loading library ('*.so')");
 	SETCB("bin.dbginfo", "true", &cb_bindbginfo, "Load debug information at startup if available");
 	SETBPREF("bin.relocs", "true", "Load relocs information at startup if available");
+	SETBPREF("bin.lazyflags", "false", "Apply the symbols, imports, relocs and classes of a file on the first command not only reading its information");
 	SETICB("bin.minstr", 0, &cb_binminstr, "Minimum string length for rz_bin");
 	SETICB("bin.maxstr", 0, &cb_binmaxstr, "Maximum string length for rz_bin");
 	SETICB("bin.maxstrbuf", 1024 * 1024 * 10, &cb_binmaxstrbuf, "Maximum size of range to load strings from");
@@ -3412,6 +3480,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 
 	SETCB("dbg.bpinmaps", "true", &cb_dbg_bpinmaps, "Activate breakpoints only if they are inside a valid map");
 	SETCB("dbg.forks", "false", &cb_dbg_forks, "Stop execution if fork() is done (see dbg.threads)");
+	SETCB("dbg.allocprof", "false", &cb_dbg_allocprof, "Count the allocations of rizin by site, the report is printed when disabled");
 #if __WINDOWS__
 	n = NODECB("dbg.btalgo", "default", &cb_dbg_btalgo);
 #else
@@ -3469,6 +3538,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 
 	/* cmd */
 	SETICB("cmd.depth", 10, &cb_cmddepth, "Maximum command depth");
+	SETICB("cmd.parse.cache", 256, &cb_cmd_parse_cache, "Number of parsed commands kept to skip parsing them again (0 disables the cache)");
 	SETPREF("cmd.bp", "", "Run when a breakpoint is hit");
 	SETPREF("cmd.onsyscall", "", "Run when a syscall is hit");
 	SETICB("cmd.hitinfo", 1, &cb_debug_hitinfo, "Show info when a tracepoint/breakpoint is hit");
@@ -3643,6 +3713,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	// DEPRECATED: USES hex.cols now SETI ("scr.colpos", 80, "Column position of cmd.cprompt in visual");
 	SETCB("scr.breakword", "", &cb_scrbreakword, "Emulate console break (^C) when a word is printed (useful for pD)");
 	SETCB("scr.breaklines", "false", &cb_breaklines, "Break lines in Visual instead of truncating them");
+	SETCB("scr.damage", "false", &cb_scrdamage, "Write only the changed parts of the screen in Visual and panels");
 	SETCB("scr.gadgets", "true", &cb_scr_gadgets, "Run pg in prompt, visual and panels");
 	SETBPREF("scr.panelborder", "false", "Specify panels border active area (0 by default)");
 	SETICB("scr.columns", 0, &cb_scrcolumns, "Force console column count (width)");
@@ -3697,6 +3768,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETI("search.chunk", 0, "Chunk size for /+ (default size is asm.bits/8");
 	SETI("search.esilcombo", 8, "Stop search after N consecutive hits");
 	SETI("search.distance", 0, "Search string distance");
+	SETI("search.collisions.threads", RZ_THREAD_POOL_ALL_CORES, "Max threads used to find the collisions in /cc (when 0 uses all available cores, 1 disables threading)");
 	SETBPREF("search.flags", "true", "All search results are flagged, otherwise only printed");
 	SETBPREF("search.overlap", "false", "Look for overlapped search hits");
 	SETI("search.maxhits", 0, "Maximum number of hits (0: no limit)");
@@ -3722,6 +3794,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETBPREF("rop.subchains", "false", "Display every length gadget from rop.len=X to 2 in /Rl");
 	SETBPREF("rop.conditional", "false", "Include conditional jump, calls and returns in ropsearch");
 	SETBPREF("rop.comments", "false", "Display comments in rop search output");
+	SETI("rop.threads", RZ_THREAD_POOL_ALL_CORES, "Max threads used to find the gadgets in /Ri (when 0 uses all available cores, 1 disables threading)");
 
 	/* io */
 	SETCB("io.cache", "false", &cb_io_cache, "Change both of io.cache.{read,write}");
@@ -1603,7 +1603,7 @@ RZ_IPI void rz_core_io_file_reopen(RzCore *core, int fd, int perms) {
 		rz_pvector_foreach_prev(maps, it) {
 			RzIOMap *map = *it;
 			if (map->fd == fd) {
-				map->perm |= RZ_PERM_WX;
+				rz_io_map_set_perm(core->io, map, map->perm | RZ_PERM_WX);
 			}
 		}
 	}
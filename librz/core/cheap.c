@@ -34,3 +34,237 @@ RZ_API RZ_OWN RzList *rz_heap_windows_heap_list(RzCore *core) {
 }
 
 #endif
+
+#define HEAP_SNAPSHOT_PAGE_SIZE 0x1000
+#define HEAP_SNAPSHOT_BULK      64 // pages read at once inside the arena ranges
+
+typedef struct {
+	ut8 bytes[HEAP_SNAPSHOT_PAGE_SIZE];
+	bool valid; ///< whether the page was read successfully
+} HeapSnapshotPage;
+
+/**
+ * Local copy of the memory read by the heap inspectors, so the chunks are
+ * parsed from memory instead of reading each header and pointer from the
+ * target. The pages inside the arena ranges are read in bulk.
+ */
+struct rz_core_heap_snapshot_t {
+	bool enabled;
+	HtUP /*<ut64, HeapSnapshotPage *>*/ *pages;
+	RzVector /*<RzInterval>*/ ranges; ///< arena ranges, read HEAP_SNAPSHOT_BULK pages at a time
+	ut64 stops; ///< value of RzDebug.stops when the pages were read
+	ut64 requests; ///< reads requested by the heap inspectors
+	ut64 io_reads; ///< reads done on the io
+};
+
+static void heap_snapshot_page_free(HtUPKv *kv) {
+	free(kv->value);
+}
+
+static RzCoreHeapSnapshot *heap_snapshot_get(RzCore *core) {
+	RzCoreHeapSnapshot *snap = core->heap_snapshot;
+	if (snap) {
+		if (core->dbg && snap->stops != core->dbg->stops) {
+			rz_core_heap_snapshot_invalidate(core);
+			snap->stops = core->dbg->stops;
+		}
+		return snap;
+	}
+	snap = RZ_NEW0(RzCoreHeapSnapshot);
+	if (!snap) {
+		return NULL;
+	}
+	snap->pages = ht_up_new(NULL, heap_snapshot_page_free, NULL);
+	if (!snap->pages) {
+		free(snap);
+		return NULL;
+	}
+	rz_vector_init(&snap->ranges, sizeof(RzInterval), NULL, NULL);
+	snap->enabled = rz_config_get_b(core->config, "dbg.heap.snapshot");
+	snap->stops = core->dbg ? core->dbg->stops : 0;
+	core->heap_snapshot = snap;
+	return snap;
+}
+
+static ut64 heap_snapshot_bulk_end(RzCoreHeapSnapshot *snap, ut64 page) {
+	RzInterval *itv;
+	rz_vector_foreach(&snap->ranges, itv) {
+		if (rz_itv_contain(*itv, page)) {
+			ut64 end = rz_itv_end(*itv);
+			ut64 max = page + HEAP_SNAPSHOT_BULK * HEAP_SNAPSHOT_PAGE_SIZE;
+			if (max < page) {
+				break;
+			}
+			return end && end < max && end > page ? end : max;
+		}
+	}
+	return page + HEAP_SNAPSHOT_PAGE_SIZE;
+}
+
+static bool heap_snapshot_read_page(RzCore *core, RzCoreHeapSnapshot *snap, ut64 page, HeapSnapshotPage *p) {
+	snap->io_reads++;
+	p->valid = rz_io_read_at(core->io, page, p->bytes, HEAP_SNAPSHOT_PAGE_SIZE);
+	return ht_up_insert(snap->pages, page, p);
+}
+
+/**
+ * Reads the run of pages starting at \p page with a single io read, or page
+ * by page when some of them can't be read.
+ */
+static HeapSnapshotPage *heap_snapshot_load(RzCore *core, RzCoreHeapSnapshot *snap, ut64 page) {
+	ut64 end = heap_snapshot_bulk_end(snap, page);
+	ut64 n = (end - page + HEAP_SNAPSHOT_PAGE_SIZE - 1) / HEAP_SNAPSHOT_PAGE_SIZE;
+	// don't read again the pages already in the snapshot
+	for (ut64 i = 1; i < n; i++) {
+		if (ht_up_find(snap->pages, page + i * HEAP_SNAPSHOT_PAGE_SIZE, NULL)) {
+			n = i;
+			break;
+		}
+	}
+	ut8 *buf = n > 1 ? malloc(n * HEAP_SNAPSHOT_PAGE_SIZE) : NULL;
+	bool bulk = false;
+	if (buf) {
+		snap->io_reads++;
+		bulk = rz_io_read_at(core->io, page, buf, n * HEAP_SNAPSHOT_PAGE_SIZE);
+	}
+	HeapSnapshotPage *first = NULL;
+	for (ut64 i = 0; i < (bulk ? n : 1); i++) {
+		HeapSnapshotPage *p = RZ_NEW(HeapSnapshotPage);
+		if (!p) {
+			break;
+		}
+		ut64 addr = page + i * HEAP_SNAPSHOT_PAGE_SIZE;
+		if (bulk) {
+			memcpy(p->bytes, buf + i * HEAP_SNAPSHOT_PAGE_SIZE, HEAP_SNAPSHOT_PAGE_SIZE);
+			p->valid = true;
+			if (!ht_up_insert(snap->pages, addr, p)) {
+				free(p);
+				continue;
+			}
+		} else if (!heap_snapshot_read_page(core, snap, addr, p)) {
+			free(p);
+			break;
+		}
+		if (!i) {
+			first = p;
+		}
+	}
+	free(buf);
+	return first;
+}
+
+/**
+ * \brief Reads \p len bytes at \p addr for the heap inspectors
+ *
+ * The bytes come from a snapshot of the target memory, which is read page
+ * by page (or in bulk inside the ranges given to
+ * rz_core_heap_snapshot_add_range()) and is kept until the debuggee stops
+ * again or the memory is written. With dbg.heap.snapshot disabled this is
+ * the same as rz_io_read_at().
+ */
+RZ_API bool rz_core_heap_read(RZ_NONNULL RzCore *core, ut64 addr, RZ_NONNULL ut8 *buf, int len) {
+	rz_return_val_if_fail(core && buf, false);
+	RzCoreHeapSnapshot *snap = heap_snapshot_get(core);
+	if (snap) {
+		snap->requests++;
+	}
+	if (!snap || !snap->enabled || len < 0 || UT64_ADD_OVFCHK(addr, len)) {
+		if (snap) {
+			snap->io_reads++;
+		}
+		return rz_io_read_at(core->io, addr, buf, len);
+	}
+	bool ret = true;
+	while (len > 0) {
+		ut64 page = addr & ~(ut64)(HEAP_SNAPSHOT_PAGE_SIZE - 1);
+		HeapSnapshotPage *p = ht_up_find(snap->pages, page, NULL);
+		if (!p) {
+			p = heap_snapshot_load(core, snap, page);
+			if (!p) {
+				return rz_io_read_at(core->io, addr, buf, len) && ret;
+			}
+		}
+		int off = addr - page;
+		int n = RZ_MIN(len, HEAP_SNAPSHOT_PAGE_SIZE - off);
+		memcpy(buf, p->bytes + off, n);
+		ret &= p->valid;
+		buf += n;
+		addr += n;
+		len -= n;
+	}
+	return ret;
+}
+
+/**
+ * \brief Marks [from, to) as an arena range, whose pages are read in bulk
+ */
+RZ_API void rz_core_heap_snapshot_add_range(RZ_NONNULL RzCore *core, ut64 from, ut64 to) {
+	rz_return_if_fail(core);
+	RzCoreHeapSnapshot *snap = heap_snapshot_get(core);
+	if (!snap || to <= from) {
+		return;
+	}
+	RzInterval *itv;
+	rz_vector_foreach(&snap->ranges, itv) {
+		if (itv->addr == from && rz_itv_end(*itv) == to) {
+			return;
+		}
+	}
+	RzInterval range = { .addr = from, .size = to - from };
+	rz_vector_push(&snap->ranges, &range);
+}
+
+/**
+ * \brief Drops the memory read by the heap inspectors, which is read again
+ * by the next rz_core_heap_read()
+ */
+RZ_API void rz_core_heap_snapshot_invalidate(RZ_NONNULL RzCore *core) {
+	rz_return_if_fail(core);
+	RzCoreHeapSnapshot *snap = core->heap_snapshot;
+	if (!snap || (!snap->pages->count && rz_vector_empty(&snap->ranges))) {
+		return;
+	}
+	ht_up_free(snap->pages);
+	snap->pages = ht_up_new(NULL, heap_snapshot_page_free, NULL);
+	rz_vector_clear(&snap->ranges);
+}
+
+/**
+ * \brief Enables or disables the snapshot of rz_core_heap_read()
+ */
+RZ_API void rz_core_heap_snapshot_enable(RZ_NONNULL RzCore *core, bool enable) {
+	rz_return_if_fail(core);
+	RzCoreHeapSnapshot *snap = core->heap_snapshot;
+	if (snap) {
+		snap->enabled = enable;
+		rz_core_heap_snapshot_invalidate(core);
+	}
+}
+
+/**
+ * \brief Gets the number of reads requested by the heap inspectors and of the
+ * reads done on the io to serve them, since the last call
+ */
+RZ_API void rz_core_heap_snapshot_stats(RZ_NONNULL RzCore *core, RZ_NULLABLE ut64 *requests, RZ_NULLABLE ut64 *io_reads) {
+	rz_return_if_fail(core);
+	RzCoreHeapSnapshot *snap = core->heap_snapshot;
+	if (requests) {
+		*requests = snap ? snap->requests : 0;
+	}
+	if (io_reads) {
+		*io_reads = snap ? snap->io_reads : 0;
+	}
+	if (snap) {
+		snap->requests = 0;
+		snap->io_reads = 0;
+	}
+}
+
+RZ_API void rz_core_heap_snapshot_free(RZ_NULLABLE RzCoreHeapSnapshot *snap) {
+	if (!snap) {
+		return;
+	}
+	ht_up_free(snap->pages);
+	rz_vector_fini(&snap->ranges);
+	free(snap);
+}
@@ -606,7 +606,10 @@ RZ_IPI void rz_core_rzil_step(RzCore *core) {
 	oplist = op.rzil_op ? op.rzil_op->ops : NULL;
 
 	if (oplist) {
+		// the registers are shared with analysis->reg, through the bindings
+		rz_analysis_rzil_sync_from_reg(rzil, analysis->reg);
 		rz_il_vm_list_step(vm, oplist, size > 0 ? size : 1);
+		rz_analysis_rzil_sync_to_reg(rzil, analysis->reg);
 	} else {
 		RZ_LOG_ERROR("RzIL: invalid instruction detected or reach the end of code at address 0x%08" PFMT64x "\n", addr);
 	}
@@ -19,6 +19,7 @@
 #include <cmd_descs.h>
 
 #include <tree_sitter/api.h>
+#include "cmd_parse_cache.h"
 TSLanguage *tree_sitter_rzcmd();
 
 RZ_API void rz_save_panels_layout(RzCore *core, const char *_name);
@@ -1703,6 +1704,21 @@ static bool set_tmp_bits(RzCore *core, int bits, char **tmpbits, int *cmd_ignbit
 	return true;
 }
 
+/**
+ * Applies the bin items left by bin.lazyflags before running \p cmd, unless
+ * it only reads the bin information (i) or quits (q).
+ */
+static void cmd_apply_bin_pending(RzCore *core, const char *cmd) {
+	if (!core->bin_pending) {
+		return;
+	}
+	cmd = rz_str_trim_head_ro(cmd);
+	if (!*cmd || *cmd == 'i' || *cmd == 'q') {
+		return;
+	}
+	rz_core_bin_apply_pending(core);
+}
+
 static int rz_core_cmd_subst_i(RzCore *core, char *cmd, char *colon, bool *tmpseek) {
 	RzList *tmpenvs = rz_list_newf(tmpenvs_free);
 	const char *quotestr = "`";
@@ -1729,6 +1745,7 @@ static int rz_core_cmd_subst_i(RzCore *core, char *cmd, char *colon, bool *tmpse
 		return 0;
 	}
 	rz_str_trim(cmd);
+	cmd_apply_bin_pending(core, cmd);
 
 	char *$0 = strstr(cmd, "$(");
 	if ($0) {
@@ -3837,6 +3854,13 @@ static RzCmdParsedArgs *parse_args(struct tsr2cmd_state *state, TSNode args, boo
 	}
 }
 
+static TSTree *cmd_parse(RzCore *core, TSParser *parser, const char *input) {
+	RzCmdParseCache *cache = core->rcmd->parse_cache;
+	return cache
+		? rz_cmd_parse_cache_parse(cache, parser, input)
+		: ts_parser_parse_string(parser, NULL, input, strlen(input));
+}
+
 static TSTree *apply_edits(struct tsr2cmd_state *state, RzList *edits) {
 	struct tsr2cmd_edit *edit;
 	RzListIter *it;
@@ -3847,7 +3871,8 @@ static TSTree *apply_edits(struct tsr2cmd_state *state, RzList *edits) {
 		state->input = rz_str_replace(state->input, edit->old_text, edit->new_text, 0);
 	}
 	RZ_LOG_DEBUG("new input = '%s'\n", state->input);
-	return ts_parser_parse_string(state->parser, NULL, state->input, strlen(state->input));
+	// iterators substitute the same arguments of their command many times
+	return cmd_parse(state->core, state->parser, state->input);
 }
 
 static void substitute_args_fini(struct tsr2cmd_state *state) {
@@ -3981,6 +4006,7 @@ DEFINE_HANDLE_TS_FCN_AND_SYMBOL(arged_stmt) {
 
 	pr_args->extra = command_extra_str;
 	pr_args->has_space_after_cmd = !ts_node_is_null(args) && ts_node_end_byte(command) < ts_node_start_byte(args);
+	cmd_apply_bin_pending(state->core, command_str);
 	res = rz_cmd_call_parsed_args(state->core->rcmd, pr_args);
 	if (res == RZ_CMD_STATUS_WRONG_ARGS) {
 		const char *cmdname = rz_cmd_parsed_args_cmd(pr_args);
@@ -5542,6 +5568,8 @@ RZ_API RzCmd *rz_core_cmd_new(bool has_cons) {
 
 	TSLanguage *lang = tree_sitter_rzcmd();
 	res->language = lang;
+	// sized by cmd.parse.cache, disabled until then
+	res->parse_cache = rz_cmd_parse_cache_new(0);
 	res->ts_symbols_ht = ht_up_new0();
 	struct ts_data_symbol_map *entry = map_ts_stmt_handlers;
 	while (entry->name) {
@@ -5559,6 +5587,15 @@ RZ_API RzCmd *rz_core_cmd_new(bool has_cons) {
 	return res;
 }
 
+/**
+ * \brief Sets the number of parsed commands kept by the shell parser, 0 disables the cache
+ */
+RZ_IPI void rz_core_cmd_parse_cache_set_size(RzCore *core, size_t size) {
+	if (core->rcmd && core->rcmd->parse_cache) {
+		rz_cmd_parse_cache_set_capacity(core->rcmd->parse_cache, size);
+	}
+}
+
 static RzCmdStatus core_cmd_tsrzcmd(RzCore *core, const char *cstr, bool split_lines, bool log) {
 	TSParser *parser = ts_parser_new();
 	bool language_ok = ts_parser_set_language(parser, (TSLanguage *)core->rcmd->language);
@@ -5566,7 +5603,7 @@ static RzCmdStatus core_cmd_tsrzcmd(RzCore *core, const char *cstr, bool split_l
 
 	char *input = strdup(rz_str_trim_head_ro(cstr));
 
-	TSTree *tree = ts_parser_parse_string(parser, NULL, input, strlen(input));
+	TSTree *tree = cmd_parse(core, parser, input);
 	if (!tree) {
 		rz_warn_if_reached();
 		free(input);
@@ -5595,7 +5632,17 @@ static RzCmdStatus core_cmd_tsrzcmd(RzCore *core, const char *cstr, bool split_l
 	free(ts_str);
 
 	if (is_ts_statements(root) && !ts_node_has_error(root)) {
+		RzCmdParseCache *cache = core->rcmd->parse_cache;
+		bool top = cache && core->cons->context->cmd_depth == core->max_cmd_depth;
+		ut64 start = top ? rz_time_now_mono() : 0;
+		ut64 parse_time = top ? rz_cmd_parse_cache_parse_time(cache) : 0;
 		res = handle_ts_statements(&state, root);
+		if (top) {
+			// the nested commands are parsed while executing this one
+			ut64 nested_parse_time = rz_cmd_parse_cache_parse_time(cache) - parse_time;
+			ut64 elapsed = rz_time_now_mono() - start;
+			rz_cmd_parse_cache_add_exec(cache, elapsed > nested_parse_time ? elapsed - nested_parse_time : 0);
+		}
 	} else {
 		// TODO: print a more meaningful error message and use the ERROR
 		// tokens to indicate where, probably, the error is.
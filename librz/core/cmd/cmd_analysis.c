@@ -299,6 +299,8 @@ static const char *help_msg_aets[] = {
 	"Usage:", "aets ", " [...]",
 	"aets+", "", "Start ESIL trace session",
 	"aets-", "", "Stop ESIL trace session",
+	"aetsw", " <file>", "Save the registers and memory changes of the ESIL trace to file",
+	"aetso", " <file>", "Open an ESIL trace saved with aetsw and rewind to its first step",
 	NULL
 };
 
@@ -2433,27 +2435,27 @@ RZ_API bool rz_core_esil_continue_back(RzCore *core) {
 		return true;
 	}
 
-	RzRegItem *ripc = rz_reg_get(esil->analysis->reg, "PC", -1);
-	RzVector *vreg = ht_up_find(esil->trace->registers, ripc->offset | (ripc->arena << 16), NULL);
-	if (!vreg) {
-		RZ_LOG_ERROR("failed to find PC change vector\n");
-		return false;
-	}
-
 	// Search for the nearest breakpoint in the tracepoints before the current position
-	bool bp_found = false;
+	ut64 pcs[256];
 	int idx = 0;
-	RzAnalysisEsilRegChange *reg;
-	rz_vector_foreach_prev(vreg, reg) {
-		if (reg->idx >= esil->trace->idx) {
-			continue;
+	ut32 end = esil->trace->idx;
+	while (end > 0) {
+		ut32 n = RZ_MIN(end, RZ_ARRAY_SIZE(pcs));
+		ut32 start = end - n;
+		if (rz_analysis_esil_trace_log_pcs(esil->trace->log, start, n, pcs) != n) {
+			RZ_LOG_ERROR("failed to read the PC of the ESIL trace steps\n");
+			return false;
+		}
+		ut32 i = n;
+		while (i > 0 && !rz_bp_get_in(core->dbg->bp, pcs[i - 1], RZ_PERM_X)) {
+			i--;
 		}
-		bp_found = rz_bp_get_in(core->dbg->bp, reg->data, RZ_PERM_X) != NULL;
-		if (bp_found) {
-			idx = reg->idx;
-			eprintf("hit breakpoint at: 0x%" PFMT64x " idx: %d\n", reg->data, reg->idx);
+		if (i > 0) {
+			idx = start + i - 1;
+			eprintf("hit breakpoint at: 0x%" PFMT64x " idx: %d\n", pcs[i - 1], idx);
 			break;
 		}
+		end = start;
 	}
 
 	// Return to the nearest breakpoint or jump back to the first index if a breakpoint wasn't found
@@ -3590,6 +3592,35 @@ static void cmd_analysis_esil(RzCore *core, const char *input) {
 				esil->trace = NULL;
 				rz_config_set_i(core->config, "dbg.trace", false);
 				break;
+			case 'w': // "aetsw"
+				if (!esil || !esil->trace) {
+					eprintf("No ESIL trace started\n");
+					break;
+				}
+				if (input[3] != ' ' || !input[4]) {
+					rz_core_cmd_help(core, help_msg_aets);
+					break;
+				}
+				if (!rz_analysis_esil_trace_save(esil->trace, rz_str_trim_head_ro(input + 4))) {
+					eprintf("Cannot save the ESIL trace\n");
+				}
+				break;
+			case 'o': // "aetso"
+				if (!esil) {
+					eprintf("Error: ESIL is not initialized. Use `aeim` first.\n");
+					break;
+				}
+				if (input[3] != ' ' || !input[4]) {
+					rz_core_cmd_help(core, help_msg_aets);
+					break;
+				}
+				if (!rz_analysis_esil_trace_load(esil, rz_str_trim_head_ro(input + 4))) {
+					eprintf("Cannot open the ESIL trace\n");
+					break;
+				}
+				rz_core_regs2flags(core);
+				rz_config_set_i(core->config, "dbg.trace", true);
+				break;
 			default:
 				rz_core_cmd_help(core, help_msg_aets);
 				break;
@@ -8,6 +8,7 @@
 #include <rz_cmd.h>
 #include <rz_util.h>
 #include <rz_core.h>
+#include "cmd_parse_cache.h"
 
 /*!
  * Number of sub-commands to show as options when displaying the help of a
@@ -212,6 +213,7 @@ RZ_API RzCmd *rz_cmd_free(RzCmd *cmd) {
 		return NULL;
 	}
 	ht_up_free(cmd->ts_symbols_ht);
+	rz_cmd_parse_cache_free(cmd->parse_cache);
 	rz_cmd_alias_free(cmd);
 	rz_cmd_macro_fini(&cmd->macro);
 	ht_pp_free(cmd->ht_cmds);
@@ -38,3 +38,48 @@ RZ_IPI RzCmdStatus rz_history_save_handler(RzCore *core, int argc, const char **
 	free(history);
 	return RZ_CMD_STATUS_OK;
 }
+
+RZ_IPI RzCmdStatus rz_parse_stats_handler(RzCore *core, int argc, const char **argv, RzCmdStateOutput *state) {
+	RzCmdParseCache *cache = core->rcmd->parse_cache;
+	if (!cache) {
+		RZ_LOG_ERROR("The parsing statistics are not available.\n");
+		return RZ_CMD_STATUS_ERROR;
+	}
+	RzCmdParseStats st;
+	rz_cmd_parse_cache_stats(cache, &st);
+	ut64 lookups = st.parses + st.hits;
+	switch (state->mode) {
+	case RZ_OUTPUT_MODE_JSON:
+		pj_o(state->d.pj);
+		pj_kn(state->d.pj, "commands", st.commands);
+		pj_kn(state->d.pj, "exec_time_us", st.exec_time);
+		pj_kn(state->d.pj, "parses", st.parses);
+		pj_kn(state->d.pj, "parse_time_us", st.parse_time);
+		pj_kn(state->d.pj, "cache_hits", st.hits);
+		pj_kn(state->d.pj, "cache_size", st.cached);
+		pj_kn(state->d.pj, "cache_capacity", st.capacity);
+		pj_end(state->d.pj);
+		break;
+	case RZ_OUTPUT_MODE_STANDARD:
+		rz_cons_printf("commands:    %" PFMT64u "\n", st.commands);
+		rz_cons_printf("exec time:   %" PFMT64u " us\n", st.exec_time);
+		rz_cons_printf("parses:      %" PFMT64u "\n", st.parses);
+		rz_cons_printf("parse time:  %" PFMT64u " us (%" PFMT64u " us per parse)\n",
+			st.parse_time, st.parses ? st.parse_time / st.parses : 0);
+		rz_cons_printf("cache hits:  %" PFMT64u " (%d%%)\n", st.hits, lookups ? (int)(st.hits * 100 / lookups) : 0);
+		rz_cons_printf("cache size:  %" PFMTSZu "/%" PFMTSZu "\n", st.cached, st.capacity);
+		break;
+	default:
+		rz_warn_if_reached();
+		return RZ_CMD_STATUS_ERROR;
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
+RZ_IPI RzCmdStatus rz_parse_stats_reset_handler(RzCore *core, int argc, const char **argv) {
+	RzCmdParseCache *cache = core->rcmd->parse_cache;
+	if (cache) {
+		rz_cmd_parse_cache_reset(cache);
+	}
+	return RZ_CMD_STATUS_OK;
+}
@@ -189,6 +189,84 @@ seek_exit:
 	return ret;
 }
 
+#define MAGIC_SEARCH_CHUNK 0x10000
+
+/**
+ * Loads the magic set \p file (or the one of dir.magic) for a prefilter, as
+ * rz_core_magic_at() does for itself.
+ */
+static RzMagicPrefilter *core_magic_prefilter_new(RzCore *core, const char *file, RzMagic **ms) {
+	if (file && *file == ' ') {
+		file++;
+	}
+	if (!file || !*file) {
+		file = rz_config_get(core->config, "dir.magic");
+	}
+	*ms = rz_magic_new(0);
+	if (!*ms || !rz_magic_load(*ms, file)) {
+		rz_magic_free(*ms);
+		*ms = NULL;
+		return NULL;
+	}
+	RzMagicPrefilter *pf = rz_magic_prefilter_new(*ms);
+	if (!pf) {
+		rz_magic_free(*ms);
+		*ms = NULL;
+	}
+	return pf;
+}
+
+/**
+ * Runs rz_core_magic_at() over \p itv, skipping the addresses where \p pf
+ * tells that no magic can be found in the block it would analyze there.
+ */
+static void core_magic_search(RzCore *core, const char *file, RzInterval itv, RzMagicPrefilter *pf, PJ *pj, int *hits) {
+	int maxHits = rz_config_get_i(core->config, "search.maxhits");
+	ut8 *buf = NULL;
+	ut64 buf_addr = 0;
+	ut64 buf_len = 0;
+	ut64 end = rz_itv_end(itv);
+	for (ut64 addr = itv.addr; addr < end;) {
+		if (rz_cons_is_breaked()) {
+			break;
+		}
+		ut64 align = core->search->align;
+		if (pf && (!align || !(addr % align))) {
+			// the block rz_core_magic_at() would analyze at addr
+			ut64 off = core->offset;
+			ut32 bsize = core->blocksize;
+			ut64 nb = addr >= off && addr + NAH < off + bsize ? off + bsize - addr : bsize;
+			if (!buf || addr < buf_addr || addr + nb > buf_addr + buf_len) {
+				ut8 *tmp = realloc(buf, MAGIC_SEARCH_CHUNK + bsize);
+				if (!tmp) {
+					break;
+				}
+				buf = tmp;
+				buf_addr = addr;
+				buf_len = MAGIC_SEARCH_CHUNK + bsize;
+				rz_io_read_at(core->io, buf_addr, buf, buf_len);
+				if (!pj) {
+					eprintf("0x%08" PFMT64x " [%d matches found]\r", addr, *hits);
+				}
+			}
+			if (!rz_magic_prefilter_match(pf, buf + (addr - buf_addr), nb)) {
+				addr += align ? align : 1;
+				continue;
+			}
+		}
+		int ret = rz_core_magic_at(core, file, addr, 99, false, pj, hits);
+		if (ret == -1) {
+			// something went terribly wrong.
+			break;
+		}
+		if (maxHits && *hits >= maxHits) {
+			break;
+		}
+		addr += ret;
+	}
+	free(buf);
+}
+
 static void rz_core_magic(RzCore *core, const char *file, int v, PJ *pj) {
 	ut64 addr = core->offset;
 	int hits = 0;
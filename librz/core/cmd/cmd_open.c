@@ -483,19 +483,19 @@ static void cmd_omfg(RzCore *core, const char *input) {
 		case '+':
 			rz_pvector_foreach (maps, it) {
 				RzIOMap *map = *it;
-				map->perm |= perm;
+				rz_io_map_set_perm(core->io, map, map->perm | perm);
 			}
 			break;
 		case '-':
 			rz_pvector_foreach (maps, it) {
 				RzIOMap *map = *it;
-				map->perm &= ~perm;
+				rz_io_map_set_perm(core->io, map, map->perm & ~perm);
 			}
 			break;
 		default:
 			rz_pvector_foreach (maps, it) {
 				RzIOMap *map = *it;
-				map->perm = perm;
+				rz_io_map_set_perm(core->io, map, perm);
 			}
 			break;
 		}
@@ -518,7 +518,7 @@ static void cmd_omf(RzCore *core, const char *input) {
 		rz_pvector_foreach (maps, it) {
 			RzIOMap *map = *it;
 			if (map->id == id) {
-				map->perm = perm;
+				rz_io_map_set_perm(core->io, map, perm);
 				break;
 			}
 		}
@@ -529,7 +529,7 @@ static void cmd_omf(RzCore *core, const char *input) {
 		rz_pvector_foreach (maps, it) {
 			RzIOMap *map = *it;
 			if (rz_itv_contain(map->itv, core->offset)) {
-				map->perm = perm;
+				rz_io_map_set_perm(core->io, map, perm);
 			}
 		}
 	}
@@ -1052,7 +1052,7 @@ RZ_IPI int rz_cmd_open(void *data, const char *input) {
 						void **it;
 						rz_pvector_foreach (&file->maps, it) {
 							RzIOMap *map = *it;
-							map->perm |= RZ_PERM_WX;
+							rz_io_map_set_perm(core->io, map, map->perm | RZ_PERM_WX);
 						}
 					} else {
 						eprintf("Error: %s is not writable\n", argv0);
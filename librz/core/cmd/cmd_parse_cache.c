@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include "cmd_parse_cache.h"
+
+/*
+ * LRU cache of the trees parsed by the shell parser, keyed by the literal
+ * input. Scripts and rzpipe clients send the same few commands over and
+ * over, and the commands with substitutions are parsed again after each
+ * substitution, so most inputs were already parsed recently.
+ *
+ * The trees are never modified once parsed: a hit returns a copy of the
+ * cached tree (just a reference for tree-sitter), which the caller deletes
+ * as any other tree and can use while the cache drops it. The nodes refer
+ * to the input by offset, so they are valid for any string equal to the
+ * key.
+ */
+
+typedef struct {
+	char *input;
+	TSTree *tree;
+} ParseCacheEntry;
+
+struct rz_cmd_parse_cache_t {
+	RzThreadLock *lock;
+	HtPP /*<char *, RzListIter<ParseCacheEntry *> *>*/ *ht; ///< input -> iterator in lru
+	RzList /*<ParseCacheEntry *>*/ *lru; ///< most recently used first
+	size_t capacity;
+	RzCmdParseStats stats;
+};
+
+static void entry_free(ParseCacheEntry *entry) {
+	if (!entry) {
+		return;
+	}
+	ts_tree_delete(entry->tree);
+	free(entry->input);
+	free(entry);
+}
+
+/**
+ * Creates a cache keeping at most \p capacity trees, 0 disables caching
+ */
+RZ_IPI RzCmdParseCache *rz_cmd_parse_cache_new(size_t capacity) {
+	RzCmdParseCache *cache = RZ_NEW0(RzCmdParseCache);
+	if (!cache) {
+		return NULL;
+	}
+	cache->lock = rz_th_lock_new(true);
+	cache->ht = ht_pp_new0();
+	cache->lru = rz_list_newf((RzListFree)entry_free);
+	if (!cache->lock || !cache->ht || !cache->lru) {
+		rz_cmd_parse_cache_free(cache);
+		return NULL;
+	}
+	cache->capacity = capacity;
+	return cache;
+}
+
+RZ_IPI void rz_cmd_parse_cache_free(RzCmdParseCache *cache) {
+	if (!cache) {
+		return;
+	}
+	ht_pp_free(cache->ht);
+	rz_list_free(cache->lru);
+	rz_th_lock_free(cache->lock);
+	free(cache);
+}
+
+static void cache_evict(RzCmdParseCache *cache, size_t capacity) {
+	while (rz_list_length(cache->lru) > capacity) {
+		ParseCacheEntry *entry = rz_list_pop(cache->lru);
+		ht_pp_delete(cache->ht, entry->input);
+		entry_free(entry);
+	}
+}
+
+/**
+ * Changes the maximum number of trees kept, dropping the least recently
+ * used ones if needed
+ */
+RZ_IPI void rz_cmd_parse_cache_set_capacity(RzCmdParseCache *cache, size_t capacity) {
+	rz_return_if_fail(cache);
+	rz_th_lock_enter(cache->lock);
+	cache->capacity = capacity;
+	cache_evict(cache, capacity);
+	rz_th_lock_leave(cache->lock);
+}
+
+/**
+ * Drops all the cached trees and resets the counters
+ */
+RZ_IPI void rz_cmd_parse_cache_reset(RzCmdParseCache *cache) {
+	rz_return_if_fail(cache);
+	rz_th_lock_enter(cache->lock);
+	cache_evict(cache, 0);
+	memset(&cache->stats, 0, sizeof(cache->stats));
+	rz_th_lock_leave(cache->lock);
+}
+
+/**
+ * \brief Parses \p input with \p parser, or returns the tree cached for it
+ *
+ * \return a tree owned by the caller, to be freed with ts_tree_delete()
+ */
+RZ_IPI TSTree *rz_cmd_parse_cache_parse(RzCmdParseCache *cache, TSParser *parser, const char *input) {
+	rz_return_val_if_fail(cache && parser && input, NULL);
+	rz_th_lock_enter(cache->lock);
+	RzListIter *it = ht_pp_find(cache->ht, input, NULL);
+	if (it) {
+		ParseCacheEntry *entry = rz_list_iter_get_data(it);
+		TSTree *tree = ts_tree_copy(entry->tree);
+		if (it != rz_list_head(cache->lru)) {
+			rz_list_split_iter(cache->lru, it);
+			free(it);
+			it = rz_list_prepend(cache->lru, entry);
+			if (it) {
+				ht_pp_update(cache->ht, input, it);
+			} else {
+				ht_pp_delete(cache->ht, input);
+				entry_free(entry);
+			}
+		}
+		cache->stats.hits++;
+		rz_th_lock_leave(cache->lock);
+		return tree;
+	}
+	rz_th_lock_leave(cache->lock);
+
+	// parse without holding the lock, the parser belongs to the caller
+	ut64 start = rz_time_now_mono();
+	TSTree *tree = ts_parser_parse_string(parser, NULL, input, strlen(input));
+	ut64 elapsed = rz_time_now_mono() - start;
+
+	rz_th_lock_enter(cache->lock);
+	cache->stats.parses++;
+	cache->stats.parse_time += elapsed;
+	if (tree && cache->capacity && !ht_pp_find(cache->ht, input, NULL)) {
+		ParseCacheEntry *entry = RZ_NEW0(ParseCacheEntry);
+		if (entry) {
+			entry->input = strdup(input);
+			entry->tree = ts_tree_copy(tree);
+		}
+		RzListIter *it = entry && entry->input && entry->tree ? rz_list_prepend(cache->lru, entry) : NULL;
+		if (it) {
+			ht_pp_insert(cache->ht, input, it);
+			cache_evict(cache, cache->capacity);
+		} else {
+			entry_free(entry);
+		}
+	}
+	rz_th_lock_leave(cache->lock);
+	return tree;
+}
+
+/**
+ * Returns the time spent parsing so far, in microseconds
+ */
+RZ_IPI ut64 rz_cmd_parse_cache_parse_time(RzCmdParseCache *cache) {
+	rz_return_val_if_fail(cache, 0);
+	rz_th_lock_enter(cache->lock);
+	ut64 t = cache->stats.parse_time;
+	rz_th_lock_leave(cache->lock);
+	return t;
+}
+
+/**
+ * Accounts a top-level command executed in \p exec_time microseconds
+ */
+RZ_IPI void rz_cmd_parse_cache_add_exec(RzCmdParseCache *cache, ut64 exec_time) {
+	rz_return_if_fail(cache);
+	rz_th_lock_enter(cache->lock);
+	cache->stats.commands++;
+	cache->stats.exec_time += exec_time;
+	rz_th_lock_leave(cache->lock);
+}
+
+RZ_IPI void rz_cmd_parse_cache_stats(RzCmdParseCache *cache, RzCmdParseStats *stats) {
+	rz_return_if_fail(cache && stats);
+	rz_th_lock_enter(cache->lock);
+	*stats = cache->stats;
+	stats->cached = rz_list_length(cache->lru);
+	stats->capacity = cache->capacity;
+	rz_th_lock_leave(cache->lock);
+}
@@ -0,0 +1,34 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#ifndef RZ_CMD_PARSE_CACHE_H
+#define RZ_CMD_PARSE_CACHE_H
+
+#include <rz_types.h>
+#include <tree_sitter/api.h>
+
+typedef struct rz_cmd_parse_cache_t RzCmdParseCache;
+
+/**
+ * \brief Counters of the shell parser, times are in microseconds
+ */
+typedef struct rz_cmd_parse_stats_t {
+	ut64 parses; ///< inputs parsed
+	ut64 hits; ///< inputs whose tree was found in the cache
+	ut64 parse_time; ///< time spent parsing
+	ut64 commands; ///< top-level commands executed
+	ut64 exec_time; ///< time spent executing the top-level commands, parsing excluded
+	size_t cached; ///< trees in the cache
+	size_t capacity; ///< maximum number of trees in the cache
+} RzCmdParseStats;
+
+RZ_IPI RzCmdParseCache *rz_cmd_parse_cache_new(size_t capacity);
+RZ_IPI void rz_cmd_parse_cache_free(RzCmdParseCache *cache);
+RZ_IPI void rz_cmd_parse_cache_set_capacity(RzCmdParseCache *cache, size_t capacity);
+RZ_IPI void rz_cmd_parse_cache_reset(RzCmdParseCache *cache);
+RZ_IPI TSTree *rz_cmd_parse_cache_parse(RzCmdParseCache *cache, TSParser *parser, const char *input);
+RZ_IPI ut64 rz_cmd_parse_cache_parse_time(RzCmdParseCache *cache);
+RZ_IPI void rz_cmd_parse_cache_add_exec(RzCmdParseCache *cache, ut64 exec_time);
+RZ_IPI void rz_cmd_parse_cache_stats(RzCmdParseCache *cache, RzCmdParseStats *stats);
+
+#endif
@@ -106,7 +106,7 @@ static const char *help_msg_slash_a[] = {
 static const char *help_msg_slash_c[] = {
 	"Usage: /c", "", "Search for crypto materials",
 	"/ca", "", "Search for AES keys expanded in memory",
-	"/cc", "[algo] [digest]", "Find collisions (bruteforce block length values until given checksum is found)",
+	"/cc", "[algo] [digest]", "Find collisions (change the first bytes of the block until given checksum is found, see /cc?)",
 	"/cd", "", "Search for ASN1/DER certificates",
 	"/cr", "", "Search for ASN1/DER private keys (RSA and ECC)",
 	NULL
@@ -130,6 +130,7 @@ static const char *help_msg_slash_R[] = {
 	"/R/", " [filter-by-regexp]", "Show gadgets [regular expression]",
 	"/R/j", " [filter-by-regexp]", "JSON output [regular expression]",
 	"/R/q", " [filter-by-regexp]", "Show gadgets in a quiet manner [regular expression]",
+	"/Ri", "", "Index the gadgets of the search range",
 	"/Rj", " [filter-by-string]", "JSON output",
 	"/Rk", " [select-by-class]", "Query stored ROP gadgets",
 	"/Rq", " [filter-by-string]", "Show gadgets in a quiet manner",
@@ -144,6 +145,15 @@ static const char *help_msg_slash_Rk[] = {
 	NULL
 };
 
+static const char *help_msg_slash_Ri[] = {
+	"Usage: /Ri", "", "Index ROP gadgets",
+	"/Ri", "", "Find, deduplicate and classify the gadgets of the search range",
+	"/Ril", " [type] [class] [+reg] [-reg]", "List the indexed gadgets ending with an instruction of type, of class, writing or not writing reg",
+	"/Rilj", " [type] [class] [+reg] [-reg]", "JSON output",
+	"/Rilq", " [type] [class] [+reg] [-reg]", "List the addresses of the indexed gadgets",
+	NULL
+};
+
 static const char *help_msg_slash_x[] = {
 	"Usage:", "/x [hexpairs]:[binmask]", "Search in memory",
 	"/x ", "9090cd80", "search for those bytes",
@@ -1293,13 +1303,24 @@ static void print_rop(RzCore *core, RzList *hitlist, PJ *pj, int mode) {
 	rz_list_free(ropList);
 }
 
+static int rop_increment(RzCore *core) {
+	const char *arch = rz_config_get(core->config, "asm.arch");
+	if (!strcmp(arch, "mips")) { // MIPS has no jump-in-the-middle
+		return 4;
+	} else if (!strcmp(arch, "arm")) { // ARM has no jump-in-the-middle
+		return rz_config_get_i(core->config, "asm.bits") == 16 ? 2 : 4;
+	} else if (!strcmp(arch, "avr")) { // AVR is halfword aligned.
+		return 2;
+	}
+	return 1;
+}
+
 static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, const char *grep, int regexp, struct search_parameters *param) {
 	const ut8 crop = rz_config_get_i(core->config, "rop.conditional"); // decide if cjmp, cret, and ccall should be used too for the gadget-search
 	const ut8 subchain = rz_config_get_i(core->config, "rop.subchains");
 	const ut8 max_instr = rz_config_get_i(core->config, "rop.len");
-	const char *arch = rz_config_get(core->config, "asm.arch");
 	int max_count = rz_config_get_i(core->config, "search.maxhits");
-	int i = 0, end = 0, mode = 0, increment = 1, ret, result = true;
+	int i = 0, end = 0, mode = 0, increment = rop_increment(core), ret, result = true;
 	RzList /*<endlist_pair>*/ *end_list = rz_list_newf(free);
 	RzList /*<RzRegex>*/ *rx_list = NULL;
 	int align = core->search->align;
@@ -1331,14 +1352,6 @@ static int rz_core_search_rop(RzCore *core, RzInterval search_itv, int opt, cons
 		return false;
 	}
 
-	if (!strcmp(arch, "mips")) { // MIPS has no jump-in-the-middle
-		increment = 4;
-	} else if (!strcmp(arch, "arm")) { // ARM has no jump-in-the-middle
-		increment = rz_config_get_i(core->config, "asm.bits") == 16 ? 2 : 4;
-	} else if (!strcmp(arch, "avr")) { // AVR is halfword aligned.
-		increment = 2;
-	}
-
 	// Options, like JSON, linear, ...
 	grep_arg = strchr(grep, ' ');
 	if (*grep) {
@@ -1568,6 +1581,523 @@ bad:
 	return result;
 }
 
+#define ROP_SHARD_SIZE 0x10000
+
+/**
+ * An instruction decoded while building the gadgets of an end instruction.
+ * The instructions are cached by offset since the chains starting at close
+ * offsets quickly synchronize on the same instructions.
+ */
+typedef struct {
+	ut64 hash; ///< rz_core_rop_insn_hash() of the disassembly
+	ut64 clobbered;
+	ut32 type;
+	ut8 size; ///< 0 when not decoded yet
+	bool valid;
+	bool is_end; ///< can end a gadget, given rop.conditional
+	bool bad_start; ///< can't start a gadget
+} RopInsn;
+
+typedef struct {
+	RzCore *core;
+	const RzCoreRopIndex *index; ///< to look up the clobbered registers
+	RzThreadLock *lock; ///< guards the fields below the options
+	const ut8 *buf;
+	ut64 from;
+	int len;
+	int increment;
+	int max_instr;
+	int ropdepth;
+	int align;
+	bool crop;
+	size_t n_shards;
+	size_t next_shard;
+	bool stop;
+	RzVector /*<RzCoreRopGadget>*/ *shards;
+} RopSweep;
+
+typedef struct {
+	RopSweep *sweep;
+	RzAnalysis *analysis; ///< private decoder of the thread, or the one of the core
+	RopInsn *cache;
+	int cache_size;
+} RopWorker;
+
+static void rop_insn_decode(RopWorker *worker, int off, RopInsn *insn) {
+	RopSweep *sweep = worker->sweep;
+	RzAnalysisOp op;
+	memset(insn, 0, sizeof(*insn));
+	int ret = rz_analysis_op(worker->analysis, &op, sweep->from + off, sweep->buf + off, sweep->len - off,
+		RZ_ANALYSIS_OP_MASK_DISASM | RZ_ANALYSIS_OP_MASK_ESIL);
+	insn->size = ret > 0 && op.size > 0 && op.size <= UT8_MAX ? op.size : 1;
+	insn->valid = ret > 0 && op.size > 0 && op.mnemonic &&
+		rz_str_ncasecmp(op.mnemonic, "invalid", strlen("invalid")) &&
+		rz_str_ncasecmp(op.mnemonic, ".byte", strlen(".byte"));
+	if (insn->valid) {
+		insn->hash = rz_core_rop_insn_hash(op.mnemonic);
+		insn->clobbered = rz_core_rop_index_esil_clobbered(sweep->index, rz_strbuf_get(&op.esil));
+		insn->type = op.type;
+		insn->is_end = is_end_gadget(&op, sweep->crop);
+		insn->bad_start = is_end_gadget(&op, 0) || op.type == RZ_ANALYSIS_OP_TYPE_NOP;
+	}
+	rz_analysis_op_fini(&op);
+}
+
+static void rop_gadget_hash(RzCoreRopGadget *g, const RopInsn *insn) {
+	g->hash = (g->hash ^ insn->hash) * 0x100000001b3ULL;
+	g->clobbered |= insn->clobbered;
+	g->size += insn->size;
+	g->n_instr++;
+}
+
+/**
+ * Builds all the gadgets ending with the instruction at \p end, which is
+ * followed by \p delay instructions in its delay slots.
+ */
+static void rop_gadgets_at(RopWorker *worker, int end, int delay, RzVector *out) {
+	RopSweep *sweep = worker->sweep;
+	RopInsn tail[8];
+	int n_tail = RZ_MIN(delay, (int)RZ_ARRAY_SIZE(tail) - 1) + 1;
+	int at = end;
+	for (int i = 0; i < n_tail; i++) {
+		if (at >= sweep->len) {
+			return;
+		}
+		rop_insn_decode(worker, at, &tail[i]);
+		if (!tail[i].valid) {
+			return;
+		}
+		at += tail[i].size;
+	}
+	int max_body = sweep->max_instr - n_tail;
+	int wstart = end - (RZ_MIN(end, sweep->ropdepth) / sweep->increment) * sweep->increment;
+	int wsize = end - wstart;
+	if (max_body < 1 || !wsize) {
+		return;
+	}
+	if (wsize > worker->cache_size) {
+		RopInsn *cache = realloc(worker->cache, wsize * sizeof(RopInsn));
+		if (!cache) {
+			return;
+		}
+		worker->cache = cache;
+		worker->cache_size = wsize;
+	}
+	memset(worker->cache, 0, wsize * sizeof(RopInsn));
+	for (int start = wstart; start < end; start += sweep->increment) {
+		if (sweep->align && (sweep->from + start) % sweep->align) {
+			continue;
+		}
+		RzCoreRopGadget g = { .addr = sweep->from + start, .hash = 0xcbf29ce484222325ULL, .end_type = tail[0].type };
+		int off = start;
+		while (off < end && g.n_instr < max_body) {
+			RopInsn *insn = &worker->cache[off - wstart];
+			if (!insn->size) {
+				rop_insn_decode(worker, off, insn);
+			}
+			// a gadget can't go through another end instruction
+			if (!insn->valid || insn->is_end || (!g.n_instr && insn->bad_start)) {
+				break;
+			}
+			rop_gadget_hash(&g, insn);
+			off += insn->size;
+		}
+		if (off != end || !g.n_instr) {
+			continue;
+		}
+		for (int i = 0; i < n_tail; i++) {
+			rop_gadget_hash(&g, &tail[i]);
+		}
+		rz_vector_push(out, &g);
+	}
+}
+
+/**
+ * Finds the end instructions in the shard and builds their gadgets.
+ */
+static void rop_sweep_shard(RopWorker *worker, size_t shard, bool check_break) {
+	RopSweep *sweep = worker->sweep;
+	RzVector *out = &sweep->shards[shard];
+	int from = shard * ROP_SHARD_SIZE;
+	int to = RZ_MIN(sweep->len, from + ROP_SHARD_SIZE);
+	for (int i = from; i < to; i += sweep->increment) {
+		if (check_break && rz_cons_is_breaked()) {
+			break;
+		}
+		RzAnalysisOp op;
+		if (rz_analysis_op(worker->analysis, &op, sweep->from + i, sweep->buf + i, sweep->len - i, RZ_ANALYSIS_OP_MASK_BASIC) > 0 &&
+			is_end_gadget(&op, sweep->crop)) {
+			rop_gadgets_at(worker, i, op.delay, out);
+		}
+		rz_analysis_op_fini(&op);
+	}
+}
+
+static RzThreadFunctionRet rop_sweep_thread(RzThread *th) {
+	RopWorker *worker = th->user;
+	RopSweep *sweep = worker->sweep;
+	while (true) {
+		rz_th_lock_enter(sweep->lock);
+		bool stop = sweep->stop || sweep->next_shard >= sweep->n_shards;
+		size_t shard = stop ? 0 : sweep->next_shard++;
+		rz_th_lock_leave(sweep->lock);
+		if (stop) {
+			break;
+		}
+		rop_sweep_shard(worker, shard, false);
+	}
+	return RZ_TH_STOP;
+}
+
+static void rop_sweep_stop(RopSweep *sweep) {
+	rz_th_lock_enter(sweep->lock);
+	sweep->stop = true;
+	rz_th_lock_leave(sweep->lock);
+}
+
+/**
+ * Sweeps the shards with a pool of threads, each one with its own decoder.
+ *
+ * \return false when the threads can't be started and the serial sweep must be used
+ */
+static bool rop_sweep_parallel(RopSweep *sweep, size_t max_threads) {
+	RzThreadPool *pool = rz_th_pool_new(max_threads);
+	RopWorker *workers = pool ? RZ_NEWS0(RopWorker, pool->size) : NULL;
+	bool ret = false;
+	if (!workers) {
+		goto end;
+	}
+	for (size_t i = 0; i < pool->size; i++) {
+		workers[i].sweep = sweep;
+		workers[i].analysis = rz_core_analysis_decoder_new(sweep->core);
+		if (!workers[i].analysis) {
+			RZ_LOG_ERROR("core: cannot initialize the analysis of thread %u.\n", (ut32)i);
+			goto end;
+		}
+	}
+	for (size_t i = 0; i < pool->size; i++) {
+		RzThread *th = rz_th_new(rop_sweep_thread, &workers[i], 0);
+		if (!th) {
+			RZ_LOG_ERROR("core: cannot start thread %u.\n", (ut32)i);
+			// the shards taken by the started threads are done, the others
+			// are swept by the caller
+			rop_sweep_stop(sweep);
+			rz_th_pool_wait(pool);
+			goto end;
+		}
+		rz_th_pool_add_thread(pool, th);
+	}
+	while (!rz_th_pool_wait_async(pool)) {
+		if (rz_cons_is_breaked()) {
+			rop_sweep_stop(sweep);
+			break;
+		}
+		rz_sys_usleep(1000);
+	}
+	// the threads may have not started yet or be still returning
+	rz_th_pool_wait(pool);
+	ret = true;
+end:
+	if (workers) {
+		for (size_t i = 0; i < pool->size; i++) {
+			rz_analysis_free(workers[i].analysis);
+			free(workers[i].cache);
+		}
+		free(workers);
+	}
+	rz_th_pool_free(pool);
+	return ret;
+}
+
+static int rop_gadget_cmp_addr(const void *a, const void *b) {
+	const RzCoreRopGadget *ga = a, *gb = b;
+	return ga->addr < gb->addr ? -1 : ga->addr > gb->addr;
+}
+
+/**
+ * Finds the gadgets of [from, from + len) and adds them to \p index,
+ * shard by shard in address order.
+ */
+static bool rop_index_map(RzCore *core, RzCoreRopIndex *index, ut64 from, const ut8 *buf, int len, size_t max_threads) {
+	RopSweep sweep = {
+		.core = core,
+		.index = index,
+		.buf = buf,
+		.from = from,
+		.len = len,
+		.increment = rop_increment(core),
+		.max_instr = rz_config_get_i(core->config, "rop.len"),
+		.align = core->search->align,
+		.crop = rz_config_get_b(core->config, "rop.conditional"),
+		.n_shards = (len + ROP_SHARD_SIZE - 1) / ROP_SHARD_SIZE,
+	};
+	// x86 and friends have variable length instructions, up to 15 bytes
+	sweep.ropdepth = sweep.increment == 1 ? sweep.max_instr * 15 : sweep.max_instr * sweep.increment;
+	sweep.shards = RZ_NEWS0(RzVector, sweep.n_shards);
+	sweep.lock = rz_th_lock_new(false);
+	if (!sweep.shards || !sweep.lock) {
+		free(sweep.shards);
+		rz_th_lock_free(sweep.lock);
+		return false;
+	}
+	for (size_t i = 0; i < sweep.n_shards; i++) {
+		rz_vector_init(&sweep.shards[i], sizeof(RzCoreRopGadget), NULL, NULL);
+	}
+	if (sweep.n_shards < 2 || !rop_sweep_parallel(&sweep, max_threads)) {
+		RopWorker worker = { .sweep = &sweep, .analysis = core->analysis };
+		for (size_t i = sweep.next_shard; i < sweep.n_shards && !rz_cons_is_breaked(); i++) {
+			rop_sweep_shard(&worker, i, true);
+		}
+		free(worker.cache);
+	}
+	for (size_t i = 0; i < sweep.n_shards; i++) {
+		rz_vector_sort(&sweep.shards[i], rop_gadget_cmp_addr, false);
+		RzCoreRopGadget *g;
+		rz_vector_foreach(&sweep.shards[i], g) {
+			rz_core_rop_index_add(index, g);
+		}
+		rz_vector_fini(&sweep.shards[i]);
+	}
+	free(sweep.shards);
+	rz_th_lock_free(sweep.lock);
+	return true;
+}
+
+/**
+ * Classifies the gadget through ESIL, as /R does with rop.db.
+ */
+static ut32 rop_index_classify(RzCore *core, Sdb *db, const RzCoreRopGadget *g) {
+	ut8 *buf = malloc(g->size);
+	RzList *ropList = rz_list_newf(free);
+	if (!buf || !ropList) {
+		free(buf);
+		rz_list_free(ropList);
+		return 0;
+	}
+	rz_io_read_at(core->io, g->addr, buf, g->size);
+	for (ut32 off = 0; off < g->size;) {
+		RzAnalysisOp op;
+		int ret = rz_analysis_op(core->analysis, &op, g->addr + off, buf + off, g->size - off, RZ_ANALYSIS_OP_MASK_ESIL);
+		if (op.type != RZ_ANALYSIS_OP_TYPE_RET) {
+			rz_list_append(ropList, rz_str_newf(" %s", RZ_STRBUF_SAFEGET(&op.esil)));
+		}
+		rz_analysis_op_fini(&op);
+		off += ret > 0 ? ret : 1;
+	}
+	char key[32];
+	rz_strf(key, "0x%08" PFMT64x, g->addr);
+	ut32 classes = rop_classify(core, db, ropList, key, g->size);
+	rz_list_free(ropList);
+	free(buf);
+	return classes;
+}
+
+/**
+ * Finds the gadgets of the search range and replaces core->rop_index with
+ * them. The gadgets are found by a pool of threads when the analysis plugin
+ * allows it, then they are deduplicated by the hash of their instructions
+ * and, with rop.db, classified through ESIL.
+ */
+static bool rop_index_build(RzCore *core, RzInterval search_itv, struct search_parameters *param) {
+	size_t max_threads = rz_config_get_i(core->config, "rop.threads");
+	if (rz_config_get_i(core->config, "rop.len") <= 1) {
+		eprintf("ROP length (rop.len) must be greater than 1.\n");
+		return false;
+	}
+	if (max_threads != 1 && !rz_core_analysis_decoder_is_reentrant(core)) {
+		max_threads = 1;
+	}
+	RzCoreRopIndex *index = rz_core_rop_index_new();
+	if (!index) {
+		return false;
+	}
+	rz_core_rop_index_set_regs(index, core->analysis->reg);
+	size_t found = 0;
+	bool ret = true;
+	RzListIter *iter;
+	RzIOMap *map;
+	rz_cons_break_push(NULL, NULL);
+	rz_list_foreach (param->boundaries, iter, map) {
+		if (!rz_itv_overlap(search_itv, map->itv) || rz_cons_is_breaked()) {
+			continue;
+		}
+		RzInterval itv = rz_itv_intersect(search_itv, map->itv);
+		if (itv.size > INT_MAX) {
+			RZ_LOG_ERROR("core: cannot index the gadgets of a map larger than 2GB.\n");
+			continue;
+		}
+		ut8 *buf = calloc(1, itv.size);
+		if (!buf) {
+			ret = false;
+			break;
+		}
+		(void)rz_io_read_at(core->io, itv.addr, buf, itv.size);
+		size_t before = rz_vector_len(&index->gadgets);
+		ret = rop_index_map(core, index, itv.addr, buf, (int)itv.size, max_threads);
+		free(buf);
+		if (!ret) {
+			break;
+		}
+		found += rz_vector_len(&index->gadgets) - before;
+	}
+	if (ret && rz_config_get_b(core->config, "rop.db")) {
+		Sdb *db = sdb_ns(core->sdb, "rop", true);
+		RzCoreRopGadget *g;
+		rz_vector_foreach(&index->gadgets, g) {
+			if (rz_cons_is_breaked()) {
+				break;
+			}
+			g->classes = db ? rop_index_classify(core, db, g) : 0;
+		}
+	}
+	rz_cons_break_pop();
+	if (!ret) {
+		rz_core_rop_index_free(index);
+		return false;
+	}
+	ut64 total = 0;
+	RzCoreRopGadget *g;
+	rz_vector_foreach(&index->gadgets, g) {
+		total += g->count;
+	}
+	rz_core_rop_index_free(core->rop_index);
+	core->rop_index = index;
+	rz_cons_printf("%" PFMT64u " gadgets, %u unique\n", total, (ut32)found);
+	return true;
+}
+
+static const char *rop_class_names[] = { "nop", "mov", "const", "arithm", "arithm_ct", NULL };
+
+static bool rop_query_parse(RzCoreRopIndex *index, const char *input, RzCoreRopQuery *query) {
+	query->end_type = UT32_MAX;
+	query->classes = 0;
+	query->clobbered = 0;
+	query->preserved = 0;
+	RzList *args = rz_str_split_duplist(input, " ", true);
+	RzListIter *iter;
+	char *arg;
+	bool ret = true;
+	rz_list_foreach (args, iter, arg) {
+		if (!*arg) {
+			continue;
+		}
+		if (*arg == '+' || *arg == '-') {
+			int bit = rz_core_rop_index_reg(index, arg + 1);
+			if (bit < 0) {
+				RZ_LOG_ERROR("core: register %s is not indexed.\n", arg + 1);
+				ret = false;
+				break;
+			}
+			if (*arg == '+') {
+				query->clobbered |= 1ULL << bit;
+			} else {
+				query->preserved |= 1ULL << bit;
+			}
+			continue;
+		}
+		size_t i;
+		for (i = 0; rop_class_names[i]; i++) {
+			if (!strcmp(arg, rop_class_names[i])) {
+				query->classes |= 1 << i;
+				break;
+			}
+		}
+		if (rop_class_names[i]) {
+			continue;
+		}
+		int type = rz_analysis_optype_from_string(arg);
+		if (type < 0) {
+			RZ_LOG_ERROR("core: invalid gadget type or class %s.\n", arg);
+			ret = false;
+			break;
+		}
+		query->end_type = type;
+	}
+	rz_list_free(args);
+	return ret;
+}
+
+static char *rop_gadget_opcodes(RzCore *core, const RzCoreRopGadget *g) {
+	ut8 *buf = malloc(g->size);
+	if (!buf) {
+		return NULL;
+	}
+	rz_io_read_at(core->io, g->addr, buf, g->size);
+	RzStrBuf *sb = rz_strbuf_new(NULL);
+	for (ut32 off = 0; off < g->size;) {
+		RzAsmOp asmop;
+		rz_asm_set_pc(core->rasm, g->addr + off);
+		int ret = rz_asm_disassemble(core->rasm, &asmop, buf + off, g->size - off);
+		rz_strbuf_appendf(sb, "%s%s;", off ? " " : "", rz_asm_op_get_asm(&asmop));
+		rz_asm_op_fini(&asmop);
+		off += ret > 0 ? ret : 1;
+	}
+	free(buf);
+	return rz_strbuf_drain(sb);
+}
+
+static void rop_index_list(RzCore *core, const char *input, int mode) {
+	RzCoreRopIndex *index = core->rop_index;
+	if (!index) {
+		RZ_LOG_ERROR("core: no gadget has been indexed, use /Ri first.\n");
+		return;
+	}
+	RzCoreRopQuery query;
+	if (!rop_query_parse(index, input, &query)) {
+		return;
+	}
+	RzPVector *res = rz_core_rop_index_query(index, &query);
+	if (!res) {
+		return;
+	}
+	PJ *pj = mode == 'j' ? pj_new() : NULL;
+	if (pj) {
+		pj_a(pj);
+	}
+	void **it;
+	rz_pvector_foreach (res, it) {
+		const RzCoreRopGadget *g = *it;
+		if (mode == 'q') {
+			rz_cons_printf("0x%08" PFMT64x "\n", g->addr);
+			continue;
+		}
+		char *opcodes = rop_gadget_opcodes(core, g);
+		if (pj) {
+			pj_o(pj);
+			pj_kn(pj, "addr", g->addr);
+			pj_kn(pj, "size", g->size);
+			pj_kn(pj, "count", g->count);
+			pj_ks(pj, "type", rz_analysis_optype_to_string(g->end_type));
+			pj_ka(pj, "classes");
+			for (size_t i = 0; rop_class_names[i]; i++) {
+				if (g->classes & (1 << i)) {
+					pj_s(pj, rop_class_names[i]);
+				}
+			}
+			pj_end(pj);
+			pj_ka(pj, "clobbered");
+			for (size_t i = 0; i < rz_pvector_len(&index->regs); i++) {
+				if (g->clobbered & (1ULL << i)) {
+					pj_s(pj, rz_pvector_at(&index->regs, i));
+				}
+			}
+			pj_end(pj);
+			pj_ks(pj, "opcodes", opcodes ? opcodes : "");
+			pj_end(pj);
+		} else {
+			rz_cons_printf("0x%08" PFMT64x " %-5s x%-3u %s\n", g->addr,
+				rz_analysis_optype_to_string(g->end_type), g->count, opcodes ? opcodes : "");
+		}
+		free(opcodes);
+	}
+	if (pj) {
+		pj_end(pj);
+		rz_cons_println(pj_string(pj));
+		pj_free(pj);
+	}
+	rz_pvector_free(res);
+}
+
 static bool esil_addrinfo(RzAnalysisEsil *esil) {
 	RzCore *core = (RzCore *)esil->cb.user;
 	ut64 num = 0;
@@ -2663,177 +3193,53 @@ static ut8 *v_writebuf(RzCore *core, RzList *nums, int len, char ch, int bsize)
 	return buf;
 }
 
-// maybe useful as in util/big.c .?
-static void incBuffer(ut8 *buf, int bufsz) {
-	int i = 0;
-	while (i < bufsz) {
-		buf[i]++;
-		if (!buf[i]) {
-			i++;
-			continue;
-		}
-		break;
-	}
-	// may overflow/hang/end/stop/whatever here
-}
-
-static void incPrintBuffer(ut8 *buf, int bufsz) {
-	int i = 0;
-	while (i < bufsz) {
-		buf[i]++;
-		if (!buf[i]) {
-			i++;
-			continue;
-		}
-		if (IS_PRINTABLE(buf[i])) {
-			break;
-		}
-	}
-}
-
-static void incLowerBuffer(ut8 *buf, int bufsz) {
-	int i = 0;
-	while (i < bufsz) {
-		buf[i]++;
-		if (buf[i] && isalpha(buf[i]) && islower(buf[i])) {
-			break;
-		}
-		if (!buf[i]) {
-			i++;
-			continue;
-		}
-	}
-}
-
-static void incUpperBuffer(ut8 *buf, int bufsz) {
-	int i = 0;
-	while (i < bufsz) {
-		buf[i]++;
-		if (buf[i] && isalpha(buf[i]) && isupper(buf[i])) {
-			break;
-		}
-		if (!buf[i]) {
-			i++;
-			continue;
-		}
-	}
-}
-
-static void incAlphaBuffer(ut8 *buf, int bufsz) {
-	int i = 0;
-	while (i < bufsz) {
-		buf[i]++;
-		if (buf[i] && isalpha(buf[i])) {
-			break;
-		}
-		if (!buf[i]) {
-			i++;
-			continue;
-		}
-	}
-	// may overflow/hang/end/stop/whatever here
-}
-
-static void incDigitBuffer(ut8 *buf, int bufsz) {
-	int i = 0;
-	while (i < bufsz) {
-		buf[i]++;
-		if (buf[i] && isdigit(buf[i])) {
-			break;
-		}
-		if (!buf[i]) {
-			i++;
-			continue;
-		}
+static const char *collision_charset(int mode) {
+	switch (mode) {
+	case 'p': // digits+alpha
+		return "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+	case 'a': // lowercase alpha
+		return "abcdefghijklmnopqrstuvwxyz";
+	case 'A': // uppercase alpha
+		return "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+	case 'l': // letters
+		return "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+	case 'd': // digits
+		return "0123456789";
+	default: // binary
+		return NULL;
 	}
-	// may overflow/hang/end/stop/whatever here
 }
 
 static void search_collisions(RzCore *core, const char *hashName, const ut8 *hashValue, int hashLength, int mode) {
-	ut8 RZ_ALIGNED(8) cmphash[128];
-	const RzMsgDigestPlugin *crc32 = rz_msg_digest_plugin_by_name("crc32");
-	ut8 *digest = NULL;
-
-	int i = 0;
-	int bufsz = core->blocksize;
-	ut8 *buf = calloc(1, bufsz);
-	if (!buf) {
-		return;
-	}
-	memcpy(buf, core->block, bufsz);
-	if (hashLength > sizeof(cmphash)) {
-		eprintf("Hashlength mismatch %d %d\n", hashLength, (int)sizeof(cmphash));
-		free(buf);
+	if (strcmp(hashName, "crc32")) {
+		eprintf("Only crc32 collisions can be searched\n");
 		return;
 	}
-	memcpy(cmphash, hashValue, hashLength);
-
 	if (hashLength != 4) {
 		eprintf("Invalid hash size %d (expected 4)\n", hashLength);
-		free(buf);
 		return;
 	}
-
-	rz_cons_break_push(NULL, NULL);
-	ut64 prev = rz_time_now_mono();
-	ut64 inc = 0;
-	int amount = 0;
-	int mount = 0;
-	while (!rz_cons_is_breaked()) {
-		ut64 now = rz_time_now_mono();
-		if (now < (prev + 1000000)) {
-			amount++;
-		} else {
-			mount += amount;
-			mount /= 2;
-			amount = 0;
-			prev = now;
-		}
-		switch (mode) {
-		case 'p': // digits+alpha
-			incPrintBuffer(buf, bufsz);
-			break;
-		case 'a': // lowercase alpha
-			incLowerBuffer(buf, bufsz);
-			break;
-		case 'A': // uppercase alpha
-			incUpperBuffer(buf, bufsz);
-			break;
-		case 'l': // letters
-			incAlphaBuffer(buf, bufsz);
-			break;
-		case 'd': // digits
-			incDigitBuffer(buf, bufsz);
-			break;
-		default: // binary
-			incBuffer(buf, bufsz);
-			break;
-		}
-
-		eprintf("0x%08" PFMT64x " input:", inc);
-		for (i = 0; i < bufsz; i++) {
-			eprintf("%02x", buf[i]);
-		}
-		if (mode) {
-			eprintf(" \"%s\"", buf);
-		}
-
-		crc32->small_block(buf, bufsz, &digest, NULL);
-
-		eprintf(" digest:");
-		for (i = 0; i < hashLength; i++) {
-			eprintf("%02x", digest[i]);
-		}
-		eprintf(" (%d h/s)  \r", mount);
-		if (!memcmp(hashValue, digest, hashLength)) {
-			eprintf("\nCOLLISION FOUND!\n");
-			rz_print_hexdump(core->print, core->offset, buf, bufsz, 0, 16, 0);
-			rz_cons_flush();
-		}
-		RZ_FREE(digest);
-		inc++;
+	int bufsz = core->blocksize;
+	if (bufsz < 4) {
+		eprintf("The block size must be at least 4 bytes\n");
+		return;
 	}
+	ut8 *buf = rz_mem_dup(core->block, bufsz);
+	if (!buf) {
+		return;
+	}
+	const char *charset = collision_charset(mode);
+	size_t max_threads = rz_config_get_i(core->config, "search.collisions.threads");
+	rz_cons_break_push(NULL, NULL);
+	bool found = rz_hash_crc32_collide(buf, bufsz, rz_read_be32(hashValue), charset, max_threads, rz_cons_is_breaked);
 	rz_cons_break_pop();
+	if (found) {
+		eprintf("COLLISION FOUND!\n");
+		rz_print_hexdump(core->print, core->offset, buf, bufsz, 0, 16, 0);
+		rz_cons_flush();
+	} else {
+		eprintf("No collision found\n");
+	}
 	free(buf);
 }
 
@@ -3041,6 +3447,15 @@ reread:
 			} else {
 				rop_kuery(core, input + 2, param.pj);
 			}
+		} else if (input[1] == 'i') {
+			if (input[2] == 'l') {
+				int mode = input[3] == 'j' || input[3] == 'q' ? input[3] : 0;
+				rop_index_list(core, input + (mode ? 4 : 3), mode);
+			} else if (!input[2] || input[2] == ' ') {
+				rop_index_build(core, search_itv, &param);
+			} else {
+				rz_core_cmd_help(core, help_msg_slash_Ri);
+			}
 		} else {
 			Sdb *gadgetSdb = sdb_ns(core->sdb, "gadget_sdb", false);
 
@@ -3236,6 +3651,7 @@ reread:
 			const char *arg = space ? rz_str_trim_head_ro(space + 1) : NULL;
 			if (!arg || input[2] == '?') {
 				eprintf("Usage: /cc[aAdlpb] [hashname] [hexpairhashvalue]\n");
+				eprintf(" Changes the first bytes of the block, only crc32 is supported\n");
 				eprintf(" /cca - lowercase alphabet chars only\n");
 				eprintf(" /ccA - uppercase alphabet chars only\n");
 				eprintf(" /ccl - letters (lower + upper alphabet chars)\n");
@@ -3257,7 +3673,7 @@ reread:
 						// TODO: support bigger hashes
 						int hashLength = 4;
 						ut32 n = (ut32)rz_num_get(NULL, (const char *)hashValue);
-						memcpy(hashValue, (const ut8 *)&n, sizeof(ut32));
+						rz_write_be32(hashValue, n);
 						search_collisions(core, hashName, hashValue, hashLength, mode);
 					} else {
 						int hashLength = rz_hex_str2bin(sp, hashValue);
@@ -3334,39 +3750,29 @@ reread:
 			cmd_search_bin(core, search_itv);
 			rz_config_set_i(core->config, "bin.verbose", bin_verbose);
 		} else if (input[1] == ' ' || input[1] == '\0' || param.outmode == RZ_MODE_JSON) {
-			int ret;
 			const char *file = input[param_offset - 1] ? input + param_offset : NULL;
-			ut64 addr = search_itv.addr;
 			RzListIter *iter;
 			RzIOMap *map;
 			if (param.outmode == RZ_MODE_JSON) {
 				pj_a(param.pj);
 			}
 			rz_core_magic_reset(core);
-			int maxHits = rz_config_get_i(core->config, "search.maxhits");
 			int hits = 0;
+			// cmd.hit may change anything the prefilter relies on
+			const char *cmdhit = rz_config_get(core->config, "cmd.hit");
+			RzMagic *pf_magic = NULL;
+			RzMagicPrefilter *pf = RZ_STR_ISEMPTY(cmdhit) ? core_magic_prefilter_new(core, file, &pf_magic) : NULL;
 			rz_list_foreach (param.boundaries, iter, map) {
 				if (param.outmode != RZ_MODE_JSON) {
 					eprintf("-- %llx %llx\n", map->itv.addr, rz_itv_end(map->itv));
 				}
 				rz_cons_break_push(NULL, NULL);
-				for (addr = map->itv.addr; addr < rz_itv_end(map->itv); addr++) {
-					if (rz_cons_is_breaked()) {
-						break;
-					}
-					ret = rz_core_magic_at(core, file, addr, 99, false, param.outmode == RZ_MODE_JSON ? param.pj : NULL, &hits);
-					if (ret == -1) {
-						// something went terribly wrong.
-						break;
-					}
-					if (maxHits && hits >= maxHits) {
-						break;
-					}
-					addr += ret - 1;
-				}
+				core_magic_search(core, file, map->itv, pf, param.outmode == RZ_MODE_JSON ? param.pj : NULL, &hits);
 				rz_cons_clear_line(1);
 				rz_cons_break_pop();
 			}
+			rz_magic_prefilter_free(pf);
+			rz_magic_free(pf_magic);
 			if (param.outmode == RZ_MODE_JSON) {
 				pj_end(param.pj);
 			}
@@ -673,7 +673,12 @@ static int rop_classify_nops(RzCore *core, RzList *ropList) {
 	return changes;
 }
 
-static void rop_classify(RzCore *core, Sdb *db, RzList *ropList, const char *key, unsigned int size) {
+/**
+ * Stores the classes of the gadget at \p key into \p db and returns them
+ * as RzCoreRopClass flags.
+ */
+static ut32 rop_classify(RzCore *core, Sdb *db, RzList *ropList, const char *key, unsigned int size) {
+	ut32 classes = 0;
 	int nop = 0;
 	rop_classify_nops(core, ropList);
 	char *mov, *ct, *arithm, *arithm_ct, *str;
@@ -685,7 +690,7 @@ static void rop_classify(RzCore *core, Sdb *db, RzList *ropList, const char *key
 
 	if (!db_nop || !db_mov || !db_ct || !db_aritm || !db_aritm_ct) {
 		eprintf("Error: Could not create SDB 'rop' sub-namespaces\n");
-		return;
+		return 0;
 	}
 	nop = rop_classify_nops(core, ropList);
 	mov = rop_classify_mov(core, ropList);
@@ -698,32 +703,38 @@ static void rop_classify(RzCore *core, Sdb *db, RzList *ropList, const char *key
 		char *str_nop = rz_str_newf("%s NOP", str);
 		sdb_set(db_nop, key, str_nop, 0);
 		free(str_nop);
+		classes |= RZ_CORE_ROP_CLASS_NOP;
 	} else {
 		if (mov) {
 			char *str_mov = rz_str_newf("%s MOV { %s }", str, mov);
 			sdb_set(db_mov, key, str_mov, 0);
 			free(str_mov);
 			free(mov);
+			classes |= RZ_CORE_ROP_CLASS_MOV;
 		}
 		if (ct) {
 			char *str_ct = rz_str_newf("%s LOAD_CONST { %s }", str, ct);
 			sdb_set(db_ct, key, str_ct, 0);
 			free(str_ct);
 			free(ct);
+			classes |= RZ_CORE_ROP_CLASS_CONST;
 		}
 		if (arithm) {
 			char *str_arithm = rz_str_newf("%s ARITHMETIC { %s }", str, arithm);
 			sdb_set(db_aritm, key, str_arithm, 0);
 			free(str_arithm);
 			free(arithm);
+			classes |= RZ_CORE_ROP_CLASS_ARITHM;
 		}
 		if (arithm_ct) {
 			char *str_arithm_ct = rz_str_newf("%s ARITHMETIC_CONST { %s }", str, arithm_ct);
 			sdb_set(db_aritm_ct, key, str_arithm_ct, 0);
 			free(str_arithm_ct);
 			free(arithm_ct);
+			classes |= RZ_CORE_ROP_CLASS_ARITHM_CT;
 		}
 	}
 
 	free(str);
+	return classes;
 }
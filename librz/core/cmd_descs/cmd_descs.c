@@ -5610,6 +5610,25 @@ static const RzCmdDescHelp history_save_help = {
 	.args = history_save_args,
 };
 
+static const RzCmdDescHelp Hp_help = {
+	.summary = "Statistics and cache of the parsed commands",
+};
+static const RzCmdDescArg parse_stats_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp parse_stats_help = {
+	.summary = "Shows the time spent parsing and executing the commands",
+	.args = parse_stats_args,
+};
+
+static const RzCmdDescArg parse_stats_reset_args[] = {
+	{ 0 },
+};
+static const RzCmdDescHelp parse_stats_reset_help = {
+	.summary = "Resets the parsing statistics and clears the cache of the parsed commands",
+	.args = parse_stats_reset_args,
+};
+
 static const RzCmdDescHelp i_help = {
 	.summary = "Get info about opened binary file",
 };
@@ -10454,6 +10473,11 @@ RZ_IPI void rzshell_cmddescs_init(RzCore *core) {
 	RzCmdDesc *history_save_cd = rz_cmd_desc_argv_new(core->rcmd, H_cd, "H+", rz_history_save_handler, &history_save_help);
 	rz_warn_if_fail(history_save_cd);
 
+	RzCmdDesc *Hp_cd = rz_cmd_desc_group_state_new(core->rcmd, H_cd, "Hp", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_JSON, rz_parse_stats_handler, &parse_stats_help, &Hp_help);
+	rz_warn_if_fail(Hp_cd);
+	RzCmdDesc *parse_stats_reset_cd = rz_cmd_desc_argv_new(core->rcmd, Hp_cd, "Hp-", rz_parse_stats_reset_handler, &parse_stats_reset_help);
+	rz_warn_if_fail(parse_stats_reset_cd);
+
 	RzCmdDesc *i_cd = rz_cmd_desc_group_state_new(core->rcmd, root_cd, "i", RZ_OUTPUT_MODE_QUIET | RZ_OUTPUT_MODE_TABLE | RZ_OUTPUT_MODE_JSON, rz_cmd_info_handler, &cmd_info_help, &i_help);
 	rz_warn_if_fail(i_cd);
 	rz_cmd_desc_set_default_mode(i_cd, RZ_OUTPUT_MODE_TABLE);
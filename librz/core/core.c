@@ -99,19 +99,21 @@ RZ_API RzBinReloc *rz_core_getreloc(RzCore *core, ut64 addr, int size) {
 		return NULL;
 	}
 	RzBinFile *bf = rz_bin_cur(core->bin);
-	if (!bf || !bf->o || !bf->o->relocs) {
+	RzBinRelocStorage *relocs = bf && bf->o ? rz_bin_object_get_relocs(bf->o) : NULL;
+	if (!relocs) {
 		return NULL;
 	}
-	return rz_bin_reloc_storage_get_reloc_in(bf->o->relocs, addr, size);
+	return rz_bin_reloc_storage_get_reloc_in(relocs, addr, size);
 }
 
 RZ_API RzBinReloc *rz_core_get_reloc_to(RzCore *core, ut64 addr) {
 	rz_return_val_if_fail(core, NULL);
 	RzBinFile *bf = rz_bin_cur(core->bin);
-	if (!bf || !bf->o || !bf->o->relocs) {
+	RzBinRelocStorage *relocs = bf && bf->o ? rz_bin_object_get_relocs(bf->o) : NULL;
+	if (!relocs) {
 		return NULL;
 	}
-	return rz_bin_reloc_storage_get_reloc_to(bf->o->relocs, addr);
+	return rz_bin_reloc_storage_get_reloc_to(relocs, addr);
 }
 
 /* returns the address of a jmp/call given a shortcut by the user or UT64_MAX
@@ -777,7 +779,12 @@ static ut64 num_callback(RzNum *userptr, const char *str, int *ok) {
 				...
 			}
 #endif
-			if ((flag = rz_flag_get(core->flags, str))) {
+			flag = rz_flag_get(core->flags, str);
+			if (!flag && core->bin_pending && rz_core_bin_apply_pending(core)) {
+				// the name can be one of the symbols not applied yet
+				flag = rz_flag_get(core->flags, str);
+			}
+			if (flag) {
 				ret = flag->offset;
 				if (ok) {
 					*ok = true;
@@ -2313,6 +2320,7 @@ static int win_eprintf(const char *format, ...) {
 static void ev_iowrite_cb(RzEvent *ev, int type, void *user, void *data) {
 	RzCore *core = user;
 	RzEventIOWrite *iow = data;
+	rz_core_heap_snapshot_invalidate(core);
 	if (rz_config_get_i(core->config, "analysis.detectwrites")) {
 		rz_analysis_update_analysis_range(core->analysis, iow->addr, iow->len);
 		if (core->cons->event_resize && core->cons->event_data) {
@@ -2329,11 +2337,13 @@ RZ_IPI void rz_core_vfile_bin_file_deleted(RzCore *core, RzBinFile *bf);
 
 static void ev_iodescclose_cb(RzEvent *ev, int type, void *user, void *data) {
 	RzEventIODescClose *ioc = data;
+	rz_core_heap_snapshot_invalidate(user);
 	rz_core_file_io_desc_closed(user, ioc->desc);
 }
 
 static void ev_iomapdel_cb(RzEvent *ev, int type, void *user, void *data) {
 	RzEventIOMapDel *iod = data;
+	rz_core_heap_snapshot_invalidate(user);
 	rz_core_file_io_map_deleted(user, iod->map);
 }
 
@@ -2599,6 +2609,9 @@ RZ_API void rz_core_fini(RzCore *c) {
 	// update_sdb (c);
 	//  avoid double free
 	rz_list_free(c->ropchain);
+	rz_core_rop_index_free(c->rop_index);
+	rz_core_heap_snapshot_free(c->heap_snapshot);
+	c->heap_snapshot = NULL;
 	rz_event_free(c->ev);
 	free(c->cmdlog);
 	free(c->lastsearch);
@@ -2796,6 +2809,7 @@ RZ_API int rz_core_prompt(RzCore *r, int sync) {
 	char line[4096];
 
 	int rnv = r->num->value;
+	rz_core_bin_apply_pending(r);
 	set_prompt(r);
 	int ret = rz_cons_fgets(line, sizeof(line), 0, NULL);
 	if (ret == -2) {
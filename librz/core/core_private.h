@@ -49,6 +49,11 @@ RZ_IPI void rz_core_analysis_bbs_info_print(RzCore *core, RzAnalysisFunction *fc
 RZ_IPI void rz_core_analysis_bb_info_print(RzCore *core, RzAnalysisBlock *bb, ut64 addr, RzCmdStateOutput *state);
 RZ_IPI void rz_core_analysis_function_until(RzCore *core, ut64 addr_end);
 RZ_IPI void rz_core_analysis_value_pointers(RzCore *core, RzOutputMode mode);
+RZ_IPI bool rz_core_analysis_decoder_is_reentrant(RzCore *core);
+RZ_IPI RzAnalysis *rz_core_analysis_decoder_new(RzCore *core);
+
+/* analysis_tp.c */
+RZ_IPI void rz_core_analysis_type_match_all(RzCore *core, RZ_NONNULL const ut8 *arena, size_t max_threads);
 
 /* cmeta.c */
 RZ_IPI void rz_core_meta_print(RzCore *core, RzAnalysisMetaItem *d, ut64 start, ut64 size, bool show_full, RzCmdStateOutput *state);
@@ -136,6 +141,9 @@ RZ_IPI void rz_core_debug_print_status(RzCore *core);
 RZ_IPI void rz_core_io_file_open(RzCore *core, int fd);
 RZ_IPI void rz_core_io_file_reopen(RzCore *core, int fd, int perms);
 
+/* cmd.c */
+RZ_IPI void rz_core_cmd_parse_cache_set_size(RzCore *core, size_t size);
+
 /* cmd_seek.c */
 
 RZ_IPI bool rz_core_seek_to_register(RzCore *core, const char *input, bool is_silent);
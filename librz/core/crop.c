@@ -0,0 +1,341 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_core.h>
+
+/*
+ * SDB Format of a saved index:
+ *
+ * /rop
+ *   regs=<comma-separated names of the registers of the clobbered bits>
+ *   gadgets=<base64 of the packed gadgets, ROP_RECORD_SIZE bytes each>
+ */
+
+#define ROP_RECORD_SIZE 41
+#define ROP_MAX_REGS    64
+
+#define FNV64_OFFSET 0xcbf29ce484222325ULL
+#define FNV64_PRIME  0x100000001b3ULL
+
+RZ_API RZ_OWN RzCoreRopIndex *rz_core_rop_index_new(void) {
+	RzCoreRopIndex *index = RZ_NEW0(RzCoreRopIndex);
+	if (!index) {
+		return NULL;
+	}
+	rz_vector_init(&index->gadgets, sizeof(RzCoreRopGadget), NULL, NULL);
+	rz_pvector_init(&index->regs, free);
+	index->by_hash = ht_uu_new0();
+	if (!index->by_hash) {
+		rz_core_rop_index_free(index);
+		return NULL;
+	}
+	return index;
+}
+
+RZ_API void rz_core_rop_index_free(RZ_NULLABLE RzCoreRopIndex *index) {
+	if (!index) {
+		return;
+	}
+	rz_vector_fini(&index->gadgets);
+	rz_pvector_fini(&index->regs);
+	ht_uu_free(index->by_hash);
+	ht_pu_free(index->reg_bits);
+	free(index);
+}
+
+static bool reg_contains(const RzRegItem *full, const RzRegItem *item) {
+	return full->arena == item->arena && item->offset >= full->offset && item->offset < full->offset + full->size;
+}
+
+/**
+ * \brief Assigns the clobbered bits to the full-width general purpose
+ * registers of \p reg, excluding the program counter
+ *
+ * The sub-registers (e.g. eax or al for rax) are mapped to the bit of the
+ * register containing them. Must be called before adding any gadget.
+ */
+RZ_API void rz_core_rop_index_set_regs(RZ_NONNULL RzCoreRopIndex *index, RZ_NONNULL RzReg *reg) {
+	rz_return_if_fail(index && reg);
+	rz_pvector_clear(&index->regs);
+	ht_pu_free(index->reg_bits);
+	index->reg_bits = ht_pu_new0();
+	if (!index->reg_bits) {
+		return;
+	}
+	const char *pc_name = rz_reg_get_name(reg, RZ_REG_NAME_PC);
+	RzRegItem *pc = pc_name ? rz_reg_get(reg, pc_name, -1) : NULL;
+	if (!pc) {
+		return;
+	}
+	int width = pc->size;
+	const RzList *gprs = rz_reg_get_list(reg, RZ_REG_TYPE_GPR);
+	RzRegItem *full[ROP_MAX_REGS];
+	RzListIter *iter;
+	RzRegItem *item;
+	rz_list_foreach (gprs, iter, item) {
+		if (item->size != width || item == pc || rz_pvector_len(&index->regs) >= ROP_MAX_REGS) {
+			continue;
+		}
+		full[rz_pvector_len(&index->regs)] = item;
+		rz_pvector_push(&index->regs, strdup(item->name));
+		ht_pu_insert(index->reg_bits, item->name, rz_pvector_len(&index->regs));
+	}
+	rz_list_foreach (gprs, iter, item) {
+		if (item->size >= width) {
+			continue;
+		}
+		for (size_t i = 0; i < rz_pvector_len(&index->regs); i++) {
+			if (reg_contains(full[i], item)) {
+				ht_pu_insert(index->reg_bits, item->name, i + 1);
+				break;
+			}
+		}
+	}
+}
+
+/**
+ * \brief Returns the bit of the register \p name or -1 when it is not indexed
+ */
+RZ_API int rz_core_rop_index_reg(RZ_NONNULL const RzCoreRopIndex *index, RZ_NONNULL const char *name) {
+	rz_return_val_if_fail(index && name, -1);
+	if (index->reg_bits) {
+		bool found = false;
+		ut64 bit = ht_pu_find(index->reg_bits, name, &found);
+		return found ? (int)bit - 1 : -1;
+	}
+	// a loaded index has only the names of the full registers
+	for (size_t i = 0; i < rz_pvector_len(&index->regs); i++) {
+		if (!strcmp(rz_pvector_at(&index->regs, i), name)) {
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+static bool esil_is_assignment(const char *tok, size_t len) {
+	if (!len || tok[len - 1] != '=' || isalnum((ut8)tok[0]) || tok[0] == '$') {
+		return false;
+	}
+	if (len == 2 && (tok[0] == '=' || tok[0] == '<' || tok[0] == '>' || tok[0] == '!')) {
+		// comparisons
+		return false;
+	}
+	return true;
+}
+
+/**
+ * \brief Returns the bits of the registers written by the \p esil expression
+ *
+ * Only the lookups of rz_core_rop_index_set_regs() are used, so this can be
+ * called from many threads at once.
+ */
+RZ_API ut64 rz_core_rop_index_esil_clobbered(RZ_NONNULL const RzCoreRopIndex *index, RZ_NONNULL const char *esil) {
+	rz_return_val_if_fail(index && esil, 0);
+	if (!index->reg_bits) {
+		return 0;
+	}
+	ut64 clobbered = 0;
+	char prev[64] = { 0 };
+	const char *tok = esil;
+	while (*tok) {
+		const char *end = strchr(tok, ',');
+		size_t len = end ? end - tok : strlen(tok);
+		if (esil_is_assignment(tok, len) && *prev) {
+			bool found = false;
+			ut64 bit = ht_pu_find(index->reg_bits, prev, &found);
+			if (found) {
+				clobbered |= 1ULL << (bit - 1);
+			}
+		}
+		if (len < sizeof(prev)) {
+			memcpy(prev, tok, len);
+			prev[len] = 0;
+		} else {
+			prev[0] = 0;
+		}
+		if (!end) {
+			break;
+		}
+		tok = end + 1;
+	}
+	return clobbered;
+}
+
+/**
+ * \brief Adds \p gadget to the index, unless one with the same hash is there
+ *
+ * \return true if the gadget has been added, false if it was a duplicate,
+ *         which is counted in the gadget already in the index
+ */
+RZ_API bool rz_core_rop_index_add(RZ_NONNULL RzCoreRopIndex *index, RZ_NONNULL const RzCoreRopGadget *gadget) {
+	rz_return_val_if_fail(index && gadget, false);
+	bool found = false;
+	ut64 idx = ht_uu_find(index->by_hash, gadget->hash, &found);
+	if (found) {
+		RzCoreRopGadget *dup = rz_vector_index_ptr(&index->gadgets, idx);
+		dup->count += RZ_MAX(gadget->count, 1);
+		return false;
+	}
+	RzCoreRopGadget *g = rz_vector_push(&index->gadgets, (void *)gadget);
+	if (!g) {
+		return false;
+	}
+	g->count = RZ_MAX(g->count, 1);
+	ht_uu_insert(index->by_hash, g->hash, rz_vector_len(&index->gadgets) - 1);
+	return true;
+}
+
+/**
+ * \brief Returns the gadgets matching all the conditions of \p query
+ *
+ * The returned vector points into the index, so it is valid only until the
+ * next gadget is added.
+ */
+RZ_API RZ_OWN RzPVector /*<RzCoreRopGadget *>*/ *rz_core_rop_index_query(RZ_NONNULL RzCoreRopIndex *index, RZ_NONNULL const RzCoreRopQuery *query) {
+	rz_return_val_if_fail(index && query, NULL);
+	RzPVector *res = rz_pvector_new(NULL);
+	if (!res) {
+		return NULL;
+	}
+	RzCoreRopGadget *g;
+	rz_vector_foreach(&index->gadgets, g) {
+		if ((query->end_type != UT32_MAX && g->end_type != query->end_type) ||
+			(g->classes & query->classes) != query->classes ||
+			(g->clobbered & query->clobbered) != query->clobbered ||
+			(g->clobbered & query->preserved)) {
+			continue;
+		}
+		rz_pvector_push(res, g);
+	}
+	return res;
+}
+
+/**
+ * \brief Saves \p index into \p db, as a single binary record per gadget
+ *
+ * The number of gadgets is saved too, since sdb does not keep empty values.
+ */
+RZ_API void rz_core_rop_index_save(RZ_NONNULL Sdb *db, RZ_NONNULL const RzCoreRopIndex *index) {
+	rz_return_if_fail(index && db);
+	sdb_num_set(db, "count", rz_vector_len(&index->gadgets), 0);
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	for (size_t i = 0; i < rz_pvector_len(&index->regs); i++) {
+		if (i) {
+			rz_strbuf_append(&sb, ",");
+		}
+		rz_strbuf_append(&sb, rz_pvector_at(&index->regs, i));
+	}
+	if (rz_strbuf_length(&sb)) {
+		sdb_set(db, "regs", rz_strbuf_get(&sb), 0);
+	} else {
+		sdb_unset(db, "regs", 0);
+	}
+	rz_strbuf_fini(&sb);
+
+	size_t size = rz_vector_len(&index->gadgets) * ROP_RECORD_SIZE;
+	if (!size) {
+		sdb_unset(db, "gadgets", 0);
+		return;
+	}
+	ut8 *buf = malloc(RZ_MAX(size, 1));
+	if (!buf) {
+		return;
+	}
+	ut8 *p = buf;
+	RzCoreRopGadget *g;
+	rz_vector_foreach(&index->gadgets, g) {
+		rz_write_le64(p, g->addr);
+		rz_write_le64(p + 8, g->hash);
+		rz_write_le64(p + 16, g->clobbered);
+		rz_write_le32(p + 24, g->size);
+		rz_write_le32(p + 28, g->end_type);
+		rz_write_le32(p + 32, g->classes);
+		rz_write_le32(p + 36, g->count);
+		p[40] = g->n_instr;
+		p += ROP_RECORD_SIZE;
+	}
+	char *b64 = rz_base64_encode_dyn(buf, size);
+	if (b64) {
+		sdb_set(db, "gadgets", b64, 0);
+	} else {
+		sdb_unset(db, "gadgets", 0);
+	}
+	free(b64);
+	free(buf);
+}
+
+/**
+ * \brief Loads an index saved by rz_core_rop_index_save()
+ *
+ * The clobbered registers can be looked up only by the names of the full
+ * registers until rz_core_rop_index_set_regs() is called again. Missing
+ * registers or gadgets are loaded as empty.
+ */
+RZ_API RZ_OWN RzCoreRopIndex *rz_core_rop_index_load(RZ_NONNULL Sdb *db) {
+	rz_return_val_if_fail(db, NULL);
+	const char *regs = sdb_const_get(db, "regs", 0);
+	const char *b64 = sdb_const_get(db, "gadgets", 0);
+	ut64 count = sdb_num_get(db, "count", 0);
+	RzCoreRopIndex *index = rz_core_rop_index_new();
+	if (!index) {
+		return NULL;
+	}
+	RzList *names = rz_str_split_duplist(regs ? regs : "", ",", true);
+	RzListIter *iter;
+	char *name;
+	rz_list_foreach (names, iter, name) {
+		if (*name && rz_pvector_len(&index->regs) < ROP_MAX_REGS) {
+			rz_pvector_push(&index->regs, strdup(name));
+		}
+	}
+	rz_list_free(names);
+
+	size_t len = b64 ? strlen(b64) : 0;
+	ut8 *buf = malloc(len / 4 * 3 + 3);
+	int size = buf && len ? rz_base64_decode(buf, b64, (int)len) : 0;
+	if (!buf || size < 0 || size % ROP_RECORD_SIZE || size / ROP_RECORD_SIZE != count) {
+		RZ_LOG_ERROR("core: invalid saved ROP gadget index\n");
+		free(buf);
+		rz_core_rop_index_free(index);
+		return NULL;
+	}
+	for (const ut8 *p = buf; p < buf + size; p += ROP_RECORD_SIZE) {
+		RzCoreRopGadget g = {
+			.addr = rz_read_le64(p),
+			.hash = rz_read_le64(p + 8),
+			.clobbered = rz_read_le64(p + 16),
+			.size = rz_read_le32(p + 24),
+			.end_type = rz_read_le32(p + 28),
+			.classes = rz_read_le32(p + 32),
+			.count = rz_read_le32(p + 36),
+			.n_instr = p[40],
+		};
+		rz_core_rop_index_add(index, &g);
+	}
+	free(buf);
+	return index;
+}
+
+/**
+ * \brief Hashes the disassembly of an instruction, ignoring the case and
+ * the amount of whitespace, so equal instructions get the same hash
+ */
+RZ_API ut64 rz_core_rop_insn_hash(RZ_NONNULL const char *opstr) {
+	rz_return_val_if_fail(opstr, 0);
+	ut64 h = FNV64_OFFSET;
+	bool space = false;
+	for (; *opstr; opstr++) {
+		ut8 c = *opstr;
+		if (isspace(c)) {
+			space = true;
+			continue;
+		}
+		if (space && h != FNV64_OFFSET) {
+			h = (h ^ ' ') * FNV64_PRIME;
+		}
+		space = false;
+		h = (h ^ tolower(c)) * FNV64_PRIME;
+	}
+	return h;
+}
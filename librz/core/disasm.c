@@ -70,6 +70,26 @@ static const char *rz_vline_uc[] = {
 #define DS_PRE_FCN_MIDDLE 3
 #define DS_PRE_FCN_TAIL   4
 
+#define DS_ANNOTS_MAX_SIZE (1ULL << 24)
+
+#define DS_ANNOT_FLAG    (1 << 0) ///< a flag is at the address
+#define DS_ANNOT_META_AT (1 << 1) ///< a metadata item starts at the address
+#define DS_ANNOT_META_IN (1 << 2) ///< a metadata item contains the address
+#define DS_ANNOT_BLOCK   (1 << 3) ///< a basic block contains the address
+
+/**
+ * Annotations of the addresses being disassembled, collected with a single
+ * range query per store before printing. The lines without flags, metadata
+ * or functions skip looking them up, which is most of them.
+ */
+typedef struct {
+	ut64 from; ///< first address of the window
+	ut64 size; ///< number of addresses in the window
+	ut8 *marks; ///< DS_ANNOT_* of each address, NULL if nothing was prefetched
+	RzPVector /*<RzBinSection *>*/ *sections; ///< sections intersecting the window, in the order of the object
+	bool sections_va; ///< whether sections were matched by virtual address
+} DisasmAnnots;
+
 // TODO: what about using bit shifting and enum for keys? see librz/util/bitmap.c
 // the problem of this is that the fields will be more opaque to bindings, but we will earn some bits
 typedef struct {
@@ -294,6 +314,7 @@ typedef struct {
 	const char *strip;
 	int maxflags;
 	int asm_types;
+	DisasmAnnots annots;
 } RDisasmState;
 
 static void ds_setup_print_pre(RDisasmState *ds, bool tail, bool middle);
@@ -358,10 +379,144 @@ RZ_API ut64 rz_core_pava(RzCore *core, ut64 addr) {
 	return addr;
 }
 
+static void ds_annots_fini(DisasmAnnots *annots) {
+	RZ_FREE(annots->marks);
+	rz_pvector_free(annots->sections);
+	annots->sections = NULL;
+}
+
+static void annots_mark_range(DisasmAnnots *annots, ut64 addr, ut64 end, ut8 mark) {
+	ut64 from = RZ_MAX(addr, annots->from);
+	ut64 to = RZ_MIN(end, annots->from + annots->size);
+	for (ut64 at = from; at < to; at++) {
+		annots->marks[at - annots->from] |= mark;
+	}
+}
+
+static bool annots_flag_cb(RzFlagItem *fi, void *user) {
+	DisasmAnnots *annots = user;
+	annots->marks[fi->offset - annots->from] |= DS_ANNOT_FLAG;
+	return true;
+}
+
+static bool annots_block_cb(RzAnalysisBlock *block, void *user) {
+	ut64 end = block->addr + block->size;
+	annots_mark_range(user, block->addr, end < block->addr ? UT64_MAX : end, DS_ANNOT_BLOCK);
+	return true;
+}
+
+static void annots_prefetch_sections(RDisasmState *ds) {
+	DisasmAnnots *annots = &ds->annots;
+	RzBinObject *o = ds->core->bin->cur ? ds->core->bin->cur->o : NULL;
+	if (!o || !(annots->sections = rz_pvector_new(NULL))) {
+		return;
+	}
+	annots->sections_va = rz_config_get_i(ds->core->config, "io.va");
+	RzListIter *iter;
+	RzBinSection *section;
+	rz_list_foreach (o->sections, iter, section) {
+		if (section->is_segment) {
+			continue;
+		}
+		ut64 from = annots->sections_va ? rz_bin_object_addr_with_base(o, section->vaddr) : section->paddr;
+		ut64 to = from + (annots->sections_va ? section->vsize : section->size);
+		if (from < annots->from + annots->size && to > annots->from) {
+			rz_pvector_push(annots->sections, section);
+		}
+	}
+}
+
+/**
+ * Collects the annotations of the \p size addresses starting at \p from.
+ * Nothing is collected when printing can change them, because of
+ * asm.analysis or asm.emu.
+ */
+static void ds_annots_prefetch(RDisasmState *ds, ut64 from, ut64 size) {
+	DisasmAnnots *annots = &ds->annots;
+	ds_annots_fini(annots);
+	size = RZ_MIN(size, UT64_MAX - from);
+	if (!size || size > DS_ANNOTS_MAX_SIZE || ds->asm_analysis || ds->show_emu) {
+		return;
+	}
+	annots->marks = calloc(size, 1);
+	if (!annots->marks) {
+		return;
+	}
+	annots->from = from;
+	annots->size = size;
+	RzCore *core = ds->core;
+	rz_flag_foreach_range(core->flags, from, from + size, annots_flag_cb, annots);
+	RzPVector *metas = rz_meta_get_all_intersect(core->analysis, from, size, RZ_META_TYPE_ANY);
+	if (metas) {
+		void **it;
+		rz_pvector_foreach (metas, it) {
+			RzIntervalNode *node = *it;
+			if (node->start >= from) {
+				annots->marks[node->start - from] |= DS_ANNOT_META_AT;
+			}
+			annots_mark_range(annots, node->start, node->end == UT64_MAX ? UT64_MAX : node->end + 1, DS_ANNOT_META_IN);
+		}
+		rz_pvector_free(metas);
+	}
+	rz_analysis_blocks_foreach_intersect(core->analysis, from, size, annots_block_cb, annots);
+	if (ds->show_section) {
+		annots_prefetch_sections(ds);
+	}
+}
+
+/**
+ * Returns false if the prefetched annotations tell there is no \p mark
+ * at \p at, true if there is or if it's unknown.
+ */
+static inline bool ds_annot_maybe(RDisasmState *ds, ut64 at, ut8 mark) {
+	DisasmAnnots *annots = &ds->annots;
+	if (!annots->marks || at < annots->from || at - annots->from >= annots->size) {
+		return true;
+	}
+	return annots->marks[at - annots->from] & mark;
+}
+
+static RzFlagItem *ds_flag_get_i(RDisasmState *ds, ut64 at) {
+	return ds_annot_maybe(ds, at, DS_ANNOT_FLAG) ? rz_flag_get_i(ds->core->flags, at) : NULL;
+}
+
+static const RzList *ds_flag_get_list(RDisasmState *ds, ut64 at) {
+	return ds_annot_maybe(ds, at, DS_ANNOT_FLAG) ? rz_flag_get_list(ds->core->flags, at) : NULL;
+}
+
+static const char *ds_meta_get_string(RDisasmState *ds, RzAnalysisMetaType type, ut64 at) {
+	return ds_annot_maybe(ds, at, DS_ANNOT_META_AT) ? rz_meta_get_string(ds->core->analysis, type, at) : NULL;
+}
+
+static RzAnalysisMetaItem *ds_meta_get_at(RDisasmState *ds, ut64 at, RzAnalysisMetaType type, ut64 *size) {
+	return ds_annot_maybe(ds, at, DS_ANNOT_META_AT) ? rz_meta_get_at(ds->core->analysis, at, type, size) : NULL;
+}
+
+static RzBinSection *ds_section_at(RDisasmState *ds, ut64 at, int va) {
+	DisasmAnnots *annots = &ds->annots;
+	RzBinObject *o = ds->core->bin->cur->o;
+	if (!annots->sections || annots->sections_va != !!va || at < annots->from || at - annots->from >= annots->size) {
+		return o ? rz_bin_get_section_at(o, at, va) : NULL;
+	}
+	void **it;
+	rz_pvector_foreach (annots->sections, it) {
+		RzBinSection *section = *it;
+		ut64 from = va ? rz_bin_object_addr_with_base(o, section->vaddr) : section->paddr;
+		ut64 to = from + (va ? section->vsize : section->size);
+		if (at >= from && at < to) {
+			return section;
+		}
+	}
+	return NULL;
+}
+
 static RzAnalysisFunction *fcnIn(RDisasmState *ds, ut64 at, int type) {
 	if (ds->fcn && rz_analysis_function_contains(ds->fcn, at)) {
 		return ds->fcn;
 	}
+	if (!ds_annot_maybe(ds, at, DS_ANNOT_BLOCK)) {
+		return NULL;
+	}
 	return rz_analysis_get_fcn_in(ds->core->analysis, at, type);
 }
 
@@ -916,6 +1071,7 @@ static void ds_free(RDisasmState *ds) {
 	if (!ds) {
 		return;
 	}
+	ds_annots_fini(&ds->annots);
 	if (ds->show_emu_stack) {
 		// TODO: destroy fake stack in here
 		eprintf("Free fake stack\n");
@@ -946,7 +1102,7 @@ static void ds_free(RDisasmState *ds) {
 /* XXX move to rz_print */
 static char *colorize_asm_string(RzCore *core, RDisasmState *ds, bool print_color) {
 	char *source = ds->opstr ? ds->opstr : rz_asm_op_get_asm(&ds->asmop);
-	const char *hlstr = rz_meta_get_string(ds->core->analysis, RZ_META_TYPE_HIGHLIGHT, ds->at);
+	const char *hlstr = ds_meta_get_string(ds, RZ_META_TYPE_HIGHLIGHT, ds->at);
 	bool partial_reset = line_highlighted(ds) ? true : ((hlstr && *hlstr) ? true : false);
 	RzAnalysisFunction *f = ds->show_color_args ? fcnIn(ds, ds->vat, RZ_ANALYSIS_FCN_TYPE_NULL) : NULL;
 
@@ -1206,7 +1362,7 @@ static void ds_build_op_str(RDisasmState *ds, bool print_color) {
 		int i = 0;
 		char *word = NULL;
 		char *bgcolor = NULL;
-		const char *wcdata = rz_meta_get_string(ds->core->analysis, RZ_META_TYPE_HIGHLIGHT, ds->at);
+		const char *wcdata = ds_meta_get_string(ds, RZ_META_TYPE_HIGHLIGHT, ds->at);
 		int argc = 0;
 		char **wc_array = rz_str_argv(wcdata, &argc);
 		for (i = 0; i < argc; i++) {
@@ -1596,7 +1752,7 @@ static int handleMidFlags(RzCore *core, RDisasmState *ds, bool print) {
 		return 0;
 	}
 	for (int i = 1; i < ds->oplen; i++) {
-		RzFlagItem *fi = rz_flag_get_i(core->flags, ds->at + i);
+		RzFlagItem *fi = ds_flag_get_i(ds, ds->at + i);
 		if (fi && fi->name) {
 			if (rz_analysis_find_most_relevant_block_in(core->analysis, ds->at + i)) {
 				ds->midflags = ds->midflags ? RZ_MIDFLAGS_SHOW : RZ_MIDFLAGS_HIDE;
@@ -1630,6 +1786,9 @@ static int handleMidBB(RzCore *core, RDisasmState *ds) {
 	// a bb (and fcn) can be as small as 1 byte, and advancing i based on
 	// bb->size is unsound if basic blocks can nest or overlap
 	for (i = 1; i < ds->oplen; i++) {
+		if (!ds_annot_maybe(ds, ds->at + i, DS_ANNOT_BLOCK)) {
+			continue;
+		}
 		RzAnalysisFunction *fcn = rz_analysis_get_fcn_in(core->analysis, ds->at + i, 0);
 		if (fcn) {
 			RzAnalysisBlock *bb = rz_analysis_fcn_bbget_in(core->analysis, fcn, ds->at + i);
@@ -2168,9 +2327,9 @@ static void ds_show_comments_right(RDisasmState *ds) {
 	if (!ds->show_comments && !ds->show_usercomments) {
 		return;
 	}
-	RzFlagItem *item = rz_flag_get_i(core->flags, ds->at);
-	const char *comment = rz_meta_get_string(core->analysis, RZ_META_TYPE_COMMENT, ds->at);
-	const char *vartype = rz_meta_get_string(core->analysis, RZ_META_TYPE_VARTYPE, ds->at);
+	RzFlagItem *item = ds_flag_get_i(ds, ds->at);
+	const char *comment = ds_meta_get_string(ds, RZ_META_TYPE_COMMENT, ds->at);
+	const char *vartype = ds_meta_get_string(ds, RZ_META_TYPE_VARTYPE, ds->at);
 	if (!comment) {
 		if (vartype) {
 			ds->comment = rz_str_newf("%s; %s", COLOR_ARG(ds, color_func_var_type), vartype);
@@ -2281,7 +2440,7 @@ static void ds_show_flags(RDisasmState *ds, bool overlapped) {
 	ut64 switch_addr = UT64_MAX;
 	int case_start = -1, case_prev = 0, case_current = 0;
 	f = rz_analysis_get_function_at(ds->core->analysis, ds->at);
-	const RzList *flaglist = rz_flag_get_list(core->flags, ds->at);
+	const RzList *flaglist = ds_flag_get_list(ds, ds->at);
 	RzList *uniqlist = flaglist ? rz_list_uniq(flaglist, flagCmp) : NULL;
 	int count = 0;
 	bool outline = !ds->flags_inline;
@@ -2709,12 +2868,12 @@ static void ds_print_lines_left(RDisasmState *ds) {
 		char *str = NULL;
 		if (ds->show_section_perm && core->bin && core->bin->cur) {
 			int va = rz_config_get_i(core->config, "io.va");
-			RzBinSection *sec = rz_bin_get_section_at(core->bin->cur->o, ds->at, va);
+			RzBinSection *sec = ds_section_at(ds, ds->at, va);
 			str = strdup(sec ? rz_str_rwx_i(sec->perm) : "---");
 		}
 		if (ds->show_section_name && core->bin && core->bin->cur) {
 			int va = rz_config_get_i(core->config, "io.va");
-			RzBinSection *sec = rz_bin_get_section_at(core->bin->cur->o, ds->at, va);
+			RzBinSection *sec = ds_section_at(ds, ds->at, va);
 			if (sec) {
 				if (str) {
 					str = rz_str_append(str, " ");
@@ -2885,6 +3044,9 @@ static void ds_print_offset(RDisasmState *ds) {
 }
 
 static bool requires_op_size(RDisasmState *ds) {
+	if (!ds_annot_maybe(ds, ds->at, DS_ANNOT_META_IN)) {
+		return true;
+	}
 	RzPVector *metas = rz_meta_get_all_in(ds->core->analysis, ds->at, RZ_META_TYPE_ANY);
 	if (!metas) {
 		return false;
@@ -3042,7 +3204,7 @@ static bool ds_print_meta_infos(RDisasmState *ds, ut8 *buf, int len, int idx, in
 	bool ret = false;
 	RzAnalysisMetaItem *fmi;
 	RzCore *core = ds->core;
-	if (!ds->asm_meta) {
+	if (!ds->asm_meta || !ds_annot_maybe(ds, ds->at, DS_ANNOT_META_IN)) {
 		return false;
 	}
 	RzPVector *metas = rz_meta_get_all_in(core->analysis, ds->at, RZ_META_TYPE_ANY);
@@ -3257,7 +3419,7 @@ static void ds_print_show_bytes(RDisasmState *ds) {
 		core->print->flags &= ~RZ_PRINT_FLAGS_COLOR;
 	}
 	strcpy(extra, " ");
-	if (ds->show_flag_in_bytes) {
+	if (ds->show_flag_in_bytes && ds_annot_maybe(ds, ds->at, DS_ANNOT_FLAG)) {
 		flagstr = rz_flag_get_liststr(core->flags, ds->at);
 	}
 	if (flagstr) {
@@ -3598,7 +3760,7 @@ static bool ds_print_core_vmode(RDisasmState *ds, int pos) {
 	}
 	if (ds->asm_hint_lea) {
 		ut64 size;
-		RzAnalysisMetaItem *mi = rz_meta_get_at(ds->core->analysis, ds->at, RZ_META_TYPE_ANY, &size);
+		RzAnalysisMetaItem *mi = ds_meta_get_at(ds, ds->at, RZ_META_TYPE_ANY, &size);
 		if (mi) {
 			int obits = ds->core->rasm->bits;
 			ds->core->rasm->bits = size * 8;
@@ -4942,7 +5104,7 @@ static void ds_print_comments_right(RDisasmState *ds) {
 	RzCore *core = ds->core;
 	ds_print_relocs(ds);
 	bool is_code = (!ds->hint) || (ds->hint && ds->hint->type != 'd');
-	RzAnalysisMetaItem *mi = rz_meta_get_at(ds->core->analysis, ds->at, RZ_META_TYPE_ANY, NULL);
+	RzAnalysisMetaItem *mi = ds_meta_get_at(ds, ds->at, RZ_META_TYPE_ANY, NULL);
 	if (mi) {
 		is_code = mi->type != 'd';
 		mi = NULL;
@@ -5251,6 +5413,7 @@ RZ_API int rz_core_print_disasm(RzPrint *p, RzCore *core, ut64 addr, ut8 *buf, i
 		pj_a(ds->pj);
 	}
 toro:
+	ds_annots_prefetch(ds, ds->addr, len / addrbytes);
 	// uhm... is this necessary? imho can be removed
 	rz_asm_set_pc(core->rasm, rz_core_pava(core, ds->addr + idx));
 	core->cons->vline = rz_config_get_b(core->config, "scr.utf8") ? (rz_config_get_b(core->config, "scr.utf8.curvy") ? rz_vline_uc : rz_vline_u) : rz_vline_a;
@@ -151,7 +151,7 @@ static GHT GH(tcache_chunk_size)(RzCore *core, GHT brk_start) {
 	if (!cnk) {
 		return sz;
 	}
-	rz_io_read_at(core->io, brk_start, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
+	rz_core_heap_read(core, brk_start, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
 	sz = (cnk->size >> 3) << 3; // clear chunk flag
 	return sz;
 }
@@ -215,7 +215,7 @@ RZ_API bool GH(rz_heap_update_main_arena)(RzCore *core, GHT m_arena, MallocState
 		if (!cmain_arena) {
 			return false;
 		}
-		(void)rz_io_read_at(core->io, m_arena, (ut8 *)cmain_arena, sizeof(GH(RzHeap_MallocState_tcache)));
+		(void)rz_core_heap_read(core, m_arena, (ut8 *)cmain_arena, sizeof(GH(RzHeap_MallocState_tcache)));
 		GH(update_arena_with_tc)
 		(cmain_arena, main_arena);
 	} else {
@@ -223,7 +223,7 @@ RZ_API bool GH(rz_heap_update_main_arena)(RzCore *core, GHT m_arena, MallocState
 		if (!cmain_arena) {
 			return false;
 		}
-		(void)rz_io_read_at(core->io, m_arena, (ut8 *)cmain_arena, sizeof(GH(RzHeap_MallocState)));
+		(void)rz_core_heap_read(core, m_arena, (ut8 *)cmain_arena, sizeof(GH(RzHeap_MallocState)));
 		GH(update_arena_without_tc)
 		(cmain_arena, main_arena);
 	}
@@ -516,7 +516,7 @@ void GH(print_heap_chunk)(RzCore *core, GHT chunk) {
 		return;
 	}
 
-	(void)rz_io_read_at(core->io, chunk, (ut8 *)cnk, sizeof(*cnk));
+	(void)rz_core_heap_read(core, chunk, (ut8 *)cnk, sizeof(*cnk));
 
 	PRINT_GA("struct malloc_chunk @ ");
 	PRINTF_BA("0x%" PFMT64x, (ut64)chunk);
@@ -553,7 +553,7 @@ void GH(print_heap_chunk)(RzCore *core, GHT chunk) {
 
 	char *data = calloc(1, size);
 	if (data) {
-		rz_io_read_at(core->io, chunk + SZ * 2, (ut8 *)data, size);
+		rz_core_heap_read(core, chunk + SZ * 2, (ut8 *)data, size);
 		PRINT_GA("chunk data = \n");
 		rz_print_hexdump(core->print, chunk + SZ * 2, (ut8 *)data, size, SZ * 8, SZ, 1);
 		free(data);
@@ -572,7 +572,7 @@ RZ_API GH(RzHeapChunk) * GH(rz_heap_get_chunk_at_addr)(RzCore *core, GHT addr) {
 	if (!cnk) {
 		return NULL;
 	}
-	(void)rz_io_nread_at(core->io, addr, (ut8 *)cnk, sizeof(*cnk));
+	(void)rz_core_heap_read(core, addr, (ut8 *)cnk, sizeof(*cnk));
 	return cnk;
 }
 
@@ -679,7 +679,7 @@ static int GH(print_double_linked_list_bin_simple)(RzCore *core, GHT bin, Malloc
 		return -1;
 	}
 
-	rz_io_read_at(core->io, bin, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
+	rz_core_heap_read(core, bin, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
 
 	PRINTF_GA("    0x%" PFMT64x, (ut64)bin);
 	if (cnk->fd != bin) {
@@ -693,7 +693,7 @@ static int GH(print_double_linked_list_bin_simple)(RzCore *core, GHT bin, Malloc
 			free(cnk);
 			return -1;
 		}
-		rz_io_read_at(core->io, next, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
+		rz_core_heap_read(core, next, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
 	}
 
 	PRINTF_GA("->fd = 0x%" PFMT64x, (ut64)cnk->fd);
@@ -704,7 +704,7 @@ static int GH(print_double_linked_list_bin_simple)(RzCore *core, GHT bin, Malloc
 		free(cnk);
 		return -1;
 	}
-	(void)rz_io_read_at(core->io, next, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
+	(void)rz_core_heap_read(core, next, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
 	PRINTF_GA("\n    0x%" PFMT64x, (ut64)bin);
 
 	while (cnk->bk != bin) {
@@ -715,7 +715,7 @@ static int GH(print_double_linked_list_bin_simple)(RzCore *core, GHT bin, Malloc
 			free(cnk);
 			return -1;
 		}
-		(void)rz_io_read_at(core->io, next, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
+		(void)rz_core_heap_read(core, next, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
 	}
 
 	PRINTF_GA("->bk = 0x%" PFMT64x, (ut64)cnk->bk);
@@ -738,7 +738,7 @@ static int GH(print_double_linked_list_bin_graph)(RzCore *core, GHT bin, MallocS
 	}
 	g->can->color = rz_config_get_i(core->config, "scr.color");
 
-	(void)rz_io_read_at(core->io, bin, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
+	(void)rz_core_heap_read(core, bin, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
 	snprintf(title, sizeof(title) - 1, "bin @ 0x%" PFMT64x "\n", (ut64)bin);
 	snprintf(chunk, sizeof(chunk) - 1, "fd: 0x%" PFMT64x "\nbk: 0x%" PFMT64x "\n",
 		(ut64)cnk->fd, (ut64)cnk->bk);
@@ -754,7 +754,7 @@ static int GH(print_double_linked_list_bin_graph)(RzCore *core, GHT bin, MallocS
 			return -1;
 		}
 
-		rz_io_read_at(core->io, next, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
+		rz_core_heap_read(core, next, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
 		snprintf(title, sizeof(title) - 1, "Chunk @ 0x%" PFMT64x "\n", (ut64)next);
 		snprintf(chunk, sizeof(chunk) - 1, "fd: 0x%" PFMT64x "\nbk: 0x%" PFMT64x "\n",
 			(ut64)cnk->fd, (ut64)cnk->bk);
@@ -911,7 +911,7 @@ RZ_API RzHeapBin *GH(rz_heap_fastbin_content)(RzCore *core, MallocState *main_ar
 		item->status = rz_str_new("free");
 		rz_list_append(heap_bin->chunks, item);
 		while (double_free == GHT_MAX && next_tmp && next_tmp >= brk_start && next_tmp <= main_arena->top) {
-			rz_io_read_at(core->io, next_tmp, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
+			rz_core_heap_read(core, next_tmp, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
 			next_tmp = GH(get_next_pointer)(core, next_tmp, cnk->fd);
 			if (cnk->prev_size > size || ((cnk->size >> 3) << 3) > size) {
 				break;
@@ -921,7 +921,7 @@ RZ_API RzHeapBin *GH(rz_heap_fastbin_content)(RzCore *core, MallocState *main_ar
 				break;
 			}
 		}
-		rz_io_read_at(core->io, next, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
+		rz_core_heap_read(core, next, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
 		next = GH(get_next_pointer)(core, next, cnk->fd);
 		if (cnk->prev_size > size || ((cnk->size >> 3) << 3) > size) {
 			char message[50];
@@ -1048,8 +1048,8 @@ RZ_API void GH(tcache_free)(GH(RTcache) * tcache) {
 static bool GH(tcache_read)(RzCore *core, GHT tcache_start, GH(RTcache) * tcache) {
 	rz_return_val_if_fail(core && tcache, false);
 	return tcache->type == NEW
-		? rz_io_read_at(core->io, tcache_start, (ut8 *)tcache->RzHeapTcache.heap_tcache, sizeof(GH(RzHeapTcache)))
-		: rz_io_read_at(core->io, tcache_start, (ut8 *)tcache->RzHeapTcache.heap_tcache_pre_230, sizeof(GH(RzHeapTcachePre230)));
+		? rz_core_heap_read(core, tcache_start, (ut8 *)tcache->RzHeapTcache.heap_tcache, sizeof(GH(RzHeapTcache)))
+		: rz_core_heap_read(core, tcache_start, (ut8 *)tcache->RzHeapTcache.heap_tcache_pre_230, sizeof(GH(RzHeapTcachePre230)));
 }
 
 static int GH(tcache_get_count)(GH(RTcache) * tcache, int index) {
@@ -1162,7 +1162,7 @@ RZ_API RzList *GH(rz_heap_tcache_content)(RzCore *core, GHT arena_base) {
 		GHT tcache_fd = entry;
 		GHT tcache_tmp = GHT_MAX;
 		for (size_t n = 1; n < count; n++) {
-			bool r = rz_io_nread_at(core->io, tcache_fd, (ut8 *)&tcache_tmp, sizeof(GHT));
+			bool r = rz_core_heap_read(core, tcache_fd, (ut8 *)&tcache_tmp, sizeof(GHT));
 			if (!r) {
 				goto error;
 			}
@@ -1357,7 +1357,7 @@ void GH(print_malloc_info)(RzCore *core, GHT m_state, GHT malloc_state) {
 		if (!heap_info) {
 			return;
 		}
-		rz_io_read_at(core->io, h_info, (ut8 *)heap_info, sizeof(GH(RzHeapInfo)));
+		rz_core_heap_read(core, h_info, (ut8 *)heap_info, sizeof(GH(RzHeapInfo)));
 		GH(print_inst_minfo)
 		(heap_info, h_info);
 		MallocState *ms = RZ_NEW0(MallocState);
@@ -1374,7 +1374,7 @@ void GH(print_malloc_info)(RzCore *core, GHT m_state, GHT malloc_state) {
 			}
 			if ((ms->top >> 16) << 16 != h_info) {
 				h_info = (ms->top >> 16) << 16;
-				rz_io_read_at(core->io, h_info, (ut8 *)heap_info, sizeof(GH(RzHeapInfo)));
+				rz_core_heap_read(core, h_info, (ut8 *)heap_info, sizeof(GH(RzHeapInfo)));
 				GH(print_inst_minfo)
 				(heap_info, h_info);
 			}
@@ -1439,7 +1439,7 @@ RZ_API RzHeapBin *GH(rz_heap_bin_content)(RzCore *core, MallocState *main_arena,
 		return NULL;
 	}
 
-	(void)rz_io_read_at(core->io, bk, (ut8 *)head, sizeof(GH(RzHeapChunk)));
+	(void)rz_core_heap_read(core, bk, (ut8 *)head, sizeof(GH(RzHeapChunk)));
 
 	if (head->fd == fw) {
 		return bin;
@@ -1476,7 +1476,7 @@ RZ_API RzHeapBin *GH(rz_heap_bin_content)(RzCore *core, MallocState *main_arena,
 			bin->message = rz_str_new("Corrupted list");
 			break;
 		}
-		rz_io_read_at(core->io, fw, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
+		rz_core_heap_read(core, fw, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
 		RzHeapChunkListItem *chunk = RZ_NEW0(RzHeapChunkListItem);
 		if (!chunk) {
 			break;
@@ -1809,6 +1809,7 @@ RZ_API RzList *GH(rz_heap_chunks_list)(RzCore *core, MallocState *main_arena,
 		eprintf("No Heap section\n");
 		return chunks;
 	}
+	rz_core_heap_snapshot_add_range(core, brk_start, brk_end);
 
 	GHT next_chunk = initial_brk, prev_chunk = next_chunk;
 	GH(RzHeapChunk) *cnk = RZ_NEW0(GH(RzHeapChunk));
@@ -1821,7 +1822,7 @@ RZ_API RzList *GH(rz_heap_chunks_list)(RzCore *core, MallocState *main_arena,
 		return chunks;
 	}
 
-	(void)rz_io_read_at(core->io, next_chunk, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
+	(void)rz_core_heap_read(core, next_chunk, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
 	size_tmp = (cnk->size >> 3) << 3;
 	ut64 prev_chunk_addr;
 	ut64 prev_chunk_size;
@@ -1846,7 +1847,7 @@ RZ_API RzList *GH(rz_heap_chunks_list)(RzCore *core, MallocState *main_arena,
 		if (fastbin) {
 			int i = (size_tmp / (SZ * 2)) - 2;
 			GHT idx = (GHT)main_arena->fastbinsY[i];
-			(void)rz_io_read_at(core->io, idx, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
+			(void)rz_core_heap_read(core, idx, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
 			GHT next = GH(get_next_pointer)(core, idx, cnk->fd);
 			if (prev_chunk == idx && idx && !next) {
 				is_free = true;
@@ -1858,7 +1859,7 @@ RZ_API RzList *GH(rz_heap_chunks_list)(RzCore *core, MallocState *main_arena,
 						double_free = true;
 						break;
 					}
-					(void)rz_io_read_at(core->io, next, (ut8 *)cnk_next, sizeof(GH(RzHeapChunk)));
+					(void)rz_core_heap_read(core, next, (ut8 *)cnk_next, sizeof(GH(RzHeapChunk)));
 					GHT next_node = GH(get_next_pointer)(core, next, cnk_next->fd);
 					// avoid triple while?
 					while (next_node && next_node >= brk_start && next_node < main_arena->top) {
@@ -1866,14 +1867,14 @@ RZ_API RzList *GH(rz_heap_chunks_list)(RzCore *core, MallocState *main_arena,
 							double_free = true;
 							break;
 						}
-						(void)rz_io_read_at(core->io, next_node, (ut8 *)cnk_next, sizeof(GH(RzHeapChunk)));
+						(void)rz_core_heap_read(core, next_node, (ut8 *)cnk_next, sizeof(GH(RzHeapChunk)));
 						next_node = GH(get_next_pointer)(core, next_node, cnk_next->fd);
 					}
 					if (double_free) {
 						break;
 					}
 				}
-				(void)rz_io_read_at(core->io, next, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
+				(void)rz_core_heap_read(core, next, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
 				next = GH(get_next_pointer)(core, next, cnk->fd);
 			}
 			if (double_free) {
@@ -1906,7 +1907,7 @@ RZ_API RzList *GH(rz_heap_chunks_list)(RzCore *core, MallocState *main_arena,
 						tcache_fd = entry;
 						int n;
 						for (n = 1; n < count; n++) {
-							bool r = rz_io_read_at(core->io, tcache_fd, (ut8 *)&tcache_tmp, sizeof(GHT));
+							bool r = rz_core_heap_read(core, tcache_fd, (ut8 *)&tcache_tmp, sizeof(GHT));
 							if (!r) {
 								break;
 							}
@@ -1927,7 +1928,7 @@ RZ_API RzList *GH(rz_heap_chunks_list)(RzCore *core, MallocState *main_arena,
 
 		next_chunk += size_tmp;
 		prev_chunk = next_chunk;
-		rz_io_read_at(core->io, next_chunk, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
+		rz_core_heap_read(core, next_chunk, (ut8 *)cnk, sizeof(GH(RzHeapChunk)));
 		size_tmp = (cnk->size >> 3) << 3;
 		RzHeapChunkListItem *block = RZ_NEW0(RzHeapChunkListItem);
 		if (!block) {
@@ -2107,7 +2108,7 @@ RZ_IPI RzCmdStatus GH(rz_cmd_heap_chunks_print_handler)(RzCore *core, int argc,
 				int size = 0x10;
 				char *data = calloc(1, size);
 				if (data) {
-					rz_io_nread_at(core->io, (ut64)(pos->addr + SZ * 2), (ut8 *)data, size);
+					rz_core_heap_read(core, (ut64)(pos->addr + SZ * 2), (ut8 *)data, size);
 					core->print->flags &= ~RZ_PRINT_FLAGS_HEADER;
 					core->print->pairs = false;
 					rz_cons_printf("   ");
@@ -127,7 +127,7 @@ static void GH(jemalloc_get_chunks)(RzCore *core, const char *input) {
 		eprintf("Fail at read symbol je_chunksize\n");
 		return;
 	}
-	rz_io_read_at(core->io, cnksz, (ut8 *)&cnksz, sizeof(GHT));
+	rz_core_heap_read(core, cnksz, (ut8 *)&cnksz, sizeof(GHT));
 
 	switch (input[0]) {
 	case '\0':
@@ -141,8 +141,8 @@ static void GH(jemalloc_get_chunks)(RzCore *core, const char *input) {
 		arena = rz_num_math(core->num, input);
 
 		if (arena) {
-			rz_io_read_at(core->io, arena, (ut8 *)ar, sizeof(arena_t));
-			rz_io_read_at(core->io, (GHT)(size_t)ar->achunks.qlh_first, (ut8 *)head, sizeof(extent_node_t));
+			rz_core_heap_read(core, arena, (ut8 *)ar, sizeof(arena_t));
+			rz_core_heap_read(core, (GHT)(size_t)ar->achunks.qlh_first, (ut8 *)head, sizeof(extent_node_t));
 			if (head->en_addr) {
 				PRINT_YA("   Chunk - start: ");
 				PRINTF_BA("0x%08" PFMT64x, (ut64)(size_t)head->en_addr);
@@ -150,7 +150,7 @@ static void GH(jemalloc_get_chunks)(RzCore *core, const char *input) {
 				PRINTF_BA("0x%08" PFMT64x, (ut64)(size_t)((char *)head->en_addr + cnksz));
 				PRINT_YA(", size: ");
 				PRINTF_BA("0x%08" PFMT64x "\n", (ut64)cnksz);
-				rz_io_read_at(core->io, (ut64)(size_t)head->ql_link.qre_next, (ut8 *)node, sizeof(extent_node_t));
+				rz_core_heap_read(core, (ut64)(size_t)head->ql_link.qre_next, (ut8 *)node, sizeof(extent_node_t));
 				while (node && node->en_addr != head->en_addr) {
 					PRINT_YA("   Chunk - start: ");
 					PRINTF_BA("0x%08" PFMT64x, (ut64)(size_t)node->en_addr);
@@ -158,7 +158,7 @@ static void GH(jemalloc_get_chunks)(RzCore *core, const char *input) {
 					PRINTF_BA("0x%" PFMT64x, (ut64)(size_t)((char *)node->en_addr + cnksz));
 					PRINT_YA(", size: ");
 					PRINTF_BA("0x%08" PFMT64x "\n", cnksz);
-					rz_io_read_at(core->io, (ut64)(size_t)node->ql_link.qre_next, (ut8 *)node, sizeof(extent_node_t));
+					rz_core_heap_read(core, (ut64)(size_t)node->ql_link.qre_next, (ut8 *)node, sizeof(extent_node_t));
 				}
 			}
 		}
@@ -184,15 +184,15 @@ static void GH(jemalloc_get_chunks)(RzCore *core, const char *input) {
 		}
 
 		if (GH(rz_resolve_jemalloc)(core, "je_arenas", &sym)) {
-			rz_io_read_at(core->io, sym, (ut8 *)&arenas, sizeof(GHT));
+			rz_core_heap_read(core, sym, (ut8 *)&arenas, sizeof(GHT));
 			for (;;) {
-				rz_io_read_at(core->io, arenas + i * sizeof(GHT), (ut8 *)&arena, sizeof(GHT));
+				rz_core_heap_read(core, arenas + i * sizeof(GHT), (ut8 *)&arena, sizeof(GHT));
 				if (!arena) {
 					break;
 				}
 				PRINTF_GA("arenas[%d]: @ 0x%" PFMTx " { \n", i++, (GHT)arena);
-				rz_io_read_at(core->io, arena, (ut8 *)ar, sizeof(arena_t));
-				rz_io_read_at(core->io, (GHT)(size_t)ar->achunks.qlh_first, (ut8 *)head, sizeof(extent_node_t));
+				rz_core_heap_read(core, arena, (ut8 *)ar, sizeof(arena_t));
+				rz_core_heap_read(core, (GHT)(size_t)ar->achunks.qlh_first, (ut8 *)head, sizeof(extent_node_t));
 				if (head->en_addr != 0) {
 					PRINT_YA("   Chunk - start: ");
 					PRINTF_BA("0x%08" PFMT64x, (ut64)(size_t)head->en_addr);
@@ -201,7 +201,7 @@ static void GH(jemalloc_get_chunks)(RzCore *core, const char *input) {
 					PRINT_YA(", size: ");
 					PRINTF_BA("0x%08" PFMT64x "\n", (ut64)cnksz);
 					ut64 addr = (ut64)(size_t)head->ql_link.qre_next;
-					rz_io_read_at(core->io, addr, (ut8 *)node, sizeof(extent_node_t));
+					rz_core_heap_read(core, addr, (ut8 *)node, sizeof(extent_node_t));
 					while (node && head && node->en_addr != head->en_addr) {
 						PRINT_YA("   Chunk - start: ");
 						PRINTF_BA("0x%08" PFMT64x, (ut64)(size_t)node->en_addr);
@@ -209,7 +209,7 @@ static void GH(jemalloc_get_chunks)(RzCore *core, const char *input) {
 						PRINTF_BA("0x%" PFMT64x, (ut64)(size_t)((char *)node->en_addr + cnksz));
 						PRINT_YA(", size: ");
 						PRINTF_BA("0x%" PFMT64x "\n", cnksz);
-						rz_io_read_at(core->io, (GHT)(size_t)node->ql_link.qre_next, (ut8 *)node, sizeof(extent_node_t));
+						rz_core_heap_read(core, (GHT)(size_t)node->ql_link.qre_next, (ut8 *)node, sizeof(extent_node_t));
 					}
 				}
 				PRINT_GA("}\n");
@@ -242,7 +242,7 @@ static void GH(jemalloc_print_narenas)(RzCore *core, const char *input) {
 	switch (input[0]) {
 	case '\0':
 		if (GH(rz_resolve_jemalloc)(core, "narenas_total", &symaddr)) {
-			rz_io_read_at(core->io, symaddr, (ut8 *)&narenas, sizeof(GHT));
+			rz_core_heap_read(core, symaddr, (ut8 *)&narenas, sizeof(GHT));
 			PRINTF_GA("narenas : %" PFMT64d "\n", (ut64)narenas);
 		}
 		if (narenas == 0) {
@@ -259,11 +259,11 @@ static void GH(jemalloc_print_narenas)(RzCore *core, const char *input) {
 		}
 
 		if (GH(rz_resolve_jemalloc)(core, "je_arenas", &arenas)) {
-			rz_io_read_at(core->io, arenas, (ut8 *)&arenas, sizeof(GHT));
+			rz_core_heap_read(core, arenas, (ut8 *)&arenas, sizeof(GHT));
 			PRINTF_GA("arenas[%" PFMT64d "] @ 0x%" PFMT64x " {\n", (ut64)narenas, (ut64)arenas);
 			for (i = 0; i < narenas; i++) {
 				ut64 at = arenas + (i * sizeof(GHT));
-				rz_io_read_at(core->io, at, (ut8 *)&arena, sizeof(GHT));
+				rz_core_heap_read(core, at, (ut8 *)&arena, sizeof(GHT));
 				if (!arena) {
 					PRINTF_YA("  arenas[%d]: (empty)\n", i);
 					continue;
@@ -276,7 +276,7 @@ static void GH(jemalloc_print_narenas)(RzCore *core, const char *input) {
 		break;
 	case ' ':
 		arena = rz_num_math(core->num, input + 1);
-		rz_io_read_at(core->io, (GHT)arena, (ut8 *)ar, sizeof(arena_t));
+		rz_core_heap_read(core, (GHT)arena, (ut8 *)ar, sizeof(arena_t));
 
 		PRINT_GA("struct arena_s {\n");
 #define OO(x) (ut64)(arena + rz_offsetof(arena_t, x))
@@ -345,10 +345,10 @@ static void GH(jemalloc_get_bins)(RzCore *core, const char *input) {
 			break;
 		}
 		if (GH(rz_resolve_jemalloc)(core, "je_arenas", &arenas)) {
-			rz_io_read_at(core->io, arenas, (ut8 *)&arenas, sizeof(GHT));
+			rz_core_heap_read(core, arenas, (ut8 *)&arenas, sizeof(GHT));
 			PRINTF_GA("arenas @ 0x%" PFMTx " {\n", (GHT)arenas);
 			for (;;) {
-				rz_io_read_at(core->io, arenas + i * sizeof(GHT), (ut8 *)&arena, sizeof(GHT));
+				rz_core_heap_read(core, arenas + i * sizeof(GHT), (ut8 *)&arena, sizeof(GHT));
 				if (!arena) {
 					RZ_FREE(b);
 					break;
@@ -356,9 +356,9 @@ static void GH(jemalloc_get_bins)(RzCore *core, const char *input) {
 				PRINTF_YA("   arenas[%d]: ", i++);
 				PRINTF_BA("@ 0x%" PFMTx, (GHT)arena);
 				PRINT_YA(" {\n");
-				rz_io_read_at(core->io, arena, (ut8 *)ar, sizeof(arena_t));
+				rz_core_heap_read(core, arena, (ut8 *)ar, sizeof(arena_t));
 				for (j = 0; j < JM_NBINS; j++) {
-					rz_io_read_at(core->io, (GHT)(bin_info + j * sizeof(arena_bin_info_t)),
+					rz_core_heap_read(core, (GHT)(bin_info + j * sizeof(arena_bin_info_t)),
 						(ut8 *)b, sizeof(arena_bin_info_t));
 					PRINT_YA("    {\n");
 					PRINT_YA("       regsize : ");
@@ -2,6 +2,903 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 // included from rtr.c
 
+static bool rtr_http_bind_local(RzCore *core, const char **host) {
+	const char *h = *host;
+	if (!h || !*h) {
+		return true;
+	}
+	if (!strcmp(h, "local")) {
+		rz_config_set(core->config, "http.bind", "localhost");
+	} else if (h[0] == '0' || !strcmp(h, "public")) {
+		// public
+		*host = "127.0.0.1";
+		rz_config_set(core->config, "http.bind", "0.0.0.0");
+		return false;
+	}
+	return true;
+}
+
+static void rtr_http_browse(RzCore *core, const char *host, const char *port, const char *path) {
+	const char *browser = rz_config_get(core->config, "http.browser");
+	rz_sys_cmdf("%s http://%s:%d/%s &",
+		browser, host, atoi(port), path ? path : "");
+}
+
+/* configuration used while serving the requests */
+static RzConfig *rtr_http_config_new(RzCore *core) {
+	RzConfig *cfg = rz_config_clone(core->config);
+	if (!cfg) {
+		return NULL;
+	}
+	rz_config_set(cfg, "asm.cmt.right", "false");
+#if 0
+	// WHY
+	rz_config_set (cfg, "scr.html", "true");
+#endif
+	rz_config_set_i(cfg, "scr.color", COLOR_MODE_DISABLED);
+	rz_config_set(cfg, "asm.bytes", "false");
+	rz_config_set(cfg, "scr.interactive", "false");
+	return cfg;
+}
+
+/* switches back to origcfg, keeping the http settings changed meanwhile */
+static void rtr_http_config_restore(RzCore *core, RzConfig *origcfg) {
+	int timeout = rz_config_get_i(core->config, "http.timeout");
+	const char *host = rz_config_get(core->config, "http.bind");
+	const char *port = rz_config_get(core->config, "http.port");
+	const char *cors = rz_config_get(core->config, "http.cors");
+	const char *allow = rz_config_get(core->config, "http.allow");
+	core->config = origcfg;
+	rz_config_set_i(core->config, "http.timeout", timeout);
+	rz_config_set(core->config, "http.bind", host);
+	rz_config_set(core->config, "http.port", port);
+	rz_config_set(core->config, "http.cors", cors);
+	rz_config_set(core->config, "http.allow", allow);
+	/* refresh settings - run callbacks */
+	rz_config_set(origcfg, "scr.html", rz_config_get(origcfg, "scr.html"));
+	rz_config_set_i(origcfg, "scr.color", rz_config_get_i(origcfg, "scr.color"));
+	rz_config_set(origcfg, "scr.interactive", rz_config_get(origcfg, "scr.interactive"));
+}
+
+#if HAVE_LIBUV
+
+/*
+ * Event-driven HTTP server, used unless a feature only the blocking server
+ * below supports is enabled (http.auth, http.upload, http.upget, http.uri).
+ *
+ * Connections are kept alive (HTTP/1.1 by default, HTTP/1.0 when asked) and
+ * the requests pipelined on them are answered in order. The commands still
+ * run one at a time on the loop thread, but a slow client no longer makes
+ * the others wait for the accept loop. Large outputs are sent in chunks to
+ * HTTP/1.1 clients.
+ *
+ * Besides /cmd/ and the files in http.root, it serves:
+ * - POST /cmds: runs the commands in the body, one per line, and answers
+ *   with the JSON array of their outputs
+ * - GET /stats: counters of the server, in JSON
+ */
+
+#define RTR_HTTP_READ_SIZE   4096
+#define RTR_HTTP_MAX_HEADERS (64 * 1024)
+#define RTR_HTTP_MAX_BODY    (16 * 1024 * 1024)
+#define RTR_HTTP_CHUNK_SIZE  (64 * 1024)
+
+typedef struct {
+	ut64 started; ///< monotonic time the server started at, in microseconds
+	ut64 connections;
+	ut64 requests;
+	ut64 commands;
+	ut64 bytes_in;
+	ut64 bytes_out;
+	ut64 latency_total; ///< time spent handling the requests, in microseconds
+	ut64 latency_max;
+} RtrHttpStats;
+
+typedef struct {
+	RzCore *core;
+	uv_tcp_t tcp; ///< IPv4 listener
+	uv_tcp_t tcp6; ///< IPv6 listener
+	uv_async_t stop_async;
+	RzPVector /*<RtrHttpClient *>*/ clients;
+	RtrHttpStats stats;
+	char *headers; ///< extra headers of every response
+	ut64 timeout; ///< idle time before closing a connection, in milliseconds
+	int port;
+	int ret; ///< value returned by rz_core_rtr_http_run()
+	bool stop_pending; ///< stops once the pending responses are sent
+	bool stopped;
+	void *bed;
+	ut64 offset; ///< seek of the commands, kept apart from the one of the user
+	ut8 *block;
+	ut32 blocksize;
+} RtrHttpServer;
+
+typedef struct {
+	RtrHttpServer *server;
+	uv_tcp_t tcp;
+	uv_timer_t timer;
+	char *in; ///< received bytes not consumed yet
+	size_t in_len;
+	size_t in_size;
+	size_t pending_writes;
+	int handles; ///< handles not closed yet
+	bool closing;
+	bool draining; ///< closes once the pending responses are sent
+	char peer[64];
+} RtrHttpClient;
+
+typedef struct {
+	char *head; ///< request line and headers, split in place
+	const char *method;
+	char *path;
+	const char *referer;
+	const char *body;
+	size_t body_len;
+	bool http11;
+	bool keep_alive;
+} RtrHttpRequest;
+
+typedef struct {
+	uv_write_t req;
+	RtrHttpClient *client;
+	char *head;
+	char *body;
+	char *chunks; ///< sizes of the chunks, when chunked
+} RtrHttpWrite;
+
+static void rtr_http_client_handle_closed(uv_handle_t *handle) {
+	RtrHttpClient *client = handle->data;
+	if (--client->handles > 0) {
+		return;
+	}
+	free(client->in);
+	free(client);
+}
+
+static void rtr_http_client_close(RtrHttpClient *client) {
+	if (client->closing) {
+		return;
+	}
+	client->closing = true;
+	rz_pvector_remove_data(&client->server->clients, client);
+	uv_close((uv_handle_t *)&client->timer, rtr_http_client_handle_closed);
+	uv_close((uv_handle_t *)&client->tcp, rtr_http_client_handle_closed);
+}
+
+static void rtr_http_server_stop(RtrHttpServer *server) {
+	if (server->stopped) {
+		return;
+	}
+	server->stopped = true;
+	uv_close((uv_handle_t *)&server->stop_async, NULL);
+	uv_close((uv_handle_t *)&server->tcp, NULL);
+	uv_close((uv_handle_t *)&server->tcp6, NULL);
+	while (!rz_pvector_empty(&server->clients)) {
+		rtr_http_client_close(rz_pvector_tail(&server->clients));
+	}
+}
+
+static void rtr_http_stop_cb(uv_async_t *handle) {
+	rtr_http_server_stop(handle->data);
+}
+
+static void rtr_http_break(RtrHttpServer *server) {
+	uv_async_send(&server->stop_async);
+}
+
+static void rtr_http_idle_cb(uv_timer_t *timer) {
+	RtrHttpClient *client = timer->data;
+	if (client->pending_writes) {
+		uv_timer_again(timer);
+		return;
+	}
+	rtr_http_client_close(client);
+}
+
+static void rtr_http_touch(RtrHttpClient *client) {
+	if (client->server->timeout && !client->closing) {
+		uv_timer_start(&client->timer, rtr_http_idle_cb, client->server->timeout, client->server->timeout);
+	}
+}
+
+static void rtr_http_write_cb(uv_write_t *req, int status) {
+	RtrHttpWrite *w = (RtrHttpWrite *)req;
+	RtrHttpClient *client = w->client;
+	RtrHttpServer *server = client->server;
+	free(w->head);
+	free(w->body);
+	free(w->chunks);
+	free(w);
+	client->pending_writes--;
+	if (client->closing) {
+		// cancelled
+	} else if (status < 0) {
+		http_logf(server->core, "http: cannot write to %s: %s\n", client->peer, uv_strerror(status));
+		rtr_http_client_close(client);
+	} else if (client->draining && !client->pending_writes) {
+		rtr_http_client_close(client);
+	}
+	if (server->stop_pending && !client->pending_writes) {
+		rtr_http_server_stop(server);
+	}
+}
+
+static const char *rtr_http_status(int code) {
+	switch (code) {
+	case 200: return "OK";
+	case 302: return "Found";
+	case 400: return "Bad Request";
+	case 403: return "Forbidden";
+	case 404: return "Not Found";
+	case 413: return "Payload Too Large";
+	case 501: return "Not Implemented";
+	case 503: return "Service Unavailable";
+	default: return "Unknown";
+	}
+}
+
+/**
+ * Queues the response to the last request of \p client, taking the
+ * ownership of \p body. \p headers are the specific ones of the response,
+ * each one terminated by CRLF.
+ */
+static void rtr_http_respond(RtrHttpClient *client, const RtrHttpRequest *req, int code, const char *headers, RZ_OWN char *body, size_t len) {
+	RtrHttpServer *server = client->server;
+	if (client->closing) {
+		free(body);
+		return;
+	}
+	bool keep_alive = req && req->keep_alive;
+	bool chunked = req && req->http11 && len > RTR_HTTP_CHUNK_SIZE;
+	RtrHttpWrite *w = RZ_NEW0(RtrHttpWrite);
+	size_t n_chunks = chunked ? (len + RTR_HTTP_CHUNK_SIZE - 1) / RTR_HTTP_CHUNK_SIZE : 0;
+	uv_buf_t *bufs = RZ_NEWS(uv_buf_t, 2 + 3 * n_chunks);
+	if (!w || !bufs) {
+		goto fail;
+	}
+	w->client = client;
+	w->body = body;
+	w->head = rz_str_newf("HTTP/1.1 %d %s\r\n"
+			      "Connection: %s\r\n"
+			      "%s%s",
+		code, rtr_http_status(code), keep_alive ? "keep-alive" : "close",
+		headers ? headers : "", server->headers ? server->headers : "");
+	if (chunked) {
+		w->head = rz_str_append(w->head, "Transfer-Encoding: chunked\r\n\r\n");
+	} else {
+		w->head = rz_str_appendf(w->head, "Content-Length: %" PFMT64u "\r\n\r\n", (ut64)len);
+	}
+	if (!w->head) {
+		goto fail;
+	}
+	size_t n_bufs = 0;
+	bufs[n_bufs++] = uv_buf_init(w->head, (unsigned int)strlen(w->head));
+	if (chunked) {
+		// "%x\r\n" of each chunk, then "\r\n" and the last chunk
+		const size_t size_len = 16 + 2 + 1;
+		w->chunks = malloc(n_chunks * size_len + 8);
+		if (!w->chunks) {
+			goto fail;
+		}
+		char *end = w->chunks + n_chunks * size_len;
+		strcpy(end, "\r\n0\r\n\r\n");
+		for (size_t i = 0; i < n_chunks; i++) {
+			size_t off = i * RTR_HTTP_CHUNK_SIZE;
+			size_t clen = RZ_MIN(RTR_HTTP_CHUNK_SIZE, len - off);
+			char *size = w->chunks + i * size_len;
+			int slen = snprintf(size, size_len, "%" PFMT64x "\r\n", (ut64)clen);
+			if (i) {
+				bufs[n_bufs++] = uv_buf_init(end, 2);
+			}
+			bufs[n_bufs++] = uv_buf_init(size, slen);
+			bufs[n_bufs++] = uv_buf_init(body + off, (unsigned int)clen);
+		}
+		bufs[n_bufs++] = uv_buf_init(end, 7);
+	} else if (len) {
+		bufs[n_bufs++] = uv_buf_init(body, (unsigned int)len);
+	}
+	for (size_t i = 0; i < n_bufs; i++) {
+		server->stats.bytes_out += bufs[i].len;
+	}
+	int r = uv_write(&w->req, (uv_stream_t *)&client->tcp, bufs, (unsigned int)n_bufs, rtr_http_write_cb);
+	free(bufs);
+	if (r) {
+		http_logf(server->core, "http: cannot write to %s: %s\n", client->peer, uv_strerror(r));
+		free(w->head);
+		free(w->body);
+		free(w->chunks);
+		free(w);
+		rtr_http_client_close(client);
+		return;
+	}
+	client->pending_writes++;
+	if (!keep_alive) {
+		client->draining = true;
+		uv_read_stop((uv_stream_t *)&client->tcp);
+	}
+	return;
+fail:
+	if (w) {
+		free(w->head);
+		free(w->chunks);
+		free(w);
+	}
+	free(bufs);
+	free(body);
+	rtr_http_client_close(client);
+}
+
+static void rtr_http_respond_str(RtrHttpClient *client, const RtrHttpRequest *req, int code, const char *headers, const char *body) {
+	rtr_http_respond(client, req, code, headers, strdup(body), strlen(body));
+}
+
+static void rtr_http_request_fini(RtrHttpRequest *req) {
+	free(req->head);
+	free(req->path);
+}
+
+/**
+ * Parses the request at the beginning of \p buf.
+ *
+ * \return 1 when a request is parsed and \p consumed is set to its size,
+ *         0 when more bytes are needed, -1 for a bad request and -2 when
+ *         the request is too large
+ */
+static int rtr_http_parse(const char *buf, size_t len, RtrHttpRequest *req, size_t *consumed) {
+	memset(req, 0, sizeof(*req));
+	size_t hlen = RZ_MIN(len, RTR_HTTP_MAX_HEADERS);
+	const char *crlf = (const char *)rz_mem_mem((const ut8 *)buf, (int)hlen, (const ut8 *)"\r\n\r\n", 4);
+	const char *lf = (const char *)rz_mem_mem((const ut8 *)buf, (int)hlen, (const ut8 *)"\n\n", 2);
+	const char *end = crlf && (!lf || crlf < lf) ? crlf + 4 : lf ? lf + 2 : NULL;
+	if (!end) {
+		return len >= RTR_HTTP_MAX_HEADERS ? -2 : 0;
+	}
+	req->head = rz_str_ndup(buf, end - buf);
+	if (!req->head) {
+		return -1;
+	}
+	char *line = req->head;
+	char *next = strchr(line, '\n');
+	*next++ = '\0';
+	rz_str_trim_tail(line);
+	char *path = strchr(line, ' ');
+	char *version = path ? strchr(path + 1, ' ') : NULL;
+	if (!path || !version) {
+		goto bad;
+	}
+	*path++ = '\0';
+	*version++ = '\0';
+	req->method = line;
+	req->path = strdup(path);
+	req->http11 = !strcmp(version, "HTTP/1.1");
+	req->keep_alive = req->http11;
+	size_t body_len = 0;
+	while ((line = next) && *line) {
+		next = strchr(line, '\n');
+		if (next) {
+			*next++ = '\0';
+		}
+		rz_str_trim_tail(line);
+		char *value = strchr(line, ':');
+		if (!value) {
+			continue;
+		}
+		*value++ = '\0';
+		value = (char *)rz_str_trim_head_ro(value);
+		if (!rz_str_casecmp(line, "Content-Length")) {
+			body_len = strtoull(value, NULL, 10);
+		} else if (!rz_str_casecmp(line, "Connection")) {
+			if (!rz_str_casecmp(value, "close")) {
+				req->keep_alive = false;
+			} else if (!rz_str_casecmp(value, "keep-alive")) {
+				req->keep_alive = true;
+			}
+		} else if (!rz_str_casecmp(line, "Referer")) {
+			req->referer = value;
+		} else if (!rz_str_casecmp(line, "Transfer-Encoding")) {
+			// chunked requests are not supported
+			goto bad;
+		}
+	}
+	if (!req->path) {
+		goto bad;
+	}
+	if (body_len > RTR_HTTP_MAX_BODY) {
+		rtr_http_request_fini(req);
+		return -2;
+	}
+	size_t head_len = end - buf;
+	if (len - head_len < body_len) {
+		rtr_http_request_fini(req);
+		return 0;
+	}
+	req->body = buf + head_len;
+	req->body_len = body_len;
+	*consumed = head_len + body_len;
+	return 1;
+bad:
+	rtr_http_request_fini(req);
+	return -1;
+}
+
+/**
+ * Runs \p cmd with the seek and the block of the server, restoring the
+ * ones of the user afterwards, as the blocking server does
+ */
+static char *rtr_http_cmd(RtrHttpServer *server, const char *cmd) {
+	RzCore *core = server->core;
+	server->stats.commands++;
+	rz_cons_sleep_end(server->bed);
+	ut64 origoff = core->offset;
+	ut8 *origblk = core->block;
+	ut32 origblksz = core->blocksize;
+	core->offset = server->offset;
+	core->block = server->block;
+	core->blocksize = server->blocksize;
+	rz_config_set(core->config, "scr.interactive", "false");
+	char *out = NULL;
+	if (*cmd == ':') {
+		/* commands starting with : do not show any output */
+		rz_core_cmd0(core, cmd + 1);
+	} else {
+		out = rz_core_cmd_str_pipe(core, cmd);
+	}
+	server->offset = core->offset;
+	server->block = core->block;
+	server->blocksize = core->blocksize;
+	core->offset = origoff;
+	core->block = origblk;
+	core->blocksize = origblksz;
+	server->bed = rz_cons_sleep_begin();
+	return out;
+}
+
+static bool rtr_http_referer_ok(RtrHttpServer *server, const RtrHttpRequest *req) {
+	const char *httpref = rz_config_get(server->core->config, "http.referer");
+	if (RZ_STR_ISEMPTY(httpref)) {
+		return true;
+	}
+	char *refstr = strstr(httpref, "http") ? strdup(httpref) : rz_str_newf("http://localhost:%d/", server->port);
+	bool ok = req->referer && refstr && strstr(req->referer, refstr);
+	free(refstr);
+	return ok;
+}
+
+static void rtr_http_serve_cmd(RtrHttpClient *client, RtrHttpRequest *req) {
+	RtrHttpServer *server = client->server;
+	RzCore *core = server->core;
+	char *cmd = req->path + 5;
+	if (rz_config_get_b(core->config, "http.colon") && *cmd != ':') {
+		rtr_http_respond_str(client, req, 403, NULL, "Permission denied");
+		return;
+	}
+	if (!rtr_http_referer_ok(server, req)) {
+		rtr_http_respond_str(client, req, 503, NULL, "");
+		return;
+	}
+	rz_str_uri_decode(cmd);
+	if (!strcmp(cmd, "Rh*") || !strcmp(cmd, "Rh--")) {
+		// restart or stop the server once the responses are sent
+		server->ret = !strcmp(cmd, "Rh*") ? -2 : 0;
+		server->stop_pending = true;
+		void **it;
+		rz_pvector_foreach (&server->clients, it) {
+			uv_read_stop((uv_stream_t *)&((RtrHttpClient *)*it)->tcp);
+		}
+		req->keep_alive = false;
+		rtr_http_respond_str(client, req, 200, NULL, "");
+		return;
+	}
+	char *out = rtr_http_cmd(server, cmd);
+	size_t len = out ? strlen(out) : 0;
+	rtr_http_respond(client, req, 200, "Content-Type: text/plain\r\n", out, len);
+}
+
+static void rtr_http_serve_cmds(RtrHttpClient *client, const RtrHttpRequest *req) {
+	RtrHttpServer *server = client->server;
+	bool colon = rz_config_get_b(server->core->config, "http.colon");
+	if (!rtr_http_referer_ok(server, req)) {
+		rtr_http_respond_str(client, req, 503, NULL, "");
+		return;
+	}
+	char *cmds = rz_str_ndup(req->body, req->body_len);
+	PJ *pj = pj_new();
+	if (!cmds || !pj) {
+		free(cmds);
+		pj_free(pj);
+		rtr_http_respond_str(client, req, 503, NULL, "");
+		return;
+	}
+	pj_a(pj);
+	char *line = cmds;
+	while (line) {
+		char *next = strchr(line, '\n');
+		if (next) {
+			*next++ = '\0';
+		}
+		rz_str_trim_tail(line);
+		if (*line) {
+			if (colon && *line != ':') {
+				pj_null(pj);
+			} else {
+				char *out = rtr_http_cmd(server, line);
+				pj_s(pj, out ? out : "");
+				free(out);
+			}
+		}
+		line = next;
+	}
+	pj_end(pj);
+	free(cmds);
+	char *out = pj_drain(pj);
+	size_t len = out ? strlen(out) : 0;
+	rtr_http_respond(client, req, 200, "Content-Type: application/json\r\n", out, len);
+}
+
+static void rtr_http_serve_stats(RtrHttpClient *client, const RtrHttpRequest *req) {
+	RtrHttpStats *st = &client->server->stats;
+	PJ *pj = pj_new();
+	if (!pj) {
+		rtr_http_respond_str(client, req, 503, NULL, "");
+		return;
+	}
+	pj_o(pj);
+	pj_kn(pj, "uptime_us", rz_time_now_mono() - st->started);
+	pj_kn(pj, "connections", st->connections);
+	pj_kn(pj, "open_connections", rz_pvector_len(&client->server->clients));
+	pj_kn(pj, "requests", st->requests);
+	pj_kn(pj, "commands", st->commands);
+	pj_kn(pj, "bytes_in", st->bytes_in);
+	pj_kn(pj, "bytes_out", st->bytes_out);
+	pj_kn(pj, "latency_total_us", st->latency_total);
+	pj_kn(pj, "latency_avg_us", st->requests ? st->latency_total / st->requests : 0);
+	pj_kn(pj, "latency_max_us", st->latency_max);
+	pj_end(pj);
+	char *out = pj_drain(pj);
+	size_t len = out ? strlen(out) : 0;
+	rtr_http_respond(client, req, 200, "Content-Type: application/json\r\n", out, len);
+}
+
+static void rtr_http_serve_file(RtrHttpClient *client, const RtrHttpRequest *req) {
+	RzCore *core = client->server->core;
+	const char *index = rz_config_get(core->config, "http.index");
+	const char *root = rz_config_get(core->config, "http.root");
+	const char *homeroot = rz_config_get(core->config, "http.homeroot");
+	char *rpath = NULL;
+	char *path = NULL;
+	if (!strcmp(req->path, "/")) {
+		if (*index == '/') {
+			path = strdup(index);
+		} else {
+			rpath = rz_str_newf("/%s", index);
+			path = rz_file_root(root, rpath);
+		}
+	} else if (RZ_STR_ISNOTEMPTY(homeroot)) {
+		char *homepath = rz_file_abspath(homeroot);
+		path = rz_file_root(homepath, req->path);
+		free(homepath);
+		if (!rz_file_exists(path) && !rz_file_is_directory(path)) {
+			free(path);
+			path = rz_file_root(root, req->path);
+		}
+	} else {
+		path = rz_file_root(root, req->path);
+	}
+	const char *p = rpath ? rpath : req->path;
+	if (p[strlen(p) - 1] == '/') {
+		if (*index == '/') {
+			free(path);
+			path = strdup(index);
+		} else {
+			path = rz_str_append(path, index);
+		}
+	} else if (path && rz_file_is_directory(path)) {
+		char *hdr = rz_str_newf("Location: %s/\r\n", p);
+		rtr_http_respond_str(client, req, 302, hdr, "");
+		free(hdr);
+		goto beach;
+	}
+	if (path && rz_file_exists(path)) {
+		size_t sz = 0;
+		char *f = rz_file_slurp(path, &sz);
+		if (f) {
+			const char *ct = "";
+			if (strstr(path, ".js")) {
+				ct = "Content-Type: application/javascript\r\n";
+			}
+			if (strstr(path, ".css")) {
+				ct = "Content-Type: text/css\r\n";
+			}
+			if (strstr(path, ".html")) {
+				ct = "Content-Type: text/html\r\n";
+			}
+			rtr_http_respond(client, req, 200, ct, f, sz);
+		} else {
+			rtr_http_respond_str(client, req, 403, NULL, "Permission denied");
+			http_logf(core, "http: Cannot open '%s'\n", path);
+		}
+	} else if (rz_config_get_b(core->config, "http.dirlist") && rz_file_is_directory(req->path)) {
+		char *resp = rtr_dir_files(req->path);
+		http_logf(core, "Dirlisting %s\n", req->path);
+		rtr_http_respond(client, req, 404, NULL, resp, resp ? strlen(resp) : 0);
+	} else {
+		http_logf(core, "File '%s' not found\n", path ? path : req->path);
+		rtr_http_respond_str(client, req, 404, NULL, "File not found\n");
+	}
+beach:
+	free(path);
+	free(rpath);
+}
+
+static void rtr_http_serve(RtrHttpClient *client, RtrHttpRequest *req) {
+	RtrHttpServer *server = client->server;
+	RzCore *core = server->core;
+	ut64 start = rz_time_now_mono();
+	server->stats.requests++;
+	if (rz_config_get_b(core->config, "http.verbose")) {
+		http_logf(core, "[HTTP] %s %s %s\n", client->peer, req->method, req->path);
+	}
+	if (!strcmp(req->method, "OPTIONS")) {
+		rtr_http_respond_str(client, req, 200, NULL, "");
+	} else if (!strcmp(req->method, "GET")) {
+		if (!strncmp(req->path, "/cmd/", 5)) {
+			rtr_http_serve_cmd(client, req);
+		} else if (!strcmp(req->path, "/stats")) {
+			rtr_http_serve_stats(client, req);
+		} else if (!strncmp(req->path, "/up/", 4)) {
+			rtr_http_respond_str(client, req, 403, NULL, "");
+		} else {
+			rtr_http_serve_file(client, req);
+		}
+	} else if (!strcmp(req->method, "POST")) {
+		if (!strcmp(req->path, "/cmds")) {
+			rtr_http_serve_cmds(client, req);
+		} else {
+			rtr_http_respond_str(client, req, 403, NULL, "403 Forbidden\n");
+		}
+	} else {
+		rtr_http_respond_str(client, req, 404, NULL, "Invalid protocol");
+	}
+	ut64 latency = rz_time_now_mono() - start;
+	server->stats.latency_total += latency;
+	server->stats.latency_max = RZ_MAX(server->stats.latency_max, latency);
+}
+
+static void rtr_http_alloc_cb(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
+	RtrHttpClient *client = handle->data;
+	if (client->in_size - client->in_len < RTR_HTTP_READ_SIZE) {
+		size_t size = client->in_size + RZ_MAX(client->in_size, RTR_HTTP_READ_SIZE);
+		char *in = size <= RTR_HTTP_MAX_HEADERS + RTR_HTTP_MAX_BODY ? realloc(client->in, size) : NULL;
+		if (!in) {
+			// makes the read fail with UV_ENOBUFS
+			*buf = uv_buf_init(NULL, 0);
+			return;
+		}
+		client->in = in;
+		client->in_size = size;
+	}
+	*buf = uv_buf_init(client->in + client->in_len, (unsigned int)(client->in_size - client->in_len));
+}
+
+static void rtr_http_read_cb(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
+	RtrHttpClient *client = stream->data;
+	RtrHttpServer *server = client->server;
+	if (nread < 0) {
+		if (nread != UV_EOF) {
+			http_logf(server->core, "http: cannot read from %s: %s\n", client->peer, uv_err_name((int)nread));
+		}
+		rtr_http_client_close(client);
+		return;
+	}
+	client->in_len += nread;
+	server->stats.bytes_in += nread;
+	rtr_http_touch(client);
+	// answer every complete request received, in order
+	size_t off = 0;
+	while (!client->closing && !client->draining && !server->stop_pending) {
+		RtrHttpRequest req;
+		size_t consumed = 0;
+		int r = rtr_http_parse(client->in + off, client->in_len - off, &req, &consumed);
+		if (!r) {
+			break;
+		}
+		if (r < 0) {
+			http_logf(server->core, "Invalid http headers received from client\n");
+			rtr_http_respond_str(client, NULL, r == -2 ? 413 : 400, NULL, "");
+			break;
+		}
+		rtr_http_serve(client, &req);
+		rtr_http_request_fini(&req);
+		off += consumed;
+	}
+	if (!client->closing && off) {
+		memmove(client->in, client->in + off, client->in_len - off);
+		client->in_len -= off;
+	}
+}
+
+static bool rtr_http_peer_allowed(RtrHttpServer *server, const char *peer) {
+	const char *allow = rz_config_get(server->core->config, "http.allow");
+	if (RZ_STR_ISEMPTY(allow)) {
+		return true;
+	}
+	RzList *hosts = rz_str_split_duplist(allow, ",", true);
+	bool allowed = hosts && rz_list_find(hosts, peer, (RzListComparator)strcmp);
+	rz_list_free(hosts);
+	return allowed;
+}
+
+static void rtr_http_connection_cb(uv_stream_t *stream, int status) {
+	RtrHttpServer *server = stream->data;
+	if (status < 0) {
+		http_logf(server->core, "http: connection error: %s\n", uv_strerror(status));
+		return;
+	}
+	RtrHttpClient *client = RZ_NEW0(RtrHttpClient);
+	if (!client) {
+		return;
+	}
+	client->server = server;
+	uv_tcp_init(stream->loop, &client->tcp);
+	uv_timer_init(stream->loop, &client->timer);
+	client->tcp.data = client;
+	client->timer.data = client;
+	client->handles = 2;
+	rz_pvector_push(&server->clients, client);
+	if (uv_accept(stream, (uv_stream_t *)&client->tcp)) {
+		rtr_http_client_close(client);
+		return;
+	}
+	struct sockaddr_storage addr = { 0 };
+	int addr_len = sizeof(addr);
+	if (!uv_tcp_getpeername(&client->tcp, (struct sockaddr *)&addr, &addr_len)) {
+		if (addr.ss_family == AF_INET6) {
+			uv_ip6_name((struct sockaddr_in6 *)&addr, client->peer, sizeof(client->peer));
+		} else {
+			uv_ip4_name((struct sockaddr_in *)&addr, client->peer, sizeof(client->peer));
+		}
+	}
+	if (server->stop_pending || !rtr_http_peer_allowed(server, client->peer)) {
+		rtr_http_client_close(client);
+		return;
+	}
+	server->stats.connections++;
+	activateDieTime(server->core);
+	uv_tcp_nodelay(&client->tcp, 1);
+	rtr_http_touch(client);
+	uv_read_start((uv_stream_t *)&client->tcp, rtr_http_alloc_cb, rtr_http_read_cb);
+}
+
+static int rtr_http_listen(RtrHttpServer *server, uv_tcp_t *tcp, const char *ip, bool ipv6) {
+	struct sockaddr_storage addr = { 0 };
+	int r = ipv6
+		? uv_ip6_addr(ip, server->port, (struct sockaddr_in6 *)&addr)
+		: uv_ip4_addr(ip, server->port, (struct sockaddr_in *)&addr);
+	if (!r) {
+		// IPv6 only, so that the IPv4 listener can use the same port
+		r = uv_tcp_bind(tcp, (const struct sockaddr *)&addr, ipv6 ? UV_TCP_IPV6ONLY : 0);
+	}
+	if (!r) {
+		r = uv_listen((uv_stream_t *)tcp, 128, rtr_http_connection_cb);
+	}
+	return r;
+}
+
+/* port the listener is bound to, the one picked by the system for http.port=0 */
+static int rtr_http_bound_port(uv_tcp_t *tcp) {
+	struct sockaddr_storage addr = { 0 };
+	int len = sizeof(addr);
+	if (uv_tcp_getsockname(tcp, (struct sockaddr *)&addr, &len)) {
+		return 0;
+	}
+	return addr.ss_family == AF_INET6
+		? ntohs(((struct sockaddr_in6 *)&addr)->sin6_port)
+		: ntohs(((struct sockaddr_in *)&addr)->sin_port);
+}
+
+static bool rtr_http_uv_usable(RzCore *core) {
+	return !rz_config_get_b(core->config, "http.auth") &&
+		!rz_config_get_b(core->config, "http.upload") &&
+		!rz_config_get_b(core->config, "http.upget") &&
+		RZ_STR_ISEMPTY(rz_config_get(core->config, "http.uri"));
+}
+
+static int rtr_http_uv_run(RzCore *core, int browse, const char *path, const char *host, const char *port) {
+	RtrHttpServer server = { 0 };
+	server.core = core;
+	server.port = atoi(port);
+	server.timeout = rz_config_get_i(core->config, "http.timeout") * 1000;
+	server.stats.started = rz_time_now_mono();
+	rz_pvector_init(&server.clients, NULL);
+	if (rz_config_get_b(core->config, "http.cors")) {
+		server.headers = strdup("Access-Control-Allow-Origin: *\r\n"
+					"Access-Control-Allow-Headers: Origin, "
+					"X-Requested-With, Content-Type, Accept\r\n");
+	}
+	bool local = rtr_http_bind_local(core, &host);
+
+	uv_loop_t *loop = RZ_NEW(uv_loop_t);
+	if (!loop || uv_loop_init(loop)) {
+		free(loop);
+		free(server.headers);
+		return 1;
+	}
+	uv_tcp_init(loop, &server.tcp);
+	uv_tcp_init(loop, &server.tcp6);
+	uv_async_init(loop, &server.stop_async, rtr_http_stop_cb);
+	server.tcp.data = &server;
+	server.tcp6.data = &server;
+	server.stop_async.data = &server;
+	// serving as long as either IPv4 or IPv6 is available
+	// with port 0 the IPv6 listener reuses the port the system gave to the IPv4 one
+	bool anyport = !server.port;
+	int r4 = rtr_http_listen(&server, &server.tcp, local ? "127.0.0.1" : "0.0.0.0", false);
+	if (!r4 && anyport) {
+		server.port = rtr_http_bound_port(&server.tcp);
+	}
+	int r6 = rtr_http_listen(&server, &server.tcp6, local ? "::1" : "::", true);
+	if (r4 && !r6 && anyport) {
+		server.port = rtr_http_bound_port(&server.tcp6);
+	}
+	server.offset = core->offset;
+	server.blocksize = core->blocksize;
+	server.block = rz_mem_dup(core->block, core->blocksize);
+	if ((r4 && r6) || !server.block) {
+		eprintf("Cannot listen on http.port\n");
+		rtr_http_server_stop(&server);
+		uv_run(loop, UV_RUN_DEFAULT);
+		server.ret = 1;
+		goto beach;
+	}
+
+	char portstr[16];
+	snprintf(portstr, sizeof(portstr), "%d", server.port);
+	if (browse == 'H') {
+		rtr_http_browse(core, host, portstr, path);
+	}
+	RzConfig *origcfg = core->config;
+	RzConfig *newcfg = rtr_http_config_new(core);
+	if (newcfg) {
+		core->config = newcfg;
+		// the port actually served, readable while the server runs
+		rz_config_set(newcfg, "http.port", portstr);
+	}
+	eprintf("Starting http server...\n");
+	eprintf("open http://%s:%d/\n", host, server.port);
+	eprintf("rizin -C http://%s:%d/cmd/\n", host, server.port);
+	core->http_up = true;
+	activateDieTime(core);
+
+	rz_cons_break_push((RzConsBreak)rtr_http_break, &server);
+	server.bed = rz_cons_sleep_begin();
+	uv_run(loop, UV_RUN_DEFAULT);
+	rz_cons_sleep_end(server.bed);
+	rz_cons_break_pop();
+
+	if (rz_config_get_b(core->config, "http.verbose")) {
+		RtrHttpStats *st = &server.stats;
+		http_logf(core, "[HTTP] %" PFMT64u " requests on %" PFMT64u " connections, %" PFMT64u " us max latency\n",
+			st->requests, st->connections, st->latency_max);
+	}
+	core->http_up = false;
+	if (newcfg) {
+		rtr_http_config_restore(core, origcfg);
+		rz_config_free(newcfg);
+		if (anyport) {
+			rz_config_set(core->config, "http.port", "0");
+		}
+	}
+beach:
+	uv_loop_close(loop);
+	free(loop);
+	rz_pvector_fini(&server.clients);
+	free(server.headers);
+	free(server.block);
+	return server.ret;
+}
+
+#endif
+
 // return 1 on error
 static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char *path) {
 	RzConfig *newcfg = NULL, *origcfg = NULL;
@@ -40,6 +937,11 @@ static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char
 		path = NULL;
 	}
 
+#if HAVE_LIBUV
+	if (rtr_http_uv_usable(core)) {
+		return rtr_http_uv_run(core, browse, path, host, port);
+	}
+#endif
 	if (!strcmp(port, "0")) {
 		rz_num_irand();
 		iport = 1024 + rz_num_rand(45256);
@@ -47,30 +949,8 @@ static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char
 		port = buf;
 	}
 	s = rz_socket_new(false);
-	{
-		if (host && *host) {
-			if (!strcmp(host, "::1")) {
-				s->local = true;
-			} else if (!strcmp(host, "localhost")) {
-				s->local = true;
-			} else if (!strcmp(host, "127.0.0.1")) {
-				s->local = true;
-			} else if (!strcmp(host, "local")) {
-				s->local = true;
-				rz_config_set(core->config, "http.bind", "localhost");
-			} else if (host[0] == '0' || !strcmp(host, "public")) {
-				// public
-				host = "127.0.0.1";
-				rz_config_set(core->config, "http.bind", "0.0.0.0");
-				s->local = false;
-			} else {
-				s->local = true;
-			}
-		} else {
-			s->local = true;
-		}
-		memset(&so, 0, sizeof(so));
-	}
+	s->local = rtr_http_bind_local(core, &host);
+	memset(&so, 0, sizeof(so));
 	if (!rz_socket_listen(s, port, NULL)) {
 		rz_socket_free(s);
 		eprintf("Cannot listen on http.port\n");
@@ -78,9 +958,7 @@ static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char
 	}
 
 	if (browse == 'H') {
-		const char *browser = rz_config_get(core->config, "http.browser");
-		rz_sys_cmdf("%s http://%s:%d/%s &",
-			browser, host, atoi(port), path ? path : "");
+		rtr_http_browse(core, host, port, path);
 	}
 
 	so.httpauth = rz_config_get_i(core->config, "http.auth");
@@ -107,17 +985,8 @@ static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char
 	}
 
 	origcfg = core->config;
-	newcfg = rz_config_clone(core->config);
+	newcfg = rtr_http_config_new(core);
 	core->config = newcfg;
-
-	rz_config_set(core->config, "asm.cmt.right", "false");
-#if 0
-	// WHY
-	rz_config_set (core->config, "scr.html", "true");
-#endif
-	rz_config_set_i(core->config, "scr.color", COLOR_MODE_DISABLED);
-	rz_config_set(core->config, "asm.bytes", "false");
-	rz_config_set(core->config, "scr.interactive", "false");
 	eprintf("Starting http server...\n");
 	eprintf("open http://%s:%d/\n", host, atoi(port));
 	eprintf("rizin -C http://%s:%d/cmd/\n", host, atoi(port));
@@ -463,28 +1332,13 @@ static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char
 		rz_socket_http_close(rs);
 		free(dir);
 	}
-the_end : {
-	int timeout = rz_config_get_i(core->config, "http.timeout");
-	const char *host = rz_config_get(core->config, "http.bind");
-	const char *port = rz_config_get(core->config, "http.port");
-	const char *cors = rz_config_get(core->config, "http.cors");
-	const char *allow = rz_config_get(core->config, "http.allow");
-	core->config = origcfg;
-	rz_config_set_i(core->config, "http.timeout", timeout);
-	rz_config_set(core->config, "http.bind", host);
-	rz_config_set(core->config, "http.port", port);
-	rz_config_set(core->config, "http.cors", cors);
-	rz_config_set(core->config, "http.allow", allow);
-}
+the_end:
+	rtr_http_config_restore(core, origcfg);
 	rz_cons_break_pop();
 	core->http_up = false;
 	free(pfile);
 	rz_socket_free(s);
 	rz_config_free(newcfg);
-	/* refresh settings - run callbacks */
-	rz_config_set(origcfg, "scr.html", rz_config_get(origcfg, "scr.html"));
-	rz_config_set_i(origcfg, "scr.color", rz_config_get_i(origcfg, "scr.color"));
-	rz_config_set(origcfg, "scr.interactive", rz_config_get(origcfg, "scr.interactive"));
 	return ret;
 }
 
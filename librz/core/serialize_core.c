@@ -12,6 +12,7 @@
  *   /flags => see flag.c
  *   /analysis => see analysis.c
  *   /file => see below
+ *   /rop => see crop.c, only when gadgets have been indexed
  *   offset=<offset>
  *   blocksize=<blocksize>
  */
@@ -26,6 +27,9 @@ RZ_API void rz_serialize_core_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzCore *core,
 	rz_serialize_flag_save(sdb_ns(db, "flags", true), core->flags);
 	rz_serialize_analysis_save(sdb_ns(db, "analysis", true), core->analysis);
 	rz_serialize_debug_save(sdb_ns(db, "debug", true), core->dbg);
+	if (core->rop_index) {
+		rz_core_rop_index_save(sdb_ns(db, "rop", true), core->rop_index);
+	}
 
 	char buf[0x20];
 	if (snprintf(buf, sizeof(buf), "0x%" PFMT64x, core->offset) < 0) {
@@ -81,6 +85,17 @@ RZ_API bool rz_serialize_core_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzCore *core,
 	SUB("analysis", rz_serialize_analysis_load(subdb, core->analysis, res));
 	SUB("debug", rz_serialize_debug_load(subdb, core->dbg, res));
 
+	rz_core_rop_index_free(core->rop_index);
+	core->rop_index = NULL;
+	subdb = sdb_ns(db, "rop", false);
+	if (subdb) {
+		core->rop_index = rz_core_rop_index_load(subdb);
+		if (!core->rop_index) {
+			RZ_SERIALIZE_ERR(res, "failed to load the ROP gadget index");
+			return false;
+		}
+	}
+
 	const char *str = sdb_get(db, "offset", 0);
 	if (!str || !*str) {
 		RZ_SERIALIZE_ERR(res, "missing offset in core");
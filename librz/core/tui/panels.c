@@ -4757,7 +4757,12 @@ void __panels_refresh(RzCore *core) {
 	if (core->scr_gadgets) {
 		rz_core_gadget_print(core);
 	}
-	rz_cons_flush();
+	if (core->cons->damage) {
+		// only the cells changed since the last refresh are written
+		rz_cons_visual_flush();
+	} else {
+		rz_cons_flush();
+	}
 	if (rz_cons_singleton()->fps) {
 		rz_cons_print_fps(40);
 	}
@@ -696,6 +696,7 @@ RZ_API RzDebugReasonType rz_debug_wait(RzDebug *dbg, RzBreakpointItem **bp) {
 	/* if our debugger plugin has wait */
 	if (dbg->cur && dbg->cur->wait) {
 		reason = dbg->cur->wait(dbg, dbg->pid);
+		dbg->stops++;
 		if (reason == RZ_DEBUG_REASON_DEAD) {
 			eprintf("\n==> Process finished\n\n");
 			RzEventDebugProcessFinished event = {
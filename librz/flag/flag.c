@@ -45,6 +45,15 @@ static int flag_skiplist_cmp(const void *va, const void *vb) {
 	return a->off < b->off ? -1 : 1;
 }
 
+static int flag_name_cmp(void *incoming, void *in, void *user) {
+	return strcmp(((RzFlagItem *)incoming)->name, ((RzFlagItem *)in)->name);
+}
+
+static int flag_name_prefix_cmp(const void *incoming, const RBNode *in_tree, void *user) {
+	const RzFlagItem *fi = container_of(in_tree, const RContRBNode, node)->data;
+	return strcmp(incoming, fi->name);
+}
+
 static ut64 num_callback(RzNum *user, const char *name, int *ok) {
 	RzFlag *f = (RzFlag *)user;
 	if (ok) {
@@ -159,6 +168,23 @@ static bool update_flag_item_offset(RzFlag *f, RzFlagItem *item, ut64 newoff, bo
 	return false;
 }
 
+/* takes the ownership of fname, which must be already filtered */
+static bool update_flag_item_filtered_name(RzFlag *f, RzFlagItem *item, char *fname) {
+	bool res = (item->name)
+		? ht_pp_update_key(f->ht_name, item->name, fname)
+		: ht_pp_insert(f->ht_name, fname, item);
+	if (res) {
+		if (item->name) {
+			rz_rbtree_cont_delete(f->by_name, item, flag_name_cmp, NULL);
+		}
+		set_name(item, fname);
+		rz_rbtree_cont_insert(f->by_name, item, flag_name_cmp, NULL);
+		return true;
+	}
+	free(fname);
+	return false;
+}
+
 static bool update_flag_item_name(RzFlag *f, RzFlagItem *item, const char *newname, bool force) {
 	if (!f || !item || !newname) {
 		return false;
@@ -170,15 +196,7 @@ static bool update_flag_item_name(RzFlag *f, RzFlagItem *item, const char *newna
 	if (!fname) {
 		return false;
 	}
-	bool res = (item->name)
-		? ht_pp_update_key(f->ht_name, item->name, fname)
-		: ht_pp_insert(f->ht_name, fname, item);
-	if (res) {
-		set_name(item, fname);
-		return true;
-	}
-	free(fname);
-	return false;
+	return update_flag_item_filtered_name(f, item, fname);
 }
 
 static void ht_free_flag(HtPPKv *kv) {
@@ -232,6 +250,7 @@ RZ_API RzFlag *rz_flag_new(void) {
 	f->zones = NULL;
 	f->tags = sdb_new0();
 	f->ht_name = ht_pp_new(NULL, ht_free_flag, NULL);
+	f->by_name = rz_rbtree_cont_new();
 	f->by_off = rz_skiplist_new(flag_skiplist_free, flag_skiplist_cmp);
 	rz_list_free(f->zones);
 	new_spaces(f);
@@ -272,6 +291,7 @@ RZ_API void rz_flag_item_free(RzFlagItem *item) {
 RZ_API RzFlag *rz_flag_free(RzFlag *f) {
 	rz_return_val_if_fail(f, NULL);
 	rz_skiplist_free(f->by_off);
+	rz_rbtree_cont_free(f->by_name);
 	ht_pp_free(f->ht_name);
 	sdb_free(f->tags);
 	rz_spaces_fini(&f->spaces);
@@ -736,6 +756,80 @@ err:
 	return NULL;
 }
 
+/**
+ * \brief Returns \p name filtered as rz_flag_set() does for the flag names
+ *
+ * The result can be passed to rz_flag_set_bulk(), which expects filtered
+ * names. Filtering is independent of any RzFlag, so it can be done
+ * concurrently on many names.
+ */
+RZ_API RZ_OWN char *rz_flag_name_filter(RZ_NONNULL const char *name) {
+	rz_return_val_if_fail(name, NULL);
+	return filter_item_name(name);
+}
+
+static RzFlagItem *flag_set_filtered(RzFlag *f, RZ_OWN char *name, ut64 off, ut32 size, RzSpace *space) {
+	if (RZ_STR_ISEMPTY(name)) {
+		free(name);
+		return NULL;
+	}
+	RzFlagItem *item = rz_flag_get(f, name);
+	if (item && item->offset == off) {
+		item->size = size;
+		free(name);
+		return item;
+	}
+	bool is_new = !item;
+	if (is_new) {
+		item = RZ_NEW0(RzFlagItem);
+		if (!item) {
+			free(name);
+			return NULL;
+		}
+	}
+	item->space = space;
+	item->size = size;
+	update_flag_item_offset(f, item, off + f->base, is_new, true);
+	update_flag_item_filtered_name(f, item, name);
+	return item;
+}
+
+/**
+ * \brief Creates or modifies many flag items at once
+ *
+ * Each item is set as rz_flag_set() would do with the flag space of the
+ * item selected as the current one, in the order of \p items, then its
+ * realname (if not NULL) and demangled state are set. The names must be
+ * already filtered with rz_flag_name_filter(), so that the filtering of a
+ * large batch (e.g. the symbols of a binary) can be done out of the RzFlag
+ * and only once per name.
+ *
+ * \param f RzFlag instance
+ * \param items Items to set, the name of each one is owned and reset to
+ *        NULL, while the resulting flag item (or NULL on failure) is
+ *        stored into RzFlagBulkItem.item
+ * \param count Number of \p items
+ * \return Number of flag items set
+ */
+RZ_API size_t rz_flag_set_bulk(RZ_NONNULL RzFlag *f, RZ_NONNULL RZ_INOUT RzFlagBulkItem *items, size_t count) {
+	rz_return_val_if_fail(f && (items || !count), 0);
+	size_t set = 0;
+	for (size_t i = 0; i < count; i++) {
+		RzFlagBulkItem *bi = &items[i];
+		bi->item = flag_set_filtered(f, bi->name, bi->offset, bi->size, bi->space);
+		bi->name = NULL;
+		if (!bi->item) {
+			continue;
+		}
+		if (bi->realname) {
+			rz_flag_item_set_realname(bi->item, bi->realname);
+		}
+		bi->item->demangled = bi->demangled;
+		set++;
+	}
+	return set;
+}
+
 /* add/replace/remove the alias of a flag item */
 RZ_API void rz_flag_item_set_alias(RzFlagItem *item, const char *alias) {
 	rz_return_if_fail(item);
@@ -779,6 +873,7 @@ RZ_API int rz_flag_rename(RzFlag *f, RzFlagItem *item, const char *name) {
 RZ_API bool rz_flag_unset(RzFlag *f, RzFlagItem *item) {
 	rz_return_val_if_fail(f && item, false);
 	remove_offsetmap(f, item);
+	rz_rbtree_cont_delete(f->by_name, item, flag_name_cmp, NULL);
 	ht_pp_delete(f->ht_name, item->name);
 	return true;
 }
@@ -831,6 +926,8 @@ RZ_API bool rz_flag_unset_name(RzFlag *f, const char *name) {
 /* unset all flag items in the RzFlag f */
 RZ_API void rz_flag_unset_all(RzFlag *f) {
 	rz_return_if_fail(f);
+	rz_rbtree_cont_free(f->by_name);
+	f->by_name = rz_rbtree_cont_new();
 	ht_pp_free(f->ht_name);
 	f->ht_name = ht_pp_new(NULL, ht_free_flag, NULL);
 	rz_skiplist_purge(f->by_off);
@@ -929,6 +1026,9 @@ static bool flag_count_foreach(RzFlagItem *fi, void *user) {
 RZ_API int rz_flag_count(RzFlag *f, const char *glob) {
 	int count = 0;
 	rz_return_val_if_fail(f, -1);
+	if (!glob) {
+		return f->ht_name->count;
+	}
 	rz_flag_foreach_glob(f, glob, flag_count_foreach, &count);
 	return count;
 }
@@ -950,24 +1050,144 @@ RZ_API int rz_flag_count(RzFlag *f, const char *glob) {
 		} \
 	}
 
+typedef struct {
+	const char *pfx;
+	size_t pfx_len;
+	const char *glob;
+	const RzSpace *space;
+	bool any_space;
+} FlagNameFilter;
+
+static bool flag_name_filter_match(const FlagNameFilter *filter, RzFlagItem *fi) {
+	return !strncmp(fi->name, filter->pfx, filter->pfx_len) &&
+		(filter->any_space || IS_FI_IN_SPACE(fi, filter->space)) &&
+		(!filter->glob || rz_str_glob(fi->name, filter->glob));
+}
+
+static int offset_cmp(const void *a, const void *b) {
+	ut64 x = *(const ut64 *)a, y = *(const ut64 *)b;
+	return x < y ? -1 : x > y;
+}
+
+/**
+ * Calls \p cb for the flags matching \p filter, which must have a non
+ * empty name prefix, in the same order as FOREACH_BODY does.
+ *
+ * The names index is used to find the offsets of the matching flags, then
+ * the flags at each of these offsets are visited in order, so that only
+ * the flags sharing an offset with a matching one are checked.
+ */
+static void foreach_name_prefix(RzFlag *f, const FlagNameFilter *filter, RzFlagItemCb cb, void *user) {
+	if (!f->by_name->root) {
+		return;
+	}
+	RzVector offsets;
+	rz_vector_init(&offsets, sizeof(ut64), NULL, NULL);
+	char *pfx = rz_str_ndup(filter->pfx, filter->pfx_len);
+	if (!pfx) {
+		return;
+	}
+	RBIter it = rz_rbtree_lower_bound_forward(&f->by_name->root->node, pfx, flag_name_prefix_cmp, NULL);
+	free(pfx);
+	RContRBNode *rbn;
+	rz_rbtree_iter_while(it, rbn, RContRBNode, node) {
+		RzFlagItem *fi = rbn->data;
+		if (strncmp(fi->name, filter->pfx, filter->pfx_len)) {
+			break;
+		}
+		if (flag_name_filter_match(filter, fi)) {
+			rz_vector_push(&offsets, &fi->offset);
+		}
+	}
+	qsort(offsets.a, offsets.len, sizeof(ut64), offset_cmp);
+	for (size_t i = 0; i < offsets.len; i++) {
+		ut64 off = *(ut64 *)rz_vector_index_ptr(&offsets, i);
+		if (i && off == *(ut64 *)rz_vector_index_ptr(&offsets, i - 1)) {
+			continue;
+		}
+		RzFlagsAtOffset *flags_at = rz_flag_get_nearest_list(f, off, 0);
+		if (!flags_at) {
+			continue;
+		}
+		RzListIter *it2, *tmp2;
+		RzFlagItem *fi;
+		rz_list_foreach_safe (flags_at->flags, it2, tmp2, fi) {
+			if (flag_name_filter_match(filter, fi) && !cb(fi, user)) {
+				goto end;
+			}
+		}
+	}
+end:
+	rz_vector_fini(&offsets);
+}
+
+/**
+ * Sets the name prefix of \p filter to the literal characters \p glob
+ * starts with, which every name matched by rz_str_glob() starts with too.
+ */
+static void glob_literal_prefix(FlagNameFilter *filter, const char *glob) {
+	const char *begin = strchr(glob, '^');
+	filter->pfx = begin ? begin + 1 : glob;
+	filter->pfx_len = strcspn(filter->pfx, "*?$");
+}
+
 RZ_API void rz_flag_foreach(RzFlag *f, RzFlagItemCb cb, void *user) {
 	FOREACH_BODY(true);
 }
 
 RZ_API void rz_flag_foreach_prefix(RzFlag *f, const char *pfx, int pfx_len, RzFlagItemCb cb, void *user) {
 	pfx_len = pfx_len < 0 ? strlen(pfx) : pfx_len;
-	FOREACH_BODY(!strncmp(fi->name, pfx, pfx_len));
+	if (pfx_len > 0) {
+		FlagNameFilter filter = { .pfx = pfx, .pfx_len = pfx_len, .any_space = true };
+		foreach_name_prefix(f, &filter, cb, user);
+		return;
+	}
+	FOREACH_BODY(true);
 }
 
 RZ_API void rz_flag_foreach_range(RzFlag *f, ut64 from, ut64 to, RzFlagItemCb cb, void *user) {
-	FOREACH_BODY(fi->offset >= from && fi->offset < to);
+	RzFlagsAtOffset key = { .off = from };
+	RzSkipListNode *it = rz_skiplist_find_geq(f->by_off, &key), *tmp;
+	for (; it && it != f->by_off->head; it = tmp) {
+		tmp = it->forward[0];
+		RzFlagsAtOffset *flags_at = it->data;
+		if (!flags_at) {
+			continue;
+		}
+		if (flags_at->off >= to) {
+			break;
+		}
+		RzListIter *it2, *tmp2;
+		RzFlagItem *fi;
+		rz_list_foreach_safe (flags_at->flags, it2, tmp2, fi) {
+			if (fi->offset >= from && fi->offset < to && !cb(fi, user)) {
+				return;
+			}
+		}
+	}
 }
 
 RZ_API void rz_flag_foreach_glob(RzFlag *f, const char *glob, RzFlagItemCb cb, void *user) {
+	if (glob) {
+		FlagNameFilter filter = { .glob = glob, .any_space = true };
+		glob_literal_prefix(&filter, glob);
+		if (filter.pfx_len) {
+			foreach_name_prefix(f, &filter, cb, user);
+			return;
+		}
+	}
 	FOREACH_BODY(!glob || rz_str_glob(fi->name, glob));
 }
 
 RZ_API void rz_flag_foreach_space_glob(RzFlag *f, const char *glob, const RzSpace *space, RzFlagItemCb cb, void *user) {
+	if (glob) {
+		FlagNameFilter filter = { .glob = glob, .space = space };
+		glob_literal_prefix(&filter, glob);
+		if (filter.pfx_len) {
+			foreach_name_prefix(f, &filter, cb, user);
+			return;
+		}
+	}
 	FOREACH_BODY(IS_FI_IN_SPACE(fi, space) && (!glob || rz_str_glob(fi->name, glob)));
 }
 
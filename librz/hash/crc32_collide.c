@@ -0,0 +1,307 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_msg_digest.h>
+#include <rz_util.h>
+
+/*
+ * CRC-32 (ISO-HDLC, the one of the crc32 plugin) is linear: feeding the 4
+ * bytes x (read as a little endian word) to the register r gives the same
+ * register as feeding 4 zero bytes to r ^ x. So the 4 bytes which bring the
+ * register from r to any wanted value R are x = unzero4(R) ^ r, where
+ * unzero4() steps back over 4 zero bytes.
+ */
+
+#define CRC32_POLY 0xedb88320
+#define CRC32_INIT 0xffffffff
+#define CRC32_XOUT 0xffffffff
+
+// prefixes are searched on the calling thread until the keyspace is this big
+#define COLLIDE_SERIAL_KEYSPACE (1 << 16)
+#define COLLIDE_CHECK_BREAK     0x10000
+
+typedef struct {
+	ut32 table[256];
+	ut8 top_index[256]; ///< index of the table entry with the given top byte
+} Crc32Tables;
+
+typedef struct {
+	const Crc32Tables *t;
+	const ut8 *charset;
+	size_t charset_len;
+	bool allowed[256];
+	ut32 solve; ///< unzero4() of the register needed after the 4 solved bytes
+	size_t n_free; ///< bytes enumerated before the solved ones
+	size_t next_first; ///< next value of the first free byte to search
+	size_t finished; ///< threads done searching
+	bool stop;
+	bool found;
+	ut8 *result; ///< n_free + 4 bytes of the solution
+	RzThreadLock *lock;
+} CollideSearch;
+
+static void crc32_tables_init(Crc32Tables *t) {
+	for (ut32 i = 0; i < 256; i++) {
+		ut32 c = i;
+		for (int k = 0; k < 8; k++) {
+			c = c & 1 ? (c >> 1) ^ CRC32_POLY : c >> 1;
+		}
+		t->table[i] = c;
+		// the top bytes of the entries are all different
+		t->top_index[c >> 24] = i;
+	}
+}
+
+static inline ut32 crc32_step(const Crc32Tables *t, ut32 r, ut8 b) {
+	return (r >> 8) ^ t->table[(r ^ b) & 0xff];
+}
+
+static inline ut32 crc32_unstep(const Crc32Tables *t, ut32 r, ut8 b) {
+	ut8 idx = t->top_index[r >> 24];
+	return ((r ^ t->table[idx]) << 8) | (ut8)(idx ^ b);
+}
+
+static ut32 crc32_update(const Crc32Tables *t, ut32 r, const ut8 *buf, size_t size) {
+	for (size_t i = 0; i < size; i++) {
+		r = crc32_step(t, r, buf[i]);
+	}
+	return r;
+}
+
+/**
+ * Returns the unzero4() of the register needed before \p suffix to end with
+ * the crc \p target.
+ */
+static ut32 crc32_solve_suffix(const Crc32Tables *t, const ut8 *suffix, size_t size, ut32 target) {
+	ut32 r = target ^ CRC32_XOUT;
+	for (size_t i = size; i > 0; i--) {
+		r = crc32_unstep(t, r, suffix[i - 1]);
+	}
+	for (int i = 0; i < 4; i++) {
+		r = crc32_unstep(t, r, 0);
+	}
+	return r;
+}
+
+/**
+ * \brief Overwrites the 4 bytes at \p pos of \p buf so its CRC-32 becomes \p target
+ */
+RZ_API bool rz_hash_crc32_forge(RZ_NONNULL ut8 *buf, size_t size, size_t pos, ut32 target) {
+	rz_return_val_if_fail(buf, false);
+	if (size < 4 || pos > size - 4) {
+		return false;
+	}
+	Crc32Tables t;
+	crc32_tables_init(&t);
+	ut32 r = crc32_update(&t, CRC32_INIT, buf, pos);
+	ut32 x = crc32_solve_suffix(&t, buf + pos + 4, size - pos - 4, target) ^ r;
+	rz_write_le32(buf + pos, x);
+	return true;
+}
+
+static inline bool collide_allowed(const CollideSearch *s, ut32 x) {
+	return s->allowed[x & 0xff] && s->allowed[(x >> 8) & 0xff] &&
+		s->allowed[(x >> 16) & 0xff] && s->allowed[x >> 24];
+}
+
+static bool collide_should_stop(CollideSearch *s) {
+	rz_th_lock_enter(s->lock);
+	bool stop = s->stop || s->found;
+	rz_th_lock_leave(s->lock);
+	return stop;
+}
+
+static void collide_found(CollideSearch *s, const size_t *digits, ut32 x) {
+	rz_th_lock_enter(s->lock);
+	if (!s->found) {
+		s->found = true;
+		for (size_t i = 0; i < s->n_free; i++) {
+			s->result[i] = s->charset[digits[i]];
+		}
+		rz_write_le32(s->result + s->n_free, x);
+	}
+	rz_th_lock_leave(s->lock);
+}
+
+/**
+ * Searches all the prefixes starting with the charset byte \p first, updating
+ * only the registers after the bytes changed by each increment.
+ * \p is_breaked is polled only by the thread which owns it, others get NULL.
+ */
+static bool collide_search_first(CollideSearch *s, size_t first, size_t *digits, ut32 *regs, RzHashCollideBreak is_breaked) {
+	const Crc32Tables *t = s->t;
+	size_t n = s->n_free;
+	memset(digits, 0, n * sizeof(*digits));
+	digits[0] = first;
+	for (size_t i = 0; i < n; i++) {
+		regs[i + 1] = crc32_step(t, regs[i], s->charset[digits[i]]);
+	}
+	size_t checked = 0;
+	while (true) {
+		ut32 x = s->solve ^ regs[n];
+		if (collide_allowed(s, x)) {
+			collide_found(s, digits, x);
+			return true;
+		}
+		if (++checked % COLLIDE_CHECK_BREAK == 0 && (collide_should_stop(s) || (is_breaked && is_breaked()))) {
+			return false;
+		}
+		size_t p = n - 1;
+		while (p > 0 && ++digits[p] == s->charset_len) {
+			digits[p--] = 0;
+		}
+		if (!p) {
+			return false;
+		}
+		for (size_t i = p; i < n; i++) {
+			regs[i + 1] = crc32_step(t, regs[i], s->charset[digits[i]]);
+		}
+	}
+}
+
+static bool collide_search_firsts(CollideSearch *s, RzHashCollideBreak is_breaked) {
+	size_t *digits = RZ_NEWS(size_t, s->n_free);
+	ut32 *regs = RZ_NEWS(ut32, s->n_free + 1);
+	bool found = false;
+	if (!digits || !regs) {
+		goto end;
+	}
+	regs[0] = CRC32_INIT;
+	while (!found) {
+		rz_th_lock_enter(s->lock);
+		size_t first = s->next_first;
+		bool stop = s->stop || s->found || first >= s->charset_len;
+		if (!stop) {
+			s->next_first++;
+		}
+		rz_th_lock_leave(s->lock);
+		if (stop) {
+			break;
+		}
+		if (is_breaked && is_breaked()) {
+			break;
+		}
+		found = collide_search_first(s, first, digits, regs, is_breaked);
+	}
+end:
+	free(digits);
+	free(regs);
+	return found;
+}
+
+static RzThreadFunctionRet collide_thread(RzThread *th) {
+	CollideSearch *s = th->user;
+	collide_search_firsts(s, NULL);
+	rz_th_lock_enter(s->lock);
+	s->finished++;
+	rz_th_lock_leave(s->lock);
+	return RZ_TH_STOP;
+}
+
+static bool collide_search_parallel(CollideSearch *s, size_t max_threads, RzHashCollideBreak is_breaked) {
+	RzThreadPool *pool = rz_th_pool_new(max_threads);
+	if (!pool) {
+		return collide_search_firsts(s, is_breaked);
+	}
+	size_t started = 0;
+	s->finished = 0;
+	for (size_t i = 0; i < pool->size; i++) {
+		RzThread *th = rz_th_new(collide_thread, s, 0);
+		if (!th) {
+			RZ_LOG_ERROR("hash: cannot start collision search thread %u.\n", (ut32)i);
+			break;
+		}
+		rz_th_pool_add_thread(pool, th);
+		started++;
+	}
+	while (true) {
+		rz_th_lock_enter(s->lock);
+		bool done = s->finished == started;
+		rz_th_lock_leave(s->lock);
+		if (done) {
+			break;
+		}
+		if (is_breaked && is_breaked()) {
+			rz_th_lock_enter(s->lock);
+			s->stop = true;
+			rz_th_lock_leave(s->lock);
+		}
+		rz_sys_usleep(1000);
+	}
+	rz_th_pool_wait(pool);
+	rz_th_pool_free(pool);
+	// threads which failed to start leave their work to this one
+	return collide_search_firsts(s, is_breaked) || s->found;
+}
+
+/**
+ * \brief Finds the bytes to put at the start of \p buf so its CRC-32 becomes \p target
+ *
+ * The first n bytes of \p buf are searched among the ones of \p charset and
+ * the following 4 are solved from them, n growing from 0 until the solved
+ * bytes are in \p charset too. Without a charset (any byte is allowed) the
+ * first 4 bytes are solved directly. The prefixes are split by their first
+ * byte among the threads of a pool.
+ *
+ * \param buf the block, whose first bytes are overwritten on success
+ * \param charset the allowed bytes, NULL for any
+ * \param max_threads max threads of the search, RZ_THREAD_POOL_ALL_CORES for all the cores
+ * \param is_breaked returns true to stop the search, may be NULL
+ * \return true if a collision was found and written to \p buf
+ */
+RZ_API bool rz_hash_crc32_collide(RZ_NONNULL ut8 *buf, size_t size, ut32 target, RZ_NULLABLE const char *charset, size_t max_threads, RZ_NULLABLE RzHashCollideBreak is_breaked) {
+	rz_return_val_if_fail(buf, false);
+	if (!charset) {
+		return rz_hash_crc32_forge(buf, size, 0, target);
+	}
+	Crc32Tables t;
+	crc32_tables_init(&t);
+	CollideSearch s = { .t = &t };
+	for (const char *c = charset; *c; c++) {
+		if (!s.allowed[(ut8)*c]) {
+			s.allowed[(ut8)*c] = true;
+			s.charset_len++;
+		}
+	}
+	ut8 *chars = malloc(RZ_MAX(s.charset_len, 1));
+	s.result = malloc(size);
+	s.lock = rz_th_lock_new(false);
+	bool found = false;
+	if (!s.charset_len || size < 4 || !chars || !s.result || !s.lock) {
+		goto end;
+	}
+	for (size_t i = 0, n = 0; i < 256; i++) {
+		if (s.allowed[i]) {
+			chars[n++] = i;
+		}
+	}
+	s.charset = chars;
+
+	ut32 x = crc32_solve_suffix(&t, buf + 4, size - 4, target) ^ CRC32_INIT;
+	if (collide_allowed(&s, x)) {
+		rz_write_le32(buf, x);
+		found = true;
+		goto end;
+	}
+	double keyspace = 1;
+	for (s.n_free = 1; s.n_free + 4 <= size && !s.stop; s.n_free++) {
+		keyspace *= s.charset_len;
+		s.solve = crc32_solve_suffix(&t, buf + s.n_free + 4, size - s.n_free - 4, target);
+		s.next_first = 0;
+		found = keyspace <= COLLIDE_SERIAL_KEYSPACE || max_threads == 1
+			? collide_search_firsts(&s, is_breaked)
+			: collide_search_parallel(&s, max_threads, is_breaked);
+		if (found) {
+			memcpy(buf, s.result, s.n_free + 4);
+			break;
+		}
+		if (is_breaked && is_breaked()) {
+			break;
+		}
+	}
+end:
+	rz_th_lock_free(s.lock);
+	free(s.result);
+	free(chars);
+	return found;
+}
@@ -560,6 +560,7 @@ typedef struct rz_analysis_t {
 	void *core;
 	ut64 gp; // analysis.gp, global pointer. used for mips. but can be used by other arches too in the future
 	RBTree bb_tree; // all basic blocks by address. They can overlap each other, but must never start at the same address.
+	RzSlab *block_slab; // memory of the basic blocks
 	RzList *fcns;
 	HtUP *ht_addr_fun; // address => function
 	HtPP *ht_name_fun; // name => function
@@ -1007,28 +1008,7 @@ typedef struct rz_analysis_esil_interrupt_handler_t {
 	void (*fini)(void *user);
 } RzAnalysisEsilInterruptHandler;
 
-typedef struct rz_analysis_esil_change_reg_t {
-	int idx;
-	ut64 data;
-} RzAnalysisEsilRegChange;
-
-typedef struct rz_analysis_esil_change_mem_t {
-	int idx;
-	ut8 data;
-} RzAnalysisEsilMemChange;
-
-typedef struct rz_analysis_esil_trace_t {
-	int idx;
-	int end_idx;
-	HtUP *registers;
-	HtUP *memory;
-	RzRegArena *arena[RZ_REG_TYPE_LAST];
-	ut64 stack_addr;
-	ut64 stack_size;
-	ut8 *stack_data;
-	// RzVector<RzILTraceInstruction>
-	RzPVector *instructions;
-} RzAnalysisEsilTrace;
+typedef struct rz_analysis_esil_trace_log_t RzAnalysisEsilTraceLog;
 
 typedef int (*RzAnalysisEsilHookRegWriteCB)(ANALYSIS_ESIL *esil, const char *name, ut64 *val);
 
@@ -1047,6 +1027,16 @@ typedef struct rz_analysis_esil_callbacks_t {
 	int (*reg_write)(ANALYSIS_ESIL *esil, const char *name, ut64 val);
 } RzAnalysisEsilCallbacks;
 
+typedef struct rz_analysis_esil_trace_t {
+	int idx;
+	int end_idx;
+	RzAnalysisEsilTraceLog *log; ///< registers and memory changes of each step
+	// RzVector<RzILTraceInstruction>
+	RzPVector *instructions;
+	RzAnalysisEsilCallbacks ocbs; ///< callbacks of the ESIL replaced while tracing a step
+	bool ocbs_set;
+} RzAnalysisEsilTrace;
+
 typedef struct rz_analysis_esil_t {
 	RzAnalysis *analysis;
 	char **stack;
@@ -1099,10 +1089,6 @@ typedef struct rz_analysis_esil_t {
 	int stack_fd; // ahem, let's not do this
 } RzAnalysisEsil;
 
-/* Alias RegChange and MemChange */
-typedef RzAnalysisEsilRegChange RzAnalysisRzilRegChange;
-typedef RzAnalysisEsilMemChange RzAnalysisRzilMemChange;
-
 /* Alias esil strace */
 typedef RzAnalysisEsilTrace RzAnalysisRzilTrace;
 
@@ -1121,9 +1107,19 @@ typedef struct rz_analysis_rzil_callbacks_t {
 	int (*reg_write)(ANALYSIS_RZIL *rzil, const char *name, ut64 val, RzAnalysis *analysis);
 } RzAnalysisRzilCallbacks;
 
+/**
+ * Binding between a register of RzReg and the global variable of the RzIL VM
+ * with the same name; bindings are resolved once by rz_analysis_rzil_bind_regs()
+ */
+typedef struct rz_analysis_rzil_reg_binding_t {
+	int reg_index; ///< index of the register (see rz_reg_index_get)
+	RzILVar *var; ///< global variable of the VM representing the register
+} RzAnalysisRzilRegBinding;
+
 typedef struct rz_analysis_rzil_t {
 	RzILVM *vm;
 	RzAnalysisRzilTrace *trace;
+	RzVector /*<RzAnalysisRzilRegBinding>*/ reg_bindings;
 
 	RzAnalysisRzilCallbacks cb;
 	Sdb *stats;
@@ -1190,6 +1186,7 @@ typedef struct rz_analysis_esil_basic_block_t {
 
 // TODO: rm data + len
 typedef int (*RzAnalysisOpCallback)(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask);
+typedef int (*RzAnalysisOpBatchCallback)(RzAnalysis *a, RzAnalysisOp *ops, int count, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask);
 
 typedef bool (*RzAnalysisRegProfCallback)(RzAnalysis *a);
 typedef char *(*RzAnalysisRegProfGetCallback)(RzAnalysis *a);
@@ -1229,6 +1226,13 @@ typedef struct rz_analysis_plugin_t {
 
 	// legacy rz_analysis_functions
 	RzAnalysisOpCallback op;
+	/**
+	 * Optional, decodes up to \p count consecutive instructions with a
+	 * single decoder setup. It initializes and fills only the successfully
+	 * decoded instructions and returns their number, leaving the others to
+	 * the op callback. See rz_analysis_op_batch().
+	 */
+	RzAnalysisOpBatchCallback op_batch;
 
 	RzAnalysisRegProfGetCallback get_reg_profile;
 	RzAnalysisFPBBCallback fingerprint_bb;
@@ -1477,6 +1481,7 @@ RZ_API int rz_analysis_op_reg_delta(RzAnalysis *analysis, ut64 addr, const char
 RZ_API bool rz_analysis_op_is_eob(RzAnalysisOp *op);
 RZ_API RzList *rz_analysis_op_list_new(void);
 RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask);
+RZ_API int rz_analysis_op_batch(RzAnalysis *analysis, RZ_OUT RzAnalysisOp *ops, int count, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask, RZ_OUT RZ_NULLABLE bool *failed);
 RZ_API RzAnalysisOp *rz_analysis_op_hexstr(RzAnalysis *analysis, ut64 addr, const char *hexstr);
 RZ_API char *rz_analysis_op_to_string(RzAnalysis *analysis, RzAnalysisOp *op);
 
@@ -1568,11 +1573,29 @@ RZ_API void rz_analysis_esil_trace_op(RzAnalysisEsil *esil, RZ_NONNULL RzAnalysi
 RZ_API void rz_analysis_esil_trace_list(RzAnalysisEsil *esil);
 RZ_API void rz_analysis_esil_trace_show(RzAnalysisEsil *esil, int idx);
 RZ_API void rz_analysis_esil_trace_restore(RzAnalysisEsil *esil, int idx);
+RZ_API bool rz_analysis_esil_trace_save(RZ_NONNULL RzAnalysisEsilTrace *trace, RZ_NONNULL const char *path);
+RZ_API bool rz_analysis_esil_trace_load(RZ_NONNULL RzAnalysisEsil *esil, RZ_NONNULL const char *path);
+
+/* ESIL trace log */
+RZ_API RZ_OWN RzAnalysisEsilTraceLog *rz_analysis_esil_trace_log_new(void);
+RZ_API void rz_analysis_esil_trace_log_free(RZ_NULLABLE RzAnalysisEsilTraceLog *log);
+RZ_API ut32 rz_analysis_esil_trace_log_count(RZ_NONNULL RzAnalysisEsilTraceLog *log);
+RZ_API bool rz_analysis_esil_trace_log_step_begin(RZ_NONNULL RzAnalysisEsilTraceLog *log, RZ_NONNULL RzReg *reg, ut64 pc);
+RZ_API bool rz_analysis_esil_trace_log_reg_write(RZ_NONNULL RzAnalysisEsilTraceLog *log, RZ_NONNULL const char *name, ut64 value);
+RZ_API bool rz_analysis_esil_trace_log_mem_write(RZ_NONNULL RzAnalysisEsilTraceLog *log, ut64 addr, RZ_NONNULL const ut8 *old, RZ_NONNULL const ut8 *buf, int len);
+RZ_API bool rz_analysis_esil_trace_log_step_end(RZ_NONNULL RzAnalysisEsilTraceLog *log);
+RZ_API ut32 rz_analysis_esil_trace_log_pcs(RZ_NONNULL RzAnalysisEsilTraceLog *log, ut32 from, ut32 n, RZ_OUT ut64 *out);
+RZ_API bool rz_analysis_esil_trace_log_seek(RZ_NONNULL RzAnalysisEsilTraceLog *log, RZ_NONNULL RzReg *reg, RZ_NONNULL RzIOBind *iob, ut32 idx);
+RZ_API bool rz_analysis_esil_trace_log_save(RZ_NONNULL RzAnalysisEsilTraceLog *log, RZ_NONNULL const char *path);
+RZ_API RZ_OWN RzAnalysisEsilTraceLog *rz_analysis_esil_trace_log_load(RZ_NONNULL const char *path);
 
 /* rzil : stats and trace */
 RZ_API RZ_OWN RzAnalysisRzil *rz_analysis_rzil_new();
 RZ_API void rz_analysis_rzil_free(RZ_NULLABLE RzAnalysisRzil *rzil);
 RZ_API bool rz_analysis_rzil_set_pc(RzAnalysisRzil *rzil, ut64 addr);
+RZ_API ut32 rz_analysis_rzil_bind_regs(RZ_NONNULL RzAnalysisRzil *rzil, RZ_NONNULL RzReg *reg);
+RZ_API void rz_analysis_rzil_sync_from_reg(RZ_NONNULL RzAnalysisRzil *rzil, RZ_NONNULL RzReg *reg);
+RZ_API void rz_analysis_rzil_sync_to_reg(RZ_NONNULL RzAnalysisRzil *rzil, RZ_NONNULL RzReg *reg);
 RZ_API bool rz_analysis_rzil_setup(RzAnalysis *analysis);
 RZ_API void rz_analysis_rzil_cleanup(RzAnalysis *analysis);
 RZ_API void rz_analysis_set_rzil_op(RzAnalysisRzil *rzil, ut64 addr, RzPVector *oplist);
@@ -1967,6 +1990,10 @@ RZ_API RZ_NULLABLE RZ_BORROW const char *rz_analysis_hint_arch_at(RzAnalysis *an
 // if there is no hint affecting addr.
 RZ_API int rz_analysis_hint_bits_at(RzAnalysis *analysis, ut64 addr, RZ_NULLABLE ut64 *hint_addr);
 
+// get the address of the first arch or bits hint placed after addr, where the values given by the two functions
+// above may change, or UT64_MAX if there is none.
+RZ_API ut64 rz_analysis_hint_arch_bits_next(RzAnalysis *analysis, ut64 addr);
+
 RZ_API RzAnalysisHint *rz_analysis_hint_get(RzAnalysis *analysis, ut64 addr); // accumulate all available hints affecting the given address
 
 /* switch.c APIs */
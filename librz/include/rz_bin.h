@@ -306,6 +306,14 @@ typedef struct rz_bin_object_t {
 	RZ_DEPRECATE Sdb *kv; ///< deprecated, put info in C structures instead of this
 	HtUP *addrzklassmethod;
 	void *bin_obj; // internal pointer used by formats
+	struct rz_bin_file_t *bf; ///< file of the object, whose plugin loads the items on demand
+	ut64 filter_rules; ///< RzBin filter rules when the object was loaded, applied to the items loaded on demand
+	bool filter; ///< RzBin filter of the names when the object was loaded
+	int minstrlen; ///< RzBin minimum length of the strings when the object was loaded
+	bool debase64; ///< RzBin decoding of the base64 strings when the object was loaded
+	ut32 loaded_items; ///< families of items already loaded by the rz_bin_object_get_*() accessors, read without the lock
+	ut32 loading_items; ///< families of items being loaded, whose accessors return what is loaded so far to the loader
+	RzThreadLock *items_lock; ///< serializes the loading of the items on demand
 } RzBinObject;
 
 // XXX: RbinFile may hold more than one RzBinObject
@@ -947,7 +955,7 @@ RZ_API const RzList *rz_bin_object_get_fields(RZ_NONNULL RzBinObject *obj);
 RZ_API const RzList *rz_bin_object_get_imports(RZ_NONNULL RzBinObject *obj);
 RZ_API const RzBinInfo *rz_bin_object_get_info(RZ_NONNULL RzBinObject *obj);
 RZ_API const RzList *rz_bin_object_get_libs(RZ_NONNULL RzBinObject *obj);
-RZ_API const RBNode *rz_bin_object_get_relocs(RZ_NONNULL RzBinObject *obj);
+RZ_API RzBinRelocStorage *rz_bin_object_get_relocs(RZ_NONNULL RzBinObject *obj);
 RZ_API const RzList *rz_bin_object_get_sections_all(RZ_NONNULL RzBinObject *obj);
 RZ_API RZ_OWN RzList *rz_bin_object_get_sections(RZ_NONNULL RzBinObject *obj);
 RZ_API RZ_OWN RzList *rz_bin_object_get_segments(RZ_NONNULL RzBinObject *obj);
@@ -956,6 +964,8 @@ RZ_API const RzList *rz_bin_object_get_strings(RZ_NONNULL RzBinObject *obj);
 RZ_API const RzList *rz_bin_object_get_mem(RZ_NONNULL RzBinObject *obj);
 RZ_API const RzList *rz_bin_object_get_resources(RZ_NONNULL RzBinObject *obj);
 RZ_API const RzList *rz_bin_object_get_symbols(RZ_NONNULL RzBinObject *obj);
+RZ_API RzBinLanguage rz_bin_object_get_language(RZ_NONNULL RzBinObject *obj);
+RZ_API RzBinSymbol *rz_bin_object_get_method_at(RZ_NONNULL RzBinObject *obj, ut64 vaddr);
 RZ_API const RzList *rz_bin_object_reset_strings(RZ_NONNULL RzBin *bin, RZ_NONNULL RzBinFile *bf, RZ_NONNULL RzBinObject *obj);
 RZ_API bool rz_bin_object_is_string(RZ_NONNULL RzBinObject *obj, ut64 va);
 RZ_API bool rz_bin_object_is_big_endian(RZ_NONNULL RzBinObject *obj);
@@ -1021,6 +1031,8 @@ RZ_API void rz_bin_mem_free(void *data);
 
 // demangle functions
 RZ_API RZ_OWN char *rz_bin_demangle(RZ_NULLABLE RzBinFile *bf, RZ_NULLABLE const char *language, RZ_NULLABLE const char *symbol, ut64 vaddr, bool libs);
+RZ_API RZ_OWN char *rz_bin_demangle_no_method(RZ_NULLABLE const RzBinFile *bf, RZ_NULLABLE const char *language, RZ_NULLABLE const char *symbol, bool libs, RZ_NULLABLE RZ_OUT char **method);
+RZ_API void rz_bin_demangle_add_method(RZ_NONNULL RzBinFile *bf, RZ_NONNULL const char *demangled, ut64 vaddr);
 RZ_API const char *rz_bin_get_meth_flag_string(ut64 flag, bool compact);
 
 RZ_API RzBinSection *rz_bin_get_section_at(RzBinObject *o, ut64 off, int va);
@@ -459,6 +459,7 @@ typedef struct rz_cmd_t {
 	RzList *lcmds;
 	RzCmdAlias aliases;
 	void *language; // used to store TSLanguage *
+	void *parse_cache; // used to store RzCmdParseCache *
 	HtUP *ts_symbols_ht;
 	RzCmdDesc *root_cmd_desc;
 	HtPP *ht_cmds;
@@ -22,6 +22,7 @@ extern "C" {
 #include <rz_vector.h>
 #include <sdb.h>
 #include <ht_up.h>
+#include <ht_pu.h>
 
 #include <stdio.h>
 #include <sys/types.h>
@@ -372,6 +373,37 @@ typedef struct rz_cons_canvas_t {
 	int linemode; // 0 = diagonal , 1 = square
 } RzConsCanvas;
 
+#define RZ_CONS_CELL_WIDE (1 << 0) ///< first column of a fullwidth character
+#define RZ_CONS_CELL_CONT (1 << 1) ///< second column of a fullwidth character
+
+typedef struct rz_cons_cell_t {
+	ut32 attr; ///< index of the SGR sequences in effect, 0 for none
+	char ch[4]; ///< UTF-8 character, a space if len is 0
+	ut8 len; ///< length of ch
+	ut8 flags; ///< RZ_CONS_CELL_*
+} RzConsCell;
+
+/**
+ * Double-buffered grid of cells, used to write to the terminal only the
+ * parts of a frame that changed since the previous one.
+ */
+typedef struct rz_cons_screen_t {
+	int cols;
+	int rows;
+	RzConsCell *back; ///< cells of the frame being drawn
+	RzConsCell *front; ///< cells shown on the terminal
+	bool *damaged; ///< rows of front which may not match the terminal
+	bool wrap; ///< wrap the lines longer than cols instead of truncating them
+	int x; ///< column of the cursor in back
+	int y; ///< row of the cursor in back
+	int saved_x;
+	int saved_y;
+	ut32 attr; ///< attributes of the next cells written in back
+	RzPVector /*<char *>*/ attrs; ///< SGR sequences by index, 0 is the empty one
+	HtPU /*<char *, ut64>*/ *attrs_idx; ///< SGR sequences -> index
+	RzStrBuf passthrough; ///< escape sequences of the frame not affecting the cells
+} RzConsScreen;
+
 #define RUNECODE_MIN             0xc8 // 200
 #define RUNECODE_LINE_VERT       0xc8
 #define RUNECODE_LINE_CROSS      0xc9
@@ -575,6 +607,8 @@ typedef struct rz_cons_t {
 	int click_x;
 	int click_y;
 	bool show_vals; // show which section in Vv
+	bool damage; // write only the changed cells in visual flushes
+	RzConsScreen *screen; // cells on the terminal, for damage tracking
 	// TODO: move into instance? + avoid unnecessary copies
 } RzCons;
 
@@ -824,6 +858,16 @@ RZ_API int rz_cons_canvas_resize(RzConsCanvas *c, int w, int h);
 RZ_API void rz_cons_canvas_fill(RzConsCanvas *c, int x, int y, int w, int h, char ch);
 RZ_API void rz_cons_canvas_line_square_defined(RzConsCanvas *c, int x, int y, int x2, int y2, RzCanvasLineStyle *style, int bendpoint, int isvert);
 RZ_API void rz_cons_canvas_line_back_edge(RzConsCanvas *c, int x, int y, int x2, int y2, RzCanvasLineStyle *style, int ybendpoint1, int xbendpoint, int ybendpoint2, int isvert);
+RZ_API RZ_OWN RzConsScreen *rz_cons_screen_new(void);
+RZ_API void rz_cons_screen_free(RZ_NULLABLE RzConsScreen *screen);
+RZ_API bool rz_cons_screen_resize(RZ_NONNULL RzConsScreen *screen, int cols, int rows);
+RZ_API void rz_cons_screen_invalidate(RZ_NONNULL RzConsScreen *screen);
+RZ_API void rz_cons_screen_damage(RZ_NONNULL RzConsScreen *screen, int y);
+RZ_API void rz_cons_screen_clear(RZ_NONNULL RzConsScreen *screen);
+RZ_API void rz_cons_screen_write(RZ_NONNULL RzConsScreen *screen, RZ_NONNULL const char *str, size_t len);
+RZ_API size_t rz_cons_screen_render(RZ_NONNULL RzConsScreen *screen, RZ_NONNULL RzStrBuf *out);
+RZ_API RZ_BORROW const RzConsCell *rz_cons_screen_cell(RZ_NONNULL RzConsScreen *screen, int x, int y);
+RZ_API RZ_BORROW const char *rz_cons_screen_attr(RZ_NONNULL RzConsScreen *screen, ut32 attr);
 RZ_API RzCons *rz_cons_new(void);
 RZ_API RzCons *rz_cons_singleton(void);
 RZ_API RzCons *rz_cons_free(void);
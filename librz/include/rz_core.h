@@ -270,8 +270,53 @@ typedef struct rz_core_seek_history_t {
 	RzCoreSeekItem saved_item; ///< Position to save in history
 } RzCoreSeekHistory;
 
+/**
+ * Classes of a ROP gadget, given by the ESIL classification of rop.db
+ */
+typedef enum {
+	RZ_CORE_ROP_CLASS_NOP = 1 << 0,
+	RZ_CORE_ROP_CLASS_MOV = 1 << 1,
+	RZ_CORE_ROP_CLASS_CONST = 1 << 2,
+	RZ_CORE_ROP_CLASS_ARITHM = 1 << 3,
+	RZ_CORE_ROP_CLASS_ARITHM_CT = 1 << 4,
+} RzCoreRopClass;
+
+typedef struct rz_core_rop_gadget_t {
+	ut64 addr; ///< Address of the first instruction
+	ut64 hash; ///< Hash of the normalized instructions, see rz_core_rop_insn_hash()
+	ut64 clobbered; ///< Bit i is set when the gadget writes the register i of the index
+	ut32 size; ///< Size in bytes, including the end instruction
+	ut32 end_type; ///< RzAnalysisOpType of the end instruction
+	ut32 classes; ///< RzCoreRopClass flags
+	ut32 count; ///< Number of addresses with the same instructions
+	ut8 n_instr; ///< Number of instructions
+} RzCoreRopGadget;
+
+/**
+ * Unique ROP gadgets found by /Ri, which can be queried without searching
+ * again and are saved with the project.
+ */
+typedef struct rz_core_rop_index_t {
+	RzVector /*<RzCoreRopGadget>*/ gadgets; ///< In the order they were added
+	RzPVector /*<char *>*/ regs; ///< Names of the registers of the clobbered bits, at most 64
+	HtUU *by_hash; ///< Hash -> index in gadgets
+	HtPU *reg_bits; ///< Register or sub-register name -> bit + 1, filled by rz_core_rop_index_set_regs()
+} RzCoreRopIndex;
+
+typedef struct rz_core_heap_snapshot_t RzCoreHeapSnapshot;
+
+typedef struct rz_core_rop_query_t {
+	ut32 end_type; ///< RzAnalysisOpType of the end instruction or UT32_MAX for any
+	ut32 classes; ///< RzCoreRopClass flags which must all be set
+	ut64 clobbered; ///< Registers which must all be written
+	ut64 preserved; ///< Registers which must not be written
+} RzCoreRopQuery;
+
 struct rz_core_t {
 	RzBin *bin;
+	bool bin_lang_pending; ///< bin.lang is detected from the symbols of the current file on its first read
+	ut32 bin_pending; ///< RZ_CORE_BIN_ACC_* items of a file applied before the first command needing them, see bin.lazyflags
+	ut32 bin_pending_id; ///< id of the RzBinFile of bin_pending
 	RzList *plugins; ///< List of registered core plugins
 	RzConfig *config;
 	ut64 offset; // current seek
@@ -359,6 +404,8 @@ struct rz_core_t {
 	bool scr_gadgets;
 	bool log_events; // core.c:cb_event_handler : log actions from events if cfg.log.events is set
 	RzList *ropchain;
+	RzCoreRopIndex *rop_index; ///< Gadgets indexed by /Ri, or NULL
+	RzCoreHeapSnapshot *heap_snapshot; ///< Memory read by the heap inspectors, see rz_core_heap_read()
 	bool use_tree_sitter_rzcmd;
 	bool use_rzshell_autocompletion;
 	RzCoreSeekHistory seek_history;
@@ -701,6 +748,18 @@ RZ_API int rz_core_get_stacksz(RzCore *core, ut64 from, ut64 to);
 /*tp.c*/
 RZ_API void rz_core_analysis_type_match(RzCore *core, RzAnalysisFunction *fcn, HtUU *addr_loop_table);
 
+/* crop.c */
+RZ_API RZ_OWN RzCoreRopIndex *rz_core_rop_index_new(void);
+RZ_API void rz_core_rop_index_free(RZ_NULLABLE RzCoreRopIndex *index);
+RZ_API void rz_core_rop_index_set_regs(RZ_NONNULL RzCoreRopIndex *index, RZ_NONNULL RzReg *reg);
+RZ_API int rz_core_rop_index_reg(RZ_NONNULL const RzCoreRopIndex *index, RZ_NONNULL const char *name);
+RZ_API ut64 rz_core_rop_index_esil_clobbered(RZ_NONNULL const RzCoreRopIndex *index, RZ_NONNULL const char *esil);
+RZ_API bool rz_core_rop_index_add(RZ_NONNULL RzCoreRopIndex *index, RZ_NONNULL const RzCoreRopGadget *gadget);
+RZ_API RZ_OWN RzPVector /*<RzCoreRopGadget *>*/ *rz_core_rop_index_query(RZ_NONNULL RzCoreRopIndex *index, RZ_NONNULL const RzCoreRopQuery *query);
+RZ_API void rz_core_rop_index_save(RZ_NONNULL Sdb *db, RZ_NONNULL const RzCoreRopIndex *index);
+RZ_API RZ_OWN RzCoreRopIndex *rz_core_rop_index_load(RZ_NONNULL Sdb *db);
+RZ_API ut64 rz_core_rop_insn_hash(RZ_NONNULL const char *opstr);
+
 /* asm.c */
 #define RZ_MIDFLAGS_HIDE     0
 #define RZ_MIDFLAGS_SHOW     1
@@ -757,6 +816,7 @@ RZ_API bool rz_core_bin_apply_classes(RzCore *core, RzBinFile *binfile);
 RZ_API bool rz_core_bin_apply_resources(RzCore *core, RzBinFile *binfile);
 RZ_API bool rz_core_bin_apply_info(RzCore *r, RzBinFile *binfile, ut32 mask);
 RZ_API bool rz_core_bin_apply_all_info(RzCore *r, RzBinFile *binfile);
+RZ_API bool rz_core_bin_apply_pending(RzCore *core);
 RZ_API int rz_core_bin_set_by_fd(RzCore *core, ut64 bin_fd);
 RZ_API int rz_core_bin_set_by_name(RzCore *core, const char *name);
 RZ_API bool rz_core_bin_load(RZ_NONNULL RzCore *core, RZ_NULLABLE const char *file_uri, ut64 base_addr);
@@ -806,6 +866,14 @@ RZ_API bool rz_heap_write_chunk(RzCore *core, RzHeapChunkSimple *chunk_simple);
 RZ_API RZ_OWN RzList *rz_heap_windows_blocks_list(RzCore *core);
 RZ_API RZ_OWN RzList *rz_heap_windows_heap_list(RzCore *core);
 
+/* cheap.c */
+RZ_API bool rz_core_heap_read(RZ_NONNULL RzCore *core, ut64 addr, RZ_NONNULL ut8 *buf, int len);
+RZ_API void rz_core_heap_snapshot_add_range(RZ_NONNULL RzCore *core, ut64 from, ut64 to);
+RZ_API void rz_core_heap_snapshot_invalidate(RZ_NONNULL RzCore *core);
+RZ_API void rz_core_heap_snapshot_enable(RZ_NONNULL RzCore *core, bool enable);
+RZ_API void rz_core_heap_snapshot_stats(RZ_NONNULL RzCore *core, RZ_NULLABLE ut64 *requests, RZ_NULLABLE ut64 *io_reads);
+RZ_API void rz_core_heap_snapshot_free(RZ_NULLABLE RzCoreHeapSnapshot *snap);
+
 // XXX dupe from rz_bin.h
 /* bin.c */
 #define RZ_CORE_BIN_ACC_STRINGS          0x001
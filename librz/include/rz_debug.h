@@ -281,6 +281,7 @@ typedef struct rz_debug_t {
 
 	/* tracking debugger state */
 	int steps; /* counter of steps done */
+	ut64 stops; /* counter of the times the debuggee stopped, to know when its memory may have changed */
 	RzDebugReason reason; /* stop reason */
 	RzDebugRecoilMode recoil_mode; /* what did the user want to do? */
 	ut64 stopaddr; /* stop address  */
@@ -43,6 +43,19 @@ typedef struct rz_flag_item_t {
 	char *alias; /* used to define a flag based on a math expression (e.g. foo + 3) */
 } RzFlagItem;
 
+/**
+ * \brief Flag item to be set by rz_flag_set_bulk()
+ */
+typedef struct rz_flag_bulk_item_t {
+	char *name; ///< flag name filtered with rz_flag_name_filter(), owned by rz_flag_set_bulk()
+	const char *realname; ///< real name to set, if not NULL
+	ut64 offset; ///< offset flagged by the item
+	ut32 size; ///< size of the flag item
+	RzSpace *space; ///< flag space of the item
+	bool demangled; ///< real name from demangling?
+	RzFlagItem *item; ///< resulting flag item, NULL on failure
+} RzFlagBulkItem;
+
 typedef struct rz_flag_t {
 	RzSpaces spaces; /* handle flag spaces */
 	st64 base; /* base address for all flag items */
@@ -51,6 +64,7 @@ typedef struct rz_flag_t {
 	RzNum *num;
 	RzSkipList *by_off; /* flags sorted by offset, value=RzFlagsAtOffset */
 	HtPP *ht_name; /* hashmap key=item name, value=RzFlagItem * */
+	RContRBTree *by_name; /* flag items sorted by name, value=RzFlagItem * */
 	PrintfCallback cb_printf;
 	RzList *zones;
 } RzFlag;
@@ -109,6 +123,8 @@ RZ_API bool rz_flag_unset_off(RzFlag *f, ut64 addr);
 RZ_API void rz_flag_unset_all(RzFlag *f);
 RZ_API void rz_flag_unset_all_in_space(RzFlag *f, const char *space_name);
 RZ_API RzFlagItem *rz_flag_set(RzFlag *fo, const char *name, ut64 addr, ut32 size);
+RZ_API RZ_OWN char *rz_flag_name_filter(RZ_NONNULL const char *name);
+RZ_API size_t rz_flag_set_bulk(RZ_NONNULL RzFlag *f, RZ_NONNULL RZ_INOUT RzFlagBulkItem *items, size_t count);
 RZ_API RzFlagItem *rz_flag_set_next(RzFlag *fo, const char *name, ut64 addr, ut32 size);
 RZ_API void rz_flag_item_set_alias(RzFlagItem *item, const char *alias);
 RZ_API void rz_flag_item_free(RzFlagItem *item);
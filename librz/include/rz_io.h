@@ -76,6 +76,10 @@ typedef struct rz_io_t {
 	RzIDPool *map_ids;
 	RzPVector maps; // from tail backwards maps with higher priority are found
 	RzSkyline map_skyline; // map parts that are not covered by others
+	struct rz_io_map_snapshot_t *map_snapshot; ///< immutable view of map_skyline for concurrent readers
+	ut32 map_snapshot_epoch;
+	ut32 map_snapshot_readers[2]; ///< readers taking a snapshot, by parity of the epoch
+	int concurrent; ///< nesting of rz_io_concurrent_begin()
 	RzIDStorage *files;
 	RzPVector cache;
 	RzSkyline cache_skyline;
@@ -96,6 +100,8 @@ typedef struct rz_io_t {
 	RzCoreBind corebind;
 } RzIO;
 
+typedef struct rz_io_map_snapshot_t RzIOMapSnapshot;
+
 typedef struct rz_io_desc_t {
 	int fd;
 	int perm;
@@ -138,6 +144,7 @@ typedef struct rz_io_plugin_t {
 	RzIODesc *(*open)(RzIO *io, const char *, int perm, int mode);
 	RzList * /*RzIODesc* */ (*open_many)(RzIO *io, const char *, int perm, int mode);
 	int (*read)(RzIO *io, RzIODesc *fd, ut8 *buf, int count);
+	int (*pread)(RzIODesc *fd, ut64 addr, ut8 *buf, int count); ///< positional read, safe to call from concurrent threads
 	ut64 (*lseek)(RzIO *io, RzIODesc *fd, ut64 offset, int whence);
 	int (*write)(RzIO *io, RzIODesc *fd, const ut8 *buf, int count);
 	int (*close)(RzIODesc *desc);
@@ -295,6 +302,7 @@ RZ_API bool rz_io_map_priorize_for_fd(RzIO *io, int fd);
 RZ_API void rz_io_map_cleanup(RzIO *io);
 RZ_API void rz_io_map_fini(RzIO *io);
 RZ_API bool rz_io_map_is_in_range(RzIOMap *map, ut64 from, ut64 to);
+RZ_API void rz_io_map_set_perm(RZ_NONNULL RzIO *io, RZ_NONNULL RzIOMap *map, int perm);
 RZ_API void rz_io_map_set_name(RzIOMap *map, const char *name);
 RZ_API void rz_io_map_del_name(RzIOMap *map);
 RZ_API RzList *rz_io_map_get_for_fd(RzIO *io, int fd);
@@ -327,6 +335,7 @@ RZ_API bool rz_io_vread_at_mapped(RzIO *io, ut64 vaddr, ut8 *buf, int len);
 RZ_API bool rz_io_read_at(RzIO *io, ut64 addr, ut8 *buf, int len);
 RZ_API bool rz_io_read_at_mapped(RzIO *io, ut64 addr, ut8 *buf, int len);
 RZ_API int rz_io_nread_at(RzIO *io, ut64 addr, ut8 *buf, int len);
+RZ_API bool rz_io_read_at_concurrent(RZ_NONNULL RzIO *io, ut64 addr, RZ_NONNULL ut8 *buf, int len);
 RZ_API void rz_io_alprint(RzList *ls);
 RZ_API bool rz_io_write_at(RzIO *io, ut64 addr, const ut8 *buf, int len);
 RZ_API bool rz_io_read(RzIO *io, ut8 *buf, int len);
@@ -341,6 +350,11 @@ RZ_API void rz_io_bind(RzIO *io, RzIOBind *bnd);
 RZ_API bool rz_io_shift(RzIO *io, ut64 start, ut64 end, st64 move);
 RZ_API ut64 rz_io_seek(RzIO *io, ut64 offset, int whence);
 RZ_API int rz_io_fini(RzIO *io);
+RZ_API bool rz_io_concurrent_begin(RZ_NONNULL RzIO *io);
+RZ_API void rz_io_concurrent_end(RZ_NONNULL RzIO *io);
+RZ_API RZ_OWN RzIOMapSnapshot *rz_io_map_snapshot_acquire(RZ_NONNULL RzIO *io);
+RZ_API void rz_io_map_snapshot_release(RZ_NULLABLE RzIOMapSnapshot *snap);
+RZ_API bool rz_io_map_snapshot_read_at(RZ_NONNULL RzIOMapSnapshot *snap, ut64 addr, RZ_NONNULL ut8 *buf, int len);
 RZ_API void rz_io_free(RzIO *io);
 #define rz_io_bind_init(x) memset(&x, 0, sizeof(x))
 
@@ -277,6 +277,8 @@ struct rz_magic_set {
 typedef struct rz_magic_set RzMagic;
 #endif
 
+typedef struct rz_magic_prefilter_t RzMagicPrefilter;
+
 #ifdef RZ_API
 RZ_API RzMagic *rz_magic_new(int flags);
 RZ_API void rz_magic_free(RzMagic *);
@@ -293,6 +295,11 @@ RZ_API bool rz_magic_load_buffer(RzMagic *, const char *);
 RZ_API bool rz_magic_compile(RzMagic *, const char *);
 RZ_API bool rz_magic_check(RzMagic *, const char *);
 RZ_API int rz_magic_errno(RzMagic *);
+
+RZ_API RZ_OWN RzMagicPrefilter *rz_magic_prefilter_new(RZ_NONNULL RzMagic *ms);
+RZ_API void rz_magic_prefilter_free(RZ_NULLABLE RzMagicPrefilter *pf);
+RZ_API bool rz_magic_prefilter_match(RZ_NONNULL RzMagicPrefilter *pf, RZ_NONNULL const ut8 *buf, size_t size);
+RZ_API size_t rz_magic_prefilter_scan(RZ_NONNULL RzMagicPrefilter *pf, RZ_NONNULL const ut8 *buf, size_t size, size_t count, size_t window, RZ_NONNULL ut8 *candidates);
 #endif
 
 #endif
@@ -29,6 +29,8 @@ typedef struct rz_main_t {
 
 typedef int (*RzMainCallback)(int argc, const char **argv);
 
+struct rz_core_t;
+
 RZ_API RzMain *rz_main_new(const char *name);
 RZ_API void rz_main_free(RzMain *m);
 RZ_API int rz_main_run(RzMain *m, int argc, const char **argv);
@@ -39,6 +41,7 @@ RZ_API int rz_main_rz_run(int argc, const char **argv);
 RZ_API int rz_main_rz_hash(int argc, const char **argv);
 RZ_API int rz_main_rz_bin(int argc, const char **argv);
 RZ_API int rz_main_rizin(int argc, const char **argv);
+RZ_API int rz_main_rizin_with_core(RZ_NONNULL RZ_OWN struct rz_core_t *core, int argc, const char **argv);
 RZ_API int rz_main_rz_asm(int argc, const char **argv);
 RZ_API int rz_main_rz_agent(int argc, const char **argv);
 RZ_API int rz_main_rz_find(int argc, const char **argv);
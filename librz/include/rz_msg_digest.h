@@ -43,11 +43,15 @@ typedef struct rz_msg_digest_t {
 	RzMsgDigestStatus status;
 } RzMsgDigest;
 
+typedef bool (*RzHashCollideBreak)(void);
+
 #ifdef RZ_API
 
 RZ_API ut32 rz_hash_xxhash(RZ_NONNULL const ut8 *input, size_t size);
 RZ_API double rz_hash_entropy(RZ_NONNULL const ut8 *data, ut64 len);
 RZ_API double rz_hash_entropy_fraction(RZ_NONNULL const ut8 *data, ut64 len);
+RZ_API bool rz_hash_crc32_forge(RZ_NONNULL ut8 *buf, size_t size, size_t pos, ut32 target);
+RZ_API bool rz_hash_crc32_collide(RZ_NONNULL ut8 *buf, size_t size, ut32 target, RZ_NULLABLE const char *charset, size_t max_threads, RZ_NULLABLE RzHashCollideBreak is_breaked);
 
 RZ_API RZ_BORROW const RzMsgDigestPlugin *rz_msg_digest_plugin_by_index(size_t index);
 RZ_API RZ_BORROW const RzMsgDigestPlugin *rz_msg_digest_plugin_by_name(RZ_NONNULL const char *name);
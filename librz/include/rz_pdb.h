@@ -150,9 +150,11 @@ typedef struct tpi_types {
 
 typedef struct tpi_stream_t {
 	RzPdbTpiStreamHeader header;
-	RBTree types;
+	RBTree types; ///< types decoded so far, see rz_bin_pdb_get_type_by_index()
 	ut64 type_index_base;
 	RzList /* RzBaseType */ *print_type;
+	RzBuffer *type_buf; ///< data of the TPI stream, the records are decoded on first lookup
+	ut32 *type_offsets; ///< offset of each record in type_buf, indexed by (type_index - TypeIndexBegin), UT32_MAX once it failed to decode
 } RzPdbTpiStream;
 
 // PDB
@@ -122,6 +122,9 @@ typedef struct rz_reg_t {
 	char *name[RZ_REG_NAME_LAST]; // aliases
 	RzRegSet regset[RZ_REG_TYPE_LAST];
 	RzList *allregs;
+	RzRegItem **items; ///< Same items of allregs, indexed by RzRegItem.index (see rz_reg_reindex)
+	int items_count;
+	RzRegItem *role_items[RZ_REG_NAME_LAST]; ///< Lazily resolved items of the aliases in name
 	RzList *roregs;
 	int iters;
 	int arch;
@@ -168,6 +171,10 @@ RZ_API RzRegItem *rz_reg_next_diff(RzReg *reg, int type, const ut8 *buf, int buf
 
 RZ_API void rz_reg_reindex(RzReg *reg);
 RZ_API RzRegItem *rz_reg_index_get(RzReg *reg, int idx);
+RZ_API int rz_reg_index_of(RzReg *reg, const char *name);
+RZ_API ut64 rz_reg_index_get_value(RzReg *reg, int idx);
+RZ_API bool rz_reg_index_set_value(RzReg *reg, int idx, ut64 value);
+RZ_API RzRegItem *rz_reg_get_by_role(RzReg *reg, RzRegisterId role);
 
 /* Item */
 RZ_API void rz_reg_item_free(RzRegItem *item);
@@ -27,6 +27,9 @@ typedef struct rz_type_target_t {
 
 typedef struct rz_type_parser_t RzTypeParser;
 
+typedef struct rz_type_db_index_t RzTypeDBIndex;
+typedef struct rz_type_db_lazy_t RzTypeDBLazy;
+
 typedef struct rz_type_db_t {
 	void *user;
 	HtPP /* <char *, RzBaseType *> */ *types; //< name -> base type
@@ -36,6 +39,9 @@ typedef struct rz_type_db_t {
 	RzTypeParser *parser;
 	RzNum *num;
 	RzIOBind iob; // for RzIO in formats
+	RzTypeDBIndex *index; //< reverse indexes of enum values and member offsets, built on demand
+	ut64 generation; //< incremented on each change of the types, to rebuild the stale indexes
+	RzTypeDBLazy *lazy; //< type libraries whose types are loaded on their first lookup, even by the const lookups
 } RzTypeDB;
 
 // All types in RzTypeDB module are either concrete,
@@ -327,6 +333,7 @@ RZ_API RzBaseType *rz_type_db_get_typedef(const RzTypeDB *typedb, RZ_NONNULL con
 RZ_API int rz_type_db_enum_member_by_name(const RzTypeDB *typedb, const char *name, const char *member);
 RZ_API RZ_BORROW char *rz_type_db_enum_member_by_val(const RzTypeDB *typedb, const char *name, ut64 val);
 RZ_API RZ_OWN RzList *rz_type_db_find_enums_by_val(const RzTypeDB *typedb, ut64 val);
+RZ_API void rz_type_db_invalidate_index(RZ_NONNULL const RzTypeDB *typedb);
 RZ_API char *rz_type_db_enum_get_bitfield(const RzTypeDB *typedb, const char *name, ut64 val);
 
 // Type size calculation
@@ -55,6 +55,7 @@ int gettimeofday(struct timeval *p, void *tz);
 #include "rz_util/rz_queue.h"
 #include "rz_util/rz_range.h"
 #include "rz_util/rz_signal.h"
+#include "rz_util/rz_slab.h"
 #include "rz_util/rz_spaces.h"
 #include "rz_util/rz_stack.h"
 #include "rz_util/rz_str.h"
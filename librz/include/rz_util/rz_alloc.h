@@ -16,6 +16,12 @@ typedef void(RFree)(void *);
 RZ_API void *rz_malloc_aligned(size_t size, size_t alignment);
 RZ_API void rz_free_aligned(void *p);
 
+RZ_API void rz_alloc_prof_enable(bool enable);
+RZ_API bool rz_alloc_prof_enabled(void);
+RZ_API void rz_alloc_prof_record(RZ_NONNULL const char *site, size_t size, bool alloc);
+RZ_API void rz_alloc_prof_reset(void);
+RZ_API RZ_OWN char *rz_alloc_prof_report(void);
+
 #if RZ_MALLOC_WRAPPER
 
 RZ_API void rz_alloc_hooks(RMalloc m, RCalloc c, RRealloc r, RFree f);
@@ -0,0 +1,38 @@
+#ifndef RZ_SLAB_H
+#define RZ_SLAB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Allocator of objects of a fixed size
+ *
+ * Objects are carved from pages holding many of them and released objects
+ * are reused by the next allocations, so that allocating and freeing them
+ * costs a few instructions. All the pages are freed at once with the slab,
+ * which is meant to be owned by the structure that owns the objects (e.g.
+ * RzAnalysis for its basic blocks). A slab is not thread-safe.
+ */
+typedef struct rz_slab_t {
+	const char *name; ///< name of the allocation site, reported by the allocation profiler
+	size_t obj_size; ///< size of an object, aligned
+	size_t page_objs; ///< number of objects in each page
+	void *pages; ///< pages allocated, linked through their header
+	void *free_list; ///< objects released, linked through their first word
+	ut8 *next; ///< first object never allocated of the last page
+	ut8 *end; ///< end of the last page
+	size_t count; ///< number of objects allocated and not released
+} RzSlab;
+
+RZ_API RZ_OWN RzSlab *rz_slab_new(size_t obj_size, size_t page_objs, RZ_NULLABLE const char *name);
+RZ_API void rz_slab_free(RZ_NULLABLE RzSlab *slab);
+RZ_API RZ_OWN void *rz_slab_alloc(RZ_NONNULL RzSlab *slab);
+RZ_API RZ_OWN void *rz_slab_alloc0(RZ_NONNULL RzSlab *slab);
+RZ_API void rz_slab_release(RZ_NONNULL RzSlab *slab, RZ_NULLABLE void *obj);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //  RZ_SLAB_H
@@ -696,6 +696,10 @@ RZ_API int rz_io_fini(RzIO *io) {
 	if (!io) {
 		return false;
 	}
+	// readers still holding a snapshot keep it alive
+	while (io->concurrent) {
+		rz_io_concurrent_end(io);
+	}
 	rz_io_desc_cache_fini_all(io);
 	rz_io_desc_fini(io);
 	rz_io_map_fini(io);
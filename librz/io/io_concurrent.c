@@ -0,0 +1,283 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_io.h>
+#include "io_private.h"
+
+/*
+ * Concurrent readers don't walk io->maps nor io->map_skyline, which the
+ * thread owning the RzIO changes, but an immutable snapshot of the skyline.
+ * Each change of the maps publishes a new snapshot, and the previous one is
+ * freed once the last reader holding it releases it (RCU-style).
+ *
+ * A reader takes a reference to the published snapshot while being counted
+ * in the readers of the current epoch. The owner swaps the snapshot, moves
+ * to the next epoch and waits for the readers of the previous one to be
+ * done before dropping its reference, so no reader can take a reference to
+ * an already freed snapshot. Readers never wait, the owner only for the few
+ * instructions a reader needs to take its reference.
+ */
+
+#if defined(__GNUC__) || defined(__clang__)
+#define IO_HAVE_ATOMICS 1
+#define atomic_inc(p)         __atomic_add_fetch(p, 1, __ATOMIC_SEQ_CST)
+#define atomic_dec(p)         __atomic_sub_fetch(p, 1, __ATOMIC_SEQ_CST)
+#define atomic_load(p)        __atomic_load_n(p, __ATOMIC_SEQ_CST)
+#define atomic_store(p, v)    __atomic_store_n(p, v, __ATOMIC_SEQ_CST)
+#define atomic_ptr_load(p)    __atomic_load_n(p, __ATOMIC_SEQ_CST)
+#define atomic_ptr_xchg(p, v) __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST)
+#elif defined(_MSC_VER)
+#define IO_HAVE_ATOMICS 1
+#define atomic_inc(p)         ((ut32)InterlockedIncrement((volatile LONG *)(p)))
+#define atomic_dec(p)         ((ut32)InterlockedDecrement((volatile LONG *)(p)))
+#define atomic_load(p)        ((ut32)InterlockedCompareExchange((volatile LONG *)(p), 0, 0))
+#define atomic_store(p, v)    InterlockedExchange((volatile LONG *)(p), (LONG)(v))
+#define atomic_ptr_load(p)    InterlockedCompareExchangePointer((PVOID volatile *)(p), NULL, NULL)
+#define atomic_ptr_xchg(p, v) InterlockedExchangePointer((PVOID volatile *)(p), v)
+#else
+#define IO_HAVE_ATOMICS 0
+#endif
+
+typedef struct {
+	ut64 addr;
+	ut64 last; ///< last address of the part, so parts can end at UT64_MAX
+	ut64 delta; ///< paddr = addr + delta - map address
+	int perm;
+	RzIODesc *desc; ///< NULL if its plugin has no pread
+} SnapshotPart;
+
+struct rz_io_map_snapshot_t {
+	ut32 refcount;
+	bool ff;
+	ut8 Oxff;
+	size_t count;
+	SnapshotPart *parts; ///< sorted by address, not overlapping
+};
+
+static RzIOMapSnapshot *snapshot_new(RzIO *io) {
+	RzIOMapSnapshot *snap = RZ_NEW0(RzIOMapSnapshot);
+	if (!snap) {
+		return NULL;
+	}
+	RzVector *skyline = &io->map_skyline.v;
+	snap->refcount = 1;
+	snap->ff = io->ff;
+	snap->Oxff = io->Oxff;
+	snap->parts = RZ_NEWS0(SnapshotPart, RZ_MAX(rz_vector_len(skyline), 1));
+	if (!snap->parts) {
+		free(snap);
+		return NULL;
+	}
+	RzSkylineItem *item;
+	rz_vector_foreach (skyline, item) {
+		RzIOMap *map = item->user;
+		if (!item->itv.size) {
+			continue;
+		}
+		SnapshotPart *part = &snap->parts[snap->count++];
+		part->addr = item->itv.addr;
+		part->last = item->itv.addr + item->itv.size - 1;
+		part->delta = map->delta + item->itv.addr - map->itv.addr;
+		part->perm = map->perm;
+		RzIODesc *desc = rz_io_desc_get(io, map->fd);
+		part->desc = desc && desc->plugin && desc->plugin->pread ? desc : NULL;
+	}
+	return snap;
+}
+
+static void snapshot_free(RzIOMapSnapshot *snap) {
+	if (snap) {
+		free(snap->parts);
+		free(snap);
+	}
+}
+
+#if IO_HAVE_ATOMICS
+
+/**
+ * Publishes \p snap, taking its reference, and drops the one of the
+ * previous snapshot once no reader can take it anymore.
+ */
+static void snapshot_publish(RzIO *io, RzIOMapSnapshot *snap) {
+	RzIOMapSnapshot *old = atomic_ptr_xchg(&io->map_snapshot, snap);
+	ut32 epoch = atomic_load(&io->map_snapshot_epoch);
+	atomic_store(&io->map_snapshot_epoch, epoch + 1);
+	while (atomic_load(&io->map_snapshot_readers[epoch & 1])) {
+		rz_sys_usleep(1);
+	}
+	rz_io_map_snapshot_release(old);
+}
+
+/**
+ * \brief Takes a reference to the snapshot of the maps, from any thread
+ *
+ * The snapshot is an immutable view of the maps, which can be read with
+ * rz_io_map_snapshot_read_at() while the thread owning \p io changes the
+ * maps. It is available between rz_io_concurrent_begin() and
+ * rz_io_concurrent_end().
+ *
+ * \return the snapshot, to be released with rz_io_map_snapshot_release(),
+ *         or NULL if there is none
+ */
+RZ_API RZ_OWN RzIOMapSnapshot *rz_io_map_snapshot_acquire(RZ_NONNULL RzIO *io) {
+	rz_return_val_if_fail(io, NULL);
+	ut32 epoch;
+	while (true) {
+		epoch = atomic_load(&io->map_snapshot_epoch);
+		atomic_inc(&io->map_snapshot_readers[epoch & 1]);
+		if (atomic_load(&io->map_snapshot_epoch) == epoch) {
+			break;
+		}
+		// the owner may be already waiting for the other epoch
+		atomic_dec(&io->map_snapshot_readers[epoch & 1]);
+	}
+	RzIOMapSnapshot *snap = atomic_ptr_load(&io->map_snapshot);
+	if (snap) {
+		atomic_inc(&snap->refcount);
+	}
+	atomic_dec(&io->map_snapshot_readers[epoch & 1]);
+	return snap;
+}
+
+RZ_API void rz_io_map_snapshot_release(RZ_NULLABLE RzIOMapSnapshot *snap) {
+	if (snap && !atomic_dec(&snap->refcount)) {
+		snapshot_free(snap);
+	}
+}
+
+#else
+
+static void snapshot_publish(RzIO *io, RzIOMapSnapshot *snap) {
+	snapshot_free(snap);
+}
+
+RZ_API RZ_OWN RzIOMapSnapshot *rz_io_map_snapshot_acquire(RZ_NONNULL RzIO *io) {
+	rz_return_val_if_fail(io, NULL);
+	// there is no way to take a reference without locking
+	return NULL;
+}
+
+RZ_API void rz_io_map_snapshot_release(RZ_NULLABLE RzIOMapSnapshot *snap) {
+	rz_warn_if_fail(!snap);
+}
+
+#endif
+
+/**
+ * Rebuilds the snapshot after a change of the maps, if there are concurrent
+ * readers.
+ */
+void io_map_snapshot_update(RzIO *io) {
+	if (io->concurrent) {
+		snapshot_publish(io, snapshot_new(io));
+	}
+}
+
+/**
+ * \brief Starts publishing snapshots of the maps for concurrent readers
+ *
+ * From now on, each change of the maps rebuilds the snapshot, so this must
+ * be called by the thread owning \p io before starting the readers. Calls
+ * can be nested and must be balanced by rz_io_concurrent_end().
+ *
+ * Concurrent readers see the maps, and read the descs through the pread
+ * callback of their plugins, but not the io cache, the desc caches or the
+ * physical mode. The descs must be neither written, resized nor closed
+ * while they read.
+ *
+ * \return true if concurrent reads are supported
+ */
+RZ_API bool rz_io_concurrent_begin(RZ_NONNULL RzIO *io) {
+	rz_return_val_if_fail(io, false);
+	if (!io->concurrent++) {
+		snapshot_publish(io, snapshot_new(io));
+	}
+	return IO_HAVE_ATOMICS && io->map_snapshot;
+}
+
+/**
+ * \brief Stops publishing the snapshots, once the concurrent readers are done
+ */
+RZ_API void rz_io_concurrent_end(RZ_NONNULL RzIO *io) {
+	rz_return_if_fail(io);
+	if (io->concurrent && !--io->concurrent) {
+		snapshot_publish(io, NULL);
+	}
+}
+
+static bool snapshot_read(const RzIOMapSnapshot *snap, ut64 addr, ut8 *buf, ut64 len) {
+	// first part whose last address >= addr
+	size_t lo = 0, hi = snap->count;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (snap->parts[mid].last < addr) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	ut64 last = addr + len - 1;
+	bool ret = true;
+	for (size_t i = lo; i < snap->count; i++) {
+		const SnapshotPart *part = &snap->parts[i];
+		if (part->addr > last) {
+			break;
+		}
+		ut64 from = RZ_MAX(part->addr, addr);
+		ut64 to = RZ_MIN(part->last, last);
+		int size = (int)(to - from + 1);
+		if (!(part->perm & RZ_PERM_R) || !part->desc) {
+			ret = false;
+			continue;
+		}
+		int r = part->desc->plugin->pread(part->desc, part->delta + from - part->addr, buf + (from - addr), size);
+		if (r != size) {
+			ret = false;
+		}
+	}
+	return ret;
+}
+
+/**
+ * \brief Reads \p len bytes at the virtual address \p addr through \p snap
+ *
+ * Unmapped bytes are filled with io->Oxff as rz_io_read_at() does.
+ *
+ * \return true iff all the reads on mapped regions are successful and complete
+ */
+RZ_API bool rz_io_map_snapshot_read_at(RZ_NONNULL RzIOMapSnapshot *snap, ut64 addr, RZ_NONNULL ut8 *buf, int len) {
+	rz_return_val_if_fail(snap && buf && len >= 0, false);
+	if (!len) {
+		return false;
+	}
+	if (snap->ff) {
+		memset(buf, snap->Oxff, len);
+	}
+	ut64 head = RZ_MIN((ut64)len, UT64_MAX - addr + 1);
+	bool ret = snapshot_read(snap, addr, buf, head);
+	if (head < (ut64)len) {
+		// wraps around the address space
+		ret &= snapshot_read(snap, 0, buf + head, len - head);
+	}
+	return ret;
+}
+
+/**
+ * \brief Reads \p len bytes at the virtual address \p addr, from any thread
+ *
+ * Takes no lock, reading the snapshot of the maps published between
+ * rz_io_concurrent_begin() and rz_io_concurrent_end().
+ *
+ * \return true iff all the reads on mapped regions are successful and
+ *         complete, false if there is no snapshot
+ */
+RZ_API bool rz_io_read_at_concurrent(RZ_NONNULL RzIO *io, ut64 addr, RZ_NONNULL ut8 *buf, int len) {
+	rz_return_val_if_fail(io && buf && len >= 0, false);
+	RzIOMapSnapshot *snap = rz_io_map_snapshot_acquire(io);
+	if (!snap) {
+		return false;
+	}
+	bool ret = rz_io_map_snapshot_read_at(snap, addr, buf, len);
+	rz_io_map_snapshot_release(snap);
+	return ret;
+}
@@ -6,6 +6,7 @@
 #include <rz_io.h>
 #include <sdb.h>
 #include <string.h>
+#include "io_private.h"
 
 // shall be used by plugins for creating descs
 RZ_API RzIODesc *rz_io_desc_new(RzIO *io, RzIOPlugin *plugin, const char *uri, int perm, int mode, void *data) {
@@ -282,6 +283,7 @@ RZ_API bool rz_io_desc_exchange(RzIO *io, int fd, int fdx) {
 			map->perm &= (descx->perm | RZ_PERM_X);
 		}
 	}
+	io_map_snapshot_update(io);
 	return true;
 }
 
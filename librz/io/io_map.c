@@ -7,6 +7,7 @@
 #include <sdb.h>
 #include "rz_util.h"
 #include "rz_vector.h"
+#include "io_private.h"
 
 #define END_OF_MAP_IDS UT32_MAX
 
@@ -19,6 +20,7 @@ void io_map_calculate_skyline(RzIO *io) {
 		RzIOMap *map = (RzIOMap *)*it;
 		rz_skyline_add(&io->map_skyline, map->itv, map);
 	}
+	io_map_snapshot_update(io);
 }
 
 RzIOMap *io_map_new(RzIO *io, int fd, int perm, ut64 delta, ut64 addr, ut64 size) {
@@ -44,6 +46,7 @@ RzIOMap *io_map_new(RzIO *io, int fd, int perm, ut64 delta, ut64 addr, ut64 size
 	// new map lives on the top, being top the list's tail
 	rz_pvector_push(&io->maps, map);
 	rz_skyline_add(&io->map_skyline, map->itv, map);
+	io_map_snapshot_update(io);
 	return map;
 }
 
@@ -327,6 +330,22 @@ RZ_API void rz_io_map_fini(RzIO *io) {
 	rz_id_pool_free(io->map_ids);
 	io->map_ids = NULL;
 	rz_skyline_clear(&io->map_skyline);
+	io_map_snapshot_update(io);
+}
+
+/**
+ * \brief Changes the permissions of \p map, which belongs to \p io
+ *
+ * The maps seen by concurrent readers are updated too, so the permissions
+ * of a map must not be changed directly.
+ */
+RZ_API void rz_io_map_set_perm(RZ_NONNULL RzIO *io, RZ_NONNULL RzIOMap *map, int perm) {
+	rz_return_if_fail(io && map);
+	if (map->perm == perm) {
+		return;
+	}
+	map->perm = perm;
+	io_map_snapshot_update(io);
 }
 
 RZ_API void rz_io_map_set_name(RzIOMap *map, const char *name) {
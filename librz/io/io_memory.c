@@ -111,6 +111,25 @@ int io_memory_read(RzIO *io, RzIODesc *fd, ut8 *buf, int count) {
 	return count;
 }
 
+/**
+ * Reads at \p addr without moving the offset of \p fd, so it can be called
+ * from concurrent threads as long as \p fd is not written or resized.
+ */
+int io_memory_pread(RzIODesc *fd, ut64 addr, ut8 *buf, int count) {
+	if (!fd || !fd->data || count < 0) {
+		return -1;
+	}
+	ut32 mallocsz = _io_malloc_sz(fd);
+	if (addr >= mallocsz) {
+		memset(buf, 0xff, count);
+		return 0;
+	}
+	int size = (int)RZ_MIN((ut64)count, mallocsz - addr);
+	memcpy(buf, _io_malloc_buf(fd) + addr, size);
+	memset(buf + size, 0xff, count - size);
+	return size;
+}
+
 int io_memory_close(RzIODesc *fd) {
 	RzIOMalloc *riom;
 	if (!fd || !fd->data) {
@@ -5,7 +5,8 @@
 #define _IO_PRIVATE_H_
 
 RzIOMap *io_map_new(RzIO *io, int fd, int perm, ut64 delta, ut64 addr, ut64 size);
-RzIOMap *io_map_add(RzIO *io, int fd, int flags, ut64 delta, ut64 addr, ut64 size, bool do_skyline);
+RzIOMap *io_map_add(RzIO *io, int fd, int flags, ut64 delta, ut64 addr, ut64 size);
 void io_map_calculate_skyline(RzIO *io);
+void io_map_snapshot_update(RzIO *io);
 
 #endif
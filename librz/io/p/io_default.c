@@ -180,6 +180,28 @@ static bool __resize(RzIO *io, RzIODesc *fd, ut64 size) {
 }
 
 #if __UNIX__
+// pread(2) doesn't move the offset of the file, so it is thread-safe
+static int __pread(RzIODesc *fd, ut64 addr, ut8 *buf, int len) {
+	rz_return_val_if_fail(fd && fd->data && buf && len >= 0, -1);
+	RzIOMMapFileObj *mmo = fd->data;
+	if (!mmo->buf || mmo->buf->fd < 0 || addr > ST64_MAX) {
+		return -1;
+	}
+	int done = 0;
+	while (done < len) {
+		ssize_t r = pread(mmo->buf->fd, buf + done, len - done, (off_t)(addr + done));
+		if (r < 0 && errno == EINTR) {
+			continue;
+		}
+		if (r <= 0) {
+			break;
+		}
+		done += (int)r;
+	}
+	memset(buf + done, 0xff, len - done);
+	return done;
+}
+
 static bool __is_blockdevice(RzIODesc *desc) {
 	rz_return_val_if_fail(desc && desc->data, false);
 	RzIOMMapFileObj *mmo = desc->data;
@@ -199,6 +221,9 @@ RzIOPlugin rz_io_plugin_default = {
 	.open = __open_default,
 	.close = __close,
 	.read = __read,
+#if __UNIX__
+	.pread = __pread,
+#endif
 	.check = __plugin_open_default,
 	.lseek = __lseek,
 	.write = __write,
@@ -90,6 +90,7 @@ RzIOPlugin rz_io_plugin_tcp = {
 	.open = __open,
 	.close = io_memory_close,
 	.read = io_memory_read,
+	.pread = io_memory_pread,
 	.check = __check,
 	.lseek = io_memory_lseek,
 	.write = io_memory_write,
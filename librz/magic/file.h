@@ -62,6 +62,7 @@ int file_zmagic(struct rz_magic_set *, int, const char *, const ut8 *, size_t);
 int file_ascmagic(struct rz_magic_set *, const unsigned char *, size_t);
 int file_is_tar(struct rz_magic_set *, const unsigned char *, size_t);
 int file_softmagic(struct rz_magic_set *, const unsigned char *, size_t, int);
+int file_softmagic_test(struct rz_magic_set *, struct rz_magic *, const unsigned char *, size_t);
 struct mlist *file_apprentice(struct rz_magic_set *, const char *, int);
 ut64 file_signextend(RzMagic *, struct rz_magic *, ut64);
 void file_delmagic(struct rz_magic *, int type, size_t entries);
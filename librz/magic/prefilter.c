@@ -0,0 +1,363 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_userconf.h>
+#include <rz_magic.h>
+#include <rz_util.h>
+
+/*
+ * A prefilter tells the offsets where no top-level test of a magic set can
+ * match, so scanning a buffer for magic needs the interpreter only at the
+ * other ones. Each top-level binary test comparing fixed bytes is compiled
+ * into a signature of up to PREFILTER_SIG_MAX bytes, keyed by one of its
+ * bytes at a fixed offset (the anchor). The signatures are bucketed by anchor
+ * and key byte, with a bitmap of the key bytes of each anchor. The tests
+ * which can not be compiled are run by the interpreter on their own, and so
+ * are the ones whose signature matched, to confirm it.
+ */
+
+#if USE_LIB_MAGIC
+
+struct rz_magic_prefilter_t {
+	int dummy;
+};
+
+RZ_API RZ_OWN RzMagicPrefilter *rz_magic_prefilter_new(RZ_NONNULL RzMagic *ms) {
+	rz_return_val_if_fail(ms, NULL);
+	// the tests of the system library can not be inspected
+	return RZ_NEW0(RzMagicPrefilter);
+}
+
+RZ_API void rz_magic_prefilter_free(RZ_NULLABLE RzMagicPrefilter *pf) {
+	free(pf);
+}
+
+RZ_API bool rz_magic_prefilter_match(RZ_NONNULL RzMagicPrefilter *pf, RZ_NONNULL const ut8 *buf, size_t size) {
+	return true;
+}
+
+#else
+
+#include "file.h"
+
+#define PREFILTER_SIG_MAX 8
+
+typedef struct {
+	struct rz_magic *m;
+	ut32 nconts; ///< continuations following m
+} MagicEntry;
+
+typedef struct {
+	MagicEntry e;
+	ut32 anchor; ///< offset of the key byte
+	ut32 offset; ///< offset of the first byte of the signature
+	ut32 need; ///< bytes the test reads from the start of the buffer
+	ut8 key;
+	ut8 len;
+	ut8 bytes[PREFILTER_SIG_MAX];
+	ut8 mask[PREFILTER_SIG_MAX];
+} MagicSignature;
+
+typedef struct {
+	ut32 offset;
+	ut8 keys[256 / 8]; ///< bitmap of the key bytes of the signatures
+	ut32 start[257]; ///< signatures with the key byte k are sigs[start[k]..start[k + 1])
+} MagicAnchor;
+
+struct rz_magic_prefilter_t {
+	RzMagic *ms;
+	RzVector /*<MagicSignature>*/ sigs;
+	RzVector /*<MagicAnchor>*/ anchors;
+	RzVector /*<MagicEntry>*/ tests; ///< top-level tests without a signature
+	bool tar;
+	bool always; ///< the set describes any buffer anyway
+};
+
+static bool sig_numeric(struct rz_magic *m, MagicSignature *sig) {
+	int width;
+	bool big;
+	switch (m->type) {
+	case FILE_BYTE:
+		width = 1;
+		big = false;
+		break;
+	case FILE_SHORT:
+	case FILE_BESHORT:
+	case FILE_LESHORT:
+		width = 2;
+		big = m->type == FILE_SHORT ? RZ_SYS_ENDIAN : m->type == FILE_BESHORT;
+		break;
+	case FILE_LONG:
+	case FILE_BELONG:
+	case FILE_LELONG:
+		width = 4;
+		big = m->type == FILE_LONG ? RZ_SYS_ENDIAN : m->type == FILE_BELONG;
+		break;
+	case FILE_QUAD:
+	case FILE_BEQUAD:
+	case FILE_LEQUAD:
+		width = 8;
+		big = m->type == FILE_QUAD ? RZ_SYS_ENDIAN : m->type == FILE_BEQUAD;
+		break;
+	default:
+		return false;
+	}
+	ut64 mask = UT64_MAX;
+	if (m->num_mask) {
+		if ((m->mask_op & FILE_OPS_MASK) != FILE_OPAND || (m->mask_op & FILE_OPINVERSE)) {
+			return false;
+		}
+		mask = m->num_mask;
+	} else if (m->mask_op & FILE_OPINVERSE) {
+		return false;
+	}
+	sig->offset = m->offset;
+	sig->need = m->offset + width;
+	sig->len = width;
+	for (int i = 0; i < width; i++) {
+		// the value is compared after masking, so the masked bytes must be equal to it
+		int shift = 8 * (big ? width - 1 - i : i);
+		sig->bytes[i] = (m->value.q >> shift) & 0xff;
+		sig->mask[i] = (mask >> shift) & 0xff;
+	}
+	return true;
+}
+
+static bool sig_string(struct rz_magic *m, MagicSignature *sig) {
+	if (m->type != FILE_STRING || m->str_flags || !m->vallen) {
+		return false;
+	}
+	sig->offset = m->offset;
+	sig->need = m->offset + m->vallen;
+	sig->len = RZ_MIN(m->vallen, PREFILTER_SIG_MAX);
+	memcpy(sig->bytes, m->value.s, sig->len);
+	memset(sig->mask, 0xff, sig->len);
+	return true;
+}
+
+/**
+ * Compiles the necessary condition for the top-level test \p m to match:
+ * its bytes at a fixed offset, with the first fully compared one as key.
+ */
+static bool sig_compile(struct rz_magic *m, MagicSignature *sig) {
+	if (m->reln != '=' || (m->flag & (INDIR | OFFADD | INDIROFFADD))) {
+		return false;
+	}
+	if (!sig_numeric(m, sig) && !sig_string(m, sig)) {
+		return false;
+	}
+	for (int i = 0; i < sig->len; i++) {
+		if (sig->mask[i] == 0xff) {
+			sig->anchor = sig->offset + i;
+			sig->key = sig->bytes[i];
+			return sig->need >= sig->offset;
+		}
+	}
+	return false;
+}
+
+static int sig_cmp(const void *a, const void *b) {
+	const MagicSignature *x = a, *y = b;
+	if (x->anchor != y->anchor) {
+		return x->anchor < y->anchor ? -1 : 1;
+	}
+	return (int)x->key - (int)y->key;
+}
+
+static bool prefilter_index(RzMagicPrefilter *pf) {
+	if (!rz_vector_empty(&pf->sigs)) {
+		qsort(pf->sigs.a, rz_vector_len(&pf->sigs), sizeof(MagicSignature), sig_cmp);
+	}
+	MagicAnchor *anchor = NULL;
+	for (ut32 i = 0; i < rz_vector_len(&pf->sigs); i++) {
+		MagicSignature *sig = rz_vector_index_ptr(&pf->sigs, i);
+		if (!anchor || anchor->offset != sig->anchor) {
+			anchor = rz_vector_push(&pf->anchors, NULL);
+			if (!anchor) {
+				return false;
+			}
+			memset(anchor, 0, sizeof(*anchor));
+			anchor->offset = sig->anchor;
+			for (int k = 0; k < 257; k++) {
+				anchor->start[k] = i;
+			}
+		}
+		anchor->keys[sig->key >> 3] |= 1 << (sig->key & 7);
+		// the signatures are sorted by key, so all the later buckets start after this one
+		for (int k = sig->key + 1; k < 257; k++) {
+			anchor->start[k] = i + 1;
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief Compiles the top-level tests of the magic set \p ms into a prefilter
+ *
+ * The prefilter keeps using \p ms to run the tests it could not compile, so
+ * \p ms must outlive it and must not be used by other threads meanwhile.
+ * A compiled prefilter can be reused for any number of buffers.
+ */
+RZ_API RZ_OWN RzMagicPrefilter *rz_magic_prefilter_new(RZ_NONNULL RzMagic *ms) {
+	rz_return_val_if_fail(ms, NULL);
+	if (!ms->mlist || file_check_mem(ms, 0) == -1) {
+		return NULL;
+	}
+	RzMagicPrefilter *pf = RZ_NEW0(RzMagicPrefilter);
+	if (!pf) {
+		return NULL;
+	}
+	pf->ms = ms;
+	pf->tar = !(ms->flags & RZ_MAGIC_NO_CHECK_TAR);
+	int mime = ms->flags & RZ_MAGIC_MIME;
+	pf->always = mime && !(mime & RZ_MAGIC_MIME_TYPE);
+	rz_vector_init(&pf->sigs, sizeof(MagicSignature), NULL, NULL);
+	rz_vector_init(&pf->anchors, sizeof(MagicAnchor), NULL, NULL);
+	rz_vector_init(&pf->tests, sizeof(MagicEntry), NULL, NULL);
+	if (!(ms->flags & RZ_MAGIC_NO_CHECK_SOFT)) {
+		for (struct mlist *ml = ms->mlist->next; ml != ms->mlist; ml = ml->next) {
+			for (ut32 i = 0; i < ml->nmagic; i++) {
+				struct rz_magic *m = &ml->magic[i];
+				// only the binary tests are run on buffers, see file_buffer()
+				if (m->cont_level || !(m->flag & BINTEST)) {
+					continue;
+				}
+				MagicSignature sig = { .e = { .m = m } };
+				while (i + sig.e.nconts + 1 < ml->nmagic && m[sig.e.nconts + 1].cont_level) {
+					sig.e.nconts++;
+				}
+				bool ok = sig_compile(m, &sig)
+					? !!rz_vector_push(&pf->sigs, &sig)
+					: !!rz_vector_push(&pf->tests, &sig.e);
+				if (!ok) {
+					rz_magic_prefilter_free(pf);
+					return NULL;
+				}
+			}
+		}
+	}
+	if (!prefilter_index(pf)) {
+		rz_magic_prefilter_free(pf);
+		return NULL;
+	}
+	return pf;
+}
+
+RZ_API void rz_magic_prefilter_free(RZ_NULLABLE RzMagicPrefilter *pf) {
+	if (!pf) {
+		return;
+	}
+	rz_vector_fini(&pf->sigs);
+	rz_vector_fini(&pf->anchors);
+	rz_vector_fini(&pf->tests);
+	free(pf);
+}
+
+/**
+ * An entry printing nothing is described only by its continuations, which
+ * are run only if one of the first level matches. Tells whether one may
+ * match, once the entry \p e itself matched.
+ */
+static bool conts_may_match(RzMagicPrefilter *pf, const MagicEntry *e, const ut8 *buf, size_t size) {
+	struct rz_magic *m = e->m;
+	if (*((pf->ms->flags & RZ_MAGIC_MIME) ? m->mimetype : m->desc)) {
+		return true;
+	}
+	for (ut32 i = 1; i <= e->nconts; i++) {
+		struct rz_magic *c = &m[i];
+		if (c->cont_level != 1) {
+			continue;
+		}
+		// offsets relative to the previous match depend on the interpreter state
+		if ((c->flag & (INDIR | OFFADD)) || c->cond != COND_NONE || c->type == FILE_DEFAULT) {
+			return true;
+		}
+		if (file_softmagic_test(pf->ms, c, buf, size)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static inline bool sig_match(const MagicSignature *sig, const ut8 *buf, size_t size) {
+	if (sig->need > size) {
+		// the interpreter does not read past the end of the buffer
+		return false;
+	}
+	const ut8 *p = buf + sig->offset;
+	for (int i = 0; i < sig->len; i++) {
+		if ((p[i] & sig->mask[i]) != sig->bytes[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief Tells whether rz_magic_buffer() may identify the \p size bytes of \p buf
+ *
+ * \return false only if rz_magic_buffer() on the same bytes would surely not
+ *         find any magic, true if it may
+ */
+RZ_API bool rz_magic_prefilter_match(RZ_NONNULL RzMagicPrefilter *pf, RZ_NONNULL const ut8 *buf, size_t size) {
+	rz_return_val_if_fail(pf && buf, true);
+	if (size < 2 || pf->always) {
+		// described as empty or very short, or without any type
+		return true;
+	}
+	// is_tar() needs an octal checksum, possibly after blanks
+	if (pf->tar && size >= 512 && (isspace(buf[148]) || (buf[148] >= '0' && buf[148] <= '7'))) {
+		return true;
+	}
+	MagicAnchor *anchor;
+	rz_vector_foreach (&pf->anchors, anchor) {
+		if (anchor->offset >= size) {
+			// sorted by offset, so no later signature fits either
+			break;
+		}
+		ut8 key = buf[anchor->offset];
+		if (!(anchor->keys[key >> 3] & (1 << (key & 7)))) {
+			continue;
+		}
+		for (ut32 i = anchor->start[key]; i < anchor->start[key + 1]; i++) {
+			MagicSignature *sig = rz_vector_index_ptr(&pf->sigs, i);
+			if (sig_match(sig, buf, size) && file_softmagic_test(pf->ms, sig->e.m, buf, size) &&
+				conts_may_match(pf, &sig->e, buf, size)) {
+				return true;
+			}
+		}
+	}
+	MagicEntry *e;
+	rz_vector_foreach (&pf->tests, e) {
+		if (file_softmagic_test(pf->ms, e->m, buf, size) && conts_may_match(pf, e, buf, size)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+#endif
+
+/**
+ * \brief Marks in \p candidates the offsets of \p buf where rz_magic_buffer() may find magic
+ *
+ * The offsets from 0 to \p count are tested in one pass, each one on the
+ * \p window bytes following it (or less at the end of \p buf), as
+ * rz_magic_prefilter_match() does.
+ *
+ * \param candidates bitmap of at least (count + 7) / 8 bytes, bit i set for the offset i
+ * \return the number of candidate offsets
+ */
+RZ_API size_t rz_magic_prefilter_scan(RZ_NONNULL RzMagicPrefilter *pf, RZ_NONNULL const ut8 *buf, size_t size, size_t count, size_t window, RZ_NONNULL ut8 *candidates) {
+	rz_return_val_if_fail(pf && buf && candidates, 0);
+	count = RZ_MIN(count, size);
+	memset(candidates, 0, (count + 7) / 8);
+	size_t n = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (rz_magic_prefilter_match(pf, buf + i, RZ_MIN(window, size - i))) {
+			candidates[i >> 3] |= 1 << (i & 7);
+			n++;
+		}
+	}
+	return n;
+}
@@ -273,6 +273,24 @@ static int match(RzMagic *ms, struct rz_magic *magic, ut32 nmagic, const ut8 *s,
 	return returnval; /* This is hit if -k is set or there is no match */
 }
 
+/*
+ * Tests only the top-level entry m, as match() does before processing its
+ * continuations. Returns 1 if it matches (or the test failed, so the caller
+ * can let match() report it), 0 otherwise.
+ */
+int file_softmagic_test(RzMagic *ms, struct rz_magic *m, const ut8 *s, size_t nbytes) {
+	ms->offset = m->offset;
+	ms->line = m->lineno;
+	int got = mget(ms, s, m, nbytes, 0);
+	if (got == -1) {
+		return 1;
+	}
+	if (!got) {
+		return m->reln == '!';
+	}
+	return magiccheck(ms, m) != 0;
+}
+
 static int check_fmt(RzMagic *ms, struct rz_magic *m) {
 	RzRegex rx;
 	int rc;
@@ -367,8 +367,7 @@ static bool has_file_arg(int argc, const char **argv, RzGetopt *opt) {
 	return (argc >= 2 && argv[opt->ind] && strcmp(argv[opt->ind], "--")) || ((!strcmp(argv[opt->ind - 1], "--") && argv[opt->ind]));
 }
 
-RZ_API int rz_main_rizin(int argc, const char **argv) {
-	RzCore *r;
+static int main_rizin(RzCore *r, int argc, const char **argv) {
 	bool forcequit = false;
 	bool haveRarunProfile = false;
 	RzListIter *iter;
@@ -446,7 +445,13 @@ RZ_API int rz_main_rizin(int argc, const char **argv) {
 		free(sysdbg);
 	}
 
-	r = rz_core_new();
+	if (!r) {
+		r = rz_core_new();
+		if (r) {
+			// the commands apply the symbols and relocs when they need them
+			rz_config_set_b(r->config, "bin.lazyflags", true);
+		}
+	}
 	if (!r) {
 		eprintf("Cannot initialize RzCore\n");
 		LISTS_FREE();
@@ -1505,3 +1510,21 @@ beach:
 	RZ_FREE(pfile);
 	return ret;
 }
+
+RZ_API int rz_main_rizin(int argc, const char **argv) {
+	return main_rizin(NULL, argc, argv);
+}
+
+/**
+ * \brief Runs rizin like rz_main_rizin(), but on a core created in advance
+ *
+ * Lets a process initialize the core once and fork a child running each
+ * command line, skipping the registration of the plugins and the
+ * initialization of the config in the children.
+ *
+ * \param core created with rz_core_new(), freed before returning
+ */
+RZ_API int rz_main_rizin_with_core(RZ_NONNULL RZ_OWN RzCore *core, int argc, const char **argv) {
+	rz_return_val_if_fail(core, 1);
+	return main_rizin(core, argc, argv);
+}
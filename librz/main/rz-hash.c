@@ -11,6 +11,7 @@
 #include <rz_crypto.h>
 
 #define RZ_HASH_DEFAULT_BLOCK_SIZE 0x1000
+#define RZ_HASH_SLOTS_PER_THREAD   16
 
 typedef struct {
 	ut8 *buf;
@@ -61,6 +62,7 @@ typedef struct rz_hash_context {
 	ut32 nfiles;
 	ut64 block_size;
 	ut64 iterate;
+	ut64 threads;
 	/* Output here */
 	PJ *pj;
 } RzHashContext;
@@ -68,7 +70,7 @@ typedef struct rz_hash_context {
 typedef bool (*RzHashRun)(RzHashContext *ctx, RzIO *io, const char *filename);
 
 static void rz_hash_show_help(bool usage_only) {
-	printf("Usage: rz-hash [-vhBkjLq] [-b S] [-a A] [-c H] [-E A] [-D A] [-s S] [-x S] [-f O] [-t O] [files|-] ...\n");
+	printf("Usage: rz-hash [-vhBkjLq] [-b S] [-a A] [-c H] [-E A] [-D A] [-s S] [-x S] [-f O] [-t O] [-T N] [files|-] ...\n");
 	if (usage_only) {
 		return;
 	}
@@ -86,6 +88,7 @@ static void rz_hash_show_help(bool usage_only) {
 		" -E algo     Encrypt the given input; use -S to set key and -I to set IV (if needed)\n"
 		" -f from     Starts the calculation at given offset\n"
 		" -t to       Stops the calculation at given offset\n"
+		" -T threads  Hashes files (or blocks when -B is set) using N threads (0 = all cores)\n"
 		" -I iv       Sets the initialization vector (IV)\n"
 		" -i times    Repeat the calculation N times\n"
 		" -j          Outputs the result as a JSON structure\n"
@@ -317,10 +320,11 @@ static void rz_hash_parse_cmdline(int argc, const char **argv, RzHashContext *ct
 	const char *seed = NULL;
 	const char *key = NULL;
 	memset((void *)ctx, 0, sizeof(RzHashContext));
+	ctx->threads = 1;
 
 	RzGetopt opt;
 	int c;
-	rz_getopt_init(&opt, argc, argv, "jD:e:vE:a:i:I:S:K:s:x:b:nBhf:t:kLqc:");
+	rz_getopt_init(&opt, argc, argv, "jD:e:vE:a:i:I:S:K:s:x:b:nBhf:t:T:kLqc:");
 	while ((c = rz_getopt_next(&opt)) != -1) {
 		switch (c) {
 		case 'q': rz_hash_ctx_set_quiet(ctx); break;
@@ -348,6 +352,7 @@ static void rz_hash_parse_cmdline(int argc, const char **argv, RzHashContext *ct
 		case 'b': rz_hash_ctx_set_unsigned(ctx, block_size, opt.arg); break;
 		case 'f': rz_hash_ctx_set_unsigned(ctx, offset.from, opt.arg); break;
 		case 't': rz_hash_ctx_set_unsigned(ctx, offset.to, opt.arg); break;
+		case 'T': ctx->threads = strtoull(opt.arg, NULL, 0); break;
 		case 'v': ctx->operation = RZ_HASH_OP_VERSION; break;
 		case 'h': ctx->operation = RZ_HASH_OP_HELP; break;
 		case 's': rz_hash_ctx_set_input(ctx, input, opt.arg, false); break;
@@ -423,6 +428,9 @@ static void rz_hash_parse_cmdline(int argc, const char **argv, RzHashContext *ct
 		if (key) {
 			rz_hash_error(ctx, RZ_HASH_OP_ERROR, "algorithm 'luhn' is incompatible with -K option.\n");
 		}
+		if (ctx->threads != 1) {
+			rz_hash_error(ctx, RZ_HASH_OP_ERROR, "algorithm 'luhn' is incompatible with -T option.\n");
+		}
 		ctx->operation = RZ_HASH_OP_LUHN;
 	} else if (ctx->operation == RZ_HASH_OP_ENCRYPT || ctx->operation == RZ_HASH_OP_DECRYPT) {
 		if (!key && strncmp("base", ctx->algorithm, 4) && strcmp("punycode", ctx->algorithm)) {
@@ -444,6 +452,9 @@ static void rz_hash_parse_cmdline(int argc, const char **argv, RzHashContext *ct
 		if (ctx->mode == RZ_HASH_MODE_RANDOMART) {
 			rz_hash_error(ctx, RZ_HASH_OP_ERROR, "option -k is incompatible with -E/-D.\n");
 		}
+		if (ctx->threads != 1) {
+			rz_hash_error(ctx, RZ_HASH_OP_ERROR, "option -T is incompatible with -E/-D.\n");
+		}
 	} else if (ctx->operation == RZ_HASH_OP_HASH) {
 		if (ctx->iv) {
 			rz_hash_error(ctx, RZ_HASH_OP_ERROR, "option -I is incompatible with -a; use -S to define a seed or -K to define an hmac key.\n");
@@ -795,18 +806,109 @@ static RzList *parse_hash_algorithms(RzHashContext *ctx) {
 	return rz_str_split_list(ctx->algorithm, ",", 0);
 }
 
+static RzMsgDigest *rz_hash_msg_digest_new(RzHashContext *ctx, RzList *algorithms) {
+	const char *algorithm;
+	RzListIter *it;
+
+	RzMsgDigest *md = rz_msg_digest_new();
+	if (!md) {
+		RZ_LOG_ERROR("rz-hash: error, cannot allocate hash context memory\n");
+		return NULL;
+	}
+
+	rz_list_foreach (algorithms, it, algorithm) {
+		if (!rz_msg_digest_configure(md, algorithm)) {
+			rz_msg_digest_free(md);
+			return NULL;
+		}
+	}
+
+	if (ctx->key.len > 0 && !rz_msg_digest_hmac(md, ctx->key.buf, ctx->key.len)) {
+		rz_msg_digest_free(md);
+		return NULL;
+	}
+	return md;
+}
+
+static bool rz_hash_check_file_range(RzHashContext *ctx, ut64 filesize) {
+	if (ctx->offset.to > filesize) {
+		RZ_LOG_ERROR("rz-hash: error, -t value is greater than file size\n");
+		return false;
+	}
+
+	if (ctx->offset.from > filesize) {
+		RZ_LOG_ERROR("rz-hash: error, -f value is greater than file size\n");
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Reads the range [from, to) block by block (using `block` as a buffer of
+ * ctx->block_size bytes) and computes the final digest in `md`.
+ * When `use_seed` is set, the seed is prepended or appended to the data.
+ */
+static bool rz_hash_digest_range(RzHashContext *ctx, RzIO *io, RzMsgDigest *md, ut8 *block, ut64 from, ut64 to, bool use_seed) {
+	ut64 bsize = ctx->block_size;
+	if (!rz_msg_digest_init(md)) {
+		return false;
+	}
+
+	if (use_seed && ctx->as_prefix && ctx->seed.buf &&
+		!rz_msg_digest_update(md, ctx->seed.buf, ctx->seed.len)) {
+		return false;
+	}
+
+	for (ut64 j = from; j < to; j += bsize) {
+		int read = rz_io_pread_at(io, j, block, to - j > bsize ? bsize : (to - j));
+		if (!rz_msg_digest_update(md, block, read)) {
+			return false;
+		}
+	}
+
+	if (use_seed && !ctx->as_prefix && ctx->seed.buf &&
+		!rz_msg_digest_update(md, ctx->seed.buf, ctx->seed.len)) {
+		return false;
+	}
+
+	return rz_msg_digest_final(md) && rz_msg_digest_iterate(md, ctx->iterate);
+}
+
+static void rz_hash_print_results(RzHashContext *ctx, RzMsgDigest *md, RzList *algorithms, const ut8 *cmphash, size_t cmphashlen, ut64 from, ut64 to, ut64 filesize, const char *filename) {
+	const char *algorithm;
+	RzListIter *it;
+	const ut8 *digest = NULL;
+	RzMsgDigestSize digest_size = 0;
+
+	rz_list_foreach (algorithms, it, algorithm) {
+		if (ctx->mode == RZ_HASH_MODE_JSON) {
+			pj_o(ctx->pj);
+		}
+		if (cmphash) {
+			bool result = false;
+			digest = rz_msg_digest_get_result(md, algorithm, &digest_size);
+			if (digest_size == cmphashlen) {
+				result = !memcmp(cmphash, digest, digest_size);
+			}
+			rz_hash_context_compare_hashes(ctx, filesize, result, algorithm, filename);
+		} else {
+			rz_hash_print_digest(ctx, md, algorithm, from, to, filename);
+		}
+		if (ctx->mode == RZ_HASH_MODE_JSON) {
+			pj_end(ctx->pj);
+		}
+	}
+}
+
 static bool calculate_hash(RzHashContext *ctx, RzIO *io, const char *filename) {
 	bool result = false;
-	const char *algorithm;
 	RzList *algorithms = NULL;
-	RzListIter *it;
 	RzMsgDigest *md = NULL;
 	ut64 bsize = 0;
 	ut64 filesize;
 	ut8 *block = NULL;
 	ut8 *cmphash = NULL;
-	const ut8 *digest = NULL;
-	RzMsgDigestSize digest_size = 0;
+	size_t cmphashlen = 0;
 
 	algorithms = parse_hash_algorithms(ctx);
 	if (!algorithms || rz_list_length(algorithms) < 1) {
@@ -816,19 +918,8 @@ static bool calculate_hash(RzHashContext *ctx, RzIO *io, const char *filename) {
 
 	filesize = rz_io_desc_size(io->desc);
 
-	md = rz_msg_digest_new();
-	if (!md) {
-		RZ_LOG_ERROR("rz-hash: error, cannot allocate hash context memory\n");
-		goto calculate_hash_end;
-	}
-
-	if (ctx->offset.to > filesize) {
-		RZ_LOG_ERROR("rz-hash: error, -t value is greater than file size\n");
-		goto calculate_hash_end;
-	}
-
-	if (ctx->offset.from > filesize) {
-		RZ_LOG_ERROR("rz-hash: error, -f value is greater than file size\n");
+	md = rz_hash_msg_digest_new(ctx, algorithms);
+	if (!md || !rz_hash_check_file_range(ctx, filesize)) {
 		goto calculate_hash_end;
 	}
 
@@ -839,136 +930,343 @@ static bool calculate_hash(RzHashContext *ctx, RzIO *io, const char *filename) {
 		goto calculate_hash_end;
 	}
 
-	rz_list_foreach (algorithms, it, algorithm) {
-		if (!rz_msg_digest_configure(md, algorithm)) {
+	if (ctx->compare && !rz_hash_parse_hexadecimal("-c", ctx->compare, &cmphash, &cmphashlen)) {
+		goto calculate_hash_end;
+	}
+
+	ut64 to = ctx->offset.to ? ctx->offset.to : filesize;
+	if (ctx->show_blocks) {
+		for (ut64 j = ctx->offset.from; j < to; j += bsize) {
+			ut64 end = to - j > bsize ? j + bsize : to;
+			if (!rz_hash_digest_range(ctx, io, md, block, j, end, false)) {
+				goto calculate_hash_end;
+			}
+			rz_hash_print_results(ctx, md, algorithms, NULL, 0, j, j + bsize, filesize, filename);
+		}
+	} else {
+		if (!rz_hash_digest_range(ctx, io, md, block, ctx->offset.from, to, true)) {
 			goto calculate_hash_end;
 		}
+		rz_hash_print_results(ctx, md, algorithms, cmphash, cmphashlen, ctx->offset.from, to, filesize, filename);
 	}
+	result = true;
 
-	if (ctx->key.len > 0 && !rz_msg_digest_hmac(md, ctx->key.buf, ctx->key.len)) {
-		goto calculate_hash_end;
+calculate_hash_end:
+	rz_list_free(algorithms);
+	free(block);
+	free(cmphash);
+	if (md) {
+		rz_msg_digest_free(md);
 	}
+	return result;
+}
 
-	if (ctx->compare) {
-		ut64 to = ctx->offset.to ? ctx->offset.to : filesize;
-		size_t cmphashlen = 0;
-		bool result = false;
+/**
+ * A job is either a whole file (multi-file mode) or a single block of a file
+ * (block mode, -B). Jobs live in a ring of slots so that at most `n_slots`
+ * results are kept in memory while the main thread prints them in order.
+ */
+typedef struct {
+	ut64 from;
+	ut64 to;
+	ut64 filesize;
+	RzMsgDigest *md;
+	bool done;
+	bool success;
+} RzHashJob;
 
-		if (!rz_hash_parse_hexadecimal("-c", ctx->compare, &cmphash, &cmphashlen)) {
-			// RZ_LOG_ERROR("rz-hash: error, cannot allocate block memory\n");
-			goto calculate_hash_end;
-		}
+typedef struct {
+	RzHashContext *ctx;
+	const char *filename; ///< file hashed in block mode, NULL in multi-file mode
+	ut64 filesize; ///< size of filename in block mode
+	RzHashJob *slots;
+	ut64 n_slots;
+	ut64 n_jobs;
+	ut64 next; ///< next job to be picked by a worker
+	ut64 printed; ///< next job to be printed by the main thread
+	bool stop;
+	RzThreadLock *lock;
+	RzThreadCond *cond;
+} RzHashScheduler;
 
-		if (!rz_msg_digest_init(md)) {
-			goto calculate_hash_end;
+typedef struct {
+	RzHashScheduler *sched;
+	RzIO *io;
+	RzIODesc *desc;
+	ut8 *block;
+} RzHashWorker;
+
+static bool rz_hash_worker_run_job(RzHashWorker *worker, ut64 index, RzHashJob *job) {
+	RzHashScheduler *sched = worker->sched;
+	RzHashContext *ctx = sched->ctx;
+
+	if (!sched->filename) {
+		// multi-file mode: each job hashes a whole file
+		const char *filename = ctx->files[index];
+		RzIODesc *desc = rz_io_open_nomap(worker->io, filename, RZ_PERM_R, 0);
+		if (!desc) {
+			RZ_LOG_ERROR("rz-hash: error, cannot open file '%s'\n", filename);
+			return false;
+		}
+		job->filesize = rz_io_desc_size(desc);
+		if (!rz_hash_check_file_range(ctx, job->filesize)) {
+			rz_io_desc_close(desc);
+			return false;
 		}
+		job->from = ctx->offset.from;
+		job->to = ctx->offset.to ? ctx->offset.to : job->filesize;
+		bool res = rz_hash_digest_range(ctx, worker->io, job->md, worker->block, job->from, job->to, true);
+		rz_io_desc_close(desc);
+		return res;
+	}
 
-		if (ctx->as_prefix && ctx->seed.buf &&
-			!rz_msg_digest_update(md, ctx->seed.buf, ctx->seed.len)) {
-			goto calculate_hash_end;
+	// block mode: the file is opened once per worker
+	if (!worker->desc) {
+		worker->desc = rz_io_open_nomap(worker->io, sched->filename, RZ_PERM_R, 0);
+		if (!worker->desc) {
+			RZ_LOG_ERROR("rz-hash: error, cannot open file '%s'\n", sched->filename);
+			return false;
 		}
+	}
+	ut64 end = ctx->offset.to ? ctx->offset.to : sched->filesize;
+	job->filesize = sched->filesize;
+	job->from = ctx->offset.from + index * ctx->block_size;
+	job->to = RZ_MIN(job->from + ctx->block_size, end);
+	return rz_hash_digest_range(ctx, worker->io, job->md, worker->block, job->from, job->to, false);
+}
 
-		for (ut64 j = ctx->offset.from; j < to; j += bsize) {
-			int read = rz_io_pread_at(io, j, block, to - j > bsize ? bsize : (to - j));
-			if (!rz_msg_digest_update(md, block, read)) {
-				goto calculate_hash_end;
-			}
+static RzThreadFunctionRet rz_hash_worker_thread(RzThread *th) {
+	RzHashWorker *worker = th->user;
+	RzHashScheduler *sched = worker->sched;
+
+	while (true) {
+		rz_th_lock_enter(sched->lock);
+		while (!sched->stop && sched->next < sched->n_jobs &&
+			sched->next >= sched->printed + sched->n_slots) {
+			// all the slots are full; wait for the main thread to print them
+			rz_th_cond_wait(sched->cond, sched->lock);
+		}
+		if (sched->stop || sched->next >= sched->n_jobs) {
+			rz_th_lock_leave(sched->lock);
+			break;
 		}
+		ut64 index = sched->next++;
+		rz_th_lock_leave(sched->lock);
 
-		if (!ctx->as_prefix && ctx->seed.buf &&
-			!rz_msg_digest_update(md, ctx->seed.buf, ctx->seed.len)) {
-			goto calculate_hash_end;
+		RzHashJob *job = &sched->slots[index % sched->n_slots];
+		bool success = rz_hash_worker_run_job(worker, index, job);
+
+		rz_th_lock_enter(sched->lock);
+		job->success = success;
+		job->done = true;
+		rz_th_cond_signal_all(sched->cond);
+		rz_th_lock_leave(sched->lock);
+	}
+	return RZ_TH_STOP;
+}
+
+static void rz_hash_worker_free(RzHashWorker *worker) {
+	if (!worker) {
+		return;
+	}
+	rz_io_desc_close(worker->desc);
+	rz_io_free(worker->io);
+	free(worker->block);
+	free(worker);
+}
+
+/**
+ * Runs all the jobs of the scheduler on a thread pool and prints the results
+ * in the same order of the serial implementation.
+ */
+static bool rz_hash_scheduler_run(RzHashScheduler *sched, RzList *algorithms, const ut8 *cmphash, size_t cmphashlen) {
+	RzHashContext *ctx = sched->ctx;
+	bool result = false;
+	RzThreadPool *pool = rz_th_pool_new(ctx->threads);
+	if (!pool) {
+		RZ_LOG_ERROR("rz-hash: error, cannot allocate thread pool\n");
+		return false;
+	}
+
+	sched->next = 0;
+	sched->printed = 0;
+	sched->stop = false;
+	for (ut64 i = 0; i < sched->n_slots; ++i) {
+		sched->slots[i].done = false;
+	}
+
+	RZ_LOG_VERBOSE("rz-hash: using %u threads\n", (ut32)pool->size);
+	for (size_t i = 0; i < pool->size; ++i) {
+		RzHashWorker *worker = RZ_NEW0(RzHashWorker);
+		if (!worker || !(worker->io = rz_io_new()) || !(worker->block = malloc(ctx->block_size))) {
+			RZ_LOG_ERROR("rz-hash: error, cannot allocate worker memory\n");
+			rz_hash_worker_free(worker);
+			break;
 		}
-		if (!rz_msg_digest_final(md) ||
-			!rz_msg_digest_iterate(md, ctx->iterate)) {
-			goto calculate_hash_end;
+		worker->sched = sched;
+		RzThread *th = rz_th_new(rz_hash_worker_thread, worker, 0);
+		if (!th) {
+			RZ_LOG_ERROR("rz-hash: error, cannot allocate worker thread\n");
+			rz_hash_worker_free(worker);
+			break;
 		}
+		rz_th_pool_add_thread(pool, th);
+	}
 
-		rz_list_foreach (algorithms, it, algorithm) {
-			digest = rz_msg_digest_get_result(md, algorithm, &digest_size);
-			if (digest_size != cmphashlen) {
-				result = false;
-			} else {
-				result = !memcmp(cmphash, digest, digest_size);
-			}
+	if (!pool->threads[0]) {
+		goto rz_hash_scheduler_run_end;
+	}
 
+	for (ut64 i = 0; i < sched->n_jobs; ++i) {
+		RzHashJob *job = &sched->slots[i % sched->n_slots];
+		rz_th_lock_enter(sched->lock);
+		while (!job->done) {
+			rz_th_cond_wait(sched->cond, sched->lock);
+		}
+		rz_th_lock_leave(sched->lock);
+		if (!job->success) {
+			goto rz_hash_scheduler_run_end;
+		}
+
+		const char *filename = sched->filename ? sched->filename : ctx->files[i];
+		if (sched->filename) {
+			rz_hash_print_results(ctx, job->md, algorithms, NULL, 0, job->from, job->from + ctx->block_size, job->filesize, filename);
+		} else {
 			if (ctx->mode == RZ_HASH_MODE_JSON) {
-				pj_o(ctx->pj);
+				pj_ka(ctx->pj, filename);
 			}
-			rz_hash_context_compare_hashes(ctx, filesize, result, algorithm, filename);
+			rz_hash_print_results(ctx, job->md, algorithms, cmphash, cmphashlen, job->from, job->to, job->filesize, filename);
 			if (ctx->mode == RZ_HASH_MODE_JSON) {
 				pj_end(ctx->pj);
 			}
 		}
-	} else if (ctx->show_blocks) {
-		ut64 to = ctx->offset.to ? ctx->offset.to : filesize;
-		for (ut64 j = ctx->offset.from; j < to; j += bsize) {
-			int read = rz_io_pread_at(io, j, block, to - j > bsize ? bsize : (to - j));
-			if (!rz_msg_digest_init(md) ||
-				!rz_msg_digest_update(md, block, read) ||
-				!rz_msg_digest_final(md) ||
-				!rz_msg_digest_iterate(md, ctx->iterate)) {
-				goto calculate_hash_end;
-			}
 
-			rz_list_foreach (algorithms, it, algorithm) {
-				digest = rz_msg_digest_get_result(md, algorithm, &digest_size);
-				if (ctx->mode == RZ_HASH_MODE_JSON) {
-					pj_o(ctx->pj);
-				}
-				rz_hash_print_digest(ctx, md, algorithm, j, j + bsize, filename);
-				if (ctx->mode == RZ_HASH_MODE_JSON) {
-					pj_end(ctx->pj);
-				}
-			}
-		}
-	} else {
-		ut64 to = ctx->offset.to ? ctx->offset.to : filesize;
-		if (!rz_msg_digest_init(md)) {
-			goto calculate_hash_end;
-		}
+		rz_th_lock_enter(sched->lock);
+		job->done = false;
+		sched->printed++;
+		rz_th_cond_signal_all(sched->cond);
+		rz_th_lock_leave(sched->lock);
+	}
+	result = true;
 
-		if (ctx->as_prefix && ctx->seed.buf &&
-			!rz_msg_digest_update(md, ctx->seed.buf, ctx->seed.len)) {
-			goto calculate_hash_end;
+rz_hash_scheduler_run_end:
+	rz_th_lock_enter(sched->lock);
+	sched->stop = true;
+	rz_th_cond_signal_all(sched->cond);
+	rz_th_lock_leave(sched->lock);
+	rz_th_pool_wait(pool);
+	for (size_t i = 0; i < pool->size; ++i) {
+		if (pool->threads[i]) {
+			rz_hash_worker_free(pool->threads[i]->user);
 		}
+	}
+	rz_th_pool_free(pool);
+	return result;
+}
 
-		for (ut64 j = ctx->offset.from; j < to; j += bsize) {
-			int read = rz_io_pread_at(io, j, block, to - j > bsize ? bsize : (to - j));
-			if (!rz_msg_digest_update(md, block, read)) {
-				goto calculate_hash_end;
-			}
-		}
+/**
+ * Multi-threaded version of calculate_hash; files (or blocks when -B is set)
+ * are hashed concurrently, each worker owns its RzIO instance and reads the
+ * data in chunks of ctx->block_size bytes, thus memory stays bounded by the
+ * number of slots regardless of the file size.
+ */
+static bool rz_hash_context_run_parallel(RzHashContext *ctx) {
+	bool result = false;
+	RzList *algorithms = NULL;
+	ut8 *cmphash = NULL;
+	size_t cmphashlen = 0;
+	RzHashScheduler sched = { 0 };
 
-		if (!ctx->as_prefix && ctx->seed.buf &&
-			!rz_msg_digest_update(md, ctx->seed.buf, ctx->seed.len)) {
-			goto calculate_hash_end;
+	algorithms = parse_hash_algorithms(ctx);
+	if (!algorithms || rz_list_length(algorithms) < 1) {
+		RZ_LOG_ERROR("rz-hash: error, empty list of hash algorithms\n");
+		goto rz_hash_context_run_parallel_end;
+	}
+
+	if (ctx->compare && !rz_hash_parse_hexadecimal("-c", ctx->compare, &cmphash, &cmphashlen)) {
+		goto rz_hash_context_run_parallel_end;
+	}
+
+	size_t n_threads = ctx->threads ? ctx->threads : rz_th_physical_core_number();
+	sched.ctx = ctx;
+	sched.n_slots = n_threads * RZ_HASH_SLOTS_PER_THREAD;
+	sched.slots = RZ_NEWS0(RzHashJob, sched.n_slots);
+	sched.lock = rz_th_lock_new(false);
+	sched.cond = rz_th_cond_new();
+	if (!sched.slots || !sched.lock || !sched.cond) {
+		RZ_LOG_ERROR("rz-hash: error, cannot allocate scheduler memory\n");
+		goto rz_hash_context_run_parallel_end;
+	}
+	for (ut64 i = 0; i < sched.n_slots; ++i) {
+		sched.slots[i].md = rz_hash_msg_digest_new(ctx, algorithms);
+		if (!sched.slots[i].md) {
+			goto rz_hash_context_run_parallel_end;
 		}
+	}
 
-		if (!rz_msg_digest_final(md) ||
-			!rz_msg_digest_iterate(md, ctx->iterate)) {
-			goto calculate_hash_end;
+	if (ctx->mode == RZ_HASH_MODE_JSON) {
+		ctx->pj = pj_new();
+		if (!ctx->pj) {
+			RZ_LOG_ERROR("rz-hash: error, failed to allocate JSON memory.\n");
+			goto rz_hash_context_run_parallel_end;
 		}
+		pj_o(ctx->pj);
+	}
 
-		rz_list_foreach (algorithms, it, algorithm) {
-			digest = rz_msg_digest_get_result(md, algorithm, &digest_size);
+	if (!ctx->show_blocks) {
+		sched.n_jobs = ctx->nfiles;
+		if (!rz_hash_scheduler_run(&sched, algorithms, cmphash, cmphashlen)) {
+			goto rz_hash_context_run_parallel_end;
+		}
+	} else {
+		for (ut32 i = 0; i < ctx->nfiles; ++i) {
+			RzIO *io = rz_io_new();
+			RzIODesc *desc = io ? rz_io_open_nomap(io, ctx->files[i], RZ_PERM_R, 0) : NULL;
+			if (!desc) {
+				RZ_LOG_ERROR("rz-hash: error, cannot open file '%s'\n", ctx->files[i]);
+				rz_io_free(io);
+				goto rz_hash_context_run_parallel_end;
+			}
+			sched.filename = ctx->files[i];
+			sched.filesize = rz_io_desc_size(desc);
+			rz_io_free(io);
+			if (!rz_hash_check_file_range(ctx, sched.filesize)) {
+				goto rz_hash_context_run_parallel_end;
+			}
+			ut64 to = ctx->offset.to ? ctx->offset.to : sched.filesize;
+			sched.n_jobs = to > ctx->offset.from ? (to - ctx->offset.from + ctx->block_size - 1) / ctx->block_size : 0;
 
 			if (ctx->mode == RZ_HASH_MODE_JSON) {
-				pj_o(ctx->pj);
+				pj_ka(ctx->pj, sched.filename);
+			}
+			if (!rz_hash_scheduler_run(&sched, algorithms, NULL, 0)) {
+				goto rz_hash_context_run_parallel_end;
 			}
-			rz_hash_print_digest(ctx, md, algorithm, ctx->offset.from, to, filename);
 			if (ctx->mode == RZ_HASH_MODE_JSON) {
 				pj_end(ctx->pj);
 			}
 		}
 	}
+
+	if (ctx->mode == RZ_HASH_MODE_JSON) {
+		pj_end(ctx->pj);
+		printf("%s\n", pj_string(ctx->pj));
+	}
 	result = true;
 
-calculate_hash_end:
+rz_hash_context_run_parallel_end:
+	if (sched.slots) {
+		for (ut64 i = 0; i < sched.n_slots; ++i) {
+			if (sched.slots[i].md) {
+				rz_msg_digest_free(sched.slots[i].md);
+			}
+		}
+		free(sched.slots);
+	}
+	rz_th_cond_free(sched.cond);
+	rz_th_lock_free(sched.lock);
 	rz_list_free(algorithms);
-	free(block);
 	free(cmphash);
-	rz_msg_digest_free(md);
 	return result;
 }
 
@@ -1184,7 +1482,11 @@ RZ_API int rz_main_rz_hash(int argc, const char **argv) {
 		}
 		break;
 	case RZ_HASH_OP_HASH:
-		if (!rz_hash_context_run(&ctx, calculate_hash)) {
+		if (ctx.threads != 1 && ctx.nfiles > 0) {
+			if (!rz_hash_context_run_parallel(&ctx)) {
+				goto rz_main_rz_hash_end;
+			}
+		} else if (!rz_hash_context_run(&ctx, calculate_hash)) {
 			goto rz_main_rz_hash_end;
 		}
 		break;
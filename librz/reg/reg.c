@@ -133,6 +133,7 @@ RZ_API bool rz_reg_set_name(RzReg *reg, int role, const char *name) {
 	rz_return_val_if_fail(reg && name, false);
 	if (role >= 0 && role < RZ_REG_NAME_LAST) {
 		reg->name[role] = rz_str_dup(reg->name[role], name);
+		reg->role_items[role] = NULL;
 		return true;
 	}
 	return false;
@@ -186,7 +187,10 @@ RZ_API void rz_reg_free_internal(RzReg *reg, bool init) {
 		if (reg->name[i]) {
 			RZ_FREE(reg->name[i]);
 		}
+		reg->role_items[i] = NULL;
 	}
+	RZ_FREE(reg->items);
+	reg->items_count = 0;
 	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
 		ht_pp_free(reg->regset[i].ht_regs);
 		reg->regset[i].ht_regs = NULL;
@@ -232,29 +236,75 @@ RZ_API void rz_reg_reindex(RzReg *reg) {
 		}
 	}
 	rz_list_sort(all, (RzListComparator)regcmp);
+	free(reg->items);
+	reg->items = RZ_NEWS(RzRegItem *, rz_list_length(all));
 	index = 0;
 	rz_list_foreach (all, iter, r) {
+		if (reg->items) {
+			reg->items[index] = r;
+		}
 		r->index = index++;
 	}
+	reg->items_count = reg->items ? index : 0;
 	rz_list_free(reg->allregs);
 	reg->allregs = all;
 }
 
+/**
+ * \brief Returns the register item with the given index in O(1)
+ *
+ * The index of a register is assigned by rz_reg_reindex() and stays valid
+ * until the register profile changes.
+ */
 RZ_API RzRegItem *rz_reg_index_get(RzReg *reg, int idx) {
-	RzRegItem *r;
-	RzListIter *iter;
+	rz_return_val_if_fail(reg, NULL);
 	if (idx < 0) {
 		return NULL;
 	}
-	if (!reg->allregs) {
+	if (!reg->items) {
 		rz_reg_reindex(reg);
 	}
-	rz_list_foreach (reg->allregs, iter, r) {
-		if (r->index == idx) {
-			return r;
-		}
+	return idx < reg->items_count ? reg->items[idx] : NULL;
+}
+
+/**
+ * \brief Resolves a register name (or alias like PC, SP, ...) to its index
+ *
+ * This is meant to be called once, i.e. when an emulator or a debugger
+ * backend is set up, and then use the returned index with rz_reg_index_get,
+ * rz_reg_index_get_value and rz_reg_index_set_value, which do not perform
+ * any lookup by name.
+ *
+ * \return the index of the register or -1 when not found
+ */
+RZ_API int rz_reg_index_of(RzReg *reg, const char *name) {
+	rz_return_val_if_fail(reg && name, -1);
+	RzRegItem *item = rz_reg_get(reg, name, -1);
+	if (!item) {
+		return -1;
 	}
-	return NULL;
+	if (!reg->items) {
+		rz_reg_reindex(reg);
+	}
+	return item->index < reg->items_count && reg->items[item->index] == item ? item->index : -1;
+}
+
+/**
+ * \brief Reads the value of the register with the given index
+ */
+RZ_API ut64 rz_reg_index_get_value(RzReg *reg, int idx) {
+	rz_return_val_if_fail(reg, 0);
+	RzRegItem *item = rz_reg_index_get(reg, idx);
+	return item ? rz_reg_get_value(reg, item) : 0;
+}
+
+/**
+ * \brief Writes the value of the register with the given index
+ */
+RZ_API bool rz_reg_index_set_value(RzReg *reg, int idx, ut64 value) {
+	rz_return_val_if_fail(reg, false);
+	RzRegItem *item = rz_reg_index_get(reg, idx);
+	return item ? rz_reg_set_value(reg, item, value) : false;
 }
 
 RZ_API void rz_reg_free(RzReg *reg) {
@@ -316,38 +366,51 @@ RZ_API ut64 rz_reg_getv(RzReg *reg, const char *name) {
 	return ri ? rz_reg_get_value(reg, ri) : UT64_MAX;
 }
 
+static RzRegItem *reg_get_by_name(RzReg *reg, const char *name, int from, int to) {
+	for (int i = from; i < to; i++) {
+		HtPP *pp = reg->regset[i].ht_regs;
+		if (pp) {
+			bool found = false;
+			RzRegItem *item = ht_pp_find(pp, name, &found);
+			if (found) {
+				return item;
+			}
+		}
+	}
+	return NULL;
+}
+
 RZ_API RzRegItem *rz_reg_get(RzReg *reg, const char *name, int type) {
-	int i, e;
 	rz_return_val_if_fail(reg && name, NULL);
 	// TODO: define flag register as RZ_REG_TYPE_FLG
 	if (type == RZ_REG_TYPE_FLG) {
 		type = RZ_REG_TYPE_GPR;
 	}
 	if (type == -1) {
-		i = 0;
-		e = RZ_REG_TYPE_LAST;
 		int alias = rz_reg_get_name_idx(name);
-		if (alias != -1) {
-			const char *nname = rz_reg_get_name(reg, alias);
-			if (nname) {
-				name = nname;
-			}
+		if (alias != -1 && reg->name[alias]) {
+			return rz_reg_get_by_role(reg, alias);
 		}
-	} else {
-		i = type;
-		e = type + 1;
+		return reg_get_by_name(reg, name, 0, RZ_REG_TYPE_LAST);
 	}
-	for (; i < e; i++) {
-		HtPP *pp = reg->regset[i].ht_regs;
-		if (pp) {
-			bool found = false;
-			RzRegItem *item = ht_pp_find(pp, name, &found);
-			if (found) {
-				return item;
-			}
-		}
+	return reg_get_by_name(reg, name, type, type + 1);
+}
+
+/**
+ * \brief Returns the register item bound to the given role (PC, SP, ...)
+ *
+ * The item is resolved on the first call and then cached until the alias
+ * or the register profile changes.
+ */
+RZ_API RzRegItem *rz_reg_get_by_role(RzReg *reg, RzRegisterId role) {
+	rz_return_val_if_fail(reg, NULL);
+	if (role < 0 || role >= RZ_REG_NAME_LAST || !reg->name[role]) {
+		return NULL;
 	}
-	return NULL;
+	if (!reg->role_items[role]) {
+		reg->role_items[role] = reg_get_by_name(reg, reg->name[role], 0, RZ_REG_TYPE_LAST);
+	}
+	return reg->role_items[role];
 }
 
 RZ_API const RzList *rz_reg_get_list(RzReg *reg, int type) {
@@ -135,8 +135,7 @@ RZ_API ut64 rz_reg_get_value(RzReg *reg, RzRegItem *item) {
 }
 
 RZ_API ut64 rz_reg_get_value_by_role(RzReg *reg, RzRegisterId role) {
-	// TODO use mapping from RzRegisterId to RzRegItem (via RzRegSet)
-	return rz_reg_get_value(reg, rz_reg_get(reg, rz_reg_get_name(reg, role), -1));
+	return rz_reg_get_value(reg, rz_reg_get_by_role(reg, role));
 }
 
 RZ_API bool rz_reg_set_value(RzReg *reg, RzRegItem *item, ut64 value) {
@@ -221,12 +220,10 @@ RZ_API bool rz_reg_set_value(RzReg *reg, RzRegItem *item, ut64 value) {
 }
 
 RZ_API bool rz_reg_set_value_by_role(RzReg *reg, RzRegisterId role, ut64 val) {
-	// TODO use mapping from RzRegisterId to RzRegItem (via RzRegSet)
-	const char *name = rz_reg_get_name(reg, role);
-	if (!name) {
+	RzRegItem *r = rz_reg_get_by_role(reg, role);
+	if (!r) {
 		return false;
 	}
-	RzRegItem *r = rz_reg_get(reg, name, -1);
 	return rz_reg_set_value(reg, r, val);
 }
 
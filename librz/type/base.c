@@ -5,6 +5,8 @@
 #include <rz_type.h>
 #include <string.h>
 
+#include "type_internal.h"
+
 RZ_API void rz_type_base_enum_case_free(void *e, void *user) {
 	(void)user;
 	RzTypeEnumCase *cas = e;
@@ -37,6 +39,9 @@ RZ_API RZ_BORROW RzBaseType *rz_type_db_get_base_type(const RzTypeDB *typedb, RZ
 	bool found = false;
 	RzBaseType *btype = ht_pp_find(typedb->types, name, &found);
 	if (!found || !btype) {
+		btype = rz_type_db_lazy_base_type(typedb, name);
+	}
+	if (!btype) {
 		eprintf("Cannot find base type \"%s\"\n", name);
 		return NULL;
 	}
@@ -51,6 +56,8 @@ RZ_API RZ_BORROW RzBaseType *rz_type_db_get_base_type(const RzTypeDB *typedb, RZ
  */
 RZ_API bool rz_type_db_delete_base_type(RzTypeDB *typedb, RZ_NONNULL RzBaseType *type) {
 	rz_return_val_if_fail(typedb && type && type->name, false);
+	rz_type_db_index_remove(typedb, type);
+	rz_type_db_lazy_drop_type(typedb, type->name);
 	ht_pp_delete(typedb->types, type->name);
 	return true;
 }
@@ -77,6 +84,7 @@ static bool base_type_kind_collect_cb(void *user, const void *k, const void *v)
  */
 RZ_API RZ_OWN RzList /* RzBaseType */ *rz_type_db_get_base_types_of_kind(const RzTypeDB *typedb, RzBaseTypeKind kind) {
 	rz_return_val_if_fail(typedb, NULL);
+	rz_type_db_lazy_load_types(typedb);
 	RzList *types = rz_list_new();
 	struct list_kind lk = { types, kind };
 	ht_pp_foreach(typedb->types, base_type_kind_collect_cb, &lk);
@@ -97,6 +105,7 @@ static bool base_type_collect_cb(void *user, const void *k, const void *v) {
  */
 RZ_API RZ_OWN RzList /* RzBaseType */ *rz_type_db_get_base_types(const RzTypeDB *typedb) {
 	rz_return_val_if_fail(typedb, NULL);
+	rz_type_db_lazy_load_types(typedb);
 	RzList *types = rz_list_new();
 	ht_pp_foreach(typedb->types, base_type_collect_cb, types);
 	return types;
@@ -168,7 +177,11 @@ RZ_API RZ_OWN RzBaseType *rz_type_base_type_new(RzBaseTypeKind kind) {
  */
 RZ_API void rz_type_db_save_base_type(const RzTypeDB *typedb, const RzBaseType *type) {
 	rz_return_if_fail(typedb && type && type->name);
-	ht_pp_insert(typedb->types, type->name, (void *)type);
+	// A type with the same name in the libraries takes precedence
+	rz_type_db_lazy_base_type(typedb, type->name);
+	if (ht_pp_insert(typedb->types, type->name, (void *)type)) {
+		rz_type_db_index_add(typedb, (RzBaseType *)type);
+	}
 }
 
 /**
@@ -7,6 +7,8 @@
 #include <rz_reg.h>
 #include <rz_type.h>
 
+#include "type_internal.h"
+
 #define NOPTR           0
 #define PTRSEEK         1
 #define PTRBACK         2
@@ -1900,6 +1902,10 @@ RZ_API const char *rz_type_db_format_get(const RzTypeDB *typedb, const char *nam
 	rz_return_val_if_fail(typedb && name, NULL);
 	bool found = false;
 	const char *result = ht_pp_find(typedb->formats, name, &found);
+	if (!found && rz_type_db_lazy_base_type(typedb, name)) {
+		// The format comes along with the type
+		result = ht_pp_find(typedb->formats, name, &found);
+	}
 	if (!found || !result) {
 		// eprintf("Cannot find format \"%s\"\n", name);
 		return NULL;
@@ -1909,6 +1915,7 @@ RZ_API const char *rz_type_db_format_get(const RzTypeDB *typedb, const char *nam
 
 RZ_API void rz_type_db_format_set(RzTypeDB *typedb, const char *name, const char *fmt) {
 	rz_return_if_fail(typedb && name && fmt);
+	rz_type_db_lazy_base_type(typedb, name);
 	ht_pp_insert(typedb->formats, name, strdup(fmt));
 }
 
@@ -1922,6 +1929,7 @@ static bool format_collect_cb(void *user, const void *k, const void *v) {
 
 RZ_API RZ_OWN RzList *rz_type_db_format_all(RzTypeDB *typedb) {
 	rz_return_val_if_fail(typedb, NULL);
+	rz_type_db_lazy_load_types(typedb);
 	RzList *formats = rz_list_newf(free);
 	ht_pp_foreach(typedb->formats, format_collect_cb, formats);
 	return formats;
@@ -1929,6 +1937,7 @@ RZ_API RZ_OWN RzList *rz_type_db_format_all(RzTypeDB *typedb) {
 
 RZ_API void rz_type_db_format_delete(RzTypeDB *typedb, const char *name) {
 	rz_return_if_fail(typedb && name);
+	rz_type_db_lazy_base_type(typedb, name);
 	ht_pp_delete(typedb->formats, name);
 }
 
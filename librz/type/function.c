@@ -8,6 +8,8 @@
 #include <rz_type.h>
 #include <string.h>
 
+#include "type_internal.h"
+
 /**
  * \brief Creates a new RzCallable type
  *
@@ -164,6 +166,9 @@ RZ_API RZ_BORROW RzCallable *rz_type_func_get(RzTypeDB *typedb, RZ_NONNULL const
 	bool found = false;
 	RzCallable *callable = ht_pp_find(typedb->callables, name, &found);
 	if (!found || !callable) {
+		callable = rz_type_db_lazy_callable(typedb, name);
+	}
+	if (!callable) {
 		RZ_LOG_DEBUG("Cannot find function type \"%s\"\n", name);
 		return NULL;
 	}
@@ -178,6 +183,7 @@ RZ_API RZ_BORROW RzCallable *rz_type_func_get(RzTypeDB *typedb, RZ_NONNULL const
  */
 RZ_API bool rz_type_func_delete(RzTypeDB *typedb, RZ_NONNULL const char *name) {
 	rz_return_val_if_fail(typedb && name, false);
+	rz_type_db_lazy_drop_callable(typedb, name);
 	ht_pp_delete(typedb->callables, name);
 	return true;
 }
@@ -190,6 +196,7 @@ static void callables_ht_free(HtPPKv *kv) {
  * \brief Removes all RzCallable types
  */
 RZ_API void rz_type_func_delete_all(RzTypeDB *typedb) {
+	rz_type_db_lazy_drop_callables(typedb);
 	ht_pp_free(typedb->callables);
 	typedb->callables = ht_pp_new(NULL, callables_ht_free, NULL);
 }
@@ -203,7 +210,7 @@ RZ_API void rz_type_func_delete_all(RzTypeDB *typedb) {
 RZ_API bool rz_type_func_exist(RzTypeDB *typedb, RZ_NONNULL const char *name) {
 	rz_return_val_if_fail(typedb && name, false);
 	bool found = false;
-	return ht_pp_find(typedb->callables, name, &found) && found;
+	return (ht_pp_find(typedb->callables, name, &found) && found) || rz_type_db_lazy_callable(typedb, name);
 }
 
 /**
@@ -568,6 +575,7 @@ RZ_API RZ_OWN RzList *rz_type_function_names(RzTypeDB *typedb) {
 	rz_return_val_if_fail(typedb, NULL);
 	RzList *result = rz_list_newf(free);
 	ht_pp_foreach(typedb->callables, function_names_collect_cb, result);
+	rz_type_db_lazy_callable_names(typedb, result, false);
 	return result;
 }
 
@@ -589,5 +597,6 @@ RZ_API RZ_OWN RzList *rz_type_noreturn_function_names(RzTypeDB *typedb) {
 	rz_return_val_if_fail(typedb, NULL);
 	RzList *noretl = rz_list_newf(free);
 	ht_pp_foreach(typedb->callables, noreturn_function_names_collect_cb, noretl);
+	rz_type_db_lazy_callable_names(typedb, noretl, true);
 	return noretl;
 }
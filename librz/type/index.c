@@ -0,0 +1,442 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include <rz_type.h>
+#include "type_internal.h"
+
+/*
+ * Reverse indexes of the types database, used to answer "which enums have
+ * a case with this value" and "which structures/unions have a member at
+ * this offset" without walking every type on each query.
+ *
+ * Both indexes are built lazily on the first query and then kept up to date
+ * type by type: saving, loading or deleting a base type through the RzTypeDB
+ * API only updates the entries of that type and of the structures/unions
+ * whose member offsets depend on its name, when the next query comes. Bulk
+ * changes, like parsing C code (which can complete forward definitions in
+ * place), loading a whole library or changing the bits, increment
+ * typedb->generation instead and the indexes are rebuilt by the next query.
+ *
+ * The results are returned in the order the types were indexed. The indexes
+ * cover only the types already loaded: each query first loads from the
+ * pending type libraries the types which can match it.
+ */
+
+#define TYPE_INDEX_MAX_DEPTH 64
+
+struct rz_type_db_index_t {
+	HtUP /*<ut64, RzPVector<RzBaseType *>>*/ *enums_by_val; ///< case value -> enums
+	HtUP /*<ut64, RzPVector<RzBaseType *>>*/ *compounds_by_offset; ///< member offset -> structs and unions
+	HtUP /*<RzBaseType *, TypeIndexEntry *>*/ *entries; ///< indexed type -> its entries
+	HtPP /*<char *, RzPVector<RzBaseType *>>*/ *dependents; ///< type name -> compounds whose entries depend on it
+	HtUP /*<RzBaseType *, NULL>*/ *pending; ///< types to index again on the next query
+	ut64 generation; ///< generation of the types database the index was built for
+};
+
+typedef struct {
+	HtUP *ht; ///< enums_by_val or compounds_by_offset
+	RzVector /*<ut64>*/ keys; ///< keys of ht listing the type
+	RzPVector /*<char *>*/ deps; ///< names of the types the keys depend on
+} TypeIndexEntry;
+
+typedef struct {
+	const RzTypeDB *typedb;
+	RzTypeDBIndex *index;
+	RzBaseType *btype; ///< type being indexed
+	TypeIndexEntry *entry;
+} TypeIndexCtx;
+
+static void index_pvector_free(HtUPKv *kv) {
+	rz_pvector_free(kv->value);
+}
+
+static void index_dependents_free(HtPPKv *kv) {
+	free(kv->key);
+	rz_pvector_free(kv->value);
+}
+
+static void index_entry_free(HtUPKv *kv) {
+	TypeIndexEntry *entry = kv->value;
+	rz_vector_fini(&entry->keys);
+	rz_pvector_fini(&entry->deps);
+	free(entry);
+}
+
+/**
+ * Frees the reverse indexes of the types database
+ */
+RZ_IPI void rz_type_db_index_free(RZ_NULLABLE RzTypeDBIndex *index) {
+	if (!index) {
+		return;
+	}
+	ht_up_free(index->enums_by_val);
+	ht_up_free(index->compounds_by_offset);
+	ht_up_free(index->entries);
+	ht_pp_free(index->dependents);
+	ht_up_free(index->pending);
+	free(index);
+}
+
+static RzTypeDBIndex *index_new(const RzTypeDB *typedb) {
+	RzTypeDBIndex *index = RZ_NEW0(RzTypeDBIndex);
+	if (!index) {
+		return NULL;
+	}
+	index->enums_by_val = ht_up_new(NULL, index_pvector_free, NULL);
+	index->compounds_by_offset = ht_up_new(NULL, index_pvector_free, NULL);
+	index->entries = ht_up_new(NULL, index_entry_free, NULL);
+	index->dependents = ht_pp_new(NULL, index_dependents_free, NULL);
+	index->pending = ht_up_new0();
+	if (!index->enums_by_val || !index->compounds_by_offset || !index->entries || !index->dependents || !index->pending) {
+		rz_type_db_index_free(index);
+		return NULL;
+	}
+	index->generation = typedb->generation;
+	return index;
+}
+
+/**
+ * Appends the type being indexed to the list of the key, at most once.
+ */
+static void index_add(TypeIndexCtx *ctx, ut64 key) {
+	HtUP *ht = ctx->entry->ht;
+	RzPVector *vec = ht_up_find(ht, key, NULL);
+	if (!vec) {
+		vec = rz_pvector_new(NULL);
+		if (!vec) {
+			return;
+		}
+		ht_up_insert(ht, key, vec);
+	} else if (rz_pvector_len(vec) && rz_pvector_tail(vec) == ctx->btype) {
+		return;
+	}
+	if (rz_pvector_push(vec, ctx->btype)) {
+		rz_vector_push(&ctx->entry->keys, &key);
+	}
+}
+
+/**
+ * Records that the entries of the type being indexed depend on \p name,
+ * returns false if it was already recorded.
+ */
+static bool index_dep(TypeIndexCtx *ctx, const char *name) {
+	void **it;
+	rz_pvector_foreach (&ctx->entry->deps, it) {
+		if (!strcmp(*it, name)) {
+			return false;
+		}
+	}
+	char *dup = strdup(name);
+	if (!dup || !rz_pvector_push(&ctx->entry->deps, dup)) {
+		free(dup);
+		return false;
+	}
+	RzPVector *vec = ht_pp_find(ctx->index->dependents, name, NULL);
+	if (!vec) {
+		vec = rz_pvector_new(NULL);
+		if (!vec) {
+			return true;
+		}
+		ht_pp_insert(ctx->index->dependents, name, vec);
+	}
+	rz_pvector_push(vec, ctx->btype);
+	return true;
+}
+
+static RzBaseType *index_base_type(const RzTypeDB *typedb, RzType *type) {
+	if (type->kind != RZ_TYPE_KIND_IDENTIFIER || !type->identifier.name) {
+		return NULL;
+	}
+	// avoid rz_type_db_get_base_type() which complains about missing types
+	return ht_pp_find(typedb->types, type->identifier.name, NULL);
+}
+
+/**
+ * Records the names of the types \p type is made of, which determine its
+ * size and so the offsets of the members following it.
+ */
+static void index_type_deps(TypeIndexCtx *ctx, RzType *type, int depth) {
+	if (depth > TYPE_INDEX_MAX_DEPTH) {
+		return;
+	}
+	if (type->kind == RZ_TYPE_KIND_ARRAY) {
+		index_type_deps(ctx, type->array.type, depth + 1);
+		return;
+	}
+	if (type->kind != RZ_TYPE_KIND_IDENTIFIER || !type->identifier.name || !index_dep(ctx, type->identifier.name)) {
+		return;
+	}
+	RzBaseType *btype = index_base_type(ctx->typedb, type);
+	if (!btype) {
+		return;
+	}
+	if (btype->kind == RZ_BASE_TYPE_KIND_TYPEDEF && btype->type) {
+		index_type_deps(ctx, btype->type, depth + 1);
+	} else if (btype->kind == RZ_BASE_TYPE_KIND_STRUCT) {
+		RzTypeStructMember *memb;
+		rz_vector_foreach(&btype->struct_data.members, memb) {
+			index_type_deps(ctx, memb->type, depth + 1);
+		}
+	} else if (btype->kind == RZ_BASE_TYPE_KIND_UNION) {
+		RzTypeUnionMember *memb;
+		rz_vector_foreach(&btype->union_data.members, memb) {
+			index_type_deps(ctx, memb->type, depth + 1);
+		}
+	}
+}
+
+/**
+ * Collects the offsets matched by rz_type_path_by_offset() for the members
+ * nested into \p type, which are reached when the searched offset is
+ * \p base less than the offset compared in the nested member walker.
+ */
+static void index_nested_offsets(TypeIndexCtx *ctx, RzType *type, ut64 base, int depth) {
+	if (depth > TYPE_INDEX_MAX_DEPTH) {
+		return;
+	}
+	if (type->kind != RZ_TYPE_KIND_IDENTIFIER) {
+		return;
+	}
+	if (type->identifier.kind == RZ_TYPE_IDENTIFIER_KIND_STRUCT) {
+		RzBaseType *btype = index_base_type(ctx->typedb, type);
+		if (!btype || btype->kind != RZ_BASE_TYPE_KIND_STRUCT) {
+			return;
+		}
+		RzTypeStructMember *memb;
+		ut64 memb_offset = 0;
+		rz_vector_foreach(&btype->struct_data.members, memb) {
+			index_add(ctx, memb_offset - base);
+			index_nested_offsets(ctx, memb->type, memb_offset + base, depth + 1);
+			memb_offset += rz_type_db_get_bitsize(ctx->typedb, memb->type) / 8;
+		}
+	} else if (type->identifier.kind == RZ_TYPE_IDENTIFIER_KIND_UNION) {
+		RzBaseType *btype = index_base_type(ctx->typedb, type);
+		if (!btype || btype->kind != RZ_BASE_TYPE_KIND_UNION) {
+			return;
+		}
+		RzTypeUnionMember *memb;
+		rz_vector_foreach(&btype->union_data.members, memb) {
+			index_nested_offsets(ctx, memb->type, base, depth + 1);
+		}
+	}
+}
+
+static void index_compound_offsets(TypeIndexCtx *ctx) {
+	RzBaseType *btype = ctx->btype;
+	if (btype->kind == RZ_BASE_TYPE_KIND_STRUCT) {
+		RzTypeStructMember *memb;
+		ut64 memb_offset = 0;
+		rz_vector_foreach(&btype->struct_data.members, memb) {
+			index_type_deps(ctx, memb->type, 1);
+			index_add(ctx, memb_offset);
+			index_nested_offsets(ctx, memb->type, memb_offset, 1);
+			memb_offset += rz_type_db_get_bitsize(ctx->typedb, memb->type) / 8;
+		}
+	} else if (btype->kind == RZ_BASE_TYPE_KIND_UNION) {
+		RzTypeUnionMember *memb;
+		rz_vector_foreach(&btype->union_data.members, memb) {
+			index_type_deps(ctx, memb->type, 1);
+			index_nested_offsets(ctx, memb->type, 0, 1);
+		}
+	}
+}
+
+static bool index_type(const RzTypeDB *typedb, RzTypeDBIndex *index, RzBaseType *btype) {
+	if (btype->kind != RZ_BASE_TYPE_KIND_ENUM && btype->kind != RZ_BASE_TYPE_KIND_STRUCT &&
+		btype->kind != RZ_BASE_TYPE_KIND_UNION) {
+		return true;
+	}
+	TypeIndexEntry *entry = RZ_NEW0(TypeIndexEntry);
+	if (!entry) {
+		return false;
+	}
+	entry->ht = btype->kind == RZ_BASE_TYPE_KIND_ENUM ? index->enums_by_val : index->compounds_by_offset;
+	rz_vector_init(&entry->keys, sizeof(ut64), NULL, NULL);
+	rz_pvector_init(&entry->deps, free);
+	if (!ht_up_insert(index->entries, (ut64)(size_t)btype, entry)) {
+		free(entry);
+		return false;
+	}
+	TypeIndexCtx ctx = { typedb, index, btype, entry };
+	if (btype->kind == RZ_BASE_TYPE_KIND_ENUM) {
+		RzTypeEnumCase *cas;
+		rz_vector_foreach(&btype->enum_data.cases, cas) {
+			index_add(&ctx, (ut64)cas->val);
+		}
+	} else {
+		index_compound_offsets(&ctx);
+	}
+	return true;
+}
+
+/**
+ * Drops the entries of \p btype from the indexes
+ */
+static void index_type_remove(RzTypeDBIndex *index, RzBaseType *btype) {
+	ht_up_delete(index->pending, (ut64)(size_t)btype);
+	TypeIndexEntry *entry = ht_up_find(index->entries, (ut64)(size_t)btype, NULL);
+	if (!entry) {
+		return;
+	}
+	ut64 *key;
+	rz_vector_foreach(&entry->keys, key) {
+		RzPVector *vec = ht_up_find(entry->ht, *key, NULL);
+		if (!vec) {
+			continue;
+		}
+		rz_pvector_remove_data(vec, btype);
+		if (rz_pvector_empty(vec)) {
+			ht_up_delete(entry->ht, *key);
+		}
+	}
+	void **it;
+	rz_pvector_foreach (&entry->deps, it) {
+		RzPVector *vec = ht_pp_find(index->dependents, *it, NULL);
+		if (!vec) {
+			continue;
+		}
+		rz_pvector_remove_data(vec, btype);
+		if (rz_pvector_empty(vec)) {
+			ht_pp_delete(index->dependents, *it);
+		}
+	}
+	ht_up_delete(index->entries, (ut64)(size_t)btype);
+}
+
+static void index_pending_add(RzTypeDBIndex *index, const char *name) {
+	RzPVector *vec = ht_pp_find(index->dependents, name, NULL);
+	if (!vec) {
+		return;
+	}
+	void **it;
+	rz_pvector_foreach (vec, it) {
+		ht_up_update(index->pending, (ut64)(size_t)*it, NULL);
+	}
+}
+
+static bool index_collect_cb(void *user, const ut64 k, const void *v) {
+	return rz_vector_push(user, (void *)&k);
+}
+
+/**
+ * Indexes again the types changed or depending on changed types since the
+ * last query. Indexing can load more types from the libraries, which are
+ * processed in the same way.
+ */
+static bool index_flush(const RzTypeDB *typedb, RzTypeDBIndex *index) {
+	RzVector types;
+	rz_vector_init(&types, sizeof(ut64), NULL, NULL);
+	bool ok = true;
+	while (ok && index->pending->count) {
+		rz_vector_clear(&types);
+		ht_up_foreach(index->pending, index_collect_cb, &types);
+		ut64 *k;
+		rz_vector_foreach(&types, k) {
+			ht_up_delete(index->pending, *k);
+		}
+		rz_vector_foreach(&types, k) {
+			RzBaseType *btype = (RzBaseType *)(size_t)*k;
+			index_type_remove(index, btype);
+			if (!index_type(typedb, index, btype)) {
+				ok = false;
+				break;
+			}
+		}
+	}
+	rz_vector_fini(&types);
+	return ok;
+}
+
+static bool index_types_collect_cb(void *user, const void *k, const void *v) {
+	return rz_pvector_push(user, (void *)v);
+}
+
+static RzTypeDBIndex *index_get(const RzTypeDB *typedb) {
+	RzTypeDB *db = (RzTypeDB *)typedb;
+	if (db->index && db->index->generation == db->generation && index_flush(db, db->index)) {
+		return db->index;
+	}
+	rz_type_db_index_free(db->index);
+	db->index = index_new(db);
+	if (!db->index) {
+		return NULL;
+	}
+	// Indexing can load types, so the database is not walked while doing it
+	RzPVector types;
+	rz_pvector_init(&types, NULL);
+	ht_pp_foreach(db->types, index_types_collect_cb, &types);
+	bool ok = true;
+	void **it;
+	rz_pvector_foreach (&types, it) {
+		if (!index_type(db, db->index, *it)) {
+			ok = false;
+			break;
+		}
+	}
+	rz_pvector_fini(&types);
+	if (!ok || !index_flush(db, db->index)) {
+		rz_type_db_index_free(db->index);
+		db->index = NULL;
+	}
+	return db->index;
+}
+
+/**
+ * Updates the indexes for \p btype, just saved in the database
+ */
+RZ_IPI void rz_type_db_index_add(RZ_NONNULL const RzTypeDB *typedb, RZ_NONNULL RzBaseType *btype) {
+	RzTypeDBIndex *index = typedb->index;
+	if (!index || index->generation != typedb->generation) {
+		return;
+	}
+	ht_up_update(index->pending, (ut64)(size_t)btype, NULL);
+	index_pending_add(index, btype->name);
+}
+
+/**
+ * Updates the indexes for \p btype, which is going to be removed from the
+ * database and freed
+ */
+RZ_IPI void rz_type_db_index_remove(RZ_NONNULL const RzTypeDB *typedb, RZ_NONNULL RzBaseType *btype) {
+	RzTypeDBIndex *index = typedb->index;
+	if (!index || index->generation != typedb->generation) {
+		return;
+	}
+	index_pending_add(index, btype->name);
+	index_type_remove(index, btype);
+}
+
+/**
+ * \brief Marks the reverse indexes of the types database as stale
+ *
+ * Increments the generation of the database, so the indexes are rebuilt on
+ * the next query. This is done by the parser and by the bulk changes of the
+ * RzTypeDB API, it must be called only after changing a RzBaseType already
+ * saved in the database in place.
+ *
+ * \param typedb Types Database instance
+ */
+RZ_API void rz_type_db_invalidate_index(RZ_NONNULL const RzTypeDB *typedb) {
+	rz_return_if_fail(typedb);
+	((RzTypeDB *)typedb)->generation++;
+}
+
+/**
+ * Returns the enums having at least one case equal to \p val, or NULL
+ */
+RZ_IPI RZ_BORROW const RzPVector /*<RzBaseType *>*/ *rz_type_db_index_enums_by_val(const RzTypeDB *typedb, ut64 val) {
+	rz_type_db_lazy_load_enums_by_val(typedb, val);
+	RzTypeDBIndex *index = index_get(typedb);
+	return index ? ht_up_find(index->enums_by_val, val, NULL) : NULL;
+}
+
+/**
+ * Returns the structures and unions for which rz_type_path_by_offset()
+ * returns at least one path with \p offset, or NULL
+ */
+RZ_IPI RZ_BORROW const RzPVector /*<RzBaseType *>*/ *rz_type_db_index_compounds_by_offset(const RzTypeDB *typedb, ut64 offset) {
+	rz_type_db_lazy_load_compounds(typedb);
+	RzTypeDBIndex *index = index_get(typedb);
+	return index ? ht_up_find(index->compounds_by_offset, offset, NULL) : NULL;
+}
@@ -0,0 +1,420 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include <rz_type.h>
+#include <sdb.h>
+#include "type_internal.h"
+
+/*
+ * Lazy loading of the pre-shipped type libraries.
+ *
+ * The types-*.sdb and functions-*.sdb files are compiled at build time and
+ * can be queried by name without being loaded, so rz_type_db_init() only
+ * opens them when the database is empty, and every RzBaseType/RzCallable
+ * is parsed the first time it is looked up. Listing functions load all the
+ * pending types first.
+ *
+ * As when the libraries were loaded one after the other, a name defined by
+ * several libraries resolves to the one loaded last. The names looked up
+ * once are remembered, so that deleting a type doesn't resurrect it from
+ * the libraries.
+ *
+ * Since the lookups taking a const RzTypeDB can load types, and so change
+ * the hashtables of the database, a RzTypeDB must not be used by several
+ * threads at once, even only for lookups.
+ */
+
+struct rz_type_db_lazy_t {
+	RzPVector /*<Sdb *>*/ types; ///< types libraries not fully loaded, in loading order
+	RzPVector /*<Sdb *>*/ callables; ///< function types libraries not fully loaded, in loading order
+	HtPP /*<char *, NULL>*/ *types_seen; ///< base type names already looked up in the libraries
+	HtPP /*<char *, NULL>*/ *callables_seen; ///< callable names already looked up in the libraries
+	HtUP /*<ut64, RzPVector<char *>>*/ *enums_by_val; ///< case value -> names of the enums in the libraries, built on demand
+};
+
+static void lazy_sdb_free(void *e) {
+	Sdb *db = e;
+	sdb_close(db);
+	sdb_free(db);
+}
+
+/**
+ * Frees the lazy loading state, closing the libraries left
+ */
+RZ_IPI void rz_type_db_lazy_free(RZ_NULLABLE RzTypeDBLazy *lazy) {
+	if (!lazy) {
+		return;
+	}
+	rz_pvector_fini(&lazy->types);
+	rz_pvector_fini(&lazy->callables);
+	ht_pp_free(lazy->types_seen);
+	ht_pp_free(lazy->callables_seen);
+	ht_up_free(lazy->enums_by_val);
+	free(lazy);
+}
+
+static RzTypeDBLazy *lazy_get(RzTypeDB *typedb) {
+	if (typedb->lazy) {
+		return typedb->lazy;
+	}
+	RzTypeDBLazy *lazy = RZ_NEW0(RzTypeDBLazy);
+	if (!lazy) {
+		return NULL;
+	}
+	rz_pvector_init(&lazy->types, lazy_sdb_free);
+	rz_pvector_init(&lazy->callables, lazy_sdb_free);
+	lazy->types_seen = ht_pp_new0();
+	lazy->callables_seen = ht_pp_new0();
+	if (!lazy->types_seen || !lazy->callables_seen) {
+		rz_type_db_lazy_free(lazy);
+		return NULL;
+	}
+	typedb->lazy = lazy;
+	return lazy;
+}
+
+static bool lazy_add_sdb(RzTypeDB *typedb, const char *path, bool callables) {
+	if (!rz_file_exists(path)) {
+		return false;
+	}
+	RzTypeDBLazy *lazy = lazy_get(typedb);
+	if (!lazy) {
+		return false;
+	}
+	Sdb *db = sdb_new(0, path, 0);
+	if (!db) {
+		return false;
+	}
+	if (!rz_pvector_push(callables ? &lazy->callables : &lazy->types, db)) {
+		lazy_sdb_free(db);
+		return false;
+	}
+	if (!callables) {
+		ht_up_free(lazy->enums_by_val);
+		lazy->enums_by_val = NULL;
+	}
+	// The names missing so far can be found in the new library
+	HtPP **seen = callables ? &lazy->callables_seen : &lazy->types_seen;
+	ht_pp_free(*seen);
+	*seen = ht_pp_new0();
+	return *seen != NULL;
+}
+
+/**
+ * Adds the compiled types library at \p path, its types are loaded on
+ * their first lookup
+ */
+RZ_IPI bool rz_type_db_lazy_add_types_sdb(RZ_NONNULL RzTypeDB *typedb, RZ_NONNULL const char *path) {
+	rz_return_val_if_fail(typedb && path, false);
+	return lazy_add_sdb(typedb, path, false);
+}
+
+/**
+ * Adds the compiled function types library at \p path, its callables are
+ * loaded on their first lookup
+ */
+RZ_IPI bool rz_type_db_lazy_add_callables_sdb(RZ_NONNULL RzTypeDB *typedb, RZ_NONNULL const char *path) {
+	rz_return_val_if_fail(typedb && path, false);
+	return lazy_add_sdb(typedb, path, true);
+}
+
+static bool lazy_seen(HtPP *seen, const char *name) {
+	bool found = false;
+	ht_pp_find(seen, name, &found);
+	return found;
+}
+
+/**
+ * Loads the base type \p name from the pending libraries if it was never
+ * looked up before, returns NULL if there is no such type.
+ */
+RZ_IPI RZ_BORROW RzBaseType *rz_type_db_lazy_base_type(RZ_NONNULL const RzTypeDB *typedb, RZ_NONNULL const char *name) {
+	RzTypeDB *db = (RzTypeDB *)typedb;
+	RzTypeDBLazy *lazy = db->lazy;
+	if (!lazy || rz_pvector_empty(&lazy->types) || lazy_seen(lazy->types_seen, name)) {
+		return NULL;
+	}
+	// Marked before loading, since the type can reference itself
+	ht_pp_insert(lazy->types_seen, name, NULL);
+	for (size_t i = rz_pvector_len(&lazy->types); i > 0; i--) {
+		Sdb *sdb = rz_pvector_at(&lazy->types, i - 1);
+		if (rz_type_db_sdb_load_base_type(db, sdb, name)) {
+			return ht_pp_find(db->types, name, NULL);
+		}
+	}
+	return NULL;
+}
+
+static bool base_type_kind_filter(void *user, const char *k, const char *v) {
+	return !strcmp(v, "struct") || !strcmp(v, "enum") || !strcmp(v, "union") ||
+		!strcmp(v, "typedef") || !strcmp(v, "type");
+}
+
+static bool enum_kind_filter(void *user, const char *k, const char *v) {
+	return !strcmp(v, "enum");
+}
+
+static bool compound_kind_filter(void *user, const char *k, const char *v) {
+	return !strcmp(v, "struct") || !strcmp(v, "union");
+}
+
+/**
+ * Loads all the base types left in the pending libraries
+ */
+RZ_IPI void rz_type_db_lazy_load_types(RZ_NONNULL const RzTypeDB *typedb) {
+	RzTypeDB *db = (RzTypeDB *)typedb;
+	RzTypeDBLazy *lazy = db->lazy;
+	if (!lazy || rz_pvector_empty(&lazy->types)) {
+		return;
+	}
+	for (size_t i = rz_pvector_len(&lazy->types); i > 0; i--) {
+		Sdb *sdb = rz_pvector_at(&lazy->types, i - 1);
+		SdbKv *kv;
+		SdbListIter *iter;
+		SdbList *l = sdb_foreach_list_filter(sdb, base_type_kind_filter, false);
+		ls_foreach (l, iter, kv) {
+			const char *name = sdbkv_key(kv);
+			if (lazy_seen(lazy->types_seen, name)) {
+				continue;
+			}
+			ht_pp_insert(lazy->types_seen, name, NULL);
+			if (ht_pp_find(db->types, name, NULL)) {
+				// Loaded by other means after this library
+				continue;
+			}
+			rz_type_db_sdb_load_base_type(db, sdb, name);
+		}
+		ls_free(l);
+	}
+	rz_pvector_clear(&lazy->types);
+	rz_type_db_invalidate_index(db);
+}
+
+static void lazy_pvector_free(HtUPKv *kv) {
+	rz_pvector_free(kv->value);
+}
+
+/**
+ * Maps the values of the enum cases of the pending libraries to the names
+ * of their enums, reading the libraries without parsing the types
+ */
+static HtUP *lazy_enums_by_val_new(RzTypeDBLazy *lazy) {
+	HtUP *ht = ht_up_new(NULL, lazy_pvector_free, NULL);
+	if (!ht) {
+		return NULL;
+	}
+	RzStrBuf key;
+	rz_strbuf_init(&key);
+	for (size_t i = rz_pvector_len(&lazy->types); i > 0; i--) {
+		Sdb *sdb = rz_pvector_at(&lazy->types, i - 1);
+		SdbKv *kv;
+		SdbListIter *iter;
+		SdbList *l = sdb_foreach_list_filter(sdb, enum_kind_filter, false);
+		ls_foreach (l, iter, kv) {
+			const char *name = sdbkv_key(kv);
+			char *cases = sdb_get(sdb, rz_strbuf_setf(&key, "enum.%s", name), NULL);
+			if (!cases) {
+				continue;
+			}
+			RzList *list = rz_str_split_list(cases, ",", 0);
+			RzListIter *it;
+			char *cas;
+			rz_list_foreach (list, it, cas) {
+				ut64 val = sdb_num_get(sdb, rz_strbuf_setf(&key, "enum.%s.%s", name, cas), NULL);
+				RzPVector *names = ht_up_find(ht, val, NULL);
+				if (!names) {
+					names = rz_pvector_new(free);
+					if (!names || !ht_up_insert(ht, val, names)) {
+						rz_pvector_free(names);
+						continue;
+					}
+				}
+				rz_pvector_push(names, strdup(name));
+			}
+			rz_list_free(list);
+			free(cases);
+		}
+		ls_free(l);
+	}
+	rz_strbuf_fini(&key);
+	return ht;
+}
+
+/**
+ * Loads from the pending libraries only the enums having a case equal to
+ * \p val, so that they can be found by value
+ */
+RZ_IPI void rz_type_db_lazy_load_enums_by_val(RZ_NONNULL const RzTypeDB *typedb, ut64 val) {
+	RzTypeDB *db = (RzTypeDB *)typedb;
+	RzTypeDBLazy *lazy = db->lazy;
+	if (!lazy || rz_pvector_empty(&lazy->types)) {
+		return;
+	}
+	if (!lazy->enums_by_val) {
+		lazy->enums_by_val = lazy_enums_by_val_new(lazy);
+		if (!lazy->enums_by_val) {
+			return;
+		}
+	}
+	RzPVector *names = ht_up_find(lazy->enums_by_val, val, NULL);
+	if (!names) {
+		return;
+	}
+	void **it;
+	rz_pvector_foreach (names, it) {
+		// Resolves to the library loaded last, as any other lookup
+		rz_type_db_lazy_base_type(db, *it);
+	}
+}
+
+/**
+ * Loads from the pending libraries only the structures and the unions,
+ * and the types they reference
+ */
+RZ_IPI void rz_type_db_lazy_load_compounds(RZ_NONNULL const RzTypeDB *typedb) {
+	RzTypeDB *db = (RzTypeDB *)typedb;
+	RzTypeDBLazy *lazy = db->lazy;
+	if (!lazy || rz_pvector_empty(&lazy->types)) {
+		return;
+	}
+	for (size_t i = rz_pvector_len(&lazy->types); i > 0; i--) {
+		Sdb *sdb = rz_pvector_at(&lazy->types, i - 1);
+		SdbKv *kv;
+		SdbListIter *iter;
+		SdbList *l = sdb_foreach_list_filter(sdb, compound_kind_filter, false);
+		ls_foreach (l, iter, kv) {
+			rz_type_db_lazy_base_type(db, sdbkv_key(kv));
+		}
+		ls_free(l);
+	}
+}
+
+/**
+ * Prevents the base type \p name from being loaded from the libraries
+ */
+RZ_IPI void rz_type_db_lazy_drop_type(RZ_NONNULL RzTypeDB *typedb, RZ_NONNULL const char *name) {
+	RzTypeDBLazy *lazy = typedb->lazy;
+	if (!lazy || rz_pvector_empty(&lazy->types) || lazy_seen(lazy->types_seen, name)) {
+		return;
+	}
+	ht_pp_insert(lazy->types_seen, name, NULL);
+}
+
+/**
+ * Loads the callable \p name from the pending libraries if it was never
+ * looked up before, returns NULL if there is no such callable.
+ */
+RZ_IPI RZ_BORROW RzCallable *rz_type_db_lazy_callable(RZ_NONNULL const RzTypeDB *typedb, RZ_NONNULL const char *name) {
+	RzTypeDB *db = (RzTypeDB *)typedb;
+	RzTypeDBLazy *lazy = db->lazy;
+	if (!lazy || rz_pvector_empty(&lazy->callables) || lazy_seen(lazy->callables_seen, name)) {
+		return NULL;
+	}
+	ht_pp_insert(lazy->callables_seen, name, NULL);
+	for (size_t i = rz_pvector_len(&lazy->callables); i > 0; i--) {
+		Sdb *sdb = rz_pvector_at(&lazy->callables, i - 1);
+		if (rz_type_db_sdb_load_callable(db, sdb, name)) {
+			return ht_pp_find(db->callables, name, NULL);
+		}
+	}
+	return NULL;
+}
+
+static bool callable_kind_filter(void *user, const char *k, const char *v) {
+	return !strcmp(v, "func");
+}
+
+/**
+ * Loads all the callables left in the pending libraries
+ */
+RZ_IPI void rz_type_db_lazy_load_callables(RZ_NONNULL const RzTypeDB *typedb) {
+	RzTypeDB *db = (RzTypeDB *)typedb;
+	RzTypeDBLazy *lazy = db->lazy;
+	if (!lazy || rz_pvector_empty(&lazy->callables)) {
+		return;
+	}
+	for (size_t i = rz_pvector_len(&lazy->callables); i > 0; i--) {
+		Sdb *sdb = rz_pvector_at(&lazy->callables, i - 1);
+		SdbKv *kv;
+		SdbListIter *iter;
+		SdbList *l = sdb_foreach_list_filter(sdb, callable_kind_filter, false);
+		ls_foreach (l, iter, kv) {
+			const char *name = sdbkv_key(kv);
+			if (lazy_seen(lazy->callables_seen, name)) {
+				continue;
+			}
+			ht_pp_insert(lazy->callables_seen, name, NULL);
+			if (ht_pp_find(db->callables, name, NULL)) {
+				continue;
+			}
+			rz_type_db_sdb_load_callable(db, sdb, name);
+		}
+		ls_free(l);
+	}
+	rz_pvector_clear(&lazy->callables);
+}
+
+/**
+ * Appends to \p names the names of the callables not loaded yet from the
+ * pending libraries, without loading them. If \p noreturn is true, only
+ * the names of the noreturn ones are appended.
+ */
+RZ_IPI void rz_type_db_lazy_callable_names(RZ_NONNULL const RzTypeDB *typedb, RZ_NONNULL RzList /*<char *>*/ *names, bool noreturn) {
+	RzTypeDBLazy *lazy = typedb->lazy;
+	if (!lazy || rz_pvector_empty(&lazy->callables)) {
+		return;
+	}
+	HtPP *listed = ht_pp_new0();
+	if (!listed) {
+		return;
+	}
+	RzStrBuf key;
+	rz_strbuf_init(&key);
+	for (size_t i = rz_pvector_len(&lazy->callables); i > 0; i--) {
+		Sdb *sdb = rz_pvector_at(&lazy->callables, i - 1);
+		SdbKv *kv;
+		SdbListIter *iter;
+		SdbList *l = sdb_foreach_list_filter(sdb, callable_kind_filter, false);
+		ls_foreach (l, iter, kv) {
+			const char *name = sdbkv_key(kv);
+			if (lazy_seen(listed, name)) {
+				// Overridden by a library loaded later
+				continue;
+			}
+			ht_pp_insert(listed, name, NULL);
+			if (lazy_seen(lazy->callables_seen, name) || ht_pp_find(typedb->callables, name, NULL)) {
+				continue;
+			}
+			if (noreturn && !sdb_bool_get(sdb, rz_strbuf_setf(&key, "func.%s.noreturn", name), 0)) {
+				continue;
+			}
+			rz_list_append(names, strdup(name));
+		}
+		ls_free(l);
+	}
+	rz_strbuf_fini(&key);
+	ht_pp_free(listed);
+}
+
+/**
+ * Prevents the callable \p name from being loaded from the libraries
+ */
+RZ_IPI void rz_type_db_lazy_drop_callable(RZ_NONNULL RzTypeDB *typedb, RZ_NONNULL const char *name) {
+	RzTypeDBLazy *lazy = typedb->lazy;
+	if (!lazy || rz_pvector_empty(&lazy->callables) || lazy_seen(lazy->callables_seen, name)) {
+		return;
+	}
+	ht_pp_insert(lazy->callables_seen, name, NULL);
+}
+
+/**
+ * Forgets all the callables of the pending libraries
+ */
+RZ_IPI void rz_type_db_lazy_drop_callables(RZ_NONNULL RzTypeDB *typedb) {
+	RzTypeDBLazy *lazy = typedb->lazy;
+	if (!lazy) {
+		return;
+	}
+	rz_pvector_clear(&lazy->callables);
+}
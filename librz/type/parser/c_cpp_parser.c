@@ -9,6 +9,7 @@
 #include <tree_sitter/api.h>
 
 #include <types_parser.h>
+#include "../type_internal.h"
 
 // Declare the `tree_sitter_c` function, which is
 // implemented by the `tree-sitter-c` library.
@@ -109,6 +110,15 @@ RZ_API RZ_OWN RzTypeParser *rz_type_parser_init(HtPP *types, HtPP *callables) {
 	return parser;
 }
 
+/**
+ * Sets the types database owning the hashtables of the parser, to look up
+ * the types not loaded yet
+ */
+RZ_IPI void rz_type_parser_set_typedb(RZ_NONNULL RzTypeParser *parser, RZ_NULLABLE RzTypeDB *typedb) {
+	rz_return_if_fail(parser);
+	parser->state->typedb = typedb;
+}
+
 /**
  * \brief Frees the instance of the C type parser without destroying hashtables
  */
@@ -127,6 +137,10 @@ RZ_API void rz_type_parser_free_purge(RZ_NONNULL RzTypeParser *parser) {
 }
 
 static int type_parse_string(CParserState *state, const char *code, char **error_msg) {
+	if (state->typedb) {
+		// Forward declarations can be completed in place
+		rz_type_db_invalidate_index(state->typedb);
+	}
 	// Create a parser.
 	TSParser *parser = ts_parser_new();
 	// Set the parser's language (C in this case)
@@ -272,6 +286,7 @@ RZ_API int rz_type_parse_string(RzTypeDB *typedb, const char *code, char **error
 		return -1;
 	}
 	state->verbose = verbose;
+	state->typedb = typedb;
 	return type_parse_string(state, code, error_msg);
 }
 
@@ -13,6 +13,7 @@ typedef struct {
 	HtPP *types;
 	HtPP *callables;
 	HtPP *forward;
+	RzTypeDB *typedb; // types database the hashtables belong to, for the types not loaded yet
 	RzStrBuf *errors;
 	RzStrBuf *warnings;
 	RzStrBuf *debug;
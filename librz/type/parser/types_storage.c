@@ -9,6 +9,7 @@
 #include <tree_sitter/api.h>
 
 #include <types_parser.h>
+#include "../type_internal.h"
 
 // Searching and storing types in the context of the parser (types and callables hashables)
 
@@ -18,7 +19,7 @@ RzBaseType *c_parser_base_type_find(CParserState *state, RZ_NONNULL const char *
 	bool found = false;
 	RzBaseType *base_type = ht_pp_find(state->types, name, &found);
 	if (!found || !base_type) {
-		return NULL;
+		return state->typedb ? rz_type_db_lazy_base_type(state->typedb, name) : NULL;
 	}
 	return base_type;
 }
@@ -44,6 +45,9 @@ bool c_parser_base_type_store(CParserState *state, RZ_NONNULL const char *name,
 
 	// We store only RzBaseType part of the type pair
 	ht_pp_insert(state->types, name, tpair->btype);
+	if (state->typedb) {
+		rz_type_db_invalidate_index(state->typedb);
+	}
 	return true;
 }
 
@@ -86,7 +90,7 @@ RzCallable *c_parser_callable_type_find(CParserState *state, RZ_NONNULL const ch
 	bool found = false;
 	RzCallable *callable = ht_pp_find(state->callables, name, &found);
 	if (!found || !callable) {
-		return NULL;
+		return state->typedb ? rz_type_db_lazy_callable(state->typedb, name) : NULL;
 	}
 	return callable;
 }
@@ -4,6 +4,8 @@
 #include <rz_util.h>
 #include <rz_type.h>
 
+#include "type_internal.h"
+
 /**
  * \brief Creates a new instance of RzTypePath
  *
@@ -218,19 +220,20 @@ RZ_API RZ_OWN RzList /* RzTypePath */ *rz_type_path_by_offset(const RzTypeDB *ty
  */
 RZ_API RZ_OWN RzList /* RzTypePath */ *rz_type_db_get_by_offset(const RzTypeDB *typedb, ut64 offset) {
 	rz_return_val_if_fail(typedb, NULL);
-	RzList *types = rz_type_db_get_base_types(typedb);
 	RzList *result = rz_list_newf((RzListFree)rz_type_path_free);
-	RzListIter *iter;
-	RzBaseType *t;
-	rz_list_foreach (types, iter, t) {
-		if (t->kind == RZ_BASE_TYPE_KIND_STRUCT || t->kind == RZ_BASE_TYPE_KIND_UNION) {
-			RzList *list = rz_type_path_by_offset(typedb, t, offset);
-			if (list) {
-				rz_list_join(result, list);
-			}
+	const RzPVector *types = rz_type_db_index_compounds_by_offset(typedb, offset);
+	if (!types) {
+		return result;
+	}
+	void **it;
+	rz_pvector_foreach (types, it) {
+		RzBaseType *t = *it;
+		RzList *list = rz_type_path_by_offset(typedb, t, offset);
+		if (list) {
+			rz_list_join(result, list);
+			rz_list_free(list);
 		}
 	}
-	rz_list_free(types);
 	return result;
 }
 
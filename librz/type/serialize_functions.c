@@ -7,6 +7,8 @@
 #include <rz_type.h>
 #include <sdb.h>
 
+#include "type_internal.h"
+
 /**
  * Parse a type or take it from the cache if it has been parsed before already.
  * This cache is really only relevant because types are stored in the sdb as their C expression,
@@ -156,6 +158,29 @@ static bool sdb_load_callables(RzTypeDB *typedb, Sdb *sdb) {
 	return true;
 }
 
+/**
+ * Loads the single callable type \p name from \p sdb into the database,
+ * returns false if it is not defined there or cannot be loaded.
+ */
+RZ_IPI bool rz_type_db_sdb_load_callable(RzTypeDB *typedb, Sdb *sdb, const char *name) {
+	const char *kind = sdb_const_get(sdb, name, NULL);
+	if (!kind || strcmp(kind, "func")) {
+		return false;
+	}
+	HtPP *type_str_cache = ht_pp_new0();
+	if (!type_str_cache) {
+		return false;
+	}
+	RzCallable *callable = get_callable_type(typedb, sdb, name, type_str_cache);
+	ht_pp_free(type_str_cache);
+	if (!callable) {
+		return false;
+	}
+	ht_pp_update(typedb->callables, callable->name, callable);
+	RZ_LOG_DEBUG("inserting the \"%s\" callable type\n", callable->name);
+	return true;
+}
+
 static bool sdb_load_by_path(RZ_NONNULL RzTypeDB *typedb, RZ_NONNULL const char *path) {
 	rz_return_val_if_fail(typedb && path, false);
 	if (RZ_STR_ISEMPTY(path)) {
@@ -253,6 +278,7 @@ static bool export_callable_cb(void *user, const void *k, const void *v) {
 
 static bool callable_export_sdb(RZ_NONNULL Sdb *db, RZ_NONNULL const RzTypeDB *typedb) {
 	struct typedb_sdb tdb = { typedb, db };
+	rz_type_db_lazy_load_callables(typedb);
 	ht_pp_foreach(typedb->callables, export_callable_cb, &tdb);
 	return true;
 }
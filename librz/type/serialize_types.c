@@ -7,6 +7,8 @@
 #include <rz_type.h>
 #include <sdb.h>
 
+#include "type_internal.h"
+
 typedef struct {
 	RzBaseType *type;
 	char *format;
@@ -316,44 +318,74 @@ error:
 	return NULL;
 }
 
+static bool sdb_load_base_type(RzTypeDB *typedb, Sdb *sdb, const char *name, const char *kind) {
+	TypeFormatPair *tpair = NULL;
+	if (!strcmp(kind, "struct")) {
+		tpair = get_struct_type(typedb, sdb, name);
+	} else if (!strcmp(kind, "enum")) {
+		tpair = get_enum_type(sdb, name);
+	} else if (!strcmp(kind, "union")) {
+		tpair = get_union_type(typedb, sdb, name);
+	} else if (!strcmp(kind, "typedef")) {
+		tpair = get_typedef_type(typedb, sdb, name);
+	} else if (!strcmp(kind, "type")) {
+		tpair = get_atomic_type(typedb, sdb, name);
+	}
+	if (!tpair) {
+		return false;
+	}
+	bool result = false;
+	if (tpair->type) {
+		RzBaseType *old = ht_pp_find(typedb->types, tpair->type->name, NULL);
+		if (old) {
+			rz_type_db_index_remove(typedb, old);
+		}
+		ht_pp_update(typedb->types, tpair->type->name, tpair->type);
+		rz_type_db_index_add(typedb, tpair->type);
+		// If the SDB provided the preferred type format then we store it
+		char *format = tpair->format ? tpair->format : NULL;
+		// Format is not always defined, e.g. for types like "void" or anonymous types
+		if (format) {
+			ht_pp_update(typedb->formats, tpair->type->name, format);
+			RZ_LOG_DEBUG("inserting the \"%s\" type & format: \"%s\"\n", tpair->type->name, format);
+		} else {
+			ht_pp_delete(typedb->formats, tpair->type->name);
+		}
+		result = true;
+	} else {
+		free(tpair->format);
+	}
+	free(tpair);
+	return result;
+}
+
 bool sdb_load_base_types(RzTypeDB *typedb, Sdb *sdb) {
 	rz_return_val_if_fail(typedb && sdb, false);
 	SdbKv *kv;
 	SdbListIter *iter;
 	SdbList *l = sdb_foreach_list(sdb, false);
 	ls_foreach (l, iter, kv) {
-		TypeFormatPair *tpair = NULL;
-		if (!strcmp(sdbkv_value(kv), "struct")) {
-			tpair = get_struct_type(typedb, sdb, sdbkv_key(kv));
-		} else if (!strcmp(sdbkv_value(kv), "enum")) {
-			tpair = get_enum_type(sdb, sdbkv_key(kv));
-		} else if (!strcmp(sdbkv_value(kv), "union")) {
-			tpair = get_union_type(typedb, sdb, sdbkv_key(kv));
-		} else if (!strcmp(sdbkv_value(kv), "typedef")) {
-			tpair = get_typedef_type(typedb, sdb, sdbkv_key(kv));
-		} else if (!strcmp(sdbkv_value(kv), "type")) {
-			tpair = get_atomic_type(typedb, sdb, sdbkv_key(kv));
-		}
-		if (tpair && tpair->type) {
-			ht_pp_update(typedb->types, tpair->type->name, tpair->type);
-			// If the SDB provided the preferred type format then we store it
-			char *format = tpair->format ? tpair->format : NULL;
-			// Format is not always defined, e.g. for types like "void" or anonymous types
-			if (format) {
-				ht_pp_update(typedb->formats, tpair->type->name, format);
-				RZ_LOG_DEBUG("inserting the \"%s\" type & format: \"%s\"\n", tpair->type->name, format);
-			} else {
-				ht_pp_delete(typedb->formats, tpair->type->name);
-			}
-		} else if (tpair) {
-			free(tpair->format);
-		}
-		free(tpair);
+		sdb_load_base_type(typedb, sdb, sdbkv_key(kv), sdbkv_value(kv));
 	}
 	ls_free(l);
+	rz_type_db_invalidate_index(typedb);
 	return true;
 }
 
+/**
+ * Loads the single base type \p name from \p sdb into the database,
+ * returns false if it is not defined there or cannot be loaded.
+ */
+RZ_IPI bool rz_type_db_sdb_load_base_type(RzTypeDB *typedb, Sdb *sdb, const char *name) {
+	char *kind = sdb_get(sdb, name, NULL);
+	if (!kind) {
+		return false;
+	}
+	bool result = sdb_load_base_type(typedb, sdb, name, kind);
+	free(kind);
+	return result;
+}
+
 static void save_struct(const RzTypeDB *typedb, Sdb *sdb, const RzBaseType *type) {
 	rz_return_if_fail(typedb && sdb && type && type->name && type->kind == RZ_BASE_TYPE_KIND_STRUCT);
 	const char *kind = "struct";
@@ -610,6 +642,7 @@ static bool export_base_type_cb(void *user, const void *k, const void *v) {
 
 static bool types_export_sdb(RZ_NONNULL Sdb *db, RZ_NONNULL const RzTypeDB *typedb) {
 	struct typedb_sdb tdb = { typedb, db };
+	rz_type_db_lazy_load_types(typedb);
 	ht_pp_foreach(typedb->types, export_base_type_cb, &tdb);
 	return true;
 }
@@ -9,6 +9,8 @@
 #include <string.h>
 #include <sdb.h>
 
+#include "type_internal.h"
+
 static void types_ht_free(HtPPKv *kv) {
 	free(kv->key);
 	rz_type_base_type_free(kv->value);
@@ -58,6 +60,7 @@ RZ_API RzTypeDB *rz_type_db_new() {
 	if (!typedb->parser) {
 		goto rz_type_db_new_fail;
 	}
+	rz_type_parser_set_typedb(typedb->parser, typedb);
 	rz_io_bind_init(typedb->iob);
 	return typedb;
 
@@ -77,6 +80,8 @@ rz_type_db_new_fail:
  * Destroys hashtables for RzBaseType, RzCallable, type formats.
  */
 RZ_API void rz_type_db_free(RzTypeDB *typedb) {
+	rz_type_db_index_free(typedb->index);
+	rz_type_db_lazy_free(typedb->lazy);
 	rz_type_parser_free(typedb->parser);
 	ht_pp_free(typedb->callables);
 	ht_pp_free(typedb->types);
@@ -94,18 +99,24 @@ RZ_API void rz_type_db_free(RzTypeDB *typedb) {
  * Destroys all loaded base types and callable types.
  */
 RZ_API void rz_type_db_purge(RzTypeDB *typedb) {
+	rz_type_db_invalidate_index(typedb);
+	rz_type_db_lazy_free(typedb->lazy);
+	typedb->lazy = NULL;
 	ht_pp_free(typedb->callables);
 	typedb->callables = ht_pp_new(NULL, callables_ht_free, NULL);
 	ht_pp_free(typedb->types);
 	typedb->types = ht_pp_new(NULL, types_ht_free, NULL);
 	rz_type_parser_free(typedb->parser);
 	typedb->parser = rz_type_parser_init(typedb->types, typedb->callables);
+	rz_type_parser_set_typedb(typedb->parser, typedb);
 }
 
 /**
  * \brief Purges formats in the instance of the RzTypeDB
  */
 RZ_API void rz_type_db_format_purge(RzTypeDB *typedb) {
+	// The formats come along with the types
+	rz_type_db_lazy_load_types(typedb);
 	ht_pp_free(typedb->formats);
 	typedb->formats = ht_pp_new(NULL, formats_ht_free, NULL);
 }
@@ -144,6 +155,8 @@ static void set_default_type(RzTypeTarget *target, int bits) {
  */
 RZ_API void rz_type_db_set_bits(RzTypeDB *typedb, int bits) {
 	typedb->target->bits = bits;
+	// Pointers size changes the offsets of the structure members
+	rz_type_db_invalidate_index(typedb);
 	// Also set the new default type
 	set_default_type(typedb->target, bits);
 }
@@ -222,6 +235,21 @@ RZ_API bool rz_type_db_del(RzTypeDB *typedb, RZ_NONNULL const char *name) {
 	return true;
 }
 
+static bool load_types_sdb(RzTypeDB *typedb, const char *path) {
+	if (typedb->types->count) {
+		// The libraries have to override the types already there
+		return rz_type_db_load_sdb(typedb, path);
+	}
+	return rz_type_db_lazy_add_types_sdb(typedb, path);
+}
+
+static bool load_callables_sdb(RzTypeDB *typedb, const char *path) {
+	if (typedb->callables->count) {
+		return rz_type_db_load_callables_sdb(typedb, path);
+	}
+	return rz_type_db_lazy_add_callables_sdb(typedb, path);
+}
+
 /**
  * \brief Initializes the types database for specified arch, bits, OS
  *
@@ -230,6 +258,7 @@ RZ_API bool rz_type_db_del(RzTypeDB *typedb, RZ_NONNULL const char *name) {
  * on what exact types are loaded, also some atomic types sizes are different.
  * In some cases the same type, for example, structure type could have
  * a different layout, depending on the operating system or bitness.
+ * The types of the libraries are loaded on their first lookup.
  *
  * \param typedb Types Database instance
  * \param types_dir Directory where all type libraries are installed
@@ -248,13 +277,13 @@ RZ_API void rz_type_db_init(RzTypeDB *typedb, const char *types_dir, const char
 	// At first we load the basic types
 	// Atomic types
 	char *dbpath = rz_file_path_join(types_dir, "types-atomic.sdb");
-	if (rz_type_db_load_sdb(typedb, dbpath)) {
+	if (load_types_sdb(typedb, dbpath)) {
 		RZ_LOG_DEBUG("types: loaded \"%s\"\n", dbpath);
 	}
 	free(dbpath);
 	// C runtime types
 	dbpath = rz_file_path_join(types_dir, "types-libc.sdb");
-	if (rz_type_db_load_sdb(typedb, dbpath)) {
+	if (load_types_sdb(typedb, dbpath)) {
 		RZ_LOG_DEBUG("types: loaded \"%s\"\n", dbpath);
 	}
 	free(dbpath);
@@ -267,7 +296,7 @@ RZ_API void rz_type_db_init(RzTypeDB *typedb, const char *types_dir, const char
 	// Bits-specific types that are independent from architecture or OS
 	char tmp[100];
 	dbpath = rz_file_path_join(types_dir, rz_strf(tmp, "types-%d.sdb", bits));
-	if (rz_type_db_load_sdb(typedb, dbpath)) {
+	if (load_types_sdb(typedb, dbpath)) {
 		RZ_LOG_DEBUG("types: loaded \"%s\"\n", dbpath);
 	}
 	free(dbpath);
@@ -279,14 +308,14 @@ RZ_API void rz_type_db_init(RzTypeDB *typedb, const char *types_dir, const char
 
 	// Architecture-specific types
 	dbpath = rz_file_path_join(types_dir, rz_strf(tmp, "types-%s.sdb", arch));
-	if (rz_type_db_load_sdb(typedb, dbpath)) {
+	if (load_types_sdb(typedb, dbpath)) {
 		RZ_LOG_DEBUG("types: loaded \"%s\"\n", dbpath);
 	}
 	free(dbpath);
 
 	// Architecture- and bits-specific types
 	dbpath = rz_file_path_join(types_dir, rz_strf(tmp, "types-%s-%d.sdb", arch, bits));
-	if (rz_type_db_load_sdb(typedb, dbpath)) {
+	if (load_types_sdb(typedb, dbpath)) {
 		RZ_LOG_DEBUG("types: loaded \"%s\"\n", dbpath);
 	}
 	free(dbpath);
@@ -294,22 +323,22 @@ RZ_API void rz_type_db_init(RzTypeDB *typedb, const char *types_dir, const char
 	if (os) {
 		// OS-specific types
 		dbpath = rz_file_path_join(types_dir, rz_strf(tmp, "types-%s.sdb", os));
-		if (rz_type_db_load_sdb(typedb, dbpath)) {
+		if (load_types_sdb(typedb, dbpath)) {
 			RZ_LOG_DEBUG("types: loaded \"%s\"\n", dbpath);
 		}
 		free(dbpath);
 		dbpath = rz_file_path_join(types_dir, rz_strf(tmp, "types-%s-%d.sdb", os, bits));
-		if (rz_type_db_load_sdb(typedb, dbpath)) {
+		if (load_types_sdb(typedb, dbpath)) {
 			RZ_LOG_DEBUG("types: loaded \"%s\"\n", dbpath);
 		}
 		free(dbpath);
 		dbpath = rz_file_path_join(types_dir, rz_strf(tmp, "types-%s-%s.sdb", arch, os));
-		if (rz_type_db_load_sdb(typedb, dbpath)) {
+		if (load_types_sdb(typedb, dbpath)) {
 			RZ_LOG_DEBUG("types: loaded \"%s\"\n", dbpath);
 		}
 		free(dbpath);
 		dbpath = rz_file_path_join(types_dir, rz_strf(tmp, "types-%s-%s-%d.sdb", arch, os, bits));
-		if (rz_type_db_load_sdb(typedb, dbpath)) {
+		if (load_types_sdb(typedb, dbpath)) {
 			RZ_LOG_DEBUG("types: loaded \"%s\"\n", dbpath);
 		}
 		free(dbpath);
@@ -318,14 +347,14 @@ RZ_API void rz_type_db_init(RzTypeDB *typedb, const char *types_dir, const char
 	// Then, after all basic types are initialized, we load function types
 	// that use loaded previously base types for return and arguments
 	dbpath = rz_file_path_join(types_dir, "functions-libc.sdb");
-	if (rz_type_db_load_callables_sdb(typedb, dbpath)) {
+	if (load_callables_sdb(typedb, dbpath)) {
 		RZ_LOG_DEBUG("callable types: loaded \"%s\"\n", dbpath);
 	}
 	free(dbpath);
 	// OS-specific function types
 	if (os) {
 		dbpath = rz_file_path_join(types_dir, rz_strf(tmp, "functions-%s.sdb", os));
-		if (rz_type_db_load_callables_sdb(typedb, dbpath)) {
+		if (load_callables_sdb(typedb, dbpath)) {
 			RZ_LOG_DEBUG("callable types: loaded \"%s\"\n", dbpath);
 		}
 		free(dbpath);
@@ -545,11 +574,14 @@ RZ_API int rz_type_db_enum_member_by_name(const RzTypeDB *typedb, RZ_NONNULL con
  */
 RZ_API RZ_OWN RzList *rz_type_db_find_enums_by_val(const RzTypeDB *typedb, ut64 val) {
 	rz_return_val_if_fail(typedb, NULL);
-	RzList *enums = rz_type_db_get_base_types_of_kind(typedb, RZ_BASE_TYPE_KIND_ENUM);
 	RzList *result = rz_list_newf(free);
-	RzListIter *iter;
-	RzBaseType *e;
-	rz_list_foreach (enums, iter, e) {
+	const RzPVector *enums = rz_type_db_index_enums_by_val(typedb, val);
+	if (!enums) {
+		return result;
+	}
+	void **it;
+	rz_pvector_foreach (enums, it) {
+		RzBaseType *e = *it;
 		RzTypeEnumCase *cas;
 		rz_vector_foreach(&e->enum_data.cases, cas) {
 			if (cas->val == val) {
@@ -557,7 +589,6 @@ RZ_API RZ_OWN RzList *rz_type_db_find_enums_by_val(const RzTypeDB *typedb, ut64
 			}
 		}
 	}
-	rz_list_free(enums);
 	return result;
 }
 
@@ -1301,6 +1332,7 @@ RZ_API bool rz_type_db_edit_base_type(RzTypeDB *typedb, RZ_NONNULL const char *n
 	typedb->types->opt.freefn = NULL;
 	ht_pp_delete(typedb->types, t->name);
 	typedb->types->opt.freefn = freefn;
+	rz_type_db_invalidate_index(typedb);
 	char *error_msg = NULL;
 	int result = rz_type_parse_string_stateless(typedb->parser, typestr, &error_msg);
 	if (result) {
@@ -0,0 +1,35 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#ifndef RZ_TYPE_INTERNAL_H
+#define RZ_TYPE_INTERNAL_H
+
+#include <rz_type.h>
+#include <sdb.h>
+
+RZ_IPI RZ_BORROW const RzPVector /*<RzBaseType *>*/ *rz_type_db_index_enums_by_val(const RzTypeDB *typedb, ut64 val);
+RZ_IPI RZ_BORROW const RzPVector /*<RzBaseType *>*/ *rz_type_db_index_compounds_by_offset(const RzTypeDB *typedb, ut64 offset);
+RZ_IPI void rz_type_db_index_free(RZ_NULLABLE RzTypeDBIndex *index);
+RZ_IPI void rz_type_db_index_add(RZ_NONNULL const RzTypeDB *typedb, RZ_NONNULL RzBaseType *btype);
+RZ_IPI void rz_type_db_index_remove(RZ_NONNULL const RzTypeDB *typedb, RZ_NONNULL RzBaseType *btype);
+
+RZ_IPI bool rz_type_db_sdb_load_base_type(RzTypeDB *typedb, Sdb *sdb, const char *name);
+RZ_IPI bool rz_type_db_sdb_load_callable(RzTypeDB *typedb, Sdb *sdb, const char *name);
+
+RZ_IPI void rz_type_db_lazy_free(RZ_NULLABLE RzTypeDBLazy *lazy);
+RZ_IPI bool rz_type_db_lazy_add_types_sdb(RZ_NONNULL RzTypeDB *typedb, RZ_NONNULL const char *path);
+RZ_IPI bool rz_type_db_lazy_add_callables_sdb(RZ_NONNULL RzTypeDB *typedb, RZ_NONNULL const char *path);
+RZ_IPI RZ_BORROW RzBaseType *rz_type_db_lazy_base_type(RZ_NONNULL const RzTypeDB *typedb, RZ_NONNULL const char *name);
+RZ_IPI void rz_type_db_lazy_load_types(RZ_NONNULL const RzTypeDB *typedb);
+RZ_IPI void rz_type_db_lazy_load_enums_by_val(RZ_NONNULL const RzTypeDB *typedb, ut64 val);
+RZ_IPI void rz_type_db_lazy_load_compounds(RZ_NONNULL const RzTypeDB *typedb);
+RZ_IPI void rz_type_db_lazy_drop_type(RZ_NONNULL RzTypeDB *typedb, RZ_NONNULL const char *name);
+RZ_IPI RZ_BORROW RzCallable *rz_type_db_lazy_callable(RZ_NONNULL const RzTypeDB *typedb, RZ_NONNULL const char *name);
+RZ_IPI void rz_type_db_lazy_load_callables(RZ_NONNULL const RzTypeDB *typedb);
+RZ_IPI void rz_type_db_lazy_callable_names(RZ_NONNULL const RzTypeDB *typedb, RZ_NONNULL RzList /*<char *>*/ *names, bool noreturn);
+RZ_IPI void rz_type_db_lazy_drop_callable(RZ_NONNULL RzTypeDB *typedb, RZ_NONNULL const char *name);
+RZ_IPI void rz_type_db_lazy_drop_callables(RZ_NONNULL RzTypeDB *typedb);
+
+RZ_IPI void rz_type_parser_set_typedb(RZ_NONNULL RzTypeParser *parser, RZ_NULLABLE RzTypeDB *typedb);
+
+#endif
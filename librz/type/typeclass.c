@@ -5,6 +5,8 @@
 #include <rz_type.h>
 #include <string.h>
 
+#include "type_internal.h"
+
 /** \file typeclass.c
  *
  * Atomic types are split into the various type classes
@@ -338,6 +340,7 @@ static bool base_type_typeclass_sized_collect_cb(void *user, const void *k, cons
 RZ_API RZ_OWN RzList *rz_type_typeclass_get_all(const RzTypeDB *typedb, RzTypeTypeclass typeclass) {
 	rz_return_val_if_fail(typedb && typeclass != RZ_TYPE_TYPECLASS_NONE, NULL);
 	rz_return_val_if_fail(typeclass < RZ_TYPE_TYPECLASS_INVALID, NULL);
+	rz_type_db_lazy_load_types(typedb);
 	RzList *types = rz_list_new();
 	struct list_typeclass lt = { typedb, types, typeclass };
 	ht_pp_foreach(typedb->types, base_type_typeclass_collect_cb, &lt);
@@ -354,6 +357,7 @@ RZ_API RZ_OWN RzList *rz_type_typeclass_get_all(const RzTypeDB *typedb, RzTypeTy
 RZ_API RZ_OWN RzList *rz_type_typeclass_get_all_sized(const RzTypeDB *typedb, RzTypeTypeclass typeclass, size_t size) {
 	rz_return_val_if_fail(typedb && typeclass != RZ_TYPE_TYPECLASS_NONE, NULL);
 	rz_return_val_if_fail(size && typeclass < RZ_TYPE_TYPECLASS_INVALID, NULL);
+	rz_type_db_lazy_load_types(typedb);
 	RzList *types = rz_list_new();
 	struct list_typeclass_size lt = { typedb, types, typeclass, size };
 	ht_pp_foreach(typedb->types, base_type_typeclass_sized_collect_cb, &lt);
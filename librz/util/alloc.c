@@ -73,3 +73,125 @@ RZ_API void *rz_malloc_aligned(size_t size, size_t alignment) {
 RZ_API void rz_free_aligned(void *p) {
 	_r_free(((void **)p)[-1]);
 }
+
+/*
+ * Allocation profiler: counts the allocations and the bytes by site, where
+ * a site is the name given by the allocator (e.g. the name of a RzSlab) or
+ * by a frequent allocation (list nodes, bitvectors, xrefs).
+ * The counters are updated only while the profiler is enabled.
+ */
+
+typedef struct {
+	const char *site;
+	ut64 allocs;
+	ut64 frees;
+	ut64 bytes; ///< bytes allocated in total
+	ut64 live; ///< bytes allocated and not freed
+	ut64 peak; ///< maximum of live
+} AllocProfSite;
+
+static bool prof_enabled;
+static RzThreadLock *prof_lock;
+static RzVector /*<AllocProfSite>*/ prof_sites;
+
+/**
+ * \brief Enables or disables the allocation profiler, keeping its counters
+ */
+RZ_API void rz_alloc_prof_enable(bool enable) {
+	if (enable && !prof_lock) {
+		prof_lock = rz_th_lock_new(false);
+		if (!prof_lock) {
+			return;
+		}
+		rz_vector_init(&prof_sites, sizeof(AllocProfSite), NULL, NULL);
+	}
+	prof_enabled = enable;
+}
+
+RZ_API bool rz_alloc_prof_enabled(void) {
+	return prof_enabled;
+}
+
+static AllocProfSite *prof_site(const char *site) {
+	AllocProfSite *s;
+	rz_vector_foreach(&prof_sites, s) {
+		if (s->site == site || !strcmp(s->site, site)) {
+			return s;
+		}
+	}
+	s = rz_vector_push(&prof_sites, NULL);
+	if (s) {
+		memset(s, 0, sizeof(*s));
+		s->site = site;
+	}
+	return s;
+}
+
+/**
+ * \brief Counts an allocation (or a free, if \p alloc is false) of \p size bytes from \p site
+ *
+ * \p site must be a string living as long as the profiler counters, usually a literal.
+ */
+RZ_API void rz_alloc_prof_record(RZ_NONNULL const char *site, size_t size, bool alloc) {
+	rz_return_if_fail(site);
+	if (!prof_enabled) {
+		return;
+	}
+	rz_th_lock_enter(prof_lock);
+	AllocProfSite *s = prof_site(site);
+	if (s && alloc) {
+		s->allocs++;
+		s->bytes += size;
+		s->live += size;
+		s->peak = RZ_MAX(s->peak, s->live);
+	} else if (s) {
+		s->frees++;
+		// objects allocated before enabling the profiler can be freed
+		s->live -= RZ_MIN(s->live, size);
+	}
+	rz_th_lock_leave(prof_lock);
+}
+
+/**
+ * \brief Clears the counters of the allocation profiler
+ */
+RZ_API void rz_alloc_prof_reset(void) {
+	if (!prof_lock) {
+		return;
+	}
+	rz_th_lock_enter(prof_lock);
+	rz_vector_clear(&prof_sites);
+	rz_th_lock_leave(prof_lock);
+}
+
+static int prof_site_cmp(const void *a, const void *b) {
+	const AllocProfSite *sa = a, *sb = b;
+	return sa->bytes < sb->bytes ? 1 : sa->bytes > sb->bytes ? -1 : strcmp(sa->site, sb->site);
+}
+
+/**
+ * \brief Returns a table with the counters of the allocation profiler by site,
+ * sorted by the bytes allocated
+ */
+RZ_API RZ_OWN char *rz_alloc_prof_report(void) {
+	RzStrBuf *sb = rz_strbuf_new(NULL);
+	if (!sb) {
+		return NULL;
+	}
+	rz_strbuf_appendf(sb, "%-24s %12s %12s %14s %14s %14s\n", "site", "allocs", "frees", "bytes", "live", "peak");
+	if (prof_lock) {
+		rz_th_lock_enter(prof_lock);
+		RzVector *sites = rz_vector_clone(&prof_sites);
+		rz_th_lock_leave(prof_lock);
+		if (sites && sites->len) {
+			qsort(sites->a, sites->len, sites->elem_size, prof_site_cmp);
+			AllocProfSite *s;
+			rz_vector_foreach(sites, s) {
+				rz_strbuf_appendf(sb, "%-24s %12" PFMT64u " %12" PFMT64u " %14" PFMT64u " %14" PFMT64u " %14" PFMT64u "\n",
+					s->site, s->allocs, s->frees, s->bytes, s->live, s->peak);
+			}
+		}
+		rz_vector_free(sites);
+	}
+	return rz_strbuf_drain(sb);
+}
@@ -7,6 +7,8 @@
 
 #define NELEM(N, ELEMPER) ((N + (ELEMPER)-1) / (ELEMPER))
 #define BV_ELEM_SIZE      8U
+#define BV_SITE           "bitvector"
+#define BV_LARGE_SITE     "bitvector.large"
 
 /**
  * \brief Initialize a RzBitVector structure
@@ -26,6 +28,9 @@ RZ_API bool rz_bv_init(RZ_NONNULL RzBitVector *bv, ut32 length) {
 		}
 		bv->bits.large_a = tmp;
 		bv->_elem_len = real_elem_cnt;
+		if (rz_alloc_prof_enabled()) {
+			rz_alloc_prof_record(BV_LARGE_SITE, real_elem_cnt, true);
+		}
 	}
 	bv->len = length;
 	return true;
@@ -37,6 +42,9 @@ RZ_API bool rz_bv_init(RZ_NONNULL RzBitVector *bv, ut32 length) {
 RZ_API void rz_bv_fini(RZ_NONNULL RzBitVector *bv) {
 	rz_return_if_fail(bv);
 	if (bv->len > 64) {
+		if (rz_alloc_prof_enabled()) {
+			rz_alloc_prof_record(BV_LARGE_SITE, bv->_elem_len, false);
+		}
 		free(bv->bits.large_a);
 	}
 	memset(bv, 0, sizeof(RzBitVector));
@@ -54,6 +62,9 @@ RZ_API RZ_OWN RzBitVector *rz_bv_new(ut32 length) {
 		free(bv);
 		return NULL;
 	}
+	if (rz_alloc_prof_enabled()) {
+		rz_alloc_prof_record(BV_SITE, sizeof(RzBitVector), true);
+	}
 	return bv;
 }
 
@@ -66,6 +77,9 @@ RZ_API void rz_bv_free(RZ_NULLABLE RzBitVector *bv) {
 		return;
 	}
 	rz_bv_fini(bv);
+	if (rz_alloc_prof_enabled()) {
+		rz_alloc_prof_record(BV_SITE, sizeof(RzBitVector), false);
+	}
 	free(bv);
 }
 
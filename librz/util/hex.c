@@ -380,14 +380,14 @@ RZ_API int rz_hex_pair2bin(const char *arg) {
 }
 
 RZ_API int rz_hex_bin2str(const ut8 *in, int len, char *out) {
+	static const char digits[16] = "0123456789abcdef";
 	int i, idx;
-	char tmp[8];
 	if (len < 0) {
 		return 0;
 	}
 	for (idx = i = 0; i < len; i++, idx += 2) {
-		snprintf(tmp, sizeof(tmp), "%02x", in[i]);
-		memcpy(out + idx, tmp, 2);
+		out[idx] = digits[in[i] >> 4];
+		out[idx + 1] = digits[in[i] & 0xf];
 	}
 	out[idx] = 0;
 	return len;
@@ -5,6 +5,23 @@
 #include <stdio.h>
 #include "rz_util.h"
 
+#define LIST_NODE_SITE "list.node"
+
+static inline RzListIter *list_node_new(bool zero) {
+	RzListIter *item = zero ? RZ_NEW0(RzListIter) : RZ_NEW(RzListIter);
+	if (item && rz_alloc_prof_enabled()) {
+		rz_alloc_prof_record(LIST_NODE_SITE, sizeof(RzListIter), true);
+	}
+	return item;
+}
+
+static inline void list_node_free(RzListIter *item) {
+	if (rz_alloc_prof_enabled()) {
+		rz_alloc_prof_record(LIST_NODE_SITE, sizeof(RzListIter), false);
+	}
+	free(item);
+}
+
 inline RzListIter *rz_list_iter_new(void) {
 	return calloc(1, sizeof(RzListIter));
 }
@@ -166,7 +183,7 @@ RZ_API void rz_list_delete(RzList *list, RzListIter *iter) {
 		list->free(iter->data);
 	}
 	iter->data = NULL;
-	free(iter);
+	list_node_free(iter);
 }
 
 RZ_API void rz_list_split(RzList *list, void *ptr) {
@@ -177,7 +194,7 @@ RZ_API void rz_list_split(RzList *list, void *ptr) {
 		void *item = iter->data;
 		if (ptr == item) {
 			rz_list_split_iter(list, iter);
-			free(iter);
+			list_node_free(iter);
 			break;
 		}
 		iter = iter->n;
@@ -274,7 +291,7 @@ RZ_API RzList *rz_list_new_from_array(const void **arr, size_t arr_size) {
  *
  **/
 RZ_API RzListIter *rz_list_item_new(void *data) {
-	RzListIter *item = RZ_NEW0(RzListIter);
+	RzListIter *item = list_node_new(true);
 	if (item) {
 		item->data = data;
 	}
@@ -290,7 +307,7 @@ RZ_API RzListIter *rz_list_append(RzList *list, void *data) {
 
 	rz_return_val_if_fail(list, NULL);
 
-	item = RZ_NEW(RzListIter);
+	item = list_node_new(false);
 	if (!item) {
 		return item;
 	}
@@ -316,7 +333,7 @@ RZ_API RzListIter *rz_list_append(RzList *list, void *data) {
 RZ_API RzListIter *rz_list_prepend(RzList *list, void *data) {
 	rz_return_val_if_fail(list, NULL);
 
-	RzListIter *item = RZ_NEW0(RzListIter);
+	RzListIter *item = list_node_new(true);
 	if (!item) {
 		return NULL;
 	}
@@ -350,7 +367,7 @@ RZ_API RzListIter *rz_list_insert(RzList *list, ut32 n, void *data) {
 	}
 	for (it = list->head, i = 0; it && it->data; it = it->n, i++) {
 		if (i == n) {
-			item = RZ_NEW(RzListIter);
+			item = list_node_new(false);
 			if (!item) {
 				return NULL;
 			}
@@ -388,7 +405,7 @@ RZ_API void *rz_list_pop(RzList *list) {
 			list->tail->n = NULL;
 		}
 		data = iter->data;
-		free(iter);
+		list_node_free(iter);
 		list->length--;
 	}
 	return data;
@@ -412,7 +429,7 @@ RZ_API void *rz_list_pop_head(RzList *list) {
 			list->head->p = NULL;
 		}
 		data = iter->data;
-		free(iter);
+		list_node_free(iter);
 		list->length--;
 	}
 	return data;
@@ -442,7 +459,7 @@ RZ_API ut32 rz_list_del_n(RzList *list, ut32 n) {
 				it->p->n = it->n;
 				it->n->p = it->p;
 			}
-			free(it);
+			list_node_free(it);
 			list->length--;
 			return true;
 		}
@@ -524,7 +541,7 @@ RZ_API RzListIter *rz_list_add_sorted(RzList *list, void *data, RzListComparator
 		;
 	}
 	if (it) {
-		item = RZ_NEW0(RzListIter);
+		item = list_node_new(true);
 		if (!item) {
 			return NULL;
 		}
@@ -270,14 +270,12 @@ RZ_API void rz_print_cursor(RzPrint *p, int cur, int len, int set) {
 	}
 }
 
-RZ_API void rz_print_addr(RzPrint *p, ut64 addr) {
+static void print_addr_append(RzPrint *p, RzStrBuf *sb, ut64 addr) {
 	char space[32] = {
 		0
 	};
 	const char *white = "";
 #define PREOFF(x) (p && p->cons && p->cons->context && p->cons->context->pal.x) ? p->cons->context->pal.x
-	PrintfCallback printfmt = (PrintfCallback)(p ? p->cb_printf : libc_printf);
-#define print(x) printfmt("%s", x)
 	bool use_segoff = p ? (p->flags & RZ_PRINT_FLAGS_SEGOFF) : false;
 	bool use_color = p ? (p->flags & RZ_PRINT_FLAGS_COLOR) : false;
 	bool dec = p ? (p->flags & RZ_PRINT_FLAGS_ADDRDEC) : false;
@@ -305,15 +303,15 @@ RZ_API void rz_print_addr(RzPrint *p, ut64 addr) {
 			    : Color_GREEN;
 			const char *fin = Color_RESET;
 			if (dec) {
-				printfmt("%s%s%s%s%c", pre, white, space, fin, ch);
+				rz_strbuf_appendf(sb, "%s%s%s%s%c", pre, white, space, fin, ch);
 			} else {
-				printfmt("%s%04x:%04x%s%c", pre, s & 0xffff, a & 0xffff, fin, ch);
+				rz_strbuf_appendf(sb, "%s%04x:%04x%s%c", pre, s & 0xffff, a & 0xffff, fin, ch);
 			}
 		} else {
 			if (dec) {
-				printfmt("%s%s%c", white, space, ch);
+				rz_strbuf_appendf(sb, "%s%s%c", white, space, ch);
 			} else {
-				printfmt("%04x:%04x%c", s & 0xffff, a & 0xffff, ch);
+				rz_strbuf_appendf(sb, "%04x:%04x%c", s & 0xffff, a & 0xffff, ch);
 			}
 		}
 	} else {
@@ -334,30 +332,39 @@ RZ_API void rz_print_addr(RzPrint *p, ut64 addr) {
 				}
 			}
 			if (dec) {
-				printfmt("%s%s%" PFMT64d "%s%c", pre, white, addr, fin, ch);
+				rz_strbuf_appendf(sb, "%s%s%" PFMT64d "%s%c", pre, white, addr, fin, ch);
 			} else {
 				if (p && p->wide_offsets) {
 					// TODO: make %016 depend on asm.bits
-					printfmt("%s0x%016" PFMT64x "%s%c", pre, addr, fin, ch);
+					rz_strbuf_appendf(sb, "%s0x%016" PFMT64x "%s%c", pre, addr, fin, ch);
 				} else {
-					printfmt("%s0x%08" PFMT64x "%s%c", pre, addr, fin, ch);
+					rz_strbuf_appendf(sb, "%s0x%08" PFMT64x "%s%c", pre, addr, fin, ch);
 				}
 			}
 		} else {
 			if (dec) {
-				printfmt("%s%" PFMT64d "%c", white, addr, ch);
+				rz_strbuf_appendf(sb, "%s%" PFMT64d "%c", white, addr, ch);
 			} else {
 				if (p && p->wide_offsets) {
 					// TODO: make %016 depend on asm.bits
-					printfmt("0x%016" PFMT64x "%c", addr, ch);
+					rz_strbuf_appendf(sb, "0x%016" PFMT64x "%c", addr, ch);
 				} else {
-					printfmt("0x%08" PFMT64x "%c", addr, ch);
+					rz_strbuf_appendf(sb, "0x%08" PFMT64x "%c", addr, ch);
 				}
 			}
 		}
 	}
 }
 
+RZ_API void rz_print_addr(RzPrint *p, ut64 addr) {
+	PrintfCallback printfmt = (PrintfCallback)(p ? p->cb_printf : libc_printf);
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	print_addr_append(p, &sb, addr);
+	printfmt("%s", rz_strbuf_get(&sb));
+	rz_strbuf_fini(&sb);
+}
+
 RZ_API char *rz_print_hexpair(RzPrint *p, const char *str, int n) {
 	const char *s, *lastcol = Color_WHITE;
 	char *d, *dst = (char *)calloc((strlen(str) + 2), 32);
@@ -675,6 +682,168 @@ RZ_API void rz_print_section(RzPrint *p, ut64 at) {
 	}
 }
 
+#define HEXDUMP_CHUNK_SIZE (64 * 1024)
+
+static const char hex_lower[16] = "0123456789abcdef";
+
+/**
+ * Whether the rows of a hexdump can be written by hexdump_rows(), which
+ * supports the plain hexadecimal byte or 32-bit word columns and the ascii
+ * column only.
+ */
+static bool hexdump_rows_supported(RzPrint *p, int base, int step, int inc, int len) {
+	const int unsupported = RZ_PRINT_FLAGS_SPARSE | RZ_PRINT_FLAGS_ALIGN | RZ_PRINT_FLAGS_UNALLOC |
+		RZ_PRINT_FLAGS_REFS | RZ_PRINT_FLAGS_STYLE | RZ_PRINT_FLAGS_NONHEX | RZ_PRINT_FLAGS_RAINBOW |
+		RZ_PRINT_FLAGS_SECTION;
+	if (!p || (p->flags & unsupported) || p->col || p->stride || p->cur_enabled || p->use_comments ||
+		(p->cfmt && *p->cfmt)) {
+		return false;
+	}
+	// words only when the rows hold whole ones, as the generic loop skips the partial ones
+	return base == 16 || (base == 32 && step == 4 && !(inc % 4) && !(len % 4));
+}
+
+/* color of the 32-bit word \p n read at \p addr, as picked by the generic loop */
+static const char *hexdump_word_color(RzPrint *p, ut64 addr, ut32 n) {
+	if (!p->colorfor) {
+		return "";
+	}
+	const char *color = !p->iob.addr_is_mapped(p->iob.io, addr)
+		? p->cons->context->pal.ai_unmap
+		: p->colorfor(p->user, n, true);
+	return color ? color : "";
+}
+
+/**
+ * Writes the rows of a hexdump like the generic loop of rz_print_hexdump(),
+ * formatting the bytes through lookup tables into chunks of output rather
+ * than with a printf call for each byte and color. With \p base 32, the hex
+ * columns show 32-bit words.
+ */
+static void hexdump_rows(RzPrint *p, ut64 addr, const ut8 *buf, int len, int base, int inc, size_t zoomsz) {
+	const bool use_color = p->flags & RZ_PRINT_FLAGS_COLOR;
+	const bool use_offset = p->flags & RZ_PRINT_FLAGS_OFFSET;
+	const bool use_ascii = !(p->flags & RZ_PRINT_FLAGS_NONASCII);
+	const bool compact = p->flags & RZ_PRINT_FLAGS_COMPACT;
+	const bool pairs = p->pairs;
+	const bool words = base == 32;
+	const size_t reset_len = strlen(Color_RESET);
+	const char *colors[256] = { 0 };
+	ut8 colors_len[256] = { 0 };
+	char ascii[256];
+	size_t max_color = 0;
+	for (int ch = 0; ch < 256; ch++) {
+		ascii[ch] = IS_PRINTABLE(ch) ? ch : '.';
+		if (use_color) {
+			colors[ch] = rz_print_byte_color(p, ch);
+			size_t clen = colors[ch] ? strlen(colors[ch]) : 0;
+			colors_len[ch] = RZ_MIN(clen, UT8_MAX);
+			max_color = RZ_MAX(max_color, colors_len[ch]);
+		}
+	}
+	// a byte takes at most 3 columns in the hex part and 1 in the ascii one, plus the colors,
+	// and a word 11 columns and a reset, its color being appended on its own
+	size_t byte_max = use_color ? max_color + reset_len : 0;
+	char *row = malloc(3 + (size_t)inc * (2 * byte_max + 4 + reset_len));
+	if (!row) {
+		return;
+	}
+	RzStrBuf out;
+	rz_strbuf_init(&out);
+	rz_strbuf_reserve(&out, HEXDUMP_CHUNK_SIZE);
+	int i, j, rows = 0;
+	for (i = 0; i < len; i += inc, rows++) {
+		if (p->cons && p->cons->context && p->cons->context->breaked) {
+			break;
+		}
+		if (use_offset) {
+			print_addr_append(p, &out, addr + i * zoomsz);
+		}
+		char *w = row;
+		if (!compact) {
+			*w++ = ' ';
+		}
+		for (j = i; j < i + inc; j++) {
+			if (j >= len) {
+				if (compact) {
+					break;
+				}
+				int pad = words ? (j % 4 ? 3 : 2) : (j % 2 ? 3 : 2);
+				memcpy(w, "   ", pad);
+				w += pad;
+				continue;
+			}
+			if (words) {
+				ut32 n = rz_read_ble32(buf + j, p->big_endian);
+				const char *color = hexdump_word_color(p, addr + j, n);
+				if (*color) {
+					rz_strbuf_append_n(&out, row, w - row);
+					rz_strbuf_append(&out, color);
+					w = row;
+				}
+				*w++ = '0';
+				*w++ = 'x';
+				for (int shift = 28; shift >= 0; shift -= 4) {
+					*w++ = hex_lower[(n >> shift) & 0xf];
+				}
+				if (*color) {
+					memcpy(w, Color_RESET, reset_len);
+					w += reset_len;
+				}
+				*w++ = ' ';
+				j += 3;
+				continue;
+			}
+			ut8 ch = buf[j];
+			if (colors[ch]) {
+				memcpy(w, colors[ch], colors_len[ch]);
+				w += colors_len[ch];
+			}
+			*w++ = hex_lower[ch >> 4];
+			*w++ = hex_lower[ch & 0xf];
+			if (colors[ch]) {
+				memcpy(w, Color_RESET, reset_len);
+				w += reset_len;
+			}
+			if (pairs && !compact && (inc & 1)) {
+				if ((rows % 2) ? !(j & 1) : (j & 1)) {
+					*w++ = ' ';
+				}
+			} else if (((j - i) % 2 || !pairs) && !compact) {
+				*w++ = ' ';
+			}
+		}
+		*w++ = ' ';
+		if (use_ascii) {
+			for (j = i; j < i + inc && j < len; j++) {
+				ut8 ch = buf[j];
+				if (colors[ch]) {
+					memcpy(w, colors[ch], colors_len[ch]);
+					w += colors_len[ch];
+				}
+				*w++ = ascii[ch];
+				if (colors[ch]) {
+					memcpy(w, Color_RESET, reset_len);
+					w += reset_len;
+				}
+			}
+		}
+		*w++ = '\n';
+		rz_strbuf_append_n(&out, row, w - row);
+		if (rz_strbuf_length(&out) >= HEXDUMP_CHUNK_SIZE) {
+			p->cb_printf("%s", rz_strbuf_get(&out));
+			rz_strbuf_fini(&out);
+			rz_strbuf_init(&out);
+			rz_strbuf_reserve(&out, HEXDUMP_CHUNK_SIZE);
+		}
+	}
+	if (rz_strbuf_length(&out)) {
+		p->cb_printf("%s", rz_strbuf_get(&out));
+	}
+	rz_strbuf_fini(&out);
+	free(row);
+}
+
 RZ_API void rz_print_hexdump(RzPrint *p, ut64 addr, const ut8 *buf, int len, int base, int step, size_t zoomsz) {
 	rz_return_if_fail(p && buf && len > 0);
 	PrintfCallback printfmt = (PrintfCallback)printf;
@@ -888,6 +1057,10 @@ RZ_API void rz_print_hexdump(RzPrint *p, ut64 addr, const ut8 *buf, int len, int
 
 	// is this necessary?
 	rz_print_set_screenbounds(p, addr);
+	if (hexdump_rows_supported(p, base, step, inc, len)) {
+		hexdump_rows(p, addr, buf, len, base, inc, zoomsz);
+		return;
+	}
 	int rowbytes;
 	int rows = 0;
 	int bytes = 0;
@@ -1339,6 +1512,21 @@ RZ_API void rz_print_hexdiff(RzPrint *p, ut64 aa, const ut8 *_a, ut64 ba, const
 RZ_API void rz_print_bytes(RzPrint *p, const ut8 *buf, int len, const char *fmt) {
 	rz_return_if_fail(fmt);
 	int i;
+	if (!strcmp(fmt, "%02x") && len > 0) {
+		// hexpairs are encoded by chunks, not with a printf call for each byte
+		PrintfCallback printfmt = (PrintfCallback)(p ? p->cb_printf : libc_printf);
+		const int chunk = HEXDUMP_CHUNK_SIZE / 2;
+		char *out = malloc(HEXDUMP_CHUNK_SIZE + 1);
+		if (out) {
+			for (i = 0; i < len; i += chunk) {
+				rz_hex_bin2str(buf + i, RZ_MIN(chunk, len - i), out);
+				printfmt("%s", out);
+			}
+			printfmt("\n");
+			free(out);
+			return;
+		}
+	}
 	if (p) {
 		for (i = 0; i < len; i++) {
 			p->cb_printf(fmt, buf[i]);
@@ -65,6 +65,41 @@ static void print_c_instructions(RzPrint *p, ut64 addr, const ut8 *buf, int len)
 	p->cb_printf("};\n");
 }
 
+/**
+ * Writes the elements of a byte array a row at a time, with the same
+ * output of the generic loop of print_c_code() without a cursor.
+ */
+static void print_c_bytes(RzPrint *p, const ut8 *buf, int len, int w) {
+	static const char digits[16] = "0123456789abcdef";
+	char *row = malloc(3 + (size_t)w * 6);
+	if (!row) {
+		return;
+	}
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	for (int i = 0; !rz_print_is_interrupted() && i < len; i += w) {
+		char *o = row;
+		memcpy(o, "\n  ", 3);
+		o += 3;
+		for (int k = i; k < i + w && k < len; k++) {
+			*o++ = '0';
+			*o++ = 'x';
+			*o++ = digits[buf[k] >> 4];
+			*o++ = digits[buf[k] & 0xf];
+			if (k + 1 < len) {
+				*o++ = ',';
+				if ((k + 1) % w) {
+					*o++ = ' ';
+				}
+			}
+		}
+		rz_strbuf_append_n(&sb, row, o - row);
+	}
+	p->cb_printf("%s", rz_strbuf_get(&sb));
+	rz_strbuf_fini(&sb);
+	free(row);
+}
+
 static void print_c_code(RzPrint *p, ut64 addr, const ut8 *buf, int len, int ws, int w) {
 	size_t i;
 
@@ -76,6 +111,12 @@ static void print_c_code(RzPrint *p, ut64 addr, const ut8 *buf, int len, int ws,
 	p->cb_printf("#define _BUFFER_SIZE %d\n", len);
 	p->cb_printf("const uint%d_t buffer[_BUFFER_SIZE] = {", bits);
 
+	if (ws == 1 && !p->cur_enabled) {
+		print_c_bytes(p, buf, len, w);
+		p->cb_printf("\n};\n");
+		return;
+	}
+
 	for (i = 0; !rz_print_is_interrupted() && i < len; i++) {
 		if (!(i % w)) {
 			p->cb_printf("\n  ");
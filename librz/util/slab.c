@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+
+#define SLAB_ALIGN 16
+
+// the objects are allocated one by one with sanitizers, to keep their checks
+#if defined(__SANITIZE_ADDRESS__)
+#define SLAB_PASSTHROUGH 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define SLAB_PASSTHROUGH 1
+#endif
+#endif
+#ifndef SLAB_PASSTHROUGH
+#define SLAB_PASSTHROUGH 0
+#endif
+
+/**
+ * Header of the objects allocated one by one, linking them in slab->pages
+ * so that they are freed with the slab like the pages.
+ */
+typedef struct slab_obj_t {
+	struct slab_obj_t *next; ///< first, as the header of the pages
+	struct slab_obj_t *prev;
+} SlabObj;
+
+/**
+ * \brief Creates a slab of objects of \p obj_size bytes
+ *
+ * \param obj_size size of the objects
+ * \param page_objs number of objects allocated at once, 0 for a default
+ * \param name name of the slab in the report of the allocation profiler, or NULL to not profile it
+ */
+RZ_API RZ_OWN RzSlab *rz_slab_new(size_t obj_size, size_t page_objs, RZ_NULLABLE const char *name) {
+	rz_return_val_if_fail(obj_size, NULL);
+	RzSlab *slab = RZ_NEW0(RzSlab);
+	if (!slab) {
+		return NULL;
+	}
+	slab->name = name;
+	slab->obj_size = RZ_MAX(obj_size, sizeof(void *));
+	slab->obj_size = (slab->obj_size + SLAB_ALIGN - 1) & ~(size_t)(SLAB_ALIGN - 1);
+	slab->page_objs = page_objs ? page_objs : RZ_MAX(4096 / slab->obj_size, 8);
+	return slab;
+}
+
+/**
+ * \brief Frees the slab together with all the objects allocated from it
+ */
+RZ_API void rz_slab_free(RZ_NULLABLE RzSlab *slab) {
+	if (!slab) {
+		return;
+	}
+	if (slab->name && slab->count && rz_alloc_prof_enabled()) {
+		rz_alloc_prof_record(slab->name, slab->count * slab->obj_size, false);
+	}
+	// with SLAB_PASSTHROUGH, the pages are the objects not released
+	void *page = slab->pages;
+	while (page) {
+		void *next = *(void **)page;
+		free(page);
+		page = next;
+	}
+	free(slab);
+}
+
+static void *slab_page_new(RzSlab *slab) {
+	if (SIZE_MAX / slab->obj_size <= slab->page_objs) {
+		return NULL;
+	}
+	ut8 *page = malloc(SLAB_ALIGN + slab->obj_size * slab->page_objs);
+	if (!page) {
+		return NULL;
+	}
+	*(void **)page = slab->pages;
+	slab->pages = page;
+	slab->next = page + SLAB_ALIGN;
+	slab->end = slab->next + slab->obj_size * slab->page_objs;
+	return page;
+}
+
+static void *slab_obj_new(RzSlab *slab) {
+	SlabObj *hdr = malloc(SLAB_ALIGN + slab->obj_size);
+	if (!hdr) {
+		return NULL;
+	}
+	hdr->next = slab->pages;
+	hdr->prev = NULL;
+	if (hdr->next) {
+		hdr->next->prev = hdr;
+	}
+	slab->pages = hdr;
+	return (ut8 *)hdr + SLAB_ALIGN;
+}
+
+static void slab_obj_free(RzSlab *slab, void *obj) {
+	SlabObj *hdr = (SlabObj *)((ut8 *)obj - SLAB_ALIGN);
+	if (hdr->prev) {
+		hdr->prev->next = hdr->next;
+	} else {
+		slab->pages = hdr->next;
+	}
+	if (hdr->next) {
+		hdr->next->prev = hdr->prev;
+	}
+	free(hdr);
+}
+
+/**
+ * \brief Allocates an object from the slab, with undefined contents
+ */
+RZ_API RZ_OWN void *rz_slab_alloc(RZ_NONNULL RzSlab *slab) {
+	rz_return_val_if_fail(slab, NULL);
+	void *obj;
+	if (SLAB_PASSTHROUGH) {
+		obj = slab_obj_new(slab);
+	} else if (slab->free_list) {
+		obj = slab->free_list;
+		slab->free_list = *(void **)obj;
+	} else {
+		if (slab->next == slab->end && !slab_page_new(slab)) {
+			return NULL;
+		}
+		obj = slab->next;
+		slab->next += slab->obj_size;
+	}
+	if (!obj) {
+		return NULL;
+	}
+	slab->count++;
+	if (slab->name && rz_alloc_prof_enabled()) {
+		rz_alloc_prof_record(slab->name, slab->obj_size, true);
+	}
+	return obj;
+}
+
+/**
+ * \brief Allocates an object from the slab, filled with zeros
+ */
+RZ_API RZ_OWN void *rz_slab_alloc0(RZ_NONNULL RzSlab *slab) {
+	void *obj = rz_slab_alloc(slab);
+	if (obj) {
+		memset(obj, 0, slab->obj_size);
+	}
+	return obj;
+}
+
+/**
+ * \brief Releases \p obj, allocated from \p slab, which is reused by the next allocations
+ */
+RZ_API void rz_slab_release(RZ_NONNULL RzSlab *slab, RZ_NULLABLE void *obj) {
+	rz_return_if_fail(slab);
+	if (!obj) {
+		return;
+	}
+	if (SLAB_PASSTHROUGH) {
+		slab_obj_free(slab, obj);
+	} else {
+		*(void **)obj = slab->free_list;
+		slab->free_list = obj;
+	}
+	slab->count--;
+	if (slab->name && rz_alloc_prof_enabled()) {
+		rz_alloc_prof_record(slab->name, slab->obj_size, false);
+	}
+}
@@ -739,6 +739,66 @@ bool test_rz_analysis_block_analyze_ops(void) {
 	mu_end;
 }
 
+/**
+ * Checks that rz_analysis_block_analyze_ops() finds the same ops of a
+ * plain rz_analysis_op() loop over \p size bytes of \p code
+ */
+static bool check_analyze_ops_batch(const char *arch, int bits, const ut8 *code, size_t len, ut64 size) {
+	RzAnalysis *a = rz_analysis_new();
+	rz_analysis_use(a, arch);
+	rz_analysis_set_bits(a, bits);
+	IOMock io;
+	io_mock_init(&io, 0x1000, code, len);
+	io_mock_bind(&io, &a->iob);
+
+	ut64 expect[0x100];
+	size_t n = 0;
+	ut64 addr = 0x1000;
+	while (addr < 0x1000 + size && n < RZ_ARRAY_SIZE(expect)) {
+		RzAnalysisOp op;
+		int ret = rz_analysis_op(a, &op, addr, code + (addr - 0x1000), 0x1000 + size - addr, 0);
+		int op_size = op.size;
+		rz_analysis_op_fini(&op);
+		if (ret <= 0) {
+			break;
+		}
+		expect[n++] = addr;
+		addr += op_size > 0 ? op_size : 1;
+	}
+	mu_assert_true(n > 16, "more ops than a batch");
+
+	RzAnalysisBlock *block = rz_analysis_create_block(a, 0x1000, size);
+	rz_analysis_block_analyze_ops(block);
+	mu_assert_eq(block->ninstr, n, "ninstr");
+	for (size_t i = 0; i < n; i++) {
+		mu_assert_eq(rz_analysis_block_get_op_addr(block, i), expect[i], "op addr");
+	}
+	rz_analysis_block_unref(block);
+
+	rz_analysis_free(a);
+	io_mock_fini(&io);
+	mu_end;
+}
+
+bool test_rz_analysis_block_analyze_ops_batch(void) {
+	ut8 x86[0x60];
+	for (size_t i = 0; i + 3 <= 0x30; i += 3) {
+		memcpy(x86 + i, "\x48\x89\xc2", 3); // mov rdx, rax
+	}
+	memset(x86 + 0x30, 0x90, 0x20); // nop
+	memcpy(x86 + 0x50, "\x48\xc7\xc0\x37\x13\x00\x00", 7); // mov rax, 0x1337
+	memcpy(x86 + 0x57, "\x06\x90\x90\x90\x90\x90\x90\x90\x90", 9); // invalid
+	mu_assert_true(check_analyze_ops_batch("x86", 64, x86, sizeof(x86), sizeof(x86)), "x86 ops ending with invalid code");
+	mu_assert_true(check_analyze_ops_batch("x86", 64, x86, sizeof(x86), 0x56), "x86 ops ending with a truncated op");
+	ut8 arm[0x50];
+	for (size_t i = 0; i < sizeof(arm); i += 4) {
+		memcpy(arm + i, "\x00\x00\xa0\xe3", 4); // mov r0, 0
+	}
+	mu_assert_true(check_analyze_ops_batch("arm", 32, arm, sizeof(arm), sizeof(arm)), "arm ops");
+	mu_assert_true(check_analyze_ops_batch("arm", 32, arm, sizeof(arm), sizeof(arm) - 2), "arm ops ending with a truncated op");
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_analysis_block_chop_noreturn);
 	mu_run_test(test_rz_analysis_block_create);
@@ -754,6 +814,7 @@ int all_tests() {
 	mu_run_test(test_rz_analysis_block_successors);
 	mu_run_test(test_rz_analysis_block_automerge);
 	mu_run_test(test_rz_analysis_block_analyze_ops);
+	mu_run_test(test_rz_analysis_block_analyze_ops_batch);
 	return tests_passed != tests_run;
 }
 
@@ -96,8 +96,102 @@ bool test_rz_analysis_op_val() {
 	mu_end;
 }
 
+#define BATCH_ADDR 0x1000
+#define BATCH_MASK (RZ_ANALYSIS_OP_MASK_ESIL | RZ_ANALYSIS_OP_MASK_VAL | RZ_ANALYSIS_OP_MASK_OPEX | RZ_ANALYSIS_OP_MASK_DISASM | RZ_ANALYSIS_OP_MASK_HINT)
+
+/**
+ * Checks that rz_analysis_op_batch() decodes \p expected ops from \p buf,
+ * equal to the ones decoded one by one with rz_analysis_op()
+ */
+static bool check_op_batch(RzAnalysis *analysis, const char *buf, int len, int count, int expected) {
+	RzAnalysisOp ops[16];
+	bool failed;
+	int n = rz_analysis_op_batch(analysis, ops, count, BATCH_ADDR, (const ut8 *)buf, len, BATCH_MASK, &failed);
+	mu_assert_eq(n, expected, "decoded ops");
+	int off = 0;
+	for (int i = 0; i < n; i++) {
+		RzAnalysisOp op;
+		int ret = rz_analysis_op(analysis, &op, BATCH_ADDR + off, (const ut8 *)buf + off, len - off, BATCH_MASK);
+		if (i < n - 1) {
+			mu_assert_true(ret > 0, "decoded");
+		} else {
+			mu_assert_eq(failed, ret < 1, "stopped on a failure");
+		}
+		mu_assert_eq(ops[i].addr, op.addr, "addr");
+		mu_assert_eq(ops[i].size, op.size, "size");
+		mu_assert_eq(ops[i].type, op.type, "type");
+		mu_assert_eq(ops[i].jump, op.jump, "jump");
+		mu_assert_eq(ops[i].fail, op.fail, "fail");
+		mu_assert_eq(ops[i].ptr, op.ptr, "ptr");
+		mu_assert_eq(ops[i].val, op.val, "val");
+		mu_assert_eq(ops[i].stackptr, op.stackptr, "stackptr");
+		mu_assert_streq(ops[i].mnemonic, op.mnemonic, "mnemonic");
+		mu_assert_streq(rz_strbuf_get(&ops[i].esil), rz_strbuf_get(&op.esil), "esil");
+		mu_assert_streq(rz_strbuf_get(&ops[i].opex), rz_strbuf_get(&op.opex), "opex");
+		off += op.size;
+		rz_analysis_op_fini(&op);
+		rz_analysis_op_fini(&ops[i]);
+	}
+	return true;
+}
+
+bool test_rz_analysis_op_batch(const char *arch, int bits, const char *buf, int len, int count, int expected) {
+	RzAnalysis *analysis = rz_analysis_new();
+	SWITCH_TO_ARCH_BITS(arch, bits);
+	bool ok = check_op_batch(analysis, buf, len, count, expected);
+	rz_analysis_free(analysis);
+	if (!ok) {
+		return false;
+	}
+	mu_end;
+}
+
+/**
+ * Applies the bits hints the way the core binding does
+ */
+static void batch_archbits(void *core, ut64 addr) {
+	RzAnalysis *analysis = core;
+	int bits = rz_analysis_hint_bits_at(analysis, addr, NULL);
+	rz_analysis_set_bits(analysis, bits ? bits : 32);
+}
+
+bool test_rz_analysis_op_batch_hints(void) {
+	RzAnalysis *analysis = rz_analysis_new();
+	SWITCH_TO_ARCH_BITS("arm", 32);
+	analysis->coreb.core = analysis;
+	analysis->coreb.archbits = batch_archbits;
+	// push {lr}; mov r0, 0; pop {pc}, then thumb: push {r7, lr}; movs r0, 0; pop {r7, pc}
+	const char buf[] = "\x04\xe0\x2d\xe5\x00\x00\xa0\xe3\x04\xf0\x9d\xe4\x80\xb5\x00\x20\x80\xbd";
+	rz_analysis_hint_set_bits(analysis, BATCH_ADDR + 12, 16);
+	mu_assert_eq(rz_analysis_hint_arch_bits_next(analysis, BATCH_ADDR), BATCH_ADDR + 12, "next hint");
+	mu_assert_eq(rz_analysis_hint_arch_bits_next(analysis, BATCH_ADDR + 12), UT64_MAX, "no next hint");
+	bool ok = check_op_batch(analysis, buf, sizeof(buf) - 1, 16, 6);
+	rz_analysis_free(analysis);
+	if (!ok) {
+		return false;
+	}
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_analysis_op_val);
+	// push rbp; mov rbp, rsp; sub rsp, 0x10; mov dword [rbp - 4], edi; call 0x1010; leave; ret; invalid
+	const char x86[] = "\x55\x48\x89\xe5\x48\x83\xec\x10\x89\x7d\xfc\xe8\x00\x00\x00\x00\xc9\xc3\x06\x90";
+	mu_run_test(test_rz_analysis_op_batch, "x86", 64, x86, sizeof(x86) - 1, 16, 8);
+	mu_run_test(test_rz_analysis_op_batch, "x86", 64, x86, sizeof(x86) - 1, 3, 3);
+	// stp x29, x30, [sp, -0x10]!; mov x29, sp; mov x0, 0; ldp x29, x30, [sp], 0x10; ret; retaa
+	const char arm64[] = "\xfd\x7b\xbf\xa9\xfd\x03\x00\x91\x00\x00\x80\xd2\xfd\x7b\xc1\xa8\xc0\x03\x5f\xd6\xff\x0b\x5f\xd6";
+	mu_run_test(test_rz_analysis_op_batch, "arm", 64, arm64, sizeof(arm64) - 1, 16, 6);
+	// push {lr}; mov r0, 0; pop {pc}
+	const char arm32[] = "\x04\xe0\x2d\xe5\x00\x00\xa0\xe3\x04\xf0\x9d\xe4";
+	mu_run_test(test_rz_analysis_op_batch, "arm", 32, arm32, sizeof(arm32) - 1, 16, 3);
+	// push {r7, lr}; movs r0, 0; pop {r7, pc}
+	const char thumb[] = "\x80\xb5\x00\x20\x80\xbd";
+	mu_run_test(test_rz_analysis_op_batch, "arm", 16, thumb, sizeof(thumb) - 1, 16, 3);
+	// addiu sp, sp, -0x20; jr ra; nop; and a truncated instruction
+	const char mips[] = "\xe0\xff\xbd\x27\x08\x00\xe0\x03\x00\x00\x00\x00\x00\x00";
+	mu_run_test(test_rz_analysis_op_batch, "mips", 32, mips, sizeof(mips) - 1, 16, 4);
+	mu_run_test(test_rz_analysis_op_batch_hints);
 	return tests_passed != tests_run;
 }
 
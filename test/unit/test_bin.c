@@ -299,12 +299,65 @@ bool test_rz_bin_sections_mapping(void) {
 	mu_end;
 }
 
+bool test_rz_bin_object_lazy_items(void) {
+	RzBin *bin = rz_bin_new();
+	RzIO *io = rz_io_new();
+	rz_io_bind(io, &bin->iob);
+	rz_bin_load_filter(bin, RZ_BIN_REQ_ALL & ~RZ_BIN_REQ_STRINGS);
+
+	RzBinOptions opt = { 0 };
+	rz_bin_options_init(&opt, 0, 0, 0, false, false);
+	RzBinFile *bf = rz_bin_open(bin, "bins/elf/ioli/crackme0x00", &opt);
+	mu_assert_notnull(bf, "crackme0x00 binary could not be opened");
+	RzBinObject *o = bf->o;
+	mu_assert_notnull(o, "bin object");
+	mu_assert_notnull(o->sections, "sections loaded with the object");
+	mu_assert_null(o->symbols, "symbols not loaded yet");
+	mu_assert_null(o->relocs, "relocs not loaded yet");
+
+	// rules changed after opening do not affect the object
+	rz_bin_load_filter(bin, RZ_BIN_REQ_ALL);
+	mu_assert_null(rz_bin_object_get_strings(o), "strings filtered out when opening");
+
+	const RzList *symbols = rz_bin_object_get_symbols(o);
+	mu_assert_notnull(symbols, "symbols loaded on demand");
+	mu_assert_ptreq(rz_bin_object_get_symbols(o), symbols, "symbols loaded once");
+	RzBinRelocStorage *relocs = rz_bin_object_get_relocs(o);
+	mu_assert_notnull(relocs, "relocs loaded on demand");
+	mu_assert_true(relocs->relocs_count > 0, "relocs count");
+	mu_assert_eq(rz_bin_object_get_language(o), RZ_BIN_LANGUAGE_C, "language");
+	mu_assert_streq(o->info->lang, "c", "info language");
+
+	// settings changed after opening do not affect the object
+	int filter = bin->filter;
+	bin->filter = !filter;
+	mu_assert_eq(o->filter, !!filter, "filter taken when opening");
+	bin->filter = filter;
+
+	// a rebase frees the loaded items, which are loaded again at the new addresses
+	RzBinSymbol *sym = rz_list_first(symbols);
+	ut64 paddr = sym->paddr;
+	o->opts.loadaddr = 0x1000;
+	mu_assert_true(rz_bin_object_set_items(bf, o), "rebase");
+	mu_assert_null(o->symbols, "symbols freed on rebase");
+	mu_assert_null(o->relocs, "relocs freed on rebase");
+	symbols = rz_bin_object_get_symbols(o);
+	mu_assert_notnull(symbols, "symbols loaded again");
+	sym = rz_list_first(symbols);
+	mu_assert_eq(sym->paddr, paddr + 0x1000, "symbols rebased");
+
+	rz_bin_free(bin);
+	rz_io_free(io);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_rz_bin);
 	mu_run_test(test_rz_bin_reloc_storage);
 	mu_run_test(test_rz_bin_file_delete);
 	mu_run_test(test_rz_bin_file_delete_all);
 	mu_run_test(test_rz_bin_sections_mapping);
+	mu_run_test(test_rz_bin_object_lazy_items);
 	return tests_passed != tests_run;
 }
 
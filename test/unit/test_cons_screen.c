@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_cons.h>
+#include "minunit.h"
+
+static void draw(RzConsScreen *screen, const char *frame) {
+	rz_cons_screen_clear(screen);
+	rz_cons_screen_write(screen, frame, strlen(frame));
+}
+
+static char *cells_str(RzConsScreen *screen, int y) {
+	RzStrBuf *sb = rz_strbuf_new(NULL);
+	for (int x = 0; x < screen->cols; x++) {
+		const RzConsCell *cell = rz_cons_screen_cell(screen, x, y);
+		if (cell->flags & RZ_CONS_CELL_CONT) {
+			continue;
+		}
+		rz_strbuf_append_n(sb, cell->len ? cell->ch : " ", cell->len ? cell->len : 1);
+	}
+	return rz_strbuf_drain(sb);
+}
+
+static char *render(RzConsScreen *screen) {
+	RzStrBuf *sb = rz_strbuf_new(NULL);
+	rz_cons_screen_render(screen, sb);
+	return rz_strbuf_drain(sb);
+}
+
+static bool test_cons_screen_parse(void) {
+	RzConsScreen *screen = rz_cons_screen_new();
+	mu_assert_true(rz_cons_screen_resize(screen, 8, 3), "resize");
+	draw(screen, Color_RED "ab" Color_RESET "c\r\n\x1b[1;32mxy\x1b[4mz\n0123456789");
+	char *s = cells_str(screen, 0);
+	mu_assert_streq(s, "abc     ", "first row");
+	free(s);
+	s = cells_str(screen, 2);
+	mu_assert_streq(s, "01234567", "truncated row");
+	free(s);
+	const RzConsCell *cell = rz_cons_screen_cell(screen, 0, 0);
+	mu_assert_streq(rz_cons_screen_attr(screen, cell->attr), Color_RED, "red");
+	cell = rz_cons_screen_cell(screen, 2, 0);
+	mu_assert_eq(cell->attr, 0, "reset");
+	cell = rz_cons_screen_cell(screen, 1, 1);
+	mu_assert_streq(rz_cons_screen_attr(screen, cell->attr), "\x1b[1;32m", "bold green");
+	cell = rz_cons_screen_cell(screen, 2, 1);
+	mu_assert_streq(rz_cons_screen_attr(screen, cell->attr), "\x1b[1;32m\x1b[4m", "bold green underline");
+	cell = rz_cons_screen_cell(screen, 3, 1);
+	mu_assert_eq(cell->len, 0, "blank");
+	mu_assert_null(rz_cons_screen_cell(screen, 8, 0), "out of the screen");
+
+	// cursor motions and erasing
+	draw(screen, "abcdefgh\nabcdefgh\nabcdefgh\x1b[2;3H\x1b[K\x1b[1;6Hxy\x1b[3;4H\x1b[1K");
+	s = cells_str(screen, 0);
+	mu_assert_streq(s, "abcdexyh", "moved");
+	free(s);
+	s = cells_str(screen, 1);
+	mu_assert_streq(s, "ab      ", "erased to the end");
+	free(s);
+	s = cells_str(screen, 2);
+	mu_assert_streq(s, "    efgh", "erased from the start");
+	free(s);
+	draw(screen, "abcdefgh\nabcdefgh\x1b[2;2H\x1b[J");
+	s = cells_str(screen, 0);
+	mu_assert_streq(s, "abcdefgh", "not erased");
+	free(s);
+	s = cells_str(screen, 1);
+	mu_assert_streq(s, "a       ", "erased to the end of the screen");
+	free(s);
+
+	// wrapping and fullwidth characters
+	screen->wrap = true;
+	draw(screen, "0123456789\n\xe4\xbd\xa0\xe5\xa5\xbd!");
+	s = cells_str(screen, 1);
+	mu_assert_streq(s, "89      ", "wrapped");
+	free(s);
+	s = cells_str(screen, 2);
+	mu_assert_streq(s, "\xe4\xbd\xa0\xe5\xa5\xbd!   ", "fullwidth");
+	free(s);
+	cell = rz_cons_screen_cell(screen, 2, 2);
+	mu_assert_eq(cell->flags, RZ_CONS_CELL_WIDE, "wide");
+	cell = rz_cons_screen_cell(screen, 4, 2);
+	mu_assert_streq(cell->ch, "!", "after the fullwidth characters");
+	rz_cons_screen_write(screen, "\x1b[3;2Hx", 7);
+	s = cells_str(screen, 2);
+	mu_assert_streq(s, " x\xe5\xa5\xbd!   ", "fullwidth character overwritten");
+	free(s);
+
+	rz_cons_screen_free(screen);
+	mu_end;
+}
+
+static bool test_cons_screen_render(void) {
+	RzConsScreen *screen = rz_cons_screen_new();
+	mu_assert_true(rz_cons_screen_resize(screen, 10, 3), "resize");
+	draw(screen, "\x1b[?25labc\n" Color_GREEN "def" Color_RESET);
+	char *out = render(screen);
+	mu_assert_streq(out, "\x1b[?25l\x1b[1;1H" Color_RESET "abc       \x1b[2;1H" Color_RESET Color_GREEN "def" Color_RESET "       \x1b[3;1H          \x1b[2;4H", "first frame");
+	free(out);
+
+	draw(screen, "\x1b[?25labc\n" Color_GREEN "def" Color_RESET);
+	out = render(screen);
+	mu_assert_streq(out, "\x1b[?25l\x1b[2;4H", "same frame");
+	free(out);
+
+	draw(screen, "abc\n" Color_GREEN "dXf" Color_RESET "\n        yz");
+	out = render(screen);
+	mu_assert_streq(out, "\x1b[2;2H" Color_RESET Color_GREEN "X\x1b[3;9H" Color_RESET "yz\x1b[3;10H", "changed cells");
+	free(out);
+
+	rz_cons_screen_damage(screen, 0);
+	out = render(screen);
+	mu_assert_streq(out, "\x1b[1;1H" Color_RESET "abc       \x1b[3;10H", "damaged row");
+	free(out);
+
+	mu_assert_true(rz_cons_screen_resize(screen, 4, 1), "resize");
+	draw(screen, "ab\n");
+	out = render(screen);
+	mu_assert_streq(out, "\x1b[1;1H" Color_RESET "ab  \x1b[1;1H", "resized");
+	free(out);
+	rz_cons_screen_free(screen);
+	mu_end;
+}
+
+/**
+ * Moves a highlighted line in a disassembly-like listing, as in visual
+ * mode, and checks the bytes written for each frame.
+ */
+static bool test_cons_screen_frame_bytes(void) {
+	const int rows = 50, cols = 120;
+	RzConsScreen *screen = rz_cons_screen_new();
+	mu_assert_true(rz_cons_screen_resize(screen, cols, rows), "resize");
+	size_t full = 0, max_delta = 0;
+	for (int frame = 0; frame < 10; frame++) {
+		RzStrBuf *sb = rz_strbuf_new(NULL);
+		for (int y = 0; y < rows; y++) {
+			const char *bg = y == frame + 5 ? "\x1b[7m" : "";
+			rz_strbuf_appendf(sb, "%s" Color_GREEN "0x%08x" Color_RESET "%s      " Color_YELLOW "mov" Color_RESET "%s eax, dword [rbp - 0x%x]" Color_RESET "\n", bg, 0x1000 + y * 4, bg, bg, y);
+		}
+		rz_cons_screen_clear(screen);
+		rz_cons_screen_write(screen, rz_strbuf_get(sb), rz_strbuf_length(sb));
+		RzStrBuf *out = rz_strbuf_new(NULL);
+		size_t bytes = rz_cons_screen_render(screen, out);
+		mu_assert_eq(bytes, rz_strbuf_length(out), "returned length");
+		if (!frame) {
+			full = bytes;
+		} else {
+			max_delta = RZ_MAX(max_delta, bytes);
+		}
+		rz_strbuf_free(out);
+		rz_strbuf_free(sb);
+	}
+	mu_assert_true(full > rows * 30, "full frame");
+	mu_assert_true(max_delta * 10 < full, "only the changed lines are written");
+	rz_cons_screen_free(screen);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_cons_screen_parse);
+	mu_run_test(test_cons_screen_render);
+	mu_run_test(test_cons_screen_frame_bytes);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
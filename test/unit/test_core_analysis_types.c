@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_core.h>
+#include "minunit.h"
+
+static char *vars_after_aaft(const char *file, int threads, size_t *n_fcns) {
+	RzCore *core = rz_core_new();
+	if (!core) {
+		return NULL;
+	}
+	char *vars = NULL;
+	RzCoreFile *cf = rz_core_file_open(core, file, RZ_PERM_R, 0);
+	if (cf && rz_core_bin_load(core, file, 0)) {
+		rz_config_set_i(core->config, "analysis.types.threads", threads);
+		rz_core_cmd0(core, "aa");
+		rz_core_cmd0(core, "aaft");
+		vars = rz_core_cmd_str(core, "afv @@F");
+		*n_fcns = rz_list_length(core->analysis->fcns);
+	}
+	rz_core_free(core);
+	return vars;
+}
+
+static bool test_aaft_threads(void) {
+	const char *file = "bins/elf/ioli/crackme0x00";
+	size_t n_fcns = 0;
+	char *serial = vars_after_aaft(file, 1, &n_fcns);
+	char *parallel = vars_after_aaft(file, 4, &n_fcns);
+	mu_assert_notnull(serial, "serial aaft");
+	mu_assert_notnull(parallel, "parallel aaft");
+	mu_assert_true(strstr(serial, "char *") != NULL, "types propagated from the library calls");
+	mu_assert_streq(parallel, serial, "same types with many threads");
+	free(serial);
+	free(parallel);
+	mu_end;
+}
+
+static bool test_aaft_threads_many_batches(void) {
+	const char *file = "bins/elf/analysis/ls-linux-x86_64-zlul";
+	size_t n_fcns = 0;
+	char *serial = vars_after_aaft(file, 1, &n_fcns);
+	char *parallel = vars_after_aaft(file, 4, &n_fcns);
+	mu_assert_notnull(serial, "serial aaft");
+	mu_assert_notnull(parallel, "parallel aaft");
+	// 4 threads emulate batches of 64 functions
+	mu_assert_true(n_fcns > 2 * 64, "more functions than a batch");
+	mu_assert_streq(parallel, serial, "same types in all the batches");
+	free(serial);
+	free(parallel);
+	mu_end;
+}
+
+static bool test_aaft_no_writes(void) {
+	const char *file = "bins/elf/ioli/crackme0x00";
+	RzCore *core = rz_core_new();
+	mu_assert_notnull(core, "core");
+	RzCoreFile *cf = rz_core_file_open(core, file, RZ_PERM_R, 0);
+	mu_assert_notnull(cf, "open");
+	mu_assert_true(rz_core_bin_load(core, file, 0), "load");
+	rz_core_cmd0(core, "aa");
+	rz_core_cmd0(core, "aaft");
+	// the emulation keeps the memory it writes to itself
+	mu_assert_eq(rz_pvector_len(&core->io->cache), 0, "io cache");
+	rz_core_free(core);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_aaft_threads);
+	mu_run_test(test_aaft_threads_many_batches);
+	mu_run_test(test_aaft_no_writes);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
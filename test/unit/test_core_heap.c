@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_core.h>
+#include "minunit.h"
+
+#define HEAP_ADDR   0x10000
+#define HEAP_SIZE   0x20000
+#define CHUNK_SIZE  0x90
+#define CHUNK_COUNT 200
+
+/**
+ * Maps a fake glibc heap of CHUNK_COUNT allocated chunks, followed by the
+ * top chunk, as the [heap] of a core file would be.
+ */
+static RzCore *heap_core_new(MallocState *arena) {
+	RzCore *core = rz_core_new();
+	if (!core) {
+		return NULL;
+	}
+	rz_config_set_b(core->config, "dbg.glibc.tcache", false);
+	RzIOMap *map = NULL;
+	if (!rz_io_open_at(core->io, "malloc://0x20000", RZ_PERM_RW, 0644, HEAP_ADDR, &map) || !map) {
+		rz_core_free(core);
+		return NULL;
+	}
+	rz_io_map_set_name(map, "[heap]");
+	ut8 hdr[16] = { 0 };
+	for (int i = 0; i < CHUNK_COUNT; i++) {
+		rz_write_le64(hdr + 8, CHUNK_SIZE | 1);
+		rz_io_write_at(core->io, HEAP_ADDR + i * CHUNK_SIZE, hdr, sizeof(hdr));
+	}
+	memset(arena, 0, sizeof(*arena));
+	arena->top = HEAP_ADDR + CHUNK_COUNT * CHUNK_SIZE;
+	arena->system_mem = HEAP_SIZE;
+	rz_write_le64(hdr + 8, (HEAP_SIZE - CHUNK_COUNT * CHUNK_SIZE) | 1);
+	rz_io_write_at(core->io, arena->top, hdr, sizeof(hdr));
+	return core;
+}
+
+static bool chunks_equal(RzList *a, RzList *b) {
+	if (rz_list_length(a) != rz_list_length(b)) {
+		return false;
+	}
+	RzListIter *ia = rz_list_iterator(a), *ib = rz_list_iterator(b);
+	for (; ia && ib; ia = ia->n, ib = ib->n) {
+		RzHeapChunkListItem *ca = ia->data, *cb = ib->data;
+		if (ca->addr != cb->addr || ca->size != cb->size || strcmp(ca->status, cb->status)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool test_core_heap_snapshot_reads(void) {
+	MallocState arena;
+	RzCore *core = heap_core_new(&arena);
+	mu_assert_notnull(core, "core");
+
+	ut64 requests, io_reads;
+	rz_config_set_b(core->config, "dbg.heap.snapshot", false);
+	rz_core_heap_snapshot_stats(core, NULL, NULL);
+	RzList *plain = rz_heap_chunks_list_64(core, &arena, 0, 0, true);
+	rz_core_heap_snapshot_stats(core, &requests, &io_reads);
+	mu_assert_eq(rz_list_length(plain), CHUNK_COUNT + 1, "chunks and top");
+	mu_assert_true(requests >= CHUNK_COUNT, "a read for each chunk");
+	mu_assert_eq(io_reads, requests, "every read goes to the io");
+
+	rz_config_set_b(core->config, "dbg.heap.snapshot", true);
+	RzList *snap = rz_heap_chunks_list_64(core, &arena, 0, 0, true);
+	rz_core_heap_snapshot_stats(core, &requests, &io_reads);
+	mu_assert_true(chunks_equal(plain, snap), "same chunks from the snapshot");
+	mu_assert_true(requests >= CHUNK_COUNT, "a read for each chunk");
+	mu_assert_true(io_reads <= 2, "heap read in bulk");
+	rz_list_free(snap);
+
+	// walking again reuses the snapshot
+	snap = rz_heap_chunks_list_64(core, &arena, 0, 0, true);
+	rz_core_heap_snapshot_stats(core, &requests, &io_reads);
+	mu_assert_true(chunks_equal(plain, snap), "same chunks again");
+	mu_assert_eq(io_reads, 0, "no io read");
+	rz_list_free(snap);
+	rz_list_free(plain);
+	rz_core_free(core);
+	mu_end;
+}
+
+static bool test_core_heap_snapshot_invalidate(void) {
+	MallocState arena;
+	RzCore *core = heap_core_new(&arena);
+	mu_assert_notnull(core, "core");
+	RzList *chunks = rz_heap_chunks_list_64(core, &arena, 0, 0, true);
+	RzHeapChunkListItem *item = rz_list_get_n(chunks, 1);
+	mu_assert_streq(item->status, "allocated", "allocated chunk");
+	rz_list_free(chunks);
+
+	// clear the in-use bit of the second chunk, kept in the header of the third one
+	ut8 size[8];
+	rz_write_le64(size, CHUNK_SIZE);
+	rz_io_write_at(core->io, HEAP_ADDR + 2 * CHUNK_SIZE + 8, size, sizeof(size));
+	chunks = rz_heap_chunks_list_64(core, &arena, 0, 0, true);
+	item = rz_list_get_n(chunks, 1);
+	mu_assert_streq(item->status, "free", "write seen through the snapshot");
+	rz_list_free(chunks);
+
+	// the target memory may change when the debuggee runs
+	ut64 requests, io_reads;
+	rz_core_heap_snapshot_stats(core, NULL, NULL);
+	core->dbg->stops++;
+	chunks = rz_heap_chunks_list_64(core, &arena, 0, 0, true);
+	rz_core_heap_snapshot_stats(core, &requests, &io_reads);
+	mu_assert_true(io_reads > 0, "read again after a stop");
+	rz_list_free(chunks);
+
+	// chunks 28 and 29 are on the two sides of the first page boundary
+	ut8 buf[CHUNK_SIZE + 0x10];
+	mu_assert_true(rz_core_heap_read(core, HEAP_ADDR + 28 * CHUNK_SIZE, buf, sizeof(buf)), "read across pages");
+	mu_assert_eq(rz_read_le64(buf + 8), CHUNK_SIZE | 1, "chunk header before the boundary");
+	mu_assert_eq(rz_read_le64(buf + CHUNK_SIZE + 8), CHUNK_SIZE | 1, "chunk header after the boundary");
+	rz_core_free(core);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_core_heap_snapshot_reads);
+	mu_run_test(test_core_heap_snapshot_invalidate);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
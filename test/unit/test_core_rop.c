@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_core.h>
+#include "minunit.h"
+
+static const char *profile =
+	"=PC rip\n"
+	"=SP rsp\n"
+	"gpr rax .64 0 0\n"
+	"gpr eax .32 0 0\n"
+	"gpr al .8 0 0\n"
+	"gpr rbx .64 8 0\n"
+	"gpr rsp .64 16 0\n"
+	"gpr rip .64 24 0\n"
+	"flg zf .1 32.0 0\n";
+
+static RzCoreRopGadget gadget(ut64 addr, const char *insns, ut64 clobbered, ut32 end_type) {
+	RzCoreRopGadget g = { .addr = addr, .hash = rz_core_rop_insn_hash(insns), .clobbered = clobbered, .end_type = end_type, .size = 3, .n_instr = 2 };
+	return g;
+}
+
+static bool test_core_rop_insn_hash(void) {
+	mu_assert_eq(rz_core_rop_insn_hash("pop  rax"), rz_core_rop_insn_hash("POP rax"), "case and spaces");
+	mu_assert_eq(rz_core_rop_insn_hash(" pop rax\t"), rz_core_rop_insn_hash("pop rax"), "leading and trailing spaces");
+	mu_assert_neq(rz_core_rop_insn_hash("pop rax"), rz_core_rop_insn_hash("pop rbx"), "different instructions");
+	mu_assert_neq(rz_core_rop_insn_hash("poprax"), rz_core_rop_insn_hash("pop rax"), "separated operands");
+	mu_end;
+}
+
+static bool test_core_rop_index_clobbered(void) {
+	RzReg *reg = rz_reg_new();
+	mu_assert_true(rz_reg_set_profile_string(reg, profile), "profile");
+	RzCoreRopIndex *index = rz_core_rop_index_new();
+	rz_core_rop_index_set_regs(index, reg);
+	mu_assert_eq(rz_pvector_len(&index->regs), 3, "full registers without the pc");
+	mu_assert_eq(rz_core_rop_index_reg(index, "rax"), 0, "rax");
+	mu_assert_eq(rz_core_rop_index_reg(index, "al"), 0, "sub-register");
+	mu_assert_eq(rz_core_rop_index_reg(index, "rsp"), 2, "rsp");
+	mu_assert_eq(rz_core_rop_index_reg(index, "rip"), -1, "pc");
+	mu_assert_eq(rz_core_rop_index_reg(index, "zf"), -1, "flag");
+
+	// pop rax; ret
+	mu_assert_eq(rz_core_rop_index_esil_clobbered(index, "rsp,[8],rax,=,8,rsp,+="), 0x5, "pop");
+	mu_assert_eq(rz_core_rop_index_esil_clobbered(index, "rsp,[8],rip,=,8,rsp,+="), 0x4, "ret");
+	mu_assert_eq(rz_core_rop_index_esil_clobbered(index, "1,eax,+=,$z,zf,:="), 0x1, "sub-register and flag");
+	mu_assert_eq(rz_core_rop_index_esil_clobbered(index, "rax,rbx,==,$z,zf,:="), 0, "comparison");
+	mu_assert_eq(rz_core_rop_index_esil_clobbered(index, "rbx,rax,=[8]"), 0, "memory write");
+	rz_core_rop_index_free(index);
+	rz_reg_free(reg);
+	mu_end;
+}
+
+static bool test_core_rop_index_query(void) {
+	RzCoreRopIndex *index = rz_core_rop_index_new();
+	RzCoreRopGadget g = gadget(0x1000, "pop rax;ret", 0x5, RZ_ANALYSIS_OP_TYPE_RET);
+	mu_assert_true(rz_core_rop_index_add(index, &g), "added");
+	g = gadget(0x2000, "pop rax;ret", 0x5, RZ_ANALYSIS_OP_TYPE_RET);
+	mu_assert_false(rz_core_rop_index_add(index, &g), "duplicate");
+	g = gadget(0x3000, "pop rbx;jmp rax", 0x6, RZ_ANALYSIS_OP_TYPE_RJMP);
+	g.classes = RZ_CORE_ROP_CLASS_CONST;
+	mu_assert_true(rz_core_rop_index_add(index, &g), "added");
+	mu_assert_eq(rz_vector_len(&index->gadgets), 2, "unique gadgets");
+	RzCoreRopGadget *first = rz_vector_index_ptr(&index->gadgets, 0);
+	mu_assert_eq(first->addr, 0x1000, "first address kept");
+	mu_assert_eq(first->count, 2, "duplicates counted");
+
+	RzCoreRopQuery q = { .end_type = UT32_MAX };
+	RzPVector *res = rz_core_rop_index_query(index, &q);
+	mu_assert_eq(rz_pvector_len(res), 2, "all");
+	rz_pvector_free(res);
+	q.end_type = RZ_ANALYSIS_OP_TYPE_RJMP;
+	res = rz_core_rop_index_query(index, &q);
+	mu_assert_eq(rz_pvector_len(res), 1, "by end type");
+	mu_assert_eq(((RzCoreRopGadget *)rz_pvector_at(res, 0))->addr, 0x3000, "jmp gadget");
+	rz_pvector_free(res);
+	q = (RzCoreRopQuery){ .end_type = UT32_MAX, .clobbered = 0x1 };
+	res = rz_core_rop_index_query(index, &q);
+	mu_assert_eq(rz_pvector_len(res), 1, "writing rax");
+	mu_assert_eq(((RzCoreRopGadget *)rz_pvector_at(res, 0))->addr, 0x1000, "pop rax");
+	rz_pvector_free(res);
+	q = (RzCoreRopQuery){ .end_type = UT32_MAX, .preserved = 0x1 };
+	res = rz_core_rop_index_query(index, &q);
+	mu_assert_eq(rz_pvector_len(res), 1, "not writing rax");
+	mu_assert_eq(((RzCoreRopGadget *)rz_pvector_at(res, 0))->addr, 0x3000, "pop rbx");
+	rz_pvector_free(res);
+	q = (RzCoreRopQuery){ .end_type = UT32_MAX, .classes = RZ_CORE_ROP_CLASS_CONST | RZ_CORE_ROP_CLASS_MOV };
+	res = rz_core_rop_index_query(index, &q);
+	mu_assert_eq(rz_pvector_len(res), 0, "all classes required");
+	rz_pvector_free(res);
+	rz_core_rop_index_free(index);
+	mu_end;
+}
+
+static bool test_core_rop_index_save_load(void) {
+	RzReg *reg = rz_reg_new();
+	mu_assert_true(rz_reg_set_profile_string(reg, profile), "profile");
+	RzCoreRopIndex *index = rz_core_rop_index_new();
+	rz_core_rop_index_set_regs(index, reg);
+	for (ut64 i = 0; i < 100; i++) {
+		char insns[32];
+		RzCoreRopGadget g = gadget(0x1000 + i * 3, rz_strf(insns, "add rax, %d;ret", (int)(i % 40)), 0x5, RZ_ANALYSIS_OP_TYPE_RET);
+		g.classes = i % 3 ? RZ_CORE_ROP_CLASS_ARITHM_CT : 0;
+		rz_core_rop_index_add(index, &g);
+	}
+	mu_assert_eq(rz_vector_len(&index->gadgets), 40, "unique gadgets");
+	Sdb *db = sdb_new0();
+	rz_core_rop_index_save(db, index);
+	RzCoreRopIndex *loaded = rz_core_rop_index_load(db);
+	mu_assert_notnull(loaded, "load");
+	mu_assert_eq(rz_vector_len(&loaded->gadgets), 40, "loaded gadgets");
+	for (size_t i = 0; i < rz_vector_len(&index->gadgets); i++) {
+		RzCoreRopGadget *a = rz_vector_index_ptr(&index->gadgets, i);
+		RzCoreRopGadget *b = rz_vector_index_ptr(&loaded->gadgets, i);
+		mu_assert_eq(a->addr, b->addr, "addr");
+		mu_assert_eq(a->hash, b->hash, "hash");
+		mu_assert_eq(a->clobbered, b->clobbered, "clobbered");
+		mu_assert_eq(a->size, b->size, "size");
+		mu_assert_eq(a->end_type, b->end_type, "end type");
+		mu_assert_eq(a->classes, b->classes, "classes");
+		mu_assert_eq(a->count, b->count, "count");
+		mu_assert_eq(a->n_instr, b->n_instr, "instructions");
+	}
+	mu_assert_eq(rz_core_rop_index_reg(loaded, "rsp"), 2, "register names");
+
+	sdb_set(db, "gadgets", "AAAA", 0);
+	mu_assert_null(rz_core_rop_index_load(db), "truncated gadgets");
+	sdb_unset(db, "gadgets", 0);
+	mu_assert_null(rz_core_rop_index_load(db), "missing gadgets");
+
+	// an empty index overwrites the saved one
+	RzCoreRopIndex *empty = rz_core_rop_index_new();
+	rz_core_rop_index_save(db, empty);
+	rz_core_rop_index_free(empty);
+	empty = rz_core_rop_index_load(db);
+	mu_assert_notnull(empty, "load empty");
+	mu_assert_eq(rz_vector_len(&empty->gadgets), 0, "no gadgets");
+	mu_assert_eq(rz_pvector_len(&empty->regs), 0, "no registers");
+	rz_core_rop_index_free(empty);
+	sdb_free(db);
+	rz_core_rop_index_free(loaded);
+	rz_core_rop_index_free(index);
+	rz_reg_free(reg);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_core_rop_insn_hash);
+	mu_run_test(test_core_rop_index_clobbered);
+	mu_run_test(test_core_rop_index_query);
+	mu_run_test(test_core_rop_index_save_load);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -0,0 +1,204 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+#include <rz_io.h>
+#include "minunit.h"
+
+#define TRACE_STEPS 2600 ///< 10 full chunks, the first 8 of them merged in a checkpoint
+#define TRACE_MEM   64
+
+typedef struct {
+	ut64 pc;
+	ut64 r0;
+	ut64 r1;
+	ut8 mem[TRACE_MEM];
+} TraceState;
+
+typedef struct {
+	RzReg *reg;
+	RzIO *io;
+	RzIOBind iob;
+	TraceState states[TRACE_STEPS + 1];
+} TraceCtx;
+
+static void state_get(TraceCtx *ctx, TraceState *st) {
+	st->pc = rz_reg_getv(ctx->reg, "pc");
+	st->r0 = rz_reg_getv(ctx->reg, "r0");
+	st->r1 = rz_reg_getv(ctx->reg, "r1");
+	rz_io_read_at(ctx->io, 0, st->mem, sizeof(st->mem));
+}
+
+static bool trace_ctx_init(TraceCtx *ctx) {
+	ctx->reg = rz_reg_new();
+	rz_reg_set_profile_string(ctx->reg, "=PC pc\ngpr pc .32 0 0\ngpr r0 .32 4 0\ngpr r1 .32 8 0\n");
+	ctx->io = rz_io_new();
+	rz_io_open_at(ctx->io, "malloc://0x100", RZ_PERM_RW, 0644, 0, NULL);
+	rz_io_bind(ctx->io, &ctx->iob);
+	return ctx->reg && ctx->io;
+}
+
+static void trace_ctx_fini(TraceCtx *ctx) {
+	rz_io_free(ctx->io);
+	rz_reg_free(ctx->reg);
+}
+
+/**
+ * Records TRACE_STEPS steps writing registers and overlapping memory, and
+ * the expected state before each of them.
+ */
+static bool record(TraceCtx *ctx, RzAnalysisEsilTraceLog *log) {
+	for (ut32 i = 0; i < TRACE_STEPS; i++) {
+		ut64 pc = 0x1000 + (i * 7 % 50) * 4;
+		state_get(ctx, &ctx->states[i]);
+		ctx->states[i].pc = pc;
+		mu_assert_true(rz_analysis_esil_trace_log_step_begin(log, ctx->reg, pc), "step begin");
+		rz_reg_setv(ctx->reg, "r0", i * 3);
+		mu_assert_true(rz_analysis_esil_trace_log_reg_write(log, "r0", i * 3), "reg write");
+		if (!(i % 5)) {
+			rz_reg_setv(ctx->reg, "r1", ~i);
+			mu_assert_true(rz_analysis_esil_trace_log_reg_write(log, "r1", (ut32)~i), "reg write");
+		}
+		ut64 addr = i * 13 % (TRACE_MEM - 4);
+		for (int j = 0; j < 2; j++) {
+			ut8 old[4], buf[4] = { i, i >> 8, j, 0xaa };
+			rz_io_read_at(ctx->io, addr + j * 4, old, sizeof(old));
+			mu_assert_true(rz_analysis_esil_trace_log_mem_write(log, addr + j * 4, old, buf, sizeof(buf)), "mem write");
+			rz_io_write_at(ctx->io, addr + j * 4, buf, sizeof(buf));
+		}
+		mu_assert_true(rz_analysis_esil_trace_log_step_end(log), "step end");
+	}
+	state_get(ctx, &ctx->states[TRACE_STEPS]);
+	// no step writes the pc, which keeps the address of the last one
+	ctx->states[TRACE_STEPS].pc = ctx->states[TRACE_STEPS - 1].pc;
+	mu_end;
+}
+
+static bool check_seek(TraceCtx *ctx, RzAnalysisEsilTraceLog *log, ut32 idx, const TraceState *exp) {
+	mu_assert_true(rz_analysis_esil_trace_log_seek(log, ctx->reg, &ctx->iob, idx), "seek");
+	TraceState st;
+	state_get(ctx, &st);
+	mu_assert_eq(st.pc, exp->pc, "pc");
+	mu_assert_eq(st.r0, exp->r0, "r0");
+	mu_assert_eq(st.r1, exp->r1, "r1");
+	mu_assert_memeq(st.mem, exp->mem, sizeof(st.mem), "memory");
+	mu_end;
+}
+
+static bool check_seeks(TraceCtx *ctx, RzAnalysisEsilTraceLog *log) {
+	static const ut32 seeks[] = { 0, 300, 299, 512, 511, 256, 255, TRACE_STEPS, 5, 650, 257, 1, TRACE_STEPS - 1, 0, 2048, 2047, 2049, 2300, 100, 2560, TRACE_STEPS };
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(seeks); i++) {
+		mu_assert_true(check_seek(ctx, log, seeks[i], &ctx->states[seeks[i]]), "state after seek");
+	}
+	mu_assert_false(rz_analysis_esil_trace_log_seek(log, ctx->reg, &ctx->iob, TRACE_STEPS + 1), "seek past the end");
+	mu_end;
+}
+
+static bool test_esil_trace_log_seek(void) {
+	TraceCtx *ctx = RZ_NEW0(TraceCtx);
+	mu_assert_true(ctx && trace_ctx_init(ctx), "init");
+	RzAnalysisEsilTraceLog *log = rz_analysis_esil_trace_log_new();
+	mu_assert_notnull(log, "log");
+	mu_assert_true(record(ctx, log), "record");
+	mu_assert_eq(rz_analysis_esil_trace_log_count(log), TRACE_STEPS, "count");
+	mu_assert_true(check_seeks(ctx, log), "seeks");
+
+	ut64 pcs[20];
+	mu_assert_eq(rz_analysis_esil_trace_log_pcs(log, 250, RZ_ARRAY_SIZE(pcs), pcs), RZ_ARRAY_SIZE(pcs), "pcs");
+	for (ut32 i = 0; i < RZ_ARRAY_SIZE(pcs); i++) {
+		mu_assert_eq(pcs[i], ctx->states[250 + i].pc, "pc of step");
+	}
+	mu_assert_eq(rz_analysis_esil_trace_log_pcs(log, TRACE_STEPS - 2, 10, pcs), 2, "pcs at the end");
+
+	rz_analysis_esil_trace_log_free(log);
+	trace_ctx_fini(ctx);
+	free(ctx);
+	mu_end;
+}
+
+static bool test_esil_trace_log_truncate(void) {
+	TraceCtx *ctx = RZ_NEW0(TraceCtx);
+	mu_assert_true(ctx && trace_ctx_init(ctx), "init");
+	RzAnalysisEsilTraceLog *log = rz_analysis_esil_trace_log_new();
+	mu_assert_true(record(ctx, log), "record");
+
+	// after a checkpoint, in the middle of a chunk, at its start and in the first one
+	static const ut32 truncs[] = { 2300, 300, 256, 10 };
+	for (ut32 i = 0; i < RZ_ARRAY_SIZE(truncs); i++) {
+		ut32 idx = truncs[i];
+		mu_assert_true(rz_analysis_esil_trace_log_seek(log, ctx->reg, &ctx->iob, idx), "seek");
+		ut64 pc = 0x3000 + i;
+		ut8 old[2], buf[2] = { 0x55, i };
+		rz_io_read_at(ctx->io, 2, old, sizeof(old));
+		mu_assert_true(rz_analysis_esil_trace_log_step_begin(log, ctx->reg, pc), "step from a rewound position");
+		rz_reg_setv(ctx->reg, "r0", 0x77);
+		mu_assert_true(rz_analysis_esil_trace_log_reg_write(log, "r0", 0x77), "reg write");
+		mu_assert_true(rz_analysis_esil_trace_log_mem_write(log, 2, old, buf, sizeof(buf)), "mem write");
+		rz_io_write_at(ctx->io, 2, buf, sizeof(buf));
+		mu_assert_true(rz_analysis_esil_trace_log_step_end(log), "step end");
+		mu_assert_eq(rz_analysis_esil_trace_log_count(log), idx + 1, "count");
+
+		TraceState begin = ctx->states[idx];
+		begin.pc = pc;
+		TraceState end = begin;
+		end.r0 = 0x77;
+		memcpy(end.mem + 2, buf, sizeof(buf));
+		mu_assert_true(check_seek(ctx, log, idx, &begin), "back before the new step");
+		mu_assert_true(check_seek(ctx, log, idx + 1, &end), "after the new step");
+		mu_assert_true(check_seek(ctx, log, 0, &ctx->states[0]), "back to the start");
+		mu_assert_true(check_seek(ctx, log, idx - 1, &ctx->states[idx - 1]), "before the truncation");
+		mu_assert_true(check_seek(ctx, log, idx + 1, &end), "forward after the new step");
+		mu_assert_false(rz_analysis_esil_trace_log_seek(log, ctx->reg, &ctx->iob, idx + 2), "dropped steps");
+	}
+
+	rz_analysis_esil_trace_log_free(log);
+	trace_ctx_fini(ctx);
+	free(ctx);
+	mu_end;
+}
+
+static bool test_esil_trace_log_save_load(void) {
+	TraceCtx *ctx = RZ_NEW0(TraceCtx);
+	mu_assert_true(ctx && trace_ctx_init(ctx), "init");
+	RzAnalysisEsilTraceLog *log = rz_analysis_esil_trace_log_new();
+	mu_assert_true(record(ctx, log), "record");
+	char *path = rz_file_temp(NULL);
+	mu_assert_true(rz_analysis_esil_trace_log_save(log, path), "save");
+	rz_analysis_esil_trace_log_free(log);
+
+	log = rz_analysis_esil_trace_log_load(path);
+	mu_assert_notnull(log, "load");
+	mu_assert_eq(rz_analysis_esil_trace_log_count(log), TRACE_STEPS, "count");
+	mu_assert_true(check_seeks(ctx, log), "seeks");
+
+	// new steps go to a new chunk
+	ut8 old[1] = { ctx->states[TRACE_STEPS].mem[0] }, buf[1] = { 0x42 };
+	mu_assert_true(rz_analysis_esil_trace_log_step_begin(log, ctx->reg, 0x2000), "step begin");
+	mu_assert_true(rz_analysis_esil_trace_log_mem_write(log, 0, old, buf, 1), "mem write");
+	rz_io_write_at(ctx->io, 0, buf, 1);
+	mu_assert_true(rz_analysis_esil_trace_log_step_end(log), "step end");
+	mu_assert_eq(rz_analysis_esil_trace_log_count(log), TRACE_STEPS + 1, "count");
+	mu_assert_true(rz_analysis_esil_trace_log_seek(log, ctx->reg, &ctx->iob, TRACE_STEPS), "seek");
+	mu_assert_eq(rz_reg_getv(ctx->reg, "pc"), 0x2000, "pc");
+	ut8 b;
+	rz_io_read_at(ctx->io, 0, &b, 1);
+	mu_assert_eq(b, old[0], "memory");
+	rz_analysis_esil_trace_log_free(log);
+
+	mu_assert_true(rz_file_dump(path, (const ut8 *)"RZETRACE\x01\x01", 10, false), "dump");
+	mu_assert_null(rz_analysis_esil_trace_log_load(path), "truncated trace");
+	rz_file_rm(path);
+	free(path);
+	trace_ctx_fini(ctx);
+	free(ctx);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_esil_trace_log_seek);
+	mu_run_test(test_esil_trace_log_truncate);
+	mu_run_test(test_esil_trace_log_save_load);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
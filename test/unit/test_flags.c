@@ -131,10 +131,146 @@ bool test_rz_flag_get_at() {
 	mu_end;
 }
 
+bool test_rz_flag_set_bulk(void) {
+	RzFlag *flags = rz_flag_new();
+	RzSpace *sp1 = rz_flag_space_set(flags, "sp1");
+	RzSpace *sp2 = rz_flag_space_set(flags, "sp2");
+	rz_flag_space_set(flags, NULL);
+	rz_flag_set(flags, "sym.moved", 0x10, 1);
+	rz_flag_set(flags, "sym.kept", 0x20, 1);
+
+	RzFlagBulkItem items[] = {
+		{ .name = rz_flag_name_filter(" sym.new "), .realname = "new()", .offset = 0x30, .size = 4, .space = sp1, .demangled = true },
+		{ .name = rz_flag_name_filter("sym.moved"), .offset = 0x40, .size = 8, .space = sp2 },
+		{ .name = rz_flag_name_filter("sym.kept"), .offset = 0x20, .size = 2, .space = sp2 },
+		{ .name = rz_flag_name_filter(""), .offset = 0x50, .size = 1, .space = sp1 },
+	};
+	mu_assert_eq(rz_flag_set_bulk(flags, items, RZ_ARRAY_SIZE(items)), 3, "flags set");
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(items); i++) {
+		mu_assert_null(items[i].name, "name owned");
+	}
+
+	RzFlagItem *fi = rz_flag_get(flags, "sym.new");
+	mu_assert_ptreq(items[0].item, fi, "new flag");
+	mu_assert_eq(fi->offset, 0x30, "new flag offset");
+	mu_assert_eq(fi->size, 4, "new flag size");
+	mu_assert_ptreq(fi->space, sp1, "new flag space");
+	mu_assert_streq(fi->realname, "new()", "new flag realname");
+	mu_assert_true(fi->demangled, "new flag demangled");
+
+	fi = rz_flag_get(flags, "sym.moved");
+	mu_assert_ptreq(items[1].item, fi, "moved flag");
+	mu_assert_eq(fi->offset, 0x40, "moved flag offset");
+	mu_assert_ptreq(fi->space, sp2, "moved flag space");
+	mu_assert_null(rz_flag_get_i(flags, 0x10), "moved flag old offset");
+	mu_assert_streq(fi->realname, "sym.moved", "moved flag realname");
+
+	// same offset, only the size is updated as by rz_flag_set()
+	fi = rz_flag_get(flags, "sym.kept");
+	mu_assert_ptreq(items[2].item, fi, "kept flag");
+	mu_assert_eq(fi->size, 2, "kept flag size");
+	mu_assert_null(fi->space, "kept flag space");
+
+	mu_assert_null(items[3].item, "empty name");
+	mu_assert_null(rz_flag_get_i(flags, 0x50), "empty name flag");
+
+	rz_flag_free(flags);
+	mu_end;
+}
+
+static bool collect_names(RzFlagItem *fi, void *user) {
+	RzStrBuf *sb = user;
+	if (rz_strbuf_length(sb)) {
+		rz_strbuf_append(sb, ",");
+	}
+	rz_strbuf_append(sb, fi->name);
+	return true;
+}
+
+typedef struct {
+	const char *glob;
+	RzStrBuf *sb;
+} GlobCollect;
+
+static bool collect_glob_names(RzFlagItem *fi, void *user) {
+	GlobCollect *gc = user;
+	return rz_str_glob(fi->name, gc->glob) ? collect_names(fi, gc->sb) : true;
+}
+
+#define assert_foreach(call, expected, message) \
+	do { \
+		rz_strbuf_set(&sb, ""); \
+		call; \
+		mu_assert_streq(rz_strbuf_get(&sb), expected, message); \
+	} while (0)
+
+bool test_rz_flag_foreach_name(void) {
+	RzFlag *flags = rz_flag_new();
+	RzStrBuf sb;
+	rz_strbuf_init(&sb);
+	rz_flag_space_set(flags, "sp1");
+	rz_flag_set(flags, "sym.b", 0x20, 0);
+	rz_flag_set(flags, "str.a", 0x10, 0);
+	rz_flag_set(flags, "sym.a", 0x20, 0);
+	rz_flag_set(flags, "sym.c", 0x10, 0);
+	RzSpace *sp2 = rz_flag_space_set(flags, "sp2");
+	rz_flag_set(flags, "sym.d", 0x30, 0);
+	rz_flag_set(flags, "reloc.x", 0x30, 0);
+	rz_flag_set(flags, "sym.e", 0x5, 0);
+	rz_flag_space_set(flags, NULL);
+
+	// same order as a full scan: by offset, then by insertion at the offset
+	assert_foreach(rz_flag_foreach_prefix(flags, "sym.", -1, collect_names, &sb), "sym.e,sym.c,sym.b,sym.a,sym.d", "prefix");
+	assert_foreach(rz_flag_foreach_prefix(flags, "sym.xyz", 4, collect_names, &sb), "sym.e,sym.c,sym.b,sym.a,sym.d", "prefix length");
+	assert_foreach(rz_flag_foreach_glob(flags, "s*", collect_names, &sb), "sym.e,str.a,sym.c,sym.b,sym.a,sym.d", "glob");
+	assert_foreach(rz_flag_foreach_glob(flags, "sym.*a", collect_names, &sb), "sym.a", "glob suffix");
+	assert_foreach(rz_flag_foreach_glob(flags, "*.a", collect_names, &sb), "str.a,sym.a", "glob without prefix");
+	assert_foreach(rz_flag_foreach_space_glob(flags, "sym.*", sp2, collect_names, &sb), "sym.e,sym.d", "space glob");
+	assert_foreach(rz_flag_foreach_range(flags, 0x10, 0x30, collect_names, &sb), "str.a,sym.c,sym.b,sym.a", "range");
+	assert_foreach(rz_flag_foreach_range(flags, 0x11, 0x20, collect_names, &sb), "", "empty range");
+	mu_assert_eq(rz_flag_count(flags, "sym.*"), 5, "count glob");
+	mu_assert_eq(rz_flag_count(flags, NULL), 7, "count all");
+
+	// the names index follows renames and removals
+	rz_flag_rename(flags, rz_flag_get(flags, "sym.a"), "zzz.a");
+	assert_foreach(rz_flag_foreach_prefix(flags, "sym.", -1, collect_names, &sb), "sym.e,sym.c,sym.b,sym.d", "prefix after rename");
+	assert_foreach(rz_flag_foreach_prefix(flags, "zzz", -1, collect_names, &sb), "zzz.a", "renamed prefix");
+	rz_flag_unset_name(flags, "sym.c");
+	assert_foreach(rz_flag_foreach_prefix(flags, "sym.", -1, collect_names, &sb), "sym.e,sym.b,sym.d", "prefix after unset");
+	mu_assert_eq(rz_flag_unset_glob(flags, "sym.*"), 3, "unset glob");
+	assert_foreach(rz_flag_foreach(flags, collect_names, &sb), "str.a,zzz.a,reloc.x", "left");
+	rz_flag_unset_all(flags);
+	mu_assert_eq(rz_flag_count(flags, "*"), 0, "count after unset all");
+	rz_flag_set(flags, "sym.f", 0x40, 0);
+	assert_foreach(rz_flag_foreach_prefix(flags, "sym.", -1, collect_names, &sb), "sym.f", "prefix after unset all");
+
+	// many flags at shared offsets, compared with a full scan
+	char name[32];
+	for (int i = 0; i < 3000; i++) {
+		snprintf(name, sizeof(name), "f.%d.%d", i % 13, i);
+		rz_flag_set(flags, name, (i * 7919) % 509, 0);
+	}
+	const char *globs[] = { "f.1*", "f.12.*", "f.3.1?", "f.", "f.*9", "g*" };
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(globs); i++) {
+		RzStrBuf expected;
+		rz_strbuf_init(&expected);
+		GlobCollect gc = { globs[i], &expected };
+		rz_flag_foreach(flags, collect_glob_names, &gc);
+		assert_foreach(rz_flag_foreach_glob(flags, globs[i], collect_names, &sb), rz_strbuf_get(&expected), globs[i]);
+		rz_strbuf_fini(&expected);
+	}
+
+	rz_strbuf_fini(&sb);
+	rz_flag_free(flags);
+	mu_end;
+}
+
 int all_tests(void) {
 	mu_run_test(test_rz_flag_get_set);
 	mu_run_test(test_rz_flag_by_spaces);
 	mu_run_test(test_rz_flag_get_at);
+	mu_run_test(test_rz_flag_set_bulk);
+	mu_run_test(test_rz_flag_foreach_name);
 	return tests_passed != tests_run;
 }
 
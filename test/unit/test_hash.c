@@ -229,11 +229,86 @@ bool test_message_digest_small_block_stringified() {
 	mu_end;
 }
 
+static ut32 crc32_of(const ut8 *buf, size_t size) {
+	RzMsgDigestSize dsize;
+	ut8 *digest = rz_msg_digest_calculate_small_block("crc32", buf, size, &dsize);
+	ut32 crc = digest && dsize == 4 ? rz_read_be32(digest) : 0;
+	free(digest);
+	return crc;
+}
+
+static bool all_in_charset(const ut8 *buf, size_t size, const char *charset) {
+	for (size_t i = 0; i < size; i++) {
+		if (!buf[i] || !strchr(charset, buf[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool test_crc32_forge() {
+	ut8 buf[32];
+	memcpy(buf, "The quick brown fox jumps over..", sizeof(buf));
+	mu_assert_true(rz_hash_crc32_forge(buf, sizeof(buf), 10, 0xdeadbeef), "forge in the middle");
+	mu_assert_eq(crc32_of(buf, sizeof(buf)), 0xdeadbeef, "forged crc");
+	mu_assert_memeq(buf, (const ut8 *)"The quick ", 10, "prefix unchanged");
+	mu_assert_memeq(buf + 14, (const ut8 *)"n fox jumps over..", 18, "suffix unchanged");
+	mu_assert_true(rz_hash_crc32_forge(buf, 4, 0, 0x12345678), "forge the whole buffer");
+	mu_assert_eq(crc32_of(buf, 4), 0x12345678, "forged 4 bytes");
+	mu_assert_false(rz_hash_crc32_forge(buf, sizeof(buf), 29, 0), "window out of the buffer");
+	mu_end;
+}
+
+static bool always_breaked(void) {
+	return true;
+}
+
+bool test_crc32_collide() {
+	ut8 buf[16] = { 0 };
+	mu_assert_true(rz_hash_crc32_collide(buf, sizeof(buf), 0x35c246d5, NULL, 0, NULL), "binary collision");
+	mu_assert_eq(crc32_of(buf, sizeof(buf)), 0x35c246d5, "binary crc");
+
+	static const char *charsets[] = {
+		"abcdefghijklmnopqrstuvwxyz",
+		"0123456789",
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+	};
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(charsets); i++) {
+		memset(buf, 0, sizeof(buf));
+		memcpy(buf + 10, "suffix", 6);
+		mu_assert_true(rz_hash_crc32_collide(buf, sizeof(buf), 0x35c246d5, charsets[i], 0, NULL), "charset collision");
+		mu_assert_eq(crc32_of(buf, sizeof(buf)), 0x35c246d5, "charset crc");
+		size_t n = 0;
+		while (n < 10 && buf[n]) {
+			n++;
+		}
+		mu_assert_true(n >= 4, "free bytes");
+		mu_assert_true(all_in_charset(buf, n, charsets[i]), "free bytes in the charset");
+		mu_assert_memeq(buf + 10, (const ut8 *)"suffix", 6, "suffix unchanged");
+	}
+
+	// single threaded search
+	ut8 single[16] = { 0 };
+	memcpy(single + 10, "suffix", 6);
+	mu_assert_true(rz_hash_crc32_collide(single, sizeof(single), 0x35c246d5, charsets[2], 1, NULL), "single thread collision");
+	mu_assert_eq(crc32_of(single, sizeof(single)), 0x35c246d5, "single thread crc");
+	memset(single, 0, 10);
+	mu_assert_false(rz_hash_crc32_collide(single, sizeof(single), 0x35c246d5, charsets[1], 1, always_breaked), "single thread break");
+
+	// no room for the free bytes
+	memcpy(buf, "abc", 3);
+	mu_assert_false(rz_hash_crc32_collide(buf, 3, 0, "abc", 0, NULL), "buffer too small");
+	mu_assert_false(rz_hash_crc32_collide(buf, 4, 0x35c246d5, "a", 0, NULL), "no collision with a single char");
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_message_digest_configure);
 	mu_run_test(test_message_digest_api_stringified);
 	mu_run_test(test_message_digest_hmac_stringified);
 	mu_run_test(test_message_digest_small_block_stringified);
+	mu_run_test(test_crc32_forge);
+	mu_run_test(test_crc32_collide);
 	return tests_passed != tests_run;
 }
 
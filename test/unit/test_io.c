@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <rz_io.h>
+#include <rz_th.h>
 #include "minunit.h"
 
 bool test_rz_io_cache(void) {
@@ -622,6 +623,158 @@ bool test_rz_io_map_del_on_close_all(void) {
 	mu_end;
 }
 
+bool test_rz_io_read_concurrent(void) {
+	RzIO *io = rz_io_new();
+	io->va = true;
+	io->ff = true;
+	io->Oxff = 0xff;
+	RzIODesc *desc = rz_io_open_at(io, "malloc://8", RZ_PERM_RW, 0, 0x100, NULL);
+	mu_assert_notnull(desc, "open");
+	rz_io_write_at(io, 0x100, (ut8 *)"ABCDEFGH", 8);
+
+	ut8 buf[12];
+	mu_assert_false(rz_io_read_at_concurrent(io, 0x100, buf, sizeof(buf)), "no snapshot before begin");
+	mu_assert_true(rz_io_concurrent_begin(io), "begin");
+	mu_assert_true(rz_io_read_at_concurrent(io, 0xfe, buf, sizeof(buf)), "read");
+	mu_assert_memeq(buf, (ut8 *)"\xff\xff" "ABCDEFGH" "\xff\xff", sizeof(buf), "read with gaps");
+
+	RzIOMapSnapshot *snap = rz_io_map_snapshot_acquire(io);
+	mu_assert_notnull(snap, "acquire");
+	RzIOMap *map = rz_io_map_get(io, 0x100);
+	rz_io_map_remap(io, map->id, 0x200);
+	mu_assert_true(rz_io_read_at_concurrent(io, 0x200, buf, 8), "read remapped");
+	mu_assert_memeq(buf, (ut8 *)"ABCDEFGH", 8, "read remapped");
+	mu_assert_true(rz_io_map_snapshot_read_at(snap, 0x100, buf, 8), "read acquired snapshot");
+	mu_assert_memeq(buf, (ut8 *)"ABCDEFGH", 8, "acquired snapshot keeps the old maps");
+	rz_io_map_snapshot_release(snap);
+
+	rz_io_map_new(io, desc->fd, RZ_PERM_R, 4, UT64_MAX - 1, 4);
+	mu_assert_true(rz_io_read_at_concurrent(io, UT64_MAX - 1, buf, 4), "read wrapping");
+	mu_assert_memeq(buf, (ut8 *)"EFGH", 4, "read wrapping");
+	map = rz_io_map_new(io, desc->fd, RZ_PERM_W, 0, 0x300, 8);
+	mu_assert_false(rz_io_read_at_concurrent(io, 0x300, buf, 8), "read non-readable map");
+	rz_io_map_set_perm(io, map, RZ_PERM_RW);
+	mu_assert_true(rz_io_read_at_concurrent(io, 0x300, buf, 8), "read map made readable");
+	mu_assert_memeq(buf, (ut8 *)"ABCDEFGH", 8, "read map made readable");
+	rz_io_map_set_perm(io, map, RZ_PERM_W);
+	mu_assert_false(rz_io_read_at_concurrent(io, 0x300, buf, 8), "read map made non-readable");
+
+#if __UNIX__
+	// the default plugin has a pread only on unix
+	char *filename = rz_file_temp(NULL);
+	rz_file_dump(filename, (ut8 *)"1234567890ABCDEF", 0x10, false);
+	mu_assert_notnull(rz_io_open_at(io, filename, RZ_PERM_R, 0, 0x400, NULL), "open file");
+	mu_assert_true(rz_io_read_at_concurrent(io, 0x404, buf, 8), "read file");
+	mu_assert_memeq(buf, (ut8 *)"567890AB", 8, "read file");
+#endif
+
+	rz_io_concurrent_end(io);
+	mu_assert_false(rz_io_read_at_concurrent(io, 0x200, buf, 8), "no snapshot after end");
+	rz_io_free(io);
+#if __UNIX__
+	rz_file_rm(filename);
+	free(filename);
+#endif
+	mu_end;
+}
+
+#define STRESS_SIZE    0x1000
+#define STRESS_READERS 4
+
+typedef struct {
+	RzIO *io;
+	const ut8 *data;
+	RzThreadLock *lock;
+	bool stop;
+	int reads;
+	int failures;
+} StressCtx;
+
+static ut64 stress_bases[] = { 0x10000, 0x10400, 0x10c00, 0x20000 };
+
+static bool stress_check(const StressCtx *ctx, ut64 addr, const ut8 *buf, int len) {
+	// the bytes must come from a single position of the map
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(stress_bases); i++) {
+		ut64 base = stress_bases[i];
+		bool match = true;
+		for (int j = 0; j < len && match; j++) {
+			ut64 a = addr + j;
+			ut8 expect = a >= base && a < base + STRESS_SIZE ? ctx->data[a - base] : 0xff;
+			match = buf[j] == expect;
+		}
+		if (match) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static RzThreadFunctionRet stress_reader(RzThread *th) {
+	StressCtx *ctx = th->user;
+	ut8 buf[0x40];
+	ut32 seed = (ut32)(size_t)&buf;
+	bool stop = false;
+	while (!stop) {
+		seed = seed * 1103515245 + 12345;
+		ut64 addr = 0x10000 + (seed >> 8) % 0x1400;
+		rz_io_read_at_concurrent(ctx->io, addr, buf, sizeof(buf));
+		bool ok = stress_check(ctx, addr, buf, sizeof(buf));
+		rz_th_lock_enter(ctx->lock);
+		ctx->reads++;
+		ctx->failures += !ok;
+		stop = ctx->stop;
+		rz_th_lock_leave(ctx->lock);
+	}
+	return RZ_TH_STOP;
+}
+
+bool test_rz_io_read_concurrent_stress(void) {
+	RzIO *io = rz_io_new();
+	io->va = true;
+	io->ff = true;
+	io->Oxff = 0xff;
+	ut8 data[STRESS_SIZE];
+	ut32 x = 0x1337;
+	for (size_t i = 0; i < sizeof(data); i++) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		data[i] = x & 0xff;
+	}
+	RzIOMap *map;
+	RzIODesc *desc = rz_io_open_at(io, "malloc://4096", RZ_PERM_RW, 0, stress_bases[0], &map);
+	mu_assert_notnull(desc, "open");
+	rz_io_write_at(io, stress_bases[0], data, sizeof(data));
+	mu_assert_true(rz_io_concurrent_begin(io), "begin");
+
+	StressCtx ctx = { .io = io, .data = data, .lock = rz_th_lock_new(false) };
+	RzThread *readers[STRESS_READERS];
+	for (size_t i = 0; i < STRESS_READERS; i++) {
+		readers[i] = rz_th_new(stress_reader, &ctx, 0);
+		mu_assert_notnull(readers[i], "reader");
+	}
+	for (int i = 0; i < 2000; i++) {
+		rz_io_map_remap(io, map->id, stress_bases[i % RZ_ARRAY_SIZE(stress_bases)]);
+		if (!(i % 100)) {
+			rz_sys_usleep(100);
+		}
+	}
+	rz_th_lock_enter(ctx.lock);
+	ctx.stop = true;
+	rz_th_lock_leave(ctx.lock);
+	for (size_t i = 0; i < STRESS_READERS; i++) {
+		rz_th_wait(readers[i]);
+		rz_th_free(readers[i]);
+	}
+	rz_th_lock_free(ctx.lock);
+	mu_assert_true(ctx.reads > 0, "readers ran");
+	mu_assert_eq(ctx.failures, 0, "every read sees a consistent map");
+
+	rz_io_concurrent_end(io);
+	rz_io_free(io);
+	mu_end;
+}
+
 bool all_tests(void) {
 	mu_run_test(test_rz_io_cache);
 	mu_run_test(test_rz_io_mapsplit);
@@ -639,6 +792,8 @@ bool all_tests(void) {
 	mu_run_test(test_rz_io_map_del_for_fd);
 	mu_run_test(test_rz_io_map_del_on_close);
 	mu_run_test(test_rz_io_map_del_on_close_all);
+	mu_run_test(test_rz_io_read_concurrent);
+	mu_run_test(test_rz_io_read_concurrent_stress);
 	return tests_passed != tests_run;
 }
 
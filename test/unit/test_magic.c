@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_magic.h>
+#include <rz_util.h>
+#include "minunit.h"
+
+#define SCAN_SIZE   2048
+#define SCAN_WINDOW 256
+
+static const char *rules =
+	"# prefilter test rules\n"
+	"0\tstring\tRZMAGIC\trizin magic\n"
+	"0\tbelong&0xfffffff0\t0x12345670\tmasked long\n"
+	"4\tleshort\t0xbeef\tlittle endian short\n"
+	"2\tsearch/16\t\\x01MARK\tsearched mark\n"
+	// the last line of a buffer is not parsed
+	"# end\n";
+
+static ut32 xorshift(ut32 *state) {
+	ut32 x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *state = x;
+}
+
+static void fill_random(ut8 *buf, size_t size, ut32 seed) {
+	for (size_t i = 0; i < size; i++) {
+		buf[i] = xorshift(&seed) & 0xff;
+	}
+}
+
+/**
+ * Checks the prefilter never drops an offset where the interpreter finds
+ * magic, and returns how many offsets it dropped.
+ */
+static int check_equivalent(RzMagic *ms, RzMagicPrefilter *pf, const ut8 *buf, size_t size) {
+	int dropped = 0;
+	for (size_t i = 0; i < size; i++) {
+		size_t nb = RZ_MIN(SCAN_WINDOW, size - i);
+		const char *str = rz_magic_buffer(ms, buf + i, nb);
+		bool may = rz_magic_prefilter_match(pf, buf + i, nb);
+		if (str && !may) {
+			eprintf("dropped 0x%x: %s\n", (ut32)i, str);
+			return -1;
+		}
+		dropped += !may;
+	}
+	return dropped;
+}
+
+bool test_magic_prefilter_rules(void) {
+	RzMagic *ms = rz_magic_new(0);
+	mu_assert_true(rz_magic_load_buffer(ms, rules), "load rules");
+	RzMagicPrefilter *pf = rz_magic_prefilter_new(ms);
+	mu_assert_notnull(pf, "prefilter");
+
+	ut8 buf[64] = { 0 };
+	mu_assert_false(rz_magic_prefilter_match(pf, buf, sizeof(buf)), "zeroes have no magic");
+	mu_assert_true(rz_magic_prefilter_match(pf, buf, 1), "one byte is very short");
+	memcpy(buf, "RZMAGIC", 7);
+	mu_assert_true(rz_magic_prefilter_match(pf, buf, sizeof(buf)), "string");
+	mu_assert_false(rz_magic_prefilter_match(pf, buf, 6), "string past the end");
+	memset(buf, 0, sizeof(buf));
+	rz_write_be32(buf, 0x1234567a);
+	mu_assert_true(rz_magic_prefilter_match(pf, buf, sizeof(buf)), "masked long");
+	rz_write_be32(buf, 0x1234557a);
+	mu_assert_false(rz_magic_prefilter_match(pf, buf, sizeof(buf)), "masked long mismatch");
+	memset(buf, 0, sizeof(buf));
+	rz_write_le16(buf + 4, 0xbeef);
+	mu_assert_true(rz_magic_prefilter_match(pf, buf, sizeof(buf)), "little endian short");
+	memset(buf, 0, sizeof(buf));
+	memcpy(buf + 10, "\x01" "MARK", 5);
+	mu_assert_true(rz_magic_prefilter_match(pf, buf, sizeof(buf)), "search");
+
+	ut8 big[SCAN_SIZE];
+	fill_random(big, sizeof(big), 0x1337);
+	memcpy(big + 100, "RZMAGIC", 7);
+	rz_write_be32(big + 300, 0x12345678);
+	rz_write_le16(big + 504, 0xbeef);
+	memcpy(big + 700, "xx\x01" "MARK", 7);
+	int dropped = check_equivalent(ms, pf, big, sizeof(big));
+	mu_assert_true(dropped >= 0, "prefilter must keep every offset with magic");
+	mu_assert_true(dropped > SCAN_SIZE / 2, "prefilter drops most random offsets");
+
+	ut8 candidates[SCAN_SIZE / 8];
+	size_t n = rz_magic_prefilter_scan(pf, big, sizeof(big), sizeof(big), SCAN_WINDOW, candidates);
+	mu_assert_eq(n, SCAN_SIZE - dropped, "scan finds the same candidates");
+	mu_assert_true(candidates[100 / 8] & (1 << (100 % 8)), "string candidate");
+	mu_assert_true(candidates[500 / 8] & (1 << (500 % 8)), "little endian short candidate");
+
+	rz_magic_prefilter_free(pf);
+	rz_magic_free(ms);
+	mu_end;
+}
+
+bool test_magic_prefilter_default(void) {
+	RzMagic *ms = rz_magic_new(0);
+	mu_assert_true(rz_magic_load(ms, "../librz/magic/d/default"), "load default magic");
+	RzMagic *pf_ms = rz_magic_new(0);
+	mu_assert_true(rz_magic_load(pf_ms, "../librz/magic/d/default"), "load default magic");
+	RzMagicPrefilter *pf = rz_magic_prefilter_new(pf_ms);
+	mu_assert_notnull(pf, "prefilter");
+
+	ut8 buf[SCAN_SIZE];
+	fill_random(buf, sizeof(buf), 0xdeadbeef);
+	memcpy(buf + 64, "\x7f" "ELF\x01\x01\x01", 7);
+	memcpy(buf + 512, "MZ", 2);
+	memcpy(buf + 1024, "PK\x03\x04", 4);
+	memcpy(buf + 1500, "\x89PNG\r\n\x1a\n", 8);
+	int dropped = check_equivalent(ms, pf, buf, sizeof(buf));
+	mu_assert_true(dropped >= 0, "prefilter must keep every offset with magic");
+	mu_assert_true(dropped > SCAN_SIZE / 2, "prefilter drops most random offsets");
+
+	memset(buf, 0, sizeof(buf));
+	dropped = check_equivalent(ms, pf, buf, sizeof(buf));
+	mu_assert_true(dropped >= 0, "prefilter must keep every offset with magic in zeroes");
+
+	rz_magic_prefilter_free(pf);
+	rz_magic_free(pf_ms);
+	rz_magic_free(ms);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_magic_prefilter_rules);
+	mu_run_test(test_magic_prefilter_default);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -35,18 +35,20 @@ bool test_pdb_tpi_cpp(void) {
 	mu_assert_notnull(stream, "TPIs stream not found in current PDB");
 	mu_assert_eq(stream->header.HeaderSize + stream->header.TypeRecordBytes, 117156, "Wrong TPI size");
 	mu_assert_eq(stream->header.TypeIndexBegin, 0x1000, "Wrong beginning index");
-	RBIter it;
 	RzPdbTpiType *type;
 
-	rz_rbtree_foreach (stream->types, it, type, RzPdbTpiType, rb) {
+	for (ut32 idx = stream->header.TypeIndexBegin; idx < stream->header.TypeIndexEnd; idx++) {
+		type = rz_bin_pdb_get_type_by_index(stream, idx);
 		mu_assert_notnull(type, "RzPdbTpiType is null in RBTree.");
 		if (type->type_index == 0x1028) {
 			mu_assert_eq(type->leaf_type, LF_PROCEDURE, "Incorrect data type");
 			RzPdbTpiType *arglist;
 			arglist = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Procedure *)(type->type_data))->arg_list);
+			mu_assert_notnull(arglist, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(arglist->type_index, 0x1027, "Wrong type index");
 			RzPdbTpiType *return_type;
 			return_type = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Procedure *)(type->type_data))->return_type);
+			mu_assert_notnull(return_type, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(return_type->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = return_type->type_data;
 			mu_assert_eq(simple_type->size, 4, "Incorrect return type");
@@ -61,11 +63,13 @@ bool test_pdb_tpi_cpp(void) {
 			mu_assert_eq(type->leaf_type, LF_ARRAY, "Incorrect data type");
 			RzPdbTpiType *dump;
 			dump = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Array *)(type->type_data))->index_type);
+			mu_assert_notnull(dump, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(dump->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = dump->type_data;
 			mu_assert_eq(simple_type->size, 4, "Incorrect return type");
 			mu_assert_streq(simple_type->type, "uint32_t", "Incorrect return type");
 			dump = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Array *)(type->type_data))->element_type);
+			mu_assert_notnull(dump, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(dump->type_index, 0x113E, "Wrong element type index");
 			ut64 size = rz_bin_pdb_get_type_val(type);
 			mu_assert_eq(size, 20, "Wrong array size");
@@ -77,6 +81,7 @@ bool test_pdb_tpi_cpp(void) {
 			name = rz_bin_pdb_get_type_name(type);
 			mu_assert_streq(name, "EXCEPTION_DEBUGGER_ENUM", "wrong enum name");
 			dump = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Enum *)(type->type_data))->utype);
+			mu_assert_notnull(dump, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(dump->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = dump->type_data;
 			mu_assert_eq(simple_type->size, 4, "Incorrect return type");
@@ -89,6 +94,7 @@ bool test_pdb_tpi_cpp(void) {
 			mu_assert_eq(type->leaf_type, LF_MODIFIER, "Incorrect data type");
 			RzPdbTpiType *stype = NULL;
 			stype = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Modifier *)(type->type_data))->modified_type);
+			mu_assert_notnull(stype, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(stype->type_index, 0x120F, "Incorrect modified type");
 		} else if (type->type_index == 0x1003) {
 			mu_assert_eq(type->leaf_type, LF_UNION, "Incorrect data type");
@@ -118,13 +124,16 @@ bool test_pdb_tpi_cpp(void) {
 			mu_assert_eq(type->leaf_type, LF_MFUNCTION, "Incorrect data type");
 			RzPdbTpiType *typ;
 			typ = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_MFcuntion *)(type->type_data))->return_type);
+			mu_assert_notnull(typ, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(typ->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = typ->type_data;
 			mu_assert_eq(simple_type->size, 1, "Incorrect return type");
 			mu_assert_streq(simple_type->type, "bool", "Incorrect return type");
 			typ = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_MFcuntion *)(type->type_data))->class_type);
+			mu_assert_notnull(typ, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(typ->type_index, 0x1079, "incorrect mfunction class type");
 			typ = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_MFcuntion *)(type->type_data))->arglist);
+			mu_assert_notnull(typ, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(typ->type_index, 0x1027, "incorrect mfunction arglist");
 		} else if (type->type_index == 0x113F) {
 			mu_assert_eq(type->leaf_type, LF_FIELDLIST, "Incorrect data type");
@@ -213,17 +222,20 @@ bool test_pdb_tpi_rust(void) {
 	mu_assert_notnull(stream, "TPIs stream not found in current PDB");
 	mu_assert_eq(stream->header.HeaderSize + stream->header.TypeRecordBytes, 305632, "Wrong TPI size");
 	mu_assert_eq(stream->header.TypeIndexBegin, 0x1000, "Wrong beginning index");
-	RBIter it;
 	RzPdbTpiType *type;
 
-	rz_rbtree_foreach (stream->types, it, type, RzPdbTpiType, rb) {
+	for (ut32 idx = stream->header.TypeIndexBegin; idx < stream->header.TypeIndexEnd; idx++) {
+		type = rz_bin_pdb_get_type_by_index(stream, idx);
+		mu_assert_notnull(type, "RzPdbTpiType is null in RBTree.");
 		if (type->type_index == 0x101B) {
 			mu_assert_eq(type->leaf_type, LF_PROCEDURE, "Incorrect data type");
 			RzPdbTpiType *arglist;
 			arglist = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Procedure *)(type->type_data))->arg_list);
+			mu_assert_notnull(arglist, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(arglist->type_index, 0x101A, "Wrong type index");
 			RzPdbTpiType *return_type;
 			return_type = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Procedure *)(type->type_data))->return_type);
+			mu_assert_notnull(return_type, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(return_type->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = return_type->type_data;
 			mu_assert_eq(simple_type->size, 4, "Incorrect return type");
@@ -240,11 +252,13 @@ bool test_pdb_tpi_rust(void) {
 			mu_assert_eq(type->leaf_type, LF_ARRAY, "Incorrect data type");
 			RzPdbTpiType *dump;
 			dump = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Array *)(type->type_data))->index_type);
+			mu_assert_notnull(dump, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(dump->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = dump->type_data;
 			mu_assert_eq(simple_type->size, 8, "Incorrect return type");
 			mu_assert_streq(simple_type->type, "uint64_t", "Incorrect return type");
 			dump = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Array *)(type->type_data))->element_type);
+			mu_assert_notnull(dump, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(dump->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			simple_type = dump->type_data;
 			mu_assert_eq(simple_type->size, 1, "Incorrect return type");
@@ -260,6 +274,7 @@ bool test_pdb_tpi_rust(void) {
 			name = rz_bin_pdb_get_type_name(type);
 			mu_assert_streq(name, "ISA_AVAILABILITY", "wrong enum name");
 			dump = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Enum *)(type->type_data))->utype);
+			mu_assert_notnull(dump, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(dump->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = dump->type_data;
 			mu_assert_eq(simple_type->size, 4, "Incorrect return type");
@@ -272,6 +287,7 @@ bool test_pdb_tpi_rust(void) {
 			mu_assert_eq(type->leaf_type, LF_MODIFIER, "Incorrect data type");
 			RzPdbTpiType *stype = NULL;
 			stype = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Modifier *)(type->type_data))->modified_type);
+			mu_assert_notnull(stype, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(stype->leaf_type, LF_SIMPLE_TYPE, "Incorrect modified type");
 		} else if (type->type_index == 0x1EA9) {
 			mu_assert_eq(type->leaf_type, LF_CLASS, "Incorrect data type");
@@ -290,13 +306,16 @@ bool test_pdb_tpi_rust(void) {
 			mu_assert_eq(type->leaf_type, LF_MFUNCTION, "Incorrect data type");
 			RzPdbTpiType *typ;
 			typ = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_MFcuntion *)(type->type_data))->return_type);
+			mu_assert_notnull(typ, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(typ->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = typ->type_data;
 			mu_assert_eq(simple_type->size, 0, "Incorrect return type");
 			mu_assert_streq(simple_type->type, "void", "Incorrect return type");
 			typ = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_MFcuntion *)(type->type_data))->class_type);
+			mu_assert_notnull(typ, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(typ->type_index, 0x107F, "incorrect mfunction class type");
 			typ = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_MFcuntion *)(type->type_data))->arglist);
+			mu_assert_notnull(typ, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(typ->type_index, 0x1000, "incorrect mfunction arglist");
 		} else if (type->type_index == 0x13BF) {
 			mu_assert_eq(type->leaf_type, LF_FIELDLIST, "Incorrect data type");
@@ -457,17 +476,20 @@ bool test_pdb_tpi_cpp_vs2019(void) {
 	mu_assert_notnull(stream, "TPIs stream not found in current PDB");
 	mu_assert_eq(stream->header.HeaderSize + stream->header.TypeRecordBytes, 233588, "Wrong TPI size");
 	mu_assert_eq(stream->header.TypeIndexBegin, 0x1000, "Wrong beginning index");
-	RBIter it;
 	RzPdbTpiType *type;
 
-	rz_rbtree_foreach (stream->types, it, type, RzPdbTpiType, rb) {
+	for (ut32 idx = stream->header.TypeIndexBegin; idx < stream->header.TypeIndexEnd; idx++) {
+		type = rz_bin_pdb_get_type_by_index(stream, idx);
+		mu_assert_notnull(type, "RzPdbTpiType is null in RBTree.");
 		if (type->type_index == 0x1A5F) {
 			mu_assert_eq(type->leaf_type, LF_PROCEDURE, "Incorrect data type");
 			RzPdbTpiType *arglist;
 			arglist = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Procedure *)(type->type_data))->arg_list);
+			mu_assert_notnull(arglist, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(arglist->type_index, 0x1A5E, "Wrong type index");
 			RzPdbTpiType *return_type;
 			return_type = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Procedure *)(type->type_data))->return_type);
+			mu_assert_notnull(return_type, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(return_type->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = return_type->type_data;
 			mu_assert_eq(simple_type->size, 0, "Incorrect return type");
@@ -484,11 +506,13 @@ bool test_pdb_tpi_cpp_vs2019(void) {
 			mu_assert_eq(type->leaf_type, LF_ARRAY, "Incorrect data type");
 			RzPdbTpiType *dump;
 			dump = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Array *)(type->type_data))->index_type);
+			mu_assert_notnull(dump, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(dump->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = dump->type_data;
 			mu_assert_eq(simple_type->size, 4, "Incorrect return type");
 			mu_assert_streq(simple_type->type, "uint32_t", "Incorrect return type");
 			dump = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Array *)(type->type_data))->element_type);
+			mu_assert_notnull(dump, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(dump->type_index, 0x7A, "Wrong element type index");
 			ut64 size = rz_bin_pdb_get_type_val(type);
 			mu_assert_eq(size, 16, "Wrong array size");
@@ -500,6 +524,7 @@ bool test_pdb_tpi_cpp_vs2019(void) {
 			name = rz_bin_pdb_get_type_name(type);
 			mu_assert_streq(name, "ReplacesCorHdrNumericDefines", "wrong enum name");
 			dump = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Enum *)(type->type_data))->utype);
+			mu_assert_notnull(dump, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(dump->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = dump->type_data;
 			mu_assert_eq(simple_type->size, 4, "Incorrect return type");
@@ -512,6 +537,7 @@ bool test_pdb_tpi_cpp_vs2019(void) {
 			mu_assert_eq(type->leaf_type, LF_MODIFIER, "Incorrect data type");
 			RzPdbTpiType *stype = NULL;
 			stype = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Modifier *)(type->type_data))->modified_type);
+			mu_assert_notnull(stype, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(stype->type_index, 0x22, "Incorrect modified type");
 		} else if (type->leaf_type == 0x2151) {
 			mu_assert_eq(type->leaf_type, LF_UNION, "Incorrect data type");
@@ -560,6 +586,7 @@ bool test_pdb_tpi_cpp_vs2019(void) {
 				i++;
 			}
 			stype = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Class *)(type->type_data))->vshape);
+			mu_assert_notnull(stype, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(stype->type_index, 0x11E8, "wrong class vshape");
 			stype = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Class *)(type->type_data))->derived);
 			mu_assert_null(stype, "wrong class derived");
@@ -588,15 +615,19 @@ bool test_pdb_tpi_cpp_vs2019(void) {
 			mu_assert_eq(type->leaf_type, LF_MFUNCTION, "Incorrect data type");
 			RzPdbTpiType *typ;
 			typ = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_MFcuntion *)(type->type_data))->return_type);
+			mu_assert_notnull(typ, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(typ->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = typ->type_data;
 			mu_assert_eq(simple_type->size, 0, "Incorrect return type");
 			mu_assert_streq(simple_type->type, "void", "Incorrect return type");
 			typ = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_MFcuntion *)(type->type_data))->class_type);
+			mu_assert_notnull(typ, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(typ->type_index, 0x2247, "incorrect mfunction class type");
 			typ = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_MFcuntion *)(type->type_data))->this_type);
+			mu_assert_notnull(typ, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(typ->type_index, 0x2248, "incorrect mfunction this type");
 			typ = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_MFcuntion *)(type->type_data))->arglist);
+			mu_assert_notnull(typ, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(typ->type_index, 0x224E, "incorrect mfunction arglist");
 		} else if (type->type_index == 0x239A) {
 			mu_assert_eq(type->leaf_type, LF_FIELDLIST, "Incorrect data type");
@@ -711,17 +742,20 @@ bool test_pdb_tpi_arm(void) {
 	mu_assert_notnull(stream, "TPIs stream not found in current PDB");
 	mu_assert_eq(stream->header.HeaderSize + stream->header.TypeRecordBytes, 454428, "Wrong TPI size");
 	mu_assert_eq(stream->header.TypeIndexBegin, 0x1000, "Wrong beginning index");
-	RBIter it;
 	RzPdbTpiType *type;
 
-	rz_rbtree_foreach (stream->types, it, type, RzPdbTpiType, rb) {
+	for (ut32 idx = stream->header.TypeIndexBegin; idx < stream->header.TypeIndexEnd; idx++) {
+		type = rz_bin_pdb_get_type_by_index(stream, idx);
+		mu_assert_notnull(type, "RzPdbTpiType is null in RBTree.");
 		if (type->type_index == 0x1A56) {
 			mu_assert_eq(type->leaf_type, LF_PROCEDURE, "Incorrect data type");
 			RzPdbTpiType *arglist;
 			arglist = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Procedure *)(type->type_data))->arg_list);
+			mu_assert_notnull(arglist, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(arglist->type_index, 0x1A54, "Wrong type index");
 			RzPdbTpiType *return_type;
 			return_type = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Procedure *)(type->type_data))->return_type);
+			mu_assert_notnull(return_type, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(return_type->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = return_type->type_data;
 			mu_assert_eq(simple_type->size, 0, "Incorrect return type");
@@ -738,11 +772,13 @@ bool test_pdb_tpi_arm(void) {
 			mu_assert_eq(type->leaf_type, LF_ARRAY, "Incorrect data type");
 			RzPdbTpiType *dump;
 			dump = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Array *)(type->type_data))->index_type);
+			mu_assert_notnull(dump, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(dump->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = dump->type_data;
 			mu_assert_eq(simple_type->size, 4, "Incorrect return type");
 			mu_assert_streq(simple_type->type, "uint32_t", "Incorrect return type");
 			dump = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Array *)(type->type_data))->element_type);
+			mu_assert_notnull(dump, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(dump->type_index, 0x1242, "Wrong element type index");
 			ut64 size = rz_bin_pdb_get_type_val(type);
 			mu_assert_eq(size, 16, "Wrong array size");
@@ -754,6 +790,7 @@ bool test_pdb_tpi_arm(void) {
 			name = rz_bin_pdb_get_type_name(type);
 			mu_assert_streq(name, "__crt_lowio_text_mode", "wrong enum name");
 			dump = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Enum *)(type->type_data))->utype);
+			mu_assert_notnull(dump, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(dump->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = dump->type_data;
 			mu_assert_eq(simple_type->size, 1, "Incorrect return type");
@@ -766,6 +803,7 @@ bool test_pdb_tpi_arm(void) {
 			mu_assert_eq(type->leaf_type, LF_MODIFIER, "Incorrect data type");
 			RzPdbTpiType *stype = NULL;
 			stype = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Modifier *)(type->type_data))->modified_type);
+			mu_assert_notnull(stype, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(stype->type_index, 0x112D, "Incorrect modified type");
 		} else if (type->leaf_type == 0x2151) {
 			mu_assert_eq(type->leaf_type, LF_UNION, "Incorrect data type");
@@ -833,15 +871,18 @@ bool test_pdb_tpi_arm(void) {
 			mu_assert_eq(type->leaf_type, LF_MFUNCTION, "Incorrect data type");
 			RzPdbTpiType *typ;
 			typ = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_MFcuntion *)(type->type_data))->return_type);
+			mu_assert_notnull(typ, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(typ->leaf_type, LF_SIMPLE_TYPE, "Incorrect return type");
 			Tpi_LF_SimpleType *simple_type = typ->type_data;
 			mu_assert_eq(simple_type->size, 4, "Incorrect return type");
 			mu_assert_streq(simple_type->type, "int32_t", "Incorrect return type");
 			typ = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_MFcuntion *)(type->type_data))->class_type);
+			mu_assert_notnull(typ, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(typ->type_index, 0x165B, "incorrect mfunction class type");
 			typ = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_MFcuntion *)(type->type_data))->this_type);
 			mu_assert_null(typ, "incorrect mfunction this type");
 			typ = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_MFcuntion *)(type->type_data))->arglist);
+			mu_assert_notnull(typ, "RzPdbTpiType is null in RBTree.");
 			mu_assert_eq(typ->type_index, 0x168A, "incorrect mfunction arglist");
 		} else if (type->type_index == 0x16A1) {
 			mu_assert_eq(type->leaf_type, LF_FIELDLIST, "Incorrect data type");
@@ -919,12 +960,35 @@ int test_tpi_type_node_cmp(const void *incoming, const RBNode *in_tree, void *us
 	return 0;
 }
 
+bool test_pdb_tpi_lazy(void) {
+	RzPdb *pdb = rz_bin_pdb_parse_from_file("bins/pdb/Project1.pdb");
+	mu_assert_notnull(pdb, "PDB parse failed.");
+	RzPdbTpiStream *stream = pdb->s_tpi;
+	mu_assert_notnull(stream, "TPIs stream not found in current PDB");
+	mu_assert_null(stream->types, "no type is decoded while parsing");
+
+	RzPdbTpiType *type = rz_bin_pdb_get_type_by_index(stream, 0x1028);
+	mu_assert_notnull(type, "type 0x1028 is decoded on lookup");
+	mu_assert_eq(type->type_index, 0x1028, "Wrong type index");
+	mu_assert_eq(type->leaf_type, LF_PROCEDURE, "Incorrect data type");
+	mu_assert_ptreq(rz_bin_pdb_get_type_by_index(stream, 0x1028), type, "decoded type is cached");
+
+	RzPdbTpiType *arglist = rz_bin_pdb_get_type_by_index(stream, ((Tpi_LF_Procedure *)(type->type_data))->arg_list);
+	mu_assert_notnull(arglist, "arglist is decoded on lookup");
+	mu_assert_eq(arglist->type_index, 0x1027, "Wrong type index");
+	mu_assert_null(rz_bin_pdb_get_type_by_index(stream, stream->header.TypeIndexEnd), "index out of the stream");
+
+	rz_bin_pdb_free(pdb);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test(test_pdb_tpi_cpp);
 	mu_run_test(test_pdb_tpi_rust);
 	mu_run_test(test_pdb_type_save);
 	mu_run_test(test_pdb_tpi_cpp_vs2019);
 	mu_run_test(test_pdb_tpi_arm);
+	mu_run_test(test_pdb_tpi_lazy);
 	return tests_passed != tests_run;
 }
 
@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include <rz_util/rz_print.h>
+#include "minunit.h"
+
+static RzStrBuf *output;
+
+static int output_printf(const char *fmt, ...) {
+	va_list ap;
+	va_start(ap, fmt);
+	rz_strbuf_vappendf(output, fmt, ap);
+	va_end(ap);
+	return 0;
+}
+
+static RzPrint *print_new(int flags) {
+	RzPrint *p = rz_print_new();
+	p->cb_printf = output_printf;
+	p->flags = flags;
+	p->cols = 16;
+	p->pairs = true;
+	return p;
+}
+
+static char *output_drain(void) {
+	char *s = rz_strbuf_drain(output);
+	output = rz_strbuf_new(NULL);
+	return s;
+}
+
+/**
+ * Prints a hexdump with the row writer and with the generic loop, which is
+ * used when the cursor is enabled and prints nothing for a cursor out of
+ * the buffer, and returns whether the two outputs match.
+ */
+static bool hexdump_matches(RzPrint *p, ut64 addr, const ut8 *buf, int len, int base, int step) {
+	rz_print_hexdump(p, addr, buf, len, base, step, 1);
+	char *rows = output_drain();
+	p->cur_enabled = true;
+	p->cur = p->ocur = -1;
+	rz_print_hexdump(p, addr, buf, len, base, step, 1);
+	p->cur_enabled = false;
+	char *generic = output_drain();
+	bool r = !strcmp(rows, generic);
+	if (!r) {
+		eprintf("rows:\n%s\ngeneric:\n%s\n", rows, generic);
+	}
+	free(rows);
+	free(generic);
+	return r;
+}
+
+static bool word_is_mapped(RzIO *io, ut64 addr) {
+	return true;
+}
+
+static const char *word_color(void *user, ut64 addr, bool verbose) {
+	return addr & 1 ? Color_GREEN : NULL;
+}
+
+static bool test_print_hexdump(void) {
+	ut8 buf[300];
+	for (int i = 0; i < sizeof(buf); i++) {
+		buf[i] = i * 7;
+	}
+	memcpy(buf, "rizin\0\xff\x7f", 8);
+	RzPrint *p = print_new(RZ_PRINT_FLAGS_HEADER | RZ_PRINT_FLAGS_OFFSET);
+	rz_print_hexdump(p, 0x1000, buf, 20, 16, 1, 1);
+	char *s = output_drain();
+	mu_assert_streq(s,
+		"- offset -   0 1  2 3  4 5  6 7  8 9  A B  C D  E F  0123456789ABCDEF\n"
+		"0x00001000  7269 7a69 6e00 ff7f 383f 464d 545b 6269  rizin...8?FMT[bi\n"
+		"0x00001010  7077 7e85                                pw~.\n",
+		"hexdump");
+	free(s);
+
+	mu_assert_true(hexdump_matches(p, 0x1000, buf, sizeof(buf), 16, 1), "plain");
+	mu_assert_true(hexdump_matches(p, 0x1000, buf, 7, 16, 1), "partial row");
+	p->flags |= RZ_PRINT_FLAGS_COLOR;
+	mu_assert_true(hexdump_matches(p, 0x1000, buf, sizeof(buf), 16, 1), "color");
+	p->flags |= RZ_PRINT_FLAGS_NONASCII;
+	mu_assert_true(hexdump_matches(p, 0x1000, buf, sizeof(buf), 16, 1), "no ascii");
+	p->flags = RZ_PRINT_FLAGS_COMPACT;
+	mu_assert_true(hexdump_matches(p, 0, buf, 37, 16, 1), "compact");
+	p->flags = RZ_PRINT_FLAGS_OFFSET | RZ_PRINT_FLAGS_ADDRDEC;
+	p->cols = 7;
+	mu_assert_true(hexdump_matches(p, 0x1000, buf, sizeof(buf), 16, 1), "odd columns");
+	p->pairs = false;
+	p->wide_offsets = true;
+	p->flags = RZ_PRINT_FLAGS_OFFSET;
+	mu_assert_true(hexdump_matches(p, 0x1000, buf, sizeof(buf), 16, 1), "no pairs");
+	p->flags |= RZ_PRINT_FLAGS_SEGOFF;
+	mu_assert_true(hexdump_matches(p, 0x1000, buf, sizeof(buf), 16, 1), "segment offsets");
+
+	// pxw
+	p->flags = RZ_PRINT_FLAGS_HEADER | RZ_PRINT_FLAGS_OFFSET;
+	p->cols = 16;
+	p->pairs = true;
+	p->wide_offsets = false;
+	rz_print_hexdump(p, 0x1000, buf, 20, 32, 4, 1);
+	s = output_drain();
+	mu_assert_streq(s,
+		"0x00001000  0x697a6972 0x7fff006e 0x4d463f38 0x69625b54  rizin...8?FMT[bi\n"
+		"0x00001010  0x857e7770                                   pw~.\n",
+		"words hexdump");
+	free(s);
+	mu_assert_true(hexdump_matches(p, 0x1000, buf, sizeof(buf), 32, 4), "words");
+	mu_assert_true(hexdump_matches(p, 0x1000, buf, 20, 32, 4), "words partial row");
+	p->big_endian = true;
+	mu_assert_true(hexdump_matches(p, 0x1000, buf, sizeof(buf), 32, 4), "words big endian");
+	p->big_endian = false;
+	p->flags |= RZ_PRINT_FLAGS_COLOR;
+	p->colorfor = word_color;
+	p->iob.addr_is_mapped = word_is_mapped;
+	mu_assert_true(hexdump_matches(p, 0x1000, buf, sizeof(buf), 32, 4), "words color");
+	p->flags = RZ_PRINT_FLAGS_COMPACT | RZ_PRINT_FLAGS_NONASCII;
+	mu_assert_true(hexdump_matches(p, 0, buf, 36, 32, 4), "words compact");
+	p->cols = 8;
+	mu_assert_true(hexdump_matches(p, 0, buf, sizeof(buf), 32, 4), "words 8 columns");
+	rz_print_free(p);
+	mu_end;
+}
+
+static bool test_print_bytes(void) {
+	ut8 buf[0x10001];
+	char *exp = malloc(sizeof(buf) * 2 + 2);
+	for (int i = 0; i < sizeof(buf); i++) {
+		buf[i] = i ^ (i >> 8);
+		snprintf(exp + i * 2, 3, "%02x", buf[i]);
+	}
+	strcpy(exp + sizeof(buf) * 2, "\n");
+	RzPrint *p = print_new(0);
+	rz_print_bytes(p, buf, sizeof(buf), "%02x");
+	char *s = output_drain();
+	mu_assert_streq(s, exp, "hexpairs");
+	free(s);
+	free(exp);
+
+	char str[9];
+	rz_hex_bin2str((const ut8 *)"\x00\xab\x7f\xff", 4, str);
+	mu_assert_streq(str, "00ab7fff", "bin2str");
+
+	rz_print_bytes(p, buf, 3, "%02X,");
+	s = output_drain();
+	mu_assert_streq(s, "00,01,02,\n", "format");
+	free(s);
+	rz_print_free(p);
+	mu_end;
+}
+
+static bool test_print_code(void) {
+	ut8 buf[40];
+	for (int i = 0; i < sizeof(buf); i++) {
+		buf[i] = 0xf0 + i;
+	}
+	RzPrint *p = print_new(0);
+	rz_print_code(p, 0x1000, buf, 3, 'c');
+	char *s = output_drain();
+	mu_assert_streq(s, "#define _BUFFER_SIZE 3\nconst uint8_t buffer[_BUFFER_SIZE] = {\n  0xf0, 0xf1, 0xf2\n};\n", "c bytes");
+	free(s);
+
+	rz_print_code(p, 0x1000, buf, sizeof(buf), 'c');
+	char *bytes = output_drain();
+	p->cur_enabled = true;
+	p->cur = p->ocur = -1;
+	rz_print_code(p, 0x1000, buf, sizeof(buf), 'c');
+	s = output_drain();
+	mu_assert_streq(bytes, s, "same as the generic loop");
+	free(bytes);
+	free(s);
+	rz_print_free(p);
+	mu_end;
+}
+
+int all_tests() {
+	output = rz_strbuf_new(NULL);
+	mu_run_test(test_print_hexdump);
+	mu_run_test(test_print_bytes);
+	mu_run_test(test_print_code);
+	rz_strbuf_free(output);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -237,6 +237,43 @@ bool test_rz_reg_get_pack(void) {
 	mu_end;
 }
 
+bool test_rz_reg_index(void) {
+	RzReg *reg = rz_reg_new();
+	mu_assert_notnull(reg, "rz_reg_new () failed");
+
+	rz_reg_set_profile_string(reg,
+		"=PC	eip\n\
+		=SP	esp\n\
+		gpr	eax	.32	0	0\n\
+		gpr	esp	.32	4	0\n\
+		gpr	eip	.32	8	0\n\
+		gpr	ebp	.32	12	0");
+
+	int idx = rz_reg_index_of(reg, "eip");
+	mu_assert_true(idx >= 0, "eip has an index");
+	mu_assert_eq(rz_reg_index_of(reg, "rip"), -1, "rip is not in the profile");
+
+	RzRegItem *item = rz_reg_index_get(reg, idx);
+	mu_assert_ptreq(item, rz_reg_get(reg, "eip", RZ_REG_TYPE_ANY), "index lookup returns the same item");
+
+	mu_assert_true(rz_reg_index_set_value(reg, idx, 0x1337), "set eip by index");
+	mu_assert_eq(rz_reg_getv(reg, "eip"), 0x1337, "eip set by index");
+	mu_assert_eq(rz_reg_index_get_value(reg, idx), 0x1337, "get eip by index");
+
+	mu_assert_ptreq(rz_reg_get_by_role(reg, RZ_REG_NAME_PC), item, "PC role resolves to eip");
+	mu_assert_ptreq(rz_reg_get(reg, "PC", RZ_REG_TYPE_ANY), item, "PC alias resolves to eip");
+	mu_assert_eq(rz_reg_get_value_by_role(reg, RZ_REG_NAME_PC), 0x1337, "get PC by role");
+
+	rz_reg_set_name(reg, RZ_REG_NAME_PC, "ebp");
+	item = rz_reg_get_by_role(reg, RZ_REG_NAME_PC);
+	mu_assert_notnull(item, "PC role after rename");
+	mu_assert_streq(item->name, "ebp", "role cache invalidated by rz_reg_set_name");
+	mu_assert_null(rz_reg_get_by_role(reg, RZ_REG_NAME_BP), "BP role is not defined");
+
+	rz_reg_free(reg);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_reg_set_name);
 	mu_run_test(test_rz_reg_set_profile_string);
@@ -245,6 +282,7 @@ int all_tests() {
 	mu_run_test(test_rz_reg_get);
 	mu_run_test(test_rz_reg_get_list);
 	mu_run_test(test_rz_reg_get_pack);
+	mu_run_test(test_rz_reg_index);
 	return tests_passed != tests_run;
 }
 
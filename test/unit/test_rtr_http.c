@@ -0,0 +1,248 @@
+// SPDX-FileCopyrightText: 2022 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_core.h>
+#include <rz_socket.h>
+#include <rz_userconf.h>
+#include "minunit.h"
+
+#if HAVE_LIBUV
+
+typedef struct {
+	RzSocket *s;
+	char *buf; ///< bytes received and not consumed yet
+	size_t len;
+} HttpConn;
+
+typedef struct {
+	char *head;
+	char *body;
+	size_t body_len;
+} HttpResponse;
+
+static RzThreadFunctionRet http_server_th(RzThread *th) {
+	RzCore *core = th->user;
+	rz_core_rtr_http(core, 0, 'h', "");
+	return RZ_TH_STOP;
+}
+
+static bool http_conn_open(HttpConn *c, const char *port) {
+	memset(c, 0, sizeof(*c));
+	c->s = rz_socket_new(false);
+	return c->s && rz_socket_connect_tcp(c->s, "127.0.0.1", port, 5);
+}
+
+static void http_conn_close(HttpConn *c) {
+	rz_socket_free(c->s);
+	free(c->buf);
+}
+
+static bool http_conn_send(HttpConn *c, const char *data) {
+	int len = strlen(data);
+	return rz_socket_write(c->s, (void *)data, len) == len;
+}
+
+/* makes sure at least n bytes are received */
+static bool http_conn_fill(HttpConn *c, size_t n) {
+	ut8 tmp[4096];
+	while (c->len < n) {
+		int r = rz_socket_read(c->s, tmp, sizeof(tmp));
+		if (r <= 0) {
+			return false;
+		}
+		char *buf = realloc(c->buf, c->len + r + 1);
+		if (!buf) {
+			return false;
+		}
+		memcpy(buf + c->len, tmp, r);
+		c->buf = buf;
+		c->len += r;
+		c->buf[c->len] = '\0';
+	}
+	return true;
+}
+
+/* offset right after the first \p sep found from \p off, receiving more bytes when needed */
+static bool http_conn_find(HttpConn *c, size_t off, const char *sep, size_t *end) {
+	size_t sep_len = strlen(sep);
+	while (true) {
+		const ut8 *p = c->len > off ? rz_mem_mem((const ut8 *)c->buf + off, c->len - off, (const ut8 *)sep, sep_len) : NULL;
+		if (p) {
+			*end = (p - (const ut8 *)c->buf) + sep_len;
+			return true;
+		}
+		if (!http_conn_fill(c, c->len + 1)) {
+			return false;
+		}
+	}
+}
+
+/* reads the next response, with a Content-Length or chunked body */
+static bool http_conn_response(HttpConn *c, HttpResponse *res) {
+	memset(res, 0, sizeof(*res));
+	size_t off;
+	if (!http_conn_find(c, 0, "\r\n\r\n", &off)) {
+		return false;
+	}
+	res->head = rz_str_ndup(c->buf, off);
+	RzStrBuf body;
+	rz_strbuf_init(&body);
+	if (strstr(res->head, "Transfer-Encoding: chunked\r\n")) {
+		while (true) {
+			size_t data;
+			if (!http_conn_find(c, off, "\r\n", &data)) {
+				goto fail;
+			}
+			size_t size = strtoull(c->buf + off, NULL, 16);
+			if (!http_conn_fill(c, data + size + 2)) {
+				goto fail;
+			}
+			rz_strbuf_append_n(&body, c->buf + data, size);
+			off = data + size + 2;
+			if (!size) {
+				break;
+			}
+		}
+	} else {
+		const char *clen = strstr(res->head, "Content-Length: ");
+		size_t size = clen ? strtoull(clen + 16, NULL, 10) : 0;
+		if (!http_conn_fill(c, off + size)) {
+			goto fail;
+		}
+		rz_strbuf_append_n(&body, c->buf + off, size);
+		off += size;
+	}
+	memmove(c->buf, c->buf + off, c->len - off + 1);
+	c->len -= off;
+	res->body_len = rz_strbuf_length(&body);
+	res->body = rz_strbuf_drain_nofree(&body);
+	return true;
+fail:
+	rz_strbuf_fini(&body);
+	free(res->head);
+	return false;
+}
+
+static void http_response_fini(HttpResponse *res) {
+	free(res->head);
+	free(res->body);
+}
+
+/* sends a GET /cmd/ request and checks its output */
+static bool http_cmd_check(HttpConn *c, const char *cmd, const char *expect) {
+	char *req = rz_str_newf("GET /cmd/%s HTTP/1.1\r\n\r\n", cmd);
+	mu_assert_true(http_conn_send(c, req), "request sent");
+	free(req);
+	HttpResponse res;
+	mu_assert_true(http_conn_response(c, &res), "response received");
+	mu_assert_strcontains(res.head, "HTTP/1.1 200 OK\r\n", "status");
+	mu_assert_strcontains(res.head, "Connection: keep-alive\r\n", "connection kept alive");
+	mu_assert_streq(res.body, expect, "command output");
+	http_response_fini(&res);
+	return true;
+}
+
+static bool test_rtr_http(void) {
+	RzCore *core = rz_core_new();
+	mu_assert_notnull(rz_io_open(core->io, "malloc://0x10000", RZ_PERM_RW, 0), "open file");
+	rz_config_set_i(core->config, "scr.color", COLOR_MODE_DISABLED);
+	rz_config_set(core->config, "http.port", "0");
+	rz_config_set(core->config, "http.bind", "localhost");
+	rz_core_seek(core, 0x100, true);
+
+	RzThread *th = rz_th_new(http_server_th, core, 0);
+	mu_assert_notnull(th, "server thread");
+	for (int i = 0; i < 5000 && !core->http_up; i++) {
+		rz_sys_usleep(1000);
+	}
+	mu_assert_true(core->http_up, "server started");
+	// http.port=0 is replaced by the port picked by the system while serving
+	int iport = rz_config_get_i(core->config, "http.port");
+	mu_assert_true(iport > 0 && iport < 65536, "port picked by the system");
+	char port[16];
+	snprintf(port, sizeof(port), "%d", iport);
+
+	// keep-alive, the server seeks on its own
+	HttpConn a;
+	mu_assert_true(http_conn_open(&a, port), "connect");
+	mu_assert_true(http_cmd_check(&a, "s", "0x100\n"), "first request");
+	mu_assert_true(http_cmd_check(&a, "s%2B0x10", ""), "second request");
+	mu_assert_true(http_cmd_check(&a, "s", "0x110\n"), "third request");
+
+	// pipelined requests, answered in order
+	HttpConn b;
+	mu_assert_true(http_conn_open(&b, port), "connect");
+	mu_assert_true(http_conn_send(&b,
+			       "GET /cmd/%3Fe%20a HTTP/1.1\r\n\r\n"
+			       "POST /cmds HTTP/1.1\r\nContent-Length: 18\r\n\r\n?e hello\n?e world\n"
+			       "GET /cmd/%3Fe%20b HTTP/1.1\r\n\r\n"),
+		"pipelined requests sent");
+	HttpResponse res;
+	mu_assert_true(http_conn_response(&b, &res), "first response");
+	mu_assert_streq(res.body, "a\n", "first output");
+	http_response_fini(&res);
+	mu_assert_true(http_conn_response(&b, &res), "/cmds response");
+	mu_assert_strcontains(res.head, "Content-Type: application/json\r\n", "/cmds content type");
+	mu_assert_streq(res.body, "[\"hello\\n\",\"world\\n\"]", "/cmds outputs");
+	http_response_fini(&res);
+	mu_assert_true(http_conn_response(&b, &res), "last response");
+	mu_assert_streq(res.body, "b\n", "last output");
+	http_response_fini(&res);
+
+	// outputs larger than a chunk
+	mu_assert_true(http_conn_send(&b, "GET /cmd/px%200x8000%20%40%200 HTTP/1.1\r\n\r\n"), "request sent");
+	mu_assert_true(http_conn_response(&b, &res), "chunked response");
+	mu_assert_strcontains(res.head, "Transfer-Encoding: chunked\r\n", "chunked");
+	char *chunked = res.body;
+	size_t chunked_len = res.body_len;
+	res.body = NULL;
+	http_response_fini(&res);
+	mu_assert_true(chunked_len > 64 * 1024, "output of several chunks");
+
+	HttpConn c;
+	mu_assert_true(http_conn_open(&c, port), "connect");
+	mu_assert_true(http_conn_send(&c, "GET /stats HTTP/1.1\r\n\r\n"), "request sent");
+	mu_assert_true(http_conn_response(&c, &res), "/stats response");
+	RzJson *stats = rz_json_parse(res.body);
+	mu_assert_notnull(stats, "/stats json");
+	const RzJson *j = rz_json_get(stats, "connections");
+	mu_assert_true(j && j->num.u_value == 3, "connections");
+	j = rz_json_get(stats, "requests");
+	mu_assert_true(j && j->num.u_value >= 7, "requests");
+	j = rz_json_get(stats, "bytes_out");
+	mu_assert_true(j && j->num.u_value > chunked_len, "bytes out");
+	rz_json_free(stats);
+	http_response_fini(&res);
+
+	mu_assert_true(http_conn_send(&c, "GET /cmd/Rh-- HTTP/1.1\r\n\r\n"), "stop request sent");
+	mu_assert_true(http_conn_response(&c, &res), "stop response");
+	mu_assert_strcontains(res.head, "Connection: close\r\n", "connection closed");
+	http_response_fini(&res);
+	rz_th_wait(th);
+	rz_th_free(th);
+	http_conn_close(&a);
+	http_conn_close(&b);
+	http_conn_close(&c);
+
+	mu_assert_false(core->http_up, "server stopped");
+	mu_assert_eq(core->offset, 0x100, "seek of the server kept apart");
+	mu_assert_streq(rz_config_get(core->config, "http.port"), "0", "http.port restored");
+	char *local = rz_core_cmd_str(core, "px 0x8000 @ 0");
+	mu_assert_eq(chunked_len, strlen(local), "chunked output length");
+	mu_assert_memeq((ut8 *)chunked, (ut8 *)local, chunked_len, "chunked output");
+	free(local);
+	free(chunked);
+	rz_core_free(core);
+	mu_end;
+}
+
+#endif
+
+int all_tests() {
+#if HAVE_LIBUV
+	mu_run_test(test_rtr_http);
+#endif
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2021 RizinOrg <info@rizin.re>
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_util.h>
+#include "minunit.h"
+
+typedef struct {
+	ut64 a;
+	ut32 b;
+	ut8 c;
+} SlabObj;
+
+static bool test_slab_alloc(void) {
+	RzSlab *slab = rz_slab_new(sizeof(SlabObj), 5, NULL);
+	mu_assert_notnull(slab, "slab");
+	mu_assert_eq(slab->obj_size % 16, 0, "aligned size");
+	SlabObj *objs[23];
+	for (int i = 0; i < RZ_ARRAY_SIZE(objs); i++) {
+		objs[i] = rz_slab_alloc0(slab);
+		mu_assert_notnull(objs[i], "alloc");
+		mu_assert_eq(objs[i]->a | objs[i]->b | objs[i]->c, 0, "zeroed");
+		mu_assert_eq((size_t)objs[i] % 16, 0, "aligned object");
+		objs[i]->a = i;
+		objs[i]->b = i * 2;
+		objs[i]->c = i * 3;
+	}
+	mu_assert_eq(slab->count, RZ_ARRAY_SIZE(objs), "count");
+	for (int i = 0; i < RZ_ARRAY_SIZE(objs); i++) {
+		mu_assert_eq(objs[i]->a, i, "object not overwritten");
+		mu_assert_eq(objs[i]->c, (ut8)(i * 3), "object not overwritten");
+	}
+	for (int i = 0; i < RZ_ARRAY_SIZE(objs); i += 2) {
+		rz_slab_release(slab, objs[i]);
+	}
+	rz_slab_release(slab, NULL);
+	mu_assert_eq(slab->count, RZ_ARRAY_SIZE(objs) / 2, "count after release");
+	for (int i = 0; i < RZ_ARRAY_SIZE(objs); i += 2) {
+		objs[i] = rz_slab_alloc(slab);
+		mu_assert_notnull(objs[i], "alloc after release");
+		objs[i]->a = i;
+	}
+	for (int i = 0; i < RZ_ARRAY_SIZE(objs); i++) {
+		mu_assert_eq(objs[i]->a, i, "objects are distinct");
+	}
+	for (int i = 0; i < RZ_ARRAY_SIZE(objs); i += 3) {
+		rz_slab_release(slab, objs[i]);
+	}
+	mu_assert_eq(slab->count, RZ_ARRAY_SIZE(objs) - 8, "count");
+	// the objects still allocated are freed with the slab
+	rz_slab_free(slab);
+	mu_end;
+}
+
+static bool test_alloc_prof(void) {
+	RzSlab *slab = rz_slab_new(24, 0, "test.obj");
+	void *a = rz_slab_alloc(slab);
+	char *report = rz_alloc_prof_report();
+	mu_assert_null(strstr(report, "test.obj"), "disabled");
+	free(report);
+
+	rz_alloc_prof_enable(true);
+	void *b = rz_slab_alloc(slab);
+	void *c = rz_slab_alloc(slab);
+	rz_slab_release(slab, b);
+	rz_slab_release(slab, a);
+	rz_alloc_prof_record("test.site", 100, true);
+	rz_alloc_prof_enable(false);
+	rz_slab_release(slab, c);
+	report = rz_alloc_prof_report();
+	mu_assert_streq(report,
+		"site                           allocs        frees          bytes           live           peak\n"
+		"test.site                           1            0            100            100            100\n"
+		"test.obj                            2            2             64              0             64\n",
+		"report");
+	free(report);
+
+	rz_alloc_prof_reset();
+	report = rz_alloc_prof_report();
+	mu_assert_null(strstr(report, "test.obj"), "reset");
+	free(report);
+	rz_slab_free(slab);
+	mu_end;
+}
+
+static bool test_alloc_prof_sites(void) {
+	rz_alloc_prof_enable(true);
+	RzList *list = rz_list_new();
+	rz_list_append(list, "a");
+	rz_list_append(list, "b");
+	rz_list_pop(list);
+	RzBitVector *bv = rz_bv_new(128);
+	rz_bv_free(bv);
+	rz_alloc_prof_enable(false);
+	char *report = rz_alloc_prof_report();
+	mu_assert_notnull(strstr(report, "\nlist.node "), "list nodes");
+	mu_assert_notnull(strstr(report, "\nbitvector "), "bitvectors");
+	mu_assert_notnull(strstr(report, "\nbitvector.large "), "bitvector buffers");
+	free(report);
+	rz_alloc_prof_reset();
+	rz_list_free(list);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_slab_alloc);
+	mu_run_test(test_alloc_prof);
+	mu_run_test(test_alloc_prof_sites);
+	return tests_passed != tests_run;
+}
+
+mu_main(all_tests)
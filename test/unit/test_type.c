@@ -977,6 +977,291 @@ static bool test_edit_types(void) {
 	mu_end;
 }
 
+static char *index_enum = "enum idx_color { IDX_RED = 0x1235, IDX_GREEN, IDX_BLUE = 0x1235 }";
+static char *index_struct_inner = "struct idx_inner { char pad[4661]; int32_t mark; }";
+static char *index_struct_outer = "struct idx_outer { int32_t head; struct idx_inner in; }";
+static char *index_struct_outer_new = "struct idx_outer { int64_t head; struct idx_inner in; }";
+static char *index_enum_new = "enum idx_shade { IDX_DARK = 0x1237 };";
+
+static RzList *scan_enums_by_val(RzTypeDB *typedb, ut64 val) {
+	RzList *result = rz_list_newf(free);
+	RzList *enums = rz_type_db_get_base_types_of_kind(typedb, RZ_BASE_TYPE_KIND_ENUM);
+	RzListIter *iter;
+	RzBaseType *e;
+	rz_list_foreach (enums, iter, e) {
+		RzTypeEnumCase *cas;
+		rz_vector_foreach(&e->enum_data.cases, cas) {
+			if (cas->val == val) {
+				rz_list_append(result, rz_str_newf("%s.%s", e->name, cas->name));
+			}
+		}
+	}
+	rz_list_free(enums);
+	return result;
+}
+
+static RzList *scan_by_offset(RzTypeDB *typedb, ut64 offset) {
+	RzList *result = rz_list_newf((RzListFree)rz_type_path_free);
+	RzList *types = rz_type_db_get_base_types(typedb);
+	RzListIter *iter;
+	RzBaseType *t;
+	rz_list_foreach (types, iter, t) {
+		if (t->kind == RZ_BASE_TYPE_KIND_STRUCT || t->kind == RZ_BASE_TYPE_KIND_UNION) {
+			RzList *list = rz_type_path_by_offset(typedb, t, offset);
+			rz_list_join(result, list);
+			rz_list_free(list);
+		}
+	}
+	rz_list_free(types);
+	return result;
+}
+
+static int type_path_cmp(const void *a, const void *b) {
+	return strcmp(((const RzTypePath *)a)->path, ((const RzTypePath *)b)->path);
+}
+
+// The indexes return the types in the order they were indexed
+static bool check_enums_by_val(RzTypeDB *typedb, ut64 val) {
+	RzList *expect = scan_enums_by_val(typedb, val);
+	RzList *got = rz_type_db_find_enums_by_val(typedb, val);
+	rz_list_sort(expect, (RzListComparator)strcmp);
+	rz_list_sort(got, (RzListComparator)strcmp);
+	mu_assert_eq(rz_list_length(got), rz_list_length(expect), "enums count");
+	RzListIter *it1, *it2;
+	for (it1 = rz_list_iterator(expect), it2 = rz_list_iterator(got); it1 && it2; it1 = it1->n, it2 = it2->n) {
+		mu_assert_streq(it2->data, it1->data, "enum case");
+	}
+	rz_list_free(expect);
+	rz_list_free(got);
+	return true;
+}
+
+static bool check_by_offset(RzTypeDB *typedb, ut64 offset) {
+	RzList *expect = scan_by_offset(typedb, offset);
+	RzList *got = rz_type_db_get_by_offset(typedb, offset);
+	rz_list_sort(expect, type_path_cmp);
+	rz_list_sort(got, type_path_cmp);
+	mu_assert_eq(rz_list_length(got), rz_list_length(expect), "type paths count");
+	RzListIter *it1, *it2;
+	for (it1 = rz_list_iterator(expect), it2 = rz_list_iterator(got); it1 && it2; it1 = it1->n, it2 = it2->n) {
+		RzTypePath *p1 = it1->data;
+		RzTypePath *p2 = it2->data;
+		mu_assert_streq(p2->path, p1->path, "type path");
+	}
+	rz_list_free(expect);
+	rz_list_free(got);
+	return true;
+}
+
+static bool path_list_contains(RzList *list, const char *path) {
+	RzListIter *iter;
+	RzTypePath *tpath;
+	rz_list_foreach (list, iter, tpath) {
+		if (!strcmp(tpath->path, path)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool test_type_db_reverse_index(void) {
+	RzTypeDB *typedb = rz_type_db_new();
+	mu_assert_notnull(typedb, "Couldn't create new RzTypeDB");
+	char *types_dir = rz_path_system(RZ_SDB_TYPES);
+	rz_type_db_init(typedb, types_dir, "x86", 64, "linux");
+	free(types_dir);
+
+	char *error_msg = NULL;
+	RzType *ttype = rz_type_parse_string_single(typedb->parser, index_enum, &error_msg);
+	mu_assert_notnull(ttype, "enum type parse successfull");
+	rz_type_free(ttype);
+	ttype = rz_type_parse_string_single(typedb->parser, index_struct_inner, &error_msg);
+	mu_assert_notnull(ttype, "struct type parse successfull");
+	rz_type_free(ttype);
+	ttype = rz_type_parse_string_single(typedb->parser, index_struct_outer, &error_msg);
+	mu_assert_notnull(ttype, "struct type parse successfull");
+	rz_type_free(ttype);
+
+	RzList *l = rz_type_db_find_enums_by_val(typedb, 0x1235);
+	mu_assert_eq(rz_list_length(l), 2, "enum cases with the value");
+	mu_assert_streq(rz_list_first(l), "idx_color.IDX_RED", "first enum case");
+	mu_assert_streq(rz_list_last(l), "idx_color.IDX_BLUE", "last enum case");
+	rz_list_free(l);
+	l = rz_type_db_find_enums_by_val(typedb, 0x1236);
+	mu_assert_notnull(rz_list_find(l, "idx_color.IDX_GREEN", (RzListComparator)strcmp), "enum case with the value");
+	rz_list_free(l);
+
+	l = rz_type_db_get_by_offset(typedb, 4661);
+	mu_assert_true(path_list_contains(l, "idx_inner.mark"), "struct member at the offset");
+	rz_list_free(l);
+
+	// The results must be the same of a full scan of the types
+	ut64 vals[] = { 0, 1, 2, 0x1235, 0x1236, UT64_MAX };
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(vals); i++) {
+		mu_assert_true(check_enums_by_val(typedb, vals[i]), "enums by value");
+	}
+	ut64 offsets[] = { 0, 4, 8, 16, 4661, 4665, UT64_MAX - 3 };
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(offsets); i++) {
+		mu_assert_true(check_by_offset(typedb, offsets[i]), "types by offset");
+	}
+
+	// Changing the types must update the results
+	mu_assert_true(rz_type_db_edit_base_type(typedb, "idx_outer", index_struct_outer_new), "edit struct base type");
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(offsets); i++) {
+		mu_assert_true(check_by_offset(typedb, offsets[i]), "types by offset after edit");
+	}
+	// Saving and deleting base types updates the indexes without rebuilding them
+	ut64 generation = typedb->generation;
+	rz_type_db_del(typedb, "idx_color");
+	l = rz_type_db_find_enums_by_val(typedb, 0x1235);
+	mu_assert_eq(rz_list_length(l), 0, "enum cases after delete");
+	rz_list_free(l);
+	rz_type_db_del(typedb, "idx_inner");
+	l = rz_type_db_get_by_offset(typedb, 4661);
+	mu_assert_false(path_list_contains(l, "idx_inner.mark"), "struct member after delete");
+	rz_list_free(l);
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(offsets); i++) {
+		mu_assert_true(check_by_offset(typedb, offsets[i]), "types by offset after deleting a nested type");
+	}
+	RzBaseType *btype = rz_type_base_type_new(RZ_BASE_TYPE_KIND_ENUM);
+	mu_assert_notnull(btype, "enum base type");
+	btype->name = strdup("idx_saved");
+	RzTypeEnumCase cas = { .name = strdup("IDX_SAVED"), .val = 0x1238 };
+	rz_vector_push(&btype->enum_data.cases, &cas);
+	rz_type_db_save_base_type(typedb, btype);
+	l = rz_type_db_find_enums_by_val(typedb, 0x1238);
+	mu_assert_eq(rz_list_length(l), 1, "enum cases of the saved enum");
+	mu_assert_streq(rz_list_first(l), "idx_saved.IDX_SAVED", "enum case of the saved enum");
+	rz_list_free(l);
+	mu_assert_true(check_enums_by_val(typedb, 0x1238), "enums by value after save");
+	mu_assert_eq(typedb->generation, generation, "indexes updated in place");
+
+	// Replacing a type keeps the number of types, but must update the results too
+	l = rz_type_db_find_enums_by_val(typedb, 0x1237);
+	mu_assert_eq(rz_list_length(l), 0, "enum cases before the new enum");
+	rz_list_free(l);
+	rz_type_db_del(typedb, "idx_outer");
+	mu_assert_eq(rz_type_parse_string_stateless(typedb->parser, index_enum_new, &error_msg), 0, "enum type parse successfull");
+	l = rz_type_db_find_enums_by_val(typedb, 0x1237);
+	mu_assert_eq(rz_list_length(l), 1, "enum cases of the new enum");
+	mu_assert_streq(rz_list_first(l), "idx_shade.IDX_DARK", "enum case of the new enum");
+	rz_list_free(l);
+	mu_assert_true(check_by_offset(typedb, 4), "types by offset after replace");
+
+	rz_type_db_free(typedb);
+	mu_end;
+}
+
+static const char *lazy_types_sdbs[] = {
+	"types-atomic.sdb", "types-libc.sdb", "types-64.sdb", "types-x86.sdb", "types-x86-64.sdb",
+	"types-linux.sdb", "types-linux-64.sdb", "types-x86-linux.sdb", "types-x86-linux-64.sdb"
+};
+static const char *lazy_callables_sdbs[] = { "functions-libc.sdb", "functions-linux.sdb" };
+
+static bool test_type_db_lazy_init(void) {
+	char *types_dir = rz_path_system(RZ_SDB_TYPES);
+	RzTypeDB *lazy = rz_type_db_new();
+	mu_assert_notnull(lazy, "Couldn't create new RzTypeDB");
+	rz_type_db_init(lazy, types_dir, "x86", 64, "linux");
+	// The same libraries, loaded entirely
+	RzTypeDB *eager = rz_type_db_new();
+	mu_assert_notnull(eager, "Couldn't create new RzTypeDB");
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(lazy_types_sdbs); i++) {
+		char *path = rz_file_path_join(types_dir, lazy_types_sdbs[i]);
+		rz_type_db_load_sdb(eager, path);
+		free(path);
+	}
+	for (size_t i = 0; i < RZ_ARRAY_SIZE(lazy_callables_sdbs); i++) {
+		char *path = rz_file_path_join(types_dir, lazy_callables_sdbs[i]);
+		rz_type_db_load_callables_sdb(eager, path);
+		free(path);
+	}
+	free(types_dir);
+
+	// Nothing is loaded on init
+	mu_assert_eq(lazy->types->count, 0, "no types loaded");
+	mu_assert_eq(lazy->callables->count, 0, "no callables loaded");
+
+	// Listing the function names doesn't load them
+	RzList *l1 = rz_type_noreturn_function_names(eager);
+	RzList *l2 = rz_type_noreturn_function_names(lazy);
+	rz_list_sort(l1, (RzListComparator)strcmp);
+	rz_list_sort(l2, (RzListComparator)strcmp);
+	mu_assert_true(rz_list_length(l1) > 0, "noreturn functions");
+	mu_assert_eq(rz_list_length(l2), rz_list_length(l1), "noreturn functions count");
+	RzListIter *it1, *it2;
+	for (it1 = rz_list_iterator(l1), it2 = rz_list_iterator(l2); it1 && it2; it1 = it1->n, it2 = it2->n) {
+		mu_assert_streq(it2->data, it1->data, "noreturn function name");
+	}
+	rz_list_free(l1);
+	rz_list_free(l2);
+	l1 = rz_type_function_names(eager);
+	l2 = rz_type_function_names(lazy);
+	mu_assert_eq(rz_list_length(l2), rz_list_length(l1), "functions count");
+	rz_list_free(l1);
+	rz_list_free(l2);
+	mu_assert_eq(lazy->callables->count, 0, "no callables loaded");
+
+	// Looking up a callable loads it along with the types it uses
+	RzCallable *c1 = rz_type_func_get(eager, "printf");
+	RzCallable *c2 = rz_type_func_get(lazy, "printf");
+	mu_assert_notnull(c1, "printf");
+	mu_assert_notnull(c2, "printf loaded");
+	mu_assert_eq(lazy->callables->count, 1, "one callable loaded");
+	char *cstr = rz_type_callable_as_string(eager, c1);
+	mu_assert_streq_free(rz_type_callable_as_string(lazy, c2), cstr, "printf type");
+	free(cstr);
+	mu_assert_true(lazy->types->count > 0, "printf types loaded");
+
+	// Finding the enums by value loads only the enums with that value
+	ut64 count = lazy->types->count;
+	l1 = rz_type_db_find_enums_by_val(eager, 2);
+	l2 = rz_type_db_find_enums_by_val(lazy, 2);
+	rz_list_sort(l1, (RzListComparator)strcmp);
+	rz_list_sort(l2, (RzListComparator)strcmp);
+	mu_assert_true(rz_list_length(l1) > 0, "enums by value");
+	mu_assert_eq(rz_list_length(l2), rz_list_length(l1), "enums by value count");
+	for (it1 = rz_list_iterator(l1), it2 = rz_list_iterator(l2); it1 && it2; it1 = it1->n, it2 = it2->n) {
+		mu_assert_streq(it2->data, it1->data, "enum case");
+	}
+	rz_list_free(l1);
+	rz_list_free(l2);
+	mu_assert_true(lazy->types->count > count, "enums loaded");
+	mu_assert_true(lazy->types->count < eager->types->count, "not all the types loaded");
+
+	// Every type is the same as when loaded entirely
+	RzList *types = rz_type_db_get_base_types(eager);
+	RzListIter *iter;
+	RzBaseType *btype;
+	rz_list_foreach (types, iter, btype) {
+		RzBaseType *lbtype = rz_type_db_get_base_type(lazy, btype->name);
+		mu_assert_notnull(lbtype, "type loaded");
+		mu_assert_eq(lbtype->kind, btype->kind, "type kind");
+		char *s1 = rz_type_db_base_type_as_string(eager, btype);
+		char *s2 = rz_type_db_base_type_as_string(lazy, lbtype);
+		mu_assert_streq(s2, s1, "type as string");
+		free(s1);
+		free(s2);
+		const char *f1 = rz_type_db_format_get(eager, btype->name);
+		const char *f2 = rz_type_db_format_get(lazy, btype->name);
+		mu_assert_true((!f1 && !f2) || (f1 && f2 && !strcmp(f1, f2)), "type format");
+	}
+	mu_assert_eq(lazy->types->count, eager->types->count, "types count");
+	rz_list_free(types);
+
+	// Deleted types are not loaded again
+	mu_assert_notnull(rz_type_db_get_base_type(lazy, "FILE"), "FILE type");
+	rz_type_db_del(lazy, "FILE");
+	types = rz_type_db_get_base_types(lazy);
+	mu_assert_eq(rz_list_length(types), eager->types->count - 1, "types count after delete");
+	rz_list_free(types);
+	mu_assert_null(rz_type_db_get_base_type(lazy, "FILE"), "FILE type deleted");
+
+	rz_type_db_free(eager);
+	rz_type_db_free(lazy);
+	mu_end;
+}
+
 /* references */
 typedef struct {
 	const char *name;
@@ -1032,6 +1317,8 @@ int all_tests() {
 	mu_run_test(test_struct_identifier_without_specifier);
 	mu_run_test(test_union_identifier_without_specifier);
 	mu_run_test(test_edit_types);
+	mu_run_test(test_type_db_reverse_index);
+	mu_run_test(test_type_db_lazy_init);
 	mu_run_test(test_references);
 	return tests_passed != tests_run;
 }